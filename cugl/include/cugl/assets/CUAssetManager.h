@@ -52,6 +52,7 @@
 #include <cugl/assets/CULoader.h>
 #include <typeinfo>
 #include <atomic>
+#include <vector>
 
 
 namespace cugl {
@@ -97,6 +98,40 @@ protected:
     
     /** Wait variable to create a load barrier for directories. */
     std::atomic<bool> _wait;
+    
+    /** A single watched asset file (defined in the implementation) */
+    struct WatchEntry;
+    /** The asset files watched for hot reloading */
+    std::vector<std::shared_ptr<WatchEntry>> _watched;
+    /** The user callback for each hot reload */
+    LoaderCallback _reloadCallback;
+    /** The inotify descriptor (-1 if polling or not watching) */
+    int _notify;
+    /** The watched directories for each inotify watch descriptor */
+    std::unordered_map<int,std::string> _notifyDirs;
+    /** The time (in milliseconds) of the last timestamp poll */
+    Uint32 _lastPoll;
+
+    /**
+     * Records the watched asset files for the given category.
+     *
+     * Only assets with a source file (as reported by {@link BaseLoader#getSource})
+     * are watched.
+     *
+     * @param hash  The hash of the asset type
+     * @param json  The child of asset directory with these assets
+     */
+    void watchCategory(size_t hash, const std::shared_ptr<JsonValue>& json);
+    
+    /**
+     * Starts a hot reload of the given watched asset.
+     *
+     * If the asset is still reloading from an earlier change, the reload is
+     * deferred until the current one completes.
+     *
+     * @param entry The watched asset file
+     */
+    void reload(const std::shared_ptr<WatchEntry>& entry);
 
     /**
      * Synchronously reads an asset category from a JSON file
@@ -210,7 +245,7 @@ public:
      * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an asset 
      * manager on the heap, use one of the static constructors instead.
      */
-    AssetManager() : _preload(false), _wait(false) {}
+    AssetManager() : _preload(false), _wait(false), _notify(-1), _lastPoll(0) {}
     
     /**
      * Deletes this asset manager, disposing of all resources.
@@ -1007,6 +1042,80 @@ public:
         return unloadDirectory(std::string(directory));
     }
 
+#pragma mark -
+#pragma mark Hot Reloading
+    /**
+     * Watches all assets in the given directory for changes.
+     *
+     * Hot reloading is intended for desktop builds during content creation.
+     * The source file of every texture, font, and JSON asset in the directory
+     * is watched (via inotify on Linux and by polling the file timestamps
+     * elsewhere). When a file changes, the asset is decoded again on the
+     * loader thread and swapped into the existing asset in place. Every
+     * smart pointer to the asset sees the new data, so live scene graphs pick
+     * up the change without being rebuilt. Sounds and scene graphs are not
+     * reloaded.
+     *
+     * The assets in the directory must already be loaded. Changes are only
+     * detected by {@link update}, which must be called every animation frame.
+     *
+     * The optional callback function will be called each time an individual
+     * asset is reloaded or fails to reload.
+     *
+     * @param json      The JSON asset directory
+     * @param callback  An optional callback after each asset is reloaded
+     *
+     * @return true if hot reloading is supported on this platform
+     */
+    bool watchDirectory(const std::shared_ptr<JsonValue>& json, LoaderCallback callback = nullptr);
+
+    /**
+     * Watches all assets in the given directory for changes.
+     *
+     * Hot reloading is intended for desktop builds during content creation.
+     * The source file of every texture, font, and JSON asset in the directory
+     * is watched (via inotify on Linux and by polling the file timestamps
+     * elsewhere). When a file changes, the asset is decoded again on the
+     * loader thread and swapped into the existing asset in place. Every
+     * smart pointer to the asset sees the new data, so live scene graphs pick
+     * up the change without being rebuilt. Sounds and scene graphs are not
+     * reloaded.
+     *
+     * The assets in the directory must already be loaded. Changes are only
+     * detected by {@link update}, which must be called every animation frame.
+     *
+     * The optional callback function will be called each time an individual
+     * asset is reloaded or fails to reload.
+     *
+     * @param directory The path to the JSON asset directory
+     * @param callback  An optional callback after each asset is reloaded
+     *
+     * @return true if hot reloading is supported on this platform
+     */
+    bool watchDirectory(const std::string& directory, LoaderCallback callback = nullptr);
+    
+    /**
+     * Stops watching all asset files for changes.
+     *
+     * Any reloads already in progress will still complete.
+     */
+    void unwatchAll();
+    
+    /**
+     * Returns true if any asset files are watched for changes.
+     *
+     * @return true if any asset files are watched for changes.
+     */
+    bool isWatching() const { return !_watched.empty(); }
+    
+    /**
+     * Checks the watched asset files and reloads any that have changed.
+     *
+     * This method must be called from the main thread, typically once every
+     * animation frame. It does nothing if no assets are watched.
+     */
+    void update();
+
 };
 
 }
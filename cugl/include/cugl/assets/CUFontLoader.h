@@ -90,13 +90,19 @@ protected:
      * Hence this method does the maximum amount of work that can be done in 
      * asynchronous font loading.
      *
+     * If the spread is positive, the atlas is a signed distance field with
+     * that spread (see {@link Font#setDistanceSpread}). The distance field
+     * is computed here, and so it is also off the main thread.
+     *
      * @param source    The pathname to the asset
      * @param charset   The atlas character set
      * @param size      The font size
+     * @param spread    The distance field spread (0 for none)
      *
      * @return the font asset with no generated atlas
      */
-    std::shared_ptr<Font> preload(const std::string& source, const std::string& charset, int size);
+    std::shared_ptr<Font> preload(const std::string& source, const std::string& charset, int size,
+                                  int spread=0);
     
     /**
      * Creates an atlas for the font asset, and assigns it the given key.
@@ -117,6 +123,20 @@ protected:
      */
     void materialize(const std::string& key, const std::shared_ptr<Font>& font, LoaderCallback callback);
     
+    /**
+     * Swaps a reloaded font into the existing font asset with the given key.
+     *
+     * This method finishes the hot reload started in {@link reload}.  As
+     * atlas generation requires OpenGL, this step is not safe to be done in a
+     * separate thread.  Instead, it takes place in the main CUGL thread via
+     * {@link Application#schedule}.
+     *
+     * @param key       The key of the font asset
+     * @param font      The reloaded font (may be null)
+     * @param callback  An optional callback for the reload
+     */
+    void replace(const std::string& key, const std::shared_ptr<Font>& font, LoaderCallback callback);
+    
     /**
      * Internal method to support asset loading.
      *
@@ -179,6 +199,7 @@ protected:
      *      "file":         The path to the asset
      *      "size":         This font size (int)
      *      "charset":      The set of characters for the font atlas (string)
+     *      "spread":       The distance field spread in pixels (int, default 0)
      *
      * @param json      The directory entry for the asset
      * @param callback  An optional callback for asynchronous loading
@@ -487,6 +508,35 @@ public:
      * @param charset   The default atlas character set
      */
     void setCharacterSet(const std::string& charset) { _charset = charset; }
+    
+#pragma mark -
+#pragma mark Hot Reloading
+    /**
+     * Returns the source file for the given directory entry.
+     *
+     * The path is relative to the asset directory. The asset manager watches
+     * this file for changes when hot reloading.
+     *
+     * @param json      The directory entry for the asset
+     *
+     * @return the source file for the given directory entry.
+     */
+    virtual std::string getSource(const std::shared_ptr<JsonValue>& json) const override;
+    
+    /**
+     * Reloads the font for the given directory entry in place.
+     *
+     * The font file and its atlas are regenerated on the loader thread (or
+     * immediately if there is no thread). The result is then swapped into the
+     * existing font on the main thread, so every smart pointer to the font
+     * sees the new glyphs. The font must already be loaded.
+     *
+     * @param json      The directory entry for the asset
+     * @param callback  An optional callback for the reload
+     *
+     * @return true if the reload was started
+     */
+    virtual bool reload(const std::shared_ptr<JsonValue>& json, LoaderCallback callback) override;
 };
 
 }
@@ -82,6 +82,20 @@ protected:
     void materialize(const std::string& key, const std::shared_ptr<JsonValue>& json,
                      LoaderCallback callback);
     
+    /**
+     * Swaps a reloaded Json tree into the existing asset with the given key.
+     *
+     * This method finishes the hot reload started in {@link reload}. The
+     * existing root node is kept, so every smart pointer to it sees the new
+     * contents. Smart pointers to the old children are not updated.
+     *
+     * @param key       The key of the Json asset
+     * @param json      The reloaded Json tree (may be null)
+     * @param callback  An optional callback for the reload
+     */
+    void replace(const std::string& key, const std::shared_ptr<JsonValue>& json,
+                 LoaderCallback callback);
+    
     /**
      * Internal method to support asset loading.
      *
@@ -184,6 +198,34 @@ public:
         std::shared_ptr<JsonLoader> result = std::make_shared<JsonLoader>();
         return (result->init(threads) ? result : nullptr);
     }
+    
+#pragma mark -
+#pragma mark Hot Reloading
+    /**
+     * Returns the source file for the given directory entry.
+     *
+     * The path is relative to the asset directory. The asset manager watches
+     * this file for changes when hot reloading.
+     *
+     * @param json      The directory entry for the asset
+     *
+     * @return the source file for the given directory entry.
+     */
+    virtual std::string getSource(const std::shared_ptr<JsonValue>& json) const override;
+    
+    /**
+     * Reloads the Json asset for the given directory entry in place.
+     *
+     * The file is parsed again on the loader thread (or immediately if there
+     * is no thread). The result is then swapped into the existing root node
+     * on the main thread. The asset must already be loaded.
+     *
+     * @param json      The directory entry for the asset
+     * @param callback  An optional callback for the reload
+     *
+     * @return true if the reload was started
+     */
+    virtual bool reload(const std::shared_ptr<JsonValue>& json, LoaderCallback callback) override;
 };
 
 }
@@ -782,6 +782,18 @@ public:
      */
     void setNull();
 
+    /**
+     * Swaps the contents of this node with those of the given node.
+     *
+     * The type, value and children of the two nodes are exchanged. The key
+     * and parent of each node are unchanged. Unlike {@link #merge}, this
+     * node may be a root. This allows a JSON asset to be reloaded in place,
+     * so that any smart pointer to it sees the new contents.
+     *
+     * @param node  The node to swap with
+     */
+    void swap(JsonValue& node);
+
     
 #pragma mark -
 #pragma mark Child Access
@@ -725,6 +725,45 @@ public:
         return (size == 0 ? 0.0f : ((float)loadCount())/size);
     }
     
+#pragma mark Hot Reloading
+    /**
+     * Returns the source file for the given directory entry.
+     *
+     * The path is relative to the asset directory. The asset manager watches
+     * this file for changes when hot reloading. A loader that does not support
+     * hot reloading returns the empty string.
+     *
+     * @param json      The directory entry for the asset
+     *
+     * @return the source file for the given directory entry.
+     */
+    virtual std::string getSource(const std::shared_ptr<JsonValue>& json) const {
+        return "";
+    }
+    
+    /**
+     * Reloads the asset for the given directory entry in place.
+     *
+     * The file is decoded again on the loader thread (or immediately if there
+     * is no thread). The result is then swapped into the existing asset on
+     * the main thread, so every smart pointer to the asset sees the new
+     * contents. The asset must already be loaded.
+     *
+     * The optional callback is called on the main thread once the asset is
+     * swapped (or fails to reload).
+     *
+     * This method is abstract and should be overridden in child classes that
+     * support hot reloading.
+     *
+     * @param json      The directory entry for the asset
+     * @param callback  An optional callback for the reload
+     *
+     * @return true if the reload was started
+     */
+    virtual bool reload(const std::shared_ptr<JsonValue>& json, LoaderCallback callback) {
+        return false;
+    }
+    
 };
 
 
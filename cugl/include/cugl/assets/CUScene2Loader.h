@@ -51,7 +51,10 @@
 #define __CU_SCENE_2_LOADER_H__
 #include <cugl/assets/CULoader.h>
 #include <cugl/scene2/graph/CUSceneNode.h>
+#include <cugl/util/CUTimestamp.h>
 #include <unordered_map>
+#include <mutex>
+#include <condition_variable>
 
 namespace cugl {
     
@@ -70,6 +73,12 @@ class AssetManager;
  * As UI widgets typically require fonts and images to be loaded already,
  * these should always be the last elements loaded in a loading phase.
  *
+ * When loading asynchronously, the top-level subtrees of a scene are built
+ * in parallel on a private pool of builder threads. This includes the layout
+ * and the polygon geometry of the textured nodes. Only the registration of
+ * the finished scene takes place on the main thread. The main thread never
+ * sees a partially built scene.
+ *
  * As with all of our loaders, this loader is designed to be attached to an
  * asset manager. Use the method {@link getHook()} to get the appropriate
  * pointer for attaching the loader.
@@ -79,7 +88,30 @@ private:
     /** This macro disables the copy constructor (not allowed on assets) */
     CU_DISALLOW_COPY_AND_ASSIGN(Scene2Loader);
     
+public:
+    /**
+     * The time spent in each phase of building a scene.
+     *
+     * All times are in microseconds. Asynchronous phases are measured in
+     * wall-clock time, not in total worker time.
+     */
+    struct Timing {
+        /** The time to read and parse the JSON file */
+        Uint64 parse;
+        /** The time to instantiate the nodes (including polygons) */
+        Uint64 build;
+        /** The time to apply the layout managers */
+        Uint64 layout;
+        /** The time to generate the render geometry ahead of drawing */
+        Uint64 geometry;
+        /** The time to register the scene with the asset table (main thread) */
+        Uint64 attach;
+    };
+
 protected:
+    /** A scene under asynchronous construction (defined in the source) */
+    struct BuildJob;
+
     /**
      * This is an enumeration for identifying scene node types.
      *
@@ -112,6 +144,8 @@ protected:
         SLIDER,
         /** A single-line text field type */
         TEXTFIELD,
+        /** A node caching its children (CachedNode) type */
+        CACHED,
 		/** A Node implied by an imported file */
 		EXTERNAL_IMPORT,
         /** An unsupported type */
@@ -142,6 +176,25 @@ protected:
     /** The type map for managing layout */
     std::unordered_map<std::string,Form> _forms;
     
+    /** The threads for building subtrees in parallel (created on demand) */
+    std::shared_ptr<ThreadPool> _builders;
+    
+    /** A mutex to serialize font access (SDL_ttf is not thread safe) */
+    mutable std::mutex _fontMutex;
+    
+    /** The build times of each loaded scene */
+    std::unordered_map<std::string,Timing> _timings;
+    
+    /** Whether to log the build times of each scene */
+    bool _verbose;
+    
+    /** The number of asynchronous builds still running on the worker threads */
+    size_t _building;
+    /** A mutex to protect the build counter */
+    std::mutex _buildMutex;
+    /** A condition to wait for the asynchronous builds to finish */
+    std::condition_variable _buildCondition;
+    
     /**
      * Records the given Node with this loader, so that it may be unloaded later.
      *
@@ -257,6 +310,114 @@ protected:
 	 */
 	std::shared_ptr<JsonValue> getWidgetJson(const std::shared_ptr<JsonValue>& json) const;
     
+    /**
+     * Returns a single node (without children) for the given JSON object.
+     *
+     * This method builds the node and its layout manager, but it does not
+     * process the "children" attribute. If the JSON refers to an imported
+     * widget, the reference json is replaced by the widget JSON, so that the
+     * caller can access the correct children.
+     *
+     * @param key           The key to access the node after loading
+     * @param json          The JSON object defining the node
+     * @param nonrelative   Set to true if children should not use relative color
+     *
+     * @return a single node (without children) for the given JSON object.
+     */
+    std::shared_ptr<scene2::SceneNode> buildNode(const std::string& key,
+                                                 std::shared_ptr<JsonValue>& json,
+                                                 bool& nonrelative) const;
+    
+    /**
+     * Returns the JSON for the given child, or nullptr if it is a comment.
+     *
+     * If the child is a widget reference, this returns the widget JSON.
+     *
+     * @param children  The "children" attribute of a widget
+     * @param index     The child position
+     *
+     * @return the JSON for the given child, or nullptr if it is a comment.
+     */
+    std::shared_ptr<JsonValue> getChildJson(const std::shared_ptr<JsonValue>& children, int index) const;
+    
+    /**
+     * Adds a built child to the given node, registering it with the layout.
+     *
+     * @param node          The parent node
+     * @param key           The child key
+     * @param item          The JSON object defining the child
+     * @param kid           The child node
+     * @param nonrelative   Whether the child should not use relative color
+     */
+    void addChild(const std::shared_ptr<scene2::SceneNode>& node, const std::string& key,
+                  const std::shared_ptr<JsonValue>& item,
+                  const std::shared_ptr<scene2::SceneNode>& kid, bool nonrelative) const;
+    
+    /**
+     * Prepares this loader for an asynchronous build.
+     *
+     * This method must be called on the main thread. It creates the builder
+     * threads if necessary. It also creates the blank texture, which nodes
+     * without a texture fall back to, as this is the only OpenGL object that
+     * scene construction may allocate on its own.
+     */
+    void prepare();
+    
+    /**
+     * Builds the scene for the given JSON on the builder threads.
+     *
+     * This method is called on the asset manager thread. It constructs the
+     * root node immediately and then builds each top-level subtree as a
+     * separate builder task. It does not wait on these tasks. The last task
+     * to finish calls {@link assemble}.
+     *
+     * @param job       The (partially initialized) build job
+     * @param json      The JSON object defining the scene
+     */
+    void buildAsync(const std::shared_ptr<BuildJob>& job, const std::shared_ptr<JsonValue>& json);
+    
+    /**
+     * Attaches the built subtrees to the root node and performs the layout.
+     *
+     * This method is called on the builder thread that finished last. Once
+     * layout is complete (and hence all content sizes are final), it
+     * generates the render geometry of each subtree as another set of
+     * builder tasks. The last task to finish calls {@link complete}.
+     *
+     * @param job       The build job
+     */
+    void assemble(const std::shared_ptr<BuildJob>& job);
+    
+    /**
+     * Schedules the built scene to be materialized on the main thread.
+     *
+     * @param job       The build job
+     */
+    void complete(const std::shared_ptr<BuildJob>& job);
+    
+    /**
+     * Hands the result of an asynchronous build to the main thread.
+     *
+     * This method schedules the callback (and, if successful, the scene
+     * materialization) on the main thread, and then marks the build as
+     * finished. It must be the last thing a build does off the main thread,
+     * as {@link dispose} may return as soon as it is called. If the loader
+     * is disposed before the main thread gets to the build, the callback
+     * reports a failure.
+     *
+     * @param job       The build job
+     * @param success   Whether the scene was successfully built
+     */
+    void finish(const std::shared_ptr<BuildJob>& job, bool success);
+    
+    /**
+     * Records the timing for the given scene, logging it if verbose.
+     *
+     * @param key       The scene key
+     * @param timing    The scene timing
+     */
+    void report(const std::string& key, const Timing& timing);
+    
 public:
 #pragma mark -
 #pragma mark Constructors
@@ -266,7 +427,12 @@ public:
      * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate a loader on
      * the heap, use one of the static constructors instead.
      */
-    Scene2Loader() {}
+    Scene2Loader() : _verbose(false), _building(0) {}
+    
+    /**
+     * Deletes this loader, disposing all resources
+     */
+    ~Scene2Loader() { dispose(); }
     
     /**
      * Initializes a new asset loader.
@@ -313,13 +479,27 @@ public:
      *
      * Once the loader is disposed, any attempts to load a new asset will
      * fail.  You must reinitialize the loader to begin loading assets again.
+     *
+     * This method blocks until every asynchronous build has left the worker
+     * threads, as stopping the builder threads would drop their queued
+     * tasks. The callbacks of builds that have not yet reached the main
+     * thread report a failure.
      */
     void dispose() override {
+        {
+            std::unique_lock<std::mutex> lock(_buildMutex);
+            _buildCondition.wait(lock, [this] { return _building == 0; });
+        }
+        if (_builders != nullptr) {
+            _builders->stop();
+            _builders = nullptr;
+        }
         _manager = nullptr;
         _assets.clear();
         _loader = nullptr;
         _types.clear();
         _forms.clear();
+        _timings.clear();
     }
     
     /**
@@ -386,6 +566,36 @@ public:
      */
     std::shared_ptr<scene2::SceneNode> build(const std::string& key, const std::shared_ptr<JsonValue>& json) const;
     
+#pragma mark -
+#pragma mark Profiling
+    /**
+     * Returns the build times for the scene with the given key.
+     *
+     * If there is no scene for this key, all times are 0.
+     *
+     * @param key   The scene key
+     *
+     * @return the build times for the scene with the given key.
+     */
+    Timing getTiming(const std::string& key) const {
+        auto it = _timings.find(key);
+        return (it == _timings.end() ? Timing{0,0,0,0,0} : it->second);
+    }
+    
+    /**
+     * Returns true if this loader logs the build times of each scene
+     *
+     * @return true if this loader logs the build times of each scene
+     */
+    bool isVerbose() const { return _verbose; }
+    
+    /**
+     * Sets whether this loader logs the build times of each scene
+     *
+     * @param value Whether this loader logs the build times of each scene
+     */
+    void setVerbose(bool value) { _verbose = value; }
+    
 };
     
 }
@@ -164,6 +164,20 @@ protected:
      */
     void materialize(const std::shared_ptr<JsonValue>& json, SDL_Surface* surface, LoaderCallback callback);
     
+    /**
+     * Swaps a reloaded image into the existing texture for the directory entry.
+     *
+     * This method finishes the hot reload started in {@link reload}. This
+     * step is not safe to be done in a separate thread.  Instead, it takes
+     * place in the main CUGL thread via {@link Application#schedule}. Any
+     * atlas subtextures are updated in place as well.
+     *
+     * @param json      The asset directory entry
+     * @param surface   The SDL_Surface with the new image (may be null)
+     * @param callback  An optional callback for the reload
+     */
+    void replace(const std::shared_ptr<JsonValue>& json, SDL_Surface* surface, LoaderCallback callback);
+    
 
     /**
      * Internal method to support asset loading.
@@ -405,6 +419,36 @@ public:
      */
     void setMipMaps(bool flag) { _mipmaps = flag; }
 
+#pragma mark -
+#pragma mark Hot Reloading
+    /**
+     * Returns the source file for the given directory entry.
+     *
+     * The path is relative to the asset directory. The asset manager watches
+     * this file for changes when hot reloading.
+     *
+     * @param json      The directory entry for the asset
+     *
+     * @return the source file for the given directory entry.
+     */
+    virtual std::string getSource(const std::shared_ptr<JsonValue>& json) const override;
+    
+    /**
+     * Reloads the texture for the given directory entry in place.
+     *
+     * The image is decoded again on the loader thread (or immediately if there
+     * is no thread). The pixels are then uploaded into the existing texture
+     * on the main thread, so every smart pointer to the texture (or to one of
+     * its atlas subtextures) sees the new image. The texture must already be
+     * loaded.
+     *
+     * @param json      The directory entry for the asset
+     * @param callback  An optional callback for the reload
+     *
+     * @return true if the reload was started
+     */
+    virtual bool reload(const std::shared_ptr<JsonValue>& json, LoaderCallback callback) override;
+
 };
 
 }
@@ -60,6 +60,13 @@ namespace cugl {
  * can write a JSON string embedded in a larger text file.  This allows for
  * maximum flexibility in encoding/decoding JSON data.
  *
+ * JSON values are streamed directly into the write buffer, which is flushed
+ * to the file as it fills.  No intermediate string (or cJSON tree) is ever
+ * built, so writing a large tree takes linear time and constant extra memory.
+ * The layout matches {@link JsonValue#toString}, except that floating point
+ * numbers are written with the shortest representation that reads back to
+ * the same value.
+ *
  * By default, this class (and every class in the io package) accesses the
  * application save directory {@see Application#getSaveDirectory()}.  If you
  * want to access another directory, you will need to specify an absolute path
@@ -140,6 +147,36 @@ public:
      * @param format    Whether to pretty-print the JSON string
      */
     void writeJson(const JsonValue* json, bool format=true);
+
+#pragma mark -
+#pragma mark Internal Helpers
+protected:
+    /**
+     * Writes a JsonValue (and all of its children) to the buffer.
+     *
+     * @param json      The JSON value to write
+     * @param depth     The nesting depth of the value
+     * @param format    Whether to pretty-print the JSON string
+     */
+    void writeValue(const JsonValue* json, int depth, bool format);
+    
+    /**
+     * Writes a JSON number to the buffer.
+     *
+     * Integral values are written as integers. All other values are written
+     * with the shortest representation that reads back to the same double.
+     * NaN and infinity are not valid JSON, and are written as null.
+     *
+     * @param json      The JSON number to write
+     */
+    void writeNumber(const JsonValue* json);
+    
+    /**
+     * Writes a quoted and escaped JSON string to the buffer.
+     *
+     * @param s         The string to write
+     */
+    void writeString(const std::string& s);
 };
     
 }
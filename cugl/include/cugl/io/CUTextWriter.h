@@ -354,6 +354,19 @@ public:
      */
     void write(const std::string& s);
     
+    /**
+     * Writes the first len characters of a string (ASCII or UTF8) to the file
+     *
+     * The string does not need to be null-terminated. The value is written
+     * to the internal buffer, but is not necessarily flushed automatically.
+     * It will be written when the buffer reaches capacity or the file is
+     * closed.
+     *
+     * @param s     the string to write
+     * @param len   the number of characters to write
+     */
+    void write(const char* s, size_t len);
+    
     /**
      * Writes a string (ASCII or UTF8) to the file, followed by a newline
      *
@@ -1056,6 +1056,32 @@ public:
      */
     static float* transform(const Affine2& aff, float const* input, float* output, size_t size);
 
+    /**
+     * Transforms the strided point array, and stores the result in output.
+     *
+     * Each point is the first two floats of a record that is instride floats
+     * wide (outstride for the output).  This allows the transform to be
+     * applied directly to the position field of an interleaved vertex array,
+     * such as {@link SpriteVertex2}, without copying the points out. Only the
+     * x and y values of each output record are written.
+     *
+     * The points are transformed four at a time (with SSE or Neon when the
+     * vectorized math library is enabled).  The input and output may be the
+     * same array, provided that the strides are the same. Otherwise the
+     * arrays must not overlap.
+     *
+     * @param aff       The transform matrix.
+     * @param input     The array of points to transform.
+     * @param instride  The number of floats between consecutive input points.
+     * @param output    The array to store the transformed points.
+     * @param outstride The number of floats between consecutive output points.
+     * @param size      The number of points to transform.
+     *
+     * @return A reference to output for chaining
+     */
+    static float* transform(const Affine2& aff, float const* input, size_t instride,
+                            float* output, size_t outstride, size_t size);
+
     /**
      * Transforms the rectangle and stores the result in dst.
      *
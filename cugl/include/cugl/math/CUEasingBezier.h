@@ -7,6 +7,11 @@
 //  function. This provides the user with more flexibility than the
 //  EasingFunction factory.
 //
+//  The curve is solved with a few Newton steps per evaluation. For curves
+//  that are evaluated constantly, it can also be sampled into a lookup table
+//  with linear interpolation. Arrays of times can be evaluated in a batch,
+//  which uses SSE or NEON when CUGL is vectorized.
+//
 //  These classe uses our standard shared-pointer architecture.
 //
 //  1. The constructor does not perform any initialization; it just sets all
@@ -61,6 +66,14 @@ namespace cugl {
  * used to interpolate the function over time (e.g. for tweening support). The 
  * function retains a shared pointer to the object, so the object reference can 
  * be safely discarded after getting the function pointer.
+ *
+ * Evaluating the curve requires solving the x-component for the parameter.
+ * If the curve is evaluated every frame, call {@link setLookupSize} to sample
+ * it into a table instead. Then evaluation is a table lookup and a linear
+ * interpolation. When easing many values at once, the batch version of
+ * {@link evaluate} avoids the overhead of the function pointer. Like the
+ * curve, the lookup table should be set before the object is shared between
+ * threads.
  */
 class EasingBezier :  public std::enable_shared_from_this<EasingBezier> {
 #pragma mark -
@@ -73,35 +86,33 @@ protected:
     /** The C3 coefficient */
     Vec2 _c3;
     
-    /** The rootset of the polynomial x-component (cached for efficiency). */
-    std::vector<float> _rootset;
-     
+    /** The lookup table of curve values at uniform times (empty if unused) */
+    std::vector<float> _table;
+
     /**
-     * Stores the roots of a x^2 + b x + c into the rootset.
+     * Returns the curve parameter whose x-component is t.
+     *
+     * The x-component of an easing curve is monotonic, so this parameter is
+     * unique. It is found with Newton's method, falling back to bisection
+     * when the curve is too flat for Newton's method to converge.
      *
-     * This is a helper function for computing the root set from the
-     * bezier polynomial.
+     * @param t The x-component to solve for
      *
-     * @param a The 2nd degree coefficient
-     * @param b The linear coefficient
-     * @param c The constant factor
+     * @return the curve parameter whose x-component is t.
      */
-    void solveQuadraticEquation(float a, float b, float c);
-    
+    float solveCurve(float t) const;
+
     /**
-     * Stores the roots of a x^3 + b x^2 + c x + d into the rootset.
+     * Returns the y-component of the curve at the given parameter.
      *
-     * This is a helper function for computing the root set from the
-     * bezier polynomial.
+     * @param s The curve parameter
      *
-     * @param a The 3rd degree coefficient
-     * @param b The 2nd degree coefficient
-     * @param c The linear coefficient
-     * @param d The constant factor
+     * @return the y-component of the curve at the given parameter.
      */
-    void solveCubicEquation(float a, float b, float c, float d);
-   
-    
+    float sampleCurve(float s) const {
+        return ((_c3.y*s+_c2.y)*s+_c1.y)*s;
+    }
+
 #pragma mark -
 #pragma mark Constructors
 public:
@@ -244,14 +255,54 @@ public:
 #pragma mark -
 #pragma mark Easing Support
 
+    /**
+     * Returns the number of samples in the lookup table.
+     *
+     * If this value is 0, the curve is solved on every evaluation.
+     *
+     * @return the number of samples in the lookup table.
+     */
+    size_t getLookupSize() const { return _table.size(); }
+
+    /**
+     * Sets the number of samples in the lookup table.
+     *
+     * If size is nonzero, this method samples the curve at size uniformly
+     * spaced times in [0,1]. From then on, evaluation interpolates these
+     * samples instead of solving the curve. The error is quadratic in the
+     * spacing (except where the curve is nearly vertical), so 256 samples is
+     * enough for most animations. If size is 0, the table is discarded. A
+     * size of 1 is treated as 2 (the end points).
+     *
+     * This method is not thread-safe, and so it should be called before the
+     * object (or its evaluator) is shared.
+     *
+     * @param size  The number of samples in the lookup table
+     */
+    void setLookupSize(size_t size);
+
     /**
      * Returns the value of the easing function at t.
      *
-     * The easing function is only well-defined when 0 <= t <= 1.
+     * The easing function is only well-defined when 0 <= t <= 1. If there is
+     * a lookup table, t is clamped to this range.
      *
      * @return the value of the easing function at t.
      */
-    float evaluate(float t);
+    float evaluate(float t) const;
+
+    /**
+     * Stores the value of the easing function at each of the given times.
+     *
+     * This is the same as calling {@link evaluate(float)} on every time, but
+     * the values are computed four at a time with SSE or NEON when CUGL is
+     * vectorized. The arrays t and out may be the same.
+     *
+     * @param t     The array of times
+     * @param out   The array to store the results
+     * @param size  The number of times to evaluate
+     */
+    void evaluate(const float* t, float* out, size_t size) const;
 
     /**
      * Returns a pointer to the function represented by this object.
@@ -7,7 +7,9 @@
 //  provided by http:://easings.net.
 //
 //  This class is simply a factory for returning function pointers to the
-//  appropriate static method.
+//  appropriate static method. For code that evaluates an easing function
+//  many times per frame, it also provides compile-time functors (with no
+//  dispatch or type erasure) and batch evaluation.
 //
 //  CUGL MIT License:
 //      This software is provided 'as-is', without any express or implied
@@ -57,6 +59,14 @@ namespace cugl {
  * The supported easing functions are all implemented as static methods.
  * The {@link alloc()} method is used to return a function value that can
  * can be used by other functions for tweening support.
+ *
+ * The std::function returned by {@link alloc()} is convenient, but every call
+ * goes through type erasure. When the easing type is known at compile time,
+ * {@link evaluate(float,float)} and {@link Functor} resolve the function
+ * statically so that it can be inlined. The polynomial functions are also
+ * constexpr. When many values must be eased with the same function (e.g. one
+ * per node in a transition), the batch version of evaluate dispatches once
+ * for the entire array, and uses SSE or NEON for the polynomial functions.
  */
 class EasingFunction {
 public:
@@ -150,6 +160,142 @@ public:
      */
     static std::function<float(float)> alloc(Type type, float period = ELASTIC_PERIOD);
 
+    /**
+     * Returns the value of the easing function T at the given time.
+     *
+     * The easing function is chosen at compile time, so there is no dispatch
+     * and the function may be inlined. For the polynomial easing functions,
+     * this function may be used in a constant expression.
+     *
+     * The optional value period only applies to elastic easing functions, as
+     * their bounce factor is adjustable.
+     *
+     * @param time      The time in seconds.
+     * @param period    The period of an elastic easing function
+     *
+     * @return the value of the easing function T at the given time.
+     */
+    template <Type T>
+    static constexpr float evaluate(float time, float period = ELASTIC_PERIOD) {
+        if constexpr (T == Type::LINEAR) {
+            return linear(time);
+        } else if constexpr (T == Type::SINE_IN) {
+            return sineIn(time);
+        } else if constexpr (T == Type::SINE_OUT) {
+            return sineOut(time);
+        } else if constexpr (T == Type::SINE_IN_OUT) {
+            return sineInOut(time);
+        } else if constexpr (T == Type::QUAD_IN) {
+            return quadIn(time);
+        } else if constexpr (T == Type::QUAD_OUT) {
+            return quadOut(time);
+        } else if constexpr (T == Type::QUAD_IN_OUT) {
+            return quadInOut(time);
+        } else if constexpr (T == Type::CUBIC_IN) {
+            return cubicIn(time);
+        } else if constexpr (T == Type::CUBIC_OUT) {
+            return cubicOut(time);
+        } else if constexpr (T == Type::CUBIC_IN_OUT) {
+            return cubicInOut(time);
+        } else if constexpr (T == Type::QUART_IN) {
+            return quartIn(time);
+        } else if constexpr (T == Type::QUART_OUT) {
+            return quartOut(time);
+        } else if constexpr (T == Type::QUART_IN_OUT) {
+            return quartInOut(time);
+        } else if constexpr (T == Type::QUINT_IN) {
+            return quintIn(time);
+        } else if constexpr (T == Type::QUINT_OUT) {
+            return quintOut(time);
+        } else if constexpr (T == Type::QUINT_IN_OUT) {
+            return quintInOut(time);
+        } else if constexpr (T == Type::EXPO_IN) {
+            return expoIn(time);
+        } else if constexpr (T == Type::EXPO_OUT) {
+            return expoOut(time);
+        } else if constexpr (T == Type::EXPO_IN_OUT) {
+            return expoInOut(time);
+        } else if constexpr (T == Type::CIRC_IN) {
+            return circIn(time);
+        } else if constexpr (T == Type::CIRC_OUT) {
+            return circOut(time);
+        } else if constexpr (T == Type::CIRC_IN_OUT) {
+            return circInOut(time);
+        } else if constexpr (T == Type::BACK_IN) {
+            return backIn(time);
+        } else if constexpr (T == Type::BACK_OUT) {
+            return backOut(time);
+        } else if constexpr (T == Type::BACK_IN_OUT) {
+            return backInOut(time);
+        } else if constexpr (T == Type::BOUNCE_IN) {
+            return bounceIn(time);
+        } else if constexpr (T == Type::BOUNCE_OUT) {
+            return bounceOut(time);
+        } else if constexpr (T == Type::BOUNCE_IN_OUT) {
+            return bounceInOut(time);
+        } else if constexpr (T == Type::ELASTIC_IN) {
+            return elasticIn(time, period);
+        } else if constexpr (T == Type::ELASTIC_OUT) {
+            return elasticOut(time, period);
+        } else {
+            return elasticInOut(time, period);
+        }
+    }
+
+    /**
+     * This struct is a function object for the easing function T.
+     *
+     * Unlike the std::function returned by {@link alloc()}, this functor is
+     * resolved at compile time. It can be passed to templated code (such as
+     * std::transform) and inlined at the call site.
+     */
+    template <Type T>
+    struct Functor {
+        /** The period of an elastic easing function */
+        float period;
+
+        /**
+         * Creates a functor for the easing function T.
+         *
+         * The optional value period only applies to elastic easing functions,
+         * as their bounce factor is adjustable.
+         *
+         * @param period    The period of an elastic easing function
+         */
+        constexpr Functor(float period = ELASTIC_PERIOD) : period(period) {}
+
+        /**
+         * Returns the value of the easing function T at the given time.
+         *
+         * @param time  The time in seconds.
+         *
+         * @return the value of the easing function T at the given time.
+         */
+        constexpr float operator()(float time) const {
+            return evaluate<T>(time, period);
+        }
+    };
+
+    /**
+     * Stores the value of the easing function at each of the given times.
+     *
+     * The easing function is chosen once for the entire array, and the inner
+     * loop is specialized for that function. The polynomial functions (and
+     * the back functions) are evaluated four at a time with SSE or NEON when
+     * CUGL is vectorized. The arrays time and out may be the same.
+     *
+     * The optional value period only applies to elastic easing functions, as
+     * their bounce factor is adjustable.
+     *
+     * @param type      The easing function type
+     * @param time      The array of times in seconds
+     * @param out       The array to store the results
+     * @param size      The number of times to evaluate
+     * @param period    The period of an elastic easing function
+     */
+    static void evaluate(Type type, const float* time, float* out, size_t size,
+                         float period = ELASTIC_PERIOD);
+
     /**
      * Returns an adjustment of the tweening time
      *
@@ -159,7 +305,9 @@ public:
      *
      * @return An adjustment of the tweening time
      */
-    static float linear(float time);
+    static constexpr float linear(float time) {
+        return time;
+    }
     
     /**
      * Returns an adjustment of the tweening time
@@ -204,7 +352,9 @@ public:
      *
      * @return An adjustment of the tweening time
      */
-    static float quadIn(float time);
+    static constexpr float quadIn(float time) {
+        return time * time;
+    }
     
     /**
      * Returns an adjustment of the tweening time
@@ -215,7 +365,9 @@ public:
      *
      * @return An adjustment of the tweening time
      */
-    static float quadOut(float time);
+    static constexpr float quadOut(float time) {
+        return -1 * time * (time - 2);
+    }
     
     /**
      * Returns an adjustment of the tweening time
@@ -227,7 +379,14 @@ public:
      *
      * @return An adjustment of the tweening time
      */
-    static float quadInOut(float time);
+    static constexpr float quadInOut(float time) {
+        time = time*2;
+        if (time < 1) {
+            return 0.5f * time * time;
+        }
+        --time;
+        return -0.5f * (time * (time - 2) - 1);
+    }
     
     /**
      * Returns an adjustment of the tweening time
@@ -238,7 +397,9 @@ public:
      *
      * @return An adjustment of the tweening time
      */
-    static float cubicIn(float time);
+    static constexpr float cubicIn(float time) {
+        return time * time * time;
+    }
     
     /**
      * Returns an adjustment of the tweening time
@@ -249,7 +410,10 @@ public:
      *
      * @return An adjustment of the tweening time
      */
-    static float cubicOut(float time);
+    static constexpr float cubicOut(float time) {
+        time -= 1;
+        return (time * time * time + 1);
+    }
     
     /**
      * Returns an adjustment of the tweening time
@@ -261,7 +425,14 @@ public:
      *
      * @return An adjustment of the tweening time
      */
-    static float cubicInOut(float time);
+    static constexpr float cubicInOut(float time) {
+        time = time*2;
+        if (time < 1) {
+            return 0.5f * time * time * time;
+        }
+        time -= 2;
+        return 0.5f * (time * time * time + 2);
+    }
 
     /**
      * Returns an adjustment of the tweening time
@@ -272,7 +443,9 @@ public:
      *
      * @return An adjustment of the tweening time
      */
-    static float quartIn(float time);
+    static constexpr float quartIn(float time) {
+        return time * time * time * time;
+    }
 
     /**
      * Returns an adjustment of the tweening time
@@ -283,7 +456,10 @@ public:
      *
      * @return An adjustment of the tweening time
      */
-    static float quartOut(float time);
+    static constexpr float quartOut(float time) {
+        time -= 1;
+        return -(time * time * time * time - 1);
+    }
 
     /**
      * Returns an adjustment of the tweening time
@@ -295,7 +471,14 @@ public:
      *
      * @return An adjustment of the tweening time
      */
-    static float quartInOut(float time);
+    static constexpr float quartInOut(float time) {
+        time = time*2;
+        if (time < 1) {
+            return 0.5f * time * time * time * time;
+        }
+        time -= 2;
+        return -0.5f * (time * time * time * time - 2);
+    }
     
     /**
      * Returns an adjustment of the tweening time
@@ -306,7 +489,9 @@ public:
      *
      * @return An adjustment of the tweening time
      */
-    static float quintIn(float time);
+    static constexpr float quintIn(float time) {
+        return time * time * time * time * time;
+    }
     
     /**
      * Returns an adjustment of the tweening time
@@ -317,7 +502,10 @@ public:
      *
      * @return An adjustment of the tweening time
      */
-    static float quintOut(float time);
+    static constexpr float quintOut(float time) {
+        time -=1;
+        return (time * time * time * time * time + 1);
+    }
     
     /**
      * Returns an adjustment of the tweening time
@@ -329,7 +517,14 @@ public:
      *
      * @return An adjustment of the tweening time
      */
-    static float quintInOut(float time);
+    static constexpr float quintInOut(float time) {
+        time = time*2;
+        if (time < 1) {
+            return 0.5f * time * time * time * time * time;
+        }
+        time -= 2;
+        return 0.5f * (time * time * time * time * time + 2);
+    }
     
     /**
      * Returns an adjustment of the tweening time
@@ -408,7 +603,10 @@ public:
      *
      * @return An adjustment of the tweening time
      */
-    static float backIn(float time);
+    static constexpr float backIn(float time) {
+        float overshoot = 1.70158f;
+        return time * time * ((overshoot + 1) * time - overshoot);
+    }
     
     /**
      * Returns an adjustment of the tweening time
@@ -419,7 +617,11 @@ public:
      *
      * @return An adjustment of the tweening time
      */
-    static float backOut(float time);
+    static constexpr float backOut(float time) {
+        float overshoot = 1.70158f;
+        time = time - 1;
+        return time * time * ((overshoot + 1) * time + overshoot) + 1;
+    }
     
     /**
      * Returns an adjustment of the tweening time
@@ -431,7 +633,15 @@ public:
      *
      * @return An adjustment of the tweening time
      */
-    static float backInOut(float time);
+    static constexpr float backInOut(float time) {
+        float overshoot = 1.70158f * 1.525f;
+        time = time * 2;
+        if (time < 1) {
+            return (time * time * ((overshoot + 1) * time - overshoot)) / 2;
+        }
+        time = time - 2;
+        return (time * time * ((overshoot + 1) * time + overshoot)) / 2 + 1;
+    }
     
     /**
      * Returns an adjustment of the tweening time
@@ -443,7 +653,9 @@ public:
      *
      * @return An adjustment of the tweening time
      */
-    static float bounceIn(float time);
+    static constexpr float bounceIn(float time) {
+        return 1 - bounceOut(1 - time);
+    }
     
     /**
      * Returns an adjustment of the tweening time
@@ -455,7 +667,19 @@ public:
      *
      * @return An adjustment of the tweening time
      */
-    static float bounceOut(float time);
+    static constexpr float bounceOut(float time) {
+        if (time < 1 / 2.75) {
+            return 7.5625f * time * time;
+        } else if (time < 2 / 2.75) {
+            time -= 1.5f / 2.75f;
+            return 7.5625f * time * time + 0.75f;
+        } else if(time < 2.5 / 2.75) {
+            time -= 2.25f / 2.75f;
+            return 7.5625f * time * time + 0.9375f;
+        }
+        time -= 2.625f / 2.75f;
+        return 7.5625f * time * time + 0.984375f;
+    }
     
     /**
      * Returns an adjustment of the tweening time
@@ -467,7 +691,12 @@ public:
      *
      * @return An adjustment of the tweening time
      */
-    static float bounceInOut(float time);
+    static constexpr float bounceInOut(float time) {
+        if (time < 0.5f) {
+            return (1 - bounceOut(1 - time * 2)) * 0.5f;
+        }
+        return bounceOut(time * 2 - 1) * 0.5f + 0.5f;
+    }
     
     /**
      * Returns an adjustment of the tweening time
@@ -296,45 +296,49 @@ public:
 
 #pragma mark Boundary Extraction
     /**
-     * Returns the set of indices that are on a boundary of this geometry
+     * Returns the indices that are on a boundary of this geometry
      *
      * This method is really only relevant for {@link #SOLID} geometry. For other
-     * geometries, it simply returns a set of the indices.  In the case of solid
+     * geometries, it simply returns the distinct indices.  In the case of solid
      * geometries, it identifies the outer hull (not necessarily convex).
      *
-     * This method can identify the outer hull using the graph properties of the
-     * triangle mesh. An internal node if the number of neighbors is the same as
-     * the number of attached triangles. An index that is not internal is external.
+     * This method identifies the outer hull using the edges of the triangle
+     * mesh. An edge is a boundary edge if it belongs to exactly one triangle,
+     * and an index is external if it is on a boundary edge. The edges are
+     * found with a radix sort, so this method is linear in the mesh size.
      *
      * Unlike {@link #boundaries}, this method does not order the boundary indices
-     * or decompose them into connected components.
+     * or decompose them into connected components. The indices are returned
+     * in ascending order with no duplicates.
      *
      * @param indices   The indices to process
      *
-     * @return the set of indices that are on a boundary of this geometry
+     * @return the indices that are on a boundary of this geometry
      */
-    std::unordered_set<Uint32> exterior(const std::vector<Uint32> indices) const;
+    std::vector<Uint32> exterior(const std::vector<Uint32>& indices) const;
     
     /**
-     * Returns the set of indices that are on a boundary of this geometry
+     * Returns the indices that are on a boundary of this geometry
      *
      * This method is really only relevant for {@link #SOLID} geometry. For other
-     * geometries, it simply returns a set of the indices.  In the case of solid
+     * geometries, it simply returns the distinct indices.  In the case of solid
      * geometries, it identifies the outer hull (not necessarily convex).
      *
-     * This method can identify the outer hull using the graph properties of the
-     * triangle mesh. An internal node if the number of neighbors is the same as
-     * the number of attached triangles. An index that is not internal is external.
+     * This method identifies the outer hull using the edges of the triangle
+     * mesh. An edge is a boundary edge if it belongs to exactly one triangle,
+     * and an index is external if it is on a boundary edge. The edges are
+     * found with a radix sort, so this method is linear in the mesh size.
      *
      * Unlike {@link #boundaries}, this method does not order the boundary indices
-     * or decompose them into connected components.
+     * or decompose them into connected components. The indices are returned
+     * in ascending order with no duplicates.
      *
      * @param indices   The indices to process
      * @param size      The index size
      *
-     * @return the set of indices that are on a boundary of this geometry
+     * @return the indices that are on a boundary of this geometry
      */
-    std::unordered_set<Uint32> exterior(const Uint32* indices, size_t size) const;
+    std::vector<Uint32> exterior(const Uint32* indices, size_t size) const;
 
     /**
      * Returns the connected boundary components for this geometry.
@@ -416,6 +420,11 @@ private:
      * as a separate boundary.  There is no guarantee on the order of boundaries
      * returned.
      *
+     * The boundary edges are found by radix sorting a flat table of the mesh
+     * edges, and are then linked through a contiguous adjacency table. Each
+     * boundary follows the orientation of the triangles, so the mesh should
+     * be consistently oriented. There is no allocation per triangle.
+     *
      * @param indices   The indices to process
      * @param size      The index size
      *
@@ -423,157 +432,6 @@ private:
      */
     std::vector<std::vector<Uint32>> detriangulate(const Uint32* indices, size_t size) const;
 
-    /** Forward declaration for the hash function */
-    class TreeNode;
-    
-    /**
-     * This class is a triangle in a mesh, interpreted as a node in tree decomposition
-     *
-     * Two triangles are adjacent in this decomposition if they share an edge. This
-     * dual graph is not connected, though we do track direction when we are recursively
-     * following a path.
-     *
-     * The elements in a tree node are ordered in ascending order, so that we can
-     * uniquely identify a tree node from its contents.
-     */
-    class TreeNode {
-    public:
-        /** Hash function for a tree node */
-        struct TreeHasher {
-            /**
-             * Returns the hash code for the given TreeNode
-             *
-             * @param node  The TreeNode to hash
-             *
-             * @return the hash code for the given TreeNode
-             */
-            std::size_t operator()(TreeNode* node) const;
-        };
-        
-        /** The elements of this triangle */
-        int elements[3];
-        /** The adjacent neighbors to this node */
-        std::unordered_set<TreeNode*,TreeHasher> neighbors;
-            
-        /** The node pointing to this one in a traversal */
-        TreeNode* previous;
-            
-        /**
-         * Creates a TreeNode from the given three elements.
-         *
-         * @param a The first element
-         * @param b The second element
-         * @param c The third element
-         */
-        TreeNode(int a, int b, int c);
-
-        /**
-         * Delets a TreeNode, destroying all resources.
-         */
-        ~TreeNode();
-
-        /**
-         * Returns true if o is a TreeNode equal to this one
-         *
-         * Since TreeNode objects sort their contents, o must have its elements in
-         * the same order as this on.
-         *
-         * @return true if o is a TreeNode equal to this one
-         */
-        bool operator==(const TreeNode& o) const;
-            
-        /**
-         * Returns a string representation of this tree node
-         *
-         * @return a string representation of this tree node
-         */
-        std::string toString() const;
-            
-        /**
-         * Returns a string representation of a tree node with the given elements
-         *
-         * This method allows us to get the string of a tree node (from its contents)
-         * without actually having to construct the tree node itself.  This is useful
-         * for hashtable lookups.
-         *
-         * @param a The first element
-         * @param b The second element
-         * @param c The third element
-         *
-         * @return a string representation of a tree node with the given elements
-         */
-        static std::string toString(int a, int b, int c);
-            
-        /**
-         * Returns true if x is an element in this node
-         *
-         * @param x The element to check
-         *
-         * @return true if x is an element in this node
-         */
-        bool contains(int x) const;
-            
-        /**
-         * Returns true if node is adjacent to this one.
-         *
-         * A node is adjacent if it shares exactly one side.
-         *
-         * @param node  The node to check
-         *
-         * @return true if node is adjacent to this one.
-         */
-        bool adjacent(const TreeNode* node) const;
-    
-        /**
-         * Returns a boundary index from the node, not in inuse
-         *
-         * A boundary index is either one that does not appear in any
-         * of its neighbors (so this is an ear in a triangulation) or
-         * only appears in one neighbor (so this is the either the first
-         * or last triangle with this index in a normal traversal).
-         *
-         * If no boundary index can be found, or they are all already
-         * in inuse, this method returns -1.
-         *
-         * @param inuse The indices to exclude from the search
-         *
-         * @return a boundary index from the node, not in inuse
-         */
-        Uint32 pick(const std::unordered_set<Uint32>& inuse) const;
-            
-        /**
-         * Returns the opposite transition point for the given index.
-         *
-         * A transition point is a node that contains index and for which index is
-         * a boundary value (either it has no neighbors with the same index or only
-         * one neighbor).  It represents the first and/or last triangle with this
-         * index in a normal traversal.
-         *
-         * If there is only one triangle with this index, this method returns this
-         * node.  Otherwise, if this node corresponds to the first triangle, it
-         * returns the last, and vice versa.  By following indices, we create a
-         * traversal that can find an exterior boundary.
-         *
-         * @param index The index defining the traversal
-         *
-         * @return the opposite transition point for the given index.
-         */
-        TreeNode* follow(Uint32 index);
-
-        /**
-         * Returns the opposite transition point for the given index.
-         *
-         * This method is the recursive helper for {@link #follow}. It uses
-         * the internal previous attribute to track direction.
-         *
-         * @param index The index defining the traversal
-         *
-         * @return the opposite transition point for the given index.
-         */
-        TreeNode* crawl(int index);
-    };
-
-private:
     /** The geometry value */
     Value _value;
 };
@@ -1639,6 +1639,59 @@ public:
      */
     static float* transform(const float* mat, float const* input, float* output, size_t size);
 
+    /**
+     * Transforms the strided 2d point array, and stores the result in output.
+     *
+     * Each point is the first two floats of a record that is instride floats
+     * wide (outstride for the output).  The points are treated as having z=0,
+     * so only the 2d sub-block (and translation) of the matrix is applied.
+     * Only the x and y values of each output record are written.  This is
+     * the same as {@link Affine2#transform} for the equivalent affine
+     * transform, and it is much faster than transforming each {@link Vec2}
+     * separately.
+     *
+     * The input and output may be the same array, provided that the strides
+     * are the same. Otherwise the arrays must not overlap.
+     *
+     * @param mat       The transform matrix.
+     * @param input     The array of points to transform.
+     * @param instride  The number of floats between consecutive input points.
+     * @param output    The array to store the transformed points.
+     * @param outstride The number of floats between consecutive output points.
+     * @param size      The number of points to transform.
+     *
+     * @return A reference to output for chaining
+     */
+    static float* transform2(const Mat4& mat, float const* input, size_t instride,
+                             float* output, size_t outstride, size_t size);
+
+    /**
+     * Transforms the strided 3d point array, and stores the result in output.
+     *
+     * Each point is the first three floats of a record that is instride
+     * floats wide (outstride for the output).  This allows the transform to
+     * be applied directly to the position field of an interleaved vertex
+     * array, such as {@link SpriteVertex3}. As with {@link Vec3} points, the
+     * w value is 1 and is not divided out.  Only the x, y, and z values of
+     * each output record are written.
+     *
+     * The points are transformed four at a time (with SSE or Neon when the
+     * vectorized math library is enabled).  The input and output may be the
+     * same array, provided that the strides are the same. Otherwise the
+     * arrays must not overlap.
+     *
+     * @param mat       The transform matrix.
+     * @param input     The array of points to transform.
+     * @param instride  The number of floats between consecutive input points.
+     * @param output    The array to store the transformed points.
+     * @param outstride The number of floats between consecutive output points.
+     * @param size      The number of points to transform.
+     *
+     * @return A reference to output for chaining
+     */
+    static float* transform3(const Mat4& mat, float const* input, size_t instride,
+                             float* output, size_t outstride, size_t size);
+
 
 #pragma mark -
 #pragma mark Vector Operations
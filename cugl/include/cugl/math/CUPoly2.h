@@ -44,6 +44,7 @@
 #define __CU_POLY2_H__
 
 #include <vector>
+#include <memory>
 #include <cugl/math/CUVec2.h>
 #include <cugl/math/CURect.h>
 #include <cugl/math/CUGeometry.h>
@@ -107,6 +108,9 @@ class Affine2;
 class Poly2 {
 #pragma mark Values
 private:
+    /** A uniform grid over the triangles (or edges) for containment queries */
+    struct Acceleration;
+    
     /** The vector of vertices in this polygon */
     std::vector<Vec2> _vertices;
     /** The vector of indices in the triangulation */
@@ -115,6 +119,8 @@ private:
     Rect _bounds;
     /** The index semantics */
     Geometry _geom;
+    /** The containment grid, built lazily and discarded on any change */
+    mutable std::shared_ptr<Acceleration> _accel;
     
 #pragma mark -
 #pragma mark Constructors
@@ -234,7 +240,8 @@ public:
      */
     Poly2(Poly2&& poly) :
         _vertices(std::move(poly._vertices)), _indices(std::move(poly._indices)),
-        _bounds(std::move(poly._bounds)), _geom(poly._geom) {}
+        _bounds(std::move(poly._bounds)), _geom(poly._geom),
+        _accel(std::move(poly._accel)) {}
     
     /**
      * Creates a polygon for the given rectangle.
@@ -511,6 +518,23 @@ public:
      */
     Poly2& setIndices(const Uint32* indices, size_t indxsize);
     
+    /**
+     * Moves a single vertex of this polygon to the given position.
+     *
+     * The indices and geometry are unchanged. The bounding box is updated
+     * incrementally, and is only recomputed from scratch if the old vertex
+     * was on its boundary. Hence this method is much faster than resetting
+     * all of the vertices when dragging a single point.
+     *
+     * This method returns a reference to this polygon for chaining.
+     *
+     * @param index     The index of the vertex to move
+     * @param vertex    The new vertex position
+     *
+     * @return This polygon, returned for chaining
+     */
+    Poly2& setVertex(size_t index, const Vec2 vertex);
+    
     /**
      * Clears the contents of this polygon and sets the geometry to `IMPLICIT`
      *
@@ -563,9 +587,12 @@ public:
      * This accessor will not permit any changes to the vertex array.  To change
      * the array, you must change the polygon via a set() method.
      *
+     * As the caller may modify the vertices through this reference, this
+     * method discards any containment grid (see {@link #buildAcceleration}).
+     *
      * @return a reference to the vertex array
      */
-    std::vector<Vec2>& vertices() { return _vertices; }
+    std::vector<Vec2>& vertices() { _accel = nullptr; return _vertices; }
 
     /**
      * Returns a reference to list of indices.
@@ -583,11 +610,12 @@ public:
      * This accessor will not permit any changes to the index array.  To change
      * the array, you must change the polygon via a set() method.
      *
-     * This non-const version of the method is used by triangulators.
+     * This non-const version of the method is used by triangulators. It
+     * discards any containment grid (see {@link #buildAcceleration}).
      *
      * @return a reference to the vertex array
      */
-    std::vector<Uint32>& indices()  { return _indices; }
+    std::vector<Uint32>& indices()  { _accel = nullptr; return _indices; }
 
     /**
      * Returns the bounding box for the polygon
@@ -631,7 +659,7 @@ public:
      *
      * @param geom  The geometry of this polygon.
      */
-    void setGeometry(Geometry geom) { _geom = geom; }
+    void setGeometry(Geometry geom) { _geom = geom; _accel = nullptr; }
     
     
 #pragma mark -
@@ -967,6 +995,29 @@ public:
      */
     bool contains(float x, float y, bool implicit=false) const;
     
+    /**
+     * Builds the containment grid for this polygon now.
+     *
+     * Polygons with many triangles (or edges) answer {@link #contains} with a
+     * uniform grid, so that each query only tests the triangles near the
+     * point. This grid is normally built lazily on the first query and is
+     * discarded whenever the polygon changes. Small polygons are never
+     * indexed, and this method does nothing for them.
+     *
+     * Building the grid lazily is not thread-safe. If this polygon is to be
+     * queried from several threads at once, call this method first.
+     */
+    void buildAcceleration() const;
+    
+    /**
+     * Discards the containment grid for this polygon.
+     *
+     * The grid is discarded automatically by every setter. This method is
+     * only needed if the vertices are modified in place through a reference
+     * acquired before the last call to {@link #contains}.
+     */
+    void clearAcceleration() const { _accel = nullptr; }
+    
     /**
      * Returns true if the given point is on the boundary of this polygon.
      *
@@ -1112,6 +1163,16 @@ private:
      * @return true if this polygon contains the given point.
      */
     bool containsCrossing(float x, float y) const;
+
+    /**
+     * Returns the containment grid for this polygon, building it if necessary.
+     *
+     * This method returns nullptr if the polygon is too small to benefit from
+     * a grid, or if the geometry is `POINTS`.
+     *
+     * @return the containment grid for this polygon, building it if necessary.
+     */
+    const Acceleration* getAcceleration() const;
     
     Uint32 hullPoint() const;
     
@@ -1124,6 +1185,7 @@ private:
     friend class ComplexTriangulator;
     friend class SimpleExtruder;
     friend class ComplexExtruder;
+    friend class PolyClipper;
     friend class PathSmoother;
 };
 
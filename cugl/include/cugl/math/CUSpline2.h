@@ -43,11 +43,13 @@
 
 #include "CUMathBase.h"
 #include "CUVec2.h"
+#include <memory>
 #include <vector>
 
 namespace cugl {
 
 class Polynomial;
+class ThreadPool;
 
 /**
  * This class represents a spline of cubic beziers.
@@ -88,6 +90,9 @@ class Polynomial;
 class Spline2 {
 #pragma mark Values
 private:
+    /** The cached projection data for nearest point queries */
+    struct Acceleration;
+    
     /** The number of segments in this spline */
     int _size;
     
@@ -113,6 +118,8 @@ private:
      */
     bool _closed;
     
+    /** The projection cache, built lazily and discarded on any change */
+    mutable std::shared_ptr<Acceleration> _accel;
     
 #pragma mark -
 #pragma mark Constructors
@@ -214,7 +221,8 @@ public:
      * @param  spline   The spline to take from
      */
     Spline2(Spline2&& spline) : _size(spline._size), _closed(spline._closed),
-        _points(std::move(spline._points)), _smooth(std::move(spline._smooth)) {}
+        _points(std::move(spline._points)), _smooth(std::move(spline._smooth)),
+        _accel(std::move(spline._accel)) {}
     
     /**
      * Deletes this spline, releasing all resources
@@ -243,6 +251,7 @@ public:
         _size = spline._size; _closed = spline._closed;
         _points = std::move(spline._points);
         _smooth = std::move(spline._smooth);
+        _accel = std::move(spline._accel);
         return *this;
     }
     
@@ -668,6 +677,7 @@ public:
     void clear() {
         _points.clear(); _smooth.clear();
         _closed = false; _size = 0;
+        _accel = nullptr;
     }
     
 #pragma mark -
@@ -700,12 +710,38 @@ public:
      *
      * http://jazzros.blogspot.com/2011/03/projecting-point-on-bezier-curve.html
      *
+     * The point independent part of each projection polynomial is cached on
+     * the spline, together with a bounding volume hierarchy of the segments.
+     * Hence a query only solves the polynomials of the segments that could be
+     * closer than the best candidate so far, and never allocates memory.
+     *
      * @param  point    the point to project
      *
      * @return the parameterization of the nearest point on the spline.
      */
     float nearestParameter(const Vec2 point) const;
     
+    /**
+     * Builds the projection cache for this spline now.
+     *
+     * The cache stores the polynomial coefficients and control point bounds
+     * of each segment, together with a segment hierarchy. It is normally
+     * built lazily on the first call to {@link #nearestParameter}, and is
+     * discarded whenever the spline changes.
+     *
+     * Building the cache lazily is not thread-safe. If this spline is to be
+     * queried from several threads at once, call this method first.
+     */
+    void buildAcceleration() const;
+    
+    /**
+     * Discards the projection cache for this spline.
+     *
+     * The cache is discarded automatically by every setter, so this method
+     * is only needed to release the memory early.
+     */
+    void clearAcceleration() const { _accel = nullptr; }
+    
     /**
      * Returns the index of the anchor nearest the given point.
      *
@@ -732,6 +768,29 @@ public:
      */
     int nearestTangent(const Vec2 point, float threshold) const;
     
+#pragma mark -
+#pragma mark Polygon Approximation
+    /**
+     * Appends a polyline approximating this spline to the given buffer.
+     *
+     * Unlike {@link PolySplineFactory}, this method does not subdivide
+     * recursively. Each bezier is sampled at uniform parameter steps with
+     * forward differencing, using the fewest steps for which the curve is
+     * guaranteed to lie within tolerance of the polyline. The number of
+     * points is computed first, so the buffer grows at most once.
+     *
+     * Long splines may be split across a thread pool, with each thread
+     * writing its beziers directly into the buffer. The result is the same
+     * either way.
+     *
+     * @param buffer    The buffer to store the polyline
+     * @param tolerance The maximum distance from the curve to the polyline
+     * @param threads   The thread pool to split long splines (may be null)
+     *
+     * @return the number of points added to the buffer
+     */
+    size_t flatten(std::vector<Vec2>& buffer, float tolerance,
+                   const std::shared_ptr<ThreadPool>& threads = nullptr) const;
     
 #pragma mark -
 #pragma mark Internal Helpers
@@ -806,7 +865,25 @@ protected:
      * @param  rght     vector to store the right bezier
      */
     static void subdivide(const std::vector<Vec2>& src, int soff, float tp,
-                          std::vector<Vec2>& left, std::vector<Vec2>& rght);
+                          std::vector<Vec2>& left, std::vector<Vec2>& rght) {
+        left.resize(4, Vec2::ZERO);
+        rght.resize(4, Vec2::ZERO);
+        subdivide(src.data()+soff, tp, left.data(), rght.data());
+    }
+    
+    /**
+     * Applies de Castlejau's to a bezier, putting the result in left & right
+     *
+     * This version works on raw arrays of four control points, and does not
+     * allocate any memory. The arrays left and rght must have room for four
+     * points each.
+     *
+     * @param  src      the control points for the bezier
+     * @param  tp       the parameter to split at
+     * @param  left     array to store the left bezier
+     * @param  rght     array to store the right bezier
+     */
+    static void subdivide(const Vec2* src, float tp, Vec2* left, Vec2* rght);
     /**
      * Returns the projection polynomial for the given point.
      *
@@ -832,8 +909,8 @@ protected:
      * This version does not use the projection polynomial.  Instead, it picks
      * a parameter resolution and walks the entire length of the curve.  The
      * result is both slow and inexact (as the actual point may be in-between
-     * chose parameters). This version is only picked when getProjectionFast
-     * fails because of an error with root finding.
+     * chose parameters). It is no longer used by nearestParameter(), but
+     * it is a useful reference for testing getProjectionFast().
      *
      * The value returned is a pair of the parameter, and its distance value.
      * This allows us to compare this result to other segments, picking the
@@ -862,10 +939,11 @@ protected:
      * This allows us to compare this result to other segments, picking the
      * best value for the entire spline.
      *
-     * This algorithm uses the projection polynomial, and searches for roots to
-     * find the best (max of 5) candidates.  However, root finding may fail,
-     * do to singularities in Bairstow's Method.  If the root finder fails, then
-     * the first element of the pair will be -1 (an invalid parameter).
+     * This algorithm uses the cached projection polynomial, and searches for
+     * roots to find the best (max of 5) candidates. The roots are isolated
+     * on the intervals where the polynomial is monotone, which are found
+     * from the roots of its derivatives (in closed form for the cubic). As
+     * a result, this method cannot fail, and it does not allocate memory.
      *
      * @param  point    the point to project
      * @param  segment  the bezier segment to project upon
@@ -873,6 +951,13 @@ protected:
      * @return the parameterization of the nearest point on the spline.
      */
     Vec2 getProjectionFast(const Vec2 point, int segment) const;
+    
+    /**
+     * Returns the projection cache for this spline, building it if necessary.
+     *
+     * @return the projection cache for this spline, building it if necessary.
+     */
+    const Acceleration* getAcceleration() const;
   
     friend class PolySplineFactory;
 };
@@ -44,10 +44,14 @@
 #define __CU_PATH_SMOOTHER_H__
 #include <cugl/math/CUVec2.h>
 #include <cugl/math/CUPoly2.h>
+#include <memory>
 #include <vector>
 
 namespace cugl {
 
+// Forward declarations
+class ThreadPool;
+
 /**
  * This class smooths a continuous path of points, reducing the number needed.
  *
@@ -86,6 +90,10 @@ private:
     float _epsilon;
     /** Whether or not the calculation has been run */
     bool _calculated;
+    /** The input points that survive the smoothing */
+    std::vector<Uint8> _keep;
+    /** The input segments still to be processed */
+    std::vector<std::pair<size_t,size_t>> _stack;
 
 #pragma mark -
 #pragma mark Constructors
@@ -178,10 +186,25 @@ public:
     void clear();
     
     /**
-     * Performs a triangulation of the current vertex data.
+     * Performs a smoothing of the current vertex data.
      */
     void calculate();
     
+    /**
+     * Performs a smoothing of the current vertex data with the given threads.
+     *
+     * Large inputs are split across the thread pool, both when searching a
+     * long segment for its farthest point and when processing independent
+     * segments. The result is identical to {@link #calculate()}. Small
+     * inputs (or a null pool) are processed on the calling thread.
+     *
+     * This method blocks until the calculation is complete. It must not be
+     * called from a task in the same thread pool.
+     *
+     * @param threads   The thread pool to split the work across
+     */
+    void calculate(const std::shared_ptr<ThreadPool>& threads);
+    
 #pragma mark -
 #pragma mark Materialization
     /**
@@ -250,16 +273,37 @@ public:
 #pragma mark Internal Data Generation
 private:
     /**
-     * Recursively performs Douglas-Peuker on the given input segment
+     * Performs a single step of Douglas-Peuker on the given input segment
      *
-     * The results will be pulled from _input and placed in _output.
+     * If the segment must be split, this method returns the position of
+     * the split point. Normally both halves must be processed further.
+     * However, if the segment is a loop (its end points are the same), only
+     * the second half is processed, and the left flag is set to false.
+     *
+     * If the segment is smooth, this method returns 0 (which can never be
+     * a split point). If the thread pool is not null, the search of long
+     * segments is split across it.
+     *
+     * @param start     The first position in _input to process
+     * @param end       The last position in _input to process
+     * @param left      Pointer to store whether to process the first half
+     * @param threads   The thread pool for long segments (may be null)
+     *
+     * @return the position of the split point, or 0 if there is none
+     */
+    size_t split(size_t start, size_t end, bool* left, ThreadPool* threads) const;
+    
+    /**
+     * Iteratively performs Douglas-Peuker on the given input segments
      *
-     * @param start The first position in _input to process
-     * @param end   The last position in _input to process
+     * The segments are consumed from the given stack, which is used as the
+     * work list. The surviving interior points are marked in _keep. As the
+     * segments only mark their interior points, segments that do not
+     * overlap may be processed in parallel.
      *
-     * @return the number of points preserved in smoothing
+     * @param stack The stack of segments to process
      */
-    size_t douglasPeucker(size_t start, size_t end);
+    void douglasPeucker(std::vector<std::pair<size_t,size_t>>& stack);
 };
 
 }
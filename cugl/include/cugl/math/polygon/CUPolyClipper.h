@@ -0,0 +1,489 @@
+//
+//  CUPolyClipper.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module is a factory for boolean operations (union, intersection,
+//  difference, xor) and offsets (inflating or deflating) on polygons. It is
+//  designed for batches. For example, you can set the walls of a level once
+//  and then clip the vision cone of every enemy against them each frame.
+//
+//  This factory is built on top of the famous Clipper library:
+//
+//      http://www.angusj.com/delphi/clipper.php
+//
+//  Since math objects are intended to be on the stack, we do not provide
+//  any shared pointer support in this class.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: agent
+//  Version: 10/19/26
+//
+#ifndef __CU_POLY_CLIPPER_H__
+#define __CU_POLY_CLIPPER_H__
+
+#include <clipper/clipper.hpp>
+#include <cugl/math/CUPoly2.h>
+#include <cugl/math/CUVec2.h>
+#include <cugl/math/polygon/CUPolyEnums.h>
+#include <cugl/math/polygon/CUSimpleTriangulator.h>
+#include <cugl/math/polygon/CUComplexTriangulator.h>
+#include <vector>
+
+namespace cugl {
+
+/**
+ * This class is a factory for boolean operations and offsets on polygons.
+ *
+ * The factory has two sets of input polygons: the subjects and the clips.
+ * A boolean operation combines the subjects with the clips according to a
+ * {@link poly2::ClipType}. An offset inflates (or deflates) the subjects
+ * and ignores the clips. Either way, the result is a collection of closed
+ * contours, some of which may be holes.
+ *
+ * Clipper only works with integer coordinates, so every input polygon is
+ * converted to an integer grid (see {@link #setResolution}) exactly once,
+ * when it is added. Both sets persist across calculations, as do the
+ * internal Clipper objects. So it is cheap to keep a large clip set (such
+ * as the walls of a level) and swap out the subjects with {@link #setSubject}
+ * for each query.
+ *
+ * If triangulation is enabled (the default), the calculation also
+ * triangulates the result in the same pass. Contours without holes are
+ * triangulated with {@link SimpleTriangulator}, and only contours with
+ * holes pay for {@link ComplexTriangulator}.
+ *
+ * As with all factories, the methods are broken up into three phases:
+ * initialization, calculation, and materialization.  To use the factory,
+ * you first set the data (in this case sets of vertices or other Poly2s)
+ * with the initialization methods.  You then call the calculation method.
+ * Finally, you use the materialization methods to access the data in several
+ * different ways.
+ *
+ * This division allows us to support multithreaded calculation if the data
+ * generation takes too long.  However, note that this factory is not thread
+ * safe in that you cannot access data while it is still in mid-calculation.
+ */
+class PolyClipper {
+#pragma mark Values
+private:
+    /** The subject polygons, in integer coordinates */
+    ClipperLib::Paths _subject;
+    /** The clip polygons, in integer coordinates */
+    ClipperLib::Paths _clip;
+    /** The union of the subject polygons (the input to an offset) */
+    ClipperLib::Paths _merged;
+
+    /** The boolean operation worker (reused across calculations) */
+    ClipperLib::Clipper _clipper;
+    /** The offset worker (reused across calculations) */
+    ClipperLib::ClipperOffset _offset;
+    /** The result of the last calculation */
+    ClipperLib::PolyTree _solution;
+
+    /** The offset joint settings */
+    ClipperLib::JoinType _joint;
+    /** The resolution tolerance of this algorithm */
+    Uint32 _resolution;
+    /** Whether to triangulate the result */
+    bool _triangulate;
+
+    /** The triangulator for contours without holes */
+    SimpleTriangulator _simple;
+    /** The triangulator for contours with holes */
+    ComplexTriangulator _complex;
+    /** Scratch buffer for converting a contour back to float coordinates */
+    std::vector<Vec2> _contour;
+
+    /** The triangulated output */
+    Poly2 _output;
+    /** Whether or not the calculation has been run */
+    bool _calculated;
+
+#pragma mark -
+#pragma mark Constructors
+public:
+    /**
+     * Creates a clipper with no polygon data.
+     */
+    PolyClipper();
+
+    /**
+     * Deletes this clipper, releasing all resources.
+     */
+    ~PolyClipper() {}
+
+#pragma mark -
+#pragma mark Initialization
+    /**
+     * Adds a subject polygon to this clipper.
+     *
+     * The polygon must have geometry `IMPLICIT`, `PATH`, or `SOLID`. Each
+     * path boundary is treated as a closed contour, while a solid polygon
+     * contributes its triangles. The vertex data is converted to integer
+     * coordinates and not retained.
+     *
+     * This method resets all computed data.
+     *
+     * @param poly  The subject polygon
+     */
+    void addSubject(const Poly2& poly) {
+        reset();
+        append(poly, _subject);
+    }
+
+    /**
+     * Adds a subject polygon to this clipper.
+     *
+     * The vertices are treated as a closed contour. The vertex data is
+     * converted to integer coordinates and not retained.
+     *
+     * This method resets all computed data.
+     *
+     * @param points    The subject polygon vertices
+     */
+    void addSubject(const std::vector<Vec2>& points) {
+        reset();
+        append(points.data(), points.size(), _subject);
+    }
+
+    /**
+     * Replaces all subject polygons with the given polygon.
+     *
+     * The polygon must have geometry `IMPLICIT`, `PATH`, or `SOLID`. Each
+     * path boundary is treated as a closed contour, while a solid polygon
+     * contributes its triangles. The vertex data is converted to integer
+     * coordinates and not retained.
+     *
+     * This method resets all computed data.
+     *
+     * @param poly  The subject polygon
+     */
+    void setSubject(const Poly2& poly) {
+        _subject.clear();
+        addSubject(poly);
+    }
+
+    /**
+     * Replaces all subject polygons with the given polygon.
+     *
+     * The vertices are treated as a closed contour. The vertex data is
+     * converted to integer coordinates and not retained.
+     *
+     * This method resets all computed data.
+     *
+     * @param points    The subject polygon vertices
+     */
+    void setSubject(const std::vector<Vec2>& points) {
+        _subject.clear();
+        addSubject(points);
+    }
+
+    /**
+     * Adds a clip polygon to this clipper.
+     *
+     * The polygon must have geometry `IMPLICIT`, `PATH`, or `SOLID`. Each
+     * path boundary is treated as a closed contour, while a solid polygon
+     * contributes its triangles. The vertex data is converted to integer
+     * coordinates and not retained.
+     *
+     * This method resets all computed data.
+     *
+     * @param poly  The clip polygon
+     */
+    void addClip(const Poly2& poly) {
+        reset();
+        append(poly, _clip);
+    }
+
+    /**
+     * Adds a clip polygon to this clipper.
+     *
+     * The vertices are treated as a closed contour. The vertex data is
+     * converted to integer coordinates and not retained.
+     *
+     * This method resets all computed data.
+     *
+     * @param points    The clip polygon vertices
+     */
+    void addClip(const std::vector<Vec2>& points) {
+        reset();
+        append(points.data(), points.size(), _clip);
+    }
+
+    /**
+     * Replaces all clip polygons with the given polygon.
+     *
+     * The polygon must have geometry `IMPLICIT`, `PATH`, or `SOLID`. Each
+     * path boundary is treated as a closed contour, while a solid polygon
+     * contributes its triangles. The vertex data is converted to integer
+     * coordinates and not retained.
+     *
+     * This method resets all computed data.
+     *
+     * @param poly  The clip polygon
+     */
+    void setClip(const Poly2& poly) {
+        _clip.clear();
+        addClip(poly);
+    }
+
+    /**
+     * Replaces all clip polygons with the given polygon.
+     *
+     * The vertices are treated as a closed contour. The vertex data is
+     * converted to integer coordinates and not retained.
+     *
+     * This method resets all computed data.
+     *
+     * @param points    The clip polygon vertices
+     */
+    void setClip(const std::vector<Vec2>& points) {
+        _clip.clear();
+        addClip(points);
+    }
+
+    /**
+     * Sets the joint value for offsets.
+     *
+     * The joint type determines how an inflated polygon is rounded at its
+     * corners. See {@link poly2::Joint} for the description of the types.
+     * A joint of NONE is treated as SQUARE.
+     *
+     * @param joint     The offset joint type
+     */
+    void setJoint(poly2::Joint joint);
+
+    /**
+     * Returns the joint value for offsets.
+     *
+     * The joint type determines how an inflated polygon is rounded at its
+     * corners. See {@link poly2::Joint} for the description of the types.
+     *
+     * @return the joint value for offsets.
+     */
+    poly2::Joint getJoint() const;
+
+    /**
+     * Sets the subdivision resolution for the Clipper library.
+     *
+     * Clipper only supports integer coordinates, so this class scales the
+     * points by the resolution and rounds them to the nearest integer. For
+     * example, if the resolution is 128 (the default), then every point will
+     * be rounded to the nearest 1/128 value.
+     *
+     * Polygons are converted when they are added, so changing the resolution
+     * clears all subject and clip polygons.
+     *
+     * @param resolution    The subdivision resolution
+     */
+    void setResolution(Uint32 resolution) {
+        clear();
+        _resolution = resolution;
+    }
+
+    /**
+     * Returns the subdivision resolution for the Clipper library.
+     *
+     * Clipper only supports integer coordinates, so this class scales the
+     * points by the resolution and rounds them to the nearest integer. For
+     * example, if the resolution is 128 (the default), then every point will
+     * be rounded to the nearest 1/128 value.
+     *
+     * @return the subdivision resolution for the Clipper library.
+     */
+    Uint32 getResolution() const {
+        return _resolution;
+    }
+
+    /**
+     * Sets whether to triangulate the result of each calculation.
+     *
+     * If this is false, only the contours (see {@link #getPaths}) are
+     * available after a calculation, and {@link #getPolygon} is empty. This
+     * is faster if you only need the outlines.
+     *
+     * @param value Whether to triangulate the result of each calculation
+     */
+    void setTriangulate(bool value) {
+        _triangulate = value;
+    }
+
+    /**
+     * Returns true if the result of each calculation is triangulated.
+     *
+     * If this is false, only the contours (see {@link #getPaths}) are
+     * available after a calculation, and {@link #getPolygon} is empty.
+     *
+     * @return true if the result of each calculation is triangulated.
+     */
+    bool getTriangulate() const {
+        return _triangulate;
+    }
+
+#pragma mark -
+#pragma mark Calculation
+    /**
+     * Clears all computed data, but still maintains the settings.
+     *
+     * This method preserves all subject and clip polygons, as well as the
+     * joint, precision, and triangulation settings.
+     */
+    void reset();
+
+    /**
+     * Clears all internal data, including the subject and clip polygons.
+     *
+     * The joint, precision, and triangulation settings are preserved.
+     */
+    void clear();
+
+    /**
+     * Performs a boolean operation on the current polygon data.
+     *
+     * The operation combines all of the subject polygons with all of the
+     * clip polygons. Both sets use the nonzero fill rule.
+     *
+     * @param type  The boolean operation
+     */
+    void calculate(poly2::ClipType type);
+
+    /**
+     * Performs an offset of the current subject polygons.
+     *
+     * A positive delta inflates the polygons, while a negative one deflates
+     * them. The subjects are merged (with the nonzero rule) before they are
+     * offset, so overlapping subjects, and the triangles of a SOLID polygon,
+     * are offset as a single shape. The clip polygons are ignored.
+     *
+     * @param delta The offset distance
+     */
+    void calculateOffset(float delta);
+
+#pragma mark -
+#pragma mark Materialization
+    /**
+     * Returns a polygon representing the triangulated result.
+     *
+     * The polygon contains a completely new set of vertices together with
+     * the indices defining a solid shape. The clipper does not maintain
+     * references to this polygon and it is safe to modify it.
+     *
+     * If the calculation is not yet performed, or triangulation is disabled,
+     * this method will return the empty polygon.
+     *
+     * @return a polygon representing the triangulated result.
+     */
+    Poly2 getPolygon() const;
+
+    /**
+     * Stores the triangulated result in the given buffer.
+     *
+     * This method will add both the new vertices, and the corresponding
+     * indices to the new buffer.  If the buffer is not empty, the indices
+     * will be adjusted accordingly. You should clear the buffer first if
+     * you do not want to preserve the original data.
+     *
+     * If the calculation is not yet performed, or triangulation is disabled,
+     * this method will do nothing.
+     *
+     * @param buffer    The buffer to store the triangulated result
+     *
+     * @return a reference to the buffer for chaining.
+     */
+    Poly2* getPolygon(Poly2* buffer) const;
+
+    /**
+     * Returns the contours of the result as closed paths.
+     *
+     * Each contour is a separate polygon with geometry `PATH`. Holes are
+     * included, and are oriented opposite to the outer contours.
+     *
+     * If the calculation is not yet performed, this method will return the
+     * empty list.
+     *
+     * @return the contours of the result as closed paths.
+     */
+    std::vector<Poly2> getPaths() const;
+
+    /**
+     * Stores the contours of the result in the given buffer.
+     *
+     * Each contour is appended as a separate polygon with geometry `PATH`.
+     * Holes are included, and are oriented opposite to the outer contours.
+     *
+     * If the calculation is not yet performed, this method will do nothing.
+     *
+     * @param buffer    The buffer to store the contours
+     *
+     * @return the number of contours added to the buffer
+     */
+    size_t getPaths(std::vector<Poly2>& buffer) const;
+
+#pragma mark -
+#pragma mark Internal Data Generation
+private:
+    /**
+     * Appends the boundaries of the polygon to the given paths.
+     *
+     * @param poly  The polygon to convert
+     * @param paths The paths to append to
+     */
+    void append(const Poly2& poly, ClipperLib::Paths& paths);
+
+    /**
+     * Appends the given closed contour to the given paths.
+     *
+     * @param points    The contour vertices
+     * @param size      The number of vertices
+     * @param paths     The paths to append to
+     */
+    void append(const Vec2* points, size_t size, ClipperLib::Paths& paths);
+
+    /**
+     * Converts the contour of a Clipper node back to float coordinates.
+     *
+     * The result is stored in the given buffer, which is cleared first.
+     *
+     * @param node      The Clipper node
+     * @param buffer    The buffer to store the contour
+     */
+    void convert(const ClipperLib::PolyNode* node, std::vector<Vec2>& buffer) const;
+
+    /**
+     * Triangulates a single outer node of the Clipper solution
+     *
+     * The node and its immediate holes are triangulated into the output.
+     * This is a recursive method that also processes any islands inside
+     * of the holes.
+     *
+     * @param node  The (outer) PolyNode to triangulate
+     */
+    void processNode(const ClipperLib::PolyNode* node);
+
+    /**
+     * Materializes the Clipper solution after a calculation.
+     */
+    void processSolution();
+};
+
+}
+
+#endif /* __CU_POLY_CLIPPER_H__ */
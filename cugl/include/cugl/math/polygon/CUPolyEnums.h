@@ -102,6 +102,40 @@ enum class Traversal : int {
     INTERIOR = 3
 };
     
+/**
+ * The boolean operations supported by {@link PolyClipper}.
+ *
+ * The operations combine the subject polygons with the clip polygons. Both
+ * sets use the nonzero fill rule, so overlapping polygons in the same set
+ * act as their union.
+ */
+enum class ClipType : int {
+    /** The region covered by either the subjects or the clips */
+    UNION = 0,
+    /** The region covered by both the subjects and the clips */
+    INTERSECTION = 1,
+    /** The region covered by the subjects but not the clips */
+    DIFFERENCE = 2,
+    /** The region covered by the subjects or the clips, but not both */
+    XOR = 3
+};
+    
+/**
+ * The triangulation algorithms supported by {@link TriangulationCache}.
+ *
+ * The first two are the algorithms of {@link SimpleTriangulator}, while the
+ * last is the algorithm of {@link ComplexTriangulator}. None of them support
+ * holes or self-intersections in a cached triangulation.
+ */
+enum class Triangulation : int {
+    /** The sweep-line monotone partition of SimpleTriangulator */
+    MONOTONE = 0,
+    /** The ear clipping algorithm of SimpleTriangulator */
+    EARCLIP = 1,
+    /** The constrained Delaunay triangulation of ComplexTriangulator */
+    DELAUNAY = 2
+};
+    
 /**
  * This enum specifies a capsule shape
  *
@@ -277,7 +277,7 @@ public:
      *
      * @return the number of elements added to the buffer
      */
-    size_t getParameters(std::vector<float> buffer);
+    size_t getParameters(std::vector<float>& buffer);
     
     /**
      * Returns a list of tangents for a polygon approximation
@@ -316,7 +316,7 @@ public:
      *
      * @return the number of elements added to the buffer
      */
-    size_t getTangents(std::vector<Vec2> buffer);
+    size_t getTangents(std::vector<Vec2>& buffer);
 
     /**
      * Stores tangent data for the approximation in the buffer.
@@ -376,7 +376,7 @@ public:
      *
      * @return the number of elements added to the buffer
      */
-    size_t getNormals(std::vector<Vec2> buffer);
+    size_t getNormals(std::vector<Vec2>& buffer);
 
     /**
      * Stores normal data for the approximation in the buffer.
@@ -536,23 +536,22 @@ public:
 #pragma mark Internal Data Generation
 private:
     /**
-     * Generates data via recursive use of de Castlejau's
+     * Generates data via repeated use of de Castlejau's
      *
-     * This method is the recursive helper for calculate(). It performs
-     * de Castlejau's algorithm and stores the data in the buffer.  You 
-     * will never call this method directly.
+     * This method is the helper for calculate(). It performs de Castlejau's
+     * algorithm on a single bezier and stores the data in the buffer. The
+     * subdivision is depth first, using a fixed stack of control points
+     * rather than recursion, so it does not allocate any memory (other than
+     * to grow the buffers). You will never call this method directly.
      *
-     * @param  src          the control point list for the bezier
-     * @param  soff         the offset into the control point list
-     * @param  tp           the parameter to split at
+     * @param  src          the control points for the bezier
+     * @param  tp           the parameter of the first anchor
      * @param  tolerance    the error tolerance of the stopping condition
      * @param  criterion    the stopping condition criterion
-     * @param  depth        the current depth of the recursive call
      *
-     * @return The number of (anchor) points generated by this recursive call.
+     * @return The number of (anchor) points generated by this call.
      */
-    int generate(const std::vector<Vec2>& src, int soff, float tp,
-                 float tolerance, Criterion criterion, int depth);
+    int generate(const Vec2* src, float tp, float tolerance, Criterion criterion);
 
     /**
      * Returns the currently "active" control points.
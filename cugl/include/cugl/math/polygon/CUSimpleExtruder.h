@@ -117,6 +117,10 @@ private:
     poly2::EndCap _truecap;
     /** The rounded joint/cap precision */
     Uint32 _precision;
+    /** Whether every joint is padded to the same size */
+    bool _uniform;
+    /** The stroke width of the last calculation */
+    float _stroke;
 
     /** The output results of extruded vertices */
     std::vector<Vec2> _outverts;
@@ -125,6 +129,19 @@ private:
     /** Whether or not the calculation has been run */
     bool _calculated;
     
+    /** Scratch space for the extruded vertices of an update */
+    std::vector<Vec2> _scratchverts;
+    /** Scratch space for the extruded indices of an update */
+    std::vector<Uint32> _scratchindx;
+    /** The first output vertex changed by the last calculation */
+    Uint32 _vstart;
+    /** The number of output vertices changed by the last calculation */
+    Uint32 _vcount;
+    /** The first output index changed by the last calculation */
+    Uint32 _istart;
+    /** The number of output indices changed by the last calculation */
+    Uint32 _icount;
+    
 #pragma mark -
 #pragma mark Constructors
 public:
@@ -181,8 +198,9 @@ public:
      */
     void set(const std::vector<Vec2>& points, bool closed) {
         reset();
-        _input.push_back(points);
-        _closed.push_back(closed);
+        _input.resize(1);
+        _input[0].assign(points.begin(),points.end());
+        _closed.assign(1,closed);
     }
 
     /**
@@ -287,6 +305,38 @@ public:
          return _precision;
      }
     
+    /**
+     * Sets whether every joint in the extrusion has the same size.
+     *
+     * Joints normally vary in size, as a mitre may fail and a straight
+     * joint is omitted altogether. A uniform extrusion pads every joint
+     * (including the implicit one before the first segment) with degenerate
+     * triangles, so that every segment of the path occupies a fixed range of
+     * the output. This is what makes {@link #update} possible. It is false
+     * by default.
+     *
+     * @param uniform   Whether every joint in the extrusion has the same size
+     */
+    void setUniform(bool uniform) {
+        _uniform = uniform;
+    }
+    
+    /**
+     * Returns true if every joint in the extrusion has the same size.
+     *
+     * Joints normally vary in size, as a mitre may fail and a straight
+     * joint is omitted altogether. A uniform extrusion pads every joint
+     * (including the implicit one before the first segment) with degenerate
+     * triangles, so that every segment of the path occupies a fixed range of
+     * the output. This is what makes {@link #update} possible. It is false
+     * by default.
+     *
+     * @return true if every joint in the extrusion has the same size
+     */
+    bool isUniform() const {
+        return _uniform;
+    }
+    
 #pragma mark -
 #pragma mark Calculation
     /**
@@ -330,6 +380,41 @@ public:
      */
     void calculate(float stroke);
     
+    /**
+     * Moves a single point of the path and re-extrudes only what it affects.
+     *
+     * The extruder must have a single path (as given to the vector version
+     * of {@link #set}) and index is a position in that path. If the extrusion
+     * is uniform and has already been calculated, this method recomputes
+     * only the two segments adjacent to the point and the three joints
+     * around them, in place. The changed range of the output is available
+     * from {@link #getUpdateRange}.
+     *
+     * Otherwise, and whenever the point affects an end cap (or the closing
+     * joint of a closed path), this method recalculates everything with the
+     * previous stroke width. In that case it returns false, and the update
+     * range is the entire output.
+     *
+     * @param index The index of the point to move
+     * @param point The new position of the point
+     *
+     * @return true if the extrusion was updated incrementally
+     */
+    bool update(Uint32 index, const Vec2 point);
+    
+    /**
+     * Retrieves the output range changed by the last calculation.
+     *
+     * After a call to {@link #calculate} this is the entire output. After
+     * a call to {@link #update} it is the range that was recomputed.
+     *
+     * @param vstart    Pointer to store the first changed vertex
+     * @param vcount    Pointer to store the number of changed vertices
+     * @param istart    Pointer to store the first changed index
+     * @param icount    Pointer to store the number of changed indices
+     */
+    void getUpdateRange(Uint32* vstart, Uint32* vcount, Uint32* istart, Uint32* icount) const;
+    
 #pragma mark -
 #pragma mark Materialization
     /**
@@ -362,6 +447,24 @@ public:
      */
     Poly2* getPolygon(Poly2* buffer);
     
+    /**
+     * Copies the output range changed by the last update into the buffer.
+     *
+     * The buffer must contain exactly the result of a previous call to
+     * {@link #getPolygon} (on an empty buffer) for this extrusion. Only the
+     * vertices and indices in the {@link #getUpdateRange} are copied, and
+     * the bounds are updated incrementally where possible. This allows a
+     * path to be dragged without any reallocation.
+     *
+     * If the buffer does not match the size of the extrusion, this method
+     * clears it and calls {@link #getPolygon} instead.
+     *
+     * @param buffer    The buffer storing the extruded polygon
+     *
+     * @return a reference to the buffer for chaining.
+     */
+    Poly2* updatePolygon(Poly2* buffer);
+    
 #pragma mark -
 #pragma mark Internal Data Generation
 private:
@@ -378,6 +481,32 @@ private:
      * @param icount    Pointer to store the number of vertices needed.
      */
     void computeSize(Uint32 insize, Uint32* vcount, Uint32* icount) const;
+
+    /**
+     * Computes the number of vertices and indices in a uniform joint.
+     *
+     * This is the largest number that any single joint may produce.
+     *
+     * @param vcount    Pointer to store the number of joint vertices
+     * @param icount    Pointer to store the number of joint indices
+     */
+    void computeJointSize(Uint32* vcount, Uint32* icount) const;
+    
+    /**
+     * Finishes the joint started at the given output positions.
+     *
+     * If the extrusion is uniform, this pads the joint with degenerate
+     * triangles to the size given by {@link #computeJointSize}. In either
+     * case, it makes sure that the vertex position for the next segment
+     * follows the joint (which is not the case for a failed mitre).
+     *
+     * @param a     The generating point of the joint
+     * @param start The vertex position at the start of the joint
+     * @param vmark The size of the vertex output at the start of the joint
+     * @param imark The size of the index output at the start of the joint
+     * @param data  The data necessary to run the Kivy algorithm.
+     */
+    void finishJoint(const Vec2 a, Uint32 start, size_t vmark, size_t imark, KivyData* data);
     
     /**
      * Creates the extruded line segment from a to b.
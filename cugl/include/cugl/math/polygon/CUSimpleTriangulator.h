@@ -10,8 +10,12 @@
 //  Because math objects are intended to be on the stack, we do not provide
 //  any shared pointer support in this class.
 //
-//  This implementation is largely inspired by the LibGDX implementation from
-//  Nicolas Gramlich, Eric Spits, Thomas Cate, and Nathan Sweet.
+//  By default, this class uses a sweep-line monotone partition, which runs
+//  in O(n log n) time. The original ear clipping algorithm (which is O(n^2))
+//  is still available, and is used as a fallback for degenerate input. The
+//  ear clipping implementation is largely inspired by the LibGDX
+//  implementation from Nicolas Gramlich, Eric Spits, Thomas Cate, and
+//  Nathan Sweet.
 //
 //  CUGL MIT License:
 //      This software is provided 'as-is', without any express or implied
@@ -41,6 +45,7 @@
 #include <cugl/math/CUPoly2.h>
 #include <cugl/math/CUVec2.h>
 #include <vector>
+#include <set>
 
 namespace cugl {
     
@@ -48,11 +53,19 @@ namespace cugl {
  * This class is a factory for producing solid Poly2 objects from a set of vertices.
  *
  * For all but the simplist of shapes, it is important to have a triangulator
- * that can divide up the polygon into triangles for drawing. This is a straight
- * forward implementation of the the ear cutting algorithm to triangulate simple
- * polygons. It will not handle polygons with holes or with self intersections.
+ * that can divide up the polygon into triangles for drawing. This factory
+ * partitions the polygon into y-monotone pieces with a sweep line and then
+ * triangulates each piece with a stack. This is O(n log n) in the number of
+ * vertices. It will not handle polygons with holes or with self intersections.
  * All triangles produced are guaranteed to be counter-clockwise.
  *
+ * If the sweep detects that the polygon is not simple, it falls back to the
+ * classic ear clipping algorithm, which is O(n^2) but more forgiving of bad
+ * data. You can also force ear clipping with {@link #setEarClipping}.
+ *
+ * All intermediate buffers are retained between calculations, so reusing the
+ * same triangulator for many polygons avoids repeated allocation.
+ *
  * As with all factories, the methods are broken up into three phases:
  * initialization, calculation, and materialization.  To use the factory, you
  * first set the data (in this case a set of vertices or another Poly2) with the
@@ -82,6 +95,42 @@ private:
         /** Vertex and its immediate neighbors form a convex polygon */
         CONVEX     = 1
     };
+    
+    /**
+     * Enumeration of vertex kinds for the monotone partition sweep
+     *
+     * These are the classic categories of de Berg et al. A vertex is above
+     * another if it has larger y-coordinate, or the same y-coordinate and a
+     * smaller x-coordinate.
+     */
+    enum SweepKind {
+        /** Both neighbors are below and the interior angle is less than pi */
+        START,
+        /** Both neighbors are below and the interior angle is more than pi */
+        SPLIT,
+        /** Both neighbors are above and the interior angle is less than pi */
+        END,
+        /** Both neighbors are above and the interior angle is more than pi */
+        MERGE,
+        /** One neighbor is above and the other is below */
+        REGULAR
+    };
+    
+    /**
+     * The ordering of edges in the sweep status
+     *
+     * Edges are ordered left to right by their intersection with the current
+     * sweep line. The special edge QUERY_EDGE stands for the current sweep
+     * vertex, so that we can search for the edge immediately to its left.
+     */
+    struct EdgeOrder {
+        /** The triangulator owning the sweep state */
+        const SimpleTriangulator* owner;
+        /** Creates an ordering for the given triangulator */
+        EdgeOrder(const SimpleTriangulator* owner) : owner(owner) {}
+        /** Returns true if edge a is to the left of edge b */
+        bool operator()(Uint32 a, Uint32 b) const;
+    };
 
     /** The set of vertices to use in the calculation */
     std::vector<Vec2> _input;
@@ -93,6 +142,47 @@ private:
     std::vector<Uint32> _output;
     /** Whether or not the calculation has been run */
     bool _calculated;
+    /** Whether to use ear clipping instead of the monotone partition */
+    bool _earclip;
+    
+    /** The input indices of the (deduplicated) polygon in counter-clockwise order */
+    std::vector<Uint32> _order;
+    /** The sweep kind of each vertex in _order */
+    std::vector<SweepKind> _kinds;
+    /** The vertex positions sorted from top to bottom */
+    std::vector<Uint32> _events;
+    /** The helper vertex of each edge (edge i goes from vertex i to i+1) */
+    std::vector<Uint32> _helpers;
+    /** The diagonals of the monotone partition, as flattened pairs */
+    std::vector<Uint32> _diagonals;
+    /** The offsets of each vertex into the half-edge tables */
+    std::vector<Uint32> _offsets;
+    /** The source vertex of each half-edge */
+    std::vector<Uint32> _sources;
+    /** The target vertex of each half-edge (sorted by angle about the source) */
+    std::vector<Uint32> _targets;
+    /** The angle of each half-edge about its source */
+    std::vector<double> _angles;
+    /** Whether each half-edge has been assigned to a face */
+    std::vector<bool> _visited;
+    /** The vertices of the current monotone face */
+    std::vector<Uint32> _face;
+    /** The vertices of the current face, sorted from top to bottom */
+    std::vector<Uint32> _sorted;
+    /** The chain (0 left, 1 right, 2 both) of each vertex in _sorted */
+    std::vector<Uint8> _chains;
+    /** The reflex chain stack for the monotone triangulation */
+    std::vector<Uint32> _stack;
+    /** The edges currently crossing the sweep line */
+    std::set<Uint32,EdgeOrder> _status;
+    /** The position of each active edge in _status */
+    std::vector<std::set<Uint32,EdgeOrder>::iterator> _handles;
+    /** Whether each edge is currently in _status */
+    std::vector<bool> _active;
+    /** The x-coordinate of the current sweep vertex */
+    double _sweepX;
+    /** The y-coordinate of the current sweep vertex */
+    double _sweepY;
 
 #pragma mark -
 #pragma mark Constructors
@@ -100,7 +190,8 @@ public:
     /**
      * Creates a triangulator with no vertex data.
      */
-    SimpleTriangulator() : _calculated(false) {}
+    SimpleTriangulator() : _calculated(false), _earclip(false), _status(EdgeOrder(this)),
+    _sweepX(0), _sweepY(0) {}
 
     /**
      * Creates a triangulator with the given vertex data.
@@ -110,7 +201,8 @@ public:
      * 
      * @param points    The vertices to triangulate
      */
-    SimpleTriangulator(const std::vector<Vec2>& points) : _calculated(false) { _input = points; }
+    SimpleTriangulator(const std::vector<Vec2>& points) : _calculated(false), _earclip(false),
+    _status(EdgeOrder(this)), _sweepX(0), _sweepY(0) { _input = points; }
 
     /**
      * Creates a triangulator with the given vertex data.
@@ -123,7 +215,8 @@ public:
      *
      * @param poly    The vertices to triangulate
      */
-    SimpleTriangulator(const Poly2& poly) :  _calculated(false) { set(poly); }
+    SimpleTriangulator(const Poly2& poly) :  _calculated(false), _earclip(false),
+    _status(EdgeOrder(this)), _sweepX(0), _sweepY(0) { set(poly); }
 
     /**
      * Deletes this triangulator, releasing all resources.
@@ -163,6 +256,29 @@ public:
         reset();
         _input = points;
     }
+    
+    /**
+     * Sets whether this triangulator uses the ear clipping algorithm.
+     *
+     * Ear clipping is O(n^2) in the number of vertices, while the default
+     * monotone partition is O(n log n). Ear clipping is more tolerant of
+     * self-intersecting input, though the monotone partition already falls
+     * back to it when it detects a problem. This setting is mainly useful
+     * for benchmarking.
+     *
+     * @param value Whether to use the ear clipping algorithm
+     */
+    void setEarClipping(bool value) { _earclip = value; }
+    
+    /**
+     * Returns true if this triangulator uses the ear clipping algorithm.
+     *
+     * Ear clipping is O(n^2) in the number of vertices, while the default
+     * monotone partition is O(n log n).
+     *
+     * @return true if this triangulator uses the ear clipping algorithm.
+     */
+    bool getEarClipping() const { return _earclip; }
 
 #pragma mark -
 #pragma mark Calculation
@@ -187,6 +303,9 @@ public:
     
     /**
      * Performs a triangulation of the current vertex data.
+     *
+     * Intermediate buffers are cleared but not released, so they are reused
+     * by the next calculation.
      */
     void calculate();
     
@@ -279,6 +398,61 @@ private:
      */
     bool areVerticesClockwise (const std::vector<Vec2>& vertices);
     
+    /**
+     * Returns true if the vertex at position a is above the one at b.
+     *
+     * Positions refer to _order. A vertex is above another if it has larger
+     * y-coordinate, or the same y-coordinate and a smaller x-coordinate.
+     *
+     * @param a     The first vertex position
+     * @param b     The second vertex position
+     *
+     * @return true if the vertex at position a is above the one at b.
+     */
+    bool isAbove(Uint32 a, Uint32 b) const;
+    
+    /**
+     * Returns the x-coordinate where the given edge meets the sweep line.
+     *
+     * @param edge  The edge (from position edge to edge+1)
+     *
+     * @return the x-coordinate where the given edge meets the sweep line.
+     */
+    double sweepIntercept(Uint32 edge) const;
+    
+    /**
+     * Computes a monotone triangulation of the current vertex data.
+     *
+     * This partitions the polygon into y-monotone pieces and triangulates
+     * each one. The triangles are added to the output in counter-clockwise
+     * order. If this method returns false, the input is not a simple polygon
+     * and the output must be discarded.
+     *
+     * @return true if the triangulation succeeded
+     */
+    bool computeMonotone();
+    
+    /**
+     * Computes the diagonals partitioning the polygon into monotone pieces.
+     *
+     * This is the sweep line portion of the algorithm. It returns false if
+     * the sweep status becomes inconsistent (e.g. a self-intersection).
+     *
+     * @return true if the partition succeeded
+     */
+    bool computeDiagonals();
+    
+    /**
+     * Triangulates the monotone polygon stored in _face.
+     *
+     * The face is a list of vertex positions in counter-clockwise order.
+     * This method runs in linear time, and returns false if the face is
+     * degenerate.
+     *
+     * @return true if the face was triangulated
+     */
+    bool triangulateMonotone();
+    
     /**
      * Removes an ear tip from the naive triangulation, adding it to the output.
      *
@@ -336,6 +510,14 @@ private:
      */
     void computeTriangulation();
     
+    /**
+     * Computes an ear clipping triangulation of the current vertex data.
+     *
+     * This is the original O(n^2) algorithm, and produces counter-clockwise
+     * triangles in the output.
+     */
+    void computeEarClipping();
+    
     /**
      * Removes colinear vertices from the current triangulation.
      *
@@ -0,0 +1,289 @@
+//
+//  CUTriangulationCache.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module is a cache of polygon triangulations, keyed on the vertices.
+//  Scene graphs tend to build the same shapes over and over again, whether
+//  because a scene file uses the same widget many times, or because the game
+//  recreates nodes every time the player enters a room. With this cache, a
+//  repeated shape costs a hash lookup instead of a triangulation.
+//
+//  Unlike the other classes in this package, this class is not a factory.
+//  You may create a private cache on the stack, but most code should use
+//  the shared cache, which is the one used by the scene graph nodes.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: agent
+//  Version: 10/19/26
+//
+#ifndef __CU_TRIANGULATION_CACHE_H__
+#define __CU_TRIANGULATION_CACHE_H__
+
+#include <cugl/math/CUPoly2.h>
+#include <cugl/math/CUVec2.h>
+#include <cugl/math/polygon/CUPolyEnums.h>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace cugl {
+
+/**
+ * This class is a cache of triangulations for simple polygons.
+ *
+ * A triangulation is identified by the vertices of the polygon (compared
+ * exactly) and the {@link poly2::Triangulation} algorithm. The vertices are
+ * hashed without allocation, so a repeated shape costs a hash lookup and a
+ * comparison. The triangulation is returned as an immutable index buffer,
+ * which is shared by every polygon with the same vertices.
+ *
+ * On a miss, the cache triangulates with a {@link SimpleTriangulator} or
+ * {@link ComplexTriangulator}. These factories (and the scratch buffer for
+ * the result) belong to the calling thread and are retained between misses,
+ * so the only allocations are for the new cache entry. The cache holds a
+ * bounded number of entries, and discards the least recently used one when
+ * it is full.
+ *
+ * The number of hits and misses is tracked for profiling. All methods are
+ * thread-safe, as scene graphs may be built on several asset loading threads.
+ * The lock is only held for the lookup and the insertion, so threads can
+ * triangulate different polygons at the same time.
+ */
+class TriangulationCache {
+#pragma mark Values
+private:
+    /** A single cached triangulation */
+    struct Entry {
+        /** The hash of the vertices and algorithm */
+        Uint64 hash;
+        /** The triangulation algorithm */
+        poly2::Triangulation type;
+        /** The polygon vertices (to rule out hash collisions) */
+        std::vector<Vec2> vertices;
+        /** The (immutable) triangulation indices */
+        std::shared_ptr<const std::vector<Uint32>> indices;
+    };
+
+    /** The cached entries, with the most recently used first */
+    std::list<Entry> _entries;
+    /** The cached entries, indexed by hash */
+    std::unordered_multimap<Uint64, std::list<Entry>::iterator> _lookup;
+    /** The maximum number of entries in this cache */
+    size_t _capacity;
+    /** The number of requests answered from the cache */
+    Uint64 _hits;
+    /** The number of requests that required a triangulation */
+    Uint64 _misses;
+    /** The lock guarding all of the above */
+    mutable std::mutex _mutex;
+
+#pragma mark -
+#pragma mark Constructors
+public:
+    /**
+     * Creates an empty cache with the given capacity.
+     *
+     * @param capacity  The maximum number of cached triangulations
+     */
+    TriangulationCache(size_t capacity=256);
+
+    /**
+     * Deletes this cache, releasing all resources.
+     *
+     * Index buffers acquired from this cache remain valid.
+     */
+    ~TriangulationCache() { clear(); }
+
+    /**
+     * Returns the cache shared by the scene graph nodes.
+     *
+     * This cache is created on first use and lives until the program exits.
+     *
+     * @return the cache shared by the scene graph nodes.
+     */
+    static TriangulationCache* get();
+
+#pragma mark -
+#pragma mark Attributes
+    /**
+     * Returns the maximum number of cached triangulations.
+     *
+     * @return the maximum number of cached triangulations.
+     */
+    size_t getCapacity() const;
+
+    /**
+     * Sets the maximum number of cached triangulations.
+     *
+     * If the cache has more entries than the new capacity, the least
+     * recently used entries are discarded.
+     *
+     * @param capacity  The maximum number of cached triangulations
+     */
+    void setCapacity(size_t capacity);
+
+    /**
+     * Returns the number of cached triangulations.
+     *
+     * @return the number of cached triangulations.
+     */
+    size_t size() const;
+
+    /**
+     * Discards all cached triangulations.
+     *
+     * This method does not reset the statistics. Index buffers acquired from
+     * this cache remain valid.
+     */
+    void clear();
+
+#pragma mark -
+#pragma mark Statistics
+    /**
+     * Returns the number of requests answered from the cache.
+     *
+     * @return the number of requests answered from the cache.
+     */
+    Uint64 getHits() const;
+
+    /**
+     * Returns the number of requests that required a triangulation.
+     *
+     * @return the number of requests that required a triangulation.
+     */
+    Uint64 getMisses() const;
+
+    /**
+     * Returns the fraction of requests answered from the cache.
+     *
+     * If there have been no requests, this method returns 0.
+     *
+     * @return the fraction of requests answered from the cache.
+     */
+    float getHitRate() const;
+
+    /**
+     * Resets the number of hits and misses to 0.
+     */
+    void resetStatistics();
+
+#pragma mark -
+#pragma mark Triangulation
+    /**
+     * Returns the triangulation of the given vertices.
+     *
+     * The vertices must define a simple polygon, with no holes. The result is
+     * the same as the triangulation produced by the factory for the given
+     * algorithm. It is shared with every other polygon with the same vertices,
+     * and so it may not be modified.
+     *
+     * @param vertices  The polygon vertices
+     * @param size      The number of vertices
+     * @param type      The triangulation algorithm
+     *
+     * @return the triangulation of the given vertices.
+     */
+    std::shared_ptr<const std::vector<Uint32>> triangulate(const Vec2* vertices, size_t size,
+                                                           poly2::Triangulation type=poly2::Triangulation::MONOTONE);
+
+    /**
+     * Returns the triangulation of the given vertices.
+     *
+     * The vertices must define a simple polygon, with no holes. The result is
+     * the same as the triangulation produced by the factory for the given
+     * algorithm. It is shared with every other polygon with the same vertices,
+     * and so it may not be modified.
+     *
+     * @param vertices  The polygon vertices
+     * @param type      The triangulation algorithm
+     *
+     * @return the triangulation of the given vertices.
+     */
+    std::shared_ptr<const std::vector<Uint32>> triangulate(const std::vector<Vec2>& vertices,
+                                                           poly2::Triangulation type=poly2::Triangulation::MONOTONE) {
+        return triangulate(vertices.data(), vertices.size(), type);
+    }
+
+    /**
+     * Stores the triangulation of the given vertices in the buffer.
+     *
+     * The buffer is reset to a `SOLID` polygon with the given vertices and
+     * their triangulation. The geometry is assigned directly, without the
+     * scan of {@link Geometry#categorize}.
+     *
+     * @param vertices  The polygon vertices
+     * @param buffer    The buffer to store the polygon
+     * @param type      The triangulation algorithm
+     *
+     * @return a reference to the buffer for chaining.
+     */
+    Poly2* triangulate(const std::vector<Vec2>& vertices, Poly2* buffer,
+                       poly2::Triangulation type=poly2::Triangulation::MONOTONE);
+
+    /**
+     * Returns the hash for the given vertices and triangulation algorithm.
+     *
+     * The hash only depends on the values of the vertices (so 0 and -0 are
+     * the same), and it does not allocate memory.
+     *
+     * @param vertices  The polygon vertices
+     * @param size      The number of vertices
+     * @param type      The triangulation algorithm
+     *
+     * @return the hash for the given vertices and triangulation algorithm.
+     */
+    static Uint64 hash(const Vec2* vertices, size_t size, poly2::Triangulation type);
+
+#pragma mark -
+#pragma mark Internal Helpers
+private:
+    /**
+     * Returns the cached triangulation of the given vertices.
+     *
+     * If the triangulation is found, its entry becomes the most recently used
+     * one. Otherwise, this method returns nullptr. The statistics are not
+     * changed. This method assumes the lock is held.
+     *
+     * @param key       The hash of the vertices and algorithm
+     * @param vertices  The polygon vertices
+     * @param size      The number of vertices
+     * @param type      The triangulation algorithm
+     *
+     * @return the cached triangulation of the given vertices.
+     */
+    std::shared_ptr<const std::vector<Uint32>> find(Uint64 key, const Vec2* vertices, size_t size,
+                                                    poly2::Triangulation type);
+
+    /**
+     * Discards the least recently used entries until the cache fits.
+     *
+     * This method assumes the lock is held.
+     *
+     * @param capacity  The number of entries to keep
+     */
+    void trim(size_t capacity);
+};
+
+}
+
+#endif /* __CU_TRIANGULATION_CACHE_H__ */
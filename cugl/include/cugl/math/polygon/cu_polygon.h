@@ -35,6 +35,8 @@
 #include "CUComplexExtruder.h"
 #include "CUSimpleTriangulator.h"
 #include "CUComplexTriangulator.h"
+#include "CUPolyClipper.h"
 #include "CUPathSmoother.h"
+#include "CUTriangulationCache.h"
 
 #endif /* __CU_POLYGON_PKG_H__ */
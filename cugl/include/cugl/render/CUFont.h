@@ -58,6 +58,11 @@
 #include <SDL/SDL_ttf.h>
 
 namespace cugl {
+
+/** Forward reference to the glyph cache */
+class GlyphCache;
+/** Forward reference to the thread pool */
+class ThreadPool;
     
 /**
  * This class represents a true type font at a fixed size.
@@ -258,6 +263,8 @@ protected:
     // Altas support
     /** Whether this font has an active atlas */
     bool _hasAtlas;
+    /** The distance field spread in pixels (0 for a coverage atlas) */
+    int _spread;
     /** The set of (unicode) glyphs supported by this atlas */
     std::vector<Uint32> _glyphset;
     /** The location of each glyph in the atlas texture */
@@ -270,6 +277,18 @@ protected:
     std::shared_ptr<Texture> _texture;
     /** A (temporary) SDL surface for computing the atlas texture */
     SDL_Surface* _surface;
+    
+    // Glyph cache support
+    /** The file with the font asset (to create the glyph cache) */
+    std::string _source;
+    /** The dynamic glyph cache, used when there is no atlas */
+    std::shared_ptr<GlyphCache> _cache;
+    /** The thread pool for glyph rasterization (may be nullptr) */
+    std::shared_ptr<ThreadPool> _threads;
+    /** The number of times meshes from this font have been invalidated */
+    Uint64 _generation;
+    /** The glyph cache evictions at the last generation update */
+    Uint64 _evictions;
 
     
 public:
@@ -312,6 +331,20 @@ public:
      */
     bool init(const std::string file, int size);
     
+    /**
+     * Replaces the contents of this font with those of the given font.
+     *
+     * This method is used to hot reload fonts. Every object holding this font
+     * sees the new glyphs. If this font has an atlas texture, that texture
+     * object is refilled rather than replaced. Text that has already been
+     * converted to a mesh keeps its old layout until it is regenerated.
+     *
+     * The given font is disposed by this method. This method must be called
+     * on the main thread, as it may touch OpenGL.
+     *
+     * @param font  The font to take the contents from
+     */
+    void reload(Font& font);
     
 #pragma mark -
 #pragma mark Static Constructors
@@ -558,6 +591,50 @@ public:
      */
     void setResolution(Resolution resolution) { clearAtlas(); _render = resolution; }
 
+    /**
+     * Returns the distance field spread in pixels (0 if there is none).
+     *
+     * If this value is positive, the atlas stores a signed distance field
+     * instead of glyph coverage. Each texel records the distance to the
+     * nearest glyph edge, clamped to the spread. A distance field atlas
+     * should be drawn with {@link SpriteBatch#setDistanceField}, as it
+     * may then be scaled without blurring, and support outlines and shadows
+     * up to the spread in width.
+     *
+     * @return the distance field spread in pixels (0 if there is none).
+     */
+    int getDistanceSpread() const { return _spread; }
+
+    /**
+     * Sets the distance field spread in pixels (0 if there is none).
+     *
+     * Changing this value will delete any atlas that is present.  The atlas
+     * must be regenerated.
+     *
+     * If this value is positive, the atlas stores a signed distance field
+     * instead of glyph coverage. Each texel records the distance to the
+     * nearest glyph edge, clamped to the spread. A distance field atlas
+     * should be drawn with {@link SpriteBatch#setDistanceField}, as it
+     * may then be scaled without blurring, and support outlines and shadows
+     * up to the spread in width.
+     *
+     * The glyph cache does not support distance fields, so this setting
+     * only has an effect when the font has an atlas.
+     *
+     * @param spread    The distance field spread in pixels
+     */
+    void setDistanceSpread(int spread);
+
+    /**
+     * Returns true if this font renders from a distance field atlas.
+     *
+     * This is true if the font has an atlas and a positive spread. Text
+     * from such a font must be drawn with {@link SpriteBatch#setDistanceField}.
+     *
+     * @return true if this font renders from a distance field atlas.
+     */
+    bool hasDistanceField() const { return _hasAtlas && _spread > 0; }
+
 
     
 #pragma mark -
@@ -694,7 +771,9 @@ public:
     /**
      * Deletes the current atlas
      * 
-     * The font will use direct rendering until a new atlas is created.
+     * The font will use the glyph cache until a new atlas is created. As this
+     * method is called whenever the font settings change, it also deletes the
+     * glyph cache, so that glyphs are rasterized with the new settings.
      */
     void clearAtlas();
 
@@ -803,6 +882,76 @@ public:
      */
     bool hasAtlas() const { return _hasAtlas; }
     
+#pragma mark -
+#pragma mark Glyph Cache
+    /**
+     * Returns the dynamic glyph cache for this font.
+     *
+     * The glyph cache is used to render text when this font does not have an
+     * atlas. Glyphs are rasterized the first time they are used and packed
+     * into texture pages. The cache is created on first use, and is deleted
+     * whenever the font settings change.
+     *
+     * This method returns nullptr if the cache could not be created.
+     *
+     * @return the dynamic glyph cache for this font.
+     */
+    const std::shared_ptr<GlyphCache>& getGlyphCache();
+
+    /**
+     * Returns the thread pool for glyph rasterization.
+     *
+     * If this value is not nullptr, the glyphs requested by {@link #prefetch}
+     * are rasterized on a worker thread. Otherwise, they are rasterized
+     * immediately. This value has no effect if this font has an atlas.
+     *
+     * @return the thread pool for glyph rasterization.
+     */
+    const std::shared_ptr<ThreadPool>& getThreadPool() const { return _threads; }
+    
+    /**
+     * Sets the thread pool for glyph rasterization.
+     *
+     * If this value is not nullptr, the glyphs requested by {@link #prefetch}
+     * are rasterized on a worker thread. Otherwise, they are rasterized
+     * immediately. This value has no effect if this font has an atlas.
+     *
+     * @param threads   The thread pool for glyph rasterization.
+     */
+    void setThreadPool(const std::shared_ptr<ThreadPool>& threads);
+    
+    /**
+     * Rasterizes the glyphs for this string in advance.
+     *
+     * If this font does not have an atlas, the glyphs missing from the glyph
+     * cache are rasterized so that they are ready when the string is rendered.
+     * If this font has a thread pool, this rasterization takes place on a
+     * worker thread.
+     *
+     * This method does nothing if this font has an atlas, or if the glyph
+     * cache has not been created yet. The cache is created the first time
+     * that text is rendered without an atlas.
+     *
+     * The string may either be in UTF8 or ASCII; the method will handle
+     * conversion automatically.
+     *
+     * @param text  The string to rasterize
+     * @param utf8  Whether the string is a UTF8 that must be decoded.
+     */
+    void prefetch(const std::string text, bool utf8=true);
+    
+    /**
+     * Returns the generation of the meshes created by this font.
+     *
+     * The generation changes whenever a mesh created by this font may no
+     * longer be valid. This happens when the atlas is deleted, when the font
+     * is reloaded, or when the glyph cache evicts a glyph. Any mesh created
+     * in an earlier generation should be rebuilt before it is drawn.
+     *
+     * @return the generation of the meshes created by this font.
+     */
+    Uint64 getGeneration() const { return _generation; }
+    
 #pragma mark -
 #pragma mark Rendering
     /**
@@ -822,7 +971,7 @@ public:
      * including the descent.  It is not the position of the baseline.
      *
      * If this font has an atlas, it will return the atlas texture.  Otherwise,
-     * it is returning a unique texture specifically generated for this string.
+     * it returns the page of the glyph cache containing the glyphs.
      *
      * This method will fail if the string is not supported by this font.
      *
@@ -857,7 +1006,7 @@ public:
      * including the descent.  It is not the position of the baseline.
      *
      * If this font has an atlas, it will return the atlas texture.  Otherwise,
-     * it is returning a unique texture specifically generated for this string.
+     * it returns the page of the glyph cache containing the glyphs.
      *
      * @param text      The string to convert to render data.
      * @param origin    The position of the first character
@@ -887,7 +1036,7 @@ public:
      * @param mesh      The mesh to store the vertices
      *
      * If this font has an atlas, it will return the atlas texture.  Otherwise,
-     * it is returning a unique texture specifically generated for this string.
+     * it returns the page of the glyph cache containing the glyphs.
      *
      * @return the texture associated with the mesh
      */
@@ -909,7 +1058,7 @@ public:
      * the character is not supported by this font.
      *
      * If this font has an atlas, it will return the atlas texture.  Otherwise,
-     * it is returning a unique texture specifically generated for this string.
+     * it returns the page of the glyph cache containing the glyphs.
      *
      * @param thechar   The character to convert to render data
      * @param offset    The (unkerned) starting position of the quad
@@ -938,7 +1087,7 @@ public:
      * including the descent.  It is not the position of the baseline.
      *
      * If this font has an atlas, it will return the atlas texture.  Otherwise,
-     * it is returning a unique texture specifically generated for this string.
+     * it returns the page of the glyph cache containing the glyphs.
      *
      * This method will fail if the string is not supported by this font.
      *
@@ -974,7 +1123,7 @@ public:
      * including the descent.  It is not the position of the baseline.
      *
      * If this font has an atlas, it will return the atlas texture.  Otherwise,
-     * it is returning a unique texture specifically generated for this string.
+     * it returns the page of the glyph cache containing the glyphs.
      *
      * @param text      The string to convert to render data.
      * @param origin    The position of the first character
@@ -1006,7 +1155,7 @@ public:
      * @param z         The uniform z-offset in 3-d space
      *
      * If this font has an atlas, it will return the atlas texture.  Otherwise,
-     * it is returning a unique texture specifically generated for this string.
+     * it returns the page of the glyph cache containing the glyphs.
      *
      * @return the texture associated with the mesh
      */
@@ -1028,7 +1177,7 @@ public:
      * the character is not supported by this font.
      *
      * If this font has an atlas, it will return the atlas texture.  Otherwise,
-     * it is returning a unique texture specifically generated for this string.
+     * it returns the page of the glyph cache containing the glyphs.
      *
      * @param thechar   The character to convert to render data
      * @param offset    The (unkerned) starting position of the quad
@@ -1074,8 +1223,8 @@ protected:
      *
      * This method will append the vertices to the provided mesh and update
      * the indices to include these new vertices.  In addition, it will return
-     * the texture that should be used with these vertices. If this is an atlas,
-     * the texture will be that atlas.
+     * the texture that should be used with these vertices. This is the page
+     * of the glyph cache containing all of the glyphs.
      *
      * The quad sequence is adjusted so that all of the vertices fit in the
      * provided rectangle.  This may mean that some of the glyphs are truncated
@@ -1097,8 +1246,8 @@ protected:
      *
      * @return the texture associated with the quads
      */
-    std::shared_ptr<Texture> getRenderedMesh(const std::string text, const Vec2 origin,
-                                             const Rect rect, Mesh<SpriteVertex2>& mesh, bool utf8);
+    std::shared_ptr<Texture> getCachedMesh(const std::string text, const Vec2 origin,
+                                           const Rect rect, Mesh<SpriteVertex2>& mesh, bool utf8);
     
     /**
      * Creates a single quad to render this character and stores it in the mesh
@@ -1127,8 +1276,8 @@ protected:
      *
      * This method will append the vertices to the provided mesh and update
      * the indices to include these new vertices.  In addition, it will return
-     * the texture that should be used with these vertices. If this is an atlas,
-     * the texture will be that atlas.
+     * the texture that should be used with these vertices. This is the page
+     * of the glyph cache containing the glyph.
      *
      * The quad is adjusted so that all of the vertices fit in the provided
      * rectangle.  This may mean that no quad is generated at all.
@@ -1144,8 +1293,33 @@ protected:
      *
      * @return the texture associated with the quads
      */
-    std::shared_ptr<Texture> getRenderedQuad(Uint32 thechar, Vec2& offset, const Rect rect,
-                                             Mesh<SpriteVertex2>& mesh);
+    std::shared_ptr<Texture> getCachedQuad(Uint32 thechar, Vec2& offset, const Rect rect,
+                                           Mesh<SpriteVertex2>& mesh);
+    
+    /**
+     * Creates a single quad to render a glyph and stores it in the mesh
+     *
+     * This method will append the vertices to the given mesh and update
+     * the indices to include these new vertices. The glyph is the region of
+     * the texture with the given bounds (with the origin at the top left).
+     * The quad is adjusted so that all of the vertices fit in the provided
+     * rectangle. This may mean that no quad is generated at all.
+     *
+     * This method will return false if the right edge of the glyph is not
+     * rendered. This lets us know if a character has exceeded the bounding
+     * rectangle.  Without this, kerning may move the next character back
+     * into range.
+     *
+     * @param bounds    The glyph bounds in the texture
+     * @param texture   The texture containing the glyph
+     * @param offset    The (unkerned) starting position of the quad
+     * @param rect      The bounding box for the quad
+     * @param mesh      The mesh to store the vertices
+     *
+     * @return true if the right edge of the glyph was generated
+     */
+    bool getGlyphQuad(Rect bounds, const Texture& texture, Vec2& offset, const Rect rect,
+                      Mesh<SpriteVertex2>& mesh);
 
     /**
      * Creates quads to render this string and stores them in the mesh
@@ -1178,8 +1352,8 @@ protected:
      *
      * This method will append the vertices to the provided mesh and update
      * the indices to include these new vertices.  In addition, it will return
-     * the texture that should be used with these vertices. If this is an atlas,
-     * the texture will be that atlas.
+     * the texture that should be used with these vertices. This is the page
+     * of the glyph cache containing all of the glyphs.
      *
      * The quad sequence is adjusted so that all of the vertices fit in the
      * provided rectangle.  This may mean that some of the glyphs are truncated
@@ -1202,9 +1376,8 @@ protected:
      *
      * @return the texture associated with the quads
      */
-    std::shared_ptr<Texture> getRenderedMesh(const std::string text, const Vec2 origin,
-                                             const Rect rect, Mesh<SpriteVertex3>& mesh,
-                                             float z, bool utf8);
+    std::shared_ptr<Texture> getCachedMesh(const std::string text, const Vec2 origin,
+                                           const Rect rect, Mesh<SpriteVertex3>& mesh, float z, bool utf8);
     
     /**
      * Creates a single quad to render this character and stores it in the mesh
@@ -1235,8 +1408,8 @@ protected:
      *
      * This method will append the vertices to the provided mesh and update
      * the indices to include these new vertices.  In addition, it will return
-     * the texture that should be used with these vertices. If this is an atlas,
-     * the texture will be that atlas.
+     * the texture that should be used with these vertices. This is the page
+     * of the glyph cache containing the glyph.
      *
      * The quad is adjusted so that all of the vertices fit in the provided
      * rectangle.  This may mean that no quad is generated at all.
@@ -1253,8 +1426,43 @@ protected:
      *
      * @return the texture associated with the quads
      */
-    std::shared_ptr<Texture> getRenderedQuad(Uint32 thechar, Vec2& offset, const Rect rect,
-                                             Mesh<SpriteVertex3>& mesh, float z);
+    std::shared_ptr<Texture> getCachedQuad(Uint32 thechar, Vec2& offset, const Rect rect,
+                                           Mesh<SpriteVertex3>& mesh, float z);
+    
+    /**
+     * Creates a single quad to render a glyph and stores it in the mesh
+     *
+     * This method will append the vertices to the given mesh and update
+     * the indices to include these new vertices. The glyph is the region of
+     * the texture with the given bounds (with the origin at the top left).
+     * The quad is adjusted so that all of the vertices fit in the provided
+     * rectangle. This may mean that no quad is generated at all.
+     *
+     * This method will return false if the right edge of the glyph is not
+     * rendered. This lets us know if a character has exceeded the bounding
+     * rectangle.  Without this, kerning may move the next character back
+     * into range.
+     *
+     * @param bounds    The glyph bounds in the texture
+     * @param texture   The texture containing the glyph
+     * @param offset    The (unkerned) starting position of the quad
+     * @param rect      The bounding box for the quad
+     * @param mesh      The mesh to store the vertices
+     * @param z         The uniform z-offset in 3-d space
+     *
+     * @return true if the right edge of the glyph was generated
+     */
+    bool getGlyphQuad(Rect bounds, const Texture& texture, Vec2& offset, const Rect rect,
+                      Mesh<SpriteVertex3>& mesh, float z);
+    
+    /**
+     * Updates the generation if the glyph cache has evicted any glyphs.
+     *
+     * Any mesh built before an eviction may refer to a glyph that is no
+     * longer in the cache.
+     */
+    void syncGeneration();
+    
     /**
      * Returns the size (in pixels) necessary to render this string.
      *
@@ -1404,6 +1612,16 @@ protected:
      */
     int computeKerning(Uint32 a, Uint32 b) const;
 
+    /**
+     * Returns the total border (both sides) around each glyph in the atlas.
+     *
+     * The border prevents bleeding between glyphs. A distance field atlas
+     * also needs room for the spread on either side of each glyph.
+     *
+     * @return the total border (both sides) around each glyph in the atlas.
+     */
+    int computeBorder() const;
+
     /**
      * Computes the size of the atlas texture
      *
@@ -1440,6 +1658,17 @@ protected:
      * @param rectangle A plan for the atlas as a rectangular array of characters.
      */
     void layoutAtlas(const std::vector< std::vector<Uint32> >& rectangle);
+
+    /**
+     * Converts the glyph coverage in the SDL surface to a distance field.
+     *
+     * Each texel is assigned the signed distance to the nearest glyph edge,
+     * scaled so that the spread maps to [0,1], with the edge at 0.5. The
+     * distance is stored in the alpha channel, leaving the color white. The
+     * glyphs are far enough apart that this can be done for the whole atlas
+     * at once.
+     */
+    void computeDistanceField();
     
     /**
      * Generates an SDL surface for the font atlas.
@@ -0,0 +1,470 @@
+//
+//  CUGlyphCache.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a dynamic glyph cache for fonts without an atlas.
+//  Glyphs are rasterized the first time that they are used, and are packed
+//  into a small number of texture pages. This means that text outside of a
+//  fixed character set (such as localized text) can still be drawn from an
+//  atlas, instead of creating a new texture every time the text changes.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: agent
+//  Version: 10/19/26
+//
+#ifndef __CU_GLYPH_CACHE_H__
+#define __CU_GLYPH_CACHE_H__
+
+#include <cugl/math/CURect.h>
+#include <cugl/render/CUFont.h>
+#include <cugl/render/CUTexture.h>
+#include <SDL/SDL_ttf.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace cugl {
+
+/** Forward reference to the thread pool */
+class ThreadPool;
+
+/**
+ * This class is a dynamic glyph cache for a single font.
+ *
+ * Glyphs are rasterized on first use and packed into texture pages. Every
+ * page is a square texture divided into shelves of the font height. A new
+ * glyph is placed in the first shelf with enough room, and is uploaded to
+ * the page with {@link Texture#update}. So adding a glyph never uploads
+ * the entire page.
+ *
+ * All glyphs of a single request (typically a string) are placed on the
+ * same page, so that the string may be drawn with one texture. A glyph may
+ * be resident on more than one page. When every page is full, the least
+ * recently used glyphs of a page are evicted to make room. An eviction
+ * invalidates any mesh built from the evicted glyph, so the cache counts
+ * evictions, and any mesh built before the last eviction should be rebuilt.
+ *
+ * Glyphs may be rasterized ahead of time with {@link #prefetch}. If the
+ * cache has a thread pool, this rasterization takes place on a worker
+ * thread, and the glyphs are uploaded the next time they are requested.
+ * The cache has its own copy of the font, so the worker never competes
+ * with the owning {@link Font} for the SDL data.
+ *
+ * With the exception of {@link #prefetch}, all methods of this class must
+ * be called on the main thread, as they use OpenGL.
+ */
+class GlyphCache {
+#pragma mark Values
+private:
+    /** A free span of pixels on a shelf */
+    struct Span {
+        /** The left edge of the span */
+        int x;
+        /** The width of the span */
+        int width;
+    };
+
+    /** A single texture page */
+    struct Page {
+        /** The texture for this page */
+        std::shared_ptr<Texture> texture;
+        /** The free spans of each shelf, sorted from left to right */
+        std::vector<std::vector<Span>> shelves;
+    };
+
+    /** A glyph resident on a page */
+    struct Slot {
+        /** The glyph bounds in the page (without the border) */
+        Rect bounds;
+        /** The request in which the glyph was last used */
+        Uint64 used;
+    };
+
+    /**
+     * The rasterization state shared with the worker thread.
+     *
+     * This state is separate from the cache so that a queued task never
+     * keeps the texture pages alive. The pages must be deleted on the main
+     * thread, but this state may be deleted on any thread.
+     */
+    struct Rasterizer {
+        /** The copy of the font used for rasterization */
+        TTF_Font* data;
+        /** The rendering resolution of the font */
+        Font::Resolution render;
+        /** The height of a rasterized glyph (including the border) */
+        int height;
+        /** The glyphs rasterized in advance, waiting to be uploaded */
+        std::unordered_map<Uint32, SDL_Surface*> pending;
+        /** The glyphs currently queued for rasterization */
+        std::unordered_set<Uint32> queued;
+        /** The number of pages on which each glyph is resident */
+        std::unordered_map<Uint32, Uint32> resident;
+        /** The lock guarding the pending, queued and resident glyphs */
+        std::mutex lock;
+        /** The lock guarding the font data */
+        std::mutex fontLock;
+
+        /** Creates an empty rasterizer */
+        Rasterizer() : data(nullptr), render(Font::Resolution::BLENDED), height(0) {}
+
+        /** Deletes this rasterizer, closing the font and all pending surfaces */
+        ~Rasterizer();
+    };
+
+    /** The rasterization state (shared with the worker thread) */
+    std::shared_ptr<Rasterizer> _rasterizer;
+    /** The height of a single shelf (including the border) */
+    int _shelfHeight;
+    /** The width and height of each page */
+    int _pageSize;
+    /** The maximum number of pages */
+    size_t _maxPages;
+
+    /** The texture pages */
+    std::vector<Page> _pages;
+    /** The resident glyphs, keyed by page and glyph */
+    std::unordered_map<Uint64, Slot> _slots;
+    /** The glyphs rasterized in advance, taken from the rasterizer */
+    std::unordered_map<Uint32, SDL_Surface*> _ready;
+    /** The glyphs not supported by the font */
+    std::unordered_set<Uint32> _missing;
+    /** The number of requests so far */
+    Uint64 _tick;
+    /** The number of evictions so far */
+    Uint64 _evictions;
+    /** The thread pool for rasterization (may be nullptr) */
+    std::shared_ptr<ThreadPool> _threads;
+
+#pragma mark -
+#pragma mark Constructors
+public:
+    /**
+     * Creates a degenerate glyph cache with no font.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+     * the heap, use one of the static constructors instead.
+     */
+    GlyphCache();
+
+    /**
+     * Deletes this glyph cache, disposing of all resources.
+     */
+    ~GlyphCache() { dispose(); }
+
+    /**
+     * Deletes the glyph cache resources and resets all attributes.
+     *
+     * This deletes all texture pages. Glyphs queued for rasterization on
+     * a worker thread are discarded.
+     */
+    void dispose();
+
+    /**
+     * Initializes a glyph cache for the given font file.
+     *
+     * The font is opened a second time, so that glyphs may be rasterized
+     * while the owning font is in use. The style, hinting and resolution
+     * must match those of the owning font. If they change, the cache must
+     * be replaced.
+     *
+     * @param file          The file with the font asset
+     * @param size          The font size in points
+     * @param style         The font face style
+     * @param hinting       The rasterization hints
+     * @param resolution    The rendering resolution
+     *
+     * @return true if initialization is successful.
+     */
+    bool init(const std::string file, int size, Font::Style style,
+              Font::Hinting hinting, Font::Resolution resolution);
+
+    /**
+     * Returns a newly allocated glyph cache for the given font file.
+     *
+     * The font is opened a second time, so that glyphs may be rasterized
+     * while the owning font is in use. The style, hinting and resolution
+     * must match those of the owning font. If they change, the cache must
+     * be replaced.
+     *
+     * @param file          The file with the font asset
+     * @param size          The font size in points
+     * @param style         The font face style
+     * @param hinting       The rasterization hints
+     * @param resolution    The rendering resolution
+     *
+     * @return a newly allocated glyph cache for the given font file.
+     */
+    static std::shared_ptr<GlyphCache> alloc(const std::string file, int size, Font::Style style,
+                                             Font::Hinting hinting, Font::Resolution resolution) {
+        std::shared_ptr<GlyphCache> result = std::make_shared<GlyphCache>();
+        return (result->init(file,size,style,hinting,resolution) ? result : nullptr);
+    }
+
+#pragma mark -
+#pragma mark Attributes
+    /**
+     * Returns the width and height of each texture page.
+     *
+     * The page size is chosen from the font height, so that every page has
+     * room for several hundred glyphs.
+     *
+     * @return the width and height of each texture page.
+     */
+    int getPageSize() const { return _pageSize; }
+
+    /**
+     * Returns the number of texture pages currently allocated.
+     *
+     * @return the number of texture pages currently allocated.
+     */
+    size_t getPageCount() const { return _pages.size(); }
+
+    /**
+     * Returns the maximum number of texture pages.
+     *
+     * Once this many pages are allocated, new glyphs evict the least recently
+     * used glyphs of a page.
+     *
+     * @return the maximum number of texture pages.
+     */
+    size_t getMaxPages() const { return _maxPages; }
+
+    /**
+     * Sets the maximum number of texture pages.
+     *
+     * Once this many pages are allocated, new glyphs evict the least recently
+     * used glyphs of a page. Pages that are already allocated are kept, even
+     * if there are more than this number. The value must be at least 1.
+     *
+     * @param pages The maximum number of texture pages.
+     */
+    void setMaxPages(size_t pages);
+
+    /**
+     * Returns the number of glyphs resident in the cache.
+     *
+     * A glyph resident on several pages is counted once for each page.
+     *
+     * @return the number of glyphs resident in the cache.
+     */
+    size_t size() const { return _slots.size(); }
+
+    /**
+     * Returns the number of glyphs evicted so far.
+     *
+     * Any mesh built before the last eviction may refer to a glyph that is
+     * no longer in the cache, and should be rebuilt.
+     *
+     * @return the number of glyphs evicted so far.
+     */
+    Uint64 getEvictions() const { return _evictions; }
+
+    /**
+     * Returns the thread pool for rasterization.
+     *
+     * If this value is nullptr, glyphs are only rasterized on demand.
+     *
+     * @return the thread pool for rasterization.
+     */
+    const std::shared_ptr<ThreadPool>& getThreadPool() const { return _threads; }
+
+    /**
+     * Sets the thread pool for rasterization.
+     *
+     * If this value is nullptr, glyphs are only rasterized on demand.
+     *
+     * @param threads   The thread pool for rasterization.
+     */
+    void setThreadPool(const std::shared_ptr<ThreadPool>& threads) { _threads = threads; }
+
+#pragma mark -
+#pragma mark Glyph Access
+    /**
+     * Returns the page containing all of the given glyphs.
+     *
+     * The glyphs are rasterized and uploaded if necessary. The page chosen
+     * is the one with the most glyphs already resident. If it does not have
+     * room, the glyphs are placed on a new page, or (if there are already
+     * the maximum number of pages) the least recently used glyphs of the
+     * page are evicted. Glyphs that are not supported by the font, or that
+     * cannot fit on a page, are skipped.
+     *
+     * This method returns -1 if there are no glyphs to place.
+     *
+     * @param glyphs    The (Unicode) glyphs to place
+     * @param size      The number of glyphs
+     *
+     * @return the page containing all of the given glyphs.
+     */
+    int acquire(const Uint32* glyphs, size_t size);
+
+    /**
+     * Returns the texture for the given page.
+     *
+     * @param page  The page index
+     *
+     * @return the texture for the given page.
+     */
+    const std::shared_ptr<Texture>& getTexture(int page) const {
+        return _pages[page].texture;
+    }
+
+    /**
+     * Returns true if the glyph is resident on the given page.
+     *
+     * If the glyph is resident, its bounds (in pixels, with the origin at
+     * the top left of the page) are stored in the rectangle.
+     *
+     * @param page      The page index
+     * @param glyph     The (Unicode) glyph
+     * @param bounds    The rectangle to store the glyph bounds
+     *
+     * @return true if the glyph is resident on the given page.
+     */
+    bool getBounds(int page, Uint32 glyph, Rect& bounds) const;
+
+    /**
+     * Rasterizes the given glyphs in advance.
+     *
+     * If there is a thread pool, the glyphs are rasterized on a worker
+     * thread. Otherwise, they are rasterized immediately. Either way, they
+     * are not uploaded until they are requested by {@link #acquire}. Glyphs
+     * that are already resident are ignored.
+     *
+     * This method is thread safe. It may be called in any thread.
+     *
+     * @param glyphs    The (Unicode) glyphs to rasterize
+     * @param size      The number of glyphs
+     */
+    void prefetch(const Uint32* glyphs, size_t size);
+
+    /**
+     * Deletes all texture pages and resident glyphs.
+     *
+     * This counts as an eviction of every resident glyph.
+     */
+    void clear();
+
+#pragma mark -
+#pragma mark Internal Helpers
+private:
+    /**
+     * Returns the key for a glyph on a page.
+     *
+     * @param page  The page index
+     * @param glyph The (Unicode) glyph
+     *
+     * @return the key for a glyph on a page.
+     */
+    static Uint64 key(int page, Uint32 glyph) {
+        return ((Uint64)page << 32) | glyph;
+    }
+
+    /**
+     * Returns a newly rasterized glyph surface.
+     *
+     * The surface is in RGBA format, and includes a transparent border
+     * around the glyph. This method returns nullptr if the glyph is not
+     * supported. It is safe to call from any thread.
+     *
+     * @param raster    The rasterization state
+     * @param glyph     The (Unicode) glyph
+     *
+     * @return a newly rasterized glyph surface.
+     */
+    static SDL_Surface* rasterize(Rasterizer* raster, Uint32 glyph);
+
+    /**
+     * Rasterizes the queued glyphs, storing them as pending.
+     *
+     * This is the task executed on the worker thread.
+     *
+     * @param raster    The rasterization state
+     * @param glyphs    The glyphs to rasterize
+     */
+    static void rasterize(Rasterizer* raster, const std::vector<Uint32>& glyphs);
+
+    /**
+     * Returns the surface for the given glyph.
+     *
+     * This method uses the surface rasterized in advance if there is one.
+     * The caller takes ownership of the surface.
+     *
+     * @param glyph The (Unicode) glyph
+     *
+     * @return the surface for the given glyph.
+     */
+    SDL_Surface* obtain(Uint32 glyph);
+
+    /**
+     * Returns the index of a newly allocated (empty) page.
+     *
+     * @return the index of a newly allocated (empty) page.
+     */
+    int addPage();
+
+    /**
+     * Places the glyph surface on the given page.
+     *
+     * If the page does not have room, and reclaim is true, the least recently
+     * used glyphs of the page are evicted until it does. This method returns
+     * false if the glyph could not be placed.
+     *
+     * @param page      The page index
+     * @param glyph     The (Unicode) glyph
+     * @param surface   The glyph surface (including the border)
+     * @param reclaim   Whether to evict glyphs to make room
+     *
+     * @return true if the glyph was placed on the page.
+     */
+    bool place(int page, Uint32 glyph, SDL_Surface* surface, bool reclaim);
+
+    /**
+     * Evicts the least recently used glyph of the given page.
+     *
+     * Glyphs used in the current request are never evicted. This method
+     * returns false if there is no glyph to evict.
+     *
+     * @param page  The page index
+     *
+     * @return true if a glyph was evicted.
+     */
+    bool evict(int page);
+};
+
+}
+
+#endif /* __CU_GLYPH_CACHE_H__ */
@@ -63,6 +63,68 @@
 #pragma mark -
 namespace cugl {
 
+/**
+ * This template maps a CUGL type to the GLSL type of a uniform.
+ *
+ * It is only defined for the types supported by {@link UniformHandle}.
+ */
+template <typename T>
+struct UniformTraits;
+
+/** A GLSL float */
+template <> struct UniformTraits<GLfloat> { static constexpr GLenum type = GL_FLOAT; };
+/** A GLSL int (also used for samplers and booleans) */
+template <> struct UniformTraits<GLint>   { static constexpr GLenum type = GL_INT; };
+/** A GLSL unsigned int */
+template <> struct UniformTraits<GLuint>  { static constexpr GLenum type = GL_UNSIGNED_INT; };
+/** A GLSL vec2 */
+template <> struct UniformTraits<Vec2>    { static constexpr GLenum type = GL_FLOAT_VEC2; };
+/** A GLSL vec3 */
+template <> struct UniformTraits<Vec3>    { static constexpr GLenum type = GL_FLOAT_VEC3; };
+/** A GLSL vec4 */
+template <> struct UniformTraits<Vec4>    { static constexpr GLenum type = GL_FLOAT_VEC4; };
+/** A GLSL vec4 storing a color */
+template <> struct UniformTraits<Color4f> { static constexpr GLenum type = GL_FLOAT_VEC4; };
+/** A GLSL mat4 */
+template <> struct UniformTraits<Mat4>    { static constexpr GLenum type = GL_FLOAT_MAT4; };
+
+/**
+ * This class is a typed reference to a uniform in a {@link Shader}.
+ *
+ * A handle is created by {@link Shader#getUniformHandle} and can only be
+ * used with the shader that created it. It stores the location of the
+ * uniform, so setting the uniform requires no string look-up or driver
+ * query. In addition, the type parameter ensures that the uniform is
+ * always set with a value of the correct type.
+ *
+ * A handle is a lightweight value, and should be cached by the caller. A
+ * default handle (or a handle for a uniform that does not exist) is not
+ * valid, and setting it does nothing. Handles are invalidated when the
+ * shader is disposed.
+ */
+template <typename T>
+class UniformHandle {
+public:
+    /** The program for this handle (to detect misuse) */
+    GLuint program;
+    /** The index of this uniform in the shader table (-1 if invalid) */
+    GLint  slot;
+    /** The program location of this uniform (-1 if invalid) */
+    GLint  location;
+    
+    /**
+     * Creates an invalid uniform handle.
+     */
+    UniformHandle() : program(0), slot(-1), location(-1) {}
+    
+    /**
+     * Returns true if this handle refers to an active uniform.
+     *
+     * @return true if this handle refers to an active uniform.
+     */
+    bool isValid() const { return slot >= 0; }
+};
+
 /**
  * This class defines a GLSL shader.
  *
@@ -149,6 +211,24 @@ protected:
     /** Mappings of uniforms to a uniform block */
     std::unordered_map<GLint, GLint>        _uniblockfields;
 
+    /** A uniform variable, with the last value set by a handle */
+    struct Uniform {
+        /** The program location (-1 for uniform block members) */
+        GLint  location;
+        /** The uniform type */
+        GLenum type;
+        /** Whether the shadow value agrees with the program */
+        bool   cached;
+        /** The shadow value (large enough for a mat4) */
+        GLfloat shadow[16];
+    };
+    /** The uniform table, indexed by active uniform index */
+    std::vector<Uniform> _uniforms;
+    /** The table index for each uniform name */
+    std::unordered_map<std::string, GLint> _uniformslots;
+    /** The table index for each uniform location */
+    std::unordered_map<GLint, GLint> _uniformlocales;
+
     
 #pragma mark -
 #pragma mark Compilation
@@ -208,6 +288,46 @@ private:
      */
     void cacheUniforms();
     
+    /**
+     * Returns the table index of the given uniform, checking its type.
+     *
+     * If name is not a valid uniform, or it does not have the given type,
+     * this method returns -1. The type GL_INT also matches booleans and
+     * samplers.
+     *
+     * @param name  The uniform variable name
+     * @param type  The expected uniform type
+     *
+     * @return the table index of the given uniform, checking its type.
+     */
+    GLint getUniformSlot(const std::string& name, GLenum type) const;
+    
+    /**
+     * Returns true if the value differs from the shadow value of a uniform.
+     *
+     * If the value differs (or there is no shadow value), it becomes the new
+     * shadow value, and the caller should upload it. This method returns
+     * false if the slot is invalid.
+     *
+     * @param slot      The table index of the uniform
+     * @param program   The program that issued the handle
+     * @param value     The value to upload
+     * @param size      The size of the value in bytes
+     *
+     * @return true if the value differs from the shadow value of a uniform.
+     */
+    bool updateShadow(GLint slot, GLuint program, const void* value, size_t size);
+    
+    /**
+     * Discards the shadow value of the uniform at the given location.
+     *
+     * This is called when a uniform is set without a handle, so that the
+     * next handle update is not skipped.
+     *
+     * @param pos   The location of the uniform in the shader
+     */
+    void forgetUniform(GLint pos);
+    
     
 #pragma mark -
 #pragma mark Constructors
@@ -440,6 +560,137 @@ public:
     GLenum getUniformType(const std::string name) const;
 
     
+#pragma mark -
+#pragma mark Uniform Handles
+    /**
+     * Returns a typed handle for the given uniform
+     *
+     * The uniform locations and types are reflected when the shader is
+     * linked, so this method does not query the driver. The handle should
+     * be cached and reused, as setting a uniform with a handle does no
+     * look-up at all. If name is not a valid uniform, or its GLSL type
+     * does not agree with T, the handle will not be valid.
+     *
+     * @param name  The uniform variable name
+     *
+     * @return a typed handle for the given uniform
+     */
+    template <typename T>
+    UniformHandle<T> getUniformHandle(const std::string& name) const {
+        UniformHandle<T> result;
+        result.slot = getUniformSlot(name, UniformTraits<T>::type);
+        if (result.slot >= 0) {
+            result.program  = _program;
+            result.location = _uniforms[result.slot].location;
+        }
+        return result;
+    }
+
+    /**
+     * Sets the uniform for the given handle to an int value.
+     *
+     * The value is compared to the last value set by a handle. If it has
+     * not changed, nothing is uploaded to the shader.
+     *
+     * This method will only succeed if the shader is actively bound.
+     *
+     * @param handle    The uniform handle
+     * @param value     The value for the uniform
+     */
+    void setUniform(const UniformHandle<GLint>& handle, GLint value);
+
+    /**
+     * Sets the uniform for the given handle to an unsigned int value.
+     *
+     * The value is compared to the last value set by a handle. If it has
+     * not changed, nothing is uploaded to the shader.
+     *
+     * This method will only succeed if the shader is actively bound.
+     *
+     * @param handle    The uniform handle
+     * @param value     The value for the uniform
+     */
+    void setUniform(const UniformHandle<GLuint>& handle, GLuint value);
+
+    /**
+     * Sets the uniform for the given handle to a float value.
+     *
+     * The value is compared to the last value set by a handle. If it has
+     * not changed, nothing is uploaded to the shader.
+     *
+     * This method will only succeed if the shader is actively bound.
+     *
+     * @param handle    The uniform handle
+     * @param value     The value for the uniform
+     */
+    void setUniform(const UniformHandle<GLfloat>& handle, GLfloat value);
+
+    /**
+     * Sets the uniform for the given handle to a vector value.
+     *
+     * The value is compared to the last value set by a handle. If it has
+     * not changed, nothing is uploaded to the shader.
+     *
+     * This method will only succeed if the shader is actively bound.
+     *
+     * @param handle    The uniform handle
+     * @param value     The value for the uniform
+     */
+    void setUniform(const UniformHandle<Vec2>& handle, const Vec2& value);
+
+    /**
+     * Sets the uniform for the given handle to a vector value.
+     *
+     * The value is compared to the last value set by a handle. If it has
+     * not changed, nothing is uploaded to the shader.
+     *
+     * This method will only succeed if the shader is actively bound.
+     *
+     * @param handle    The uniform handle
+     * @param value     The value for the uniform
+     */
+    void setUniform(const UniformHandle<Vec3>& handle, const Vec3& value);
+
+    /**
+     * Sets the uniform for the given handle to a vector value.
+     *
+     * The value is compared to the last value set by a handle. If it has
+     * not changed, nothing is uploaded to the shader.
+     *
+     * This method will only succeed if the shader is actively bound.
+     *
+     * @param handle    The uniform handle
+     * @param value     The value for the uniform
+     */
+    void setUniform(const UniformHandle<Vec4>& handle, const Vec4& value);
+
+    /**
+     * Sets the uniform for the given handle to a color value.
+     *
+     * The value is compared to the last value set by a handle. If it has
+     * not changed, nothing is uploaded to the shader.
+     *
+     * This method will only succeed if the shader is actively bound.
+     *
+     * @param handle    The uniform handle
+     * @param value     The value for the uniform
+     */
+    void setUniform(const UniformHandle<Color4f>& handle, const Color4f& value);
+
+    /**
+     * Sets the uniform for the given handle to a matrix value.
+     *
+     * The value is compared to the last value set by a handle. If it has
+     * not changed, nothing is uploaded to the shader.
+     *
+     * This method will only succeed if the shader is actively bound.
+     *
+     * @param handle    The uniform handle
+     * @param value     The value for the uniform
+     */
+    void setUniform(const UniformHandle<Mat4>& handle, const Mat4& value);
+
+    
 #pragma mark -
 #pragma mark Sampler Properties
     /**
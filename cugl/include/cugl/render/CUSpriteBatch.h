@@ -53,6 +53,8 @@
 #include <cugl/math/CUMathBase.h>
 #include <cugl/math/CUMat4.h>
 #include <cugl/math/CUColor4.h>
+#include <cugl/render/CUShader.h>
+#include <cugl/render/CUScissor.h>
 
 // Default memory sizes
 #define DEFAULT_CAPACITY  8192
@@ -66,9 +68,9 @@ class Shader;
 class Affine2;
 class Texture;
 class Gradient;
-class Scissor;
 class Rect;
 class Poly2;
+class SpriteMesh;
     
 /**
  * This class is a sprite batch for drawing 2d graphics.
@@ -82,7 +84,8 @@ class Poly2;
  * This sprite batch is capable of drawing with an active texture. In that case,
  * the shape will be drawn with a solid color.  If no color has been specified,
  * the default color is white. Outlines use the same texturing rules that solids do.
- * There is also support for a simple, limited radius blur effect on textures.
+ * There is also support for a simple, limited radius blur effect on textures,
+ * and for drawing text from a signed distance field font atlas.
  *
  * Color gradient support is provided by the {@link Gradient} class. All gradients
  * will be tinted by the current color (so the color should be reset to white
@@ -90,7 +93,10 @@ class Poly2;
  *
  * Scissor masks are supported by the {@link Scissor} class. This is useful for
  * constraining shapes to an internal window. A scissor mask must be a transformed
- * rectangle; it cannot mask with arbitrary polygons.
+ * rectangle; it cannot mask with arbitrary polygons. Nested masks are managed
+ * by a scissor stack (see {@link #pushScissor}) which stores its masks by
+ * value. Masks that are not rotated and have no fringe are applied with
+ * glScissor. Only rotated or feathered masks use the shader.
  *
  * Drawing only occurs when the methods {@link #flush} or {@link #end} are 
  * called. Because loading vertices into a {@link VertexBuffer} is an expensive 
@@ -156,6 +162,12 @@ private:
         GLenum srcFactor;
         /** The stored destination factor */
         GLenum dstFactor;
+        /** Whether the alpha channel has its own blending factors */
+        bool alphaSeparate;
+        /** The stored source factor for the alpha channel */
+        GLenum srcAlpha;
+        /** The stored destination factor for the alpha channel */
+        GLenum dstAlpha;
         /** The stored depth testing support */
         GLenum depthFunc;
         /** The stored perspective matrix */
@@ -166,9 +178,29 @@ private:
         GLsizei blockptr;
         /** The pixel step for our blur function */
         GLuint  blurstep;
+        /** The distance field outline width */
+        GLfloat outlineWidth;
+        /** The distance field outline color */
+        Color4f outlineColor;
+        /** The distance field shadow offset in texels */
+        Vec2    shadowOffset;
+        /** The distance field shadow color */
+        Color4f shadowColor;
+        /** Whether to clip with glScissor (for an axis-aligned scissor mask) */
+        bool clipped;
+        /** The axis-aligned scissor mask in the coordinates of the perspective */
+        Rect clipRect;
         /** The dirty bits relative to the previous set of uniforms */
         GLuint dirty;
     };
+    
+    /** An entry of the scissor stack */
+    struct ScissorState {
+        /** The scissor mask, intersected with the entries below it */
+        Scissor mask;
+        /** Whether this entry has a scissor mask at all */
+        bool active;
+    };
 
     /** Whether this sprite batch has been initialized yet */
     bool _initialized;
@@ -195,6 +227,15 @@ private:
     unsigned int _indxMax;
     /** The number of indices in the current mesh */
     unsigned int _indxSize;
+
+    /** The vertex buffer for instanced sprites */
+    std::shared_ptr<VertexBuffer>  _instbuff;
+    /** The pending sprite instances */
+    SpriteInstance* _instData;
+    /** The instance capacity of the batch */
+    unsigned int _instMax;
+    /** The number of pending sprite instances */
+    unsigned int _instSize;
     
     /** The active drawing context */
     Context* _context;
@@ -210,8 +251,31 @@ private:
     
     /** The active gradient */
     std::shared_ptr<Gradient> _gradient;
-    /** The active scissor mask */
-    std::shared_ptr<Scissor>  _scissor;
+    /** The scissor stack (the top entry is the active scissor mask) */
+    std::vector<ScissorState> _scissorStack;
+    /** The position of the top of the scissor stack */
+    size_t _scissorTop;
+    /** The viewport for glScissor (refreshed on begin and perspective changes) */
+    GLint _viewport[4];
+    
+    /** The shader uniform for the drawing type */
+    UniformHandle<GLint>   _uniformType;
+    /** The shader uniform for the perspective matrix */
+    UniformHandle<Mat4>    _uniformPerspective;
+    /** The shader uniform for the blur offset */
+    UniformHandle<Vec2>    _uniformBlur;
+    /** The shader uniform for the distance field outline and shadow offset */
+    UniformHandle<Vec3>    _uniformDistance;
+    /** The shader uniform for the distance field outline color */
+    UniformHandle<Color4f> _uniformOutline;
+    /** The shader uniform for the distance field shadow color */
+    UniformHandle<Color4f> _uniformShadow;
+    /** The shader uniform for the transform of a retained mesh */
+    UniformHandle<Mat4>    _uniformModel;
+    /** The shader uniform for the tint of a retained mesh */
+    UniformHandle<Color4f> _uniformTint;
+    /** The shader uniform for drawing instanced sprites */
+    UniformHandle<GLint>   _uniformInstanced;
 
     // Monitoring values
     /** The number of vertices drawn in this pass (so far) */
@@ -624,6 +688,11 @@ public:
      * If this value is nullptr, then no scissor mask is active. This value
      * is nullptr by default.
      *
+     * This method replaces the top of the scissor stack. It does not
+     * intersect the scissor with the rest of the stack, and it does not
+     * change the stack depth. Setting a scissor equal to the active one
+     * does nothing.
+     *
      * This method acquires a copy of the scissor. Changes to the original
      * scissor mask after calling this method have no effect.
      *
@@ -642,12 +711,85 @@ public:
      * is nullptr by default.
      *
      * This method returns a copy of the internal scissor. Changes to this
-     * object have no effect on the sprite batch.
+     * object have no effect on the sprite batch. To avoid the allocation,
+     * use {@link #getActiveScissor} instead.
      *
      * @return The active scissor mask for this sprite batch
      */
     std::shared_ptr<Scissor> getScissor() const;
     
+    /**
+     * Returns the active scissor mask of this sprite batch
+     *
+     * If no scissor mask is active, this method returns nullptr. The
+     * pointer refers to the top of the scissor stack, and is only valid
+     * until the stack changes. It should never be retained.
+     *
+     * @return The active scissor mask for this sprite batch
+     */
+    const Scissor* getActiveScissor() const {
+        const ScissorState& top = _scissorStack[_scissorTop];
+        return top.active ? &top.mask : nullptr;
+    }
+    
+    /**
+     * Pushes the given scissor mask onto the scissor stack.
+     *
+     * The new active mask is the intersection of the given mask with the
+     * current active mask (if any). The intersection takes place in the
+     * coordinate system of the current mask, and so it is exact unless
+     * the masks are rotated differently. This is the same as the method
+     * {@link Scissor#intersect} with loose set to false.
+     *
+     * The stack stores its masks by value and reuses its storage, so this
+     * method does not allocate memory (once the stack has reached its
+     * maximum depth). If the new mask is the same as the current one, the
+     * drawing context does not change.
+     *
+     * Every push must be balanced by a call to {@link #popScissor}.
+     *
+     * @param mask  The scissor mask to push
+     */
+    void pushScissor(const Scissor& mask);
+    
+    /**
+     * Pushes the given scissor mask onto the scissor stack.
+     *
+     * This method is the same as {@link #pushScissor(const Scissor&)},
+     * except that the given transform replaces the transform of the mask.
+     * This is useful for scene graph nodes, which define their masks in
+     * node space.
+     *
+     * Every push must be balanced by a call to {@link #popScissor}.
+     *
+     * @param mask      The scissor mask to push
+     * @param transform The transform of the pushed mask
+     */
+    void pushScissor(const Scissor& mask, const Mat4& transform);
+    
+    /**
+     * Pushes a copy of the active scissor mask onto the scissor stack.
+     *
+     * This does not change the active mask. It saves the mask, so that it
+     * can be modified with {@link #setScissor} and then restored with
+     * {@link #popScissor}.
+     */
+    void pushScissor();
+    
+    /**
+     * Pops the top of the scissor stack, restoring the previous mask.
+     *
+     * This method does nothing if the stack only has its base entry.
+     */
+    void popScissor();
+    
+    /**
+     * Returns the number of masks pushed onto the scissor stack.
+     *
+     * @return the number of masks pushed onto the scissor stack.
+     */
+    size_t getScissorDepth() const { return _scissorTop; }
+    
     /**
      * Sets the blending function for this sprite batch
      *
@@ -687,6 +829,58 @@ public:
      */
     GLenum getDestinationBlendFactor() const { return _context->dstFactor; }
     
+    /**
+     * Sets a separate blending function for the alpha channel
+     *
+     * By default, the alpha channel is blended with the same factors as the
+     * color channels (see {@link #setBlendFunc}). That is correct when drawing
+     * to the screen, but not when drawing to an offscreen texture. The color
+     * channels are multiplied by the source alpha, but so is the alpha itself.
+     * Hence translucent pixels store the square of their alpha.
+     *
+     * Once this method is called, the alpha channel uses these factors no
+     * matter what the color factors are (see glBlendFuncSeparate). The
+     * factors GL_ONE and GL_ONE_MINUS_SRC_ALPHA store the correct coverage,
+     * and so produce a premultiplied texture. Call {@link #clearBlendAlphaFunc}
+     * to blend the alpha channel with the color factors again.
+     *
+     * @param srcFactor Specifies how the source alpha factor is computed
+     * @param dstFactor Specifies how the destination alpha factor is computed.
+     */
+    void setBlendAlphaFunc(GLenum srcFactor, GLenum dstFactor);
+    
+    /**
+     * Blends the alpha channel with the same factors as the color channels
+     *
+     * This method undoes {@link #setBlendAlphaFunc}, and is the default.
+     */
+    void clearBlendAlphaFunc();
+    
+    /**
+     * Returns true if the alpha channel has its own blending factors
+     *
+     * @return true if the alpha channel has its own blending factors
+     */
+    bool hasBlendAlphaFunc() const { return _context->alphaSeparate; }
+    
+    /**
+     * Returns the source blending factor for the alpha channel
+     *
+     * This value is only used if {@link #hasBlendAlphaFunc} is true.
+     *
+     * @return the source blending factor for the alpha channel
+     */
+    GLenum getSourceAlphaFactor() const { return _context->srcAlpha; }
+    
+    /**
+     * Returns the destination blending factor for the alpha channel
+     *
+     * This value is only used if {@link #hasBlendAlphaFunc} is true.
+     *
+     * @return the destination blending factor for the alpha channel
+     */
+    GLenum getDestinationAlphaFactor() const { return _context->dstAlpha; }
+    
     /**
      * Sets the blending equation for this sprite batch
      *
@@ -804,6 +998,105 @@ public:
      * @return the blur step in pixels (0 if there is no blurring).
      */
     GLuint getBlurStep() const { return _context->blurstep; }
+
+    /**
+     * Sets whether the active texture is a signed distance field.
+     *
+     * A distance field texture stores the distance to the nearest edge in
+     * its alpha channel, with the edge at 0.5. This is typically a font
+     * atlas created with {@link Font#setDistanceSpread}. Such a texture
+     * is filled with the current color (or gradient), and antialiased at
+     * the edges. This allows text to be scaled up without blurring. It
+     * also supports outline and shadow effects.
+     *
+     * A distance field replaces any blur effect. This value is false by
+     * default.
+     *
+     * @param field Whether the active texture is a signed distance field
+     */
+    void setDistanceField(bool field);
+
+    /**
+     * Returns true if the active texture is a signed distance field.
+     *
+     * A distance field texture stores the distance to the nearest edge in
+     * its alpha channel, with the edge at 0.5. This is typically a font
+     * atlas created with {@link Font#setDistanceSpread}. Such a texture
+     * is filled with the current color (or gradient), and antialiased at
+     * the edges. This allows text to be scaled up without blurring. It
+     * also supports outline and shadow effects.
+     *
+     * A distance field replaces any blur effect. This value is false by
+     * default.
+     *
+     * @return true if the active texture is a signed distance field.
+     */
+    bool isDistanceField() const;
+
+    /**
+     * Sets the outline for distance field textures.
+     *
+     * The width is measured in distance units, where 0.5 is the full spread
+     * of the distance field. Hence the outline can be no wider than the
+     * spread. A width of 0 disables the outline, which is the default.
+     *
+     * This value has no effect unless {@link #isDistanceField} is true.
+     *
+     * @param width The outline width in distance units
+     * @param color The outline color
+     */
+    void setOutline(float width, const Color4f color);
+
+    /**
+     * Returns the outline width for distance field textures.
+     *
+     * The width is measured in distance units, where 0.5 is the full spread
+     * of the distance field. A width of 0 means there is no outline.
+     *
+     * @return the outline width for distance field textures.
+     */
+    float getOutlineWidth() const { return _context->outlineWidth; }
+
+    /**
+     * Returns the outline color for distance field textures.
+     *
+     * @return the outline color for distance field textures.
+     */
+    Color4f getOutlineColor() const { return _context->outlineColor; }
+
+    /**
+     * Sets the drop shadow for distance field textures.
+     *
+     * The offset is measured in texels of the active texture, with the
+     * y-axis pointing up. So the shadow scales with the text. The shadow
+     * has the same outline as the text. A clear color disables the shadow,
+     * which is the default.
+     *
+     * This value has no effect unless {@link #isDistanceField} is true.
+     *
+     * @param offset    The shadow offset in texels
+     * @param color     The shadow color
+     */
+    void setShadow(const Vec2 offset, const Color4f color);
+
+    /**
+     * Returns the drop shadow offset for distance field textures.
+     *
+     * The offset is measured in texels of the active texture, with the
+     * y-axis pointing up.
+     *
+     * @return the drop shadow offset for distance field textures.
+     */
+    Vec2 getShadowOffset() const { return _context->shadowOffset; }
+
+    /**
+     * Returns the drop shadow color for distance field textures.
+     *
+     * A clear color means there is no shadow.
+     *
+     * @return the drop shadow color for distance field textures.
+     */
+    Color4f getShadowColor() const { return _context->shadowColor; }
     
 
 #pragma mark -
@@ -1862,6 +2155,78 @@ public:
     void draw(const std::shared_ptr<Texture>& texture, const Color4f color,
               const Poly2& poly, const Vec2 origin, const Mat4& transform);
 
+#pragma mark -
+#pragma mark Retained Meshes
+    /**
+     * Draws the given retained mesh with the given transform.
+     *
+     * Unlike {@link #fill}, the vertices are not transformed on the CPU or
+     * copied into this sprite batch. The mesh is drawn directly from its own
+     * vertex buffer, with the transform passed to the shader as a uniform.
+     * The mesh uses the current texture, gradient, scissor, blend state and
+     * perspective of this sprite batch.
+     *
+     * The mesh vertices use their own color values.  However, if tint is true,
+     * these values will be tinted (i.e. multiplied) by the current active
+     * color. The vertex positions are 2d, so the depth of this sprite batch
+     * is ignored.
+     *
+     * This method must flush any vertices batched so far, and each retained
+     * mesh is a separate draw call. See {@link SpriteMesh} for when this is
+     * faster than batching.
+     *
+     * @param mesh      The retained mesh to draw
+     * @param transform The coordinate transform
+     * @param tint      Whether to tint with the active color
+     */
+    void draw(const std::shared_ptr<SpriteMesh>& mesh, const Mat4& transform, bool tint = true);
+
+#pragma mark -
+#pragma mark Instanced Sprites
+    /**
+     * Draws the given sprite instance with the current texture.
+     *
+     * An instance is a unit quad with its own transform, texture region,
+     * animation frame, and color (see {@link SpriteInstance}). Instances
+     * are not expanded into vertices on the CPU. Instead, consecutive
+     * instances are collected and drawn together with a single call to
+     * glDrawElementsInstanced. The run of instances ends when any other
+     * shape is drawn, when the batch is flushed, or when any drawing state
+     * (such as the texture or blend function) changes. Hence sprites that
+     * share a texture should be drawn together.
+     *
+     * Instances use the current texture, scissor, blend state and
+     * perspective of this sprite batch. They do not use the active color
+     * (each instance has its own color), the depth, or the gradient. This
+     * sprite batch should not have a gradient when drawing instances.
+     *
+     * @param instance  The sprite instance to draw
+     */
+    void drawInstanced(const SpriteInstance& instance) {
+        drawInstanced(&instance, 1);
+    }
+
+    /**
+     * Draws the given sprite instances with the current texture.
+     *
+     * An instance is a unit quad with its own transform, texture region,
+     * animation frame, and color (see {@link SpriteInstance}). Instances
+     * are not expanded into vertices on the CPU. Instead, consecutive
+     * instances are collected and drawn together with a single call to
+     * glDrawElementsInstanced. The run of instances ends when any other
+     * shape is drawn, when the batch is flushed, or when any drawing state
+     * (such as the texture or blend function) changes. Hence sprites that
+     * share a texture should be drawn together.
+     *
+     * Instances use the current texture, scissor, blend state and
+     * perspective of this sprite batch. They do not use the active color
+     * (each instance has its own color), the depth, or the gradient. This
+     * sprite batch should not have a gradient when drawing instances.
+     *
+     * @param instances The sprite instances to draw
+     * @param count     The number of sprite instances
+     */
+    void drawInstanced(const SpriteInstance* instances, size_t count);
 
 #pragma mark -
 #pragma mark Internal Helpers
@@ -1910,6 +2275,41 @@ private:
      */
     void setUniformBlock(Context* context, bool tint);
     
+    /**
+     * Applies the changed values of the given context to OpenGL.
+     *
+     * Only the values marked dirty in the context are applied. This method
+     * assumes that the uniform buffer is active.
+     *
+     * @param context   The uniform context to apply
+     */
+    void apply(Context* context);
+
+    /**
+     * Draws the pending sprite instances.
+     *
+     * This method is called whenever a run of instances ends. It applies
+     * the current context, and so the run cannot span a context change.
+     */
+    void flushInstances();
+    
+    /**
+     * Updates the drawing context to agree with the top of the scissor stack.
+     *
+     * Axis-aligned masks with no fringe (under an axis-aligned perspective)
+     * are clipped with glScissor. All other masks use the scissor shader.
+     */
+    void updateScissor();
+    
+    /**
+     * Caches the uniform handles for the active shader.
+     *
+     * This method is called whenever the shader changes. Handles for
+     * uniforms that the shader does not have are invalid, and are ignored
+     * when drawing.
+     */
+    void lookupUniforms();
+    
     /**
      * Updates the shader with the current blur offsets
      *
@@ -1924,6 +2324,16 @@ private:
      */
     void blurTexture(const std::shared_ptr<Texture>& texture, GLuint step);
 
+    /**
+     * Updates the shader with the current distance field effects
+     *
+     * The shadow offset depends upon the texture size. This method converts
+     * the offset into texture coordinates, just like {@link #blurTexture}.
+     *
+     * @param context   The current uniform context
+     */
+    void distanceTexture(Context* context);
+
     /**
      * Returns the number of vertices added to the drawing buffer.
      *
@@ -0,0 +1,190 @@
+//
+//  CUSpriteMesh.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a sprite mesh that is retained on the GPU. Normally
+//  a SpriteBatch transforms the vertices of every mesh on the CPU and copies
+//  them into its own vertex buffer, every frame. A sprite mesh is uploaded
+//  once to its own vertex buffer, and is drawn with a transform uniform
+//  instead. This is much cheaper for large meshes that rarely change shape,
+//  even if they move every frame.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: agent
+//  Version: 10/19/26
+//
+#ifndef __CU_SPRITE_MESH_H__
+#define __CU_SPRITE_MESH_H__
+
+#include <cugl/render/CUVertexBuffer.h>
+#include <cugl/render/CUSpriteVertex.h>
+#include <cugl/render/CUMesh.h>
+#include <memory>
+
+namespace cugl {
+
+/**
+ * This class is a sprite mesh retained in its own vertex buffer.
+ *
+ * A sprite mesh is drawn with {@link SpriteBatch#draw}. Unlike the other
+ * drawing methods of a sprite batch, the vertices are not transformed on
+ * the CPU or copied into the batch. Instead, the transform is passed to the
+ * shader as a uniform. Hence moving the mesh only updates a matrix.
+ *
+ * The vertices keep their own colors, and are tinted by the sprite batch
+ * color (unless there is a gradient, in which case the colors are the
+ * gradient coordinates). The vertex positions are 2d, so the sprite batch
+ * depth is ignored.
+ *
+ * Each draw of a sprite mesh is a separate draw call, and the sprite batch
+ * must flush before it. Therefore a sprite mesh only pays off for meshes
+ * with many vertices, or for meshes that are drawn between changes of
+ * texture or other state anyway.
+ *
+ * A sprite mesh is an OpenGL resource, and so it may only be created,
+ * updated, or deleted on the main (rendering) thread.
+ */
+class SpriteMesh {
+#pragma mark Values
+private:
+    /** The vertex buffer storing the mesh */
+    std::shared_ptr<VertexBuffer> _vertbuff;
+    /** The drawing command (GL_TRIANGLES or GL_LINES) */
+    GLenum  _command;
+    /** The number of vertices in the vertex buffer */
+    GLsizei _vertSize;
+    /** The number of indices in the vertex buffer */
+    GLsizei _indxSize;
+
+#pragma mark -
+#pragma mark Constructors
+public:
+    /**
+     * Creates an uninitialized sprite mesh.
+     *
+     * You must initialize the mesh to allocate buffer memory.
+     */
+    SpriteMesh();
+
+    /**
+     * Deletes this sprite mesh, freeing all resources.
+     */
+    ~SpriteMesh() { dispose(); }
+
+    /**
+     * Deletes the sprite mesh, freeing all resources.
+     *
+     * You must reinitialize the sprite mesh to use it.
+     */
+    void dispose();
+
+    /**
+     * Initializes this sprite mesh with the given vertices.
+     *
+     * The mesh is uploaded to a new vertex buffer immediately. The mesh must
+     * be sliceable, with a drawing command of GL_TRIANGLES or GL_LINES.
+     *
+     * @param mesh  The mesh to upload
+     *
+     * @return true if initialization was successful.
+     */
+    bool init(const Mesh<SpriteVertex2>& mesh);
+
+    /**
+     * Returns a newly allocated sprite mesh with the given vertices.
+     *
+     * The mesh is uploaded to a new vertex buffer immediately. The mesh must
+     * be sliceable, with a drawing command of GL_TRIANGLES or GL_LINES.
+     *
+     * @param mesh  The mesh to upload
+     *
+     * @return a newly allocated sprite mesh with the given vertices.
+     */
+    static std::shared_ptr<SpriteMesh> alloc(const Mesh<SpriteVertex2>& mesh) {
+        std::shared_ptr<SpriteMesh> result = std::make_shared<SpriteMesh>();
+        return (result->init(mesh) ? result : nullptr);
+    }
+
+#pragma mark -
+#pragma mark Attributes
+    /**
+     * Replaces the vertices of this sprite mesh.
+     *
+     * The new mesh is uploaded to the vertex buffer immediately. The binding
+     * of any other vertex buffer (such as the one of an active sprite batch)
+     * is preserved.
+     *
+     * @param mesh  The mesh to upload
+     */
+    void setMesh(const Mesh<SpriteVertex2>& mesh);
+
+    /**
+     * Returns the vertex buffer storing this mesh.
+     *
+     * @return the vertex buffer storing this mesh.
+     */
+    const std::shared_ptr<VertexBuffer>& getVertexBuffer() const { return _vertbuff; }
+
+    /**
+     * Returns the drawing command of this mesh.
+     *
+     * @return the drawing command of this mesh.
+     */
+    GLenum getCommand() const { return _command; }
+
+    /**
+     * Returns the number of vertices in this mesh.
+     *
+     * @return the number of vertices in this mesh.
+     */
+    GLsizei getVertexSize() const { return _vertSize; }
+
+    /**
+     * Returns the number of indices in this mesh.
+     *
+     * @return the number of indices in this mesh.
+     */
+    GLsizei getIndexSize() const { return _indxSize; }
+
+    /**
+     * Returns the GPU memory used by this mesh in bytes.
+     *
+     * @return the GPU memory used by this mesh in bytes.
+     */
+    size_t getMemoryUsage() const {
+        return _vertSize*sizeof(SpriteVertex2)+_indxSize*sizeof(GLuint);
+    }
+};
+
+}
+
+#endif /* __CU_SPRITE_MESH_H__ */
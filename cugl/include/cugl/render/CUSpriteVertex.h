@@ -34,6 +34,8 @@
 #include <cugl/math/CUVec2.h>
 #include <cugl/math/CUVec3.h>
 #include <cugl/math/CUVec4.h>
+#include <cugl/math/CUMat4.h>
+#include <cugl/math/CURect.h>
 
 namespace cugl {
 
@@ -97,6 +99,64 @@ public:
     static const GLvoid* texcoordOffset()   { return (GLvoid*)offsetof(SpriteVertex2, texcoord);  }
 };
 
+/**
+ * This class/struct is rendering information for an instanced sprite.
+ *
+ * The class is intended to be used as a struct.  This struct has the
+ * per-instance information required by {@link SpriteBatch#drawInstanced}.
+ * Every instance is a unit quad, which is mapped to the screen by an affine
+ * transform. The transform is stored as the first two rows of the matrix,
+ * so a point (x,y) on the quad is placed at (dot(transform0,(x,y,1)),
+ * dot(transform1,(x,y,1))).
+ *
+ * The texture coordinates are computed from the animation frame. The frame
+ * is a pair (index, columns) into a filmstrip, and texrect is the region of
+ * the first frame (origin and size in texture coordinates). The origin is
+ * the top left corner, as texture coordinates have the y-axis pointing down.
+ * A negative width or height flips the image along that axis. A sprite that
+ * is not animated has frame (0,1).
+ */
+class SpriteInstance {
+public:
+    /** The first row of the affine transform of the unit quad */
+    cugl::Vec3 transform0;
+    /** The second row of the affine transform of the unit quad */
+    cugl::Vec3 transform1;
+    /** The texture region of the first frame (origin and size) */
+    cugl::Vec4 texrect;
+    /** The instance color */
+    cugl::Vec4 color;
+    /** The animation frame index and the number of filmstrip columns */
+    cugl::Vec2 frame;
+
+    /** The memory offset of the first transform row */
+    static const GLvoid* transform0Offset() { return (GLvoid*)offsetof(SpriteInstance, transform0); }
+    /** The memory offset of the second transform row */
+    static const GLvoid* transform1Offset() { return (GLvoid*)offsetof(SpriteInstance, transform1); }
+    /** The memory offset of the texture region */
+    static const GLvoid* texrectOffset()    { return (GLvoid*)offsetof(SpriteInstance, texrect);    }
+    /** The memory offset of the instance color */
+    static const GLvoid* colorOffset()      { return (GLvoid*)offsetof(SpriteInstance, color);      }
+    /** The memory offset of the animation frame */
+    static const GLvoid* frameOffset()      { return (GLvoid*)offsetof(SpriteInstance, frame);      }
+
+    /**
+     * Sets the transform to place the unit quad at bounds under the matrix.
+     *
+     * Only the affine 2d part of the matrix is used.
+     *
+     * @param matrix    The coordinate transform
+     * @param bounds    The sprite bounds before the transform
+     */
+    void setTransform(const cugl::Mat4& matrix, const cugl::Rect bounds) {
+        const float* m = matrix.m;
+        transform0.set(m[0]*bounds.size.width, m[4]*bounds.size.height,
+                       m[0]*bounds.origin.x+m[4]*bounds.origin.y+m[12]);
+        transform1.set(m[1]*bounds.size.width, m[5]*bounds.size.height,
+                       m[1]*bounds.origin.x+m[5]*bounds.origin.y+m[13]);
+    }
+};
+
 }
 
 #endif /* __CU_VERTEX_H__ */
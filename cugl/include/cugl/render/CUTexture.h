@@ -406,6 +406,48 @@ public:
      */
     const Texture& set(const void *data);
 
+    /**
+     * Replaces the contents of this texture with an image of the given size.
+     *
+     * Unlike {@link #set}, the image may have a different size than the
+     * original. The OpenGL buffer is reused, so every object holding this
+     * texture (including any subtexture) sees the new image. The filter and
+     * wrap settings are kept, and mipmaps are rebuilt if this texture had
+     * them. The buffer must be in the pixel format of this texture.
+     *
+     * This method is used to hot reload textures. It may not be called on a
+     * subtexture. Any texture bound to offset 0 will be unbound.
+     *
+     * @param data      The buffer to read into the texture
+     * @param width     The image width in pixels
+     * @param height    The image height in pixels
+     *
+     * @return true if the texture was successfully replaced
+     */
+    bool reload(const void *data, int width, int height);
+
+    /**
+     * Replaces a rectangular region of this texture with the given buffer.
+     *
+     * The buffer must have the pixel format of this texture, and be of size
+     * width*height*bytesize. The region is specified in pixels, with the
+     * origin at the first row of the image, and must fit inside the texture.
+     * Unlike {@link #set}, this texture does not need to be active. This
+     * makes it possible to add images to a texture atlas incrementally,
+     * without uploading the entire atlas.
+     *
+     * Mipmaps are not rebuilt by this method. This method may not be called
+     * on a subtexture. Any texture bound to offset 0 will be unbound.
+     *
+     * @param data      The buffer to read into the texture
+     * @param x         The left edge of the region in pixels
+     * @param y         The first row of the region in pixels
+     * @param width     The region width in pixels
+     * @param height    The region height in pixels
+     *
+     * @return true if the region was successfully replaced
+     */
+    bool update(const void *data, int x, int y, int width, int height);
     
 #pragma mark -
 #pragma mark Attributes
@@ -635,6 +677,22 @@ public:
      */
     std::shared_ptr<Texture> getSubTexture(GLfloat minS, GLfloat maxS, GLfloat minT, GLfloat maxT);
     
+    /**
+     * Resets the region of this subtexture within its parent.
+     *
+     * The values must be 0 <= minS <= maxS <= 1 and 0 <= minT <= maxT <= 1.
+     * They have the same meaning as in {@link #getSubTexture}.
+     *
+     * This method is used to update an atlas after the parent texture is
+     * reloaded with a different size. It may only be called on a subtexture.
+     *
+     * @param minS  The new minimum S coordinate
+     * @param maxS  The new maximum S coordinate
+     * @param minT  The new minimum T coordinate
+     * @param maxT  The new maximum T coordinate
+     */
+    void setSubRegion(GLfloat minS, GLfloat maxS, GLfloat minT, GLfloat maxT);
+    
     /**
      * Returns true if this texture is a subtexture.
      *
@@ -97,6 +97,8 @@ private:
         GLboolean norm;
         /** The offset of the attribute in the vertex buffer */
         GLsizeiptr offset;
+        /** The number of instances per attribute value (0 for per vertex) */
+        GLuint divisor;
     };
     
     /** The data stride of this buffer (0 if there is only one attribute) */
@@ -389,14 +391,19 @@ public:
      * The attribute offset is measured in bytes from the start of the 
      * vertex data structure (for a single vertex).
      *
+     * The divisor is for instanced drawing (see {@link #drawInstanced}). An
+     * attribute with divisor 0 advances once per vertex. Otherwise, it
+     * advances once per that many instances.
+     *
      * @param name      The attribute name
      * @param size      The attribute size in byte.
      * @param type      The attribute type
      * @param norm      Whether to normalize the value (floating point only)
      * @param offset    The attribute offset in the vertex data structure
+     * @param divisor   The number of instances per attribute value
      */
     void setupAttribute(const std::string name, GLint size, GLenum type,
-                        GLboolean norm, GLsizei offset);
+                        GLboolean norm, GLsizei offset, GLuint divisor=0);
     
     
     /**
@@ -31,12 +31,14 @@
 #include "CUSpriteVertex.h"
 #include "CUTexture.h"
 #include "CUFont.h"
+#include "CUGlyphCache.h"
 #include "CUMesh.h"
 #include "CUScissor.h"
 #include "CUGradient.h"
 #include "CUShader.h"
 #include "CUUniformBuffer.h"
 #include "CURenderTarget.h"
+#include "CUSpriteMesh.h"
 #include "CUSpriteBatch.h"
 #include "CUCamera.h"
 #include "CUOrthographicCamera.h"
@@ -43,11 +43,17 @@
 #ifndef __CU_SCENE_2_H__
 #define __CU_SCENE_2_H__
 
+#include <functional>
 #include <cugl/math/cu_math.h>
 #include <cugl/scene2/graph/CUSceneNode.h>
 #include <cugl/render/CUOrthographicCamera.h>
 
 namespace cugl {
+
+    namespace scene2 {
+        /** Forward reference to cached nodes (which suspend culling) */
+        class CachedNode;
+    }
     
 /**
  * This class provides the root node of a two-dimensional scene graph.
@@ -92,6 +98,41 @@ protected:
     /** Whether or note this scene is still active */
     bool _active;
 
+    /** A node of the bounding volume hierarchy for hit testing */
+    struct HitBox {
+        /** The world bounds of everything in this subtree */
+        Rect bounds;
+        /** The first entry (leaf) or the right child (interior) */
+        Uint32 start;
+        /** The number of entries (0 for an interior node) */
+        Uint32 count;
+        /** The greatest draw order in this subtree */
+        Uint32 order;
+    };
+    /** Whether the hit testing hierarchy must be rebuilt */
+    bool _hitDirty;
+    /** The visible nodes, in draw order (back to front) */
+    std::vector<std::shared_ptr<scene2::SceneNode>> _hitNodes;
+    /** The world bounding box of each visible node */
+    std::vector<Rect> _hitBounds;
+    /** The entries of the hierarchy leaves, as positions in _hitNodes */
+    std::vector<Uint32> _hitItems;
+    /** The hierarchy, in depth-first order (the left child follows its parent) */
+    std::vector<HitBox> _hitTree;
+    
+    /** Whether to skip subtrees outside of the camera when rendering */
+    bool _culling;
+    /** Whether culling is currently active (only true inside of render) */
+    bool _cullActive;
+    /** The visible region of the camera in world space */
+    Rect _cullRect;
+    /** The number of subtrees tested for culling in the last render pass */
+    Uint32 _cullTests;
+    /** The number of subtrees culled in the last render pass */
+    Uint32 _cullSkips;
+    /** The number of nodes culled in the last render pass */
+    Uint32 _cullNodes;
+
 #pragma mark -
 #pragma mark Constructors
 public:
@@ -923,13 +964,170 @@ public:
      * That means that parents are always draw before (and behind children).
      * To override this draw order, scene nodes do support a z-axis offset.
      *
+     * If culling is enabled (see {@link #setCulling}), subtrees outside of
+     * the camera are skipped.
+     *
      * @param batch     The SpriteBatch to draw with.
      */
     virtual void render(const std::shared_ptr<SpriteBatch>& batch);
     
+#pragma mark -
+#pragma mark Culling
+    /**
+     * Returns true if this scene skips subtrees outside of the camera.
+     *
+     * If culling is enabled, {@link render} tests each node against the
+     * visible region of the camera before drawing it. If the node and all of
+     * its descendants are outside of that region, the entire subtree is
+     * skipped. Nodes are tested with the cached bounds of their subtree (see
+     * {@link scene2::SceneNode#getSubtreeBounds}), so this is cheap unless
+     * the scene changes shape every frame.
+     *
+     * Nodes that draw outside of their {@link scene2::SceneNode#getDrawBounds}
+     * may be culled while partly visible. Hence culling is disabled by default.
+     *
+     * @return true if this scene skips subtrees outside of the camera.
+     */
+    bool isCulling() const { return _culling; }
+    
+    /**
+     * Sets whether this scene skips subtrees outside of the camera.
+     *
+     * If culling is enabled, {@link render} tests each node against the
+     * visible region of the camera before drawing it. If the node and all of
+     * its descendants are outside of that region, the entire subtree is
+     * skipped. Nodes are tested with the cached bounds of their subtree (see
+     * {@link scene2::SceneNode#getSubtreeBounds}), so this is cheap unless
+     * the scene changes shape every frame.
+     *
+     * Nodes that draw outside of their {@link scene2::SceneNode#getDrawBounds}
+     * may be culled while partly visible. Hence culling is disabled by default.
+     *
+     * @param value Whether this scene skips subtrees outside of the camera.
+     */
+    void setCulling(bool value) { _culling = value; }
+    
+    /**
+     * Returns the number of subtrees tested for culling in the last render.
+     *
+     * This value is 0 if culling is disabled.
+     *
+     * @return the number of subtrees tested for culling in the last render.
+     */
+    Uint32 getCullTests() const { return _cullTests; }
+    
+    /**
+     * Returns the number of subtrees culled in the last render.
+     *
+     * This value is 0 if culling is disabled.
+     *
+     * @return the number of subtrees culled in the last render.
+     */
+    Uint32 getCulledSubtrees() const { return _cullSkips; }
+    
+    /**
+     * Returns the number of nodes culled in the last render.
+     *
+     * This is the number of visible nodes in all of the culled subtrees.
+     * It is 0 if culling is disabled.
+     *
+     * @return the number of nodes culled in the last render.
+     */
+    Uint32 getCulledNodes() const { return _cullNodes; }
+    
+#pragma mark -
+#pragma mark Hit Testing
+    /**
+     * Returns the topmost node whose bounding box contains the given point.
+     *
+     * The point is in world coordinates. Nodes are tested against the
+     * axis-aligned bounding box of their content in world space, so rotated
+     * nodes may report hits slightly outside of their contents. Invisible
+     * nodes (and their descendants) are ignored, as are nodes with no
+     * content size. Among the nodes that contain the point, this method
+     * returns the one drawn last in the pre-order traversal of {@link render}.
+     *
+     * If filter is provided, only nodes that pass it are considered. This
+     * is useful for picking only interactive nodes (e.g. buttons) and not
+     * the labels drawn on top of them.
+     *
+     * The query uses a bounding volume hierarchy over all visible nodes, so
+     * it is logarithmic in the size of the scene graph. The hierarchy is
+     * rebuilt lazily on the next query whenever a node in this scene is
+     * moved, resized, shown, hidden, added, removed, or reordered.
+     *
+     * @param point     The point in world coordinates
+     * @param filter    An optional predicate restricting the candidates
+     *
+     * @return the topmost node whose bounding box contains the given point.
+     */
+    std::shared_ptr<scene2::SceneNode> pick(const Vec2 point,
+                                            const std::function<bool(const std::shared_ptr<scene2::SceneNode>&)>& filter = nullptr);
+    
+    /**
+     * Returns the topmost node whose bounding box contains the screen point.
+     *
+     * This method is the same as {@link pick}, except that the point is first
+     * converted from screen to world coordinates by the scene camera.
+     *
+     * @param screenPoint   The point in screen coordinates
+     * @param filter        An optional predicate restricting the candidates
+     *
+     * @return the topmost node whose bounding box contains the screen point.
+     */
+    std::shared_ptr<scene2::SceneNode> pickScreen(const Vec2 screenPoint,
+                                                  const std::function<bool(const std::shared_ptr<scene2::SceneNode>&)>& filter = nullptr) {
+        Vec3 world = screenToWorldCoords(screenPoint);
+        return pick(Vec2(world.x,world.y),filter);
+    }
+    
+    /**
+     * Appends all nodes whose bounding box contains the given point.
+     *
+     * The point is in world coordinates. The nodes are appended to the
+     * given vector in draw order from front to back, so that the topmost
+     * node comes first. See {@link pick} for how the nodes are tested.
+     *
+     * @param point The point in world coordinates
+     * @param nodes The vector to store the results
+     *
+     * @return the number of nodes appended
+     */
+    size_t pickAll(const Vec2 point, std::vector<std::shared_ptr<scene2::SceneNode>>& nodes);
+    
 private:
 #pragma mark -
 #pragma mark Internal Helpers
+    /**
+     * Marks the hit testing hierarchy as out of date.
+     *
+     * This method is called by {@link scene2::SceneNode} whenever a node in
+     * this scene changes position, size, visibility or order. Any references
+     * retained by the hierarchy are released immediately.
+     */
+    void setHitDirty();
+    
+    /**
+     * Rebuilds the hit testing hierarchy if it is out of date.
+     */
+    void buildHitTree();
+    
+    /**
+     * Recursively collects the visible nodes of a subtree for hit testing.
+     *
+     * @param node      The root of the subtree
+     * @param transform The world transform of the node parent
+     */
+    void collectHitNodes(const std::shared_ptr<scene2::SceneNode>& node, const Mat4& transform);
+    
+    /**
+     * Recursively builds the hierarchy over the given range of _hitItems.
+     *
+     * @param start The first item in the range
+     * @param end   The item after the range
+     */
+    void buildHitBox(Uint32 start, Uint32 end);
+    
     /**
      * Sets whether the children of this Scene needs resorting.
      *
@@ -951,6 +1149,7 @@ private:
     
     // Tightly couple with Node
     friend class scene2::SceneNode;
+    friend class scene2::CachedNode;
 };
 
 }
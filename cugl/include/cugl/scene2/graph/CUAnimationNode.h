@@ -282,6 +282,24 @@ public:
      * @param frame the index to make the active frame
      */
     void setFrame(int frame);
+
+#pragma mark -
+#pragma mark Rendering
+    /**
+     * Draws this Node via the given SpriteBatch.
+     *
+     * If this node is a plain filmstrip frame (the polygon is the frame
+     * rectangle, with no gradient, flip, or retained mesh), it is drawn as
+     * a {@link SpriteInstance}. Consecutive animation nodes that share a
+     * texture are then drawn by the sprite batch with a single instanced
+     * draw call. Otherwise, this node is drawn like any polygon node.
+     *
+     * @param batch     The SpriteBatch to draw with.
+     * @param transform The global transformation matrix.
+     * @param tint      The tint to blend with the Node color.
+     */
+    virtual void draw(const std::shared_ptr<SpriteBatch>& batch,
+                      const Mat4& transform, Color4 tint) override;
  
 };
     }
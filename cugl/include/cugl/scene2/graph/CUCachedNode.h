@@ -0,0 +1,378 @@
+//
+//  CUCachedNode.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a scene graph node that caches the rendering of its
+//  children in an offscreen texture. Most of a level (floors, walls, props)
+//  never changes while the level is running. Yet the scene graph normally
+//  transforms and uploads all of it every frame. A cached node draws its
+//  subtree once, and then draws that subtree as a single textured quad until
+//  one of its descendants changes.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: agent
+//  Version: 10/19/26
+//
+#ifndef __CU_CACHED_NODE_H__
+#define __CU_CACHED_NODE_H__
+#include <cugl/scene2/graph/CUSceneNode.h>
+#include <cugl/render/CURenderTarget.h>
+
+namespace cugl {
+    namespace scene2 {
+
+/**
+ * This class is a node that caches the rendering of its children.
+ *
+ * The first time this node is rendered, it draws all of its descendants to
+ * an offscreen {@link RenderTarget}. From then on, it draws that texture as
+ * a single quad, skipping the traversal of its subtree entirely. The cache
+ * is only redrawn when a descendant changes its appearance (see
+ * {@link SceneNode#setRenderDirty}). All of the setters in the scene graph
+ * mark the appropriate nodes automatically.
+ *
+ * The resolution of the cache matches the on-screen size of this node,
+ * including any scaling by its ancestors and the camera zoom. The scale is
+ * rounded up to a power of two. Hence moving this node (or panning the
+ * camera) reuses the cached texture, and so does zooming, until the zoom
+ * crosses a power of two. The tint color of this node is applied when
+ * drawing the quad, and so fading this node does not invalidate the cache
+ * either.
+ *
+ * There are several restrictions on the contents of a cached node. Any
+ * content outside the bounding box (0,0,width,height) of this node is
+ * clipped. The tint is applied to the whole cache, including children that
+ * do not have relative color. Finally, as render targets do not nest, a
+ * cached node may not be used inside of a {@link Scene2Texture} or of
+ * another cached node.
+ *
+ * If the offscreen buffer cannot be allocated, this node draws its children
+ * directly, like a normal {@link SceneNode}. It does not try to allocate
+ * a buffer of the same size again.
+ *
+ * This node is a render barrier for {@link OrderedNode}. The priorities of
+ * its descendants only order them within the cache.
+ */
+class CachedNode : public SceneNode {
+protected:
+    /** The offscreen buffer storing the rendered children */
+    std::shared_ptr<RenderTarget> _target;
+    /** The pixels per unit of content in the offscreen buffer */
+    float _cacheScale;
+    /** The width of the last offscreen buffer that failed to allocate */
+    int _failWidth;
+    /** The height of the last offscreen buffer that failed to allocate */
+    int _failHeight;
+    /** The number of frames drawn from the cache */
+    Uint64 _hits;
+    /** The number of frames that redrew the cache */
+    Uint64 _misses;
+
+#pragma mark -
+#pragma mark Constructors
+public:
+    /**
+     * Creates an uninitialized node.
+     *
+     * You must initialize this Node before use.
+     *
+     * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate a Node on the
+     * heap, use one of the static constructors instead.
+     */
+    CachedNode();
+
+    /**
+     * Deletes this node, releasing all resources.
+     */
+    ~CachedNode() { dispose(); }
+
+    /**
+     * Disposes all of the resources used by this node.
+     *
+     * A disposed Node can be safely reinitialized. Any children owned by this
+     * node will be released.  They will be deleted if no other object owns them.
+     *
+     * It is unsafe to call this on a Node that is still currently inside of
+     * a scene graph.
+     */
+    virtual void dispose() override;
+
+#pragma mark -
+#pragma mark Static Constructors
+    /**
+     * Returns a newly allocated node at the world origin.
+     *
+     * The node has both position and size (0,0). As a cached node with no
+     * size caches nothing, you must set the content size before use.
+     *
+     * @return a newly allocated node at the world origin.
+     */
+    static std::shared_ptr<CachedNode> alloc() {
+        std::shared_ptr<CachedNode> result = std::make_shared<CachedNode>();
+        return (result->init() ? result : nullptr);
+    }
+
+    /**
+     * Returns a newly allocated node with the given size.
+     *
+     * The size defines the content size, and hence the size of the cache.
+     * The bounding box of the node is (0,0,width,height). The node is
+     * anchored in the center and has position (width/2,height/2) in the
+     * parent space.
+     *
+     * @param size  The size of the node in parent space
+     *
+     * @return a newly allocated node with the given size.
+     */
+    static std::shared_ptr<CachedNode> allocWithBounds(const Size size) {
+        std::shared_ptr<CachedNode> result = std::make_shared<CachedNode>();
+        return (result->initWithBounds(size) ? result : nullptr);
+    }
+
+    /**
+     * Returns a newly allocated node with the given size.
+     *
+     * The size defines the content size, and hence the size of the cache.
+     * The bounding box of the node is (0,0,width,height). The node is
+     * anchored in the center and has position (width/2,height/2) in the
+     * parent space.
+     *
+     * @param width     The width of the node in parent space
+     * @param height    The height of the node in parent space
+     *
+     * @return a newly allocated node with the given size.
+     */
+    static std::shared_ptr<CachedNode> allocWithBounds(float width, float height) {
+        std::shared_ptr<CachedNode> result = std::make_shared<CachedNode>();
+        return (result->initWithBounds(width,height) ? result : nullptr);
+    }
+
+    /**
+     * Returns a newly allocated node with the given bounds.
+     *
+     * The rectangle origin is the bottom left corner of the node in parent
+     * space, and corresponds to the origin of the Node space. The size
+     * defines its content width and height in node space, and hence the
+     * size of the cache. The node anchor is placed in the center.
+     *
+     * @param rect  The bounds of the node in parent space
+     *
+     * @return a newly allocated node with the given bounds.
+     */
+    static std::shared_ptr<CachedNode> allocWithBounds(const Rect rect) {
+        std::shared_ptr<CachedNode> result = std::make_shared<CachedNode>();
+        return (result->initWithBounds(rect) ? result : nullptr);
+    }
+
+    /**
+     * Returns a newly allocated node with the given JSON specificaton.
+     *
+     * This initializer is designed to receive the "data" object from the
+     * JSON passed to {@link Scene2Loader}. This JSON format supports the
+     * same attributes as a {@link SceneNode}. The content size is also the
+     * size of the cache, so it should be specified.
+     *
+     * @param loader    The scene loader passing this JSON file
+     * @param data      The JSON object specifying the node
+     *
+     * @return a newly allocated node with the given JSON specificaton.
+     */
+    static std::shared_ptr<SceneNode> allocWithData(const Scene2Loader* loader,
+                                                    const std::shared_ptr<JsonValue>& data) {
+        std::shared_ptr<CachedNode> result = std::make_shared<CachedNode>();
+        if (!result->initWithData(loader,data)) { result = nullptr; }
+        return std::dynamic_pointer_cast<SceneNode>(result);
+    }
+
+#pragma mark -
+#pragma mark Attributes
+    /**
+     * Returns a string that is used to identify the node.
+     *
+     * This is used by {@link OrderedNode} to identify render barriers.
+     *
+     * @return a string that is used to identify the node.
+     */
+    virtual const std::string getClassName() const override { return "CachedNode"; }
+
+    /**
+     * Sets the color tinting this node.
+     *
+     * The tint is applied when drawing the cache, and so changing it does
+     * not invalidate the cache.
+     *
+     * @param color the color tinting this node.
+     */
+    virtual void setColor(Color4 color) override;
+
+    /**
+     * Returns true if the cache is up to date.
+     *
+     * The cache is up to date if it exists and no descendant has changed
+     * appearance since it was drawn.
+     *
+     * @return true if the cache is up to date.
+     */
+    bool isCached() const { return _target != nullptr && !_renderDirty; }
+
+    /**
+     * Releases the offscreen buffer storing the cache.
+     *
+     * The cache will be reallocated and redrawn the next time this node is
+     * rendered. You should call this method when a cached node is removed
+     * from the scene but not destroyed, to reclaim its GPU memory.
+     */
+    void clearCache();
+
+    /**
+     * Returns the offscreen texture storing the cache.
+     *
+     * This value is nullptr if this node has not been rendered since it was
+     * created (or since the last call to {@link clearCache}).
+     *
+     * @return the offscreen texture storing the cache.
+     */
+    std::shared_ptr<Texture> getCacheTexture() const;
+
+#pragma mark -
+#pragma mark Statistics
+    /**
+     * Returns the number of frames drawn from the cache.
+     *
+     * @return the number of frames drawn from the cache.
+     */
+    Uint64 getHits() const { return _hits; }
+
+    /**
+     * Returns the number of frames that redrew the cache.
+     *
+     * @return the number of frames that redrew the cache.
+     */
+    Uint64 getMisses() const { return _misses; }
+
+    /**
+     * Returns the fraction of frames drawn from the cache.
+     *
+     * If this node has not been rendered, this method returns 0.
+     *
+     * @return the fraction of frames drawn from the cache.
+     */
+    float getHitRate() const;
+
+    /**
+     * Resets the number of hits and misses to 0.
+     */
+    void resetStatistics() { _hits = 0; _misses = 0; }
+
+    /**
+     * Returns the GPU memory used by the cache in bytes.
+     *
+     * This includes both the color buffer and the depth/stencil buffer of
+     * the offscreen render target. It is 0 if there is no cache.
+     *
+     * @return the GPU memory used by the cache in bytes.
+     */
+    size_t getMemoryUsage() const;
+
+#pragma mark -
+#pragma mark Rendering
+    /**
+     * Draws this Node and all of its children with the given SpriteBatch.
+     *
+     * If the cache is up to date, this method draws it without visiting any
+     * of the children. Otherwise, it redraws the children to the cache first.
+     * This requires flushing the sprite batch, and so it should not happen
+     * often. If there is no cache, it draws the children directly.
+     *
+     * @param batch     The SpriteBatch to draw with.
+     * @param transform The global transformation matrix.
+     * @param tint      The tint to blend with the Node color.
+     */
+    virtual void render(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform, Color4 tint) override;
+
+    /**
+     * Draws the cache via the given SpriteBatch.
+     *
+     * This method only draws the cached texture. It does not update the
+     * cache, and it draws nothing if there is no cache.
+     *
+     * @param batch     The SpriteBatch to draw with.
+     * @param transform The global transformation matrix.
+     * @param tint      The tint to blend with the Node color.
+     */
+    virtual void draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform, Color4 tint) override;
+
+#pragma mark -
+#pragma mark Internal Helpers
+protected:
+    /**
+     * Returns the pixels per unit of content for the cache.
+     *
+     * This is the on-screen scale of this node under the given transform and
+     * the perspective of the sprite batch, so it includes the camera zoom. It
+     * is rounded up to a power of two, so that a smooth zoom does not redraw
+     * the cache every frame. It is also limited so that the cache does not
+     * exceed the maximum texture size.
+     *
+     * @param batch     The SpriteBatch to draw with.
+     * @param transform The global transformation matrix.
+     *
+     * @return the pixels per unit of content for the cache.
+     */
+    float computeScale(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform) const;
+
+    /**
+     * Redraws the children of this node to the cache.
+     *
+     * The cache is reallocated if the content size or the scale has changed.
+     * The sprite batch is flushed before and after drawing to the cache, and
+     * all of its state is restored afterwards. Scene culling is suspended
+     * while drawing to the cache, as the cache must hold the entire subtree.
+     *
+     * The children are drawn with a separate alpha blend function (see
+     * {@link SpriteBatch#setBlendAlphaFunc}), so that the cache stores
+     * premultiplied color with the correct alpha.
+     *
+     * This method returns false if the cache could not be allocated.
+     *
+     * @param batch     The SpriteBatch to draw with.
+     * @param scale     The pixels per unit of content for the cache.
+     *
+     * @return true if the cache was redrawn
+     */
+    bool refresh(const std::shared_ptr<SpriteBatch>& batch, float scale);
+};
+
+    }
+}
+
+#endif /* __CU_CACHED_NODE_H__ */
@@ -119,6 +119,8 @@ class PathNode : public TexturedNode {
 protected:
     /** The extrusion polygon, when the stroke > 0 */
     Poly2 _extrusion;
+    /** The extruder for this path (kept for incremental updates) */
+    SimpleExtruder _extruder;
     /** The bounds of the extruded shape */
     Rect _extrbounds;
     
@@ -219,6 +221,7 @@ public:
      *      "polygon":  An even array of polygon vertices (numbers)
      *      "indices":  An array of unsigned ints defining triangles from the
      *                  the vertices. The array size should be a multiple of 3.
+     *      "retained": Whether to draw the mesh from its own vertex buffer
      *      'stroke':   A number specifying the stroke width.
      *      'joint':    One of 'mitre', 'bevel', or 'round'.
      *      'cap':      One of 'square' or 'round'.
@@ -335,6 +338,7 @@ public:
      *      "polygon":  An even array of polygon vertices (numbers)
      *      "indices":  An array of unsigned ints defining triangles from the
      *                  the vertices. The array size should be a multiple of 3.
+     *      "retained": Whether to draw the mesh from its own vertex buffer
      *      'stroke':   A number specifying the stroke width.
      *      'joint':    One of 'mitre', 'bevel', or 'round'.
      *      'cap':      One of 'square' or 'round'.
@@ -480,6 +484,21 @@ public:
      */
     virtual void setPolygon(const Rect rect) override;
     
+    /**
+     * Moves a single vertex of the path to the given position.
+     *
+     * This method is designed for paths that are edited every frame. If
+     * the path is an implicit one (e.g. it was set from a vector of
+     * vertices) and the move does not change the bounds of the path, only
+     * the segments and joints adjacent to the vertex are re-extruded. These
+     * are patched into the existing mesh in place, without reallocation.
+     * Otherwise, this method is equivalent to resetting the polygon.
+     *
+     * @param index     The index of the vertex to move
+     * @param vertex    The new vertex position
+     */
+    void setVertex(size_t index, const Vec2 vertex);
+    
     /**
      * Returns the width of the extruded content.
      *
@@ -530,6 +549,19 @@ public:
      * @return the bounding box of the extruded content.
      */
     const Rect getExtrudedContentBounds() const { return _extrbounds; }
+    
+    /**
+     * Returns the bounding box of the content drawn by this node.
+     *
+     * This is the union of the content bounds and the extruded content
+     * bounds, as the stroke may extend past the wireframe path.
+     *
+     * @return the bounding box of the content drawn by this node.
+     */
+    virtual Rect getDrawBounds() const override {
+        Rect result = TexturedNode::getDrawBounds();
+        return result.merge(_extrbounds);
+    }
 
     
 #pragma mark Rendering
@@ -567,6 +599,17 @@ private:
      */
     virtual void generateRenderData() override;
     
+    /**
+     * Recomputes the render data for the given range of vertices.
+     *
+     * The vertices are taken from the extrusion if the stroke is positive,
+     * and from the path otherwise.
+     *
+     * @param start The first vertex to recompute
+     * @param end   The vertex after the last one to recompute
+     */
+    virtual void refreshRenderData(size_t start, size_t end) override;
+    
     /**
      * Updates the extrusion polygon, based on the current settings.
      *
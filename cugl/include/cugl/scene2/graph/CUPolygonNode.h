@@ -44,7 +44,7 @@
 
 #include <string>
 #include <cugl/scene2/graph/CUTexturedNode.h>
-#include <cugl/math/polygon/CUSimpleTriangulator.h>
+#include <cugl/math/polygon/CUTriangulationCache.h>
 
 namespace cugl {
     /**
@@ -85,13 +85,7 @@ namespace cugl {
  * use the top right.
  */
 class PolygonNode : public TexturedNode {
-#pragma mark Values
-protected:
-    /** A triangulator for those incomplete polygons */
-    static SimpleTriangulator _triangulator;
-
 public:
-#pragma mark -
 #pragma mark Constructor
     /**
      * Creates an empty polygon with the degenerate texture.
@@ -139,8 +133,8 @@ public:
      * color.
      *
      * The polygon will be triangulated using the rules of SimpleTriangulator.
-     * All PolygonNode objects share a single triangulator, so this allocator is
-     * not thread safe.
+     * The triangulation is shared through {@link TriangulationCache}, so a
+     * repeated shape is only triangulated once.
      *
      * @param vertices  The vertices to texture (expressed in image space)
      *
@@ -205,8 +199,8 @@ public:
      * Returns a textured polygon from the image filename and the given vertices.
      *
      * The polygon will be triangulated using the rules of SimpleTriangulator.
-     * All PolygonNode objects share a single triangulator, so this allocator is
-     * not thread safe.
+     * The triangulation is shared through {@link TriangulationCache}, so a
+     * repeated shape is only triangulated once.
      *
      * @param filename  A path to image file, e.g., "scene1/earthtile.png"
      * @param vertices  The vertices to texture (expressed in image space)
@@ -267,8 +261,8 @@ public:
      * Returns a textured polygon from a Texture object and the given vertices.
      *
      * The polygon will be triangulated using the rules of SimpleTriangulator.
-     * All PolygonNode objects share a single triangulator, so this method is
-     * not thread safe.
+     * The triangulation is shared through {@link TriangulationCache}, so a
+     * repeated shape is only triangulated once.
      *
      * @param texture   A shared pointer to a Texture object.
      * @param vertices  The vertices to texture (expressed in image space)
@@ -323,6 +317,7 @@ public:
      *      "polygon":  An even array of polygon vertices (numbers)
      *      "indices":  An array of unsigned ints defining triangles from the
      *                  the vertices. The array size should be a multiple of 3.
+     *      "retained": Whether to draw the mesh from its own vertex buffer
      *
      * All attributes are optional.  However, it is generally a good idea to
      * specify EITHER the texture or the polygon
@@ -345,8 +340,8 @@ public:
      * Sets the polgon to the vertices expressed in texture space.
      *
      * The polygon will be triangulated using the rules of SimpleTriangulator.
-     * All PolygonNode objects share a single triangulator, so this method is
-     * not thread safe.
+     * The triangulation is shared through {@link TriangulationCache}, so a
+     * repeated shape is only triangulated once.
      *
      * @param vertices  The vertices to texture
      */
@@ -66,6 +66,7 @@ class Scene2Loader;
     namespace scene2 {
     
 class Layout;
+class CachedNode;
     
     
 /**
@@ -218,6 +219,17 @@ protected:
     int  _zOrder;
     /** Indicates whether or not the z-order is currently violated */
     bool _zDirty;
+    /** Indicates whether the appearance changed since it was last cached */
+    bool _renderDirty;
+    
+    /** The bounds of this node and its visible descendants in node space */
+    Rect _cullBounds;
+    /** The number of visible nodes in this subtree (for cull statistics) */
+    Uint32 _cullCount;
+    /** Whether this subtree has no content to bound (and is never culled) */
+    bool _cullEmpty;
+    /** Indicates whether the culling bounds must be recomputed */
+    bool _cullDirty;
     
     /** The rendering priority; used by {@link OrderedNode} */
     float _priority;
@@ -980,7 +992,7 @@ public:
      *
      * @param color the color tinting this node.
      */
-    virtual void setColor(Color4 color) { _tintColor = color; }
+    virtual void setColor(Color4 color) { _tintColor = color; setRenderDirty(); }
 
     /**
      * Returns the absolute color tinting this node.
@@ -1013,7 +1025,7 @@ public:
      *
      * @param visible   true if the node is visible.
      */
-    void setVisible(bool visible) { _isVisible = visible; }
+    void setVisible(bool visible);
     
     /**
      * Returns true if this node is tinted by its parent.
@@ -1035,7 +1047,7 @@ public:
      *
      * @param flag  Whether this node is tinted by its parent.
      */
-    void setRelativeColor(bool flag) { _hasParentColor = flag; }
+    void setRelativeColor(bool flag) { _hasParentColor = flag; setRenderDirty(); }
     
     /**
      * Returns the scissor associated with this node.
@@ -1091,7 +1103,7 @@ public:
      *
      * @param scissor   The scissor associated with this node.
      */
-    void setScissor(const std::shared_ptr<Scissor>& scissor) { _scissor = scissor;}
+    void setScissor(const std::shared_ptr<Scissor>& scissor) { _scissor = scissor; setRenderDirty(); }
 
     /**
      * Sets a content-bounded scissor associated with this node.
@@ -1115,7 +1127,7 @@ public:
      * of the same orientation. The rule for this intersection will
      * be the same as {@link Scissor#intersect}.
      */
-    void setScissor() { _scissor = Scissor::alloc(getContentSize());}
+    void setScissor() { _scissor = Scissor::alloc(getContentSize()); setRenderDirty(); }
 
     
 #pragma mark -
@@ -1909,6 +1921,7 @@ public:
      */
     void setPriority(float priority) {
         _priority = priority;
+        setRenderDirty();
     }
 
     /**
@@ -1983,6 +1996,95 @@ public:
      */
     virtual void draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform, Color4 tint) {}
     
+    /**
+     * Returns true if the appearance of this node has changed since it was cached.
+     *
+     * This value is used by {@link CachedNode} to decide when to redraw its
+     * subtree. It satisfies the following invariant: if a node is dirty, then
+     * so are all of its ancestors. Our methods guarantee this invariant, so
+     * a cached subtree is clean exactly when its root is clean.
+     *
+     * Nodes outside of a {@link CachedNode} are never cleaned, and so this
+     * method will always return true for them.
+     *
+     * @return true if the appearance of this node has changed since it was cached.
+     */
+    bool isRenderDirty() const { return _renderDirty; }
+    
+    /**
+     * Marks the appearance of this node as changed.
+     *
+     * This method marks this node and all of its ancestors as dirty, so that
+     * any enclosing {@link CachedNode} will redraw its subtree. The setters
+     * of this class (and its subclasses) call this method automatically. You
+     * only need to call it if you change the appearance of a node in some
+     * other way, such as modifying a texture that it draws.
+     *
+     * Changes to the position, scale, or angle of a node do not change its
+     * own appearance. They mark the parent instead. Therefore moving a
+     * {@link CachedNode} (or any of its ancestors) does not invalidate the
+     * cache.
+     *
+     * This method also invalidates the culling bounds of this node and its
+     * ancestors (see {@link #getSubtreeBounds}).
+     */
+    void setRenderDirty();
+    
+#pragma mark -
+#pragma mark Culling
+    /**
+     * Returns the bounding box of the content drawn by this node.
+     *
+     * The bounding box is in node space. By default, it is the rectangle
+     * (0,0,width,height) of the content size. Subclasses that draw outside
+     * of their content bounds (such as {@link PathNode}) should override
+     * this method, or else they may be culled while partly on screen.
+     *
+     * The value does not include the children of this node.
+     *
+     * @return the bounding box of the content drawn by this node.
+     */
+    virtual Rect getDrawBounds() const {
+        return Rect(Vec2::ZERO,_contentSize);
+    }
+    
+    /**
+     * Returns the bounding box of this node and its visible descendants.
+     *
+     * The bounding box is in node space, and is the union of {@link #getDrawBounds}
+     * with the (transformed) subtree bounds of each visible child. Nodes with
+     * no content size do not contribute to the bounds.
+     *
+     * This value is cached, and is only recomputed when a node in this
+     * subtree changes (see {@link #setRenderDirty}). As it is in node space,
+     * moving this node, or any of its ancestors, does not invalidate it.
+     *
+     * @return the bounding box of this node and its visible descendants.
+     */
+    const Rect& getSubtreeBounds() {
+        if (_cullDirty) { updateCullBounds(); }
+        return _cullBounds;
+    }
+    
+    /**
+     * Returns true if this node and its descendants may be skipped.
+     *
+     * A subtree is culled if culling is active in its {@link Scene2} and the
+     * subtree bounds, in world space, do not overlap the visible region of the
+     * scene camera. Culling is only active while the scene is rendering, and
+     * only if it is enabled with {@link Scene2#setCulling}. A subtree with no
+     * content bounds is never culled.
+     *
+     * This method is called by {@link #render} before drawing this node. Any
+     * subclass that overrides render (or that renders its descendants in some
+     * other way) should call it as well.
+     *
+     * @param transform The global transformation matrix of this node
+     *
+     * @return true if this node and its descendants may be skipped.
+     */
+    bool isCulled(const Mat4& transform);
+    
     
 #pragma mark -
 #pragma mark Layout Automation
@@ -2046,6 +2148,24 @@ private:
      */
     void setZDirty(bool value);
     
+    /**
+     * Marks this node and all of its descendants as clean.
+     *
+     * This method is called by {@link CachedNode} after it redraws its
+     * subtree. It is the only way to clean a node.
+     */
+    void clearRenderDirty();
+    
+    /**
+     * Recomputes the culling bounds of this subtree.
+     *
+     * This method recomputes the bounds of any dirty children (visible or
+     * not) first, so that the entire subtree is clean afterwards. This is
+     * what allows {@link #setRenderDirty} to stop at the first node whose
+     * culling bounds are already dirty.
+     */
+    void updateCullBounds();
+    
     /**
      * Sets the parent node.
      *
@@ -2100,6 +2220,7 @@ private:
     CU_DISALLOW_COPY_AND_ASSIGN(SceneNode);
     
     friend class cugl::Scene2;
+    friend class CachedNode;
 };
     }
 
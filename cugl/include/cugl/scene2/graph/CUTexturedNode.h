@@ -40,6 +40,7 @@
 #include <cugl/render/CUTexture.h>
 #include <cugl/render/CUSpriteVertex.h>
 #include <cugl/render/CUMesh.h>
+#include <cugl/render/CUSpriteMesh.h>
 
 namespace cugl {
 
@@ -112,6 +113,12 @@ protected:
     bool _rendered;
     /** The render data for this node */
     Mesh<SpriteVertex2> _mesh;
+    /** Whether to draw the render data from a retained GPU mesh */
+    bool _retained;
+    /** The render data retained on the GPU (if any) */
+    std::shared_ptr<SpriteMesh> _retainedMesh;
+    /** Whether the retained mesh is out of date with the render data */
+    bool _retainedDirty;
     
     /** The blending equation for this texture */
     GLenum _blendEquation;
@@ -329,6 +336,7 @@ public:
      *      "polygon":  An even array of polygon vertices (numbers)
      *      "indices":  An array of unsigned ints defining triangles from the
      *                  the vertices. The array size should be a multiple of 3.
+     *      "retained": Whether to draw the mesh from its own vertex buffer
      *
      * All attributes are optional.  However, it is generally a good idea to
      * specify EITHER the texture or the polygon
@@ -459,7 +467,7 @@ public:
      * @param srcFactor Specifies how the source blending factors are computed
      * @param dstFactor Specifies how the destination blending factors are computed.
      */
-    void setBlendFunc(GLenum srcFactor, GLenum dstFactor) { _srcFactor = srcFactor; _dstFactor = dstFactor; }
+    void setBlendFunc(GLenum srcFactor, GLenum dstFactor) { _srcFactor = srcFactor; _dstFactor = dstFactor; setRenderDirty(); }
     
     /**
      * Returns the source blending factor
@@ -487,7 +495,7 @@ public:
      *
      * @return the destination blending factor
      */
-    GLenum getDestinationBlendFactor() const { return _srcFactor; }
+    GLenum getDestinationBlendFactor() const { return _dstFactor; }
     
     /**
      * Sets the blending equation for this textured node
@@ -504,7 +512,7 @@ public:
      *
      * @param equation  Specifies how source and destination colors are combined
      */
-    void setBlendEquation(GLenum equation) { _blendEquation = equation; }
+    void setBlendEquation(GLenum equation) { _blendEquation = equation; setRenderDirty(); }
     
     /**
      * Returns the blending equation for this textured node
@@ -606,8 +614,19 @@ public:
     void setAbsolute(bool flag) {
         _absolute = flag;
         _anchor = Vec2::ANCHOR_BOTTOM_LEFT;
+        setRenderDirty();
     }
     
+    /**
+     * Returns the bounding box of the content drawn by this node.
+     *
+     * This is the content bounds unless the node uses absolute positioning.
+     * In that case, the polygon keeps its offset from the node origin.
+     *
+     * @return the bounding box of the content drawn by this node.
+     */
+    virtual Rect getDrawBounds() const override;
+    
     /**
      * Sets the anchor point in percentages.
      *
@@ -720,6 +739,39 @@ public:
      */
     void setGradient(const std::shared_ptr<Gradient>& gradient);
 
+    /**
+     * Sets whether to draw this node from a retained GPU mesh.
+     *
+     * Normally the render data of this node is transformed on the CPU and
+     * copied into the sprite batch every frame. A retained node instead
+     * uploads its render data once to its own {@link SpriteMesh}, and draws
+     * it with a transform uniform. Moving the node only changes the matrix.
+     * The mesh is uploaded again only when the render data changes (e.g. a
+     * new polygon, texture, or animation frame).
+     *
+     * Each retained node is a separate draw call. Hence this is only worth
+     * it for nodes with many vertices, such as large level pieces and
+     * paths. Small sprites should still be batched.
+     *
+     * This method must be called on the rendering thread, as disabling a
+     * retained node releases its vertex buffer.
+     *
+     * @param flag  Whether to draw this node from a retained GPU mesh
+     */
+    void setRetained(bool flag);
+
+    /**
+     * Returns true if this node is drawn from a retained GPU mesh.
+     *
+     * Normally the render data of this node is transformed on the CPU and
+     * copied into the sprite batch every frame. A retained node instead
+     * uploads its render data once to its own {@link SpriteMesh}, and draws
+     * it with a transform uniform. Moving the node only changes the matrix.
+     *
+     * @return true if this node is drawn from a retained GPU mesh.
+     */
+    bool isRetained() const { return _retained; }
+
     
 #pragma mark -
 #pragma mark Internal Helpers
@@ -729,6 +781,20 @@ protected:
      */
     virtual void generateRenderData();
     
+    /**
+     * Recomputes the render data for the given range of vertices.
+     *
+     * This method assumes that the render data is present and that the
+     * mesh vertices correspond to the polygon vertices. It resets the
+     * positions, texture coordinates and gradient coordinates of the
+     * vertices in the range [start,end) in place. This allows a node to
+     * move a few vertices without reallocating its mesh.
+     *
+     * @param start The first vertex to recompute
+     * @param end   The vertex after the last one to recompute
+     */
+    virtual void refreshRenderData(size_t start, size_t end);
+    
     /**
      * Clears the render data, releasing all vertices and indices.
      */
@@ -743,6 +809,18 @@ protected:
      */
     void updateTextureCoords();
 
+    /**
+     * Draws the render data via the given SpriteBatch.
+     *
+     * The render data is filled if it is triangulated, and outlined
+     * otherwise. If this node is retained, the render data is drawn from the
+     * retained mesh, which is (re)uploaded first if necessary.
+     *
+     * @param batch     The SpriteBatch to draw with.
+     * @param transform The global transformation matrix.
+     */
+    void drawMesh(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform);
+
     /** This macro disables the copy constructor (not allowed on scene graphs) */
     CU_DISALLOW_COPY_AND_ASSIGN(TexturedNode);
 
@@ -197,6 +197,7 @@ public:
      *      "traveral": One of 'open', 'closed', or 'interior'
      *      "indices":  An array of unsigned ints defining triangles from the
      *                  the vertices. The array size should be a multiple of 3.
+     *      "retained": Whether to draw the mesh from its own vertex buffer
      *
      * All attributes are optional.  However, it is generally a good idea to
      * specify EITHER the texture or the polygon.  If you specify the indices,
@@ -320,6 +321,7 @@ public:
      *      "traveral": One of 'open', 'closed', or 'interior'
      *      "indices":  An array of unsigned ints defining triangles from the
      *                  the vertices. The array size should be a multiple of 3.
+     *      "retained": Whether to draw the mesh from its own vertex buffer
      *
      * All attributes are optional.  However, it is generally a good idea to
      * specify EITHER the texture or the polygon.  If you specify the indices,
@@ -394,6 +396,21 @@ public:
      */
     virtual void setPolygon(const Rect rect) override;
 
+    /**
+     * Moves a single vertex of the source polygon to the given position.
+     *
+     * This method is designed for wireframes that are edited every frame.
+     * If the traversal is open or closed on an implicit source, the vertex
+     * is moved in the existing mesh in place, provided that the move does
+     * not change the bounds of the wireframe. Otherwise, this method
+     * recomputes the traversal. An interior traversal keeps its original
+     * triangulation.
+     *
+     * @param index     The index of the vertex to move
+     * @param vertex    The new vertex position
+     */
+    void setVertex(size_t index, const Vec2 vertex);
+
 #pragma mark -
 #pragma mark Rendering
     /**
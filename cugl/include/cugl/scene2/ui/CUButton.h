@@ -373,7 +373,8 @@ public:
      * The pushable region is the area of this node that responds to mouse
      * clicks.  By allowing it to be an arbitrary polygon, we are capable of
      * defining buttons with complex shapes. The vertices will be converted
-     * into a polygon using {@link SimpleTriangulator}.
+     * into a polygon using {@link SimpleTriangulator}, through the shared
+     * {@link TriangulationCache}.
      *
      * @param vertices  The region responding to mouse clicks.
      */
@@ -216,6 +216,14 @@ protected:
     Color4 _foreground;
     /** The color of the background panel (default is CLEAR) */
     Color4 _background;
+    /** The outline width in texels (distance field fonts only) */
+    float  _outlineWidth;
+    /** The outline color (distance field fonts only) */
+    Color4 _outlineColor;
+    /** The drop shadow offset in texels (distance field fonts only) */
+    Vec2   _shadowOffset;
+    /** The drop shadow color (distance field fonts only) */
+    Color4 _shadowColor;
     
     /** The blending equation for this texture */
     GLenum _blendEquation;
@@ -226,6 +234,8 @@ protected:
 
     /** Whether or not the glyphs have been rendered */
     bool _rendered;
+    /** The font generation when the glyphs were rendered */
+    Uint64 _generation;
     /** The glyph vertices */
     Mesh<SpriteVertex2> _mesh;
     /** The font bounds */
@@ -339,6 +349,8 @@ public:
      *      "foreground":   A four-element integer array. Values should be 0..255
      *      "background":   A four-element integer array. Values should be 0..255
      *      "padding":      A two-element float array.
+     *      "outline":      A five-element array of the width and color (0..255)
+     *      "shadow":       A six-element array of the offset and color (0..255)
      *      "halign":       One of 'left', 'center', 'right', 'hard left',
      *                      'true center' and 'hard right'.
      *      "valign":       One of 'top', 'middle', 'bottom', 'hard top',
@@ -430,6 +442,8 @@ public:
      *      "foreground":   A four-element integer array. Values should be 0..255
      *      "background":   A four-element integer array. Values should be 0..255
      *      "padding":      A two-element float array.
+     *      "outline":      A five-element array of the width and color (0..255)
+     *      "shadow":       A six-element array of the offset and color (0..255)
      *      "halign":       One of 'left', 'center', 'right', 'hard left',
      *                      'true center' and 'hard right'.
      *      "valign":       One of 'top', 'middle', 'bottom', 'hard top',
@@ -775,6 +789,76 @@ public:
      * @param color The background color of this label.
      */
     void setBackground(Color4 color);
+
+    /**
+     * Returns the outline width of this label in texels.
+     *
+     * Outlines are only supported by fonts with a distance field atlas (see
+     * {@link Font#setDistanceSpread}). The width is measured in texels of
+     * the atlas, so it scales with the text. It cannot be larger than the
+     * font spread. This value is 0 by default.
+     *
+     * @return the outline width of this label in texels.
+     */
+    float getOutlineWidth() const { return _outlineWidth; }
+
+    /**
+     * Returns the outline color of this label.
+     *
+     * Outlines are only supported by fonts with a distance field atlas (see
+     * {@link Font#setDistanceSpread}). This color is CLEAR by default.
+     *
+     * @return the outline color of this label.
+     */
+    Color4 getOutlineColor() const { return _outlineColor; }
+
+    /**
+     * Sets the outline of this label.
+     *
+     * Outlines are only supported by fonts with a distance field atlas (see
+     * {@link Font#setDistanceSpread}). The width is measured in texels of
+     * the atlas, so it scales with the text. It cannot be larger than the
+     * font spread. A width of 0 disables the outline.
+     *
+     * @param width The outline width in texels
+     * @param color The outline color
+     */
+    void setOutline(float width, Color4 color) { _outlineWidth = width; _outlineColor = color; setRenderDirty(); }
+
+    /**
+     * Returns the drop shadow offset of this label in texels.
+     *
+     * Drop shadows are only supported by fonts with a distance field atlas
+     * (see {@link Font#setDistanceSpread}). The offset is measured in texels
+     * of the atlas, so it scales with the text. It should not be larger
+     * than the font spread.
+     *
+     * @return the drop shadow offset of this label in texels.
+     */
+    const Vec2 getShadowOffset() const { return _shadowOffset; }
+
+    /**
+     * Returns the drop shadow color of this label.
+     *
+     * Drop shadows are only supported by fonts with a distance field atlas
+     * (see {@link Font#setDistanceSpread}). This color is CLEAR by default.
+     *
+     * @return the drop shadow color of this label.
+     */
+    Color4 getShadowColor() const { return _shadowColor; }
+
+    /**
+     * Sets the drop shadow of this label.
+     *
+     * Drop shadows are only supported by fonts with a distance field atlas
+     * (see {@link Font#setDistanceSpread}). The offset is measured in texels
+     * of the atlas, so it scales with the text. It should not be larger
+     * than the font spread. A CLEAR color disables the shadow.
+     *
+     * @param offset    The drop shadow offset in texels
+     * @param color     The drop shadow color
+     */
+    void setShadow(const Vec2 offset, Color4 color) { _shadowOffset = offset; _shadowColor = color; setRenderDirty(); }
     
     /**
      * Returns the font to use for this label
@@ -814,7 +898,7 @@ public:
      * @param srcFactor Specifies how the source blending factors are computed
      * @param dstFactor Specifies how the destination blending factors are computed.
      */
-    void setBlendFunc(GLenum srcFactor, GLenum dstFactor) { _srcFactor = srcFactor; _dstFactor = dstFactor; }
+    void setBlendFunc(GLenum srcFactor, GLenum dstFactor) { _srcFactor = srcFactor; _dstFactor = dstFactor; setRenderDirty(); }
     
     /**
      * Returns the source blending factor
@@ -859,7 +943,7 @@ public:
      *
      * @param equation  Specifies how source and destination colors are combined
      */
-    void setBlendEquation(GLenum equation) { _blendEquation = equation; }
+    void setBlendEquation(GLenum equation) { _blendEquation = equation; setRenderDirty(); }
     
     /**
      * Returns the blending equation for this textured node
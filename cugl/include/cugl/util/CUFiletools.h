@@ -6,6 +6,10 @@
 //  OS indepedent way.  It is largely a collection of namespaced functions, much 
 //  like the strings module. It is based off the the os.path module in Python.
 //
+//  The path manipulation functions have variants that take string views and
+//  write to a caller-provided string.  These reuse the buffer of the output
+//  string, so loops over many paths (such as asset loading) need not allocate.
+//
 //  CUGL MIT License:
 //      This software is provided 'as-is', without any express or implied
 //      warranty.  In no event will the authors be held liable for any damages
@@ -30,6 +34,7 @@
 #ifndef __CU_FILE_TOOLS_H__
 #define __CU_FILE_TOOLS_H__
 #include <string>
+#include <string_view>
 #include <vector>
 #include <functional>
 #include <initializer_list>
@@ -82,7 +87,7 @@ namespace cugl {
      *
      * @return true if the file named by this path name is a hidden file.
      */
-    bool is_hidden(const std::string path);
+    bool is_hidden(std::string_view path);
 
     /**
      * Returns true if this path name is absolute.
@@ -93,7 +98,7 @@ namespace cugl {
      *
      * @return true if this path name is absolute.
     */
-    bool is_absolute(const std::string path);
+    bool is_absolute(std::string_view path);
 
     /**
      * Returns true if the file or directory denoted by this path name exists.
@@ -169,6 +174,17 @@ namespace cugl {
      */
     const std::string dir_name(const std::string path);
 
+    /**
+     * Stores the path name of the parent directory for this file in result.
+     *
+     * This is the same as {@link dir_name}, except that it reuses the buffer
+     * of result instead of allocating a new string.
+     *
+     * @param path      The file path name
+     * @param result    The string to store the parent directory
+     */
+    void dir_name(std::string_view path, std::string& result);
+
     /**
      * Returns the name of the leaf file of this path.
      *
@@ -182,6 +198,17 @@ namespace cugl {
      */
     const std::string base_name(const std::string path);
 
+    /**
+     * Stores the name of the leaf file of this path in result.
+     *
+     * This is the same as {@link base_name}, except that it reuses the buffer
+     * of result instead of allocating a new string.
+     *
+     * @param path      The file path name
+     * @param result    The string to store the leaf file name
+     */
+    void base_name(std::string_view path, std::string& result);
+
     /**
      * Returns the pair of a leaf file and its parent directory.
      *
@@ -196,6 +223,18 @@ namespace cugl {
      */
     std::pair<std::string, std::string> split_path(const std::string path);
 
+    /**
+     * Stores the leaf file and its parent directory in the given strings.
+     *
+     * This is the same as {@link split_path}, except that it reuses the
+     * buffers of dir and base instead of allocating new strings.
+     *
+     * @param path  The file path name
+     * @param dir   The string to store the parent directory
+     * @param base  The string to store the leaf file name
+     */
+    void split_path(std::string_view path, std::string& dir, std::string& base);
+
     /**
      * Returns the path name broken up into individual elements.
      *
@@ -292,6 +331,18 @@ namespace cugl {
      */
     const std::string normalize_path(const std::string path);
 
+    /**
+     * Stores the given path, normalized to the current platform, in result.
+     *
+     * This is the same as {@link normalize_path}, except that it reuses the
+     * buffer of result.  The path is normalized in a single pass, without
+     * splitting it into a vector of components first.
+     *
+     * @param path      The file path name
+     * @param result    The string to store the normalized path
+     */
+    void normalize_path(std::string_view path, std::string& result);
+
     /**
      * Returns the given path, canonicalized to the current platform
      *
@@ -394,6 +445,18 @@ namespace cugl {
      */
     const std::string join_path(const std::string* elts, size_t size);
 
+    /**
+     * Stores a path that is the concatentation of elts in result.
+     *
+     * This is the same as {@link join_path}, except that it reuses the buffer
+     * of result.  The buffer is sized once, so there is at most one allocation
+     * (and none if result is already large enough).
+     *
+     * @param elts      The strings to join
+     * @param result    The string to store the path
+     */
+    void join_path(std::initializer_list<std::string_view> elts, std::string& result);
+
 
 #pragma mark -
 #pragma mark File Manipulation
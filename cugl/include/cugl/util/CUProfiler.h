@@ -0,0 +1,619 @@
+//
+//  CUProfiler.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a frame profiler. The application FPS and the sprite
+//  batch statistics can tell us that a frame is slow, but not why. This
+//  profiler records named zones of CPU time (update, render, flush, audio)
+//  and of GPU time (via timer queries) into ring buffers. The results can be
+//  exported as Chrome trace JSON (for chrome://tracing or Perfetto), or drawn
+//  as an overlay in the game itself.
+//
+//  This class is a singleton, like the AudioEngine. You start it with the
+//  static method start(), and access it with get(). Zones are best recorded
+//  with the CUProfileZone and CUProfileGPUZone macros, which do nothing if the
+//  profiler is not running.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: agent
+//  Version: 10/19/26
+//
+#ifndef __CU_PROFILER_H__
+#define __CU_PROFILER_H__
+#include <cugl/base/CUBase.h>
+#include <cugl/util/CUTimestamp.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace cugl {
+
+/** Forward references */
+class JsonValue;
+class SpriteBatch;
+class Rect;
+
+/**
+ * This class is a singleton frame profiler.
+ *
+ * The profiler records zones, which are named intervals of time. There are
+ * three tracks of zones. The main track holds CPU zones on the main thread.
+ * These zones may nest (e.g. a flush inside of render), and they are
+ * recorded with {@link #beginZone} and {@link #endZone}, or better yet with
+ * the macro {@link CUProfileZone}. The thread track holds CPU zones from
+ * other threads, like the audio callback. These zones are recorded all at
+ * once with {@link #recordZone}. Finally, the GPU track holds the time
+ * the GPU spent on commands issued between {@link #beginGPUZone} and
+ * {@link #endGPUZone} (or the macro {@link CUProfileGPUZone}).
+ *
+ * GPU zones use asynchronous timer queries (GL_TIME_ELAPSED, or the
+ * extension EXT_disjoint_timer_query on OpenGLES). The results are collected
+ * at the end of a later frame, so they never stall the pipeline. GPU zones
+ * may not nest, and they are silently ignored if the device has no timer
+ * queries (see {@link #hasGPUTimers}). A timer query measures a duration,
+ * not a time. So a GPU zone is placed at the time its commands were issued
+ * on the CPU, which is only an approximation of when the GPU ran them.
+ *
+ * All zones are stored in preallocated ring buffers, so recording a zone
+ * never allocates memory. Only the most recent zones are kept. For the same
+ * reason, zone names must be string literals (or otherwise outlive the
+ * profiler), as they are not copied.
+ *
+ * The application brackets each frame with {@link #beginFrame} and
+ * {@link #endFrame}, recording the zones "update", "render" and "swap".
+ * The sprite batch records the zones "flush" and "mesh" on both the main
+ * and the GPU track, and the audio output records "audio" on the thread
+ * track.
+ *
+ * IMPORTANT: Like the OpenGL context, this class is not thread-safe. The
+ * only method that may be called outside of the main thread is
+ * {@link #recordZone}. Because the audio thread records zones, the profiler
+ * should be stopped after the {@link AudioEngine}.
+ */
+class Profiler {
+#pragma mark Values
+public:
+    /** The default number of zones kept on each track */
+    static const Uint32 DEFAULT_CAPACITY = 8192;
+
+    /**
+     * This enumeration identifies the track of a zone
+     */
+    enum class Track : Uint8 {
+        /** A CPU zone on the main thread */
+        MAIN = 0,
+        /** A CPU zone on another thread */
+        THREAD = 1,
+        /** A GPU zone measured by a timer query */
+        GPU = 2
+    };
+
+    /**
+     * This class is a single recorded zone.
+     *
+     * All times are in nanoseconds since the profiler was started.
+     */
+    class Zone {
+    public:
+        /** The name of this zone (not owned by the zone) */
+        const char* name;
+        /** The start time of this zone in nanoseconds */
+        Uint64 start;
+        /** The duration of this zone in nanoseconds */
+        Uint64 duration;
+        /** The frame in which this zone started */
+        Uint32 frame;
+        /** The nesting depth of this zone (0 for the frame itself) */
+        Uint32 depth;
+        /** The track of this zone */
+        Track track;
+    };
+
+private:
+    /**
+     * This class is a ring buffer of zones.
+     *
+     * The buffer is preallocated, and the oldest zones are overwritten when
+     * it is full.
+     */
+    class Ring {
+    public:
+        /** The zone storage */
+        std::vector<Zone> zones;
+        /** The index of the next zone to write */
+        size_t head;
+        /** The number of zones in the buffer */
+        size_t size;
+
+        /**
+         * Creates a ring buffer with the given capacity
+         *
+         * @param capacity  The maximum number of zones
+         */
+        Ring(size_t capacity) : head(0), size(0) { zones.resize(capacity); }
+
+        /**
+         * Adds a zone to the ring buffer, overwriting the oldest if full
+         *
+         * @param zone  The zone to add
+         */
+        void push(const Zone& zone) {
+            zones[head] = zone;
+            head = (head+1) % zones.size();
+            size = size < zones.size() ? size+1 : size;
+        }
+
+        /**
+         * Returns the zone at the given position, where 0 is the oldest
+         *
+         * @param pos   The position in the ring buffer
+         *
+         * @return the zone at the given position, where 0 is the oldest
+         */
+        const Zone& at(size_t pos) const {
+            return zones[(head+zones.size()-size+pos) % zones.size()];
+        }
+
+        /**
+         * Removes all zones from the ring buffer
+         */
+        void clear() { head = 0; size = 0; }
+    };
+
+    /**
+     * This class is an open zone on the main track
+     */
+    class OpenZone {
+    public:
+        /** The name of the zone */
+        const char* name;
+        /** The start time of the zone */
+        Uint64 start;
+    };
+
+    /**
+     * This class is a GPU timer query waiting for its result
+     */
+    class Query {
+    public:
+        /** The OpenGL query object */
+        GLuint query;
+        /** The name of the zone */
+        const char* name;
+        /** The CPU time at which the zone began */
+        Uint64 start;
+        /** The frame in which the zone began */
+        Uint32 frame;
+    };
+
+    /** Reference to the profiler singleton */
+    static Profiler* _gProfiler;
+
+    /** The moment the profiler was started */
+    Timestamp _origin;
+    /** Whether the profiler is currently recording */
+    bool _enabled;
+    /** The current frame number (read by other threads) */
+    std::atomic<Uint32> _frame;
+    /** Whether we are currently inside of a frame */
+    bool _inframe;
+
+    /** The zones on the main track */
+    Ring _main;
+    /** The zones on the GPU track */
+    Ring _gpu;
+    /** The zones from other threads */
+    Ring _thread;
+    /** The mutex guarding the thread zones */
+    mutable std::mutex _mutex;
+    /** The number of thread zones dropped to avoid blocking */
+    std::atomic<Uint32> _dropped;
+
+    /** The stack of open zones on the main track */
+    std::vector<OpenZone> _stack;
+    /** The depth of the stack of open zones */
+    size_t _depth;
+
+    /** Whether this device supports timer queries */
+    bool _gpuTimers;
+    /** The query objects, used as a ring buffer */
+    std::vector<Query> _queries;
+    /** The index of the oldest query awaiting its result */
+    size_t _queryTail;
+    /** The number of queries awaiting their result */
+    size_t _queryCount;
+    /** Whether a GPU zone is currently open */
+    bool _gpuOpen;
+    /** The nesting depth of ignored GPU zones */
+    Uint32 _gpuIgnored;
+
+#pragma mark -
+#pragma mark Constructors
+    /**
+     * Creates a new profiler with the given capacity.
+     *
+     * This constructor is private. Use {@link #start} instead.
+     *
+     * @param capacity  The number of zones kept on each track
+     */
+    Profiler(Uint32 capacity);
+
+    /**
+     * Deletes this profiler, releasing all resources.
+     *
+     * This destructor is private. Use {@link #stop} instead.
+     */
+    ~Profiler();
+
+    /** This class cannot be copied */
+    CU_DISALLOW_COPY_AND_ASSIGN(Profiler);
+
+public:
+    /**
+     * Returns the singleton instance of the profiler.
+     *
+     * If the profiler has not been started, then this method will return
+     * nullptr.
+     *
+     * @return the singleton instance of the profiler.
+     */
+    static Profiler* get() { return _gProfiler; }
+
+    /**
+     * Starts the singleton profiler.
+     *
+     * Once this method is called, the method get() will no longer return
+     * nullptr. Calling the method multiple times (without calling stop) will
+     * have no effect. This method must be called after the OpenGL context
+     * is created, as it allocates the GPU timer queries.
+     *
+     * @param capacity  The number of zones kept on each track
+     *
+     * @return true if the profiler was successfully started
+     */
+    static bool start(Uint32 capacity=DEFAULT_CAPACITY);
+
+    /**
+     * Shuts down the singleton profiler, releasing all resources.
+     *
+     * Once this method is called, the method get() will return nullptr.
+     * Calling the method multiple times (without calling start) will have
+     * no effect.
+     */
+    static void stop();
+
+#pragma mark -
+#pragma mark Attributes
+    /**
+     * Returns true if the profiler is recording zones.
+     *
+     * A profiler that is not enabled ignores all zones. This allows you to
+     * freeze the current contents of the ring buffers for inspection.
+     *
+     * @return true if the profiler is recording zones.
+     */
+    bool isEnabled() const { return _enabled; }
+
+    /**
+     * Sets whether the profiler is recording zones.
+     *
+     * A profiler that is not enabled ignores all zones. This allows you to
+     * freeze the current contents of the ring buffers for inspection.
+     *
+     * @param value Whether the profiler is recording zones.
+     */
+    void setEnabled(bool value);
+
+    /**
+     * Returns true if this device supports GPU timer queries.
+     *
+     * If this value is false, all GPU zones are ignored.
+     *
+     * @return true if this device supports GPU timer queries.
+     */
+    bool hasGPUTimers() const { return _gpuTimers; }
+
+    /**
+     * Returns the current frame number.
+     *
+     * @return the current frame number.
+     */
+    Uint32 getFrame() const { return _frame.load(); }
+
+    /**
+     * Returns the number of thread zones dropped.
+     *
+     * A thread zone is dropped, rather than blocking its thread, if the main
+     * thread is reading the thread track at the same time.
+     *
+     * @return the number of thread zones dropped.
+     */
+    Uint32 getDropped() const { return _dropped.load(); }
+
+    /**
+     * Returns the current time in nanoseconds since the profiler started.
+     *
+     * This is the clock used by all of the zones.
+     *
+     * @return the current time in nanoseconds since the profiler started.
+     */
+    Uint64 now() const {
+        Timestamp stamp;
+        return Timestamp::ellapsedNanos(_origin,stamp);
+    }
+
+    /**
+     * Removes all recorded zones.
+     *
+     * Queries that are still waiting on the GPU will be recorded when they
+     * complete.
+     */
+    void clear();
+
+#pragma mark -
+#pragma mark Recording
+    /**
+     * Marks the start of a new frame.
+     *
+     * This opens a zone named "frame" at depth 0 on the main track. This
+     * method is called by the {@link Application} and should not be called
+     * directly.
+     */
+    void beginFrame();
+
+    /**
+     * Marks the end of the current frame.
+     *
+     * This closes the frame zone and collects the results of any finished
+     * GPU timer queries. This method is called by the {@link Application}
+     * and should not be called directly.
+     */
+    void endFrame();
+
+    /**
+     * Opens a zone on the main track.
+     *
+     * This zone is nested inside of any zone that is currently open. The
+     * name must outlive the profiler, as it is not copied. This method may
+     * only be called on the main thread.
+     *
+     * @param name  The name of the zone
+     */
+    void beginZone(const char* name);
+
+    /**
+     * Closes the most recent zone on the main track.
+     *
+     * This method may only be called on the main thread.
+     */
+    void endZone();
+
+    /**
+     * Records a completed zone from a thread other than the main thread.
+     *
+     * The times should come from {@link #now}. This method never blocks.
+     * If the main thread is reading the thread track, the zone is dropped.
+     *
+     * @param name  The name of the zone
+     * @param start The start time of the zone in nanoseconds
+     * @param end   The end time of the zone in nanoseconds
+     */
+    void recordZone(const char* name, Uint64 start, Uint64 end);
+
+    /**
+     * Opens a GPU zone, measuring all commands until {@link #endGPUZone}.
+     *
+     * GPU zones may not nest. If a GPU zone is already open, this method
+     * (and its matching call to endGPUZone) is ignored. It is also ignored
+     * if the device has no timer queries, or if every query is still waiting
+     * on the GPU.
+     *
+     * @param name  The name of the zone
+     */
+    void beginGPUZone(const char* name);
+
+    /**
+     * Closes the current GPU zone.
+     *
+     * The result of the zone is collected at the end of a later frame.
+     */
+    void endGPUZone();
+
+#pragma mark -
+#pragma mark Results
+    /**
+     * Returns the zones on the given track, from oldest to newest.
+     *
+     * Zones on the main and thread tracks are ordered by end time. Zones on
+     * the GPU track are ordered by start time.
+     *
+     * @param track The track to query
+     *
+     * @return the zones on the given track, from oldest to newest.
+     */
+    std::vector<Zone> getZones(Track track) const;
+
+    /**
+     * Returns the average duration of the named zone in milliseconds.
+     *
+     * The average is taken over the recorded zones on the given track. It is
+     * 0 if there are no such zones.
+     *
+     * @param name  The name of the zone
+     * @param track The track of the zone
+     *
+     * @return the average duration of the named zone in milliseconds.
+     */
+    float getAverage(const std::string& name, Track track=Track::MAIN) const;
+
+    /**
+     * Returns the recorded zones as a Chrome trace.
+     *
+     * The trace uses the JSON object format of the Chrome trace event
+     * profiler, and can be opened with chrome://tracing or Perfetto. Each
+     * track is a separate thread of process 0.
+     *
+     * @return the recorded zones as a Chrome trace.
+     */
+    std::shared_ptr<JsonValue> getChromeTrace() const;
+
+    /**
+     * Writes the recorded zones to the given file as a Chrome trace.
+     *
+     * The file uses the JSON object format of the Chrome trace event
+     * profiler, and can be opened with chrome://tracing or Perfetto.
+     *
+     * @param path  The path of the file to write
+     *
+     * @return true if the file was successfully written
+     */
+    bool writeChromeTrace(const std::string& path) const;
+
+    /**
+     * Draws the recent frames as an overlay with the given sprite batch.
+     *
+     * Each frame is drawn as a vertical bar, with the most recent frame on
+     * the right. The bar is the frame time, divided into the zones at depth
+     * 1 (such as update and render). A thinner bar to its right is the GPU
+     * time of the frame. The horizontal lines mark 1/60 and 1/30 seconds.
+     *
+     * The overlay is drawn in the coordinate space of the current sprite
+     * batch perspective. The sprite batch must be active. This method
+     * changes the texture, color, and blend state of the sprite batch.
+     *
+     * @param batch     The sprite batch to draw with
+     * @param bounds    The bounding box of the overlay
+     * @param frames    The number of frames to draw
+     */
+    void draw(const std::shared_ptr<SpriteBatch>& batch, const Rect& bounds, Uint32 frames=120) const;
+
+#pragma mark -
+#pragma mark Internal Helpers
+private:
+    /**
+     * Collects the results of any finished GPU timer queries.
+     *
+     * The queries are collected in order, so this stops at the first query
+     * that is not yet available. If the GPU reports a disjoint event, the
+     * collected results are discarded.
+     */
+    void collectQueries();
+};
+
+#pragma mark -
+/**
+ * This class is a scoped zone on the main track of the profiler.
+ *
+ * This class opens a zone when it is created and closes it when it goes
+ * out of scope. It does nothing if the profiler is not running. It is
+ * best used via the macro {@link CUProfileZone}.
+ */
+class ProfileZone {
+private:
+    /** The profiler recording this zone (or nullptr) */
+    Profiler* _profiler;
+
+public:
+    /**
+     * Opens a zone with the given name
+     *
+     * @param name  The name of the zone
+     */
+    ProfileZone(const char* name) : _profiler(Profiler::get()) {
+        if (_profiler) { _profiler->beginZone(name); }
+    }
+
+    /**
+     * Closes this zone
+     *
+     * Nothing happens if the profiler was stopped inside of the zone.
+     */
+    ~ProfileZone() {
+        if (_profiler && _profiler == Profiler::get()) { _profiler->endZone(); }
+    }
+};
+
+/**
+ * This class is a scoped zone on the GPU track of the profiler.
+ *
+ * This class opens a GPU zone when it is created and closes it when it
+ * goes out of scope. It does nothing if the profiler is not running. It is
+ * best used via the macro {@link CUProfileGPUZone}.
+ */
+class ProfileGPUZone {
+private:
+    /** The profiler recording this zone (or nullptr) */
+    Profiler* _profiler;
+
+public:
+    /**
+     * Opens a GPU zone with the given name
+     *
+     * @param name  The name of the zone
+     */
+    ProfileGPUZone(const char* name) : _profiler(Profiler::get()) {
+        if (_profiler) { _profiler->beginGPUZone(name); }
+    }
+
+    /**
+     * Closes this GPU zone
+     *
+     * Nothing happens if the profiler was stopped inside of the zone.
+     */
+    ~ProfileGPUZone() {
+        if (_profiler && _profiler == Profiler::get()) { _profiler->endGPUZone(); }
+    }
+};
+
+}
+
+/** Joins two tokens (after expanding them) */
+#define CU_PROFILE_JOIN(a,b)        CU_PROFILE_JOIN_AUX(a,b)
+/** Joins two tokens (without expanding them) */
+#define CU_PROFILE_JOIN_AUX(a,b)    a##b
+
+/**
+ * @def CUProfileZone(name)
+ *
+ * Records a CPU zone until the end of the current scope.
+ *
+ * The name must be a string literal. This macro does nothing if the
+ * profiler is not running.
+ *
+ * @param name  The name of the zone
+ */
+#define CUProfileZone(name)     cugl::ProfileZone CU_PROFILE_JOIN(_cu_zone,__LINE__)(name)
+
+/**
+ * @def CUProfileGPUZone(name)
+ *
+ * Records a GPU zone until the end of the current scope.
+ *
+ * The name must be a string literal. This macro does nothing if the
+ * profiler is not running.
+ *
+ * @param name  The name of the zone
+ */
+#define CUProfileGPUZone(name)  cugl::ProfileGPUZone CU_PROFILE_JOIN(_cu_gpuzone,__LINE__)(name)
+
+#endif /* __CU_PROFILER_H__ */
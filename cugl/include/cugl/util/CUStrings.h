@@ -11,6 +11,13 @@
 //  long, etc.  Those types are NOT cross-platform.  For example, a long is
 //  8 bytes on Unix/OS X, but 4 bytes on some Win32 platforms.
 //
+//  The query and number parsing functions take string views, so they can be
+//  applied to substrings and C-strings without allocating.  Number parsing is
+//  built on std::from_chars (or on strtod_l with the "C" locale, where the
+//  standard library has no floating point from_chars).  It never throws and
+//  ignores the user locale.  If a string is not a number, or the number is
+//  out of range, the result is 0 and the number of characters processed is 0.
+//
 //  CUGL MIT License:
 //      This software is provided 'as-is', without any express or implied
 //      warranty.  In no event will the authors be held liable for any damages
@@ -38,6 +45,7 @@
 #include <SDL/SDL.h>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <locale>
 #include <initializer_list>
 #include <algorithm>
@@ -299,7 +307,7 @@ namespace cugl {
      *
      * @return the byte equivalent to the given string
      */
-    Uint8 stou8(const std::string str, std::size_t* pos = 0, int base = 10);
+    Uint8 stou8(std::string_view str, std::size_t* pos = 0, int base = 10);
     
     /**
      * Returns the signed 16 bit integer equivalent to the given string
@@ -315,7 +323,7 @@ namespace cugl {
      *
      * @return the signed 16 bit integer equivalent to the given string
      */
-    Sint16 stos16(const std::string str, std::size_t* pos = 0, int base = 10);
+    Sint16 stos16(std::string_view str, std::size_t* pos = 0, int base = 10);
     
     /**
      * Returns the unsigned 16 bit integer equivalent to the given string
@@ -331,7 +339,7 @@ namespace cugl {
      *
      * @return the unsigned 16 bit integer equivalent to the given string
      */
-    Uint16 stou16(const std::string str, std::size_t* pos = 0, int base = 10);
+    Uint16 stou16(std::string_view str, std::size_t* pos = 0, int base = 10);
     
     /**
      * Returns the signed 32 bit integer equivalent to the given string
@@ -347,7 +355,7 @@ namespace cugl {
      *
      * @return the signed 32 bit integer equivalent to the given string
      */
-    Sint32 stos32(const std::string str, std::size_t* pos = 0, int base = 10);
+    Sint32 stos32(std::string_view str, std::size_t* pos = 0, int base = 10);
     
     /**
      * Returns the unsigned 32 bit integer equivalent to the given string
@@ -363,7 +371,7 @@ namespace cugl {
      *
      * @return the unsigned 32 bit integer equivalent to the given string
      */
-    Uint32 stou32(const std::string str, std::size_t* pos = 0, int base = 10);
+    Uint32 stou32(std::string_view str, std::size_t* pos = 0, int base = 10);
     
     /**
      * Returns the signed 64 bit integer equivalent to the given string
@@ -379,7 +387,7 @@ namespace cugl {
      *
      * @return the signed 64 bit integer equivalent to the given string
      */
-    Sint64 stos64(const std::string str, std::size_t* pos = 0, int base = 10);
+    Sint64 stos64(std::string_view str, std::size_t* pos = 0, int base = 10);
     
     /**
      * Returns the unsigned 64 bit integer equivalent to the given string
@@ -395,7 +403,7 @@ namespace cugl {
      *
      * @return the unsigned 64 bit integer equivalent to the given string
      */
-    Uint64 stou64(const std::string str, std::size_t* pos = 0, int base = 10);
+    Uint64 stou64(std::string_view str, std::size_t* pos = 0, int base = 10);
     
     /**
      * Returns the float equivalent to the given string
@@ -410,7 +418,7 @@ namespace cugl {
      *
      * @return the float equivalent to the given string
      */
-    float stof(const std::string str, std::size_t* pos = 0);
+    float stof(std::string_view str, std::size_t* pos = 0);
     
     /**
      * Returns the double equivalent to the given string
@@ -425,7 +433,7 @@ namespace cugl {
      *
      * @return the double equivalent to the given string
      */
-    double stod(const std::string str, std::size_t* pos = 0);
+    double stod(std::string_view str, std::size_t* pos = 0);
 
     
 #pragma mark -
@@ -439,7 +447,7 @@ namespace cugl {
      *
      * @return true if the string only contains alphabetic characters.
      */
-    bool isalpha(const std::string str);
+    bool isalpha(std::string_view str);
 
     /**
      * Returns true if the string only contains alphabetic and numeric characters.
@@ -450,7 +458,7 @@ namespace cugl {
      *
      * @return true if the string only contains alphabetic and numeric characters.
      */
-    bool isalphanum(const std::string str);
+    bool isalphanum(std::string_view str);
 
     /**
      * Returns true if the string only contains numeric characters.
@@ -461,7 +469,7 @@ namespace cugl {
      *
      * @return true if the string only contains numeric characters.
      */
-    bool isnumeric(const std::string str);
+    bool isnumeric(std::string_view str);
 
     /**
      * Returns true if the string can safely be converted to a number (double)
@@ -472,7 +480,7 @@ namespace cugl {
      *
      * @return true if the string can safely be converted to a number (double)
      */
-    bool isnumber(const std::string str);
+    bool isnumber(std::string_view str);
 
     /**
      * Returns the number of times substring a appears in str.
@@ -484,7 +492,7 @@ namespace cugl {
      *
      * @return the number of times substring a appears in str.
      */
-    int count(const std::string str, const std::string a);
+    int count(std::string_view str, std::string_view a);
 
     /**
      * Returns true if str starts with the substring a.
@@ -494,7 +502,7 @@ namespace cugl {
      *
      * @return true if str starts with the substring a.
      */
-    bool starts_with(const std::string str, const std::string a);
+    bool starts_with(std::string_view str, std::string_view a);
     
     /**
      * Returns true if str ends with the substring a.
@@ -504,7 +512,7 @@ namespace cugl {
      *
      * @return true if str ends with the substring a.
      */
-    bool ends_with(const std::string str, const std::string a);
+    bool ends_with(std::string_view str, std::string_view a);
     
     /**
      * Returns true if the string is lower case
@@ -519,7 +527,7 @@ namespace cugl {
      *
      * @return true if the string is lower case
      */
-    bool islower(const std::string str);
+    bool islower(std::string_view str);
 
     /**
      * Returns true if the string is upper case
@@ -534,7 +542,7 @@ namespace cugl {
      *
      * @return true if the string is upper case
      */
-    bool isupper(const std::string str);
+    bool isupper(std::string_view str);
     
     
 #pragma mark -
@@ -565,6 +573,41 @@ namespace cugl {
      * @return a list of substrings separate by the line separator
      */
     std::vector<std::string> splitlines(const std::string str);
+
+    /**
+     * Stores the substrings of str separated by the given separator in result
+     *
+     * This is the allocation-free version of {@link split}.  The contents of
+     * result are replaced (but its capacity is kept), so the same vector can
+     * be reused across calls.  The views refer to the characters of str, so
+     * they are only valid as long as str is.
+     *
+     * The separator is interpretted exactly; no whitespace is removed around
+     * the separator.  If the separator is the empty string, this function
+     * will store the individual characters in str.
+     *
+     * @param str       The string to split
+     * @param sep       The splitting delimeter
+     * @param result    The vector to store the substrings
+     *
+     * @return the number of substrings found
+     */
+    size_t split(std::string_view str, std::string_view sep, std::vector<std::string_view>& result);
+
+    /**
+     * Stores the substrings of str separated by the line separator in result
+     *
+     * This is the allocation-free version of {@link splitlines}.  The contents
+     * of result are replaced (but its capacity is kept), so the same vector can
+     * be reused across calls.  The views refer to the characters of str, so
+     * they are only valid as long as str is.
+     *
+     * @param str       The string to split
+     * @param result    The vector to store the substrings
+     *
+     * @return the number of substrings found
+     */
+    size_t splitlines(std::string_view str, std::vector<std::string_view>& result);
     
     /**
      * Returns a string that is the concatenation of elts.
@@ -670,6 +713,17 @@ namespace cugl {
      * @return a lower case copy of str.
      */
     std::string tolower(std::string str);
+
+    /**
+     * Stores a lower case copy of str in result.
+     *
+     * This version reuses the buffer of result, so it does not allocate once
+     * result is large enough.  This function uses the current C++ locale.
+     *
+     * @param str       The string to convert
+     * @param result    The string to store the lower case copy
+     */
+    void tolower(std::string_view str, std::string& result);
     
     /**
      * Returns an upper case copy of str.
@@ -192,6 +192,30 @@ public:
      */
     void addTask(const std::function<void()> &task);
     
+    /**
+     * Splits the range [0,size) across the worker threads and waits for it.
+     *
+     * The range is divided into one contiguous chunk per worker, plus one
+     * for the calling thread. The task is called once per chunk with the
+     * start and end (exclusive) of that chunk. This method blocks until all
+     * chunks have been processed. If the pool is stopped, or the range is
+     * too small to split, the task is run entirely on the calling thread.
+     *
+     * This method must never be called from a task in this same pool, as
+     * the workers may all be blocked waiting on each other.
+     *
+     * @param size  The size of the range to split
+     * @param task  The task to perform on each chunk
+     */
+    void parallelFor(size_t size, const std::function<void(size_t, size_t)>& task);
+    
+    /**
+     * Returns the number of worker threads in this pool.
+     *
+     * @return the number of worker threads in this pool.
+     */
+    int getThreadCount() const { return (int)_workers.size(); }
+    
     /**
      * Stop the thread pool, marking it for shut down.
      *
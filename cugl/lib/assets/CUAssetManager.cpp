@@ -46,9 +46,42 @@
 //  Version: 5/20/19
 //
 #include <cugl/cugl.h>
+#if defined (__LINUX__) && !defined (__ANDROID__)
+    #include <sys/inotify.h>
+    #include <unistd.h>
+    /** Whether to use inotify (instead of polling) for hot reloading */
+    #define CU_INOTIFY 1
+#endif
 
 using namespace cugl;
 
+/** How often (in milliseconds) to poll file timestamps for hot reloading */
+#define WATCH_POLL_INTERVAL 250
+
+/**
+ * A single asset file watched for hot reloading.
+ */
+struct AssetManager::WatchEntry {
+    /** The hash of the asset type */
+    size_t hash;
+    /** The directory entry for the asset */
+    std::shared_ptr<JsonValue> json;
+    /** The absolute path of the source file */
+    std::string path;
+    /** The parent directory of the source file */
+    std::string dir;
+    /** The leaf name of the source file */
+    std::string base;
+    /** The last known timestamp of the source file */
+    Uint64 stamp;
+    /** Whether the source file has changed since the last update */
+    bool changed;
+    /** Whether a reload is currently in progress */
+    bool busy;
+    /** Whether the source file changed again during a reload */
+    bool dirty;
+};
+
 #pragma mark -
 #pragma mark Constructors
 /**
@@ -76,6 +109,7 @@ bool AssetManager::init() {
  * threads) and reattach all loaders to use the asset manager again.
  */
 void AssetManager::dispose() {
+    unwatchAll();
     detachAll();
     _workers = nullptr;
 }
@@ -548,3 +582,268 @@ size_t AssetManager::waitCount() const {
     }
     return _preload ? result+1 : result;
 }
+
+
+#pragma mark -
+#pragma mark Hot Reloading
+/**
+ * Records the watched asset files for the given category.
+ *
+ * Only assets with a source file (as reported by {@link BaseLoader#getSource})
+ * are watched.
+ *
+ * @param hash  The hash of the asset type
+ * @param json  The child of asset directory with these assets
+ */
+void AssetManager::watchCategory(size_t hash, const std::shared_ptr<JsonValue>& json) {
+    auto it = _handlers.find(hash);
+    if (it == _handlers.end() || it->second == nullptr) {
+        return;
+    }
+    
+    std::shared_ptr<BaseLoader> loader = it->second;
+    std::string root = Application::get()->getAssetDirectory();
+    for(int ii = 0; ii < json->size(); ii++) {
+        std::shared_ptr<JsonValue> child = json->get(ii);
+        std::string source = loader->getSource(child);
+        if (source.empty()) {
+            continue;
+        }
+        
+        std::shared_ptr<WatchEntry> entry = std::make_shared<WatchEntry>();
+        entry->hash  = hash;
+        entry->json  = child;
+        entry->path  = filetool::normalize_path(filetool::is_absolute(source) ? source : root+source);
+        filetool::split_path(entry->path,entry->dir,entry->base);
+        entry->stamp = filetool::file_timestamp(entry->path);
+        entry->changed = false;
+        entry->busy  = false;
+        entry->dirty = false;
+        _watched.push_back(entry);
+        
+#if defined (CU_INOTIFY)
+        if (_notify >= 0) {
+            bool found = false;
+            for(auto jt = _notifyDirs.begin(); !found && jt != _notifyDirs.end(); ++jt) {
+                found = jt->second == entry->dir;
+            }
+            if (!found) {
+                int wd = inotify_add_watch(_notify, entry->dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+                if (wd < 0) {
+                    CULogError("Could not watch directory '%s'",entry->dir.c_str());
+                } else {
+                    _notifyDirs[wd] = entry->dir;
+                }
+            }
+        }
+#endif
+    }
+}
+
+/**
+ * Starts a hot reload of the given watched asset.
+ *
+ * If the asset is still reloading from an earlier change, the reload is
+ * deferred until the current one completes.
+ *
+ * @param entry The watched asset file
+ */
+void AssetManager::reload(const std::shared_ptr<WatchEntry>& entry) {
+    if (entry->busy) {
+        entry->dirty = true;
+        return;
+    }
+    
+    auto it = _handlers.find(entry->hash);
+    if (it == _handlers.end() || it->second == nullptr) {
+        return;
+    }
+    
+    entry->busy  = true;
+    entry->dirty = false;
+    bool started = it->second->reload(entry->json,[=](const std::string& key, bool success) {
+        entry->busy = false;
+        if (success) {
+            CULog("Reloaded asset '%s'",key.c_str());
+        } else {
+            CULogError("Could not reload asset '%s'",key.c_str());
+        }
+        if (this->_reloadCallback != nullptr) {
+            this->_reloadCallback(key,success);
+        }
+        if (entry->dirty) {
+            this->reload(entry);
+        }
+    });
+    if (!started) {
+        entry->busy = false;
+    }
+}
+
+/**
+ * Watches all assets in the given directory for changes.
+ *
+ * Hot reloading is intended for desktop builds during content creation.
+ * The source file of every texture, font, and JSON asset in the directory
+ * is watched (via inotify on Linux and by polling the file timestamps
+ * elsewhere). When a file changes, the asset is decoded again on the
+ * loader thread and swapped into the existing asset in place. Every
+ * smart pointer to the asset sees the new data, so live scene graphs pick
+ * up the change without being rebuilt. Sounds and scene graphs are not
+ * reloaded.
+ *
+ * The assets in the directory must already be loaded. Changes are only
+ * detected by {@link update}, which must be called every animation frame.
+ *
+ * The optional callback function will be called each time an individual
+ * asset is reloaded or fails to reload.
+ *
+ * @param json      The JSON asset directory
+ * @param callback  An optional callback after each asset is reloaded
+ *
+ * @return true if hot reloading is supported on this platform
+ */
+bool AssetManager::watchDirectory(const std::shared_ptr<JsonValue>& json, LoaderCallback callback) {
+#if defined (CU_MOBILE)
+    return false;
+#else
+    _reloadCallback = callback;
+#if defined (CU_INOTIFY)
+    if (_notify < 0) {
+        _notify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (_notify < 0) {
+            CULogError("Could not start inotify; polling for asset changes instead");
+        }
+    }
+#endif
+    
+    for(int ii = 0; ii < json->size(); ii++) {
+        std::shared_ptr<JsonValue> child = json->get(ii);
+        if (child->key() == "textures") {
+            watchCategory(typeid(Texture).hash_code(),child);
+        } else if (child->key() == "sounds") {
+            watchCategory(typeid(Sound).hash_code(),child);
+        } else if (child->key() == "fonts") {
+            watchCategory(typeid(Font).hash_code(),child);
+        } else if (child->key() == "jsons") {
+            watchCategory(typeid(JsonValue).hash_code(), child);
+        } else if (child->key() == "widgets") {
+            watchCategory(typeid(WidgetValue).hash_code(), child);
+        } else if (child->key() == "scene2s") {
+            watchCategory(typeid(scene2::SceneNode).hash_code(),child);
+        }
+    }
+    _lastPoll = SDL_GetTicks();
+    return true;
+#endif
+}
+
+/**
+ * Watches all assets in the given directory for changes.
+ *
+ * Hot reloading is intended for desktop builds during content creation.
+ * The source file of every texture, font, and JSON asset in the directory
+ * is watched (via inotify on Linux and by polling the file timestamps
+ * elsewhere). When a file changes, the asset is decoded again on the
+ * loader thread and swapped into the existing asset in place. Every
+ * smart pointer to the asset sees the new data, so live scene graphs pick
+ * up the change without being rebuilt. Sounds and scene graphs are not
+ * reloaded.
+ *
+ * The assets in the directory must already be loaded. Changes are only
+ * detected by {@link update}, which must be called every animation frame.
+ *
+ * The optional callback function will be called each time an individual
+ * asset is reloaded or fails to reload.
+ *
+ * @param directory The path to the JSON asset directory
+ * @param callback  An optional callback after each asset is reloaded
+ *
+ * @return true if hot reloading is supported on this platform
+ */
+bool AssetManager::watchDirectory(const std::string& directory, LoaderCallback callback) {
+    std::shared_ptr<JsonReader> reader = JsonReader::allocWithAsset(directory);
+    if (reader == nullptr) {
+        CULogError("No asset directory located at '%s'",directory.c_str());
+        return false;
+    }
+    
+    std::shared_ptr<JsonValue> json = reader->readJson();
+    return json != nullptr && watchDirectory(json,callback);
+}
+
+/**
+ * Stops watching all asset files for changes.
+ *
+ * Any reloads already in progress will still complete.
+ */
+void AssetManager::unwatchAll() {
+    _watched.clear();
+    _reloadCallback = nullptr;
+#if defined (CU_INOTIFY)
+    if (_notify >= 0) {
+        close(_notify);
+        _notify = -1;
+    }
+#endif
+    _notifyDirs.clear();
+}
+
+/**
+ * Checks the watched asset files and reloads any that have changed.
+ *
+ * This method must be called from the main thread, typically once every
+ * animation frame. It does nothing if no assets are watched.
+ */
+void AssetManager::update() {
+    if (_watched.empty()) {
+        return;
+    }
+    
+#if defined (CU_INOTIFY)
+    if (_notify >= 0) {
+        alignas(struct inotify_event) char buffer[4096];
+        ssize_t length;
+        while ((length = read(_notify, buffer, sizeof(buffer))) > 0) {
+            const struct inotify_event* event;
+            for(char* ptr = buffer; ptr < buffer+length; ptr += sizeof(struct inotify_event)+event->len) {
+                event = (const struct inotify_event*)ptr;
+                auto jt = _notifyDirs.find(event->wd);
+                if (event->len == 0 || jt == _notifyDirs.end()) {
+                    continue;
+                }
+                for(auto it = _watched.begin(); it != _watched.end(); ++it) {
+                    if ((*it)->dir == jt->second && (*it)->base == event->name) {
+                        (*it)->changed = true;
+                    }
+                }
+            }
+        }
+    } else
+#endif
+    {
+        // File timestamps are coarse, so there is no point checking every frame
+        Uint32 now = SDL_GetTicks();
+        if (now-_lastPoll < WATCH_POLL_INTERVAL) {
+            return;
+        }
+        _lastPoll = now;
+        for(auto it = _watched.begin(); it != _watched.end(); ++it) {
+            Uint64 stamp = filetool::file_timestamp((*it)->path);
+            if (stamp != (*it)->stamp) {
+                (*it)->stamp = stamp;
+                // A zero stamp means the file is missing (probably mid-save)
+                (*it)->changed = (stamp != 0);
+            }
+        }
+    }
+    
+    // The callbacks may modify _watched, so work on a copy
+    std::vector<std::shared_ptr<WatchEntry>> watched = _watched;
+    for(auto it = watched.begin(); it != watched.end(); ++it) {
+        if ((*it)->changed) {
+            (*it)->changed = false;
+            reload(*it);
+        }
+    }
+}
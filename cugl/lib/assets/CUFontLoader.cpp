@@ -81,13 +81,19 @@ _charset(UNKNOWN_CHARS) {
  * Hence this method does the maximum amount of work that can be done in
  * asynchronous font loading.
  *
+ * If the spread is positive, the atlas is a signed distance field with
+ * that spread (see {@link Font#setDistanceSpread}). The distance field
+ * is computed here, and so it is also off the main thread.
+ *
  * @param source    The pathname to the asset
  * @param charset   The atlas character set
  * @param charset   The font size
+ * @param spread    The distance field spread (0 for none)
  *
  * @return the font asset with no generated atlas
  */
-std::shared_ptr<Font> FontLoader::preload(const std::string& source, const std::string& charset, int size) {
+std::shared_ptr<Font> FontLoader::preload(const std::string& source, const std::string& charset, int size,
+                                          int spread) {
     // Make sure we reference the asset directory
 #if defined (__WINDOWS__)
     bool absolute = (bool)strstr(source.c_str(),":") || source[0] == '\\';
@@ -103,6 +109,9 @@ std::shared_ptr<Font> FontLoader::preload(const std::string& source, const std::
         return result;
     }
     
+    // Glyphs outside of the atlas are rasterized on the loader thread
+    result->setThreadPool(_loader);
+    result->setDistanceSpread(spread);
     if (charset.empty()) {
         result->buildAtlasAsync();
     } else {
@@ -144,6 +153,32 @@ void FontLoader::materialize(const std::string& key, const std::shared_ptr<Font>
     _queue.erase(key);
 }
 
+/**
+ * Swaps a reloaded font into the existing font asset with the given key.
+ *
+ * This method finishes the hot reload started in {@link reload}.  As
+ * atlas generation requires OpenGL, this step is not safe to be done in a
+ * separate thread.  Instead, it takes place in the main CUGL thread via
+ * {@link Application#schedule}.
+ *
+ * @param key       The key of the font asset
+ * @param font      The reloaded font (may be null)
+ * @param callback  An optional callback for the reload
+ */
+void FontLoader::replace(const std::string& key, const std::shared_ptr<Font>& font, LoaderCallback callback) {
+    auto it = _assets.find(key);
+    
+    bool success = false;
+    if (font != nullptr && it != _assets.end()) {
+        it->second->reload(*font);
+        success = true;
+    }
+    
+    if (callback != nullptr) {
+        callback(key,success);
+    }
+}
+
 /**
  * Internal method to support asset loading.
  *
@@ -209,6 +244,7 @@ bool FontLoader::read(const std::string& key, const std::string& source, int siz
  *      "file":         The path to the asset
  *      "size":         This font size (int)
  *      "charset":      The set of characters for the font atlas (string)
+ *      "spread":       The distance field spread in pixels (int, default 0)
  *
  * @param json      The directory entry for the asset
  * @param callback  An optional callback for asynchronous loading
@@ -226,10 +262,11 @@ bool FontLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback cal
     std::string source  = json->getString("file",UNKNOWN_SOURCE);
     std::string charset = json->getString("charset",UNKNOWN_CHARS);
     int size = json->getInt("size",UNKNOWN_SIZE);
+    int spread = json->getInt("spread",0);
     
     bool success = false;
     if (_loader == nullptr || !async) {
-        std::shared_ptr<Font> font = preload(source,charset,size);
+        std::shared_ptr<Font> font = preload(source,charset,size,spread);
         if (font != nullptr) {
             success = true;
             materialize(key,font,callback);
@@ -238,7 +275,7 @@ bool FontLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback cal
         }
     } else {
         _loader->addTask([=](void) {
-            std::shared_ptr<Font> font = this->preload(source,charset,size);
+            std::shared_ptr<Font> font = this->preload(source,charset,size,spread);
             Application::get()->schedule([=](void){
                 this->materialize(key,font,callback);
                 return false;
@@ -248,3 +285,57 @@ bool FontLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback cal
     
     return success;
 }
+
+
+#pragma mark -
+#pragma mark Hot Reloading
+/**
+ * Returns the source file for the given directory entry.
+ *
+ * The path is relative to the asset directory. The asset manager watches
+ * this file for changes when hot reloading.
+ *
+ * @param json      The directory entry for the asset
+ *
+ * @return the source file for the given directory entry.
+ */
+std::string FontLoader::getSource(const std::shared_ptr<JsonValue>& json) const {
+    return json->getString("file","");
+}
+
+/**
+ * Reloads the font for the given directory entry in place.
+ *
+ * The font file and its atlas are regenerated on the loader thread (or
+ * immediately if there is no thread). The result is then swapped into the
+ * existing font on the main thread, so every smart pointer to the font
+ * sees the new glyphs. The font must already be loaded.
+ *
+ * @param json      The directory entry for the asset
+ * @param callback  An optional callback for the reload
+ *
+ * @return true if the reload was started
+ */
+bool FontLoader::reload(const std::shared_ptr<JsonValue>& json, LoaderCallback callback) {
+    std::string key = json->key();
+    if (_assets.find(key) == _assets.end()) {
+        return false;
+    }
+    
+    std::string source  = json->getString("file",UNKNOWN_SOURCE);
+    std::string charset = json->getString("charset",UNKNOWN_CHARS);
+    int size = json->getInt("size",UNKNOWN_SIZE);
+    int spread = json->getInt("spread",0);
+    if (_loader == nullptr) {
+        replace(key,preload(source,charset,size,spread),callback);
+    } else {
+        _loader->addTask([=](void) {
+            std::shared_ptr<Font> font = this->preload(source,charset,size,spread);
+            Application::get()->schedule([=](void){
+                this->replace(key,font,callback);
+                return false;
+            });
+        });
+    }
+    return true;
+}
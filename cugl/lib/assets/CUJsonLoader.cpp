@@ -78,6 +78,32 @@ void JsonLoader::materialize(const std::string& key, const std::shared_ptr<JsonV
     _queue.erase(key);
 }
 
+/**
+ * Swaps a reloaded Json tree into the existing asset with the given key.
+ *
+ * This method finishes the hot reload started in {@link reload}. The
+ * existing root node is kept, so every smart pointer to it sees the new
+ * contents. Smart pointers to the old children are not updated.
+ *
+ * @param key       The key of the Json asset
+ * @param json      The reloaded Json tree (may be null)
+ * @param callback  An optional callback for the reload
+ */
+void JsonLoader::replace(const std::string& key, const std::shared_ptr<JsonValue>& json,
+                         LoaderCallback callback) {
+    auto it = _assets.find(key);
+    
+    bool success = false;
+    if (json != nullptr && it != _assets.end()) {
+        it->second->swap(*json);
+        success = true;
+    }
+    
+    if (callback != nullptr) {
+        callback(key,success);
+    }
+}
+
 /**
  * Internal method to support asset loading.
  *
@@ -173,3 +199,54 @@ bool JsonLoader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback cal
     return success;
 }
 
+
+#pragma mark -
+#pragma mark Hot Reloading
+/**
+ * Returns the source file for the given directory entry.
+ *
+ * The path is relative to the asset directory. The asset manager watches
+ * this file for changes when hot reloading.
+ *
+ * @param json      The directory entry for the asset
+ *
+ * @return the source file for the given directory entry.
+ */
+std::string JsonLoader::getSource(const std::shared_ptr<JsonValue>& json) const {
+    return json->asString("");
+}
+
+/**
+ * Reloads the Json asset for the given directory entry in place.
+ *
+ * The file is parsed again on the loader thread (or immediately if there
+ * is no thread). The result is then swapped into the existing root node
+ * on the main thread. The asset must already be loaded.
+ *
+ * @param json      The directory entry for the asset
+ * @param callback  An optional callback for the reload
+ *
+ * @return true if the reload was started
+ */
+bool JsonLoader::reload(const std::shared_ptr<JsonValue>& json, LoaderCallback callback) {
+    std::string key = json->key();
+    if (_assets.find(key) == _assets.end()) {
+        return false;
+    }
+    
+    std::string source = json->asString(UNKNOWN_SOURCE);
+    if (_loader == nullptr) {
+        std::shared_ptr<JsonReader> reader = JsonReader::allocWithAsset(source);
+        replace(key,(reader == nullptr ? nullptr : reader->readJson()),callback);
+    } else {
+        _loader->addTask([=](void) {
+            std::shared_ptr<JsonReader> reader = JsonReader::allocWithAsset(source);
+            std::shared_ptr<JsonValue> value = (reader == nullptr ? nullptr : reader->readJson());
+            Application::get()->schedule([=](void) {
+                this->replace(key,value,callback);
+                return false;
+            });
+        });
+    }
+    return true;
+}
@@ -780,6 +780,30 @@ void JsonValue::setNull() {
     _type = Type::NullType;
 }
 
+/**
+ * Swaps the contents of this node with those of the given node.
+ *
+ * The type, value and children of the two nodes are exchanged. The key
+ * and parent of each node are unchanged. Unlike {@link #merge}, this
+ * node may be a root. This allows a JSON asset to be reloaded in place,
+ * so that any smart pointer to it sees the new contents.
+ *
+ * @param node  The node to swap with
+ */
+void JsonValue::swap(JsonValue& node) {
+    std::swap(_type,node._type);
+    std::swap(_stringValue,node._stringValue);
+    std::swap(_longValue,node._longValue);
+    std::swap(_doubleValue,node._doubleValue);
+    std::swap(_children,node._children);
+    for(auto it = _children.begin(); it != _children.end(); ++it) {
+        (*it)->_parent = this;
+    }
+    for(auto it = node._children.begin(); it != node._children.end(); ++it) {
+        (*it)->_parent = &node;
+    }
+}
+
 
 #pragma mark -
 #pragma mark Child Access
@@ -53,15 +53,78 @@
 #include <cugl/assets/CUWidgetValue.h>
 #include <cugl/base/CUApplication.h>
 #include <cugl/io/CUJsonReader.h>
+#include <cugl/render/CUTexture.h>
 #include <cugl/util/CUStrings.h>
 #include <cugl/scene2/cu_scene2.h>
 #include <locale>
 #include <algorithm>
+#include <atomic>
 
 using namespace cugl;
 
 /** If the type is unknown */
 #define UNKNOWN_STR  "<unknown>"
+/** The maximum number of builder threads */
+#define MAX_BUILDERS 4
+
+#pragma mark -
+#pragma mark Build Jobs
+/**
+ * A scene under asynchronous construction.
+ *
+ * This object is shared by all of the builder tasks for a single scene.
+ * Each task writes to its own slot, so only the counter is synchronized.
+ */
+struct Scene2Loader::BuildJob {
+    /** The scene key */
+    std::string key;
+    /** The callback to invoke once the scene is materialized */
+    LoaderCallback callback;
+    /** The root node of the scene */
+    std::shared_ptr<scene2::SceneNode> root;
+    /** Whether the children of the root ignore relative color */
+    bool nonrelative;
+    /** The keys of the top-level children */
+    std::vector<std::string> keys;
+    /** The JSON of the top-level children */
+    std::vector<std::shared_ptr<JsonValue>> items;
+    /** The built top-level subtrees (one slot per child) */
+    std::vector<std::shared_ptr<scene2::SceneNode>> kids;
+    /** The number of builder tasks still running for the current phase */
+    std::atomic<size_t> pending;
+    /** The time stamp at the start of the current phase */
+    Timestamp phase;
+    /** The accumulated scene timing */
+    Timing timing;
+
+    /** Creates an empty build job */
+    BuildJob() : nonrelative(false), pending(0), timing{0,0,0,0,0} {}
+};
+
+/**
+ * Generates the render geometry for every textured node in the subtree.
+ *
+ * The render data of a textured node only depends on its polygon, texture
+ * coordinates and content size. None of this touches OpenGL, so this may
+ * be done off the main thread, provided that the layout is final.
+ *
+ * @param node      The subtree root
+ * @param recursive Whether to process the descendants of node
+ */
+static void prepare_geometry(const std::shared_ptr<scene2::SceneNode>& node, bool recursive) {
+    scene2::TexturedNode* textured = dynamic_cast<scene2::TexturedNode*>(node.get());
+    if (textured != nullptr) {
+        textured->refresh();
+    }
+    if (recursive) {
+        for(auto it = node->getChildren().begin(); it != node->getChildren().end(); ++it) {
+            prepare_geometry(*it, true);
+        }
+    }
+}
+
+#pragma mark -
+#pragma mark Initialization
 
 /**
  * Initializes a new asset loader.
@@ -95,6 +158,7 @@ bool Scene2Loader::init(const std::shared_ptr<ThreadPool>& threads) {
     _types["slider"] = Widget::SLIDER;
     _types["textfield"] = Widget::TEXTFIELD;
     _types["text field"] = Widget::TEXTFIELD;
+    _types["cached"] = Widget::CACHED;
 	_types["widget"] = Widget::EXTERNAL_IMPORT;
 
     // Define the supported layouts
@@ -138,13 +202,55 @@ bool Scene2Loader::init(const std::shared_ptr<ThreadPool>& threads) {
  */
 std::shared_ptr<scene2::SceneNode> Scene2Loader::build(const std::string& key,
                                                       const std::shared_ptr<JsonValue>& json) const {
+    if (json == nullptr) {
+        return nullptr;
+    }
+    
+    bool nonrelative = false;
+    std::shared_ptr<JsonValue> source = json;
+    std::shared_ptr<scene2::SceneNode> node = buildNode(key,source,nonrelative);
+    if (node == nullptr) {
+        return nullptr;
+    }
+    
+    std::shared_ptr<JsonValue> children = source->get("children");
+    if (children != nullptr) {
+        for (int ii = 0; ii < children->size(); ii++) {
+            std::shared_ptr<JsonValue> item = getChildJson(children,ii);
+            if (item != nullptr) {
+                std::string local = children->get(ii)->key();
+                addChild(node,local,item,build(local,item),nonrelative);
+            }
+        }
+    }
+    
+    // Do not perform layout yet.
+    return node;
+}
+
+/**
+ * Returns a single node (without children) for the given JSON object.
+ *
+ * This method builds the node and its layout manager, but it does not
+ * process the "children" attribute. If the JSON refers to an imported
+ * widget, the reference json is replaced by the widget JSON, so that the
+ * caller can access the correct children.
+ *
+ * @param key           The key to access the node after loading
+ * @param json          The JSON object defining the node
+ * @param nonrelative   Set to true if children should not use relative color
+ *
+ * @return a single node (without children) for the given JSON object.
+ */
+std::shared_ptr<scene2::SceneNode> Scene2Loader::buildNode(const std::string& key,
+                                                          std::shared_ptr<JsonValue>& json,
+                                                          bool& nonrelative) const {
     std::string type = json->getString("type",UNKNOWN_STR);
     auto it = _types.find(cugl::strtool::tolower(type));
     if (it == _types.end()) {
         return nullptr;
     }
     
-    bool nonrelative = false;
     std::shared_ptr<JsonValue> data = json->get("data");
     std::shared_ptr<scene2::SceneNode> node = nullptr;
     switch (it->second) {
@@ -174,8 +280,11 @@ std::shared_ptr<scene2::SceneNode> Scene2Loader::build(const std::string& key,
         node = scene2::NinePatch::allocWithData(this,data);
         break;
     case Widget::LABEL:
+    {
+        std::lock_guard<std::mutex> lock(_fontMutex);
         node = scene2::Label::allocWithData(this,data);
         break;
+    }
     case Widget::BUTTON:
         node = scene2::Button::allocWithData(this,data);
         break;
@@ -186,12 +295,18 @@ std::shared_ptr<scene2::SceneNode> Scene2Loader::build(const std::string& key,
         node = scene2::Slider::allocWithData(this,data);
         break;
     case Widget::TEXTFIELD:
+    {
+        std::lock_guard<std::mutex> lock(_fontMutex);
         node = scene2::TextField::allocWithData(this,data);
         break;
+    }
+    case Widget::CACHED:
+        node = scene2::CachedNode::allocWithData(this,data);
+        break;
 	case Widget::EXTERNAL_IMPORT: 
 	{
-		const std::shared_ptr<JsonValue> widgetJson = getWidgetJson(json);
-		return build(key, widgetJson);
+		json = getWidgetJson(json);
+		return buildNode(key, json, nonrelative);
 	}
     case Widget::UNKNOWN:
         break;
@@ -229,37 +344,60 @@ std::shared_ptr<scene2::SceneNode> Scene2Loader::build(const std::string& key,
         }
     }
     node->setLayout(layout);
-    
-    std::shared_ptr<JsonValue> children = json->get("children");
-	if (children != nullptr) {
-		for (int ii = 0; ii < children->size(); ii++) {
-			std::shared_ptr<JsonValue> item = children->get(ii);
-			std::string key = item->key();
-			if (key != "comment") {
-				// If this is a widget, use the loaded widget json instead
-				if (item->has("type") && item->getString("type") == "Widget") {
-					item = getWidgetJson(item);
-				}
-
-				std::shared_ptr<scene2::SceneNode> kid = build(key, item);
-                if (nonrelative) {
-                    kid->setRelativeColor(false);
-                }
-				node->addChild(kid);
-
-				if (layout != nullptr && item->has("layout")) {
-					std::shared_ptr<JsonValue> posit = item->get("layout");
-					layout->add(key, posit);
-				}
-			}
-		}
-	}
-    
-    // Do not perform layout yet.
     node->setName(key);
     return node;
 }
 
+/**
+ * Returns the JSON for the given child, or nullptr if it is a comment.
+ *
+ * If the child is a widget reference, this returns the widget JSON.
+ *
+ * @param children  The "children" attribute of a widget
+ * @param index     The child position
+ *
+ * @return the JSON for the given child, or nullptr if it is a comment.
+ */
+std::shared_ptr<JsonValue> Scene2Loader::getChildJson(const std::shared_ptr<JsonValue>& children, int index) const {
+    std::shared_ptr<JsonValue> item = children->get(index);
+    if (item->key() == "comment") {
+        return nullptr;
+    }
+    // If this is a widget, use the loaded widget json instead
+    if (item->has("type") && item->getString("type") == "Widget") {
+        item = getWidgetJson(item);
+    }
+    return item;
+}
+
+/**
+ * Adds a built child to the given node, registering it with the layout.
+ *
+ * @param node          The parent node
+ * @param key           The child key
+ * @param item          The JSON object defining the child
+ * @param kid           The child node
+ * @param nonrelative   Whether the child should not use relative color
+ */
+void Scene2Loader::addChild(const std::shared_ptr<scene2::SceneNode>& node, const std::string& key,
+                            const std::shared_ptr<JsonValue>& item,
+                            const std::shared_ptr<scene2::SceneNode>& kid, bool nonrelative) const {
+    if (kid == nullptr) {
+        CULogError("Could not build scene node %s",key.c_str());
+        return;
+    }
+    if (nonrelative) {
+        kid->setRelativeColor(false);
+    }
+    node->addChild(kid);
+    
+    const std::shared_ptr<scene2::Layout>& layout = node->getLayout();
+    if (layout != nullptr && item->has("layout")) {
+        std::shared_ptr<JsonValue> posit = item->get("layout");
+        layout->add(key, posit);
+    }
+}
+
 
 /**
  * Translates the JSON of a widget to the JSON of the node that it encodes.
@@ -389,26 +527,41 @@ bool Scene2Loader::read(const std::string& key, const std::string& source,
 
     bool success = false;
     if (_loader == nullptr || !async) {
+        Timing timing = {0,0,0,0,0};
+        Timestamp start;
         std::shared_ptr<JsonReader> reader = JsonReader::allocWithAsset(source);
         std::shared_ptr<JsonValue> json = (reader == nullptr ? nullptr : reader->readJson());
+        Timestamp parsed;
         std::shared_ptr<scene2::SceneNode> node = build(key,json);
-        node->doLayout();
+        Timestamp built;
         if (node != nullptr) {
+            node->doLayout();
+            Timestamp laid;
+            timing.parse  = Timestamp::ellapsedMicros(start,parsed);
+            timing.build  = Timestamp::ellapsedMicros(parsed,built);
+            timing.layout = Timestamp::ellapsedMicros(built,laid);
             success = true;
             materialize(node,callback);
+            timing.attach = Timestamp::ellapsedMicros(laid,Timestamp());
+            report(key,timing);
         } else {
             _queue.erase(key);
         }
     } else {
+        prepare();
+        std::shared_ptr<BuildJob> job = std::make_shared<BuildJob>();
+        job->key = key;
+        job->callback = callback;
+        {
+            std::lock_guard<std::mutex> lock(_buildMutex);
+            _building++;
+        }
         _loader->addTask([=](void) {
+            job->phase.mark();
             std::shared_ptr<JsonReader> reader = JsonReader::allocWithAsset(source);
             std::shared_ptr<JsonValue> json = (reader == nullptr ? nullptr : reader->readJson());
-            std::shared_ptr<scene2::SceneNode> node = build(key,json);
-            node->doLayout();
-            Application::get()->schedule([=](void) {
-                this->materialize(node,callback);
-                return false;
-            });
+            job->timing.parse = Timestamp::ellapsedMicros(job->phase,Timestamp());
+            buildAsync(job,json);
         });
     }
     
@@ -457,28 +610,221 @@ bool Scene2Loader::read(const std::shared_ptr<JsonValue>& json, LoaderCallback c
     
     bool success = false;
     if (_loader == nullptr || !async) {
+        Timing timing = {0,0,0,0,0};
+        Timestamp start;
         std::shared_ptr<scene2::SceneNode> node = build(key,json);
-        node->doLayout();
+        Timestamp built;
         if (node != nullptr) {
+            node->doLayout();
+            Timestamp laid;
+            timing.build  = Timestamp::ellapsedMicros(start,built);
+            timing.layout = Timestamp::ellapsedMicros(built,laid);
             success = true;
             materialize(node,callback);
+            timing.attach = Timestamp::ellapsedMicros(laid,Timestamp());
+            report(key,timing);
         } else {
             _queue.erase(key);
         }
     } else {
+        prepare();
+        std::shared_ptr<BuildJob> job = std::make_shared<BuildJob>();
+        job->key = key;
+        job->callback = callback;
+        {
+            std::lock_guard<std::mutex> lock(_buildMutex);
+            _building++;
+        }
         _loader->addTask([=](void) {
-            std::shared_ptr<scene2::SceneNode> node = build(key,json);
-            node->doLayout();
-            Application::get()->schedule([=](void) {
-                this->materialize(node,callback);
-                return false;
-            });
+            buildAsync(job,json);
         });
     }
     
     return success;
 }
 
+#pragma mark -
+#pragma mark Parallel Construction
+/**
+ * Prepares this loader for an asynchronous build.
+ *
+ * This method must be called on the main thread. It creates the builder
+ * threads if necessary. It also creates the blank texture, which nodes
+ * without a texture fall back to, as this is the only OpenGL object that
+ * scene construction may allocate on its own.
+ */
+void Scene2Loader::prepare() {
+    if (_builders == nullptr) {
+        int threads = SDL_GetCPUCount()-1;
+        threads = std::max(1,std::min(threads,MAX_BUILDERS));
+        _builders = ThreadPool::alloc(threads);
+    }
+    Texture::getBlank();
+}
+
+/**
+ * Builds the scene for the given JSON on the builder threads.
+ *
+ * This method is called on the asset manager thread. It constructs the
+ * root node immediately and then builds each top-level subtree as a
+ * separate builder task. It does not wait on these tasks. The last task
+ * to finish calls {@link assemble}.
+ *
+ * @param job       The (partially initialized) build job
+ * @param json      The JSON object defining the scene
+ */
+void Scene2Loader::buildAsync(const std::shared_ptr<BuildJob>& job, const std::shared_ptr<JsonValue>& json) {
+    job->phase.mark();
+    std::shared_ptr<JsonValue> source = json;
+    if (_builders == nullptr) {
+        CULogError("Could not build scene %s: the loader has no builder threads",job->key.c_str());
+        finish(job,false);
+        return;
+    }
+
+    job->root = (json == nullptr ? nullptr : buildNode(job->key,source,job->nonrelative));
+    if (job->root == nullptr) {
+        CULogError("Could not build scene %s",job->key.c_str());
+        finish(job,false);
+        return;
+    }
+    
+    std::shared_ptr<JsonValue> children = source->get("children");
+    if (children != nullptr) {
+        for (int ii = 0; ii < children->size(); ii++) {
+            std::shared_ptr<JsonValue> item = getChildJson(children,ii);
+            if (item != nullptr) {
+                job->keys.push_back(children->get(ii)->key());
+                job->items.push_back(item);
+            }
+        }
+    }
+    
+    size_t count = job->items.size();
+    if (count == 0) {
+        assemble(job);
+        return;
+    }
+    
+    // Set every slot before the first task can finish
+    job->kids.resize(count);
+    job->pending = count;
+    for(size_t ii = 0; ii < count; ii++) {
+        _builders->addTask([=](void) {
+            job->kids[ii] = build(job->keys[ii],job->items[ii]);
+            if (--job->pending == 0) {
+                assemble(job);
+            }
+        });
+    }
+}
+
+/**
+ * Attaches the built subtrees to the root node and performs the layout.
+ *
+ * This method is called on the builder thread that finished last. Once
+ * layout is complete (and hence all content sizes are final), it
+ * generates the render geometry of each subtree as another set of
+ * builder tasks. The last task to finish calls {@link complete}.
+ *
+ * @param job       The build job
+ */
+void Scene2Loader::assemble(const std::shared_ptr<BuildJob>& job) {
+    Timestamp built;
+    job->timing.build = Timestamp::ellapsedMicros(job->phase,built);
+    
+    for(size_t ii = 0; ii < job->kids.size(); ii++) {
+        addChild(job->root,job->keys[ii],job->items[ii],job->kids[ii],job->nonrelative);
+    }
+    job->root->doLayout();
+    
+    job->phase.mark();
+    job->timing.layout = Timestamp::ellapsedMicros(built,job->phase);
+    prepare_geometry(job->root,false);
+    
+    size_t count = job->root->getChildCount();
+    if (count == 0) {
+        complete(job);
+        return;
+    }
+    
+    job->pending = count;
+    for(size_t ii = 0; ii < count; ii++) {
+        std::shared_ptr<scene2::SceneNode> kid = job->root->getChild((unsigned int)ii);
+        _builders->addTask([=](void) {
+            prepare_geometry(kid,true);
+            if (--job->pending == 0) {
+                complete(job);
+            }
+        });
+    }
+}
+
+/**
+ * Schedules the built scene to be materialized on the main thread.
+ *
+ * @param job       The build job
+ */
+void Scene2Loader::complete(const std::shared_ptr<BuildJob>& job) {
+    job->timing.geometry = Timestamp::ellapsedMicros(job->phase,Timestamp());
+    finish(job,true);
+}
+
+/**
+ * Hands the result of an asynchronous build to the main thread.
+ *
+ * This method schedules the callback (and, if successful, the scene
+ * materialization) on the main thread, and then marks the build as
+ * finished. It must be the last thing a build does off the main thread,
+ * as {@link dispose} may return as soon as it is called. If the loader
+ * is disposed before the main thread gets to the build, the callback
+ * reports a failure.
+ *
+ * @param job       The build job
+ * @param success   Whether the scene was successfully built
+ */
+void Scene2Loader::finish(const std::shared_ptr<BuildJob>& job, bool success) {
+    std::weak_ptr<BaseLoader> self = weak_from_this();
+    Application::get()->schedule([=](void) {
+        // A disposed loader has no builders, and a deleted one has no owner
+        bool alive = !self.expired() && this->_builders != nullptr;
+        if (success && alive) {
+            Timestamp start;
+            this->materialize(job->root,job->callback);
+            job->timing.attach = Timestamp::ellapsedMicros(start,Timestamp());
+            this->report(job->key,job->timing);
+        } else {
+            if (job->callback != nullptr) {
+                job->callback(job->key,false);
+            }
+            if (alive) {
+                this->_queue.erase(job->key);
+            }
+        }
+        return false;
+    });
+
+    std::lock_guard<std::mutex> lock(_buildMutex);
+    _building--;
+    _buildCondition.notify_all();
+}
+
+/**
+ * Records the timing for the given scene, logging it if verbose.
+ *
+ * @param key       The scene key
+ * @param timing    The scene timing
+ */
+void Scene2Loader::report(const std::string& key, const Timing& timing) {
+    _timings[key] = timing;
+    if (_verbose) {
+        CULog("Scene %s: parse %llu, build %llu, layout %llu, geometry %llu, attach %llu micros",
+              key.c_str(),(unsigned long long)timing.parse,(unsigned long long)timing.build,
+              (unsigned long long)timing.layout,(unsigned long long)timing.geometry,
+              (unsigned long long)timing.attach);
+    }
+}
+
 /**
  * Unloads the asset for the given directory entry
  *
@@ -282,6 +282,39 @@ void TextureLoader::materialize(const std::shared_ptr<JsonValue>& json, SDL_Surf
     _queue.erase(key);
 }
 
+/**
+ * Swaps a reloaded image into the existing texture for the directory entry.
+ *
+ * This method finishes the hot reload started in {@link reload}. This
+ * step is not safe to be done in a separate thread.  Instead, it takes
+ * place in the main CUGL thread via {@link Application#schedule}. Any
+ * atlas subtextures are updated in place as well.
+ *
+ * @param json      The asset directory entry
+ * @param surface   The SDL_Surface with the new image (may be null)
+ * @param callback  An optional callback for the reload
+ */
+void TextureLoader::replace(const std::shared_ptr<JsonValue>& json, SDL_Surface* surface, LoaderCallback callback) {
+    std::string key = json->key();
+    auto it = _assets.find(key);
+    
+    bool success = false;
+    if (surface != nullptr && it != _assets.end()) {
+        std::shared_ptr<Texture> texture = it->second;
+        success = texture->reload(surface->pixels, surface->w, surface->h);
+        if (success) {
+            parseAtlas(json,texture);
+        }
+    }
+    
+    if (callback != nullptr) {
+        callback(key,success);
+    }
+    if (surface != nullptr) {
+        SDL_FreeSurface(surface);
+    }
+}
+
 /**
  * Internal method to support asset loading.
  *
@@ -466,6 +499,9 @@ bool TextureLoader::purge(const std::shared_ptr<JsonValue>& json) {
  * the subtexture, respectively.  Each subtexture will have the key of the
  * main texture as the prefix (together with an underscore _) of its key.
  *
+ * If a subtexture of this texture already exists (because the texture was
+ * reloaded), its region is updated in place.
+ *
  * @param json      The asset directory entry
  * @param texture   The texture loaded for this asset
  */
@@ -479,9 +515,66 @@ void TextureLoader::parseAtlas(const std::shared_ptr<JsonValue>& json, const std
             std::string name = key+"_"+item->key();
             std::vector<int> values = item->asIntArray();
             CUAssertLog(values.size() == 4, "Atlas dimensions are incorrect: %d",(Uint32)values.size());
-            _assets[name] = texture->getSubTexture(values[0]/size.width, values[2]/size.width,
-                                                   values[1]/size.height,values[3]/size.height);
+            auto jt = _assets.find(name);
+            if (jt != _assets.end() && jt->second->getParent() == texture) {
+                // Reloaded; keep the existing subtexture objects
+                jt->second->setSubRegion(values[0]/size.width, values[2]/size.width,
+                                         values[1]/size.height,values[3]/size.height);
+            } else {
+                _assets[name] = texture->getSubTexture(values[0]/size.width, values[2]/size.width,
+                                                       values[1]/size.height,values[3]/size.height);
+            }
         }
     }
 }
 
+
+#pragma mark -
+#pragma mark Hot Reloading
+/**
+ * Returns the source file for the given directory entry.
+ *
+ * The path is relative to the asset directory. The asset manager watches
+ * this file for changes when hot reloading.
+ *
+ * @param json      The directory entry for the asset
+ *
+ * @return the source file for the given directory entry.
+ */
+std::string TextureLoader::getSource(const std::shared_ptr<JsonValue>& json) const {
+    return json->getString("file","");
+}
+
+/**
+ * Reloads the texture for the given directory entry in place.
+ *
+ * The image is decoded again on the loader thread (or immediately if there
+ * is no thread). The pixels are then uploaded into the existing texture
+ * on the main thread, so every smart pointer to the texture (or to one of
+ * its atlas subtextures) sees the new image. The texture must already be
+ * loaded.
+ *
+ * @param json      The directory entry for the asset
+ * @param callback  An optional callback for the reload
+ *
+ * @return true if the reload was started
+ */
+bool TextureLoader::reload(const std::shared_ptr<JsonValue>& json, LoaderCallback callback) {
+    if (_assets.find(json->key()) == _assets.end()) {
+        return false;
+    }
+    
+    std::string source = json->getString("file",UNKNOWN_SOURCE);
+    if (_loader == nullptr) {
+        replace(json,preload(source),callback);
+    } else {
+        _loader->addTask([=](void) {
+            SDL_Surface* surface = this->preload(source);
+            Application::get()->schedule([=](void){
+                this->replace(json,surface,callback);
+                return false;
+            });
+        });
+    }
+    return true;
+}
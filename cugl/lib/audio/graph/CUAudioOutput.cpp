@@ -49,6 +49,7 @@
 #include <cugl/audio/CUAudioDevices.h>
 #include <cugl/util/CUDebug.h>
 #include <cugl/util/CUTimestamp.h>
+#include <cugl/util/CUProfiler.h>
 #include <atomic>
 #include <cstring>
 
@@ -77,7 +78,12 @@ static void audioCallback(void*  userdata, Uint8* stream, int len) {
     AudioOutput* device = (AudioOutput*)userdata;
     Uint32 count = (Uint32)(len/(device->getChannels()*device->getBitRate()));
     float* output = (float*)stream;
+    cugl::Profiler* profiler = cugl::Profiler::get();
+    Uint64 start = profiler ? profiler->now() : 0;
     device->read(output,count);
+    if (profiler) {
+        profiler->recordZone("audio", start, profiler->now());
+    }
 }
 
 /**
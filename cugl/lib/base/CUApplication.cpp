@@ -35,6 +35,7 @@
 #include <cugl/render/CUTexture.h>
 #include <cugl/input/CUInput.h>
 #include <cugl/util/CUDebug.h>
+#include <cugl/util/CUProfiler.h>
 #include <algorithm>
 #include <vector>
 
@@ -270,14 +271,25 @@ bool Application::step() {
     _start.mark();
     bool running = getInput();
     if (running &&  _state == State::FOREGROUND) {
-        processCallbacks(((Uint32)micros)/1000);
-        update(micros/1000000.0f);
-
-        glClearColor(_clearColor.r, _clearColor.g, _clearColor.b, _clearColor.a);
-        glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        Profiler* profiler = Profiler::get();
+        if (profiler) { profiler->beginFrame(); }
+        {
+            CUProfileZone("update");
+            processCallbacks(((Uint32)micros)/1000);
+            update(micros/1000000.0f);
+        }
 
-        draw();
-        Display::get()->refresh();
+        {
+            CUProfileZone("render");
+            glClearColor(_clearColor.r, _clearColor.g, _clearColor.b, _clearColor.a);
+            glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            draw();
+        }
+        {
+            CUProfileZone("swap");
+            Display::get()->refresh();
+        }
+        if (profiler && profiler == Profiler::get()) { profiler->endFrame(); }
     } else {
         running = _state == State::BACKGROUND;
     }
@@ -48,9 +48,16 @@
 //
 #include <cugl/io/CUJsonWriter.h>
 #include <cugl/util/CUDebug.h>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
 
 using namespace cugl;
 
+/** The size of the stack buffer for formatting a single number */
+#define NUMBER_BUFFER 32
+
 /**
  * Writes a JsonValue to the file, appending a newline at the end.
  *
@@ -64,6 +71,174 @@ using namespace cugl;
  */
 void JsonWriter::writeJson(const JsonValue* json, bool format) {
     CUAssertLog(json, "Attempt to write a nullptr JSON");
-    std::string data = json->toString(format);
-    writeLine(data);
+    writeValue(json,0,format);
+    write('\n');
+    flush();
+}
+
+#pragma mark -
+#pragma mark Internal Helpers
+/**
+ * Writes a JsonValue (and all of its children) to the buffer.
+ *
+ * @param json      The JSON value to write
+ * @param depth     The nesting depth of the value
+ * @param format    Whether to pretty-print the JSON string
+ */
+void JsonWriter::writeValue(const JsonValue* json, int depth, bool format) {
+    switch (json->_type) {
+        case JsonValue::Type::NullType:
+            write("null",4);
+            break;
+        case JsonValue::Type::BoolType:
+            if (json->_longValue) {
+                write("true",4);
+            } else {
+                write("false",5);
+            }
+            break;
+        case JsonValue::Type::NumberType:
+            writeNumber(json);
+            break;
+        case JsonValue::Type::StringType:
+            writeString(json->_stringValue);
+            break;
+        case JsonValue::Type::ArrayType:
+            write('[');
+            for(auto it = json->_children.begin(); it != json->_children.end(); ++it) {
+                if (it != json->_children.begin()) {
+                    if (format) {
+                        write(", ",2);
+                    } else {
+                        write(',');
+                    }
+                }
+                writeValue(it->get(),depth+1,format);
+            }
+            write(']');
+            break;
+        case JsonValue::Type::ObjectType:
+            // Same layout as cJSON_Print, so files do not churn under version control
+            write('{');
+            if (format) {
+                write('\n');
+            }
+            for(auto it = json->_children.begin(); it != json->_children.end(); ++it) {
+                if (format) {
+                    for(int ii = 0; ii <= depth; ii++) {
+                        write('\t');
+                    }
+                }
+                writeString((*it)->_key);
+                write(':');
+                if (format) {
+                    write('\t');
+                }
+                writeValue(it->get(),depth+1,format);
+                if (it+1 != json->_children.end()) {
+                    write(',');
+                }
+                if (format) {
+                    write('\n');
+                }
+            }
+            if (format) {
+                for(int ii = 0; ii < depth; ii++) {
+                    write('\t');
+                }
+            }
+            write('}');
+            break;
+        default:
+            CUAssertLog(false,"Unknown JSON type %d",(int)json->_type);
+    }
+}
+
+/**
+ * Writes a JSON number to the buffer.
+ *
+ * Integral values are written as integers. All other values are written
+ * with the shortest representation that reads back to the same double.
+ * NaN and infinity are not valid JSON, and are written as null.
+ *
+ * @param json      The JSON number to write
+ */
+void JsonWriter::writeNumber(const JsonValue* json) {
+    double value = json->_doubleValue;
+    if (!std::isfinite(value)) {
+        write("null",4);
+        return;
+    }
+    
+    char buffer[NUMBER_BUFFER];
+    if ((double)json->_longValue == value) {
+        std::to_chars_result result = std::to_chars(buffer, buffer+NUMBER_BUFFER, json->_longValue);
+        write(buffer,(size_t)(result.ptr-buffer));
+        return;
+    }
+    
+#if defined (__cpp_lib_to_chars)
+    std::to_chars_result result = std::to_chars(buffer, buffer+NUMBER_BUFFER, value);
+    write(buffer,(size_t)(result.ptr-buffer));
+#else
+    // No floating point to_chars (e.g. NDK libc++), so use the shortest %g that round trips
+    int len = snprintf(buffer, NUMBER_BUFFER, "%.15g", value);
+    if (std::strtod(buffer, nullptr) != value) {
+        len = snprintf(buffer, NUMBER_BUFFER, "%.17g", value);
+    }
+    write(buffer,(size_t)len);
+#endif
+}
+
+/**
+ * Writes a quoted and escaped JSON string to the buffer.
+ *
+ * @param s         The string to write
+ */
+void JsonWriter::writeString(const std::string& s) {
+    write('"');
+    const char* data = s.data();
+    size_t start = 0;
+    for(size_t ii = 0; ii < s.size(); ii++) {
+        unsigned char c = (unsigned char)data[ii];
+        if (c > 31 && c != '"' && c != '\\') {
+            continue;
+        }
+        
+        // Write the unescaped run in one copy
+        write(data+start,ii-start);
+        start = ii+1;
+        switch (c) {
+            case '"':
+                write("\\\"",2);
+                break;
+            case '\\':
+                write("\\\\",2);
+                break;
+            case '\b':
+                write("\\b",2);
+                break;
+            case '\f':
+                write("\\f",2);
+                break;
+            case '\n':
+                write("\\n",2);
+                break;
+            case '\r':
+                write("\\r",2);
+                break;
+            case '\t':
+                write("\\t",2);
+                break;
+            default:
+            {
+                char buffer[8];
+                int len = snprintf(buffer, 8, "\\u%04x", c);
+                write(buffer,(size_t)len);
+            }
+                break;
+        }
+    }
+    write(data+start,s.size()-start);
+    write('"');
 }
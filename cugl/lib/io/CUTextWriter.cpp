@@ -51,10 +51,81 @@
 #include <cugl/util/CUDebug.h>
 #include <cugl/util/CUFiletools.h>
 #include <cstring>
+#include <mutex>
+#include <vector>
 
 using namespace cugl;
 
 #define BUFFSIZE 1024
+/** The maximum number of idle default-sized buffers kept for reuse */
+#define POOL_LIMIT 4
+
+#pragma mark -
+#pragma mark Buffer Pool
+/**
+ * A pool of idle write buffers of the default capacity.
+ *
+ * Writers are often short-lived (one per save file), so recycling their
+ * buffers avoids a heap allocation per file. The pool is shared by every
+ * thread, and so is guarded by a mutex.
+ */
+class BufferPool {
+public:
+    /** The idle buffers */
+    std::vector<char*> buffers;
+    /** The mutex guarding the idle buffers */
+    std::mutex mutex;
+    
+    /** Deletes all idle buffers */
+    ~BufferPool() {
+        for(auto it = buffers.begin(); it != buffers.end(); ++it) {
+            delete[] *it;
+        }
+    }
+};
+
+/** The shared buffer pool */
+static BufferPool buffer_pool;
+
+/**
+ * Returns a write buffer of the given capacity
+ *
+ * Buffers of the default capacity are taken from the pool if possible.
+ *
+ * @param capacity  The buffer capacity
+ *
+ * @return a write buffer of the given capacity
+ */
+static char* acquire_buffer(Uint32 capacity) {
+    if (capacity == BUFFSIZE) {
+        std::lock_guard<std::mutex> lock(buffer_pool.mutex);
+        if (!buffer_pool.buffers.empty()) {
+            char* result = buffer_pool.buffers.back();
+            buffer_pool.buffers.pop_back();
+            return result;
+        }
+    }
+    return new char[capacity];
+}
+
+/**
+ * Releases a write buffer of the given capacity
+ *
+ * Buffers of the default capacity are returned to the pool if there is room.
+ *
+ * @param buffer    The buffer to release
+ * @param capacity  The buffer capacity
+ */
+static void release_buffer(char* buffer, Uint32 capacity) {
+    if (capacity == BUFFSIZE) {
+        std::lock_guard<std::mutex> lock(buffer_pool.mutex);
+        if (buffer_pool.buffers.size() < POOL_LIMIT) {
+            buffer_pool.buffers.push_back(buffer);
+            return;
+        }
+    }
+    delete[] buffer;
+}
 
 #pragma mark -
 #pragma mark Constructors
@@ -103,7 +174,7 @@ bool TextWriter::init(const std::string file, unsigned int capacity) {
     }
     
     _capacity = capacity;
-    _cbuffer = new char[_capacity];
+    _cbuffer = acquire_buffer(_capacity);
     _bufoff = 0;
     
     return (bool)_cbuffer;
@@ -138,7 +209,7 @@ void TextWriter::close() {
         _stream  = nullptr;
     }
     if (_cbuffer) {
-        delete[] _cbuffer;
+        release_buffer(_cbuffer,_capacity);
         _cbuffer = nullptr;
     }
 }
@@ -173,22 +244,7 @@ void TextWriter::write(char c) {
  * @param s  the string to write
  */
 void TextWriter::write(const char* s) {
-    CUAssertLog(_stream, "Attempt to write to a closed stream");
-    size_t pos = 0;
-    size_t len = strlen(s);
-
-    if (_bufoff+len >  _capacity) {
-        flush();
-    }
-    while (len-pos > _capacity-_bufoff) {
-        memcpy(&(_cbuffer[_bufoff]), &(s[pos]),_capacity-_bufoff);
-        pos += _capacity-_bufoff;
-        _bufoff = _capacity;
-        flush();
-    }
-
-    memcpy(&(_cbuffer[_bufoff]), &(s[pos]), len-pos);
-    _bufoff += (Sint32)(len-pos);
+    write(s,strlen(s));
 }
 
 /**
@@ -201,20 +257,35 @@ void TextWriter::write(const char* s) {
  * @param s  the string to write
  */
 void TextWriter::write(const std::string& s) {
+    write(s.data(),s.size());
+}
+
+/**
+ * Writes the first len characters of a string (ASCII or UTF8) to the file
+ *
+ * The string does not need to be null-terminated. The value is written
+ * to the internal buffer, but is not necessarily flushed automatically.
+ * It will be written when the buffer reaches capacity or the file is
+ * closed.
+ *
+ * @param s     the string to write
+ * @param len   the number of characters to write
+ */
+void TextWriter::write(const char* s, size_t len) {
     CUAssertLog(_stream, "Attempt to write to a closed stream");
     size_t pos = 0;
-    if (_bufoff+s.size() > _capacity) {
+    if (_bufoff+len > _capacity) {
         flush();
     }
-    while (s.size()-pos > _capacity-_bufoff) {
-        memcpy(&(_cbuffer[_bufoff]), &(s.c_str()[pos]), _capacity-_bufoff);
+    while (len-pos > _capacity-_bufoff) {
+        memcpy(&(_cbuffer[_bufoff]), &(s[pos]), _capacity-_bufoff);
         pos += _capacity-_bufoff;
         _bufoff = _capacity;
         flush();
     }
 
-    memcpy(&(_cbuffer[_bufoff]), &(s.c_str()[pos]), s.size()-pos);
-    _bufoff += (Sint32)(s.size()-pos);
+    memcpy(&(_cbuffer[_bufoff]), &(s[pos]), len-pos);
+    _bufoff += (Sint32)(len-pos);
 }
 
 /**
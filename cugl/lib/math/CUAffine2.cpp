@@ -962,6 +962,140 @@ float* Affine2::transform(const Affine2& aff, float const* input, float* output,
     return output;
 }
 
+/**
+ * Transforms the strided point array, and stores the result in output.
+ *
+ * Each point is the first two floats of a record that is instride floats
+ * wide (outstride for the output).  This allows the transform to be
+ * applied directly to the position field of an interleaved vertex array,
+ * such as {@link SpriteVertex2}, without copying the points out. Only the
+ * x and y values of each output record are written.
+ *
+ * The points are transformed four at a time (with SSE or Neon when the
+ * vectorized math library is enabled).  The input and output may be the
+ * same array, provided that the strides are the same. Otherwise the
+ * arrays must not overlap.
+ *
+ * @param aff       The transform matrix.
+ * @param input     The array of points to transform.
+ * @param instride  The number of floats between consecutive input points.
+ * @param output    The array to store the transformed points.
+ * @param outstride The number of floats between consecutive output points.
+ * @param size      The number of points to transform.
+ *
+ * @return A reference to output for chaining
+ */
+float* Affine2::transform(const Affine2& aff, float const* input, size_t instride,
+                          float* output, size_t outstride, size_t size) {
+    CUAssertLog(output, "Destination array is null");
+    CUAssertLog(instride >= 2 && outstride >= 2, "Strides must be at least 2");
+    const float a  = aff.m[0];
+    const float b  = aff.m[1];
+    const float c  = aff.m[2];
+    const float d  = aff.m[3];
+    const float tx = aff.m[4];
+    const float ty = aff.m[5];
+    
+    // Each block reads all four points before writing any, so in place is safe
+    size_t ii = 0;
+#if defined CU_MATH_VECTOR_SSE
+    const __m128 va = _mm_set1_ps(a);
+    const __m128 vb = _mm_set1_ps(b);
+    const __m128 vc = _mm_set1_ps(c);
+    const __m128 vd = _mm_set1_ps(d);
+    const __m128 vx = _mm_set1_ps(tx);
+    const __m128 vy = _mm_set1_ps(ty);
+    for(; ii+4 <= size; ii += 4) {
+        const float* src = input+ii*instride;
+        __m128 xs, ys;
+        if (instride == 2) {
+            __m128 lo = _mm_loadu_ps(src);
+            __m128 hi = _mm_loadu_ps(src+4);
+            xs = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2,0,2,0));
+            ys = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3,1,3,1));
+        } else {
+            xs = _mm_setr_ps(src[0],src[instride],  src[2*instride],  src[3*instride]);
+            ys = _mm_setr_ps(src[1],src[instride+1],src[2*instride+1],src[3*instride+1]);
+        }
+        __m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(va,xs),_mm_mul_ps(vc,ys)),vx);
+        __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vb,xs),_mm_mul_ps(vd,ys)),vy);
+        
+        float* dst = output+ii*outstride;
+        if (outstride == 2) {
+            _mm_storeu_ps(dst,  _mm_unpacklo_ps(rx,ry));
+            _mm_storeu_ps(dst+4,_mm_unpackhi_ps(rx,ry));
+        } else {
+            __attribute__((__aligned__(16))) float temp[8];
+            _mm_store_ps(temp,  rx);
+            _mm_store_ps(temp+4,ry);
+            for(size_t jj = 0; jj < 4; jj++) {
+                dst[jj*outstride  ] = temp[jj];
+                dst[jj*outstride+1] = temp[jj+4];
+            }
+        }
+    }
+#elif defined CU_MATH_VECTOR_NEON64
+    const float32x4_t va = vdupq_n_f32(a);
+    const float32x4_t vb = vdupq_n_f32(b);
+    const float32x4_t vc = vdupq_n_f32(c);
+    const float32x4_t vd = vdupq_n_f32(d);
+    const float32x4_t vx = vdupq_n_f32(tx);
+    const float32x4_t vy = vdupq_n_f32(ty);
+    for(; ii+4 <= size; ii += 4) {
+        const float* src = input+ii*instride;
+        float32x4x2_t pts;
+        if (instride == 2) {
+            pts = vld2q_f32(src);
+        } else {
+            __attribute__((__aligned__(16))) float temp[8];
+            for(size_t jj = 0; jj < 4; jj++) {
+                temp[jj]   = src[jj*instride];
+                temp[jj+4] = src[jj*instride+1];
+            }
+            pts.val[0] = vld1q_f32(temp);
+            pts.val[1] = vld1q_f32(temp+4);
+        }
+        float32x4x2_t res;
+        res.val[0] = vmlaq_f32(vmlaq_f32(vx,va,pts.val[0]),vc,pts.val[1]);
+        res.val[1] = vmlaq_f32(vmlaq_f32(vy,vb,pts.val[0]),vd,pts.val[1]);
+        
+        float* dst = output+ii*outstride;
+        if (outstride == 2) {
+            vst2q_f32(dst,res);
+        } else {
+            __attribute__((__aligned__(16))) float temp[8];
+            vst1q_f32(temp,  res.val[0]);
+            vst1q_f32(temp+4,res.val[1]);
+            for(size_t jj = 0; jj < 4; jj++) {
+                dst[jj*outstride  ] = temp[jj];
+                dst[jj*outstride+1] = temp[jj+4];
+            }
+        }
+    }
+#else
+    for(; ii+4 <= size; ii += 4) {
+        const float* src = input+ii*instride;
+        float x0 = src[0];            float y0 = src[1];
+        float x1 = src[instride];     float y1 = src[instride+1];
+        float x2 = src[2*instride];   float y2 = src[2*instride+1];
+        float x3 = src[3*instride];   float y3 = src[3*instride+1];
+        
+        float* dst = output+ii*outstride;
+        dst[0] = a*x0+c*y0+tx;                  dst[1] = b*x0+d*y0+ty;
+        dst[outstride]   = a*x1+c*y1+tx;        dst[outstride+1]   = b*x1+d*y1+ty;
+        dst[2*outstride] = a*x2+c*y2+tx;        dst[2*outstride+1] = b*x2+d*y2+ty;
+        dst[3*outstride] = a*x3+c*y3+tx;        dst[3*outstride+1] = b*x3+d*y3+ty;
+    }
+#endif
+    for(; ii < size; ii++) {
+        float x = input[ii*instride];
+        float y = input[ii*instride+1];
+        output[ii*outstride  ] = a*x+c*y+tx;
+        output[ii*outstride+1] = b*x+d*y+ty;
+    }
+    return output;
+}
+
 /**
  * Transforms the rectangle and stores the result in dst.
  *
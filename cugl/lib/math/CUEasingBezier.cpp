@@ -7,6 +7,11 @@
 //  function. This provides the user with more flexibility than the
 //  EasingFunction factory.
 //
+//  The curve is solved with a few Newton steps per evaluation. For curves
+//  that are evaluated constantly, it can also be sampled into a lookup table
+//  with linear interpolation. Arrays of times can be evaluated in a batch,
+//  which uses SSE or NEON when CUGL is vectorized.
+//
 //  These classe uses our standard shared-pointer architecture.
 //
 //  1. The constructor does not perform any initialization; it just sets all
@@ -45,6 +50,15 @@
 
 using namespace cugl;
 
+/** The maximum number of Newton steps when solving the curve */
+#define BEZIER_NEWTON_STEPS 8
+/** The maximum number of bisection steps when Newton's method fails */
+#define BEZIER_BISECT_STEPS 32
+/** The tolerance for the x-component when solving the curve */
+#define BEZIER_TOLERANCE    1e-6f
+/** The minimum slope for a Newton step */
+#define BEZIER_MIN_SLOPE    1e-6f
+
 #pragma mark Constructors
 /**
  * Creates an uninitialized easing function.
@@ -156,28 +170,187 @@ void EasingBezier::dispose() {
     _c1 = Vec2::ZERO;
     _c2 = Vec2::ZERO;
     _c3 = Vec2::ZERO;
-    _rootset.clear();
+    _table.clear();
 }
 
 #pragma mark -
 #pragma mark Easing Support
+/**
+ * Sets the number of samples in the lookup table.
+ *
+ * If size is nonzero, this method samples the curve at size uniformly
+ * spaced times in [0,1]. From then on, evaluation interpolates these
+ * samples instead of solving the curve. The error is quadratic in the
+ * spacing (except where the curve is nearly vertical), so 256 samples is
+ * enough for most animations. If size is 0, the table is discarded. A
+ * size of 1 is treated as 2 (the end points).
+ *
+ * This method is not thread-safe, and so it should be called before the
+ * object (or its evaluator) is shared.
+ *
+ * @param size  The number of samples in the lookup table
+ */
+void EasingBezier::setLookupSize(size_t size) {
+    _table.clear();
+    if (size == 0) {
+        _table.shrink_to_fit();
+        return;
+    }
+    
+    size = std::max(size, (size_t)2);
+    _table.resize(size);
+    for(size_t ii = 0; ii < size; ii++) {
+        _table[ii] = sampleCurve(solveCurve((float)ii/(size-1)));
+    }
+}
 
 /**
  * Returns the value of the easing function at t.
  *
- * The easing function is only well-defined when 0 <= t <= 1.
+ * The easing function is only well-defined when 0 <= t <= 1. If there is
+ * a lookup table, t is clamped to this range.
  *
  * @return the value of the easing function at t.
  */
-float EasingBezier::evaluate(float t) {
-    _rootset.clear();
-    solveCubicEquation(_c3.x, _c2.x, _c1.x, -t);
-    float choice = 0;
-    if (!_rootset.empty()) {
-        choice = _rootset[0];
+float EasingBezier::evaluate(float t) const {
+    if (_table.empty()) {
+        return sampleCurve(solveCurve(t));
     }
     
-    return choice*choice*choice*_c3.y+choice*choice*_c2.y+choice*_c1.y;
+    size_t last = _table.size()-1;
+    float pos = std::min(std::max(t, 0.0f), 1.0f)*last;
+    size_t index = std::min((size_t)pos, last-1);
+    return _table[index]+(_table[index+1]-_table[index])*(pos-index);
+}
+
+/**
+ * Stores the value of the easing function at each of the given times.
+ *
+ * This is the same as calling {@link evaluate(float)} on every time, but
+ * the values are computed four at a time with SSE or NEON when CUGL is
+ * vectorized. The arrays t and out may be the same.
+ *
+ * @param t     The array of times
+ * @param out   The array to store the results
+ * @param size  The number of times to evaluate
+ */
+void EasingBezier::evaluate(const float* t, float* out, size_t size) const {
+    size_t ii = 0;
+#if defined CU_MATH_VECTOR_SSE
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one  = _mm_set1_ps(1.0f);
+    if (!_table.empty()) {
+        const float* table = _table.data();
+        const __m128 scale = _mm_set1_ps((float)(_table.size()-1));
+        const __m128 limit = _mm_set1_ps((float)(_table.size()-2));
+        alignas(16) int lane[4];
+        for(; ii+4 <= size; ii += 4) {
+            __m128 pos = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(t+ii), zero), one), scale);
+            __m128i index = _mm_cvttps_epi32(_mm_min_ps(pos, limit));
+            __m128 frac = _mm_sub_ps(pos, _mm_cvtepi32_ps(index));
+            _mm_store_si128((__m128i*)lane, index);
+            __m128 lo = _mm_setr_ps(table[lane[0]], table[lane[1]], table[lane[2]], table[lane[3]]);
+            __m128 hi = _mm_setr_ps(table[lane[0]+1], table[lane[1]+1], table[lane[2]+1], table[lane[3]+1]);
+            _mm_storeu_ps(out+ii, _mm_add_ps(lo, _mm_mul_ps(_mm_sub_ps(hi, lo), frac)));
+        }
+    } else {
+        const __m128 c1x = _mm_set1_ps(_c1.x);
+        const __m128 c2x = _mm_set1_ps(_c2.x);
+        const __m128 c3x = _mm_set1_ps(_c3.x);
+        const __m128 d2x = _mm_set1_ps(2*_c2.x);
+        const __m128 d3x = _mm_set1_ps(3*_c3.x);
+        const __m128 c1y = _mm_set1_ps(_c1.y);
+        const __m128 c2y = _mm_set1_ps(_c2.y);
+        const __m128 c3y = _mm_set1_ps(_c3.y);
+        const __m128 sign  = _mm_set1_ps(-0.0f);
+        const __m128 slope = _mm_set1_ps(BEZIER_MIN_SLOPE);
+        const __m128 tolerance = _mm_set1_ps(BEZIER_TOLERANCE);
+        for(; ii+4 <= size; ii += 4) {
+            __m128 x = _mm_loadu_ps(t+ii);
+            __m128 s = _mm_min_ps(_mm_max_ps(x, zero), one);
+            __m128 fx = zero;
+            for(int jj = 0; jj < BEZIER_NEWTON_STEPS; jj++) {
+                fx = _mm_sub_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(c3x, s), c2x), s), c1x), s), x);
+                __m128 dx = _mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(d3x, s), d2x), s), c1x);
+                __m128 steep = _mm_cmpge_ps(_mm_andnot_ps(sign, dx), slope);
+                s = _mm_sub_ps(s, _mm_and_ps(steep, _mm_div_ps(fx, dx)));
+                s = _mm_min_ps(_mm_max_ps(s, zero), one);
+            }
+            fx = _mm_sub_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(c3x, s), c2x), s), c1x), s), x);
+            __m128 y = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(c3y, s), c2y), s), c1y), s);
+            _mm_storeu_ps(out+ii, y);
+            
+            // Lanes that did not converge (or lie outside [0,1]) are solved exactly
+            int converged = _mm_movemask_ps(_mm_cmplt_ps(_mm_andnot_ps(sign, fx), tolerance));
+            if (converged != 0xF) {
+                for(int jj = 0; jj < 4; jj++) {
+                    if (!(converged & (1 << jj))) {
+                        out[ii+jj] = sampleCurve(solveCurve(t[ii+jj]));
+                    }
+                }
+            }
+        }
+    }
+#elif defined CU_MATH_VECTOR_NEON64
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t one  = vdupq_n_f32(1.0f);
+    if (!_table.empty()) {
+        const float* table = _table.data();
+        const float32x4_t scale = vdupq_n_f32((float)(_table.size()-1));
+        const float32x4_t limit = vdupq_n_f32((float)(_table.size()-2));
+        int32_t lane[4];
+        for(; ii+4 <= size; ii += 4) {
+            float32x4_t pos = vmulq_f32(vminq_f32(vmaxq_f32(vld1q_f32(t+ii), zero), one), scale);
+            int32x4_t index = vcvtq_s32_f32(vminq_f32(pos, limit));
+            float32x4_t frac = vsubq_f32(pos, vcvtq_f32_s32(index));
+            vst1q_s32(lane, index);
+            float lo[4] = { table[lane[0]], table[lane[1]], table[lane[2]], table[lane[3]] };
+            float hi[4] = { table[lane[0]+1], table[lane[1]+1], table[lane[2]+1], table[lane[3]+1] };
+            float32x4_t base = vld1q_f32(lo);
+            vst1q_f32(out+ii, vmlaq_f32(base, vsubq_f32(vld1q_f32(hi), base), frac));
+        }
+    } else {
+        const float32x4_t c1x = vdupq_n_f32(_c1.x);
+        const float32x4_t c2x = vdupq_n_f32(_c2.x);
+        const float32x4_t c3x = vdupq_n_f32(_c3.x);
+        const float32x4_t d2x = vdupq_n_f32(2*_c2.x);
+        const float32x4_t d3x = vdupq_n_f32(3*_c3.x);
+        const float32x4_t c1y = vdupq_n_f32(_c1.y);
+        const float32x4_t c2y = vdupq_n_f32(_c2.y);
+        const float32x4_t c3y = vdupq_n_f32(_c3.y);
+        const float32x4_t slope = vdupq_n_f32(BEZIER_MIN_SLOPE);
+        const float32x4_t tolerance = vdupq_n_f32(BEZIER_TOLERANCE);
+        uint32_t converged[4];
+        for(; ii+4 <= size; ii += 4) {
+            float32x4_t x = vld1q_f32(t+ii);
+            float32x4_t s = vminq_f32(vmaxq_f32(x, zero), one);
+            float32x4_t fx = zero;
+            for(int jj = 0; jj < BEZIER_NEWTON_STEPS; jj++) {
+                fx = vsubq_f32(vmulq_f32(vmlaq_f32(c1x, vmlaq_f32(c2x, c3x, s), s), s), x);
+                float32x4_t dx = vmlaq_f32(c1x, vmlaq_f32(d2x, d3x, s), s);
+                uint32x4_t steep = vcgeq_f32(vabsq_f32(dx), slope);
+                s = vsubq_f32(s, vbslq_f32(steep, vdivq_f32(fx, dx), zero));
+                s = vminq_f32(vmaxq_f32(s, zero), one);
+            }
+            fx = vsubq_f32(vmulq_f32(vmlaq_f32(c1x, vmlaq_f32(c2x, c3x, s), s), s), x);
+            vst1q_f32(out+ii, vmulq_f32(vmlaq_f32(c1y, vmlaq_f32(c2y, c3y, s), s), s));
+            
+            // Lanes that did not converge (or lie outside [0,1]) are solved exactly
+            uint32x4_t good = vcltq_f32(vabsq_f32(fx), tolerance);
+            if (vminvq_u32(good) == 0) {
+                vst1q_u32(converged, good);
+                for(int jj = 0; jj < 4; jj++) {
+                    if (!converged[jj]) {
+                        out[ii+jj] = sampleCurve(solveCurve(t[ii+jj]));
+                    }
+                }
+            }
+        }
+    }
+#endif
+    for(; ii < size; ii++) {
+        out[ii] = evaluate(t[ii]);
+    }
 }
 
 /**
@@ -193,73 +366,46 @@ std::function<float(float)> EasingBezier::getEvaluator() {
     return [=] (float t){ return context->evaluate(t); };
 }
 
-
 #pragma mark -
 #pragma mark Internal Helpers
 /**
- * Stores the roots of a x^2 + b x + c into the rootset.
+ * Returns the curve parameter whose x-component is t.
  *
- * This is a helper function for computing the root set from the
- * bezier polynomial.
+ * The x-component of an easing curve is monotonic, so this parameter is
+ * unique. It is found with Newton's method, falling back to bisection
+ * when the curve is too flat for Newton's method to converge.
  *
- * @param a The 2nd degree coefficient
- * @param b The linear coefficient
- * @param c The constant factor
- */
-void EasingBezier::solveQuadraticEquation(float a, float b, float c) {
-    float  discriminant = b * b - 4 * a * c;
-    if (discriminant >= 0) {
-        _rootset.push_back((-b + sqrtf(discriminant)) / (2.0f * a));
-        _rootset.push_back((-b - sqrtf(discriminant)) / (2.0f * a));
-    }
-
-}
-
-/**
- * Stores the roots of a x^3 + b x^2 + c x + d into the rootset.
- *
- * This is a helper function for computing the root set from the
- * bezier polynomial.
+ * @param t The x-component to solve for
  *
- * @param a The 3rd degree coefficient
- * @param b The 2nd degree coefficient
- * @param c The linear coefficient
- * @param d The constant factor
+ * @return the curve parameter whose x-component is t.
  */
-void EasingBezier::solveCubicEquation(float a, float b, float c, float d) {
-    if (a == 0) {
-        solveQuadraticEquation(b, c, d);
-        return;
+float EasingBezier::solveCurve(float t) const {
+    float s = t;
+    for(int ii = 0; ii < BEZIER_NEWTON_STEPS; ii++) {
+        float x = ((_c3.x*s+_c2.x)*s+_c1.x)*s-t;
+        if (fabsf(x) < BEZIER_TOLERANCE) {
+            return s;
+        }
+        float dx = (3*_c3.x*s+2*_c2.x)*s+_c1.x;
+        if (fabsf(dx) < BEZIER_MIN_SLOPE) {
+            break;
+        }
+        s -= x/dx;
     }
     
-    b /= a;
-    c /= a;
-    d /= a;
-    
-    float p = (3 * c - b * b)/3.0f;
-    float q = (2 * b * b * b - 9 * b * c + 27 * d)/27.0f;
-    
-    if (p == 0) {
-        _rootset.push_back(powf(-q, 1.0f/3.0f));
-    } else if (q == 0) {
-        _rootset.push_back(sqrtf(-p));
-        _rootset.push_back(-sqrtf(-p));
-    } else {
-        float discriminant = q*q/4.0f + p*p*p/27.0f;
-        if (discriminant == 0) {
-            _rootset.push_back(powf(q/2.0f, 1.0f/3.0f) - b/3.0f);
-        } else if (discriminant > 0) {
-            _rootset.push_back(powf(-(q/2.0f) + sqrtf(discriminant), 1.0f/3.0f) -
-                               powf((q/2.0f)  + sqrtf(discriminant), 1.0f/3.0f) - b/3.0f);
+    float lo = 0;
+    float hi = 1;
+    s = std::min(std::max(t, lo), hi);
+    for(int ii = 0; ii < BEZIER_BISECT_STEPS; ii++) {
+        float x = ((_c3.x*s+_c2.x)*s+_c1.x)*s;
+        if (fabsf(x-t) < BEZIER_TOLERANCE) {
+            return s;
+        } else if (x < t) {
+            lo = s;
         } else {
-            float r = sqrtf( powf(-(p/3.0f), 3.0f) );
-            float phi = acosf(-(q / (2 * sqrtf(-p*p*p/27.0f))));
-            float s = 2 * powf(r, 1.0f/3.0f);
-            _rootset.push_back(s * cosf(phi / 3.0f) - b / 3.0f);
-            _rootset.push_back(s * cosf((phi + 2 * (float)M_PI) / 3.0f) - b / 3.0f);
-            _rootset.push_back(s * cosf((phi + 4 * (float)M_PI) / 3.0f) - b / 3.0f);
+            hi = s;
         }
+        s = (lo+hi)*0.5f;
     }
+    return s;
 }
-
-
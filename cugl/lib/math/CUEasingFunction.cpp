@@ -35,6 +35,161 @@
 
 using namespace cugl;
 
+/** The polynomial accelerates from t=0 */
+#define EASE_IN         0
+/** The polynomial decelerates to t=1 */
+#define EASE_OUT        1
+/** The polynomial accelerates to t=0.5 and then decelerates */
+#define EASE_IN_OUT     2
+/** The overshoot of the back easing functions */
+#define BACK_OVERSHOOT  1.70158f
+/** The overshoot of the back in-out easing function */
+#define BACK_OVERSHOOT_IN_OUT (1.70158f * 1.525f)
+
+#pragma mark -
+#pragma mark Batch Helpers
+/**
+ * Stores the value of the easing function T at each of the given times.
+ *
+ * This is the scalar version of batch evaluation. As T is known at compile
+ * time, the function is inlined in the loop.
+ *
+ * @param time      The array of times in seconds
+ * @param out       The array to store the results
+ * @param size      The number of times to evaluate
+ * @param period    The period of an elastic easing function
+ */
+template <EasingFunction::Type T>
+static void evaluate_each(const float* time, float* out, size_t size, float period) {
+    for(size_t ii = 0; ii < size; ii++) {
+        out[ii] = EasingFunction::evaluate<T>(time[ii], period);
+    }
+}
+
+#if defined CU_MATH_VECTOR_SSE
+/**
+ * Returns t^(degree-1) * (slope*t - offset) for four values of t.
+ *
+ * This is the "in" form of the polynomial easing functions. The power
+ * functions have slope 1 and offset 0, while the back functions have a
+ * cubic with an overshoot.
+ *
+ * @param t         The times
+ * @param degree    The polynomial degree
+ * @param slope     The leading coefficient
+ * @param offset    The overshoot coefficient
+ *
+ * @return t^(degree-1) * (slope*t - offset) for four values of t.
+ */
+static inline __m128 ease_in(__m128 t, int degree, __m128 slope, __m128 offset) {
+    __m128 result = _mm_sub_ps(_mm_mul_ps(slope, t), offset);
+    for(int kk = 1; kk < degree; kk++) {
+        result = _mm_mul_ps(result, t);
+    }
+    return result;
+}
+#elif defined CU_MATH_VECTOR_NEON64
+/**
+ * Returns t^(degree-1) * (slope*t - offset) for four values of t.
+ *
+ * This is the "in" form of the polynomial easing functions. The power
+ * functions have slope 1 and offset 0, while the back functions have a
+ * cubic with an overshoot.
+ *
+ * @param t         The times
+ * @param degree    The polynomial degree
+ * @param slope     The leading coefficient
+ * @param offset    The overshoot coefficient
+ *
+ * @return t^(degree-1) * (slope*t - offset) for four values of t.
+ */
+static inline float32x4_t ease_in(float32x4_t t, int degree, float32x4_t slope, float32x4_t offset) {
+    float32x4_t result = vsubq_f32(vmulq_f32(slope, t), offset);
+    for(int kk = 1; kk < degree; kk++) {
+        result = vmulq_f32(result, t);
+    }
+    return result;
+}
+#endif
+
+/**
+ * Stores the value of the polynomial easing function T at the given times.
+ *
+ * Every polynomial easing function (including the back functions) is
+ * derived from the polynomial f(t) = t^(degree-1) * (slope*t - offset).
+ * The out function is 1-f(1-t), and the in-out function is f(2t)/2 for
+ * t < 0.5 and 1-f(2-2t)/2 otherwise. This allows us to evaluate them four
+ * at a time with SSE or NEON. Any remaining values (or all values if CUGL
+ * is not vectorized) are evaluated with the scalar function T.
+ *
+ * @param time      The array of times in seconds
+ * @param out       The array to store the results
+ * @param size      The number of times to evaluate
+ * @param degree    The polynomial degree
+ * @param slope     The leading coefficient
+ * @param offset    The overshoot coefficient
+ * @param mode      One of EASE_IN, EASE_OUT, or EASE_IN_OUT
+ */
+template <EasingFunction::Type T>
+static void evaluate_polynomial(const float* time, float* out, size_t size,
+                                int degree, float slope, float offset, int mode) {
+    size_t ii = 0;
+#if defined CU_MATH_VECTOR_SSE
+    const __m128 one  = _mm_set1_ps(1.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 two  = _mm_set1_ps(2.0f);
+    const __m128 a = _mm_set1_ps(slope);
+    const __m128 b = _mm_set1_ps(offset);
+    for(; ii+4 <= size; ii += 4) {
+        __m128 t = _mm_loadu_ps(time+ii);
+        __m128 result;
+        if (mode == EASE_IN) {
+            result = ease_in(t, degree, a, b);
+        } else if (mode == EASE_OUT) {
+            result = _mm_sub_ps(one, ease_in(_mm_sub_ps(one, t), degree, a, b));
+        } else {
+            __m128 t2 = _mm_mul_ps(two, t);
+            __m128 lo = _mm_mul_ps(half, ease_in(t2, degree, a, b));
+            __m128 hi = _mm_sub_ps(one, _mm_mul_ps(half, ease_in(_mm_sub_ps(two, t2), degree, a, b)));
+            __m128 mask = _mm_cmplt_ps(t, half);
+            result = _mm_or_ps(_mm_and_ps(mask, lo), _mm_andnot_ps(mask, hi));
+        }
+        _mm_storeu_ps(out+ii, result);
+    }
+#elif defined CU_MATH_VECTOR_NEON64
+    const float32x4_t one  = vdupq_n_f32(1.0f);
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    const float32x4_t two  = vdupq_n_f32(2.0f);
+    const float32x4_t a = vdupq_n_f32(slope);
+    const float32x4_t b = vdupq_n_f32(offset);
+    for(; ii+4 <= size; ii += 4) {
+        float32x4_t t = vld1q_f32(time+ii);
+        float32x4_t result;
+        if (mode == EASE_IN) {
+            result = ease_in(t, degree, a, b);
+        } else if (mode == EASE_OUT) {
+            result = vsubq_f32(one, ease_in(vsubq_f32(one, t), degree, a, b));
+        } else {
+            float32x4_t t2 = vmulq_f32(two, t);
+            float32x4_t lo = vmulq_f32(half, ease_in(t2, degree, a, b));
+            float32x4_t hi = vsubq_f32(one, vmulq_f32(half, ease_in(vsubq_f32(two, t2), degree, a, b)));
+            result = vbslq_f32(vcltq_f32(t, half), lo, hi);
+        }
+        vst1q_f32(out+ii, result);
+    }
+#else
+    // The coefficients are only used by the vectorized loops
+    (void)degree;
+    (void)slope;
+    (void)offset;
+    (void)mode;
+#endif
+    evaluate_each<T>(time+ii, out+ii, size-ii, 0);
+}
+
+#pragma mark -
+#pragma mark Easing Support
+
 /**
  * Returns an easing function of the given type.
  *
@@ -116,18 +271,126 @@ std::function<float(float)> EasingFunction::alloc(Type type, float period) {
 }
 
 /**
- * Returns an adjustment of the tweening time
+ * Stores the value of the easing function at each of the given times.
  *
- * This is a linear easing function (the default)
+ * The easing function is chosen once for the entire array, and the inner
+ * loop is specialized for that function. The polynomial functions (and
+ * the back functions) are evaluated four at a time with SSE or NEON when
+ * CUGL is vectorized. The arrays time and out may be the same.
  *
- * @param time  The time in seconds.
+ * The optional value period only applies to elastic easing functions, as
+ * their bounce factor is adjustable.
  *
- * @return An adjustment of the tweening time
+ * @param type      The easing function type
+ * @param time      The array of times in seconds
+ * @param out       The array to store the results
+ * @param size      The number of times to evaluate
+ * @param period    The period of an elastic easing function
  */
-float EasingFunction::linear(float time) {
-    return time;
+void EasingFunction::evaluate(Type type, const float* time, float* out, size_t size, float period) {
+    switch(type) {
+    case Type::LINEAR:
+        evaluate_each<Type::LINEAR>(time, out, size, period);
+        break;
+    case Type::SINE_IN:
+        evaluate_each<Type::SINE_IN>(time, out, size, period);
+        break;
+    case Type::SINE_OUT:
+        evaluate_each<Type::SINE_OUT>(time, out, size, period);
+        break;
+    case Type::SINE_IN_OUT:
+        evaluate_each<Type::SINE_IN_OUT>(time, out, size, period);
+        break;
+    case Type::QUAD_IN:
+        evaluate_polynomial<Type::QUAD_IN>(time, out, size, 2, 1, 0, EASE_IN);
+        break;
+    case Type::QUAD_OUT:
+        evaluate_polynomial<Type::QUAD_OUT>(time, out, size, 2, 1, 0, EASE_OUT);
+        break;
+    case Type::QUAD_IN_OUT:
+        evaluate_polynomial<Type::QUAD_IN_OUT>(time, out, size, 2, 1, 0, EASE_IN_OUT);
+        break;
+    case Type::CUBIC_IN:
+        evaluate_polynomial<Type::CUBIC_IN>(time, out, size, 3, 1, 0, EASE_IN);
+        break;
+    case Type::CUBIC_OUT:
+        evaluate_polynomial<Type::CUBIC_OUT>(time, out, size, 3, 1, 0, EASE_OUT);
+        break;
+    case Type::CUBIC_IN_OUT:
+        evaluate_polynomial<Type::CUBIC_IN_OUT>(time, out, size, 3, 1, 0, EASE_IN_OUT);
+        break;
+    case Type::QUART_IN:
+        evaluate_polynomial<Type::QUART_IN>(time, out, size, 4, 1, 0, EASE_IN);
+        break;
+    case Type::QUART_OUT:
+        evaluate_polynomial<Type::QUART_OUT>(time, out, size, 4, 1, 0, EASE_OUT);
+        break;
+    case Type::QUART_IN_OUT:
+        evaluate_polynomial<Type::QUART_IN_OUT>(time, out, size, 4, 1, 0, EASE_IN_OUT);
+        break;
+    case Type::QUINT_IN:
+        evaluate_polynomial<Type::QUINT_IN>(time, out, size, 5, 1, 0, EASE_IN);
+        break;
+    case Type::QUINT_OUT:
+        evaluate_polynomial<Type::QUINT_OUT>(time, out, size, 5, 1, 0, EASE_OUT);
+        break;
+    case Type::QUINT_IN_OUT:
+        evaluate_polynomial<Type::QUINT_IN_OUT>(time, out, size, 5, 1, 0, EASE_IN_OUT);
+        break;
+    case Type::EXPO_IN:
+        evaluate_each<Type::EXPO_IN>(time, out, size, period);
+        break;
+    case Type::EXPO_OUT:
+        evaluate_each<Type::EXPO_OUT>(time, out, size, period);
+        break;
+    case Type::EXPO_IN_OUT:
+        evaluate_each<Type::EXPO_IN_OUT>(time, out, size, period);
+        break;
+    case Type::CIRC_IN:
+        evaluate_each<Type::CIRC_IN>(time, out, size, period);
+        break;
+    case Type::CIRC_OUT:
+        evaluate_each<Type::CIRC_OUT>(time, out, size, period);
+        break;
+    case Type::CIRC_IN_OUT:
+        evaluate_each<Type::CIRC_IN_OUT>(time, out, size, period);
+        break;
+    case Type::BACK_IN:
+        evaluate_polynomial<Type::BACK_IN>(time, out, size, 3, BACK_OVERSHOOT+1,
+                                           BACK_OVERSHOOT, EASE_IN);
+        break;
+    case Type::BACK_OUT:
+        evaluate_polynomial<Type::BACK_OUT>(time, out, size, 3, BACK_OVERSHOOT+1,
+                                            BACK_OVERSHOOT, EASE_OUT);
+        break;
+    case Type::BACK_IN_OUT:
+        evaluate_polynomial<Type::BACK_IN_OUT>(time, out, size, 3, BACK_OVERSHOOT_IN_OUT+1,
+                                               BACK_OVERSHOOT_IN_OUT, EASE_IN_OUT);
+        break;
+    case Type::BOUNCE_IN:
+        evaluate_each<Type::BOUNCE_IN>(time, out, size, period);
+        break;
+    case Type::BOUNCE_OUT:
+        evaluate_each<Type::BOUNCE_OUT>(time, out, size, period);
+        break;
+    case Type::BOUNCE_IN_OUT:
+        evaluate_each<Type::BOUNCE_IN_OUT>(time, out, size, period);
+        break;
+    case Type::ELASTIC_IN:
+        evaluate_each<Type::ELASTIC_IN>(time, out, size, period);
+        break;
+    case Type::ELASTIC_OUT:
+        evaluate_each<Type::ELASTIC_OUT>(time, out, size, period);
+        break;
+    case Type::ELASTIC_IN_OUT:
+        evaluate_each<Type::ELASTIC_IN_OUT>(time, out, size, period);
+        break;
+    }
 }
 
+#pragma mark -
+#pragma mark Easing Functions
+
 /**
  * Returns an adjustment of the tweening time
  *
@@ -168,189 +431,6 @@ float EasingFunction::sineInOut(float time) {
     return -0.5f * (cosf((float)M_PI * time) - 1);
 }
 
-/**
- * Returns an adjustment of the tweening time
- *
- * This is a quadratic polynomial with an asymptotic start at t=0.
- *
- * @param time  The time in seconds.
- *
- * @return An adjustment of the tweening time
- */
-float EasingFunction::quadIn(float time) {
-    return time * time;
-}
-
-/**
- * Returns an adjustment of the tweening time
- *
- * This is a quadratic polynomial with an asymptotic finish at t=1.
- *
- * @param time  The time in seconds.
- *
- * @return An adjustment of the tweening time
- */
-float EasingFunction::quadOut(float time) {
-    return -1 * time * (time - 2);
-}
-
-/**
- * Returns an adjustment of the tweening time
- *
- * This is a concatenation of the {@link quadIn(float)} and {@link quadOut(float)}
- * easing functions.
- *
- * @param time  The time in seconds.
- *
- * @return An adjustment of the tweening time
- */
-float EasingFunction::quadInOut(float time) {
-    time = time*2;
-    if (time < 1) {
-        return 0.5f * time * time;
-    }
-    --time;
-    return -0.5f * (time * (time - 2) - 1);
-}
-
-/**
- * Returns an adjustment of the tweening time
- *
- * This is a cubic polynomial with an asymptotic start at t=0.
- *
- * @param time  The time in seconds.
- *
- * @return An adjustment of the tweening time
- */
-float EasingFunction::cubicIn(float time) {
-    return time * time * time;
-}
-
-/**
- * Returns an adjustment of the tweening time
- *
- * This is a cubic polynomial with an asymptotic finish at t=1.
- *
- * @param time  The time in seconds.
- *
- * @return An adjustment of the tweening time
- */
-float EasingFunction::cubicOut(float time) {
-    time -= 1;
-    return (time * time * time + 1);
-}
-
-/**
- * Returns an adjustment of the tweening time
- *
- * This is a concatenation of the {@link cubicIn(float)} and {@link cubicOut(float)}
- * easing functions.
- *
- * @param time  The time in seconds.
- *
- * @return An adjustment of the tweening time
- */
-float EasingFunction::cubicInOut(float time) {
-    time = time*2;
-    if (time < 1) {
-        return 0.5f * time * time * time;
-    }
-    time -= 2;
-    return 0.5f * (time * time * time + 2);
-}
-
-/**
- * Returns an adjustment of the tweening time
- *
- * This is a fourth-degree polynomial with an asymptotic start at t=0.
- *
- * @param time  The time in seconds.
- *
- * @return An adjustment of the tweening time
- */
-float EasingFunction::quartIn(float time) {
-    return time * time * time * time;
-}
-
-/**
- * Returns an adjustment of the tweening time
- *
- * This is a fourth-degree polynomial with an asymptotic finish at t=1.
- *
- * @param time  The time in seconds.
- *
- * @return An adjustment of the tweening time
- */
-float EasingFunction::quartOut(float time) {
-    time -= 1;
-    return -(time * time * time * time - 1);
-}
-
-/**
- * Returns an adjustment of the tweening time
- *
- * This is a concatenation of the {@link quartIn(float)} and {@link quartOut(float)}
- * easing functions.
- *
- * @param time  The time in seconds.
- *
- * @return An adjustment of the tweening time
- */
-float EasingFunction::quartInOut(float time) {
-    time = time*2;
-    if (time < 1) {
-        return 0.5f * time * time * time * time;
-    }
-    time -= 2;
-    return -0.5f * (time * time * time * time - 2);
-}
-
-/**
- * Returns an adjustment of the tweening time
- *
- * This is a fifth-degree polynomial with an asymptotic start at t=0.
- *
- * @param time  The time in seconds.
- *
- * @return An adjustment of the tweening time
- */
-float EasingFunction::quintIn(float time) {
-    return time * time * time * time * time;
-}
-
-/**
- * Returns an adjustment of the tweening time
- *
- * This is a fifth-degree polynomial with an asymptotic finish at t=1.
- *
- * @param time  The time in seconds.
- *
- * @return An adjustment of the tweening time
- */
-float EasingFunction::quintOut(float time) {
-    time -=1;
-    return (time * time * time * time * time + 1);
-}
-
-/**
- * Returns an adjustment of the tweening time
- *
- * This is a concatenation of the {@link quintIn(float)} and {@link quintOut(float)}
- * easing functions.
- *
- * @param time  The time in seconds.
- *
- * @return An adjustment of the tweening time
- */
-float EasingFunction::quintInOut(float time) {
-    time = time*2;
-    if (time < 1) {
-        return 0.5f * time * time * time * time * time;
-    }
-    time -= 2;
-    return 0.5f * (time * time * time * time * time + 2);
-}
-
 /**
  * Returns an adjustment of the tweening time
  *
@@ -444,118 +524,6 @@ float EasingFunction::circInOut(float time) {
     return 0.5f * (sqrt(1 - time * time) + 1);
 }
 
-/**
- * Returns an adjustment of the tweening time
- *
- * This is an easing function that briefly dips below t=0 after the start.
- *
- * @param time  The time in seconds.
- *
- * @return An adjustment of the tweening time
- */
-float EasingFunction::backIn(float time) {
-    float overshoot = 1.70158f;
-    return time * time * ((overshoot + 1) * time - overshoot);
-}
-
-/**
- * Returns an adjustment of the tweening time
- *
- * This is an easing function that briefly rises above t=1 before the finish.
- *
- * @param time  The time in seconds.
- *
- * @return An adjustment of the tweening time
- */
-float EasingFunction::backOut(float time) {
-    float overshoot = 1.70158f;
-    time = time - 1;
-    return time * time * ((overshoot + 1) * time + overshoot) + 1;
-}
-
-/**
- * Returns an adjustment of the tweening time
- *
- * This is a concatenation of the {@link backIn(float)} and {@link backOut(float)}
- * easing functions.
- *
- * @param time  The time in seconds.
- *
- * @return An adjustment of the tweening time
- */
-float EasingFunction::backInOut(float time) {
-    float overshoot = 1.70158f * 1.525f;
-    
-    time = time * 2;
-    if (time < 1) {
-        return (time * time * ((overshoot + 1) * time - overshoot)) / 2;
-    } else {
-        time = time - 2;
-        return (time * time * ((overshoot + 1) * time + overshoot)) / 2 + 1;
-    }
-}
-
-/**
- * Returns an adjustment of the tweening time
- *
- * This is an easing function that bounces down to t=0 several times after the
- * start.
- *
- * @param time  The time in seconds.
- *
- * @return An adjustment of the tweening time
- */
-float EasingFunction::bounceIn(float time) {
-    return 1 - bounceOut(1 - time);
-}
-
-/**
- * Returns an adjustment of the tweening time
- *
- * This is an easing function that bounces up to t=1 several times before the
- * finish.
- *
- * @param time  The time in seconds.
- *
- * @return An adjustment of the tweening time
- */
-float EasingFunction::bounceOut(float time) {
-    if (time < 1 / 2.75) {
-        return 7.5625f * time * time;
-    } else if (time < 2 / 2.75) {
-        time -= 1.5f / 2.75f;
-        return 7.5625f * time * time + 0.75f;
-    } else if(time < 2.5 / 2.75) {
-        time -= 2.25f / 2.75f;
-        return 7.5625f * time * time + 0.9375f;
-    }
-    
-    time -= 2.625f / 2.75f;
-    return 7.5625f * time * time + 0.984375f;
-}
-
-/**
- * Returns an adjustment of the tweening time
- *
- * This is a concatenation of the {@link bounceIn(float)} and {@link bounceOut(float)}
- * easing functions.
- *
- * @param time  The time in seconds.
- *
- * @return An adjustment of the tweening time
- */
-float EasingFunction::bounceInOut(float time) {
-    float result = 0;
-    if (time < 0.5f) {
-        time = time * 2;
-        result = (1 - bounceOut(1 - time)) * 0.5f;
-    } else {
-        result = bounceOut(time * 2 - 1) * 0.5f + 0.5f;
-    }
-    
-    return result;
-}
-
 /**
  * Returns an adjustment of the tweening time
  *
@@ -36,10 +36,132 @@
 #include <cugl/math/CUGeometry.h>
 #include <cugl/math/polygon/CUSimpleTriangulator.h>
 #include <cugl/util/CUDebug.h>
-#include <unordered_map>
 
 using namespace cugl;
 
+/** The number of bits in each digit of the edge radix sort */
+#define RADIX_BITS  13
+/** The number of buckets in each pass of the edge radix sort */
+#define RADIX_SIZE  (1 << RADIX_BITS)
+/** The largest vertex index bound that fits in an edge key */
+#define EDGE_BOUND  0x7FFFFFFFU
+
+#pragma mark -
+#pragma mark Edge Tables
+/**
+ * Sorts the keys in ascending order with a least-significant-digit radix sort
+ *
+ * Only the given number of low bits are sorted, so the number of passes
+ * depends on the largest key and not the type. The scratch buffer is
+ * resized to match the keys, and may be reused across calls.
+ *
+ * @param keys      The keys to sort
+ * @param scratch   The scratch buffer for each pass
+ * @param bits      The number of significant bits in each key
+ */
+static void radix_sort(std::vector<Uint64>& keys, std::vector<Uint64>& scratch, int bits) {
+    std::vector<size_t> count(RADIX_SIZE);
+    scratch.resize(keys.size());
+    for(int shift = 0; shift < bits; shift += RADIX_BITS) {
+        std::fill(count.begin(), count.end(), 0);
+        for(auto it = keys.begin(); it != keys.end(); ++it) {
+            count[(*it >> shift) & (RADIX_SIZE-1)]++;
+        }
+        size_t total = 0;
+        for(size_t ii = 0; ii < RADIX_SIZE; ii++) {
+            size_t amt = count[ii];
+            count[ii] = total;
+            total += amt;
+        }
+        for(auto it = keys.begin(); it != keys.end(); ++it) {
+            scratch[count[(*it >> shift) & (RADIX_SIZE-1)]++] = *it;
+        }
+        keys.swap(scratch);
+    }
+}
+
+/**
+ * Returns one more than the largest index in the given array
+ *
+ * @param indices   The indices to process
+ * @param size      The index size
+ *
+ * @return one more than the largest index in the given array
+ */
+static Uint32 index_bound(const Uint32* indices, size_t size) {
+    Uint32 bound = 0;
+    for(size_t ii = 0; ii < size; ii++) {
+        bound = std::max(bound, indices[ii]+1);
+    }
+    return bound;
+}
+
+/**
+ * Stores the boundary edges of the triangle mesh in the given arrays
+ *
+ * A boundary edge is an edge that belongs to exactly one triangle. Each
+ * edge is stored as a pair from[i] -> to[i], oriented as it appears in its
+ * triangle. Degenerate triangles are ignored.
+ *
+ * Every edge of the mesh is encoded as a 64-bit key of its (sorted) end
+ * points, with the lowest bit recording the orientation. These keys are
+ * radix sorted so that the copies of an edge are adjacent. This requires
+ * no hashing and no allocation per edge.
+ *
+ * @param indices   The triangle mesh indices
+ * @param size      The index size
+ * @param bound     One more than the largest index
+ * @param from      The array to store the edge starts
+ * @param to        The array to store the edge ends
+ */
+static void boundary_edges(const Uint32* indices, size_t size, Uint32 bound,
+                           std::vector<Uint32>& from, std::vector<Uint32>& to) {
+    CUAssertLog(bound <= EDGE_BOUND, "The index %u is too large for an edge table", bound-1);
+    from.clear();
+    to.clear();
+
+    std::vector<Uint64> keys;
+    keys.reserve(size);
+    for(size_t ii = 0; ii+2 < size; ii += 3) {
+        const Uint32* tri = indices+ii;
+        if (tri[0] == tri[1] || tri[1] == tri[2] || tri[2] == tri[0]) {
+            continue;
+        }
+        for(int jj = 0; jj < 3; jj++) {
+            Uint32 a = tri[jj];
+            Uint32 b = tri[(jj+1) % 3];
+            Uint64 edge = a < b ? (Uint64)a*bound+b : (Uint64)b*bound+a;
+            keys.push_back(edge << 1 | (a > b ? 1 : 0));
+        }
+    }
+
+    int bits = 1;
+    while (bits < 64 && ((Uint64)bound*bound << 1) > ((Uint64)1 << bits)) {
+        bits++;
+    }
+    std::vector<Uint64> scratch;
+    radix_sort(keys, scratch, bits);
+
+    for(size_t ii = 0; ii < keys.size(); ) {
+        size_t jj = ii+1;
+        while (jj < keys.size() && (keys[jj] >> 1) == (keys[ii] >> 1)) {
+            jj++;
+        }
+        if (jj == ii+1) {
+            Uint64 edge = keys[ii] >> 1;
+            Uint32 a = (Uint32)(edge / bound);
+            Uint32 b = (Uint32)(edge % bound);
+            if (keys[ii] & 1) {
+                std::swap(a,b);
+            }
+            from.push_back(a);
+            to.push_back(b);
+        }
+        ii = jj;
+    }
+}
+
+
 #pragma mark Matching
 /**
  * Returns the OpenGL drawing code for this geometry
@@ -307,90 +429,72 @@ std::vector<Uint32> Geometry::index(const float* vertices, size_t size) const {
 #pragma mark -
 #pragma mark Boundary Extraction
 /**
- * Returns the set of indices that are on a boundary of this geometry
+ * Returns the indices that are on a boundary of this geometry
  *
  * This method is really only relevant for {@link #SOLID} geometry. For other
- * geometries, it simply returns a set of the indices.  In the case of solid
+ * geometries, it simply returns the distinct indices.  In the case of solid
  * geometries, it identifies the outer hull (not necessarily convex).
  *
- * This method can identify the outer hull using the graph properties of the
- * triangle mesh. An internal node if the number of neighbors is the same as
- * the number of attached triangles. An index that is not internal is external.
+ * This method identifies the outer hull using the edges of the triangle
+ * mesh. An edge is a boundary edge if it belongs to exactly one triangle,
+ * and an index is external if it is on a boundary edge. The edges are
+ * found with a radix sort, so this method is linear in the mesh size.
  *
  * Unlike {@link #boundaries}, this method does not order the boundary indices
- * or decompose them into connected components.
+ * or decompose them into connected components. The indices are returned
+ * in ascending order with no duplicates.
  *
  * @param indices   The indices to process
  *
- * @return the set of indices that are on a boundary of this geometry
+ * @return the indices that are on a boundary of this geometry
  */
-std::unordered_set<Uint32> Geometry::exterior(const std::vector<Uint32> indices) const {
+std::vector<Uint32> Geometry::exterior(const std::vector<Uint32>& indices) const {
     return exterior(indices.data(),indices.size());
 }
     
 /**
- * Returns the set of indices that are on a boundary of this geometry
+ * Returns the indices that are on a boundary of this geometry
  *
  * This method is really only relevant for {@link #SOLID} geometry. For other
- * geometries, it simply returns a set of the indices.  In the case of solid
+ * geometries, it simply returns the distinct indices.  In the case of solid
  * geometries, it identifies the outer hull (not necessarily convex).
  *
- * This method can identify the outer hull using the graph properties of the
- * triangle mesh. An internal node if the number of neighbors is the same as
- * the number of attached triangles. An index that is not internal is external.
+ * This method identifies the outer hull using the edges of the triangle
+ * mesh. An edge is a boundary edge if it belongs to exactly one triangle,
+ * and an index is external if it is on a boundary edge. The edges are
+ * found with a radix sort, so this method is linear in the mesh size.
  *
  * Unlike {@link #boundaries}, this method does not order the boundary indices
- * or decompose them into connected components.
+ * or decompose them into connected components. The indices are returned
+ * in ascending order with no duplicates.
  *
  * @param indices   The indices to process
  * @param size      The index size
  *
- * @return the set of indices that are on a boundary of this geometry
+ * @return the indices that are on a boundary of this geometry
  */
-std::unordered_set<Uint32> Geometry::exterior(const Uint32* indices, size_t size) const {
-    std::unordered_set<Uint32> result;
+std::vector<Uint32> Geometry::exterior(const Uint32* indices, size_t size) const {
+    Uint32 bound = index_bound(indices,size);
+    std::vector<Uint8> marks(bound,0);
     if (_value != Geometry::SOLID) {
-        result.reserve(size);
         for(size_t ii = 0; ii < size; ii++) {
-            result.emplace(indices[ii]);
+            marks[indices[ii]] = 1;
         }
-        return result;
-    }
-
-    std::unordered_map<Uint32,std::unordered_set<Uint32>*> neighbors;
-    std::unordered_map<Uint32,Uint32> count;
-    for(int ii = 0; ii < size; ii += 3) {
-        for(int jj = 0; jj < 3; jj++) {
-            Uint32 indx = indices[ii+jj];
-            auto search = neighbors.find(indx);
-            std::unordered_set<Uint32>* slot = nullptr;
-            if (search == neighbors.end()) {
-                slot = new std::unordered_set<Uint32>();
-                neighbors[indx] = slot;
-                count[indx] = 0;
-            } else {
-                slot = search->second;
-            }
-
-            slot->emplace( indices[ii+((jj+1) % 3)] );
-            slot->emplace( indices[ii+((jj+2) % 3)] );
-            count[indx] = count[indx]+1;
+    } else {
+        std::vector<Uint32> from, to;
+        boundary_edges(indices, size, bound, from, to);
+        for(size_t ii = 0; ii < from.size(); ii++) {
+            marks[from[ii]] = 1;
+            marks[to[ii]] = 1;
         }
     }
 
-    result.reserve(size);
-    for(size_t ii = 0; ii < size; ii++) {
-        Uint32 indx = indices[ii];
-        if (neighbors[indx]->size() > count[indx]) {
-            result.emplace(indx);
+    std::vector<Uint32> result;
+    for(Uint32 ii = 0; ii < bound; ii++) {
+        if (marks[ii]) {
+            result.push_back(ii);
         }
     }
-    
-    // Clean up
-    for(auto it = neighbors.begin(); it != neighbors.end(); ++it) {
-        delete it->second;
-        it->second = nullptr;
-    }
     return result;
 }
 
@@ -529,312 +633,71 @@ std::vector<std::vector<Uint32>> Geometry::boundaries(const Uint32* indices, siz
  * as a separate boundary.  There is no guarantee on the order of boundaries
  * returned.
  *
+ * The boundary edges are found by radix sorting a flat table of the mesh
+ * edges, and are then linked through a contiguous adjacency table. Each
+ * boundary follows the orientation of the triangles, so the mesh should
+ * be consistently oriented. There is no allocation per triangle.
+ *
  * @param indices   The indices to process
  * @param size      The index size
  *
  * @return a detriangulation of this mesh
  */
 std::vector<std::vector<Uint32>> Geometry::detriangulate(const Uint32* indices, size_t size) const {
-    // Create the decomposition
-    std::unordered_map<std::string,TreeNode*> decomp;
-    for(int ii = 0; ii < size; ii += 3) {
-        std::string key = TreeNode::toString(indices[ii],indices[ii+1],indices[ii+2]);
-        auto search = decomp.find(key);
-        if (search == decomp.end()) {
-            TreeNode* current = new TreeNode(indices[ii],indices[ii+1],indices[ii+2]);
-            for(auto it = decomp.begin(); it != decomp.end(); ++it) {
-                TreeNode* node = it->second;
-                if (node->adjacent( current )) {
-                    node->neighbors.emplace( current );
-                    current->neighbors.emplace(node);
-                }
-            }
-            decomp[key] = current;
-        }
-    }
-    
-    // Create arrays for the result and to track our progress
     std::vector<std::vector<Uint32>> result;
-    std::unordered_set<Uint32> inuse;
-    std::unordered_set<Uint32> total;
-    for(size_t ii = 0; ii < size; ii++) {
-        total.emplace(indices[ii]);
+    Uint32 bound = index_bound(indices,size);
+    std::vector<Uint32> from, to;
+    boundary_edges(indices, size, bound, from, to);
+    if (from.empty()) {
+        return result;
     }
-    
-    // Keep going until all boundaries found
-    result.push_back(std::vector<Uint32>());
-    std::vector<Uint32>* array = &result.back();
-    bool abort = false;
-    while (inuse.size() != total.size() && !abort) {
-        // Pick a valid (exterior) starting point at the correct position
-        TreeNode* current = nullptr;
-        int start = -1;
-        for(auto it = decomp.begin(); start == -1 && it != decomp.end(); ++it) {
-            TreeNode* node = it->second;
-            start = node->pick(inuse);
-            if (start != -1) {
-                current = node;
-            }
-        }
-        
-        // Self-crossings may allow a point to be reused, so we
-        // need a local "visited" set for each path.
-        std::unordered_set<Uint32> visited;
-        if (start != -1) {
-            // Follow the path until no more indices to pick
-            int index = start;
-            current = current->follow( index );
-            while (current != nullptr) {
-                visited.emplace( index );
-                array->push_back( index );
-                index = current->pick( visited );
-                current = current->follow( index );
-            }
-            // Add this to the global results
-            for(auto it = visited.begin(); it != visited.end(); ++it) {
-                inuse.emplace(*it);
-            }
-            result.push_back(std::vector<Uint32>());
-            array = &result.back();
 
-            // Reset the tree node internal state for next pass
-            if (inuse.size() != total.size()) {
-                for(auto it = decomp.begin(); it != decomp.end(); ++it) {
-                    it->second->previous = nullptr;
-                }
-            }
-        } else {
-            // All the indices found were internal
-            abort = true;
-        }
+    // Outgoing edges of each index, stored contiguously (offset[v] to offset[v+1])
+    size_t count = from.size();
+    std::vector<Uint32> offset(bound+1,0);
+    for(size_t ii = 0; ii < count; ii++) {
+        offset[from[ii]+1]++;
     }
-    
-    // Clean up the decomposition
-    for(auto it = decomp.begin(); it != decomp.end(); ++it) {
-        delete it->second;
-        it->second = nullptr;
-    }
-
-    return result;
-}
-
-/**
- * Returns the hash code for the given TreeNode
- *
- * @param node  The TreeNode to hash
- *
- * @return the hash code for the given TreeNode
- */
-std::size_t Geometry::TreeNode::TreeHasher::operator()(TreeNode* node) const {
-    size_t one = std::hash<int>()((node->elements)[0]) & 0xff;
-    size_t two = std::hash<int>()((node->elements)[1]) & 0xff;
-    size_t tre = std::hash<int>()((node->elements)[2]) & 0xff;
-    return (one | (two << 8) | (tre << 16));
-}
-
-/**
- * Creates a TreeNode from the given three elements.
- *
- * @param a The first element
- * @param b The second element
- * @param c The third element
- */
-Geometry::TreeNode::TreeNode(int a, int b, int c) {
-    elements[0] = std::min( a, std::min( b, c ) );
-    elements[2] = std::max( a, std::max( b, c ) );
-    elements[1] = a;
-    if (elements[0] == elements[1] || elements[2] == elements[1]) {
-        elements[1] = b;
+    for(Uint32 ii = 0; ii < bound; ii++) {
+        offset[ii+1] += offset[ii];
     }
-    if (elements[0] == elements[1] || elements[2] == elements[1]) {
-        elements[1] = c;
+    std::vector<Uint32> cursor(offset.begin(),offset.end()-1);
+    std::vector<Uint32> outgoing(count);
+    for(size_t ii = 0; ii < count; ii++) {
+        outgoing[cursor[from[ii]]++] = (Uint32)ii;
     }
-    CUAssertLog(elements[0] < elements[1] && elements[1] < elements[2],
-                "The triangle [%d, %d, %d] is degenerate.", a, b, c );
-}
+    std::copy(offset.begin(),offset.end()-1,cursor.begin());
 
-/**
- * Delets a TreeNode, destroying all resources.
- */
-Geometry::TreeNode::~TreeNode() {
-    // TreeNodes own nothing
-    neighbors.clear();
-    previous = nullptr;
-}
-            
-/**
- * Returns true if o is a TreeNode equal to this one
- *
- * Since TreeNode objects sort their contents, o must have its elements in
- * the same order as this on.
- *
- * @return true if o is a TreeNode equal to this one
- */
-bool Geometry::TreeNode::operator==(const TreeNode& o) const {
-    return elements[0] == o.elements[0] && elements[1] == o.elements[1] && elements[2] == o.elements[2];
-}
-            
-/**
- * Returns a string representation of this tree node
- *
- * @return a string representation of this tree node
- */
-std::string Geometry::TreeNode::toString() const {
-    char buff[100];
-    snprintf(buff, sizeof(buff), "[%d,%d,%d]", elements[0], elements[1], elements[2]);
-    std::string result = buff;
-    return result;
-}
-
-/**
- * Returns a string representation of a tree node with the given elements
- *
- * This method allows us to get the string of a tree node (from its contents)
- * without actually having to construct the tree node itself.  This is useful
- * for hashtable lookups.
- *
- * @param a The first element
- * @param b The second element
- * @param c The third element
- *
- * @return a string representation of a tree node with the given elements
- */
-std::string Geometry::TreeNode::toString(int a, int b, int c) {
-    int indx1 = std::min( a, std::min( b, c ) );
-    int indx3 = std::max( a, std::max( b, c ) );
-    int indx2 = a;
-    if (indx1 == indx2 || indx3 == indx2) {
-        indx2 = b;
-    }
-    if (indx1 == indx2 || indx3 == indx2) {
-        indx2 = c;
-    }
-    char buff[100];
-    snprintf(buff, sizeof(buff), "[%d,%d,%d]", indx1, indx2, indx3);
-    std::string result = buff;
-    return result;
-}
-            
-/**
- * Returns true if x is an element in this node
- *
- * @param x The element to check
- *
- * @return true if x is an element in this node
- */
-bool Geometry::TreeNode::contains(int x) const {
-    return x >= 0 && (elements[0] == x || elements[1] == x || elements[2] == x);
-}
-    
-/**
- * Returns true if node is adjacent to this one.
- *
- * A node is adjacent if it shares exactly one side.
- *
- * @param node  The node to check
- *
- * @return true if node is adjacent to this one.
- */
-bool Geometry::TreeNode::adjacent(const TreeNode* node) const {
-    int count = 0;
-    for (int ii = 0; ii < 3; ii++) {
-        count += contains( node->elements[ii] ) ? 1 : 0;
-    }
-    return count == 2;
-}
-    
-/**
- * Returns a boundary index from the node, not in inuse
- *
- * A boundary index is either one that does not appear in any
- * of its neighbors (so this is an ear in a triangulation) or
- * only appears in one neighbor (so this is the either the first
- * or last triangle with this index in a normal traversal).
- *
- * If no boundary index can be found, or they are all already
- * in inuse, this method returns -1.
- *
- * @param inuse The indices to exclude from the search
- *
- * @return a boundary index from the node, not in inuse
- */
-Uint32 Geometry::TreeNode::pick(const std::unordered_set<Uint32>& inuse) const {
-    int count[3];
-    for (auto it = neighbors.begin(); it != neighbors.end(); ++it) {
-        TreeNode* node = *it;
-        for (int ii = 0; ii < 3; ii++) {
-            if (node->contains( elements[ii] )) {
-                    count[ii]++;
-            }
-        }
-    }
-    
-    int ptr = -1;
-    for (int ii = 0; ii < 3; ii++) {
-        if ((count[ii] == 0 || count[ii] == 1)) {
-            if (inuse.find(elements[ii]) != inuse.end()) {
-                if (ptr == -1) {
-                    ptr = ii;
-                } else if (count[ii] < count[ptr]) {
-                    ptr = ii;
-                }
-            }
+    // Link the edges into boundaries
+    std::vector<Uint8> used(count,0);
+    for(size_t start = 0; start < count; start++) {
+        if (used[start]) {
+            continue;
         }
-    }
-    
-    return ptr != -1 ? elements[ptr] : -1;
-}
-            
-/**
- * Returns the opposite transition point for the given index.
- *
- * A transition point is a node that contains index and for which index is
- * a boundary value (either it has no neighbors with the same index or only
- * one neighbor).  It represents the first and/or last triangle with this
- * index in a normal traversal.
- *
- * If there is only one triangle with this index, this method returns this
- * node.  Otherwise, if this node corresponds to the first triangle, it
- * returns the last, and vice versa.  By following indices, we create a
- * traversal that can find an exterior boundary.
- *
- * @param index The index defining the traversal
- *
- * @return the opposite transition point for the given index.
- */
-Geometry::TreeNode* Geometry::TreeNode::follow(Uint32 index) {
-    previous = nullptr;
-    return crawl( index );
-}
 
-/**
- * Returns the opposite transition point for the given index.
- *
- * This method is the recursive helper for {@link #follow}. It uses
- * the internal previous attribute to track direction.
- *
- * @param index The index defining the traversal
- *
- * @return the opposite transition point for the given index.
- */
-Geometry::TreeNode* Geometry::TreeNode::crawl(int index) {
-    if (!contains(index)) {
-        return nullptr;
-    }
+        result.push_back(std::vector<Uint32>());
+        std::vector<Uint32>* array = &result.back();
+        Uint32 edge = (Uint32)start;
+        while (true) {
+            used[edge] = 1;
+            array->push_back(from[edge]);
+            Uint32 next = to[edge];
+            if (next == from[start]) {
+                break;
+            }
 
-    TreeNode* next = nullptr;
-    for (auto it = neighbors.begin(); it != neighbors.end(); ++it) {
-        TreeNode* node = *it;
-        if (node != previous && node->contains( index )) {
-            next = node;
+            // Skip edges taken by an earlier boundary through this index
+            Uint32& pos = cursor[next];
+            while (pos < offset[next+1] && used[outgoing[pos]]) {
+                pos++;
+            }
+            if (pos == offset[next+1]) {
+                // Inconsistent orientation leaves an open chain
+                array->push_back(next);
+                break;
+            }
+            edge = outgoing[pos];
         }
     }
-
-    if (next == nullptr) {
-        return this;
-    } else if (next->previous == this) {
-        return nullptr;
-    }
-    next->previous = this;
-    return next->crawl( index );
+    return result;
 }
@@ -2751,6 +2751,150 @@ float* Mat4::transform(const float* mat, float const* input, float* output, size
     return output;
 }
 
+/**
+ * Transforms the strided 2d point array, and stores the result in output.
+ *
+ * Each point is the first two floats of a record that is instride floats
+ * wide (outstride for the output).  The points are treated as having z=0,
+ * so only the 2d sub-block (and translation) of the matrix is applied.
+ * Only the x and y values of each output record are written.  This is
+ * the same as {@link Affine2#transform} for the equivalent affine
+ * transform, and it is much faster than transforming each {@link Vec2}
+ * separately.
+ *
+ * The input and output may be the same array, provided that the strides
+ * are the same. Otherwise the arrays must not overlap.
+ *
+ * @param mat       The transform matrix.
+ * @param input     The array of points to transform.
+ * @param instride  The number of floats between consecutive input points.
+ * @param output    The array to store the transformed points.
+ * @param outstride The number of floats between consecutive output points.
+ * @param size      The number of points to transform.
+ *
+ * @return A reference to output for chaining
+ */
+float* Mat4::transform2(const Mat4& mat, float const* input, size_t instride,
+                        float* output, size_t outstride, size_t size) {
+    Affine2 aff;
+    aff.m[0] = mat.m[0];  aff.m[1] = mat.m[1];
+    aff.m[2] = mat.m[4];  aff.m[3] = mat.m[5];
+    aff.m[4] = mat.m[12]; aff.m[5] = mat.m[13];
+    return Affine2::transform(aff, input, instride, output, outstride, size);
+}
+
+/**
+ * Transforms the strided 3d point array, and stores the result in output.
+ *
+ * Each point is the first three floats of a record that is instride
+ * floats wide (outstride for the output).  This allows the transform to
+ * be applied directly to the position field of an interleaved vertex
+ * array, such as {@link SpriteVertex3}. As with {@link Vec3} points, the
+ * w value is 1 and is not divided out.  Only the x, y, and z values of
+ * each output record are written.
+ *
+ * The points are transformed four at a time (with SSE or Neon when the
+ * vectorized math library is enabled).  The input and output may be the
+ * same array, provided that the strides are the same. Otherwise the
+ * arrays must not overlap.
+ *
+ * @param mat       The transform matrix.
+ * @param input     The array of points to transform.
+ * @param instride  The number of floats between consecutive input points.
+ * @param output    The array to store the transformed points.
+ * @param outstride The number of floats between consecutive output points.
+ * @param size      The number of points to transform.
+ *
+ * @return A reference to output for chaining
+ */
+float* Mat4::transform3(const Mat4& mat, float const* input, size_t instride,
+                        float* output, size_t outstride, size_t size) {
+    CUAssertLog(output, "Destination array is null");
+    CUAssertLog(instride >= 3 && outstride >= 3, "Strides must be at least 3");
+    const float* m = mat.m;
+    
+    // Each block reads all four points before writing any, so in place is safe
+    size_t ii = 0;
+#if defined CU_MATH_VECTOR_SSE
+    __m128 r[12];
+    for(int jj = 0; jj < 12; jj++) {
+        r[jj] = _mm_set1_ps(m[(jj/3)*4+(jj%3)]);
+    }
+    for(; ii+4 <= size; ii += 4) {
+        const float* src = input+ii*instride;
+        __m128 xs = _mm_setr_ps(src[0],src[instride],  src[2*instride],  src[3*instride]);
+        __m128 ys = _mm_setr_ps(src[1],src[instride+1],src[2*instride+1],src[3*instride+1]);
+        __m128 zs = _mm_setr_ps(src[2],src[instride+2],src[2*instride+2],src[3*instride+2]);
+        
+        __attribute__((__aligned__(16))) float temp[12];
+        for(int jj = 0; jj < 3; jj++) {
+            __m128 v = _mm_add_ps(_mm_mul_ps(r[jj],xs),_mm_mul_ps(r[jj+3],ys));
+            v = _mm_add_ps(v,_mm_add_ps(_mm_mul_ps(r[jj+6],zs),r[jj+9]));
+            _mm_store_ps(temp+4*jj,v);
+        }
+        
+        float* dst = output+ii*outstride;
+        for(size_t jj = 0; jj < 4; jj++) {
+            dst[jj*outstride  ] = temp[jj];
+            dst[jj*outstride+1] = temp[jj+4];
+            dst[jj*outstride+2] = temp[jj+8];
+        }
+    }
+#elif defined CU_MATH_VECTOR_NEON64
+    float32x4_t r[12];
+    for(int jj = 0; jj < 12; jj++) {
+        r[jj] = vdupq_n_f32(m[(jj/3)*4+(jj%3)]);
+    }
+    for(; ii+4 <= size; ii += 4) {
+        const float* src = input+ii*instride;
+        float32x4x3_t pts;
+        if (instride == 3) {
+            pts = vld3q_f32(src);
+        } else {
+            __attribute__((__aligned__(16))) float temp[12];
+            for(size_t jj = 0; jj < 4; jj++) {
+                temp[jj]   = src[jj*instride];
+                temp[jj+4] = src[jj*instride+1];
+                temp[jj+8] = src[jj*instride+2];
+            }
+            pts.val[0] = vld1q_f32(temp);
+            pts.val[1] = vld1q_f32(temp+4);
+            pts.val[2] = vld1q_f32(temp+8);
+        }
+        float32x4x3_t res;
+        for(int jj = 0; jj < 3; jj++) {
+            float32x4_t v = vmlaq_f32(r[jj+9],r[jj],pts.val[0]);
+            v = vmlaq_f32(v,r[jj+3],pts.val[1]);
+            res.val[jj] = vmlaq_f32(v,r[jj+6],pts.val[2]);
+        }
+        
+        float* dst = output+ii*outstride;
+        if (outstride == 3) {
+            vst3q_f32(dst,res);
+        } else {
+            __attribute__((__aligned__(16))) float temp[12];
+            vst1q_f32(temp,  res.val[0]);
+            vst1q_f32(temp+4,res.val[1]);
+            vst1q_f32(temp+8,res.val[2]);
+            for(size_t jj = 0; jj < 4; jj++) {
+                dst[jj*outstride  ] = temp[jj];
+                dst[jj*outstride+1] = temp[jj+4];
+                dst[jj*outstride+2] = temp[jj+8];
+            }
+        }
+    }
+#endif
+    for(; ii < size; ii++) {
+        float x = input[ii*instride];
+        float y = input[ii*instride+1];
+        float z = input[ii*instride+2];
+        output[ii*outstride  ] = m[0]*x+m[4]*y+m[8] *z+m[12];
+        output[ii*outstride+1] = m[1]*x+m[5]*y+m[9] *z+m[13];
+        output[ii*outstride+2] = m[2]*x+m[6]*y+m[10]*z+m[14];
+    }
+    return output;
+}
+
 #pragma mark -
 #pragma mark Conversion Methods
 
@@ -56,6 +56,76 @@
 using namespace std;
 using namespace cugl;
 
+/** The number of triangles (or edges) before contains() uses a grid */
+#define ACCEL_THRESHOLD 16
+/** The maximum number of grid cells along either axis */
+#define ACCEL_MAX_CELLS 128
+
+#pragma mark -
+#pragma mark Acceleration
+/**
+ * A uniform grid over the triangles (or edges) of a polygon.
+ *
+ * For `SOLID` polygons, each cell lists the triangles whose bounding box
+ * overlaps it. For `PATH` and `IMPLICIT` polygons the grid is a single
+ * column, and each row lists the edges whose vertical span overlaps it. That
+ * is all that is needed for a horizontal crossing test.
+ *
+ * The cell lists are stored contiguously, with cell c spanning the entries
+ * offsets[c] to offsets[c+1] of the items array. The grid also records the
+ * size of the polygon it was built from so that it can detect the (direct)
+ * modifications made by the factory classes.
+ */
+struct Poly2::Acceleration {
+    /** The geometry when this grid was built */
+    Geometry geom;
+    /** The number of vertices when this grid was built */
+    size_t vsize;
+    /** The number of indices when this grid was built */
+    size_t isize;
+    /** The minimum corner of the grid */
+    Vec2 origin;
+    /** The maximum corner of the grid */
+    Vec2 extent;
+    /** The reciprocal cell width (0 for a single column) */
+    float scalex;
+    /** The reciprocal cell height (0 for a single row) */
+    float scaley;
+    /** The number of grid columns */
+    Uint32 cols;
+    /** The number of grid rows */
+    Uint32 rows;
+    /** The start of each cell in the items array (plus a terminal entry) */
+    std::vector<Uint32> offsets;
+    /** The triangles (or edges) in each cell */
+    std::vector<Uint32> items;
+    
+    /**
+     * Returns the column for the given x-coordinate, clamped to the grid
+     *
+     * @param x The x-coordinate
+     *
+     * @return the column for the given x-coordinate, clamped to the grid
+     */
+    Uint32 column(float x) const {
+        float pos = (x-origin.x)*scalex;
+        return pos <= 0 ? 0 : std::min((Uint32)pos,cols-1);
+    }
+
+    /**
+     * Returns the row for the given y-coordinate, clamped to the grid
+     *
+     * @param y The y-coordinate
+     *
+     * @return the row for the given y-coordinate, clamped to the grid
+     */
+    Uint32 row(float y) const {
+        float pos = (y-origin.y)*scaley;
+        return pos <= 0 ? 0 : std::min((Uint32)pos,rows-1);
+    }
+};
+
+#pragma mark -
 #pragma mark Setters
 /**
  * Sets this polygon to be have the resources of the given one.
@@ -69,6 +139,7 @@ Poly2& Poly2::operator=(Poly2&& other) {
 	_indices = std::move(other._indices);
 	_bounds = std::move(other._bounds);
 	_geom = other._geom;
+	_accel = std::move(other._accel);
 	return *this;
 }
     
@@ -225,6 +296,7 @@ Poly2& Poly2::set(const Poly2& poly) {
     _indices.assign(poly._indices.begin(),poly._indices.end());
     _bounds = poly._bounds;
     _geom = poly._geom;
+    _accel = poly._accel;
     return *this;
 }
 
@@ -275,6 +347,7 @@ Poly2& Poly2::set(const Rect rect, bool solid) {
         _geom = Geometry::PATH;
     }
     _bounds = rect;
+    _accel = nullptr;
     return *this;
 }
 
@@ -295,6 +368,7 @@ Poly2& Poly2::set(const Rect rect, bool solid) {
 Poly2& Poly2::setIndices(const vector<Uint32>& indices) {
     _indices.assign(indices.begin(), indices.end());
     _geom = Geometry::categorize(indices);
+    _accel = nullptr;
     return *this;
 }
 
@@ -318,6 +392,47 @@ Poly2& Poly2::setIndices(const vector<Uint32>& indices) {
 Poly2& Poly2::setIndices(const Uint32* indices, size_t indxsize) {
     _indices.assign(indices, indices+indxsize);
     _geom = Geometry::categorize(indices,indxsize);
+    _accel = nullptr;
+    return *this;
+}
+
+/**
+ * Moves a single vertex of this polygon to the given position.
+ *
+ * The indices and geometry are unchanged. The bounding box is updated
+ * incrementally, and is only recomputed from scratch if the old vertex
+ * was on its boundary. Hence this method is much faster than resetting
+ * all of the vertices when dragging a single point.
+ *
+ * This method returns a reference to this polygon for chaining.
+ *
+ * @param index     The index of the vertex to move
+ * @param vertex    The new vertex position
+ *
+ * @return This polygon, returned for chaining
+ */
+Poly2& Poly2::setVertex(size_t index, const Vec2 vertex) {
+    CUAssertLog(index < _vertices.size(), "Vertex index %zu is out of bounds", index);
+    Vec2 old = _vertices[index];
+    _vertices[index] = vertex;
+    _accel = nullptr;
+    
+    float minx = _bounds.getMinX();
+    float maxx = _bounds.getMaxX();
+    float miny = _bounds.getMinY();
+    float maxy = _bounds.getMaxY();
+    // The maximum is rounded through the size, so allow some slack
+    float slack = CU_MATH_EPSILON*(1+std::max(fabsf(maxx),fabsf(maxy)));
+    if (old.x <= minx || old.x >= maxx-slack || old.y <= miny || old.y >= maxy-slack) {
+        computeBounds();
+    } else {
+        minx = std::min(minx,vertex.x);
+        maxx = std::max(maxx,vertex.x);
+        miny = std::min(miny,vertex.y);
+        maxy = std::max(maxy,vertex.y);
+        _bounds.origin.set(minx,miny);
+        _bounds.size.set(maxx-minx,maxy-miny);
+    }
     return *this;
 }
 
@@ -331,6 +446,7 @@ Poly2& Poly2::clear() {
     _indices.clear();
     _geom = Geometry::IMPLICIT;
     _bounds = Rect::ZERO;
+    _accel = nullptr;
     return *this;
 }
 
@@ -386,10 +502,9 @@ Poly2& Poly2::operator*=(const Vec2 scale) {
  * @return This polygon with the vertices transformed
  */
 Poly2& Poly2::operator*=(const Affine2& transform) {
-    Vec2 tmp;
-    for(int ii = 0; ii < _vertices.size(); ii++) {
-        Affine2::transform(transform,_vertices[ii], &tmp);
-        _vertices[ii] = tmp;
+    if (!_vertices.empty()) {
+        float* data = &(_vertices[0].x);
+        Affine2::transform(transform, data, 2, data, 2, _vertices.size());
     }
     
     computeBounds();
@@ -406,10 +521,9 @@ Poly2& Poly2::operator*=(const Affine2& transform) {
  * @return This polygon with the vertices transformed
  */
 Poly2& Poly2::operator*=(const Mat4& transform) {
-    Vec2 tmp;
-    for(int ii = 0; ii < _vertices.size(); ii++) {
-        Mat4::transform(transform,_vertices[ii], &tmp);
-        _vertices[ii] = tmp;
+    if (!_vertices.empty()) {
+        float* data = &(_vertices[0].x);
+        Mat4::transform2(transform, data, 2, data, 2, _vertices.size());
     }
     
     computeBounds();
@@ -697,19 +811,55 @@ bool Poly2::contains(float x, float y, bool implicit) const {
         case Geometry::PATH:
             return containsCrossing( x,y );
         case Geometry::SOLID:
+        {
+            Vec2 temp2(x,y);
+            const Acceleration* grid = getAcceleration();
+            if (grid != nullptr) {
+                if (x < grid->origin.x || x > grid->extent.x ||
+                    y < grid->origin.y || y > grid->extent.y) {
+                    return false;
+                }
+                Uint32 cell = grid->row(y)*grid->cols+grid->column(x);
+                for(Uint32 ii = grid->offsets[cell]; ii < grid->offsets[cell+1]; ii++) {
+                    Vec3 temp3 = getBarycentric( temp2, grid->items[ii] );
+                    if (0 <= temp3.x && temp3.x <= 1 &&
+                        0 <= temp3.y && temp3.y <= 1 &&
+                        0 <= temp3.z && temp3.z <= 1) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
             bool inside = false;
             for (int ii = 0; !inside && 3 * ii < _indices.size(); ii++) {
-                Vec2 temp2(x,y);
                 Vec3 temp3 = getBarycentric( temp2, ii );
                 inside = (0 <= temp3.x && temp3.x <= 1 &&
                           0 <= temp3.y && temp3.y <= 1 &&
                           0 <= temp3.z && temp3.z <= 1);
             }
             return inside;
+        }
     }
     return false;
 }
 
+/**
+ * Builds the containment grid for this polygon now.
+ *
+ * Polygons with many triangles (or edges) answer {@link #contains} with a
+ * uniform grid, so that each query only tests the triangles near the
+ * point. This grid is normally built lazily on the first query and is
+ * discarded whenever the polygon changes. Small polygons are never
+ * indexed, and this method does nothing for them.
+ *
+ * Building the grid lazily is not thread-safe. If this polygon is to be
+ * queried from several threads at once, call this method first.
+ */
+void Poly2::buildAcceleration() const {
+    getAcceleration();
+}
+
 /**
  * Returns true if the given point is on the boundary of this polygon.
  *
@@ -880,6 +1030,7 @@ void Poly2::reverse() {
         return;
     }
     
+    _accel = nullptr;
     switch(_geom) {
         case Geometry::IMPLICIT:
             std::reverse(_vertices.begin(),_vertices.end());
@@ -967,6 +1118,12 @@ Poly2::operator Rect() const {
  * this polygon.  It is recomputed whenever the vertices are set.
  */
 void Poly2::computeBounds() {
+    _accel = nullptr;
+    if (_vertices.empty()) {
+        _bounds = Rect::ZERO;
+        return;
+    }
+    
     float minx, maxx;
     float miny, maxy;
     
@@ -1036,16 +1193,37 @@ bool Poly2::containsCrossing(float x, float y) const {
     // Use a winding rule otherwise
     int intersects = 0;
     
-    if (_geom == Geometry::IMPLICIT) {
+    const Acceleration* grid = getAcceleration();
+    if (grid != nullptr) {
+        if (y < grid->origin.y || y > grid->extent.y) {
+            return false;
+        }
+        Uint32 cell = grid->row(y);
+        size_t vsize = _vertices.size();
+        for(Uint32 ii = grid->offsets[cell]; ii < grid->offsets[cell+1]; ii++) {
+            Uint32 edge = grid->items[ii];
+            Vec2 v1, v2;
+            if (_geom == Geometry::IMPLICIT) {
+                v1 = _vertices[edge];
+                v2 = _vertices[edge+1 == vsize ? 0 : edge+1];
+            } else {
+                v1 = _vertices[_indices[2*edge  ]];
+                v2 = _vertices[_indices[2*edge+1]];
+            }
+            if (((v1.y <= y && y < v2.y) || (v2.y <= y && y < v1.y)) && x < ((v2.x - v1.x) / (v2.y - v1.y) * (y - v1.y) + v1.x)) {
+                intersects++;
+            }
+        }
+    } else if (_geom == Geometry::IMPLICIT) {
         for (size_t ii = 0; ii < _vertices.size(); ii++) {
             Vec2 v1 = _vertices[ii];
-            Vec2 v2 = _vertices[ii+1];
+            Vec2 v2 = _vertices[ii+1 == _vertices.size() ? 0 : ii+1];
             if (((v1.y <= y && y < v2.y) || (v2.y <= y && y < v1.y)) && x < ((v2.x - v1.x) / (v2.y - v1.y) * (y - v1.y) + v1.x)) {
                 intersects++;
             }
         }
     } else {
-        for (size_t ii = 0; ii < _indices.size()-2; ii += 2) {
+        for (size_t ii = 0; ii+1 < _indices.size(); ii += 2) {
             Vec2 v1 = _vertices[_indices[ii]  ];
             Vec2 v2 = _vertices[_indices[ii+1]];
             if (((v1.y <= y && y < v2.y) || (v2.y <= y && y < v1.y)) && x < ((v2.x - v1.x) / (v2.y - v1.y) * (y - v1.y) + v1.x)) {
@@ -1057,6 +1235,120 @@ bool Poly2::containsCrossing(float x, float y) const {
 
 }
 
+/**
+ * Returns the containment grid for this polygon, building it if necessary.
+ *
+ * This method returns nullptr if the polygon is too small to benefit from
+ * a grid, or if the geometry is `POINTS`.
+ *
+ * @return the containment grid for this polygon, building it if necessary.
+ */
+const Poly2::Acceleration* Poly2::getAcceleration() const {
+    size_t count = 0;
+    switch (_geom) {
+        case Geometry::POINTS:
+            return nullptr;
+        case Geometry::IMPLICIT:
+            count = _vertices.size();
+            break;
+        case Geometry::PATH:
+            count = _indices.size()/2;
+            break;
+        case Geometry::SOLID:
+            count = _indices.size()/3;
+            break;
+    }
+    if (count < ACCEL_THRESHOLD) {
+        return nullptr;
+    }
+    if (_accel != nullptr && _accel->geom == _geom &&
+        _accel->vsize == _vertices.size() && _accel->isize == _indices.size()) {
+        return _accel.get();
+    }
+    
+    auto grid = std::make_shared<Acceleration>();
+    grid->geom  = _geom;
+    grid->vsize = _vertices.size();
+    grid->isize = _indices.size();
+    
+    // Compute the bounds directly, as factories may not have
+    grid->origin = _vertices[0];
+    grid->extent = _vertices[0];
+    for(auto it = _vertices.begin()+1; it != _vertices.end(); ++it) {
+        grid->origin.x = std::min(grid->origin.x,it->x);
+        grid->origin.y = std::min(grid->origin.y,it->y);
+        grid->extent.x = std::max(grid->extent.x,it->x);
+        grid->extent.y = std::max(grid->extent.y,it->y);
+    }
+    float width  = grid->extent.x-grid->origin.x;
+    float height = grid->extent.y-grid->origin.y;
+    
+    // Aim for about one primitive per cell
+    bool solid = _geom == Geometry::SOLID;
+    if (!solid || width <= 0) {
+        grid->cols = 1;
+    } else if (height <= 0) {
+        grid->cols = (Uint32)std::min(count,(size_t)ACCEL_MAX_CELLS);
+    } else {
+        double cols = std::sqrt(count*width/height);
+        grid->cols = (Uint32)std::max(1.0,std::min(std::round(cols),(double)ACCEL_MAX_CELLS));
+    }
+    grid->rows = (Uint32)std::max((size_t)1,std::min(count/grid->cols,(size_t)ACCEL_MAX_CELLS));
+    if (height <= 0) {
+        grid->rows = 1;
+    }
+    grid->scalex = width  > 0 ? grid->cols/width  : 0;
+    grid->scaley = height > 0 ? grid->rows/height : 0;
+    
+    // Counting pass, then fill pass
+    size_t vsize = _vertices.size();
+    auto span = [&](Uint32 ii, Uint32& c0, Uint32& c1, Uint32& r0, Uint32& r1) {
+        Vec2 lo, hi;
+        if (solid) {
+            const Vec2& a = _vertices[_indices[3*ii  ]];
+            const Vec2& b = _vertices[_indices[3*ii+1]];
+            const Vec2& c = _vertices[_indices[3*ii+2]];
+            lo.set(std::min(a.x,std::min(b.x,c.x)),std::min(a.y,std::min(b.y,c.y)));
+            hi.set(std::max(a.x,std::max(b.x,c.x)),std::max(a.y,std::max(b.y,c.y)));
+        } else {
+            const Vec2& a = _geom == Geometry::IMPLICIT ? _vertices[ii] : _vertices[_indices[2*ii]];
+            const Vec2& b = _geom == Geometry::IMPLICIT ? _vertices[ii+1 == vsize ? 0 : ii+1] : _vertices[_indices[2*ii+1]];
+            lo.set(std::min(a.x,b.x),std::min(a.y,b.y));
+            hi.set(std::max(a.x,b.x),std::max(a.y,b.y));
+        }
+        c0 = grid->column(lo.x); c1 = grid->column(hi.x);
+        r0 = grid->row(lo.y);    r1 = grid->row(hi.y);
+    };
+    
+    Uint32 cells = grid->cols*grid->rows;
+    grid->offsets.assign(cells+1,0);
+    Uint32 c0, c1, r0, r1;
+    for(Uint32 ii = 0; ii < count; ii++) {
+        span(ii,c0,c1,r0,r1);
+        for(Uint32 rr = r0; rr <= r1; rr++) {
+            for(Uint32 cc = c0; cc <= c1; cc++) {
+                grid->offsets[rr*grid->cols+cc+1]++;
+            }
+        }
+    }
+    for(Uint32 ii = 0; ii < cells; ii++) {
+        grid->offsets[ii+1] += grid->offsets[ii];
+    }
+    grid->items.resize(grid->offsets[cells]);
+    std::vector<Uint32> cursor(grid->offsets.begin(),grid->offsets.end()-1);
+    for(Uint32 ii = 0; ii < count; ii++) {
+        span(ii,c0,c1,r0,r1);
+        for(Uint32 rr = r0; rr <= r1; rr++) {
+            for(Uint32 cc = c0; cc <= c1; cc++) {
+                grid->items[cursor[rr*grid->cols+cc]++] = ii;
+            }
+        }
+    }
+    
+    _accel = grid;
+    return _accel.get();
+}
+
 bool Poly2::isColinear(Vec2 v, Vec2 w, Vec2 p, float err) {
     const float l2 = (w-v).lengthSquared();
     double distance = 0.0f;
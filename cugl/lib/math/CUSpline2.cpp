@@ -40,6 +40,8 @@
 
 #include <cugl/math/CUSpline2.h>
 #include <cugl/math/CUPolynomial.h>
+#include <cugl/util/CUThreadPool.h>
+#include <algorithm>
 
 using namespace std;
 using namespace cugl;
@@ -50,6 +52,465 @@ using namespace cugl;
 /** Tolerance to identify a point as "smooth" */
 #define SMOOTH_TOLERANCE    0.0001f
 
+/** Maximum number of steps when flattening a single bezier */
+#define FLATTEN_MAX_STEPS   1024
+/** The number of beziers at which it is worth using a thread pool */
+#define FLATTEN_PARALLEL_LIMIT  4096
+/** The maximum number of segments in a leaf of the projection hierarchy */
+#define PROJECT_LEAF_SIZE   4
+/** The maximum depth of the traversal stack for the projection hierarchy */
+#define PROJECT_STACK_SIZE  64
+/** The maximum number of safeguarded Newton steps to polish a root */
+#define PROJECT_ITERATIONS  64
+/** The parameter tolerance when polishing a root */
+#define PROJECT_TOLERANCE   1e-7
+/** The relative size at which a leading coefficient is negligible */
+#define PROJECT_EPSILON     1e-9
+
+#pragma mark -
+#pragma mark Acceleration
+/**
+ * Returns the dot product of two vectors in double precision.
+ *
+ * The projection coefficients subtract products of similar magnitude, so
+ * they are accumulated in double precision.
+ *
+ * @param u The first vector
+ * @param v The second vector
+ *
+ * @return the dot product of two vectors in double precision.
+ */
+static double dot(const Vec2 u, const Vec2 v) {
+    return (double)u.x*v.x+(double)u.y*v.y;
+}
+
+/**
+ * Returns the value of the polynomial at x.
+ *
+ * The coefficients are stored highest degree first.
+ *
+ * @param coeff     The polynomial coefficients
+ * @param degree    The polynomial degree
+ * @param x         The value to evaluate at
+ *
+ * @return the value of the polynomial at x.
+ */
+static double poly_eval(const double* coeff, int degree, double x) {
+    double result = coeff[0];
+    for(int ii = 1; ii <= degree; ii++) {
+        result = result*x+coeff[ii];
+    }
+    return result;
+}
+
+/**
+ * Stores the roots of the quadratic a x^2 + b x + c in [lo,hi] in roots.
+ *
+ * The roots are stored in ascending order. This method uses the stable
+ * form of the quadratic formula, and degrades to a linear equation if a
+ * is 0.
+ *
+ * @param a     The quadratic coefficient
+ * @param b     The linear coefficient
+ * @param c     The constant coefficient
+ * @param lo    The start of the search interval
+ * @param hi    The end of the search interval
+ * @param roots The array to store the roots (size 2)
+ *
+ * @return the number of roots in [lo,hi]
+ */
+static int solve_quadratic(double a, double b, double c, double lo, double hi, double* roots) {
+    double cands[2];
+    int count = 0;
+    if (a == 0) {
+        if (b == 0) {
+            return 0;
+        }
+        cands[count++] = -c/b;
+    } else {
+        double disc = b*b-4*a*c;
+        if (disc < 0) {
+            return 0;
+        }
+        double q = -0.5*(b+std::copysign(std::sqrt(disc),b));
+        cands[count++] = q/a;
+        if (q != 0) {
+            cands[count++] = c/q;
+        }
+        if (count == 2 && cands[0] > cands[1]) {
+            std::swap(cands[0],cands[1]);
+        }
+    }
+    
+    int result = 0;
+    for(int ii = 0; ii < count; ii++) {
+        if (cands[ii] >= lo && cands[ii] <= hi) {
+            roots[result++] = cands[ii];
+        }
+    }
+    return result;
+}
+
+/**
+ * Stores the roots of the cubic in [lo,hi] in roots.
+ *
+ * The roots are stored in ascending order. They are computed in closed
+ * form (trigonometric or Cardano, depending on the discriminant) and then
+ * polished with a Newton step. The cubic degrades to a quadratic if its
+ * leading coefficient is negligible.
+ *
+ * @param coeff The polynomial coefficients (highest degree first)
+ * @param lo    The start of the search interval
+ * @param hi    The end of the search interval
+ * @param roots The array to store the roots (size 3)
+ *
+ * @return the number of roots in [lo,hi]
+ */
+static int solve_cubic(const double* coeff, double lo, double hi, double* roots) {
+    double scale = std::max(std::abs(coeff[1]),std::max(std::abs(coeff[2]),std::abs(coeff[3])));
+    if (std::abs(coeff[0]) <= PROJECT_EPSILON*scale) {
+        return solve_quadratic(coeff[1],coeff[2],coeff[3],lo,hi,roots);
+    }
+    
+    double a = coeff[1]/coeff[0];
+    double b = coeff[2]/coeff[0];
+    double c = coeff[3]/coeff[0];
+    double q = (a*a-3*b)/9;
+    double r = (a*(2*a*a-9*b)+27*c)/54;
+    double q3 = q*q*q;
+    
+    double cands[3];
+    int count = 0;
+    if (r*r < q3) {
+        double theta = std::acos(std::max(-1.0,std::min(1.0,r/std::sqrt(q3))));
+        double s = -2*std::sqrt(q);
+        cands[count++] = s*std::cos(theta/3)-a/3;
+        cands[count++] = s*std::cos((theta+2*M_PI)/3)-a/3;
+        cands[count++] = s*std::cos((theta-2*M_PI)/3)-a/3;
+    } else {
+        double s = -std::copysign(std::cbrt(std::abs(r)+std::sqrt(r*r-q3)),r);
+        double t = (s == 0 ? 0 : q/s);
+        cands[count++] = s+t-a/3;
+    }
+    
+    int result = 0;
+    for(int ii = 0; ii < count; ii++) {
+        double x = cands[ii];
+        double df = (3*x+2*a)*x+b;
+        if (df != 0) {
+            x -= (((x+a)*x+b)*x+c)/df;
+        }
+        if (x >= lo && x <= hi) {
+            int pos = result++;
+            while (pos > 0 && roots[pos-1] > x) {
+                roots[pos] = roots[pos-1];
+                pos--;
+            }
+            roots[pos] = x;
+        }
+    }
+    return result;
+}
+
+/**
+ * Returns the root of the polynomial in the bracket [lo,hi].
+ *
+ * The polynomial must be monotone on the bracket, and change sign across
+ * it. The root is found with Newton's method, starting from the secant
+ * and falling back to bisection whenever a step leaves the bracket.
+ *
+ * @param coeff     The polynomial coefficients (highest degree first)
+ * @param deriv     The derivative coefficients (highest degree first)
+ * @param degree    The polynomial degree
+ * @param lo        The start of the bracket
+ * @param hi        The end of the bracket
+ * @param flo       The value of the polynomial at lo
+ * @param fhi       The value of the polynomial at hi
+ *
+ * @return the root of the polynomial in the bracket [lo,hi].
+ */
+static double isolate_root(const double* coeff, const double* deriv, int degree,
+                           double lo, double hi, double flo, double fhi) {
+    double x = lo-flo*(hi-lo)/(fhi-flo);
+    if (!(x > lo && x < hi)) {
+        x = 0.5*(lo+hi);
+    }
+    for(int ii = 0; ii < PROJECT_ITERATIONS; ii++) {
+        double f = poly_eval(coeff,degree,x);
+        if (f == 0) {
+            return x;
+        } else if ((f < 0) == (flo < 0)) {
+            lo = x;
+            flo = f;
+        } else {
+            hi = x;
+        }
+        
+        double df = poly_eval(deriv,degree-1,x);
+        double next = (df != 0 ? x-f/df : lo);
+        if (!(next > lo && next < hi)) {
+            next = 0.5*(lo+hi);
+        }
+        if (std::abs(next-x) <= PROJECT_TOLERANCE || hi-lo <= PROJECT_TOLERANCE) {
+            return next;
+        }
+        x = next;
+    }
+    return x;
+}
+
+/**
+ * Stores the roots of the polynomial in [lo,hi] in roots.
+ *
+ * The roots are stored in ascending order. Polynomials of degree 3 or
+ * less are solved in closed form. Higher degrees are split into intervals
+ * on which the polynomial is monotone, using the (recursively computed)
+ * roots of the derivative, and each sign change is polished with
+ * {@link isolate_root}. This finds every root of odd multiplicity, which
+ * is all that is needed to find the minima of a distance function.
+ *
+ * Indeed, if the polynomial is the derivative of a distance function, only
+ * the roots where it changes sign from negative to positive are minima.
+ * If rising is true, the other roots are skipped (except for polynomials
+ * solved in closed form, which return them all).
+ *
+ * Everything is computed in stack buffers, and the degree may be at most 5.
+ *
+ * @param coeff     The polynomial coefficients (highest degree first)
+ * @param degree    The polynomial degree
+ * @param lo        The start of the search interval
+ * @param hi        The end of the search interval
+ * @param roots     The array to store the roots (size 8)
+ * @param rising    Whether to only find the roots where the sign rises
+ *
+ * @return the number of roots in [lo,hi]
+ */
+static int solve_interval(const double* coeff, int degree, double lo, double hi,
+                          double* roots, bool rising=false) {
+    while (degree > 0 && coeff[0] == 0) {
+        coeff++;
+        degree--;
+    }
+    if (degree <= 0) {
+        return 0;
+    } else if (degree <= 2) {
+        return solve_quadratic(degree == 2 ? coeff[0] : 0, coeff[degree-1], coeff[degree],
+                               lo, hi, roots);
+    } else if (degree == 3) {
+        return solve_cubic(coeff, lo, hi, roots);
+    }
+    
+    double deriv[5];
+    for(int ii = 0; ii < degree; ii++) {
+        deriv[ii] = coeff[ii]*(degree-ii);
+    }
+    
+    // Split [lo,hi] into monotone intervals
+    double crit[8];
+    int count = solve_interval(deriv, degree-1, lo, hi, crit+1)+2;
+    crit[0] = lo;
+    crit[count-1] = hi;
+    
+    int result = 0;
+    double f0 = poly_eval(coeff,degree,lo);
+    if (f0 == 0) {
+        roots[result++] = lo;
+    }
+    for(int ii = 1; ii < count; ii++) {
+        double f1 = poly_eval(coeff,degree,crit[ii]);
+        if (f1 == 0) {
+            if (result == 0 || roots[result-1] != crit[ii]) {
+                roots[result++] = crit[ii];
+            }
+        } else if (f0 < 0 ? f1 > 0 : (f0 > 0 && f1 < 0 && !rising)) {
+            roots[result++] = isolate_root(coeff,deriv,degree,crit[ii-1],crit[ii],f0,f1);
+        }
+        f0 = f1;
+    }
+    return result;
+}
+
+/**
+ * Returns the squared distance from the point to the given box.
+ *
+ * The distance is 0 if the point is inside the box.
+ *
+ * @param min   The minimum corner of the box
+ * @param max   The maximum corner of the box
+ * @param point The point to compare
+ *
+ * @return the squared distance from the point to the given box.
+ */
+static float box_distance(const Vec2 min, const Vec2 max, const Vec2 point) {
+    float dx = std::max(std::max(min.x-point.x,point.x-max.x),0.0f);
+    float dy = std::max(std::max(min.y-point.y,point.y-max.y),0.0f);
+    return dx*dx+dy*dy;
+}
+
+/**
+ * The cached projection data for the segments of a spline.
+ *
+ * The projection polynomial of a segment is (B(t)-P)·B'(t), where B is the
+ * bezier and P is the point to project. Writing the bezier in the power
+ * basis B(t) = a t^3 + b t^2 + c t + p0, the three highest coefficients do
+ * not depend on P, and the lower three are dot products with p0-P. Hence
+ * each query only needs three dot products per segment.
+ *
+ * The segments are also organized in a bounding volume hierarchy, using
+ * the control points as (convex hull) bounds. As the segments of a spline
+ * are already spatially coherent, each node simply covers a contiguous
+ * range of segments, split in half at each level.
+ */
+struct Spline2::Acceleration {
+    /** The point independent data for a single segment */
+    struct Segment {
+        /** The cubic coefficient of the power basis */
+        Vec2 a;
+        /** The quadratic coefficient of the power basis */
+        Vec2 b;
+        /** The linear coefficient of the power basis */
+        Vec2 c;
+        /** The first anchor of the segment */
+        Vec2 p0;
+        /** The last anchor of the segment */
+        Vec2 p3;
+        /** The minimum corner of the control point bounds */
+        Vec2 min;
+        /** The maximum corner of the control point bounds */
+        Vec2 max;
+        /** The projection coefficients 3a·a, 5a·b, 4a·c+2b·b, 3b·c, and c·c */
+        double coeff[5];
+        
+        /**
+         * Returns the squared distance from the point to the bounding box
+         *
+         * @param point The point to compare
+         *
+         * @return the squared distance from the point to the bounding box
+         */
+        float distance(const Vec2 point) const {
+            return box_distance(min,max,point);
+        }
+    };
+    
+    /** A node in the segment hierarchy */
+    struct Node {
+        /** The minimum corner of the bounding box */
+        Vec2 min;
+        /** The maximum corner of the bounding box */
+        Vec2 max;
+        /** The first segment in this node */
+        Uint32 start;
+        /** The segment after the last one in this node */
+        Uint32 end;
+        /** The index of the left child (0 for a leaf) */
+        Uint32 left;
+        /** The index of the right child (0 for a leaf) */
+        Uint32 right;
+        
+        /**
+         * Returns the squared distance from the point to the bounding box
+         *
+         * @param point The point to compare
+         *
+         * @return the squared distance from the point to the bounding box
+         */
+        float distance(const Vec2 point) const {
+            return box_distance(min,max,point);
+        }
+    };
+    
+    /** The segment data, one for each segment */
+    std::vector<Segment> segments;
+    /** The hierarchy nodes, with the root at position 0 */
+    std::vector<Node> nodes;
+    
+    /**
+     * Builds the hierarchy node for the given segment range.
+     *
+     * The segment data must be computed before calling this method.
+     *
+     * @param start     The first segment in the node
+     * @param end       The segment after the last one in the node
+     *
+     * @return the index of the new node
+     */
+    Uint32 build(Uint32 start, Uint32 end) {
+        Uint32 index = (Uint32)nodes.size();
+        nodes.emplace_back();
+        
+        Node node;
+        node.start = start;
+        node.end = end;
+        node.left = 0;
+        node.right = 0;
+        if (end-start <= PROJECT_LEAF_SIZE) {
+            node.min = segments[start].min;
+            node.max = segments[start].max;
+            for(Uint32 ii = start+1; ii < end; ii++) {
+                node.min.x = std::min(node.min.x,segments[ii].min.x);
+                node.min.y = std::min(node.min.y,segments[ii].min.y);
+                node.max.x = std::max(node.max.x,segments[ii].max.x);
+                node.max.y = std::max(node.max.y,segments[ii].max.y);
+            }
+        } else {
+            Uint32 mid = (start+end)/2;
+            node.left  = build(start,mid);
+            node.right = build(mid,end);
+            const Node& left  = nodes[node.left];
+            const Node& right = nodes[node.right];
+            node.min.x = std::min(left.min.x,right.min.x);
+            node.min.y = std::min(left.min.y,right.min.y);
+            node.max.x = std::max(left.max.x,right.max.x);
+            node.max.y = std::max(left.max.y,right.max.y);
+        }
+        nodes[index] = node;
+        return index;
+    }
+    
+    /**
+     * Returns the parameter and squared distance of the nearest point.
+     *
+     * The value returned is the nearest point on the given segment. It
+     * is a pair of the parameter (in 0..1), and the squared distance.
+     *
+     * @param index The segment to project upon
+     * @param point The point to project
+     *
+     * @return the parameter and squared distance of the nearest point.
+     */
+    Vec2 project(Uint32 index, const Vec2 point) const {
+        const Segment& seg = segments[index];
+        Vec2 p = seg.p0-point;
+        double coeff[6];
+        coeff[0] = seg.coeff[0];
+        coeff[1] = seg.coeff[1];
+        coeff[2] = seg.coeff[2];
+        coeff[3] = seg.coeff[3]+3*dot(seg.a,p);
+        coeff[4] = seg.coeff[4]+2*dot(seg.b,p);
+        coeff[5] = dot(seg.c,p);
+        
+        // The endpoints are always candidates
+        Vec2 result(0.0f,p.lengthSquared());
+        float d = (seg.p3-point).lengthSquared();
+        if (d < result.y) {
+            result.set(1.0f,d);
+        }
+        
+        double roots[8];
+        int count = solve_interval(coeff, 5, 0, 1, roots, true);
+        for(int ii = 0; ii < count; ii++) {
+            float t = (float)roots[ii];
+            Vec2 diff = ((seg.a*t+seg.b)*t+seg.c)*t+p;
+            d = diff.lengthSquared();
+            if (d < result.y) {
+                result.set(t,d);
+            }
+        }
+        return result;
+    }
+};
+
 #pragma mark -
 #pragma mark Constructors
 
@@ -206,6 +667,7 @@ Spline2::Spline2(const Spline2& spline) {
     _closed = spline._closed;
     _points.assign(spline._points.begin(), spline._points.end());
     _smooth.assign(spline._smooth.begin(), spline._smooth.end());
+    _accel = spline._accel;
 }
 
 
@@ -228,6 +690,7 @@ Spline2::Spline2(const Spline2& spline) {
  * @return This spline, returned for chaining
  */
 Spline2& Spline2::set(const Vec2 start, const Vec2 end) {
+    _accel = nullptr;
     _points.clear();
     _smooth.clear();
     _points.push_back(start);
@@ -263,6 +726,7 @@ Spline2& Spline2::set(const Vec2 start, const Vec2 end) {
  */
 Spline2& Spline2::set(const float* points, int size) {
     CUAssertLog(size - 2 % 6 != 0, "Constrol point array is the wrong size");
+    _accel = nullptr;
     _points.clear();
     _smooth.clear();
     _size = (size - 2) / 6;
@@ -306,6 +770,7 @@ Spline2& Spline2::set(const float* points, int size) {
  */
 Spline2& Spline2::set(const std::vector<float>& points) {
     CUAssertLog(points.size() % 6 != 2, "Control point array is the wrong size");
+    _accel = nullptr;
     _points.clear();
     _smooth.clear();
 
@@ -350,6 +815,7 @@ Spline2& Spline2::set(const std::vector<float>& points) {
  */
 Spline2& Spline2::set(const std::vector<Vec2>& points) {
     CUAssertLog(points.size() % 3 != 1, "Control point array is the wrong size");
+    _accel = nullptr;
     _points.clear();
     _smooth.clear();
 
@@ -387,6 +853,7 @@ Spline2& Spline2::set(const Spline2& spline) {
     _smooth.clear();
     _points.assign(spline._points.begin(), spline._points.end());
     _smooth.assign(spline._smooth.begin(), spline._smooth.end());
+    _accel = spline._accel;
     return *this;
 }
 
@@ -409,6 +876,7 @@ Spline2& Spline2::set(const Spline2& spline) {
  * @param flag whether the spline is closed
  */
 void Spline2::setClosed(bool flag) {
+    _accel = nullptr;
     if (flag && (_points[0] != _points[3 * _size])) {
         addAnchor(_points[0]);
     }
@@ -515,6 +983,7 @@ Vec2 Spline2::getAnchor(int index) const {
 void Spline2::setAnchor(int index, const Vec2 point) {
     CUAssertLog(index >= 0 && index < _size, "Index out of bounds");
     CUAssertLog(!_closed || index < _size - 1, "Index out of bounds for closed spline");
+    _accel = nullptr;
     
     Vec2 diff = point - _points[3 * index];
     
@@ -584,6 +1053,7 @@ bool Spline2::getSmooth(int index) const {
 void Spline2::setSmooth(int index, bool flag) {
     CUAssertLog(index >= 0 && index < _size, "Index out of bounds");
     CUAssertLog(!_closed || index < _size - 1, "Index out of bounds for closed spline");
+    _accel = nullptr;
     
     _smooth[index] = flag;
     if (flag && index > 0 && index < _size) {
@@ -663,6 +1133,7 @@ Vec2 Spline2::getTangent(int index) const {
  */
 void Spline2::setTangent(int index, const Vec2 tang, bool symmetric) {
     CUAssertLog(index >= 0 && index < 2 * _size, "Index out of bounds");
+    _accel = nullptr;
     
     int spline = (index + 1) / 2;
     int anchor = 3 * spline;
@@ -775,6 +1246,7 @@ Polynomial Spline2::getPolynomialY(int segment) const {
  */
 int Spline2::addAnchor(const Vec2 point, const Vec2 tang) {
     CUAssertLog(!_closed, "Cannot append to closed curve");
+    _accel = nullptr;
     
     _points.resize(_points.size() + 3, Vec2::ZERO);
     _smooth.resize(_smooth.size() + 1, true);
@@ -811,6 +1283,7 @@ int Spline2::addAnchor(const Vec2 point, const Vec2 tang) {
 void Spline2::deleteAnchor(int index) {
     CUAssertLog(index >= 0 && index < _size, "Index out of bounds");
     CUAssertLog(!_closed || index < _size - 1, "Index out of bounds for closed spline");
+    _accel = nullptr;
     
     // Shift everything left.
     _points.erase(_points.begin() + (3 * index), _points.begin() + (3 * (index + 1)));
@@ -840,6 +1313,7 @@ void Spline2::deleteAnchor(int index) {
 void Spline2::insertAnchor(int segment, float param) {
     CUAssertLog(segment >= 0 && segment < _size, "Illegal spline segment");
     CUAssertLog(param > 0.0f && param < 1.0f, "Illegal insertion parameter");
+    _accel = nullptr;
     
     // Split the bezier.
     vector<Vec2> left;
@@ -871,23 +1345,68 @@ void Spline2::insertAnchor(int segment, float param) {
  * @return the parameterization of the nearest point on the spline.
  */
 float Spline2::nearestParameter(const Vec2 point) const {
-    float tmin = -1;
-    float dmin = -1;
-    int smin = -1;
+    const Acceleration* accel = getAcceleration();
+    if (accel == nullptr) {
+        return -1;
+    }
     
-    for (int ii = 0; ii < _size; ii++) {
-        Vec2 pair = getProjectionFast(point, ii);
-        if (pair.x == -1) {
-            pair = getProjectionSlow(point, ii);
-        }
-        if (smin == -1 || pair.y < dmin) {
-            tmin = pair.x; dmin = pair.y; smin = ii;
+    float tmin = 0;
+    float dmin = std::numeric_limits<float>::infinity();
+    Uint32 smin = 0;
+    
+    // Visit the nearest boxes first, skipping any farther than the best so far
+    Uint32 stack[PROJECT_STACK_SIZE];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Acceleration::Node& node = accel->nodes[stack[--top]];
+        if (node.distance(point) >= dmin) {
+            continue;
+        } else if (node.left == 0) {
+            // The anchors are cheap upper bounds for the segment test
+            for(Uint32 ii = node.start; ii < node.end; ii++) {
+                float d = (accel->segments[ii].p0-point).lengthSquared();
+                if (d < dmin) {
+                    tmin = 0; dmin = d; smin = ii;
+                }
+            }
+            for(Uint32 ii = node.start; ii < node.end; ii++) {
+                if (accel->segments[ii].distance(point) < dmin) {
+                    Vec2 pair = accel->project(ii, point);
+                    if (pair.y < dmin) {
+                        tmin = pair.x; dmin = pair.y; smin = ii;
+                    }
+                }
+            }
+        } else {
+            Uint32 near = node.left;
+            Uint32 far  = node.right;
+            if (accel->nodes[far].distance(point) < accel->nodes[near].distance(point)) {
+                std::swap(near,far);
+            }
+            stack[top++] = far;
+            stack[top++] = near;
         }
     }
     
     return smin + tmin;
 }
 
+/**
+ * Builds the projection cache for this spline now.
+ *
+ * The cache stores the polynomial coefficients and control point bounds
+ * of each segment, together with a segment hierarchy. It is normally
+ * built lazily on the first call to {@link #nearestParameter}, and is
+ * discarded whenever the spline changes.
+ *
+ * Building the cache lazily is not thread-safe. If this spline is to be
+ * queried from several threads at once, call this method first.
+ */
+void Spline2::buildAcceleration() const {
+    getAcceleration();
+}
+
 /**
  * Returns the index of the anchor nearest the given point.
  *
@@ -946,39 +1465,148 @@ int Spline2::nearestTangent(const Vec2 point, float threshold) const {
     return index;
 }
 
+#pragma mark -
+#pragma mark Polygon Approximation
+/**
+ * Returns the number of uniform steps needed to flatten the given bezier
+ *
+ * The second derivative of a cubic bezier is bounded by six times the
+ * largest second difference of its control points. A chord over a parameter
+ * step h is within h^2/8 of the curve times that bound.
+ *
+ * @param  src          the control points for the bezier
+ * @param  tolerance    the maximum distance from the curve to the polyline
+ *
+ * @return the number of uniform steps needed to flatten the given bezier
+ */
+static Uint32 flatten_steps(const Vec2* src, float tolerance) {
+    Vec2 d1 = src[0]-2*src[1]+src[2];
+    Vec2 d2 = src[1]-2*src[2]+src[3];
+    float bound = std::max(d1.lengthSquared(),d2.lengthSquared());
+    float steps = sqrtf(0.75f*sqrtf(bound)/tolerance);
+    return (Uint32)std::min(std::max(ceilf(steps),1.0f),(float)FLATTEN_MAX_STEPS);
+}
+
+/**
+ * Samples the given bezier with forward differencing
+ *
+ * This writes the given number of points, starting with the first anchor
+ * but excluding the last.
+ *
+ * @param  src      the control points for the bezier
+ * @param  steps    the number of uniform steps
+ * @param  output   the array to store the points
+ */
+static void flatten_bezier(const Vec2* src, Uint32 steps, Vec2* output) {
+    Vec2 a = 3*(src[1]-src[2])+src[3]-src[0];
+    Vec2 b = 3*(src[0]-2*src[1]+src[2]);
+    Vec2 c = 3*(src[1]-src[0]);
+    float h  = 1.0f/steps;
+    float h2 = h*h;
+    float h3 = h2*h;
+    
+    Vec2 f   = src[0];
+    Vec2 df  = a*h3+b*h2+c*h;
+    Vec2 ddf = 6*a*h3+2*b*h2;
+    Vec2 dddf = 6*a*h3;
+    for(Uint32 ii = 0; ii < steps; ii++) {
+        output[ii] = f;
+        f += df;
+        df += ddf;
+        ddf += dddf;
+    }
+}
+
+/**
+ * Appends a polyline approximating this spline to the given buffer.
+ *
+ * Unlike {@link PolySplineFactory}, this method does not subdivide
+ * recursively. Each bezier is sampled at uniform parameter steps with
+ * forward differencing, using the fewest steps for which the curve is
+ * guaranteed to lie within tolerance of the polyline. The number of
+ * points is computed first, so the buffer grows at most once.
+ *
+ * Long splines may be split across a thread pool, with each thread
+ * writing its beziers directly into the buffer. The result is the same
+ * either way.
+ *
+ * @param buffer    The buffer to store the polyline
+ * @param tolerance The maximum distance from the curve to the polyline
+ * @param threads   The thread pool to split long splines (may be null)
+ *
+ * @return the number of points added to the buffer
+ */
+size_t Spline2::flatten(std::vector<Vec2>& buffer, float tolerance,
+                        const std::shared_ptr<ThreadPool>& threads) const {
+    CUAssertLog(tolerance > 0, "Tolerance must be positive");
+    if (_points.empty()) {
+        return 0;
+    }
+    
+    size_t first = buffer.size();
+    const Vec2* points = _points.data();
+    if (threads && _size >= FLATTEN_PARALLEL_LIMIT) {
+        std::vector<size_t> offsets(_size+1);
+        threads->parallelFor(_size, [&](size_t start, size_t end) {
+            for(size_t ii = start; ii < end; ii++) {
+                offsets[ii+1] = flatten_steps(points+3*ii, tolerance);
+            }
+        });
+        offsets[0] = first;
+        for(int ii = 0; ii < _size; ii++) {
+            offsets[ii+1] += offsets[ii];
+        }
+        buffer.resize(offsets[_size]+1);
+        Vec2* output = buffer.data();
+        threads->parallelFor(_size, [&](size_t start, size_t end) {
+            for(size_t ii = start; ii < end; ii++) {
+                Uint32 steps = (Uint32)(offsets[ii+1]-offsets[ii]);
+                flatten_bezier(points+3*ii, steps, output+offsets[ii]);
+            }
+        });
+    } else {
+        size_t total = 0;
+        for(int ii = 0; ii < _size; ii++) {
+            total += flatten_steps(points+3*ii, tolerance);
+        }
+        buffer.resize(first+total+1);
+        Vec2* output = buffer.data()+first;
+        for(int ii = 0; ii < _size; ii++) {
+            Uint32 steps = flatten_steps(points+3*ii, tolerance);
+            flatten_bezier(points+3*ii, steps, output);
+            output += steps;
+        }
+    }
+    buffer.back() = _points[3*_size];
+    return buffer.size()-first;
+}
+
+#pragma mark -
 #pragma mark Internal Helpers
 /**
  * Applies de Castlejau's to a bezier, putting the result in left & right
  *
- * de Castlejau's takes a parameter tp in (0,1) and splits the bezier into two,
- * preserving the geometric information, but not the parameterization.  The control
- * points for the resulting two beziers are stored in left and right.
- *
- * This static method is not restricted to the current spline.  It can work
- * from any list of control points (and offset into those control points).
- * This is useful for recursive subdivision.
+ * This version works on raw arrays of four control points, and does not
+ * allocate any memory. The arrays left and rght must have room for four
+ * points each.
  *
- * @param  src      the control point list for the bezier
- * @param  soff     the offset into the control point list
+ * @param  src      the control points for the bezier
  * @param  tp       the parameter to split at
- * @param  left     vector to store the left bezier
- * @param  right    vector to store the right bezier
+ * @param  left     array to store the left bezier
+ * @param  rght     array to store the right bezier
  */
-void Spline2::subdivide(const vector<Vec2>& src, int soff, float tp,
-                            vector<Vec2>& left, vector<Vec2>& rght) {
+void Spline2::subdivide(const Vec2* src, float tp, Vec2* left, Vec2* rght) {
     // Cross bar
-    Vec2 h = (1 - tp)*src[soff + 1] + tp*src[soff + 2];
+    Vec2 h = (1 - tp)*src[1] + tp*src[2];
     
     // FIRST HALF
-    left.resize(4, Vec2::ZERO);
-    left[0] = src[soff];
-    left[1] = (1 - tp)*src[soff] + tp*src[soff + 1];
+    left[0] = src[0];
+    left[1] = (1 - tp)*src[0] + tp*src[1];
     left[2] = (1 - tp)*left[1] + tp*h;
     
     // SECOND HALF
-    rght.resize(4, Vec2::ZERO);
-    rght[3] = src[soff + 3];
-    rght[2] = (1 - tp)*src[soff + 2] + tp*src[soff + 3];
+    rght[3] = src[3];
+    rght[2] = (1 - tp)*src[2] + tp*src[3];
     rght[1] = (1 - tp)*h + tp*rght[2];
     rght[0] = (1 - tp)*left[2] + tp*rght[1];
     
@@ -1026,8 +1654,8 @@ Polynomial Spline2::getProjectionPolynomial(const Vec2 point, int segment) const
  * This version does not use the projection polynomial.  Instead, it picks
  * a parameter resolution and walks the entire length of the curve.  The
  * result is both slow and inexact (as the actual point may be in-between
- * chose parameters). This version is only picked when getProjectionFast
- * fails because of an error with root finding.
+ * chose parameters). It is no longer used by nearestParameter(), but
+ * it is a useful reference for testing getProjectionFast().
  *
  * The value returned is a pair of the parameter, and its distance value.
  * This allows us to compare this result to other segments, picking the
@@ -1053,7 +1681,7 @@ Vec2 Spline2::getProjectionSlow(const Vec2 point, int segment) const {
     }
     
     // Compare the last point.
-    Vec2 temp0 = _points[3 * _size] - point;
+    Vec2 temp0 = _points[3 * segment + 3] - point;
     float d = temp0.lengthSquared();
     if (d < result.y) {
         result.x = 1.0f; result.y = d;
@@ -1077,10 +1705,11 @@ Vec2 Spline2::getProjectionSlow(const Vec2 point, int segment) const {
  * This allows us to compare this result to other segments, picking the
  * best value for the entire spline.
  *
- * This algorithm uses the projection polynomial, and searches for roots to
- * find the best (max of 5) candidates.  However, root finding may fail,
- * do to singularities in Bairstow's Method.  If the root finder fails, then
- * the first element of the pair will be -1 (an invalid parameter).
+ * This algorithm uses the cached projection polynomial, and searches for
+ * roots to find the best (max of 5) candidates. The roots are isolated
+ * on the intervals where the polynomial is monotone, which are found
+ * from the roots of its derivatives (in closed form for the cubic). As
+ * a result, this method cannot fail, and it does not allocate memory.
  *
  * @param  point    the point to project
  * @param  segment  the bezier segment to project upon
@@ -1088,47 +1717,46 @@ Vec2 Spline2::getProjectionSlow(const Vec2 point, int segment) const {
  * @return the parameterization of the nearest point on the spline.
  */
 Vec2 Spline2::getProjectionFast(const Vec2 point, int segment) const {
-    vector<float> roots;
-    
-    Polynomial poly = getProjectionPolynomial(point, segment);
-    
-    float epsilon = 1.0f / (1 << (MAX_DEPTH + 1));
-    bool success = poly.roots(roots, epsilon);
-    if (!success) {
-        // This will kick us to the slow method
-        return Vec2(-1, 0);
-    }
-    
-    Vec2 result;
-    
-    // Now compare the candidates
-    result.x = 0.0f;
-    Vec2 compare = getPoint(segment,0.0f) - point;
-    result.y = compare.lengthSquared();
-    
-    float t = 1.0f;
-    compare = getPoint(segment,1.0f) - point;
-    float d = compare.lengthSquared();
-    if (d < result.y) {
-        result.set(t, d);
+    CUAssertLog(segment >= 0 && segment < _size, "Illegal spline segment");
+    return getAcceleration()->project(segment, point);
+}
+
+/**
+ * Returns the projection cache for this spline, building it if necessary.
+ *
+ * @return the projection cache for this spline, building it if necessary.
+ */
+const Spline2::Acceleration* Spline2::getAcceleration() const {
+    if (_accel != nullptr || _size == 0) {
+        return _accel.get();
     }
     
-    // Check the roots
-    int RESOLUTION = (1 << MAX_DEPTH);
-    for (auto it = roots.begin(); it != roots.end(); ++it) {
-        float r = *it;
-        if (r != nanf("") && r > 0 && r < 1) {
-            // Convert to nearest step.
-            t = r*RESOLUTION;
-            t = roundf(t);
-            t /= RESOLUTION;
-            compare = getPoint(segment,t) - point;
-            d = compare.lengthSquared();
-            if (d < result.y) {
-                result.set(t, d);
-            }
+    auto accel = std::make_shared<Acceleration>();
+    accel->segments.resize(_size);
+    for(int ii = 0; ii < _size; ii++) {
+        const Vec2* src = _points.data()+3*ii;
+        Acceleration::Segment& seg = accel->segments[ii];
+        seg.a  = src[3]-3*src[2]+3*src[1]-src[0];
+        seg.b  = 3*src[2]-6*src[1]+3*src[0];
+        seg.c  = 3*(src[1]-src[0]);
+        seg.p0 = src[0];
+        seg.p3 = src[3];
+        seg.min = src[0];
+        seg.max = src[0];
+        for(int jj = 1; jj < 4; jj++) {
+            seg.min.x = std::min(seg.min.x,src[jj].x);
+            seg.min.y = std::min(seg.min.y,src[jj].y);
+            seg.max.x = std::max(seg.max.x,src[jj].x);
+            seg.max.y = std::max(seg.max.y,src[jj].y);
         }
+        seg.coeff[0] = 3*dot(seg.a,seg.a);
+        seg.coeff[1] = 5*dot(seg.a,seg.b);
+        seg.coeff[2] = 4*dot(seg.a,seg.c)+2*dot(seg.b,seg.b);
+        seg.coeff[3] = 3*dot(seg.b,seg.c);
+        seg.coeff[4] = dot(seg.c,seg.c);
     }
-    
-    return result;
+    accel->nodes.reserve(2*(_size/PROJECT_LEAF_SIZE)+1);
+    accel->build(0, _size);
+    _accel = accel;
+    return _accel.get();
 }
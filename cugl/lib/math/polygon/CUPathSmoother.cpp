@@ -42,11 +42,17 @@
 //
 #include <cugl/math/polygon/CUPathSmoother.h>
 #include <cugl/util/CUDebug.h>
+#include <cugl/util/CUThreadPool.h>
+#include <mutex>
 
 using namespace cugl;
 
 /* This makes sense as default for touch coordinates */
 #define DEFAULT_EPSILON 1
+/** The input size at which it is worth using a thread pool */
+#define SMOOTH_PARALLEL_LIMIT 65536
+/** The number of independent segments to create for each thread */
+#define SMOOTH_PARALLEL_SPLIT 8
 
 #pragma mark Constructors
 /**
@@ -93,72 +99,243 @@ void PathSmoother::clear() {
 }
 
 /**
- * Performs a triangulation of the current vertex data.
+ * Returns the position of the point farthest from the line through sp and ep
+ *
+ * The points searched are those in the range [start,end). The distance is
+ * not normalized; it is the magnitude of the cross product with ep-sp. Ties
+ * go to the earliest point. The points are processed four at a time (with
+ * SSE or Neon when the vectorized math library is enabled).
+ *
+ * @param points    The array of input points
+ * @param start     The first position to search
+ * @param end       The position after the last one to search
+ * @param sp        The start of the line
+ * @param ep        The end of the line
+ * @param dmax      Pointer to store the (unnormalized) distance
+ *
+ * @return the position of the point farthest from the line
+ */
+static size_t farthest(const Vec2* points, size_t start, size_t end,
+                       const Vec2 sp, const Vec2 ep, float* dmax) {
+    const float ux = ep.x-sp.x;
+    const float uy = ep.y-sp.y;
+    float best = -1;
+    size_t index = start;
+    
+    size_t ii = start;
+#if defined CU_MATH_VECTOR_SSE
+    const __m128 vux = _mm_set1_ps(ux);
+    const __m128 vuy = _mm_set1_ps(uy);
+    const __m128 vsx = _mm_set1_ps(sp.x);
+    const __m128 vsy = _mm_set1_ps(sp.y);
+    const __m128 mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    for(; ii+4 <= end; ii += 4) {
+        const float* src = &(points[ii].x);
+        __m128 a = _mm_loadu_ps(src);
+        __m128 b = _mm_loadu_ps(src+4);
+        __m128 xs = _mm_shuffle_ps(a,b,_MM_SHUFFLE(2,0,2,0));
+        __m128 ys = _mm_shuffle_ps(a,b,_MM_SHUFFLE(3,1,3,1));
+        __m128 c = _mm_sub_ps(_mm_mul_ps(vuy,_mm_sub_ps(xs,vsx)),_mm_mul_ps(vux,_mm_sub_ps(ys,vsy)));
+        c = _mm_and_ps(c,mask);
+        if (_mm_movemask_ps(_mm_cmpgt_ps(c,_mm_set1_ps(best)))) {
+            __attribute__((__aligned__(16))) float temp[4];
+            _mm_store_ps(temp,c);
+            for(size_t jj = 0; jj < 4; jj++) {
+                if (temp[jj] > best) {
+                    best = temp[jj];
+                    index = ii+jj;
+                }
+            }
+        }
+    }
+#elif defined CU_MATH_VECTOR_NEON64
+    const float32x4_t vux = vdupq_n_f32(ux);
+    const float32x4_t vuy = vdupq_n_f32(uy);
+    const float32x4_t vsx = vdupq_n_f32(sp.x);
+    const float32x4_t vsy = vdupq_n_f32(sp.y);
+    for(; ii+4 <= end; ii += 4) {
+        float32x4x2_t pts = vld2q_f32(&(points[ii].x));
+        float32x4_t c = vsubq_f32(vmulq_f32(vuy,vsubq_f32(pts.val[0],vsx)),
+                                  vmulq_f32(vux,vsubq_f32(pts.val[1],vsy)));
+        c = vabsq_f32(c);
+        if (vmaxvq_f32(c) > best) {
+            float temp[4];
+            vst1q_f32(temp,c);
+            for(size_t jj = 0; jj < 4; jj++) {
+                if (temp[jj] > best) {
+                    best = temp[jj];
+                    index = ii+jj;
+                }
+            }
+        }
+    }
+#endif
+    for(; ii < end; ii++) {
+        float c = fabsf(uy*(points[ii].x-sp.x)-ux*(points[ii].y-sp.y));
+        if (c > best) {
+            best = c;
+            index = ii;
+        }
+    }
+    
+    *dmax = best;
+    return index;
+}
+
+/**
+ * Performs a smoothing of the current vertex data.
  */
 void PathSmoother::calculate() {
-    douglasPeucker(0,_input.size()-1);
+    calculate(nullptr);
 }
 
 /**
- * Recursively performs Douglas-Peuker on the given input segment
+ * Performs a smoothing of the current vertex data with the given threads.
  *
- * The results will be pulled from _input and placed in _output.
+ * Large inputs are split across the thread pool, both when searching a
+ * long segment for its farthest point and when processing independent
+ * segments. The result is identical to {@link #calculate()}. Small
+ * inputs (or a null pool) are processed on the calling thread.
  *
- * @param start The first position in _input to process
- * @param end   The last position in _input to process
+ * This method blocks until the calculation is complete. It must not be
+ * called from a task in the same thread pool.
  *
- * @return the number of points preserved in smoothing
+ * @param threads   The thread pool to split the work across
  */
-size_t PathSmoother::douglasPeucker(size_t start, size_t end) {
-    const size_t OVER = (size_t)-1;
-    Vec2 sp = _input[start];
-    Vec2 ep = (end == OVER ? _input[0] : _input[end]);
-    if (end - start <= 1 || (end == OVER && start == _input.size()-1)) {
-        _output.push_back(sp);
-        _output.push_back(ep);
-        return 2;
-    } else if (sp == ep) {
-        _output.push_back(sp);
-        size_t index = OVER;
-        for(size_t ii = start+1; index == OVER && ii < end; ii++) {
-            Vec2 v = _input[ii];
-            if (v != sp) {
-                index = ii;
+void PathSmoother::calculate(const std::shared_ptr<ThreadPool>& threads) {
+    reset();
+    size_t size = _input.size();
+    _keep.assign(size,0);
+    if (size > 0) {
+        _keep[0] = 1;
+        _keep[size-1] = 1;
+    }
+    
+    _stack.clear();
+    if (size > 2) {
+        _stack.push_back(std::make_pair(0,size-1));
+    }
+    
+    if (threads && size > SMOOTH_PARALLEL_LIMIT) {
+        // Split breadth-first until there is enough independent work
+        size_t target = SMOOTH_PARALLEL_SPLIT*(threads->getThreadCount()+1);
+        size_t head = 0;
+        while (head < _stack.size() && _stack.size()-head < target) {
+            std::pair<size_t,size_t> seg = _stack[head++];
+            bool left;
+            size_t index = split(seg.first, seg.second, &left, threads.get());
+            if (index) {
+                _keep[index] = 1;
+                if (left) {
+                    _stack.push_back(std::make_pair(seg.first,index));
+                }
+                _stack.push_back(std::make_pair(index,seg.second));
             }
         }
-        if (index != OVER) {
-            return douglasPeucker( index, end)+1;
-        } else {
-            _output.push_back(ep);
-            return 2;
+        _stack.erase(_stack.begin(),_stack.begin()+head);
+        
+        // Segments only mark their interior, so they can run in parallel
+        threads->parallelFor(_stack.size(), [this](size_t start, size_t end) {
+            std::vector<std::pair<size_t,size_t>> local(_stack.begin()+start,_stack.begin()+end);
+            douglasPeucker(local);
+        });
+        _stack.clear();
+    } else {
+        douglasPeucker(_stack);
+    }
+    
+    for(size_t ii = 0; ii < size; ii++) {
+        if (_keep[ii]) {
+            _output.push_back(_input[ii]);
         }
     }
+    _calculated = true;
+}
 
-    float dMax = 0;
-    size_t index = 0;
-    for(size_t ii = start+1; ii < end; ii++) {
-        Vec2 v = _input[ii];
-        Vec2 u = ep-sp;
-        float dist = fabsf((u.y*v.x-u.x*v.y+ep.x*sp.y-ep.y*sp.x)/u.length());
-        if (dist > dMax) {
-            index = ii;
-            dMax = dist;
+/**
+ * Performs a single step of Douglas-Peuker on the given input segment
+ *
+ * If the segment must be split, this method returns the position of
+ * the split point. Normally both halves must be processed further.
+ * However, if the segment is a loop (its end points are the same), only
+ * the second half is processed, and the left flag is set to false.
+ *
+ * If the segment is smooth, this method returns 0 (which can never be
+ * a split point). If the thread pool is not null, the search of long
+ * segments is split across it.
+ *
+ * @param start     The first position in _input to process
+ * @param end       The last position in _input to process
+ * @param left      Pointer to store whether to process the first half
+ * @param threads   The thread pool for long segments (may be null)
+ *
+ * @return the position of the split point, or 0 if there is none
+ */
+size_t PathSmoother::split(size_t start, size_t end, bool* left, ThreadPool* threads) const {
+    *left = true;
+    if (end-start <= 1) {
+        return 0;
+    }
+    
+    Vec2 sp = _input[start];
+    Vec2 ep = _input[end];
+    if (sp == ep) {
+        // Skip to the first point off the loop start
+        *left = false;
+        for(size_t ii = start+1; ii < end; ii++) {
+            if (_input[ii] != sp) {
+                return ii;
+            }
         }
+        return 0;
     }
-
-    if (dMax > _epsilon) {
-        size_t result = 0;
-        result += douglasPeucker(start, index);
-        _output.pop_back();
-        result += douglasPeucker(index, end);
-        return result;
+    
+    const Vec2* points = _input.data();
+    float dmax = -1;
+    size_t index = start+1;
+    if (threads && end-start > SMOOTH_PARALLEL_LIMIT) {
+        std::mutex mutex;
+        size_t first = start+1;
+        threads->parallelFor(end-first, [&](size_t cstart, size_t cend) {
+            float dist;
+            size_t pos = farthest(points, first+cstart, first+cend, sp, ep, &dist);
+            std::unique_lock<std::mutex> lk(mutex);
+            if (dist > dmax || (dist == dmax && pos < index)) {
+                dmax = dist;
+                index = pos;
+            }
+        });
     } else {
-        _output.push_back(sp);
-        _output.push_back(ep);
-        return 2;
+        index = farthest(points, start+1, end, sp, ep, &dmax);
     }
     
-    return 0;
+    return (dmax > _epsilon*(ep-sp).length()) ? index : 0;
+}
+
+/**
+ * Iteratively performs Douglas-Peuker on the given input segments
+ *
+ * The segments are consumed from the given stack, which is used as the
+ * work list. The surviving interior points are marked in _keep. As the
+ * segments only mark their interior points, segments that do not
+ * overlap may be processed in parallel.
+ *
+ * @param stack The stack of segments to process
+ */
+void PathSmoother::douglasPeucker(std::vector<std::pair<size_t,size_t>>& stack) {
+    while (!stack.empty()) {
+        std::pair<size_t,size_t> seg = stack.back();
+        stack.pop_back();
+        bool left;
+        size_t index = split(seg.first, seg.second, &left, nullptr);
+        if (index) {
+            _keep[index] = 1;
+            stack.push_back(std::make_pair(index,seg.second));
+            if (left) {
+                stack.push_back(std::make_pair(seg.first,index));
+            }
+        }
+    }
 }
 
 
@@ -0,0 +1,431 @@
+//
+//  CUPolyClipper.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module is a factory for boolean operations (union, intersection,
+//  difference, xor) and offsets (inflating or deflating) on polygons. It is
+//  designed for batches. For example, you can set the walls of a level once
+//  and then clip the vision cone of every enemy against them each frame.
+//
+//  This factory is built on top of the famous Clipper library:
+//
+//      http://www.angusj.com/delphi/clipper.php
+//
+//  Since math objects are intended to be on the stack, we do not provide
+//  any shared pointer support in this class.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: agent
+//  Version: 10/19/26
+//
+#include <cugl/math/polygon/CUPolyClipper.h>
+#include <cugl/util/CUDebug.h>
+#include <cmath>
+#include <iterator>
+
+using namespace cugl;
+
+/** The default Clipper resolution */
+#define RESOLUTION 128
+
+#pragma mark -
+#pragma mark Initialization
+/**
+ * Creates a clipper with no polygon data.
+ */
+PolyClipper::PolyClipper() :
+_joint(ClipperLib::jtSquare),
+_resolution(RESOLUTION),
+_triangulate(true),
+_calculated(false) {
+}
+
+/**
+ * Appends the boundaries of the polygon to the given paths.
+ *
+ * @param poly  The polygon to convert
+ * @param paths The paths to append to
+ */
+void PolyClipper::append(const Poly2& poly, ClipperLib::Paths& paths) {
+    const std::vector<Vec2>& verts = poly.vertices();
+    switch (poly.getGeometry()) {
+        case Geometry::IMPLICIT:
+            append(verts.data(), verts.size(), paths);
+            break;
+        case Geometry::PATH:
+        {
+            std::vector<std::vector<Uint32>> bounds = poly.getGeometry().boundaries(poly.indices());
+            for(auto it = bounds.begin(); it != bounds.end(); ++it) {
+                paths.emplace_back();
+                ClipperLib::Path& path = paths.back();
+                path.reserve(it->size());
+                for(auto jt = it->begin(); jt != it->end(); ++jt) {
+                    const Vec2& v = verts[*jt];
+                    path.emplace_back((ClipperLib::cInt)std::round(v.x*_resolution),
+                                      (ClipperLib::cInt)std::round(v.y*_resolution));
+                }
+            }
+        }
+            break;
+        case Geometry::SOLID:
+        {
+            // Under the nonzero rule, the triangles merge into their union.
+            // Offsets must union the subjects first (see calculateOffset).
+            const std::vector<Uint32>& indices = poly.indices();
+            Vec2 tri[3];
+            for(size_t ii = 0; ii+2 < indices.size(); ii += 3) {
+                tri[0] = verts[indices[ii  ]];
+                tri[1] = verts[indices[ii+1]];
+                tri[2] = verts[indices[ii+2]];
+                append(tri, 3, paths);
+            }
+        }
+            break;
+        default:
+            CUAssertLog(false,"Polygon geometry does not support clipping");
+            break;
+    }
+}
+
+/**
+ * Appends the given closed contour to the given paths.
+ *
+ * @param points    The contour vertices
+ * @param size      The number of vertices
+ * @param paths     The paths to append to
+ */
+void PolyClipper::append(const Vec2* points, size_t size, ClipperLib::Paths& paths) {
+    paths.emplace_back();
+    ClipperLib::Path& path = paths.back();
+    path.reserve(size);
+    for(size_t ii = 0; ii < size; ii++) {
+        path.emplace_back((ClipperLib::cInt)std::round(points[ii].x*_resolution),
+                          (ClipperLib::cInt)std::round(points[ii].y*_resolution));
+    }
+}
+
+#pragma mark -
+#pragma mark Clipper Attributes
+/**
+ * Sets the joint value for offsets.
+ *
+ * The joint type determines how an inflated polygon is rounded at its
+ * corners. See {@link poly2::Joint} for the description of the types.
+ * A joint of NONE is treated as SQUARE.
+ *
+ * @param joint     The offset joint type
+ */
+void PolyClipper::setJoint(poly2::Joint joint) {
+    switch (joint) {
+        case poly2::Joint::MITRE:
+            _joint = ClipperLib::jtMiter;
+            break;
+        case poly2::Joint::ROUND:
+            _joint = ClipperLib::jtRound;
+            break;
+        default:
+            _joint = ClipperLib::jtSquare;
+            break;
+    }
+}
+
+/**
+ * Returns the joint value for offsets.
+ *
+ * The joint type determines how an inflated polygon is rounded at its
+ * corners. See {@link poly2::Joint} for the description of the types.
+ *
+ * @return the joint value for offsets.
+ */
+poly2::Joint PolyClipper::getJoint() const {
+    switch (_joint) {
+        case ClipperLib::jtMiter:
+            return poly2::Joint::MITRE;
+        case ClipperLib::jtRound:
+            return poly2::Joint::ROUND;
+        default:
+            return poly2::Joint::SQUARE;
+    }
+}
+
+#pragma mark -
+#pragma mark Calculation
+/**
+ * Clears all computed data, but still maintains the settings.
+ *
+ * This method preserves all subject and clip polygons, as well as the
+ * joint, precision, and triangulation settings.
+ */
+void PolyClipper::reset() {
+    _solution.Clear();
+    _output.clear();
+    _calculated = false;
+}
+
+/**
+ * Clears all internal data, including the subject and clip polygons.
+ *
+ * The joint, precision, and triangulation settings are preserved.
+ */
+void PolyClipper::clear() {
+    reset();
+    _subject.clear();
+    _clip.clear();
+    _merged.clear();
+}
+
+/**
+ * Performs a boolean operation on the current polygon data.
+ *
+ * The operation combines all of the subject polygons with all of the
+ * clip polygons. Both sets use the nonzero fill rule.
+ *
+ * @param type  The boolean operation
+ */
+void PolyClipper::calculate(poly2::ClipType type) {
+    reset();
+    ClipperLib::ClipType op = ClipperLib::ctUnion;
+    switch (type) {
+        case poly2::ClipType::INTERSECTION:
+            op = ClipperLib::ctIntersection;
+            break;
+        case poly2::ClipType::DIFFERENCE:
+            op = ClipperLib::ctDifference;
+            break;
+        case poly2::ClipType::XOR:
+            op = ClipperLib::ctXor;
+            break;
+        default:
+            break;
+    }
+
+    // The triangulators require contours that do not touch themselves
+    _clipper.Clear();
+    _clipper.StrictlySimple(_triangulate);
+    _clipper.AddPaths(_subject, ClipperLib::ptSubject, true);
+    _clipper.AddPaths(_clip, ClipperLib::ptClip, true);
+    _clipper.Execute(op, _solution, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+    processSolution();
+}
+
+/**
+ * Performs an offset of the current subject polygons.
+ *
+ * A positive delta inflates the polygons, while a negative one deflates
+ * them. The subjects are merged (with the nonzero rule) before they are
+ * offset, so overlapping subjects, and the triangles of a SOLID polygon,
+ * are offset as a single shape. The clip polygons are ignored.
+ *
+ * @param delta The offset distance
+ */
+void PolyClipper::calculateOffset(float delta) {
+    reset();
+
+    // ClipperOffset offsets each path on its own, so merge them first
+    _clipper.Clear();
+    _clipper.StrictlySimple(false);
+    _clipper.AddPaths(_subject, ClipperLib::ptSubject, true);
+    _clipper.Execute(ClipperLib::ctUnion, _merged, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+
+    _offset.Clear();
+    _offset.ArcTolerance = 0.25*_resolution;
+    _offset.AddPaths(_merged, _joint, ClipperLib::etClosedPolygon);
+    _offset.Execute(_solution, delta*_resolution);
+    processSolution();
+}
+
+/**
+ * Materializes the Clipper solution after a calculation.
+ */
+void PolyClipper::processSolution() {
+    if (_triangulate) {
+        for(auto it = _solution.Childs.begin(); it != _solution.Childs.end(); ++it) {
+            processNode(*it);
+        }
+    }
+    _output._geom = Geometry::SOLID;
+    if (!_output._vertices.empty()) {
+        _output.computeBounds();
+    }
+    _calculated = true;
+}
+
+/**
+ * Converts the contour of a Clipper node back to float coordinates.
+ *
+ * The result is stored in the given buffer, which is cleared first.
+ *
+ * @param node      The Clipper node
+ * @param buffer    The buffer to store the contour
+ */
+void PolyClipper::convert(const ClipperLib::PolyNode* node, std::vector<Vec2>& buffer) const {
+    buffer.clear();
+    buffer.reserve(node->Contour.size());
+    double scale = 1.0/_resolution;
+    for(auto it = node->Contour.begin(); it != node->Contour.end(); ++it) {
+        buffer.push_back(Vec2((float)(it->X*scale),(float)(it->Y*scale)));
+    }
+}
+
+/**
+ * Triangulates a single outer node of the Clipper solution
+ *
+ * The node and its immediate holes are triangulated into the output.
+ * This is a recursive method that also processes any islands inside
+ * of the holes.
+ *
+ * @param node  The (outer) PolyNode to triangulate
+ */
+void PolyClipper::processNode(const ClipperLib::PolyNode* node) {
+    convert(node, _contour);
+    if (node->Childs.empty()) {
+        _simple.set(_contour);
+        _simple.calculate();
+        _simple.getPolygon(&_output);
+        return;
+    }
+
+    _complex.clear();
+    _complex.set(_contour);
+    for(auto it = node->Childs.begin(); it != node->Childs.end(); ++it) {
+        convert(*it, _contour);
+        _complex.addHole(_contour);
+    }
+    _complex.calculate();
+    _complex.getPolygon(&_output);
+
+    for(auto it = node->Childs.begin(); it != node->Childs.end(); ++it) {
+        for(auto jt = (*it)->Childs.begin(); jt != (*it)->Childs.end(); ++jt) {
+            processNode(*jt);
+        }
+    }
+}
+
+#pragma mark -
+#pragma mark Materialization
+/**
+ * Returns a polygon representing the triangulated result.
+ *
+ * The polygon contains a completely new set of vertices together with
+ * the indices defining a solid shape. The clipper does not maintain
+ * references to this polygon and it is safe to modify it.
+ *
+ * If the calculation is not yet performed, or triangulation is disabled,
+ * this method will return the empty polygon.
+ *
+ * @return a polygon representing the triangulated result.
+ */
+Poly2 PolyClipper::getPolygon() const {
+    return _output;
+}
+
+/**
+ * Stores the triangulated result in the given buffer.
+ *
+ * This method will add both the new vertices, and the corresponding
+ * indices to the new buffer.  If the buffer is not empty, the indices
+ * will be adjusted accordingly. You should clear the buffer first if
+ * you do not want to preserve the original data.
+ *
+ * If the calculation is not yet performed, or triangulation is disabled,
+ * this method will do nothing.
+ *
+ * @param buffer    The buffer to store the triangulated result
+ *
+ * @return a reference to the buffer for chaining.
+ */
+Poly2* PolyClipper::getPolygon(Poly2* buffer) const {
+    CUAssertLog(buffer, "Destination buffer is null");
+    CUAssertLog(buffer->_geom == Geometry::SOLID || buffer->_geom == Geometry::IMPLICIT,
+                "Buffer geometry is incompatible with this result.");
+    if (_calculated && !_output._vertices.empty()) {
+        if (buffer->_vertices.size() == 0) {
+            buffer->_vertices = _output._vertices;
+            buffer->_indices  = _output._indices;
+        } else {
+            int offset = (int)buffer->_vertices.size();
+            buffer->_vertices.reserve(offset+_output._vertices.size());
+            std::copy(_output._vertices.begin(),_output._vertices.end(),std::back_inserter(buffer->_vertices));
+
+            buffer->_indices.reserve(buffer->_indices.size()+_output._indices.size());
+            for(auto it = _output._indices.begin(); it != _output._indices.end(); ++it) {
+                buffer->_indices.push_back(offset+*it);
+            }
+        }
+        buffer->_geom = Geometry::SOLID;
+        buffer->computeBounds();
+    }
+    return buffer;
+}
+
+/**
+ * Returns the contours of the result as closed paths.
+ *
+ * Each contour is a separate polygon with geometry `PATH`. Holes are
+ * included, and are oriented opposite to the outer contours.
+ *
+ * If the calculation is not yet performed, this method will return the
+ * empty list.
+ *
+ * @return the contours of the result as closed paths.
+ */
+std::vector<Poly2> PolyClipper::getPaths() const {
+    std::vector<Poly2> result;
+    getPaths(result);
+    return result;
+}
+
+/**
+ * Stores the contours of the result in the given buffer.
+ *
+ * Each contour is appended as a separate polygon with geometry `PATH`.
+ * Holes are included, and are oriented opposite to the outer contours.
+ *
+ * If the calculation is not yet performed, this method will do nothing.
+ *
+ * @param buffer    The buffer to store the contours
+ *
+ * @return the number of contours added to the buffer
+ */
+size_t PolyClipper::getPaths(std::vector<Poly2>& buffer) const {
+    if (!_calculated) {
+        return 0;
+    }
+    size_t count = 0;
+    for(const ClipperLib::PolyNode* node = _solution.GetFirst(); node != nullptr; node = node->GetNext()) {
+        if (node->Contour.size() < 2) {
+            continue;
+        }
+        buffer.emplace_back();
+        Poly2& poly = buffer.back();
+        convert(node, poly._vertices);
+        Uint32 size = (Uint32)poly._vertices.size();
+        poly._indices.reserve(2*size);
+        for(Uint32 ii = 0; ii < size; ii++) {
+            poly._indices.push_back(ii);
+            poly._indices.push_back(ii+1 == size ? 0 : ii+1);
+        }
+        poly._geom = Geometry::PATH;
+        poly.computeBounds();
+        count++;
+    }
+    return count;
+}
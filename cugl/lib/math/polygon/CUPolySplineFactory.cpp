@@ -35,9 +35,12 @@
 #include <cugl/math/polygon/CUPolySplineFactory.h>
 #include <cugl/util/CUDebug.h>
 #include <iterator>
+#include <algorithm>
 
 /** Tolerance to identify a point as "smooth" */
 #define SMOOTH_TOLERANCE    0.0001f
+/** Maximum subdivision depth for de Castlejau's */
+#define MAX_DEPTH   8
 
 using namespace cugl;
 
@@ -67,7 +70,7 @@ void PolySplineFactory::calculate(Criterion criterion, float tolerance) {
     if (!_spline) { return; }
     
     for (int ii = 0; ii < _spline->_size; ii++) {
-        generate(_spline->_points, (3 * ii), (float)ii, tolerance, criterion, 0);
+        generate(_spline->_points.data()+3*ii, (float)ii, tolerance, criterion);
     }
     
     // Push back last point and parameter
@@ -78,76 +81,96 @@ void PolySplineFactory::calculate(Criterion criterion, float tolerance) {
 }
 
 /**
- * Generates data via recursive use of de Castlejau's
+ * Generates data via repeated use of de Castlejau's
  *
- * This method is the recursive helper for calculate(). It performs
- * de Castlejau's algorithm and stores the data in the buffer.  You
- * will never call this method directly.
+ * This method is the helper for calculate(). It performs de Castlejau's
+ * algorithm on a single bezier and stores the data in the buffer. The
+ * subdivision is depth first, using a fixed stack of control points
+ * rather than recursion, so it does not allocate any memory (other than
+ * to grow the buffers). You will never call this method directly.
  *
- * @param  src          the control point list for the bezier
- * @param  soff         the offset into the control point list
- * @param  tp           the parameter to split at
+ * @param  src          the control points for the bezier
+ * @param  tp           the parameter of the first anchor
  * @param  tolerance    the error tolerance of the stopping condition
  * @param  criterion    the stopping condition criterion
- * @param  depth        the current depth of the recursive call
  *
- * @return The number of (anchor) points generated by this recursive call.
+ * @return The number of (anchor) points generated by this call.
  */
-int PolySplineFactory::generate(const std::vector<Vec2>& src, int soff, float tp,
-                                      float tolerance, PolySplineFactory::Criterion criterion,
-                                      int depth) {
-    // Do not go to far
-    bool terminate = (depth >= 8) || (soff >= src.size() - 1);
+int PolySplineFactory::generate(const Vec2* src, float tp, float tolerance,
+                                PolySplineFactory::Criterion criterion) {
+    // Each level of subdivision leaves at most one right half on the stack
+    Vec2  curves[MAX_DEPTH+2][4];
+    float params[MAX_DEPTH+2];
+    int   depths[MAX_DEPTH+2];
+    int   top = 0;
+    
+    std::copy(src, src+4, curves[0]);
+    params[0] = tp;
+    depths[0] = 0;
+    
+    int result = 0;
+    while (top >= 0) {
+        const Vec2* curve = curves[top];
+        int depth = depths[top];
         
-    // Check if we are at the bottom level
-    if (!terminate && criterion == PolySplineFactory::Criterion::SPACING) {
-        Vec2 temp0 = src[soff + 3] - src[soff];             // p3 - p0
-        terminate = temp0.length() < tolerance;
-    }
-    else if (!terminate && (criterion == PolySplineFactory::Criterion::DISTANCE ||
-                                criterion == PolySplineFactory::Criterion::FLAT)) {
-        Vec2 temp0 = src[soff + 3] - src[soff];             // p3 - p0
-        float leng = 1.0f;
-        if (criterion == PolySplineFactory::Criterion::FLAT) {
-            leng = temp0.length();
-        }
+        // Do not go to far
+        bool terminate = (depth >= MAX_DEPTH);
+        
+        // Check if we are at the bottom level
+        if (!terminate && criterion == PolySplineFactory::Criterion::SPACING) {
+            Vec2 temp0 = curve[3] - curve[0];               // p3 - p0
+            terminate = temp0.length() < tolerance;
+        } else if (!terminate && (criterion == PolySplineFactory::Criterion::DISTANCE ||
+                                  criterion == PolySplineFactory::Criterion::FLAT)) {
+            Vec2 temp0 = curve[3] - curve[0];               // p3 - p0
+            float leng = 1.0f;
+            if (criterion == PolySplineFactory::Criterion::FLAT) {
+                leng = temp0.length();
+            }
             
-        Vec2 temp1 = src[soff + 1] - src[soff];             // p1 - p0
-        temp1.normalize();
-        float scale = temp0.dot(temp1);
-        temp1 *= scale;
-        temp0 -= temp1;
+            Vec2 temp1 = curve[1] - curve[0];               // p1 - p0
+            temp1.normalize();
+            float scale = temp0.dot(temp1);
+            temp1 *= scale;
+            temp0 -= temp1;
             
-        terminate = (temp0.length() < tolerance*leng);
-    
-        temp0 = src[soff] - src[soff + 3];                  // p0 - p3
-        temp1 = src[soff + 2] - src[soff + 3];              // p2 - p3
-        temp1.normalize();
-        scale = temp0.dot(temp1);
-        temp1 *= scale;
-        temp0 -= temp1;
+            terminate = (temp0.length() < tolerance*leng);
             
-        terminate = terminate && (temp0.length() < tolerance*leng);
-    }
-        
-    // Add the first point if terminating.
-    int result = 0;
-    if (terminate) {
-        _parambuff.push_back(tp);
-        _pointbuff.push_back(src[soff]);
-        _pointbuff.push_back(src[soff + 1]);
-        _pointbuff.push_back(src[soff + 2]);
-        return 1;
-    }
+            temp0 = curve[0] - curve[3];                    // p0 - p3
+            temp1 = curve[2] - curve[3];                    // p2 - p3
+            temp1.normalize();
+            scale = temp0.dot(temp1);
+            temp1 *= scale;
+            temp0 -= temp1;
+            
+            terminate = terminate && (temp0.length() < tolerance*leng);
+        }
         
-    std::vector<Vec2> left;
-    std::vector<Vec2> rght;
-    Spline2::subdivide(src, soff, 0.5, left, rght);
+        // Add the first point if terminating.
+        if (terminate) {
+            _parambuff.push_back(params[top]);
+            _pointbuff.push_back(curve[0]);
+            _pointbuff.push_back(curve[1]);
+            _pointbuff.push_back(curve[2]);
+            result++;
+            top--;
+            continue;
+        }
         
-    // Recursive calls
-    float sp = tp + 1.0f / (1 << (depth + 1));
-    result =  generate(left, 0, tp, tolerance, criterion, depth + 1);
-    result += generate(rght, 0, sp, tolerance, criterion, depth + 1);
+        // Replace the top with the right half, and push the left
+        Vec2 left[4];
+        Vec2 rght[4];
+        Spline2::subdivide(curve, 0.5f, left, rght);
+        float lp = params[top];
+        float sp = lp + 1.0f / (1 << (depth + 1));
+        std::copy(rght, rght+4, curves[top]);
+        params[top] = sp;
+        depths[top] = depth+1;
+        top++;
+        std::copy(left, left+4, curves[top]);
+        params[top] = lp;
+        depths[top] = depth+1;
+    }
     return result;
 }
 
@@ -296,7 +319,7 @@ std::vector<float> PolySplineFactory::getParameters() const {
  *
  * @return the number of elements added to the buffer
  */
-size_t PolySplineFactory::getParameters(std::vector<float> buffer) {
+size_t PolySplineFactory::getParameters(std::vector<float>& buffer) {
     if (_calculated) {
         buffer.reserve(buffer.size()+_parambuff.size());
         std::copy(_parambuff.begin(),_parambuff.end(),std::back_inserter(buffer));
@@ -366,7 +389,7 @@ std::vector<Vec2> PolySplineFactory::getTangents() const {
  *
  * @return the number of elements added to the buffer
  */
-size_t PolySplineFactory::getTangents(std::vector<Vec2> buffer) {
+size_t PolySplineFactory::getTangents(std::vector<Vec2>& buffer) {
     const std::vector<Vec2>* points = getActivePoints();
     if (!points) { return 0; }
 
@@ -492,7 +515,7 @@ std::vector<Vec2> PolySplineFactory::getNormals() const {
  *
  * @return the number of elements added to the buffer
  */
-size_t PolySplineFactory::getNormals(std::vector<Vec2> buffer) {
+size_t PolySplineFactory::getNormals(std::vector<Vec2>& buffer) {
     const std::vector<Vec2>* points = getActivePoints();
 
     int size = (int)points->size();
@@ -44,6 +44,7 @@
 #include <cugl/math/polygon/CUSimpleExtruder.h>
 #include <cugl/util/CUDebug.h>
 #include <iterator>
+#include <algorithm>
 
 /** The number of segments to use in a rounded joint */
 #define PRECISION 10
@@ -129,7 +130,13 @@ SimpleExtruder::SimpleExtruder() :
 _joint(poly2::Joint::SQUARE),
 _endcap(poly2::EndCap::NONE),
 _precision(PRECISION),
-_calculated(false) {
+_uniform(false),
+_stroke(0),
+_calculated(false),
+_vstart(0),
+_vcount(0),
+_istart(0),
+_icount(0) {
 }
 
 /**
@@ -145,7 +152,13 @@ SimpleExtruder::SimpleExtruder(const std::vector<Vec2>& points, bool closed) :
 _joint(poly2::Joint::SQUARE),
 _endcap(poly2::EndCap::NONE),
 _precision(PRECISION),
-_calculated(false) {
+_uniform(false),
+_stroke(0),
+_calculated(false),
+_vstart(0),
+_vcount(0),
+_istart(0),
+_icount(0) {
     set(points,closed);
 }
 
@@ -167,7 +180,13 @@ SimpleExtruder::SimpleExtruder(const Poly2& poly)  :
 _joint(poly2::Joint::SQUARE),
 _endcap(poly2::EndCap::NONE),
 _precision(PRECISION),
-_calculated(false) {
+_uniform(false),
+_stroke(0),
+_calculated(false),
+_vstart(0),
+_vcount(0),
+_istart(0),
+_icount(0) {
     set(poly);
 }
 
@@ -189,11 +208,14 @@ void SimpleExtruder::set(const Poly2& poly) {
     reset();
     switch (poly.getGeometry()) {
         case Geometry::IMPLICIT:
-            _input.push_back(poly._vertices);
-            _closed.push_back(true);
+            _input.resize(1);
+            _input[0].assign(poly._vertices.begin(),poly._vertices.end());
+            _closed.assign(1,true);
             break;
         case Geometry::PATH:
         {
+            _input.clear();
+            _closed.clear();
             size_t first = 0;
             while (first < poly._indices.size()) {
                 size_t last = first;
@@ -232,6 +254,8 @@ void SimpleExtruder::reset() {
     _outverts.clear();
     _outindx.clear();
     _calculated = false;
+    _vstart = _vcount = 0;
+    _istart = _icount = 0;
 }
 
 /**
@@ -270,12 +294,15 @@ void SimpleExtruder::clear() {
  * @param stroke    The stroke width of the extrusion
  */
 void SimpleExtruder::calculate(float stroke) {
+    _stroke = stroke;
     if (_input.size() == 0) {
         _calculated = true;
         return;
     }
     _outverts.clear();
     _outindx.clear();
+    Uint32 jverts, jindx;
+    computeJointSize(&jverts, &jindx);
    
     for(size_t seg = 0; seg < _input.size(); seg++) {
         std::vector<Vec2>* input = &_input[seg];
@@ -295,7 +322,11 @@ void SimpleExtruder::calculate(float stroke) {
             count += 1;
         }
         computeSize(count, &vcount, &icount);
-        _outverts.reserve(_outverts.size()+vcount*2);
+        if (_uniform) {
+            vcount += jverts*2;
+            icount += jindx*2;
+        }
+        _outverts.reserve(_outverts.size()+vcount);
         _outindx.reserve(_outindx.size()+icount);
         
         // Thanks Kivy guys for all the hard work.
@@ -304,7 +335,7 @@ void SimpleExtruder::calculate(float stroke) {
         // Initialize the data
         data.stroke = stroke;
         data.joint = _joint;
-        data.cap = _endcap;
+        data.cap = _truecap;
         
         // Iterate through the path
         data.angle = data.sangle = 0;
@@ -318,7 +349,11 @@ void SimpleExtruder::calculate(float stroke) {
             data.index = ii;
             
             makeSegment(a, b, &data);
+            Uint32 start = data.pos;
+            size_t vmark = _outverts.size();
+            size_t imark = _outindx.size();
             makeJoint(a, &data);
+            finishJoint(a, start, vmark, imark, &data);
         }
         
         // Process the caps
@@ -326,13 +361,128 @@ void SimpleExtruder::calculate(float stroke) {
         
         // If closed, make one last joint
         if (closed && mod > 2) {
+            Uint32 start = data.pos;
+            size_t vmark = _outverts.size();
+            size_t imark = _outindx.size();
             makeLastJoint(input, &data);
+            finishJoint(input->at(0), start, vmark, imark, &data);
         }
     }
     
+    _vstart = 0;
+    _vcount = (Uint32)_outverts.size();
+    _istart = 0;
+    _icount = (Uint32)_outindx.size();
     _calculated = true;
 }
 
+/**
+ * Moves a single point of the path and re-extrudes only what it affects.
+ *
+ * The extruder must have a single path (as given to the vector version
+ * of {@link #set}) and index is a position in that path. If the extrusion
+ * is uniform and has already been calculated, this method recomputes
+ * only the two segments adjacent to the point and the three joints
+ * around them, in place. The changed range of the output is available
+ * from {@link #getUpdateRange}.
+ *
+ * Otherwise, and whenever the point affects an end cap (or the closing
+ * joint of a closed path), this method recalculates everything with the
+ * previous stroke width. In that case it returns false, and the update
+ * range is the entire output.
+ *
+ * @param index The index of the point to move
+ * @param point The new position of the point
+ *
+ * @return true if the extrusion was updated incrementally
+ */
+bool SimpleExtruder::update(Uint32 index, const Vec2 point) {
+    CUAssertLog(_input.size() == 1, "Incremental updates require a single path");
+    CUAssertLog(index < _input[0].size(), "Index %d is out of bounds", index);
+    std::vector<Vec2>* input = &_input[0];
+    input->at(index) = point;
+    
+    // Segment ii runs from point ii to ii+1, and is followed by the joint at
+    // point ii. So the point affects segments index-1 and index, and the
+    // joints after segments index-1 to index+1. The end caps (and closing
+    // joint) depend on the first and last segment.
+    Uint32 mod = (Uint32)input->size();
+    Uint32 count = (_closed[0] && mod > 2) ? mod+1 : mod;
+    if (!_calculated || !_uniform || index < 2 || index+3 > count) {
+        calculate(_stroke);
+        return false;
+    }
+    
+    Uint32 jverts, jindx;
+    computeJointSize(&jverts, &jindx);
+    Uint32 bverts = 4+jverts;
+    Uint32 bindx  = 6+jindx;
+    Uint32 first = index-1;
+    Uint32 last  = index+1;
+    
+    // Extrude into the scratch buffers, with the correct output positions
+    std::swap(_outverts,_scratchverts);
+    std::swap(_outindx, _scratchindx);
+    _outverts.clear();
+    _outindx.clear();
+
+    KivyData data;
+    data.stroke = _stroke;
+    data.joint = _joint;
+    data.cap = _truecap;
+    data.angle = data.sangle = 0;
+    data.pangle = data.pangle2 = 0;
+    data.anchor = 0;
+    
+    // Prime the previous segment (its output is discarded)
+    data.index = first-1;
+    data.pos = data.ppos = data.p2pos = (first-1)*bverts;
+    makeSegment(input->at(first-1), input->at(first), &data);
+    data.pos = first*bverts;
+    size_t vbase = _outverts.size();
+    size_t ibase = _outindx.size();
+    for(Uint32 ii = first; ii <= last; ii++) {
+        Vec2 a = input->at(  ii   % mod);
+        Vec2 b = input->at((ii+1) % mod);
+        data.index = ii;
+        
+        makeSegment(a, b, &data);
+        Uint32 start = data.pos;
+        size_t vmark = _outverts.size();
+        size_t imark = _outindx.size();
+        makeJoint(a, &data);
+        finishJoint(a, start, vmark, imark, &data);
+    }
+    
+    std::swap(_outverts,_scratchverts);
+    std::swap(_outindx, _scratchindx);
+    _vstart = first*bverts;
+    _vcount = (last-first+1)*bverts;
+    _istart = first*bindx;
+    _icount = (last-first+1)*bindx;
+    std::copy(_scratchverts.begin()+vbase, _scratchverts.end(), _outverts.begin()+_vstart);
+    std::copy(_scratchindx.begin()+ibase, _scratchindx.end(), _outindx.begin()+_istart);
+    return true;
+}
+
+/**
+ * Retrieves the output range changed by the last calculation.
+ *
+ * After a call to {@link #calculate} this is the entire output. After
+ * a call to {@link #update} it is the range that was recomputed.
+ *
+ * @param vstart    Pointer to store the first changed vertex
+ * @param vcount    Pointer to store the number of changed vertices
+ * @param istart    Pointer to store the first changed index
+ * @param icount    Pointer to store the number of changed indices
+ */
+void SimpleExtruder::getUpdateRange(Uint32* vstart, Uint32* vcount, Uint32* istart, Uint32* icount) const {
+    *vstart = _vstart;
+    *vcount = _vcount;
+    *istart = _istart;
+    *icount = _icount;
+}
+
 /**
  * Computes the number of vertices and indices necessary for the extrusion.
  *
@@ -385,6 +535,66 @@ void SimpleExtruder::computeSize(Uint32 insize, Uint32* vcount, Uint32* icount)
     }
 }
 
+/**
+ * Computes the number of vertices and indices in a uniform joint.
+ *
+ * This is the largest number that any single joint may produce.
+ *
+ * @param vcount    Pointer to store the number of joint vertices
+ * @param icount    Pointer to store the number of joint indices
+ */
+void SimpleExtruder::computeJointSize(Uint32* vcount, Uint32* icount) const {
+    switch (_joint) {
+        case poly2::Joint::SQUARE:
+            *vcount = 1;
+            *icount = 3;
+            break;
+        case poly2::Joint::ROUND:
+            *vcount = _precision;
+            *icount = _precision * 3;
+            break;
+        case poly2::Joint::MITRE:
+            *vcount = 2;
+            *icount = 6;
+            break;
+        case poly2::Joint::NONE:
+            *vcount = 0;
+            *icount = 0;
+            break;
+    }
+}
+
+/**
+ * Finishes the joint started at the given output positions.
+ *
+ * If the extrusion is uniform, this pads the joint with degenerate
+ * triangles to the size given by {@link #computeJointSize}. In either
+ * case, it makes sure that the vertex position for the next segment
+ * follows the joint (which is not the case for a failed mitre).
+ *
+ * @param a     The generating point of the joint
+ * @param start The vertex position at the start of the joint
+ * @param vmark The size of the vertex output at the start of the joint
+ * @param imark The size of the index output at the start of the joint
+ * @param data  The data necessary to run the Kivy algorithm.
+ */
+void SimpleExtruder::finishJoint(const Vec2 a, Uint32 start, size_t vmark, size_t imark, KivyData* data) {
+    if (!_uniform) {
+        data->pos = start+(Uint32)(_outverts.size()-vmark);
+        return;
+    }
+    
+    Uint32 jverts, jindx;
+    computeJointSize(&jverts, &jindx);
+    while (_outverts.size() < vmark+jverts) {
+        _outverts.push_back(a);
+    }
+    while (_outindx.size() < imark+jindx) {
+        _outindx.push_back(start-1);
+    }
+    data->pos = start+jverts;
+}
+
 /**
  * Creates the extruded line segment from a to b.
  *
@@ -860,3 +1070,62 @@ Poly2* SimpleExtruder::getPolygon(Poly2* buffer) {
     }
     return buffer;
 }
+
+/**
+ * Copies the output range changed by the last update into the buffer.
+ *
+ * The buffer must contain exactly the result of a previous call to
+ * {@link #getPolygon} (on an empty buffer) for this extrusion. Only the
+ * vertices and indices in the {@link #getUpdateRange} are copied, and
+ * the bounds are updated incrementally where possible. This allows a
+ * path to be dragged without any reallocation.
+ *
+ * If the buffer does not match the size of the extrusion, this method
+ * clears it and calls {@link #getPolygon} instead.
+ *
+ * @param buffer    The buffer storing the extruded polygon
+ *
+ * @return a reference to the buffer for chaining.
+ */
+Poly2* SimpleExtruder::updatePolygon(Poly2* buffer) {
+    CUAssertLog(buffer, "Destination buffer is null");
+    if (!_calculated) {
+        return buffer;
+    } else if (buffer->_vertices.size() != _outverts.size() ||
+               buffer->_indices.size() != _outindx.size()) {
+        buffer->clear();
+        return getPolygon(buffer);
+    }
+    
+    // The bounds only need a full pass if we move a vertex on the boundary
+    const Rect& bounds = buffer->_bounds;
+    float minx = bounds.getMinX();
+    float maxx = bounds.getMaxX();
+    float miny = bounds.getMinY();
+    float maxy = bounds.getMaxY();
+    bool boundary = false;
+    // The maximum is rounded through the size, so allow some slack
+    float slack = CU_MATH_EPSILON*(1+std::max(fabsf(maxx),fabsf(maxy)));
+    for(Uint32 ii = _vstart; ii < _vstart+_vcount; ii++) {
+        const Vec2& old = buffer->_vertices[ii];
+        const Vec2& now = _outverts[ii];
+        boundary = boundary || old.x <= bounds.getMinX() || old.x >= bounds.getMaxX()-slack;
+        boundary = boundary || old.y <= bounds.getMinY() || old.y >= bounds.getMaxY()-slack;
+        minx = std::min(minx,now.x);
+        maxx = std::max(maxx,now.x);
+        miny = std::min(miny,now.y);
+        maxy = std::max(maxy,now.y);
+        buffer->_vertices[ii] = now;
+    }
+    std::copy(_outindx.begin()+_istart, _outindx.begin()+_istart+_icount,
+              buffer->_indices.begin()+_istart);
+    
+    if (boundary) {
+        buffer->computeBounds();
+    } else {
+        buffer->_bounds.origin.set(minx,miny);
+        buffer->_bounds.size.set(maxx-minx,maxy-miny);
+        buffer->_accel = nullptr;
+    }
+    return buffer;
+}
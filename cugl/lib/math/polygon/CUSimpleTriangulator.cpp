@@ -10,8 +10,12 @@
 //  Because math objects are intended to be on the stack, we do not provide
 //  any shared pointer support in this class.
 //
-//  This implementation is largely inspired by the LibGDX implementation from
-//  Nicolas Gramlich, Eric Spits, Thomas Cate, and Nathan Sweet.
+//  By default, this class uses a sweep-line monotone partition, which runs
+//  in O(n log n) time. The original ear clipping algorithm (which is O(n^2))
+//  is still available, and is used as a fallback for degenerate input. The
+//  ear clipping implementation is largely inspired by the LibGDX
+//  implementation from Nicolas Gramlich, Eric Spits, Thomas Cate, and
+//  Nathan Sweet.
 //
 //  CUGL MIT License:
 //      This software is provided 'as-is', without any express or implied
@@ -37,12 +41,22 @@
 
 #include <cugl/math/polygon/CUSimpleTriangulator.h>
 #include <cugl/util/CUDebug.h>
+#include <algorithm>
 #include <iterator>
+#include <cmath>
 
 /** Computes the previous index in a vector, treating it as a circular queue */
 #define PREV(i,idx) ((i == 0 ? (int)idx.size() : i) - 1)
 /** Computes the next index in a vector, treating it as a circular queue */
 #define NEXT(i,idx) ((i + 1) % (int)idx.size())
+/** The pseudo-edge representing the current sweep vertex in the status */
+#define QUERY_EDGE  ((Uint32)-1)
+/** The chain classification of a vertex on the left of a monotone polygon */
+#define LEFT_CHAIN  0
+/** The chain classification of a vertex on the right of a monotone polygon */
+#define RIGHT_CHAIN 1
+/** The chain classification of the top and bottom of a monotone polygon */
+#define BOTH_CHAINS 2
 
 using namespace cugl;
 
@@ -80,37 +94,57 @@ void SimpleTriangulator::set(const Poly2& poly) {
 
 /**
  * Performs a triangulation of the current vertex data.
+ *
+ * Intermediate buffers are cleared but not released, so they are reused
+ * by the next calculation.
  */
 void SimpleTriangulator::calculate() {
     reset();
     int vcount = (int)_input.size();
     
+    // A polygon with n vertices has a triangulation of n-2 triangles.
+    int size = (vcount-2 > 0 ? vcount-2 : 0)*3;
+    _output.reserve(size);
+    if (_earclip || !computeMonotone()) {
+        _output.clear();
+        computeEarClipping();
+    }
+    trimColinear();
+    _calculated = true;
+}
+
+/**
+ * Computes an ear clipping triangulation of the current vertex data.
+ *
+ * This is the original O(n^2) algorithm, and produces counter-clockwise
+ * triangles in the output.
+ */
+void SimpleTriangulator::computeEarClipping() {
+    int vcount = (int)_input.size();
+    
+    _naive.clear();
     _naive.reserve(vcount);
     _naive.resize(vcount,0);
     
     // This algorithm uses clockwise as front-facing.  Will reverse later
     if (areVerticesClockwise(_input)) {
-        for (short i = 0; i < vcount; i++) {
+        for (int i = 0; i < vcount; i++) {
             _naive[i] = i;
         }
     } else {
         for (int i = 0, n = vcount - 1; i < vcount; i++) {
-            _naive[i] = (short)(n - i); // Reversed.
+            _naive[i] = n - i; // Reversed.
         }
     }
     
+    _types.clear();
     _types.reserve(vcount);
     for (int ii = 0; ii < vcount; ++ii) {
         _types.push_back(classifyVertex(ii));
     }
     
-    // A polygon with n vertices has a triangulation of n-2 triangles.
-    int size = (vcount-2 > 0 ? vcount-2 : 0)*3;
-    _output.reserve(size);
     computeTriangulation();
-    trimColinear();
     reverseOrientation();
-    _calculated = true;
 }
 
 /**
@@ -147,16 +181,16 @@ bool SimpleTriangulator::areVerticesClockwise (const std::vector<Vec2>& vertices
         return false;
     }
     
-    float area = 0;
+    double area = 0;
     Vec2 p1, p2;
-    for (int i = 0, n = (int)vertices.size() - 3; i < n; i += 2) {
+    for (size_t i = 0, n = vertices.size() - 1; i < n; i++) {
         p1 = vertices[i  ];
         p2 = vertices[i+1];
-        area += p1.x * p2.y - p2.x * p1.y;
+        area += (double)p1.x * p2.y - (double)p2.x * p1.y;
     }
     p1 = vertices[vertices.size()-1];
     p2 = vertices[0];
-    return area + p1.x * p2.y - p2.x * p1.y < 0;
+    return area + (double)p1.x * p2.y - (double)p2.x * p1.y < 0;
 }
 
 /**
@@ -347,6 +381,430 @@ void SimpleTriangulator::reverseOrientation() {
 }
 
 
+#pragma mark -
+#pragma mark Monotone Partition
+/**
+ * Returns true if edge a is to the left of edge b
+ *
+ * Edges are compared at the current sweep line. Ties are broken by index
+ * so that the ordering is strict.
+ *
+ * @param a     The first edge
+ * @param b     The second edge
+ *
+ * @return true if edge a is to the left of edge b
+ */
+bool SimpleTriangulator::EdgeOrder::operator()(Uint32 a, Uint32 b) const {
+    double xa = a == QUERY_EDGE ? owner->_sweepX : owner->sweepIntercept(a);
+    double xb = b == QUERY_EDGE ? owner->_sweepX : owner->sweepIntercept(b);
+    if (xa != xb) {
+        return xa < xb;
+    }
+    // The query compares below any edge through the sweep vertex
+    return a == QUERY_EDGE ? b != QUERY_EDGE : (b != QUERY_EDGE && a < b);
+}
+
+/**
+ * Returns true if the vertex at position a is above the one at b.
+ *
+ * Positions refer to _order. A vertex is above another if it has larger
+ * y-coordinate, or the same y-coordinate and a smaller x-coordinate.
+ *
+ * @param a     The first vertex position
+ * @param b     The second vertex position
+ *
+ * @return true if the vertex at position a is above the one at b.
+ */
+bool SimpleTriangulator::isAbove(Uint32 a, Uint32 b) const {
+    const Vec2& pa = _input[_order[a]];
+    const Vec2& pb = _input[_order[b]];
+    return pa.y > pb.y || (pa.y == pb.y && pa.x < pb.x);
+}
+
+/**
+ * Returns the x-coordinate where the given edge meets the sweep line.
+ *
+ * @param edge  The edge (from position edge to edge+1)
+ *
+ * @return the x-coordinate where the given edge meets the sweep line.
+ */
+double SimpleTriangulator::sweepIntercept(Uint32 edge) const {
+    const Vec2& a = _input[_order[edge]];
+    const Vec2& b = _input[_order[edge+1 == _order.size() ? 0 : edge+1]];
+    if (a.y == b.y) {
+        // A horizontal edge is only active while the sweep is at its left end
+        return std::min(a.x,b.x);
+    }
+    return a.x + (_sweepY-a.y)*((double)b.x-a.x)/((double)b.y-a.y);
+}
+
+/**
+ * Computes a monotone triangulation of the current vertex data.
+ *
+ * This partitions the polygon into y-monotone pieces and triangulates
+ * each one. The triangles are added to the output in counter-clockwise
+ * order. If this method returns false, the input is not a simple polygon
+ * and the output must be discarded.
+ *
+ * @return true if the triangulation succeeded
+ */
+bool SimpleTriangulator::computeMonotone() {
+    // Drop repeated vertices, as they have no well-defined sweep kind
+    _order.clear();
+    double area = 0;
+    for(Uint32 ii = 0; ii < _input.size(); ii++) {
+        if (_order.empty() || _input[ii] != _input[_order.back()]) {
+            _order.push_back(ii);
+        }
+    }
+    while (_order.size() > 1 && _input[_order.back()] == _input[_order[0]]) {
+        _order.pop_back();
+    }
+    Uint32 vcount = (Uint32)_order.size();
+    if (vcount < 3) {
+        return true;
+    }
+    for(Uint32 ii = 0; ii < vcount; ii++) {
+        const Vec2& p1 = _input[_order[ii]];
+        const Vec2& p2 = _input[_order[ii+1 == vcount ? 0 : ii+1]];
+        area += (double)p1.x * p2.y - (double)p2.x * p1.y;
+    }
+    if (area == 0) {
+        return false;
+    } else if (area < 0) {
+        std::reverse(_order.begin(), _order.end());
+    }
+    
+    if (vcount == 3) {
+        _output.insert(_output.end(), _order.begin(), _order.end());
+        return true;
+    }
+    
+    if (!computeDiagonals()) {
+        return false;
+    }
+    
+    // Build the half-edge tables: boundary edges, their twins, and diagonals
+    Uint32 dcount = (Uint32)_diagonals.size();
+    _offsets.assign(vcount+1, 0);
+    for(Uint32 ii = 0; ii < vcount; ii++) {
+        _offsets[ii+1] += 2;
+    }
+    for(Uint32 ii = 0; ii < dcount; ii++) {
+        _offsets[_diagonals[ii]+1]++;
+    }
+    for(Uint32 ii = 0; ii < vcount; ii++) {
+        _offsets[ii+1] += _offsets[ii];
+    }
+    Uint32 hcount = _offsets[vcount];
+    _sources.resize(hcount);
+    _targets.resize(hcount);
+    _angles.resize(hcount);
+    _visited.assign(hcount, false);
+    
+    // Use _helpers as the fill cursor for each vertex
+    _helpers.assign(_offsets.begin(), _offsets.end()-1);
+    auto link = [this](Uint32 src, Uint32 dst, bool exterior) {
+        Uint32 pos = _helpers[src]++;
+        const Vec2& a = _input[_order[src]];
+        const Vec2& b = _input[_order[dst]];
+        _sources[pos] = src;
+        _targets[pos] = dst;
+        _angles[pos]  = std::atan2((double)b.y-a.y, (double)b.x-a.x);
+        _visited[pos] = exterior;
+    };
+    for(Uint32 ii = 0; ii < vcount; ii++) {
+        Uint32 next = ii+1 == vcount ? 0 : ii+1;
+        link(ii, next, false);
+        link(next, ii, true);
+    }
+    for(Uint32 ii = 0; ii < dcount; ii += 2) {
+        link(_diagonals[ii  ], _diagonals[ii+1], false);
+        link(_diagonals[ii+1], _diagonals[ii  ], false);
+    }
+    
+    // Sort the half-edges about each vertex counter-clockwise
+    for(Uint32 ii = 0; ii < vcount; ii++) {
+        Uint32 beg = _offsets[ii];
+        Uint32 end = _offsets[ii+1];
+        for(Uint32 jj = beg+1; jj < end; jj++) {
+            for(Uint32 kk = jj; kk > beg && _angles[kk-1] > _angles[kk]; kk--) {
+                std::swap(_angles[kk-1],_angles[kk]);
+                std::swap(_targets[kk-1],_targets[kk]);
+                bool temp = _visited[kk-1];
+                _visited[kk-1] = _visited[kk];
+                _visited[kk] = temp;
+            }
+        }
+    }
+    
+    // Walk each face, keeping the interior on the left
+    for(Uint32 start = 0; start < hcount; start++) {
+        if (_visited[start]) {
+            continue;
+        }
+        _face.clear();
+        Uint32 curr = start;
+        do {
+            if (_visited[curr] || _face.size() > vcount) {
+                return false;
+            }
+            _visited[curr] = true;
+            _face.push_back(_sources[curr]);
+            
+            // The next edge is the first one clockwise from the twin
+            Uint32 vert = _targets[curr];
+            Uint32 beg = _offsets[vert];
+            Uint32 end = _offsets[vert+1];
+            Uint32 twin = beg;
+            while (twin < end && _targets[twin] != _sources[curr]) {
+                twin++;
+            }
+            if (twin == end) {
+                return false;
+            }
+            curr = (twin == beg ? end : twin)-1;
+        } while (curr != start);
+        
+        if (!triangulateMonotone()) {
+            return false;
+        }
+    }
+    return _output.size() == 3*(vcount-2);
+}
+
+/**
+ * Computes the diagonals partitioning the polygon into monotone pieces.
+ *
+ * This is the sweep line portion of the algorithm. It returns false if
+ * the sweep status becomes inconsistent (e.g. a self-intersection).
+ *
+ * @return true if the partition succeeded
+ */
+bool SimpleTriangulator::computeDiagonals() {
+    Uint32 vcount = (Uint32)_order.size();
+    _kinds.resize(vcount);
+    _events.resize(vcount);
+    for(Uint32 ii = 0; ii < vcount; ii++) {
+        Uint32 prev = ii == 0 ? vcount-1 : ii-1;
+        Uint32 next = ii+1 == vcount ? 0 : ii+1;
+        const Vec2& p1 = _input[_order[prev]];
+        const Vec2& p2 = _input[_order[ii]];
+        const Vec2& p3 = _input[_order[next]];
+        double cross = ((double)p2.x-p1.x)*((double)p3.y-p2.y)-((double)p2.y-p1.y)*((double)p3.x-p2.x);
+        bool above1 = isAbove(prev,ii);
+        bool above3 = isAbove(next,ii);
+        if (!above1 && !above3) {
+            _kinds[ii] = cross >= 0 ? SweepKind::START : SweepKind::SPLIT;
+        } else if (above1 && above3) {
+            _kinds[ii] = cross >= 0 ? SweepKind::END : SweepKind::MERGE;
+        } else {
+            _kinds[ii] = SweepKind::REGULAR;
+        }
+        _events[ii] = ii;
+    }
+    std::sort(_events.begin(), _events.end(), [this](Uint32 a, Uint32 b) {
+        return isAbove(a,b);
+    });
+    
+    _status = std::set<Uint32,EdgeOrder>(EdgeOrder(this));
+    _handles.resize(vcount);
+    _active.assign(vcount, false);
+    _helpers.assign(vcount, 0);
+    _diagonals.clear();
+    
+    auto insert = [this](Uint32 edge) {
+        auto result = _status.insert(edge);
+        _handles[edge] = result.first;
+        _active[edge] = true;
+        _helpers[edge] = edge;
+        return result.second;
+    };
+    auto remove = [this](Uint32 edge, Uint32 vert) {
+        if (!_active[edge]) {
+            return false;
+        }
+        if (_kinds[_helpers[edge]] == SweepKind::MERGE) {
+            _diagonals.push_back(vert);
+            _diagonals.push_back(_helpers[edge]);
+        }
+        _status.erase(_handles[edge]);
+        _active[edge] = false;
+        return true;
+    };
+    auto left = [this](Uint32 vert) {
+        auto it = _status.upper_bound(QUERY_EDGE);
+        if (it == _status.begin()) {
+            return false;
+        }
+        Uint32 edge = *(--it);
+        if (_kinds[_helpers[edge]] == SweepKind::MERGE) {
+            _diagonals.push_back(vert);
+            _diagonals.push_back(_helpers[edge]);
+        }
+        _helpers[edge] = vert;
+        return true;
+    };
+    
+    bool success = true;
+    for(auto it = _events.begin(); success && it != _events.end(); ++it) {
+        Uint32 vert = *it;
+        Uint32 prev = vert == 0 ? vcount-1 : vert-1;
+        _sweepX = _input[_order[vert]].x;
+        _sweepY = _input[_order[vert]].y;
+        switch (_kinds[vert]) {
+            case SweepKind::START:
+                success = insert(vert);
+                break;
+            case SweepKind::END:
+                success = remove(prev,vert);
+                break;
+            case SweepKind::SPLIT:
+            {
+                auto pos = _status.upper_bound(QUERY_EDGE);
+                if (pos == _status.begin()) {
+                    success = false;
+                } else {
+                    Uint32 edge = *(--pos);
+                    _diagonals.push_back(vert);
+                    _diagonals.push_back(_helpers[edge]);
+                    _helpers[edge] = vert;
+                    success = insert(vert);
+                }
+            }
+                break;
+            case SweepKind::MERGE:
+                success = remove(prev,vert) && left(vert);
+                break;
+            case SweepKind::REGULAR:
+                if (isAbove(prev,vert)) {
+                    // The interior lies to the right of this vertex
+                    success = remove(prev,vert) && insert(vert);
+                } else {
+                    success = left(vert);
+                }
+                break;
+        }
+    }
+    _status.clear();
+    return success;
+}
+
+/**
+ * Triangulates the monotone polygon stored in _face.
+ *
+ * The face is a list of vertex positions in counter-clockwise order.
+ * This method runs in linear time, and returns false if the face is
+ * degenerate.
+ *
+ * @return true if the face was triangulated
+ */
+bool SimpleTriangulator::triangulateMonotone() {
+    Uint32 vcount = (Uint32)_face.size();
+    if (vcount < 3) {
+        return false;
+    } else if (vcount == 3) {
+        for(auto it = _face.begin(); it != _face.end(); ++it) {
+            _output.push_back(_order[*it]);
+        }
+        return true;
+    }
+    
+    Uint32 top = 0;
+    Uint32 bot = 0;
+    for(Uint32 ii = 1; ii < vcount; ii++) {
+        if (isAbove(_face[ii],_face[top])) {
+            top = ii;
+        }
+        if (isAbove(_face[bot],_face[ii])) {
+            bot = ii;
+        }
+    }
+    
+    // Merge the two chains from top to bottom. Counter-clockwise from the top is the left chain.
+    _sorted.clear();
+    _chains.clear();
+    _sorted.push_back(_face[top]);
+    _chains.push_back(BOTH_CHAINS);
+    Uint32 lpos = top+1 == vcount ? 0 : top+1;
+    Uint32 rpos = top == 0 ? vcount-1 : top-1;
+    while (lpos != bot || rpos != bot) {
+        if (lpos != bot && (rpos == bot || isAbove(_face[lpos],_face[rpos]))) {
+            _sorted.push_back(_face[lpos]);
+            _chains.push_back(LEFT_CHAIN);
+            lpos = lpos+1 == vcount ? 0 : lpos+1;
+        } else {
+            _sorted.push_back(_face[rpos]);
+            _chains.push_back(RIGHT_CHAIN);
+            rpos = rpos == 0 ? vcount-1 : rpos-1;
+        }
+        if (_sorted.size() > vcount) {
+            return false;
+        }
+    }
+    _sorted.push_back(_face[bot]);
+    _chains.push_back(BOTH_CHAINS);
+    
+    auto orient = [this](Uint32 a, Uint32 b, Uint32 c) {
+        const Vec2& pa = _input[_order[_sorted[a]]];
+        const Vec2& pb = _input[_order[_sorted[b]]];
+        const Vec2& pc = _input[_order[_sorted[c]]];
+        return ((double)pb.x-pa.x)*((double)pc.y-pa.y)-((double)pb.y-pa.y)*((double)pc.x-pa.x);
+    };
+    auto emit = [this](Uint32 a, Uint32 b, Uint32 c) {
+        _output.push_back(_order[_sorted[a]]);
+        _output.push_back(_order[_sorted[b]]);
+        _output.push_back(_order[_sorted[c]]);
+    };
+    // Fans the current vertex across the stack (which is on the opposite chain)
+    auto fan = [&](Uint32 curr) {
+        while (_stack.size() > 1) {
+            Uint32 a = _stack.back();
+            _stack.pop_back();
+            Uint32 b = _stack.back();
+            if (_chains[a] == RIGHT_CHAIN) {
+                emit(curr,a,b);
+            } else {
+                emit(curr,b,a);
+            }
+        }
+        _stack.clear();
+    };
+    
+    _stack.clear();
+    _stack.push_back(0);
+    _stack.push_back(1);
+    for(Uint32 ii = 2; ii < vcount-1; ii++) {
+        if (_chains[ii] != _chains[_stack.back()]) {
+            fan(ii);
+            _stack.push_back(ii-1);
+            _stack.push_back(ii);
+        } else {
+            Uint32 last = _stack.back();
+            _stack.pop_back();
+            while (!_stack.empty()) {
+                Uint32 next = _stack.back();
+                double area = orient(ii,last,next);
+                if (_chains[ii] == LEFT_CHAIN ? area >= 0 : area <= 0) {
+                    break;
+                }
+                if (_chains[ii] == LEFT_CHAIN) {
+                    emit(ii,next,last);
+                } else {
+                    emit(ii,last,next);
+                }
+                last = next;
+                _stack.pop_back();
+            }
+            _stack.push_back(last);
+            _stack.push_back(ii);
+        }
+    }
+    fan(vcount-1);
+    return true;
+}
+
+
 #pragma mark -
 #pragma mark Materialization
 /**
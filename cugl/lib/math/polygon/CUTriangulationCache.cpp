@@ -0,0 +1,356 @@
+//
+//  CUTriangulationCache.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module is a cache of polygon triangulations, keyed on the vertices.
+//  Scene graphs tend to build the same shapes over and over again, whether
+//  because a scene file uses the same widget many times, or because the game
+//  recreates nodes every time the player enters a room. With this cache, a
+//  repeated shape costs a hash lookup instead of a triangulation.
+//
+//  Unlike the other classes in this package, this class is not a factory.
+//  You may create a private cache on the stack, but most code should use
+//  the shared cache, which is the one used by the scene graph nodes.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: agent
+//  Version: 10/19/26
+//
+#include <cugl/math/polygon/CUTriangulationCache.h>
+#include <cugl/math/polygon/CUSimpleTriangulator.h>
+#include <cugl/math/polygon/CUComplexTriangulator.h>
+#include <cugl/util/CUDebug.h>
+#include <algorithm>
+#include <cstring>
+
+using namespace cugl;
+
+/** The multiplier for the vertex hash (the 64-bit golden ratio) */
+#define HASH_MULTIPLIER 0x9E3779B97F4A7C15ULL
+
+/**
+ * The factories used to triangulate a cache miss.
+ *
+ * Misses are triangulated outside of the cache lock, so each thread has its
+ * own factories. They are retained between misses to avoid allocations.
+ */
+struct MissTriangulators {
+    /** The triangulator for the MONOTONE and EARCLIP algorithms */
+    SimpleTriangulator simple;
+    /** The triangulator for the DELAUNAY algorithm */
+    ComplexTriangulator complex;
+    /** The scratch buffer for a new triangulation */
+    std::vector<Uint32> scratch;
+};
+
+/**
+ * Returns the miss triangulators for the current thread.
+ *
+ * @return the miss triangulators for the current thread.
+ */
+static MissTriangulators& local_triangulators() {
+    static thread_local MissTriangulators triangulators;
+    return triangulators;
+}
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates an empty cache with the given capacity.
+ *
+ * @param capacity  The maximum number of cached triangulations
+ */
+TriangulationCache::TriangulationCache(size_t capacity) :
+_capacity(capacity),
+_hits(0),
+_misses(0) {
+}
+
+/**
+ * Returns the cache shared by the scene graph nodes.
+ *
+ * This cache is created on first use and lives until the program exits.
+ *
+ * @return the cache shared by the scene graph nodes.
+ */
+TriangulationCache* TriangulationCache::get() {
+    static TriangulationCache shared;
+    return &shared;
+}
+
+#pragma mark -
+#pragma mark Attributes
+/**
+ * Returns the maximum number of cached triangulations.
+ *
+ * @return the maximum number of cached triangulations.
+ */
+size_t TriangulationCache::getCapacity() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _capacity;
+}
+
+/**
+ * Sets the maximum number of cached triangulations.
+ *
+ * If the cache has more entries than the new capacity, the least
+ * recently used entries are discarded.
+ *
+ * @param capacity  The maximum number of cached triangulations
+ */
+void TriangulationCache::setCapacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _capacity = capacity;
+    trim(_capacity);
+}
+
+/**
+ * Returns the number of cached triangulations.
+ *
+ * @return the number of cached triangulations.
+ */
+size_t TriangulationCache::size() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _entries.size();
+}
+
+/**
+ * Discards all cached triangulations.
+ *
+ * This method does not reset the statistics. Index buffers acquired from
+ * this cache remain valid.
+ */
+void TriangulationCache::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _lookup.clear();
+    _entries.clear();
+}
+
+#pragma mark -
+#pragma mark Statistics
+/**
+ * Returns the number of requests answered from the cache.
+ *
+ * @return the number of requests answered from the cache.
+ */
+Uint64 TriangulationCache::getHits() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _hits;
+}
+
+/**
+ * Returns the number of requests that required a triangulation.
+ *
+ * @return the number of requests that required a triangulation.
+ */
+Uint64 TriangulationCache::getMisses() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _misses;
+}
+
+/**
+ * Returns the fraction of requests answered from the cache.
+ *
+ * If there have been no requests, this method returns 0.
+ *
+ * @return the fraction of requests answered from the cache.
+ */
+float TriangulationCache::getHitRate() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Uint64 total = _hits+_misses;
+    return total == 0 ? 0.0f : (float)((double)_hits/total);
+}
+
+/**
+ * Resets the number of hits and misses to 0.
+ */
+void TriangulationCache::resetStatistics() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _hits = 0;
+    _misses = 0;
+}
+
+#pragma mark -
+#pragma mark Triangulation
+/**
+ * Returns the triangulation of the given vertices.
+ *
+ * The vertices must define a simple polygon, with no holes. The result is
+ * the same as the triangulation produced by the factory for the given
+ * algorithm. It is shared with every other polygon with the same vertices,
+ * and so it may not be modified.
+ *
+ * @param vertices  The polygon vertices
+ * @param size      The number of vertices
+ * @param type      The triangulation algorithm
+ *
+ * @return the triangulation of the given vertices.
+ */
+std::shared_ptr<const std::vector<Uint32>> TriangulationCache::triangulate(const Vec2* vertices, size_t size,
+                                                                           poly2::Triangulation type) {
+    Uint64 key = hash(vertices,size,type);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto indices = find(key,vertices,size,type);
+        if (indices != nullptr) {
+            _hits++;
+            return indices;
+        }
+        _misses++;
+    }
+
+    // Triangulate without the lock so other threads are not blocked
+    MissTriangulators& local = local_triangulators();
+    local.scratch.clear();
+    std::vector<Vec2> copy(vertices, vertices+size);
+    if (size >= 3) {
+        switch (type) {
+            case poly2::Triangulation::MONOTONE:
+            case poly2::Triangulation::EARCLIP:
+                local.simple.setEarClipping(type == poly2::Triangulation::EARCLIP);
+                local.simple.set(copy);
+                local.simple.calculate();
+                local.simple.getTriangulation(local.scratch);
+                break;
+            case poly2::Triangulation::DELAUNAY:
+                local.complex.set(copy);
+                local.complex.calculate();
+                local.complex.getTriangulation(local.scratch);
+                local.complex.clear();
+                break;
+        }
+    }
+    auto indices = std::make_shared<const std::vector<Uint32>>(local.scratch.begin(), local.scratch.end());
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    // Another thread may have cached the same polygon in the meantime
+    auto existing = find(key,vertices,size,type);
+    if (existing != nullptr) {
+        return existing;
+    }
+    if (_capacity > 0) {
+        trim(_capacity-1);
+        _entries.push_front({key, type, std::move(copy), indices});
+        _lookup.emplace(key, _entries.begin());
+    }
+    return indices;
+}
+
+/**
+ * Stores the triangulation of the given vertices in the buffer.
+ *
+ * The buffer is reset to a `SOLID` polygon with the given vertices and
+ * their triangulation. The geometry is assigned directly, without the
+ * scan of {@link Geometry#categorize}.
+ *
+ * @param vertices  The polygon vertices
+ * @param buffer    The buffer to store the polygon
+ * @param type      The triangulation algorithm
+ *
+ * @return a reference to the buffer for chaining.
+ */
+Poly2* TriangulationCache::triangulate(const std::vector<Vec2>& vertices, Poly2* buffer,
+                                       poly2::Triangulation type) {
+    CUAssertLog(buffer, "Destination buffer is null");
+    auto indices = triangulate(vertices.data(), vertices.size(), type);
+    buffer->set(vertices);
+    buffer->indices().assign(indices->begin(), indices->end());
+    buffer->setGeometry(Geometry::SOLID);
+    return buffer;
+}
+
+/**
+ * Returns the hash for the given vertices and triangulation algorithm.
+ *
+ * The hash only depends on the values of the vertices (so 0 and -0 are
+ * the same), and it does not allocate memory.
+ *
+ * @param vertices  The polygon vertices
+ * @param size      The number of vertices
+ * @param type      The triangulation algorithm
+ *
+ * @return the hash for the given vertices and triangulation algorithm.
+ */
+Uint64 TriangulationCache::hash(const Vec2* vertices, size_t size, poly2::Triangulation type) {
+    Uint64 result = (size+1)*HASH_MULTIPLIER ^ (Uint64)type;
+    for(size_t ii = 0; ii < size; ii++) {
+        // Adding 0 turns -0 into 0
+        float x = vertices[ii].x+0.0f;
+        float y = vertices[ii].y+0.0f;
+        Uint32 bx, by;
+        std::memcpy(&bx, &x, sizeof(Uint32));
+        std::memcpy(&by, &y, sizeof(Uint32));
+        Uint64 word = ((Uint64)bx << 32 | by)*HASH_MULTIPLIER;
+        result = (result ^ (word ^ (word >> 29)))*HASH_MULTIPLIER;
+    }
+    return result ^ (result >> 32);
+}
+
+#pragma mark -
+#pragma mark Internal Helpers
+/**
+ * Returns the cached triangulation of the given vertices.
+ *
+ * If the triangulation is found, its entry becomes the most recently used
+ * one. Otherwise, this method returns nullptr. The statistics are not
+ * changed. This method assumes the lock is held.
+ *
+ * @param key       The hash of the vertices and algorithm
+ * @param vertices  The polygon vertices
+ * @param size      The number of vertices
+ * @param type      The triangulation algorithm
+ *
+ * @return the cached triangulation of the given vertices.
+ */
+std::shared_ptr<const std::vector<Uint32>> TriangulationCache::find(Uint64 key, const Vec2* vertices, size_t size,
+                                                                    poly2::Triangulation type) {
+    auto range = _lookup.equal_range(key);
+    for(auto it = range.first; it != range.second; ++it) {
+        const Entry& entry = *(it->second);
+        if (entry.type == type && entry.vertices.size() == size &&
+            std::equal(vertices, vertices+size, entry.vertices.begin())) {
+            _entries.splice(_entries.begin(), _entries, it->second);
+            return entry.indices;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Discards the least recently used entries until the cache fits.
+ *
+ * This method assumes the lock is held.
+ *
+ * @param capacity  The number of entries to keep
+ */
+void TriangulationCache::trim(size_t capacity) {
+    while (_entries.size() > capacity) {
+        auto last = std::prev(_entries.end());
+        auto range = _lookup.equal_range(last->hash);
+        for(auto it = range.first; it != range.second; ++it) {
+            if (it->second == last) {
+                _lookup.erase(it);
+                break;
+            }
+        }
+        _entries.pop_back();
+    }
+}
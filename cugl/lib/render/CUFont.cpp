@@ -45,16 +45,95 @@
 
 #include <deque>
 #include <algorithm>
+#include <cmath>
 #include <utf8/utf8.h>
 #include <cugl/util/CUDebug.h>
 #include <cugl/util/CUFiletools.h>
+#include <cugl/util/CUThreadPool.h>
 #include <cugl/render/CUTexture.h>
 #include <cugl/render/CUFont.h>
+#include <cugl/render/CUGlyphCache.h>
 
 using namespace cugl;
 
 /** The amount of border to put around a glyph to prevent bleeding. */
 #define GLYPH_BORDER    2
+/** The squared distance standing in for infinity in the distance transform */
+#define DISTANCE_FAR    1e20f
+
+/**
+ * Computes the squared Euclidean distance transform of a row in place.
+ *
+ * This is the one dimensional pass of the algorithm by Felzenszwalb and
+ * Huttenlocher. The input is a sampled function, with 0 at the feature
+ * texels and {@link DISTANCE_FAR} elsewhere. The output is the lower
+ * envelope of the parabolas rooted at each sample, which is the squared
+ * distance to the nearest feature. Applying this to the rows and then the
+ * columns gives the exact two dimensional transform in linear time.
+ *
+ * The scratch buffers must have room for n elements (n+1 for zs).
+ *
+ * @param data      The sampled function (stored with the given stride)
+ * @param n         The number of samples
+ * @param stride    The distance between consecutive samples
+ * @param fs        A scratch buffer for the function values
+ * @param vs        A scratch buffer for the parabola locations
+ * @param zs        A scratch buffer for the parabola boundaries
+ */
+static void distance_transform(float* data, int n, int stride, float* fs, int* vs, float* zs) {
+    for(int ii = 0; ii < n; ii++) {
+        fs[ii] = data[ii*stride];
+    }
+    
+    int k = 0;
+    vs[0] = 0;
+    zs[0] = -DISTANCE_FAR;
+    zs[1] =  DISTANCE_FAR;
+    for(int q = 1; q < n; q++) {
+        float s = ((fs[q]+q*q)-(fs[vs[k]]+vs[k]*vs[k]))/(2*q-2*vs[k]);
+        while (s <= zs[k]) {
+            k--;
+            s = ((fs[q]+q*q)-(fs[vs[k]]+vs[k]*vs[k]))/(2*q-2*vs[k]);
+        }
+        k++;
+        vs[k] = q;
+        zs[k] = s;
+        zs[k+1] = DISTANCE_FAR;
+    }
+    
+    k = 0;
+    for(int q = 0; q < n; q++) {
+        while (zs[k+1] < q) {
+            k++;
+        }
+        float dq = (float)(q-vs[k]);
+        data[q*stride] = dq*dq+fs[vs[k]];
+    }
+}
+
+/**
+ * Computes the squared Euclidean distance transform of an image in place.
+ *
+ * The image must have 0 at the feature texels and {@link DISTANCE_FAR}
+ * elsewhere. Afterwards, each texel is the squared distance to the nearest
+ * feature texel.
+ *
+ * @param image     The image to transform
+ * @param width     The image width
+ * @param height    The image height
+ */
+static void distance_transform(std::vector<float>& image, int width, int height) {
+    int n = std::max(width,height);
+    std::vector<float> fs(n);
+    std::vector<int>   vs(n);
+    std::vector<float> zs(n+1);
+    for(int x = 0; x < width; x++) {
+        distance_transform(image.data()+x, height, width, fs.data(), vs.data(), zs.data());
+    }
+    for(int y = 0; y < height; y++) {
+        distance_transform(image.data()+y*width, width, 1, fs.data(), vs.data(), zs.data());
+    }
+}
 
 #pragma mark -
 #pragma mark Constructors
@@ -79,7 +158,10 @@ _style(Style::NORMAL),
 _hints(Hinting::NORMAL),
 _render(Resolution::BLENDED),
 _hasAtlas(false),
-_surface(nullptr) { }
+_spread(0),
+_surface(nullptr),
+_generation(0),
+_evictions(0) { }
 
 /**
  * Deletes the font resources and resets all attributes.
@@ -104,11 +186,17 @@ void Font::dispose() {
     _hints  = Hinting::NORMAL;
     _render = Resolution::BLENDED;
     _hasAtlas = false;
+    _spread = 0;
     _texture = nullptr;
     _glyphset.clear();
     _glyphsize.clear();
     _glyphmap.clear();
     _kernmap.clear();
+    _source = "";
+    _cache = nullptr;
+    _threads = nullptr;
+    _evictions = 0;
+    _generation++;
 }
 
 /**
@@ -135,6 +223,7 @@ bool Font::init(const std::string file, int size) {
         return false;
     }
     _size = size;
+    _source = fullpath;
     char* strng = TTF_FontFaceFamilyName(_data);
     _name = std::string(strng);
 
@@ -150,6 +239,66 @@ bool Font::init(const std::string file, int size) {
     return true;
 }
 
+/**
+ * Replaces the contents of this font with those of the given font.
+ *
+ * This method is used to hot reload fonts. Every object holding this font
+ * sees the new glyphs. If this font has an atlas texture, that texture
+ * object is refilled rather than replaced. Text that has already been
+ * converted to a mesh keeps its old layout until it is regenerated.
+ *
+ * The given font is disposed by this method. This method must be called
+ * on the main thread, as it may touch OpenGL.
+ *
+ * @param font  The font to take the contents from
+ */
+void Font::reload(Font& font) {
+    std::swap(_name,font._name);
+    std::swap(_stylename,font._stylename);
+    std::swap(_size,font._size);
+    std::swap(_data,font._data);
+    std::swap(_fontHeight,font._fontHeight);
+    std::swap(_fontDescent,font._fontDescent);
+    std::swap(_fontAscent,font._fontAscent);
+    std::swap(_fontLineSkip,font._fontLineSkip);
+    std::swap(_fixedWidth,font._fixedWidth);
+    std::swap(_useKerning,font._useKerning);
+    std::swap(_style,font._style);
+    std::swap(_hints,font._hints);
+    std::swap(_render,font._render);
+    std::swap(_hasAtlas,font._hasAtlas);
+    std::swap(_spread,font._spread);
+    std::swap(_glyphset,font._glyphset);
+    std::swap(_glyphmap,font._glyphmap);
+    std::swap(_glyphsize,font._glyphsize);
+    std::swap(_kernmap,font._kernmap);
+    std::swap(_source,font._source);
+    
+    // The glyph cache is rebuilt on demand
+    _cache = nullptr;
+    _evictions = 0;
+    _generation++;
+    
+    if (_surface != nullptr) {
+        SDL_FreeSurface(_surface);
+        _surface = nullptr;
+    }
+    
+    // Keep the atlas texture object so that existing references stay valid
+    if (font._surface != nullptr) {
+        if (_texture != nullptr && _texture->reload(font._surface->pixels, font._surface->w, font._surface->h)) {
+            SDL_FreeSurface(font._surface);
+        } else {
+            _texture = nullptr;
+            _surface = font._surface;
+        }
+        font._surface = nullptr;
+    } else if (font._texture != nullptr || !_hasAtlas) {
+        _texture = font._texture;
+    }
+    font.dispose();
+}
+
 
 
 #pragma mark -
@@ -259,6 +408,29 @@ void Font::setHinting(Hinting hinting) {
     TTF_SetFontHinting(_data, (int)hinting);
 }
 
+/**
+ * Sets the distance field spread in pixels (0 if there is none).
+ *
+ * Changing this value will delete any atlas that is present.  The atlas
+ * must be regenerated.
+ *
+ * If this value is positive, the atlas stores a signed distance field
+ * instead of glyph coverage. Each texel records the distance to the
+ * nearest glyph edge, clamped to the spread. A distance field atlas
+ * should be drawn with {@link SpriteBatch#setDistanceField}, as it
+ * may then be scaled without blurring, and support outlines and shadows
+ * up to the spread in width.
+ *
+ * The glyph cache does not support distance fields, so this setting
+ * only has an effect when the font has an atlas.
+ *
+ * @param spread    The distance field spread in pixels
+ */
+void Font::setDistanceSpread(int spread) {
+    CUAssertLog(spread >= 0, "The spread %d is negative", spread);
+    clearAtlas(); _spread = spread;
+}
+
 #pragma mark -
 #pragma mark Measurements
 /**
@@ -383,7 +555,9 @@ Rect Font::getInternalBounds(const std::string text, bool utf8) const {
 /**
  * Deletes the current atlas
  *
- * The font will use direct rendering until a new atlas is created.
+ * The font will use the glyph cache until a new atlas is created. As this
+ * method is called whenever the font settings change, it also deletes the
+ * glyph cache, so that glyphs are rasterized with the new settings.
  */
 void Font::clearAtlas() {
     if (_surface != nullptr) { SDL_FreeSurface(_surface); _surface = nullptr;   }
@@ -393,6 +567,9 @@ void Font::clearAtlas() {
     _glyphsize.clear();
     _kernmap.clear();
     _hasAtlas = false;
+    _cache = nullptr;
+    _evictions = 0;
+    _generation++;
 }
 
 /**
@@ -468,6 +645,97 @@ const std::shared_ptr<Texture>& Font::getAtlas() {
 
 }
 
+#pragma mark -
+#pragma mark Glyph Cache
+/**
+ * Returns the dynamic glyph cache for this font.
+ *
+ * The glyph cache is used to render text when this font does not have an
+ * atlas. Glyphs are rasterized the first time they are used and packed
+ * into texture pages. The cache is created on first use, and is deleted
+ * whenever the font settings change.
+ *
+ * This method returns nullptr if the cache could not be created.
+ *
+ * @return the dynamic glyph cache for this font.
+ */
+const std::shared_ptr<GlyphCache>& Font::getGlyphCache() {
+    if (_cache == nullptr && _data != nullptr) {
+        _cache = GlyphCache::alloc(_source, _size, _style, _hints, _render);
+        if (_cache != nullptr) {
+            _cache->setThreadPool(_threads);
+        }
+        _evictions = 0;
+    }
+    return _cache;
+}
+
+/**
+ * Sets the thread pool for glyph rasterization.
+ *
+ * If this value is not nullptr, the glyphs requested by {@link #prefetch}
+ * are rasterized on a worker thread. Otherwise, they are rasterized
+ * immediately. This value has no effect if this font has an atlas.
+ *
+ * @param threads   The thread pool for glyph rasterization.
+ */
+void Font::setThreadPool(const std::shared_ptr<ThreadPool>& threads) {
+    _threads = threads;
+    if (_cache != nullptr) {
+        _cache->setThreadPool(threads);
+    }
+}
+
+/**
+ * Rasterizes the glyphs for this string in advance.
+ *
+ * If this font does not have an atlas, the glyphs missing from the glyph
+ * cache are rasterized so that they are ready when the string is rendered.
+ * If this font has a thread pool, this rasterization takes place on a
+ * worker thread.
+ *
+ * This method does nothing if this font has an atlas, or if the glyph
+ * cache has not been created yet. The cache is created the first time
+ * that text is rendered without an atlas.
+ *
+ * The string may either be in UTF8 or ASCII; the method will handle
+ * conversion automatically.
+ *
+ * @param text  The string to rasterize
+ * @param utf8  Whether the string is a UTF8 that must be decoded.
+ */
+void Font::prefetch(const std::string text, bool utf8) {
+    if (_hasAtlas || _cache == nullptr) {
+        return;
+    }
+    
+    std::vector<Uint32> glyphs;
+    if (utf8) {
+        std::string line = text;
+        std::string::iterator end_it = utf8::find_invalid(line.begin(), line.end());
+        CUAssertLog(end_it == line.end(), "String '%s' has an invalid UTF-8 encoding",text.c_str());
+        utf8::utf8to32(line.begin(), line.end(), back_inserter(glyphs));
+    } else {
+        for(auto it = text.begin(); it != text.end(); ++it) {
+            glyphs.push_back((Uint8)*it);
+        }
+    }
+    _cache->prefetch(glyphs.data(), glyphs.size());
+}
+
+/**
+ * Updates the generation if the glyph cache has evicted any glyphs.
+ *
+ * Any mesh built before an eviction may refer to a glyph that is no
+ * longer in the cache.
+ */
+void Font::syncGeneration() {
+    if (_cache != nullptr && _cache->getEvictions() != _evictions) {
+        _evictions = _cache->getEvictions();
+        _generation++;
+    }
+}
+
 #pragma mark -
 #pragma mark Rendering
 /**
@@ -487,7 +755,7 @@ const std::shared_ptr<Texture>& Font::getAtlas() {
  * including the descent.  It is not the position of the baseline.
  *
  * If this font has an atlas, it will return the atlas texture.  Otherwise,
- * it is returning a unique texture specifically generated for this string.
+ * it returns the page of the glyph cache containing the glyphs.
  *
  * This method will fail if the string is not supported by this font.
  *
@@ -506,7 +774,7 @@ std::shared_ptr<Texture> Font::getMesh(const std::string text, const Vec2 origin
         return _texture;
     }
     
-    return getRenderedMesh(text,origin,bounds,mesh,utf8);
+    return getCachedMesh(text,origin,bounds,mesh,utf8);
 }
 
 /**
@@ -530,7 +798,7 @@ std::shared_ptr<Texture> Font::getMesh(const std::string text, const Vec2 origin
  * including the descent.  It is not the position of the baseline.
  *
  * If this font has an atlas, it will return the atlas texture.  Otherwise,
- * it is returning a unique texture specifically generated for this string.
+ * it returns the page of the glyph cache containing the glyphs.
  *
  * @param text      The string to convert to render data.
  * @param origin    The position of the first character
@@ -547,7 +815,7 @@ std::shared_ptr<Texture> Font::getMesh(const std::string text, const Vec2 origin
         return _texture;
     }
     
-    return getRenderedMesh(text,origin,rect,mesh,utf8);
+    return getCachedMesh(text,origin,rect,mesh,utf8);
 }
 
 /**
@@ -567,7 +835,7 @@ std::shared_ptr<Texture> Font::getMesh(const std::string text, const Vec2 origin
  * @param mesh      The mesh to store the vertices
  *
  * If this font has an atlas, it will return the atlas texture.  Otherwise,
- * it is returning a unique texture specifically generated for this string.
+ * it returns the page of the glyph cache containing the glyphs.
  *
  * @return the texture associated with the mesh
  */
@@ -578,7 +846,7 @@ std::shared_ptr<Texture> Font::getQuad(Uint32 thechar, Vec2& offset, Mesh<Sprite
         return _texture;
     }
     
-    return getRenderedQuad(thechar,offset,bounds,mesh);
+    return getCachedQuad(thechar,offset,bounds,mesh);
 }
 
 /**
@@ -597,7 +865,7 @@ std::shared_ptr<Texture> Font::getQuad(Uint32 thechar, Vec2& offset, Mesh<Sprite
  * the character is not supported by this font.
  *
  * If this font has an atlas, it will return the atlas texture.  Otherwise,
- * it is returning a unique texture specifically generated for this string.
+ * it returns the page of the glyph cache containing the glyphs.
  *
  * @param thechar   The character to convert to render data
  * @param offset    The (unkerned) starting position of the quad
@@ -613,7 +881,7 @@ std::shared_ptr<Texture> Font::getQuad(Uint32 thechar, Vec2& offset, const Rect
         return _texture;
     }
     
-    return getRenderedQuad(thechar,offset,rect,mesh);
+    return getCachedQuad(thechar,offset,rect,mesh);
 
 }
 
@@ -634,7 +902,7 @@ std::shared_ptr<Texture> Font::getQuad(Uint32 thechar, Vec2& offset, const Rect
  * including the descent.  It is not the position of the baseline.
  *
  * If this font has an atlas, it will return the atlas texture.  Otherwise,
- * it is returning a unique texture specifically generated for this string.
+ * it returns the page of the glyph cache containing the glyphs.
  *
  * This method will fail if the string is not supported by this font.
  *
@@ -654,7 +922,7 @@ std::shared_ptr<Texture> Font::getMesh(const std::string text, const Vec2 origin
         return _texture;
     }
     
-    return getRenderedMesh(text,origin,bounds,mesh,z,utf8);
+    return getCachedMesh(text,origin,bounds,mesh,z,utf8);
 }
 
 /**
@@ -678,7 +946,7 @@ std::shared_ptr<Texture> Font::getMesh(const std::string text, const Vec2 origin
  * including the descent.  It is not the position of the baseline.
  *
  * If this font has an atlas, it will return the atlas texture.  Otherwise,
- * it is returning a unique texture specifically generated for this string.
+ * it returns the page of the glyph cache containing the glyphs.
  *
  * @param text      The string to convert to render data.
  * @param origin    The position of the first character
@@ -696,7 +964,7 @@ std::shared_ptr<Texture> Font::getMesh(const std::string text, const Vec2 origin
         return _texture;
     }
     
-    return getRenderedMesh(text,origin,rect,mesh,z,utf8);
+    return getCachedMesh(text,origin,rect,mesh,z,utf8);
 }
 
 /**
@@ -717,7 +985,7 @@ std::shared_ptr<Texture> Font::getMesh(const std::string text, const Vec2 origin
  * @param z         The uniform z-offset in 3-d space
  *
  * If this font has an atlas, it will return the atlas texture.  Otherwise,
- * it is returning a unique texture specifically generated for this string.
+ * it returns the page of the glyph cache containing the glyphs.
  *
  * @return the texture associated with the mesh
  */
@@ -728,7 +996,7 @@ std::shared_ptr<Texture> Font::getQuad(Uint32 thechar, Vec2& offset, Mesh<Sprite
         return _texture;
     }
     
-    return getRenderedQuad(thechar,offset,bounds,mesh,z);
+    return getCachedQuad(thechar,offset,bounds,mesh,z);
 }
 
 /**
@@ -747,7 +1015,7 @@ std::shared_ptr<Texture> Font::getQuad(Uint32 thechar, Vec2& offset, Mesh<Sprite
  * the character is not supported by this font.
  *
  * If this font has an atlas, it will return the atlas texture.  Otherwise,
- * it is returning a unique texture specifically generated for this string.
+ * it returns the page of the glyph cache containing the glyphs.
  *
  * @param thechar   The character to convert to render data
  * @param offset    The (unkerned) starting position of the quad
@@ -763,7 +1031,7 @@ std::shared_ptr<Texture> Font::getQuad(Uint32 thechar, Vec2& offset, const Rect
         return _texture;
     }
     
-    return getRenderedQuad(thechar,offset,rect,mesh,z);
+    return getCachedQuad(thechar,offset,rect,mesh,z);
 
 }
 
@@ -825,8 +1093,8 @@ void Font::getAtlasMesh(const std::string text, const Vec2 origin, const Rect re
  *
  * This method will append the vertices to the provided mesh and update
  * the indices to include these new vertices.  In addition, it will return
- * the texture that should be used with these vertices. If this is an atlas,
- * the texture will be that atlas.
+ * the texture that should be used with these vertices. This is the page
+ * of the glyph cache containing all of the glyphs.
  *
  * The quad sequence is adjusted so that all of the vertices fit in the
  * provided rectangle.  This may mean that some of the glyphs are truncated
@@ -848,89 +1116,46 @@ void Font::getAtlasMesh(const std::string text, const Vec2 origin, const Rect re
  *
  * @return the texture associated with the quads
  */
-std::shared_ptr<Texture> Font::getRenderedMesh(const std::string text, const Vec2 origin,
-                                               const Rect rect, Mesh<SpriteVertex2>& mesh, bool utf8) {
-    CUAssertLog(mesh.command == GL_TRIANGLES, "The mesh is not formatted for triangles");
-    SDL_Color color;
-    color.r = color.g = color.b = color.a = 255;
-    
-    // We have to do this because of format differences
-	SDL_Surface* surf1 = nullptr;
-    SDL_Surface* surf2 = nullptr;
-    
-    switch (_render) {
-        case Resolution::SOLID:
-            surf1 = (utf8 ? TTF_RenderUTF8_Solid(_data, text.c_str(), color) :
-                     TTF_RenderText_Solid(_data, text.c_str(), color));
-            surf2 = allocSurface(surf1->w, surf1->h);
-            SDL_SetSurfaceBlendMode(surf1, SDL_BLENDMODE_NONE);
-            SDL_BlitSurface(surf1,NULL,surf2,NULL);
-            SDL_FreeSurface(surf1);
-            surf1 = surf2;
-            break;
-        case Resolution::SHADED:
-            surf1 = (utf8 ? TTF_RenderUTF8_Blended(_data, text.c_str(), color) :
-                     TTF_RenderText_Blended(_data, text.c_str(), color));
-            surf2 = allocSurface(surf1->w, surf1->h);
-            SDL_BlitSurface(surf1,NULL,surf2,NULL);
-            SDL_FreeSurface(surf1);
-            surf1 = surf2;
-            break;
-        case Resolution::BLENDED:
-            surf1 = (utf8 ? TTF_RenderUTF8_Blended(_data, text.c_str(), color) :
-                     TTF_RenderText_Blended(_data, text.c_str(), color));
-            break;
+std::shared_ptr<Texture> Font::getCachedMesh(const std::string text, const Vec2 origin,
+                                             const Rect rect, Mesh<SpriteVertex2>& mesh, bool utf8) {
+    std::vector<Uint32> glyphs;
+    if (utf8) {
+        std::string line = text;
+        std::string::iterator end_it = utf8::find_invalid(line.begin(), line.end());
+        CUAssertLog(end_it == line.end(), "String '%s' has an invalid UTF-8 encoding",text.c_str());
+        utf8::utf8to32(line.begin(), line.end(), back_inserter(glyphs));
+    } else {
+        for(auto it = text.begin(); it != text.end(); ++it) {
+            glyphs.push_back((Uint8)*it);
+        }
     }
     
-    if (surf1 == nullptr) { return nullptr; }
-    std::shared_ptr<Texture> result = Texture::allocWithData(surf1->pixels,surf1->w,surf1->h);
-
-    Rect quad(origin.x,origin.y, (float)surf1->w, (float)surf1->h);
-    quad.intersect(rect);
-    
-    SpriteVertex2 temp;
-    GLuint size = (GLuint)mesh.vertices.size();
-
-    // Bottom left
-    temp.position = quad.origin;
-    temp.color = Color4::WHITE;
-    temp.texcoord.x = (quad.getMinX()-origin.x)/surf1->w;
-    temp.texcoord.y = 1-(quad.getMinY()-origin.y)/surf1->h;
-    mesh.vertices.push_back(temp);
-    
-    // Bottom right
-    temp.position = quad.origin;
-    temp.position.x += quad.size.width;
-    temp.color = Color4::WHITE;
-    temp.texcoord.x = (quad.getMaxX()-origin.x)/surf1->w;
-    temp.texcoord.y = 1-(quad.getMinY()-origin.y)/surf1->h;
-    mesh.vertices.push_back(temp);
-    
-    // Top right
-    temp.position = quad.origin + quad.size;
-    temp.color = Color4::WHITE;
-    temp.texcoord.x = (quad.getMaxX()-origin.x)/surf1->w;
-    temp.texcoord.y = 1-(quad.getMaxY()-origin.y)/surf1->h;
-    mesh.vertices.push_back(temp);
-    
-    // Top left
-    temp.position = quad.origin;
-    temp.position.y += quad.size.height;
-    temp.color = Color4::WHITE;
-    temp.texcoord.x = (quad.getMinX()-origin.x)/surf1->w;
-    temp.texcoord.y = 1-(quad.getMaxY()-origin.y)/surf1->h;
-    mesh.vertices.push_back(temp);
-    
-    // Add the quad indices
-    mesh.indices.push_back(size);
-    mesh.indices.push_back(size+1);
-    mesh.indices.push_back(size+2);
-    mesh.indices.push_back(size+2);
-    mesh.indices.push_back(size+3);
-    mesh.indices.push_back(size);
+    GlyphCache* cache = getGlyphCache().get();
+    int page = (cache == nullptr ? -1 : cache->acquire(glyphs.data(), glyphs.size()));
+    syncGeneration();
+    if (page == -1) {
+        return nullptr;
+    }
     
-    SDL_FreeSurface(surf1);
-    return result;
+    const std::shared_ptr<Texture>& texture = cache->getTexture(page);
+    Vec2 offset = origin;
+    Rect bounds;
+    bool first = true;
+    Uint32 last = 0;
+    for(auto it = glyphs.begin(); it != glyphs.end(); ++it) {
+        if (!cache->getBounds(page, *it, bounds)) {
+            continue;
+        }
+        if (!first) {
+            offset.x -= computeKerning(last, *it);
+        }
+        if (!getGlyphQuad(bounds, *texture, offset, rect, mesh)) {
+            break;
+        }
+        first = false;
+        last = *it;
+    }
+    return texture;
 }
 
 /**
@@ -954,12 +1179,50 @@ std::shared_ptr<Texture> Font::getRenderedMesh(const std::string text, const Vec
  * @return true if the right edge of the glyph was generated
  */
 bool Font::getAtlasQuad(Uint32 thechar, Vec2& offset, const Rect rect, Mesh<SpriteVertex2>& mesh) {
-    CUAssertLog(mesh.command == GL_TRIANGLES, "The mesh is not formatted for triangles");
-
     // Technically, this answer is correct
     if (!hasGlyph(thechar)) { return true; }
+    if (_spread == 0) {
+        return getGlyphQuad(_glyphmap[thechar], *_texture, offset, rect, mesh);
+    }
     
+    // A distance field extends past the glyph by the spread
     Rect bounds = _glyphmap[thechar];
+    float advance = offset.x+bounds.size.width;
+    Vec2 start(offset.x-_spread,offset.y-_spread);
+    bounds.origin.x -= _spread;
+    bounds.origin.y -= _spread;
+    bounds.size.width  += 2*_spread;
+    bounds.size.height += 2*_spread;
+    bool result = getGlyphQuad(bounds, *_texture, start, rect, mesh);
+    offset.x = advance;
+    return result || advance <= rect.getMaxX();
+}
+
+/**
+ * Creates a single quad to render a glyph and stores it in the mesh
+ *
+ * This method will append the vertices to the given mesh and update
+ * the indices to include these new vertices. The glyph is the region of
+ * the texture with the given bounds (with the origin at the top left).
+ * The quad is adjusted so that all of the vertices fit in the provided
+ * rectangle. This may mean that no quad is generated at all.
+ *
+ * This method will return false if the right edge of the glyph is not
+ * rendered. This lets us know if a character has exceeded the bounding
+ * rectangle.  Without this, kerning may move the next character back
+ * into range.
+ *
+ * @param bounds    The glyph bounds in the texture
+ * @param texture   The texture containing the glyph
+ * @param offset    The (unkerned) starting position of the quad
+ * @param rect      The bounding box for the quad
+ * @param mesh      The mesh to store the vertices
+ *
+ * @return true if the right edge of the glyph was generated
+ */
+bool Font::getGlyphQuad(Rect bounds, const Texture& texture, Vec2& offset, const Rect rect,
+                        Mesh<SpriteVertex2>& mesh) {
+    CUAssertLog(mesh.command == GL_TRIANGLES, "The mesh is not formatted for triangles");
     Rect quad(offset,bounds.size);
     
     // Skip over glyph, but recognize we may have later glyphs
@@ -979,8 +1242,8 @@ bool Font::getAtlasQuad(Uint32 thechar, Vec2& offset, const Rect rect, Mesh<Spri
     offset.x += bounds.size.width;
     bounds.size = quad.size;
     
-    int width  = _texture->getWidth();
-    int height = _texture->getHeight();
+    int width  = texture.getWidth();
+    int height = texture.getHeight();
 
     SpriteVertex2 temp;
     GLuint size = (GLuint)mesh.vertices.size();
@@ -1031,8 +1294,8 @@ bool Font::getAtlasQuad(Uint32 thechar, Vec2& offset, const Rect rect, Mesh<Spri
  *
  * This method will append the vertices to the provided mesh and update
  * the indices to include these new vertices.  In addition, it will return
- * the texture that should be used with these vertices. If this is an atlas,
- * the texture will be that atlas.
+ * the texture that should be used with these vertices. This is the page
+ * of the glyph cache containing the glyph.
  *
  * The quad is adjusted so that all of the vertices fit in the provided
  * rectangle.  This may mean that no quad is generated at all.
@@ -1048,87 +1311,20 @@ bool Font::getAtlasQuad(Uint32 thechar, Vec2& offset, const Rect rect, Mesh<Spri
  *
  * @return the texture associated with the quads
  */
-std::shared_ptr<Texture> Font::getRenderedQuad(Uint32 thechar, Vec2& offset, const Rect rect,
-                                               Mesh<SpriteVertex2>& mesh) {
-    CUAssertLog(mesh.command == GL_TRIANGLES, "The mesh is not formatted for triangles");
-    SDL_Color color;
-    color.r = color.g = color.b = color.a = 255;
-    
-    // We have to do this because of format differences
-	SDL_Surface* surf1 = nullptr;
-    SDL_Surface* surf2 = nullptr;
-    
-    switch (_render) {
-        case Resolution::SOLID:
-            surf1 = TTF_RenderGlyph_Solid(_data, thechar, color);
-            surf2 = allocSurface(surf1->w, surf1->h);
-            SDL_SetSurfaceBlendMode(surf1, SDL_BLENDMODE_NONE);
-            SDL_BlitSurface(surf1,NULL,surf2,NULL);
-            SDL_FreeSurface(surf1);
-            surf1 = surf2;
-            break;
-        case Resolution::SHADED:
-            surf1 = TTF_RenderGlyph_Blended(_data, thechar, color);
-            surf2 = allocSurface(surf1->w, surf1->h);
-            SDL_BlitSurface(surf1,NULL,surf2,NULL);
-            SDL_FreeSurface(surf1);
-            surf1 = surf2;
-            break;
-        case Resolution::BLENDED:
-            surf1 = TTF_RenderGlyph_Blended(_data, thechar, color);
-            break;
+std::shared_ptr<Texture> Font::getCachedQuad(Uint32 thechar, Vec2& offset, const Rect rect,
+                                             Mesh<SpriteVertex2>& mesh) {
+    GlyphCache* cache = getGlyphCache().get();
+    int page = (cache == nullptr ? -1 : cache->acquire(&thechar, 1));
+    syncGeneration();
+    
+    Rect bounds;
+    if (page == -1 || !cache->getBounds(page, thechar, bounds)) {
+        return nullptr;
     }
     
-    if (surf1 == nullptr) { return nullptr; }
-    std::shared_ptr<Texture> result = Texture::allocWithData(surf1->pixels,surf1->w,surf1->h);
-    
-    Rect quad(offset.x,offset.y, (float)surf1->w, (float)surf1->h);
-    quad.intersect(rect);
-
-    SpriteVertex2 temp;
-    GLuint size = (GLuint)mesh.vertices.size();
-
-    // Bottom left
-    temp.position = quad.origin;
-    temp.color = Color4::WHITE;
-    temp.texcoord.x = (quad.getMinX()-offset.x)/surf1->w;
-    temp.texcoord.y = 1-(quad.getMinY()-offset.y)/surf1->h;
-    mesh.vertices.push_back(temp);
-    
-    // Bottom right
-    temp.position = quad.origin;
-    temp.position.x += quad.size.width;
-    temp.color = Color4::WHITE;
-    temp.texcoord.x = (quad.getMaxX()-offset.x)/surf1->w;
-    temp.texcoord.y = 1-(quad.getMinY()-offset.y)/surf1->h;
-    mesh.vertices.push_back(temp);
-    
-    // Top right
-    temp.position = quad.origin+quad.size;
-    temp.color = Color4::WHITE;
-    temp.texcoord.x = (quad.getMaxX()-offset.x)/surf1->w;
-    temp.texcoord.y = 1-(quad.getMaxY()-offset.y)/surf1->h;
-    mesh.vertices.push_back(temp);
-    
-    // Top left
-    temp.position = quad.origin;
-    temp.position.y += quad.size.height;
-    temp.color = Color4::WHITE;
-    temp.texcoord.x = (quad.getMinX()-offset.x)/surf1->w;
-    temp.texcoord.y = 1-(quad.getMaxY()-offset.y)/surf1->h;
-    mesh.vertices.push_back(temp);
-
-    // Add the quad indices
-    mesh.indices.push_back(size);
-    mesh.indices.push_back(size+1);
-    mesh.indices.push_back(size+2);
-    mesh.indices.push_back(size+2);
-    mesh.indices.push_back(size+3);
-    mesh.indices.push_back(size);
-
-    offset.x = quad.getMaxX();
-    SDL_FreeSurface(surf1);
-    return result;
+    const std::shared_ptr<Texture>& texture = cache->getTexture(page);
+    getGlyphQuad(bounds, *texture, offset, rect, mesh);
+    return texture;
 }
 
 /**
@@ -1188,8 +1384,8 @@ void Font::getAtlasMesh(const std::string text, const Vec2 origin, const Rect re
  *
  * This method will append the vertices to the provided mesh and update
  * the indices to include these new vertices.  In addition, it will return
- * the texture that should be used with these vertices. If this is an atlas,
- * the texture will be that atlas.
+ * the texture that should be used with these vertices. This is the page
+ * of the glyph cache containing all of the glyphs.
  *
  * The quad sequence is adjusted so that all of the vertices fit in the
  * provided rectangle.  This may mean that some of the glyphs are truncated
@@ -1212,95 +1408,46 @@ void Font::getAtlasMesh(const std::string text, const Vec2 origin, const Rect re
  *
  * @return the texture associated with the quads
  */
-std::shared_ptr<Texture> Font::getRenderedMesh(const std::string text, const Vec2 origin,
-                                               const Rect rect, Mesh<SpriteVertex3>& mesh, float z, bool utf8) {
-    CUAssertLog(mesh.command == GL_TRIANGLES, "The mesh is not formatted for triangles");
-    SDL_Color color;
-    color.r = color.g = color.b = color.a = 255;
-    
-    // We have to do this because of format differences
-    SDL_Surface* surf1 = nullptr;
-    SDL_Surface* surf2 = nullptr;
-    
-    switch (_render) {
-        case Resolution::SOLID:
-            surf1 = (utf8 ? TTF_RenderUTF8_Solid(_data, text.c_str(), color) :
-                     TTF_RenderText_Solid(_data, text.c_str(), color));
-            surf2 = allocSurface(surf1->w, surf1->h);
-            SDL_SetSurfaceBlendMode(surf1, SDL_BLENDMODE_NONE);
-            SDL_BlitSurface(surf1,NULL,surf2,NULL);
-            SDL_FreeSurface(surf1);
-            surf1 = surf2;
-            break;
-        case Resolution::SHADED:
-            surf1 = (utf8 ? TTF_RenderUTF8_Blended(_data, text.c_str(), color) :
-                     TTF_RenderText_Blended(_data, text.c_str(), color));
-            surf2 = allocSurface(surf1->w, surf1->h);
-            SDL_BlitSurface(surf1,NULL,surf2,NULL);
-            SDL_FreeSurface(surf1);
-            surf1 = surf2;
-            break;
-        case Resolution::BLENDED:
-            surf1 = (utf8 ? TTF_RenderUTF8_Blended(_data, text.c_str(), color) :
-                     TTF_RenderText_Blended(_data, text.c_str(), color));
-            break;
+std::shared_ptr<Texture> Font::getCachedMesh(const std::string text, const Vec2 origin,
+                                             const Rect rect, Mesh<SpriteVertex3>& mesh, float z, bool utf8) {
+    std::vector<Uint32> glyphs;
+    if (utf8) {
+        std::string line = text;
+        std::string::iterator end_it = utf8::find_invalid(line.begin(), line.end());
+        CUAssertLog(end_it == line.end(), "String '%s' has an invalid UTF-8 encoding",text.c_str());
+        utf8::utf8to32(line.begin(), line.end(), back_inserter(glyphs));
+    } else {
+        for(auto it = text.begin(); it != text.end(); ++it) {
+            glyphs.push_back((Uint8)*it);
+        }
     }
     
-    if (surf1 == nullptr) { return nullptr; }
-    std::shared_ptr<Texture> result = Texture::allocWithData(surf1->pixels,surf1->w,surf1->h);
-
-    Rect quad(origin.x,origin.y, (float)surf1->w, (float)surf1->h);
-    quad.intersect(rect);
-    
-    SpriteVertex3 temp;
-    GLuint size = (GLuint)mesh.vertices.size();
-
-    // Bottom left
-    temp.position.x = quad.origin.x;
-    temp.position.y = quad.origin.y;
-    temp.position.z = z;
-    temp.color = Color4::WHITE;
-    temp.texcoord.x = (quad.getMinX()-origin.x)/surf1->w;
-    temp.texcoord.y = 1-(quad.getMinY()-origin.y)/surf1->h;
-    mesh.vertices.push_back(temp);
-    
-    // Bottom right
-    temp.position.x = quad.origin.x+quad.size.width;
-    temp.position.y = quad.origin.y;
-    temp.position.z = z;
-    temp.color = Color4::WHITE;
-    temp.texcoord.x = (quad.getMaxX()-origin.x)/surf1->w;
-    temp.texcoord.y = 1-(quad.getMinY()-origin.y)/surf1->h;
-    mesh.vertices.push_back(temp);
-    
-    // Top right
-    temp.position.x = quad.origin.x+quad.size.width;
-    temp.position.y = quad.origin.y+quad.size.height;
-    temp.position.z = z;
-    temp.color = Color4::WHITE;
-    temp.texcoord.x = (quad.getMaxX()-origin.x)/surf1->w;
-    temp.texcoord.y = 1-(quad.getMaxY()-origin.y)/surf1->h;
-    mesh.vertices.push_back(temp);
-    
-    // Top left
-    temp.position.x = quad.origin.x;
-    temp.position.y = quad.origin.y+quad.size.height;
-    temp.position.z = z;
-    temp.color = Color4::WHITE;
-    temp.texcoord.x = (quad.getMinX()-origin.x)/surf1->w;
-    temp.texcoord.y = 1-(quad.getMaxY()-origin.y)/surf1->h;
-    mesh.vertices.push_back(temp);
-    
-    // Add the quad indices
-    mesh.indices.push_back(size);
-    mesh.indices.push_back(size+1);
-    mesh.indices.push_back(size+2);
-    mesh.indices.push_back(size+2);
-    mesh.indices.push_back(size+3);
-    mesh.indices.push_back(size);
+    GlyphCache* cache = getGlyphCache().get();
+    int page = (cache == nullptr ? -1 : cache->acquire(glyphs.data(), glyphs.size()));
+    syncGeneration();
+    if (page == -1) {
+        return nullptr;
+    }
     
-    SDL_FreeSurface(surf1);
-    return result;
+    const std::shared_ptr<Texture>& texture = cache->getTexture(page);
+    Vec2 offset = origin;
+    Rect bounds;
+    bool first = true;
+    Uint32 last = 0;
+    for(auto it = glyphs.begin(); it != glyphs.end(); ++it) {
+        if (!cache->getBounds(page, *it, bounds)) {
+            continue;
+        }
+        if (!first) {
+            offset.x -= computeKerning(last, *it);
+        }
+        if (!getGlyphQuad(bounds, *texture, offset, rect, mesh, z)) {
+            break;
+        }
+        first = false;
+        last = *it;
+    }
+    return texture;
 }
 
 /**
@@ -1325,12 +1472,51 @@ std::shared_ptr<Texture> Font::getRenderedMesh(const std::string text, const Vec
  * @return true if the right edge of the glyph was generated
  */
 bool Font::getAtlasQuad(Uint32 thechar, Vec2& offset, const Rect rect, Mesh<SpriteVertex3>& mesh, float z) {
-    CUAssertLog(mesh.command == GL_TRIANGLES, "The mesh is not formatted for triangles");
-
     // Technically, this answer is correct
     if (!hasGlyph(thechar)) { return true; }
+    if (_spread == 0) {
+        return getGlyphQuad(_glyphmap[thechar], *_texture, offset, rect, mesh, z);
+    }
     
+    // A distance field extends past the glyph by the spread
     Rect bounds = _glyphmap[thechar];
+    float advance = offset.x+bounds.size.width;
+    Vec2 start(offset.x-_spread,offset.y-_spread);
+    bounds.origin.x -= _spread;
+    bounds.origin.y -= _spread;
+    bounds.size.width  += 2*_spread;
+    bounds.size.height += 2*_spread;
+    bool result = getGlyphQuad(bounds, *_texture, start, rect, mesh, z);
+    offset.x = advance;
+    return result || advance <= rect.getMaxX();
+}
+
+/**
+ * Creates a single quad to render a glyph and stores it in the mesh
+ *
+ * This method will append the vertices to the given mesh and update
+ * the indices to include these new vertices. The glyph is the region of
+ * the texture with the given bounds (with the origin at the top left).
+ * The quad is adjusted so that all of the vertices fit in the provided
+ * rectangle. This may mean that no quad is generated at all.
+ *
+ * This method will return false if the right edge of the glyph is not
+ * rendered. This lets us know if a character has exceeded the bounding
+ * rectangle.  Without this, kerning may move the next character back
+ * into range.
+ *
+ * @param bounds    The glyph bounds in the texture
+ * @param texture   The texture containing the glyph
+ * @param offset    The (unkerned) starting position of the quad
+ * @param rect      The bounding box for the quad
+ * @param mesh      The mesh to store the vertices
+ * @param z         The uniform z-offset in 3-d space
+ *
+ * @return true if the right edge of the glyph was generated
+ */
+bool Font::getGlyphQuad(Rect bounds, const Texture& texture, Vec2& offset, const Rect rect,
+                        Mesh<SpriteVertex3>& mesh, float z) {
+    CUAssertLog(mesh.command == GL_TRIANGLES, "The mesh is not formatted for triangles");
     Rect quad(offset,bounds.size);
     
     // Skip over glyph, but recognize we may have later glyphs
@@ -1350,8 +1536,8 @@ bool Font::getAtlasQuad(Uint32 thechar, Vec2& offset, const Rect rect, Mesh<Spri
     offset.x += bounds.size.width;
     bounds.size = quad.size;
     
-    int width  = _texture->getWidth();
-    int height = _texture->getHeight();
+    int width  = texture.getWidth();
+    int height = texture.getHeight();
 
     SpriteVertex3 temp;
     GLuint size = (GLuint)mesh.vertices.size();
@@ -1408,8 +1594,8 @@ bool Font::getAtlasQuad(Uint32 thechar, Vec2& offset, const Rect rect, Mesh<Spri
  *
  * This method will append the vertices to the provided mesh and update
  * the indices to include these new vertices.  In addition, it will return
- * the texture that should be used with these vertices. If this is an atlas,
- * the texture will be that atlas.
+ * the texture that should be used with these vertices. This is the page
+ * of the glyph cache containing the glyph.
  *
  * The quad is adjusted so that all of the vertices fit in the provided
  * rectangle.  This may mean that no quad is generated at all.
@@ -1426,93 +1612,20 @@ bool Font::getAtlasQuad(Uint32 thechar, Vec2& offset, const Rect rect, Mesh<Spri
  *
  * @return the texture associated with the quads
  */
-std::shared_ptr<Texture> Font::getRenderedQuad(Uint32 thechar, Vec2& offset, const Rect rect,
-                                               Mesh<SpriteVertex3>& mesh, float z) {
-    CUAssertLog(mesh.command == GL_TRIANGLES, "The mesh is not formatted for triangles");
-    SDL_Color color;
-    color.r = color.g = color.b = color.a = 255;
-    
-    // We have to do this because of format differences
-    SDL_Surface* surf1 = nullptr;
-    SDL_Surface* surf2 = nullptr;
-    
-    switch (_render) {
-        case Resolution::SOLID:
-            surf1 = TTF_RenderGlyph_Solid(_data, thechar, color);
-            surf2 = allocSurface(surf1->w, surf1->h);
-            SDL_SetSurfaceBlendMode(surf1, SDL_BLENDMODE_NONE);
-            SDL_BlitSurface(surf1,NULL,surf2,NULL);
-            SDL_FreeSurface(surf1);
-            surf1 = surf2;
-            break;
-        case Resolution::SHADED:
-            surf1 = TTF_RenderGlyph_Blended(_data, thechar, color);
-            surf2 = allocSurface(surf1->w, surf1->h);
-            SDL_BlitSurface(surf1,NULL,surf2,NULL);
-            SDL_FreeSurface(surf1);
-            surf1 = surf2;
-            break;
-        case Resolution::BLENDED:
-            surf1 = TTF_RenderGlyph_Blended(_data, thechar, color);
-            break;
+std::shared_ptr<Texture> Font::getCachedQuad(Uint32 thechar, Vec2& offset, const Rect rect,
+                                             Mesh<SpriteVertex3>& mesh, float z) {
+    GlyphCache* cache = getGlyphCache().get();
+    int page = (cache == nullptr ? -1 : cache->acquire(&thechar, 1));
+    syncGeneration();
+    
+    Rect bounds;
+    if (page == -1 || !cache->getBounds(page, thechar, bounds)) {
+        return nullptr;
     }
     
-    if (surf1 == nullptr) { return nullptr; }
-    std::shared_ptr<Texture> result = Texture::allocWithData(surf1->pixels,surf1->w,surf1->h);
-    
-    Rect quad(offset.x,offset.y, (float)surf1->w, (float)surf1->h);
-    quad.intersect(rect);
-
-    SpriteVertex3 temp;
-    GLuint size = (GLuint)mesh.vertices.size();
-
-    // Bottom left
-    temp.position.x = quad.origin.x;
-    temp.position.y = quad.origin.y;
-    temp.position.z = z;
-    temp.color = Color4::WHITE;
-    temp.texcoord.x = (quad.getMinX()-offset.x)/surf1->w;
-    temp.texcoord.y = 1-(quad.getMinY()-offset.y)/surf1->h;
-    mesh.vertices.push_back(temp);
-    
-    // Bottom right
-    temp.position.x = quad.origin.x+quad.size.width;
-    temp.position.y = quad.origin.y;
-    temp.position.z = z;
-    temp.color = Color4::WHITE;
-    temp.texcoord.x = (quad.getMaxX()-offset.x)/surf1->w;
-    temp.texcoord.y = 1-(quad.getMinY()-offset.y)/surf1->h;
-    mesh.vertices.push_back(temp);
-    
-    // Top right
-    temp.position.x = quad.origin.x+quad.size.width;
-    temp.position.y = quad.origin.y+quad.size.height;
-    temp.position.z = z;
-    temp.color = Color4::WHITE;
-    temp.texcoord.x = (quad.getMaxX()-offset.x)/surf1->w;
-    temp.texcoord.y = 1-(quad.getMaxY()-offset.y)/surf1->h;
-    mesh.vertices.push_back(temp);
-    
-    // Top left
-    temp.position.x = quad.origin.x;
-    temp.position.y = quad.origin.y+quad.size.height;
-    temp.position.z = z;
-    temp.color = Color4::WHITE;
-    temp.texcoord.x = (quad.getMinX()-offset.x)/surf1->w;
-    temp.texcoord.y = 1-(quad.getMaxY()-offset.y)/surf1->h;
-    mesh.vertices.push_back(temp);
-
-    // Add the quad indices
-    mesh.indices.push_back(size);
-    mesh.indices.push_back(size+1);
-    mesh.indices.push_back(size+2);
-    mesh.indices.push_back(size+2);
-    mesh.indices.push_back(size+3);
-    mesh.indices.push_back(size);
-
-    offset.x = quad.getMaxX();
-    SDL_FreeSurface(surf1);
-    return result;
+    const std::shared_ptr<Texture>& texture = cache->getTexture(page);
+    getGlyphQuad(bounds, *texture, offset, rect, mesh, z);
+    return texture;
 }
 
 /**
@@ -1781,12 +1894,13 @@ Rect Font::getInternalBoundsUTF8(const std::string text) const {
 int Font::prepareAtlas() {
     // Check all the glyphs
     int maxwidth = 0;
+    int border = computeBorder();
     
     for(unsigned int ii = 32; ii < 127; ii++) {
         if (TTF_GlyphIsProvided(_data, (Uint16)ii)) {
             Metrics metrics = computeMetrics(ii);
             _glyphsize.emplace(ii,metrics);
-            _glyphmap.emplace(ii,Rect(0,0, (float)(metrics.advance+GLYPH_BORDER), (float)(_fontHeight+GLYPH_BORDER)));
+            _glyphmap.emplace(ii,Rect(0,0, (float)(metrics.advance+border), (float)(_fontHeight+border)));
             _glyphset.push_back(ii);
             if (metrics.advance > maxwidth) {
                 maxwidth = metrics.advance;
@@ -1816,6 +1930,7 @@ int Font::prepareAtlas() {
 int Font::prepareAtlas(std::string charset) {
     // Check all the glyphs
     int maxwidth = 0;
+    int border = computeBorder();
     
     std::string::iterator end_it = utf8::find_invalid(charset.begin(), charset.end());
     CUAssertLog(end_it == charset.end(), "String '%s' has an invalid UTF-8 encoding",charset.c_str());
@@ -1828,7 +1943,7 @@ int Font::prepareAtlas(std::string charset) {
         if (_glyphmap.find(thechar) == _glyphmap.end() && TTF_GlyphIsProvided(_data, (Uint16)thechar)) {
             Metrics metrics = computeMetrics(thechar);
             _glyphsize.emplace(thechar,metrics);
-            _glyphmap.emplace(thechar,Rect(0,0, (float)(metrics.advance+GLYPH_BORDER), (float)(_fontHeight+GLYPH_BORDER)));
+            _glyphmap.emplace(thechar,Rect(0,0, (float)(metrics.advance+border), (float)(_fontHeight+border)));
             _glyphset.push_back(thechar);
             if (metrics.advance > maxwidth) {
                 maxwidth = metrics.advance;
@@ -1909,6 +2024,18 @@ int Font::computeKerning(Uint32 a, Uint32 b) const {
     return w2-w1;
 }
 
+/**
+ * Returns the total border (both sides) around each glyph in the atlas.
+ *
+ * The border prevents bleeding between glyphs. A distance field atlas
+ * also needs room for the spread on either side of each glyph.
+ *
+ * @return the total border (both sides) around each glyph in the atlas.
+ */
+int Font::computeBorder() const {
+    return GLYPH_BORDER+2*_spread;
+}
+
 /**
  * Computes the size of the atlas texture
  *
@@ -1926,8 +2053,9 @@ int Font::computeKerning(Uint32 a, Uint32 b) const {
  */
 void Font::computeAtlasSize(int* width, int* height) {
     // Make enough room for largest glyph
-    *width  = nextPOT(*width+GLYPH_BORDER);
-    *height = nextPOT(_fontHeight+GLYPH_BORDER);
+    int border = computeBorder();
+    *width  = nextPOT(*width+border);
+    *height = nextPOT(_fontHeight+border);
     
     // Copy the glyphs to make a visited set
     int nrows  = 1;
@@ -1964,7 +2092,7 @@ void Font::computeAtlasSize(int* width, int* height) {
 		auto pos = copied.begin();
         for(auto it = copied.begin(); !found && it != copied.end(); ++it) {
             if (_glyphsize[*it].advance < *width-used[line]) {
-                used[line] += _glyphsize[*it].advance+GLYPH_BORDER;
+                used[line] += _glyphsize[*it].advance+border;
 				pos = it;
                 found = true;
             }
@@ -1993,6 +2121,7 @@ std::vector< std::vector<Uint32> > Font::planAtlas(int width, int height) {
     // Time to order the glyphs
     int line = 0;
     int left = width-2; // Give us a spot for a 2-patch
+    int border = computeBorder();
     
     // Create a (inverse) visited set
     std::deque< wchar_t > copied;
@@ -2011,11 +2140,11 @@ std::vector< std::vector<Uint32> > Font::planAtlas(int width, int height) {
         
         // Find the largest glyph that will fit on line.
         bool found = false;
-        int fheight = _fontHeight+GLYPH_BORDER;
+        int fheight = _fontHeight+border;
 		auto value = copied.begin();
         for(auto it = copied.begin(); !found && it != copied.end(); ++it) {
             wchar_t thechar = (wchar_t)(*it);
-            int glwidth = _glyphsize[*it].advance+GLYPH_BORDER;
+            int glwidth = _glyphsize[*it].advance+border;
             if (glwidth < left) {
                 result[line].push_back(thechar);
                 _glyphmap[thechar].origin.x = (float)(width-left);
@@ -2055,6 +2184,7 @@ void Font::layoutAtlas(const std::vector< std::vector<Uint32> >& rectangle) {
     srcrect.w = srcrect.h = 2;
     SDL_FillRect(_surface,&srcrect,SDL_MapRGBA(_surface->format, 255, 255, 255, 255));
     
+    int border = computeBorder();
     for(auto it = _glyphset.begin(); it != _glyphset.end(); ++it) {
 		SDL_Surface* temp = nullptr;
         switch (_render) {
@@ -2068,10 +2198,10 @@ void Font::layoutAtlas(const std::vector< std::vector<Uint32> >& rectangle) {
         }
         
         // Resize the boundary now that spacing is safe.
-        _glyphmap[*it].origin.x += GLYPH_BORDER/2;
-        _glyphmap[*it].origin.y += GLYPH_BORDER/2;
-        _glyphmap[*it].size.width  -= GLYPH_BORDER;
-        _glyphmap[*it].size.height -= GLYPH_BORDER;
+        _glyphmap[*it].origin.x += border/2;
+        _glyphmap[*it].origin.y += border/2;
+        _glyphmap[*it].size.width  -= border;
+        _glyphmap[*it].size.height -= border;
         
         // Convert to SDL rects
         dstrect.x = (int)_glyphmap[*it].origin.x;
@@ -2089,6 +2219,71 @@ void Font::layoutAtlas(const std::vector< std::vector<Uint32> >& rectangle) {
     }
 }
 
+/**
+ * Converts the glyph coverage in the SDL surface to a distance field.
+ *
+ * Each texel is assigned the signed distance to the nearest glyph edge,
+ * scaled so that the spread maps to [0,1], with the edge at 0.5. The
+ * distance is stored in the alpha channel, leaving the color white. The
+ * glyphs are far enough apart that this can be done for the whole atlas
+ * at once.
+ */
+void Font::computeDistanceField() {
+    int width  = _surface->w;
+    int height = _surface->h;
+    SDL_PixelFormat* format = _surface->format;
+    if (SDL_MUSTLOCK(_surface)) {
+        SDL_LockSurface(_surface);
+    }
+    
+    // Threshold the coverage. The 2-patch is not a glyph and must not bleed.
+    std::vector<float> outside((size_t)width*height);
+    std::vector<float> inside((size_t)width*height);
+    Uint8* pixels = (Uint8*)_surface->pixels;
+    for(int y = 0; y < height; y++) {
+        Uint32* row = (Uint32*)(pixels+y*_surface->pitch);
+        for(int x = 0; x < width; x++) {
+            Uint32 alpha = (row[x] & format->Amask) >> format->Ashift;
+            bool solid = alpha >= 128 && (x >= 2 || y >= 2);
+            outside[(size_t)y*width+x] = solid ? 0 : DISTANCE_FAR;
+            inside[(size_t)y*width+x]  = solid ? DISTANCE_FAR : 0;
+        }
+    }
+    distance_transform(outside, width, height);
+    distance_transform(inside, width, height);
+    
+    // Measure from texel centers, so the edge falls halfway between texels
+    Uint32 white = format->Rmask | format->Gmask | format->Bmask;
+    float scale = 0.5f/_spread;
+    for(int y = 0; y < height; y++) {
+        Uint32* row = (Uint32*)(pixels+y*_surface->pitch);
+        for(int x = 0; x < width; x++) {
+            size_t pos = (size_t)y*width+x;
+            float dist;
+            if (outside[pos] > 0) {
+                dist = 0.5f-std::sqrt(outside[pos]);
+            } else {
+                dist = std::sqrt(inside[pos])-0.5f;
+            }
+            float value = std::min(std::max(0.5f+dist*scale, 0.0f), 1.0f);
+            Uint32 alpha = (Uint32)(value*255.0f+0.5f);
+            row[x] = white | ((alpha << format->Ashift) & format->Amask);
+        }
+    }
+    
+    // Restore the 2-patch
+    for(int y = 0; y < 2 && y < height; y++) {
+        Uint32* row = (Uint32*)(pixels+y*_surface->pitch);
+        for(int x = 0; x < 2 && x < width; x++) {
+            row[x] = white | format->Amask;
+        }
+    }
+    
+    if (SDL_MUSTLOCK(_surface)) {
+        SDL_UnlockSurface(_surface);
+    }
+}
+
 /**
  * Generates an SDL surface for the font atlas.
  *
@@ -2102,6 +2297,9 @@ void Font::layoutAtlas(const std::vector< std::vector<Uint32> >& rectangle) {
 bool Font::generateSurface(int width, int height) {
     _surface = allocSurface(width, height);
     layoutAtlas(planAtlas(width,height));
+    if (_spread > 0 && _surface != nullptr) {
+        computeDistanceField();
+    }
     return _surface != nullptr;
 }
 
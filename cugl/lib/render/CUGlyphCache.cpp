@@ -0,0 +1,609 @@
+//
+//  CUGlyphCache.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a dynamic glyph cache for fonts without an atlas.
+//  Glyphs are rasterized the first time that they are used, and are packed
+//  into a small number of texture pages. This means that text outside of a
+//  fixed character set (such as localized text) can still be drawn from an
+//  atlas, instead of creating a new texture every time the text changes.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: agent
+//  Version: 10/19/26
+//
+#include <cugl/render/CUGlyphCache.h>
+#include <cugl/util/CUDebug.h>
+#include <cugl/util/CUFiletools.h>
+#include <cugl/util/CUThreadPool.h>
+#include <cugl/math/CUMathBase.h>
+#include <algorithm>
+#include <climits>
+
+using namespace cugl;
+
+/** The amount of border to put around a glyph to prevent bleeding. */
+#define GLYPH_BORDER        2
+/** The number of shelves to aim for in a single page */
+#define GLYPH_PAGE_SHELVES  16
+/** The minimum page size */
+#define GLYPH_PAGE_MIN      256
+/** The maximum page size */
+#define GLYPH_PAGE_MAX      2048
+/** The default maximum number of pages */
+#define GLYPH_MAX_PAGES     4
+
+#pragma mark -
+#pragma mark Surface Helpers
+/**
+ * Returns a blank RGBA surface of the given size.
+ *
+ * This is the same format as the font atlas, so that the pixels may be
+ * uploaded directly to a texture page.
+ *
+ * @param width     The surface width
+ * @param height    The surface height
+ *
+ * @return a blank RGBA surface of the given size.
+ */
+static SDL_Surface* alloc_surface(int width, int height) {
+    // Unfortunately, masks are endian
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+    Uint32 rmask = 0xff000000;
+    Uint32 gmask = 0x00ff0000;
+    Uint32 bmask = 0x0000ff00;
+    Uint32 amask = 0x000000ff;
+#else
+    Uint32 rmask = 0x000000ff;
+    Uint32 gmask = 0x0000ff00;
+    Uint32 bmask = 0x00ff0000;
+    Uint32 amask = 0xff000000;
+#endif
+
+    SDL_Surface* result = SDL_CreateRGBSurface(SDL_SWSURFACE, width, height, 32, rmask, gmask, bmask, amask);
+    if (result != nullptr) {
+        SDL_SetSurfaceBlendMode(result, SDL_BLENDMODE_BLEND);
+        SDL_FillRect(result, NULL, SDL_MapRGBA(result->format, 0, 0, 0, 0));
+    }
+    return result;
+}
+
+/**
+ * Deletes the rasterizer, closing the font and all pending surfaces.
+ */
+GlyphCache::Rasterizer::~Rasterizer() {
+    for(auto it = pending.begin(); it != pending.end(); ++it) {
+        if (it->second != nullptr) {
+            SDL_FreeSurface(it->second);
+        }
+    }
+    pending.clear();
+    if (data != nullptr) {
+        TTF_CloseFont(data);
+        data = nullptr;
+    }
+}
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates a degenerate glyph cache with no font.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate an object on
+ * the heap, use one of the static constructors instead.
+ */
+GlyphCache::GlyphCache() :
+_shelfHeight(0),
+_pageSize(0),
+_maxPages(GLYPH_MAX_PAGES),
+_tick(0),
+_evictions(0) {
+}
+
+/**
+ * Deletes the glyph cache resources and resets all attributes.
+ *
+ * This deletes all texture pages. Glyphs queued for rasterization on
+ * a worker thread are discarded.
+ */
+void GlyphCache::dispose() {
+    clear();
+    for(auto it = _ready.begin(); it != _ready.end(); ++it) {
+        if (it->second != nullptr) {
+            SDL_FreeSurface(it->second);
+        }
+    }
+    _ready.clear();
+    _missing.clear();
+    _rasterizer = nullptr;
+    _threads = nullptr;
+    _shelfHeight = 0;
+    _pageSize = 0;
+    _maxPages = GLYPH_MAX_PAGES;
+    _tick = 0;
+    _evictions = 0;
+}
+
+/**
+ * Initializes a glyph cache for the given font file.
+ *
+ * The font is opened a second time, so that glyphs may be rasterized
+ * while the owning font is in use. The style, hinting and resolution
+ * must match those of the owning font. If they change, the cache must
+ * be replaced.
+ *
+ * @param file          The file with the font asset
+ * @param size          The font size in points
+ * @param style         The font face style
+ * @param hinting       The rasterization hints
+ * @param resolution    The rendering resolution
+ *
+ * @return true if initialization is successful.
+ */
+bool GlyphCache::init(const std::string file, int size, Font::Style style,
+                      Font::Hinting hinting, Font::Resolution resolution) {
+    if (_rasterizer != nullptr) {
+        CUAssertLog(false, "Glyph cache is already initialized");
+        return false;
+    }
+
+    std::string fullpath = filetool::normalize_path(file);
+    TTF_Font* data = TTF_OpenFont(fullpath.c_str(), size);
+    if (data == nullptr) {
+        CUAssertLog(false, "Font initialization error: %s", TTF_GetError());
+        return false;
+    }
+    TTF_SetFontStyle(data, (int)style);
+    TTF_SetFontHinting(data, (int)hinting);
+
+    _shelfHeight = TTF_FontHeight(data)+GLYPH_BORDER;
+    _pageSize = nextPOT(_shelfHeight*GLYPH_PAGE_SHELVES);
+    _pageSize = std::min(std::max(_pageSize,GLYPH_PAGE_MIN),GLYPH_PAGE_MAX);
+
+    _rasterizer = std::make_shared<Rasterizer>();
+    _rasterizer->data = data;
+    _rasterizer->render = resolution;
+    _rasterizer->height = _shelfHeight;
+    return true;
+}
+
+#pragma mark -
+#pragma mark Attributes
+/**
+ * Sets the maximum number of texture pages.
+ *
+ * Once this many pages are allocated, new glyphs evict the least recently
+ * used glyphs of a page. Pages that are already allocated are kept, even
+ * if there are more than this number. The value must be at least 1.
+ *
+ * @param pages The maximum number of texture pages.
+ */
+void GlyphCache::setMaxPages(size_t pages) {
+    CUAssertLog(pages > 0, "A glyph cache must have at least one page");
+    _maxPages = pages;
+}
+
+#pragma mark -
+#pragma mark Glyph Access
+/**
+ * Returns the page containing all of the given glyphs.
+ *
+ * The glyphs are rasterized and uploaded if necessary. The page chosen
+ * is the one with the most glyphs already resident. If it does not have
+ * room, the glyphs are placed on a new page, or (if there are already
+ * the maximum number of pages) the least recently used glyphs of the
+ * page are evicted. Glyphs that are not supported by the font, or that
+ * cannot fit on a page, are skipped.
+ *
+ * This method returns -1 if there are no glyphs to place.
+ *
+ * @param glyphs    The (Unicode) glyphs to place
+ * @param size      The number of glyphs
+ *
+ * @return the page containing all of the given glyphs.
+ */
+int GlyphCache::acquire(const Uint32* glyphs, size_t size) {
+    if (_rasterizer == nullptr || size == 0) {
+        return -1;
+    }
+    _tick++;
+
+    // Take the glyphs rasterized in advance
+    {
+        std::lock_guard<std::mutex> lock(_rasterizer->lock);
+        for(auto it = _rasterizer->pending.begin(); it != _rasterizer->pending.end(); ++it) {
+            if (it->second == nullptr) {
+                _missing.insert(it->first);
+            } else if (!_ready.emplace(it->first,it->second).second) {
+                SDL_FreeSurface(it->second);
+            }
+        }
+        _rasterizer->pending.clear();
+    }
+
+    // Start with the page that already has the most glyphs
+    int page = -1;
+    size_t most = 0;
+    for(int pp = 0; pp < (int)_pages.size(); pp++) {
+        size_t count = 0;
+        for(size_t ii = 0; ii < size; ii++) {
+            count += _slots.count(key(pp,glyphs[ii]));
+        }
+        if (page == -1 || count >= most) {
+            page = pp;
+            most = count;
+        }
+    }
+    if (page == -1) {
+        page = addPage();
+    }
+
+    size_t ii = 0;
+    while (ii < size) {
+        Uint32 glyph = glyphs[ii];
+        auto it = _slots.find(key(page,glyph));
+        if (it != _slots.end()) {
+            it->second.used = _tick;
+            ii++;
+            continue;
+        } else if (_missing.find(glyph) != _missing.end()) {
+            ii++;
+            continue;
+        }
+
+        SDL_Surface* surface = obtain(glyph);
+        if (surface == nullptr || surface->w > _pageSize) {
+            _missing.insert(glyph);
+            ii++;
+        } else if (place(page, glyph, surface, _pages.size() >= _maxPages)) {
+            ii++;
+        } else if (_pages.size() < _maxPages) {
+            // Start over on a fresh page
+            page = addPage();
+            ii = 0;
+        } else {
+            CULogError("Glyph cache could not make room for glyph %u", glyph);
+            ii++;
+        }
+
+        if (surface != nullptr) {
+            SDL_FreeSurface(surface);
+        }
+    }
+    return page;
+}
+
+/**
+ * Returns true if the glyph is resident on the given page.
+ *
+ * If the glyph is resident, its bounds (in pixels, with the origin at
+ * the top left of the page) are stored in the rectangle.
+ *
+ * @param page      The page index
+ * @param glyph     The (Unicode) glyph
+ * @param bounds    The rectangle to store the glyph bounds
+ *
+ * @return true if the glyph is resident on the given page.
+ */
+bool GlyphCache::getBounds(int page, Uint32 glyph, Rect& bounds) const {
+    auto it = _slots.find(key(page,glyph));
+    if (it == _slots.end()) {
+        return false;
+    }
+    bounds = it->second.bounds;
+    return true;
+}
+
+/**
+ * Rasterizes the given glyphs in advance.
+ *
+ * If there is a thread pool, the glyphs are rasterized on a worker
+ * thread. Otherwise, they are rasterized immediately. Either way, they
+ * are not uploaded until they are requested by {@link #acquire}. Glyphs
+ * that are already resident are ignored.
+ *
+ * This method is thread safe. It may be called in any thread.
+ *
+ * @param glyphs    The (Unicode) glyphs to rasterize
+ * @param size      The number of glyphs
+ */
+void GlyphCache::prefetch(const Uint32* glyphs, size_t size) {
+    std::shared_ptr<Rasterizer> raster = _rasterizer;
+    if (raster == nullptr) {
+        return;
+    }
+
+    std::vector<Uint32> work;
+    {
+        std::lock_guard<std::mutex> lock(raster->lock);
+        for(size_t ii = 0; ii < size; ii++) {
+            Uint32 glyph = glyphs[ii];
+            if (raster->resident.find(glyph) == raster->resident.end() &&
+                raster->pending.find(glyph)  == raster->pending.end() &&
+                raster->queued.insert(glyph).second) {
+                work.push_back(glyph);
+            }
+        }
+    }
+
+    if (work.empty()) {
+        return;
+    } else if (_threads == nullptr) {
+        rasterize(raster.get(), work);
+    } else {
+        // The task keeps the rasterizer (but not the pages) alive
+        _threads->addTask([raster,work]() {
+            rasterize(raster.get(), work);
+        });
+    }
+}
+
+/**
+ * Deletes all texture pages and resident glyphs.
+ *
+ * This counts as an eviction of every resident glyph.
+ */
+void GlyphCache::clear() {
+    _evictions += _slots.size();
+    _slots.clear();
+    _pages.clear();
+    if (_rasterizer != nullptr) {
+        std::lock_guard<std::mutex> lock(_rasterizer->lock);
+        _rasterizer->resident.clear();
+    }
+}
+
+#pragma mark -
+#pragma mark Internal Helpers
+/**
+ * Returns a newly rasterized glyph surface.
+ *
+ * The surface is in RGBA format, and includes a transparent border
+ * around the glyph. This method returns nullptr if the glyph is not
+ * supported. It is safe to call from any thread.
+ *
+ * @param raster    The rasterization state
+ * @param glyph     The (Unicode) glyph
+ *
+ * @return a newly rasterized glyph surface.
+ */
+SDL_Surface* GlyphCache::rasterize(Rasterizer* raster, Uint32 glyph) {
+    if (glyph > USHRT_MAX) {
+        return nullptr;
+    }
+
+    SDL_Color color;
+    color.r = color.g = color.b = color.a = 255;
+
+    SDL_Surface* temp = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(raster->fontLock);
+        if (!TTF_GlyphIsProvided(raster->data, (Uint16)glyph)) {
+            return nullptr;
+        }
+        switch (raster->render) {
+            case Font::Resolution::SOLID:
+                temp = TTF_RenderGlyph_Solid(raster->data, (Uint16)glyph, color);
+                break;
+            case Font::Resolution::SHADED:
+            case Font::Resolution::BLENDED:
+                temp = TTF_RenderGlyph_Blended(raster->data, (Uint16)glyph, color);
+                break;
+        }
+    }
+
+    if (temp == nullptr) {
+        return nullptr;
+    }
+
+    // The cell is always a full shelf high, so clear pixels are uploaded too
+    SDL_Surface* result = alloc_surface(temp->w+GLYPH_BORDER, raster->height);
+    if (result != nullptr) {
+        SDL_Rect dstrect;
+        dstrect.x = dstrect.y = GLYPH_BORDER/2;
+        dstrect.w = temp->w;
+        dstrect.h = temp->h;
+        if (raster->render != Font::Resolution::SHADED) {
+            SDL_SetSurfaceBlendMode(temp, SDL_BLENDMODE_NONE);
+        }
+        SDL_BlitSurface(temp,NULL,result,&dstrect);
+    }
+    SDL_FreeSurface(temp);
+    return result;
+}
+
+/**
+ * Rasterizes the queued glyphs, storing them as pending.
+ *
+ * This is the task executed on the worker thread.
+ *
+ * @param raster    The rasterization state
+ * @param glyphs    The glyphs to rasterize
+ */
+void GlyphCache::rasterize(Rasterizer* raster, const std::vector<Uint32>& glyphs) {
+    for(auto it = glyphs.begin(); it != glyphs.end(); ++it) {
+        SDL_Surface* surface = rasterize(raster, *it);
+        std::lock_guard<std::mutex> lock(raster->lock);
+        raster->queued.erase(*it);
+        if (!raster->pending.emplace(*it,surface).second && surface != nullptr) {
+            SDL_FreeSurface(surface);
+        }
+    }
+}
+
+/**
+ * Returns the surface for the given glyph.
+ *
+ * This method uses the surface rasterized in advance if there is one.
+ * The caller takes ownership of the surface.
+ *
+ * @param glyph The (Unicode) glyph
+ *
+ * @return the surface for the given glyph.
+ */
+SDL_Surface* GlyphCache::obtain(Uint32 glyph) {
+    auto it = _ready.find(glyph);
+    if (it != _ready.end()) {
+        SDL_Surface* result = it->second;
+        _ready.erase(it);
+        return result;
+    }
+    return rasterize(_rasterizer.get(), glyph);
+}
+
+/**
+ * Returns the index of a newly allocated (empty) page.
+ *
+ * @return the index of a newly allocated (empty) page.
+ */
+int GlyphCache::addPage() {
+    Page page;
+    std::vector<Uint8> blank((size_t)_pageSize*_pageSize*4, 0);
+    page.texture = Texture::allocWithData(blank.data(), _pageSize, _pageSize);
+    CUAssertLog(page.texture != nullptr, "Could not allocate a glyph page");
+
+    Span span;
+    span.x = 0;
+    span.width = _pageSize;
+    page.shelves.resize(_pageSize/_shelfHeight, std::vector<Span>(1,span));
+    _pages.push_back(std::move(page));
+    return (int)_pages.size()-1;
+}
+
+/**
+ * Places the glyph surface on the given page.
+ *
+ * If the page does not have room, and reclaim is true, the least recently
+ * used glyphs of the page are evicted until it does. This method returns
+ * false if the glyph could not be placed.
+ *
+ * @param page      The page index
+ * @param glyph     The (Unicode) glyph
+ * @param surface   The glyph surface (including the border)
+ * @param reclaim   Whether to evict glyphs to make room
+ *
+ * @return true if the glyph was placed on the page.
+ */
+bool GlyphCache::place(int page, Uint32 glyph, SDL_Surface* surface, bool reclaim) {
+    CUAssertLog(surface->pitch == surface->w*4, "Glyph surface is not tightly packed");
+    Page& data = _pages[page];
+    int width = surface->w;
+    while (true) {
+        // First fit, top to bottom
+        for(size_t ss = 0; ss < data.shelves.size(); ss++) {
+            std::vector<Span>& spans = data.shelves[ss];
+            for(auto it = spans.begin(); it != spans.end(); ++it) {
+                if (it->width < width) {
+                    continue;
+                }
+
+                int x = it->x;
+                int y = (int)ss*_shelfHeight;
+                it->x += width;
+                it->width -= width;
+                if (it->width == 0) {
+                    spans.erase(it);
+                }
+                data.texture->update(surface->pixels, x, y, surface->w, surface->h);
+
+                Slot slot;
+                slot.bounds.set((float)(x+GLYPH_BORDER/2), (float)(y+GLYPH_BORDER/2),
+                                (float)(surface->w-GLYPH_BORDER), (float)(surface->h-GLYPH_BORDER));
+                slot.used = _tick;
+                _slots[key(page,glyph)] = slot;
+
+                std::lock_guard<std::mutex> lock(_rasterizer->lock);
+                _rasterizer->resident[glyph]++;
+                return true;
+            }
+        }
+
+        if (!reclaim || !evict(page)) {
+            return false;
+        }
+    }
+    return false;
+}
+
+/**
+ * Evicts the least recently used glyph of the given page.
+ *
+ * Glyphs used in the current request are never evicted. This method
+ * returns false if there is no glyph to evict.
+ *
+ * @param page  The page index
+ *
+ * @return true if a glyph was evicted.
+ */
+bool GlyphCache::evict(int page) {
+    auto victim = _slots.end();
+    for(auto it = _slots.begin(); it != _slots.end(); ++it) {
+        if ((int)(it->first >> 32) == page && it->second.used < _tick &&
+            (victim == _slots.end() || it->second.used < victim->second.used)) {
+            victim = it;
+        }
+    }
+    if (victim == _slots.end()) {
+        return false;
+    }
+
+    // Return the cell to its shelf, merging with its neighbors
+    const Rect& bounds = victim->second.bounds;
+    Span span;
+    span.x = (int)bounds.origin.x-GLYPH_BORDER/2;
+    span.width = (int)bounds.size.width+GLYPH_BORDER;
+    int shelf = ((int)bounds.origin.y-GLYPH_BORDER/2)/_shelfHeight;
+
+    std::vector<Span>& spans = _pages[page].shelves[shelf];
+    auto pos = std::lower_bound(spans.begin(), spans.end(), span.x,
+                                [](const Span& a, int x) { return a.x < x; });
+    pos = spans.insert(pos, span);
+    if (pos+1 != spans.end() && pos->x+pos->width == (pos+1)->x) {
+        pos->width += (pos+1)->width;
+        spans.erase(pos+1);
+    }
+    if (pos != spans.begin() && (pos-1)->x+(pos-1)->width == pos->x) {
+        (pos-1)->width += pos->width;
+        spans.erase(pos);
+    }
+
+    Uint32 glyph = (Uint32)(victim->first & 0xFFFFFFFF);
+    _slots.erase(victim);
+    _evictions++;
+
+    std::lock_guard<std::mutex> lock(_rasterizer->lock);
+    auto it = _rasterizer->resident.find(glyph);
+    if (it != _rasterizer->resident.end() && --(it->second) == 0) {
+        _rasterizer->resident.erase(it);
+    }
+    return true;
+}
@@ -472,7 +472,7 @@ Scissor Scissor::getIntersection(const Scissor& mask, bool loose) const {
     
     // Now intersect in this space.
     temp.intersect(_bounds);
-    return result.set(_bounds,_transform,_fringe);
+    return result.set(temp,_transform,_fringe);
 }
 
 /**
@@ -29,6 +29,8 @@
 //  Author: Walker White
 //  Version: 2/10/20
 
+#include <cstring>
+#include <algorithm>
 #include <cugl/util/CUDebug.h>
 #include <cugl/util/CUStrings.h>
 #include <cugl/render/CUShader.h>
@@ -137,6 +139,9 @@ void Shader::dispose() {
     _uniblocknames.clear();
     _uniblocksizes.clear();
     _uniblockfields.clear();
+    _uniforms.clear();
+    _uniformslots.clear();
+    _uniformlocales.clear();
 }
 
 /**
@@ -265,15 +270,39 @@ void Shader::cacheUniforms() {
     GLchar name[bufSize];       // variable name in GLSL
     GLsizei length;             // name length
     
+    // Uniform names may be longer than block names
+    GLint maxlen = 0;
+    glGetProgramiv(_program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxlen);
+    std::vector<GLchar> buffer(std::max(maxlen,(GLint)bufSize));
+    
     glGetProgramiv(_program, GL_ACTIVE_UNIFORMS, &count);
+    _uniforms.resize(count);
     for (GLuint ii = 0; ii < count; ii++) {
-        glGetActiveUniform(_program, ii, bufSize, &length, &size, &type, name);
+        Uniform& uniform = _uniforms[ii];
+        uniform.location = -1;
+        uniform.type = GL_FALSE;
+        uniform.cached = false;
+        
+        glGetActiveUniform(_program, ii, (GLsizei)buffer.size(), &length, &size, &type, buffer.data());
         GLenum error = glGetError();
         if (!error) {
-            std::string key(name);
+            std::string key(buffer.data());
             _uniformtypes[key] = type;
             _uniformsizes[key] = size;
             _uniformnames[ii]  = key;
+            
+            // Reflect the location once, so we never query it again
+            uniform.type = type;
+            uniform.location = glGetUniformLocation(_program, buffer.data());
+            _uniformslots[key] = ii;
+            if (uniform.location >= 0) {
+                _uniformlocales[uniform.location] = ii;
+            }
+            
+            // Arrays are reported by their first element
+            if (key.size() > 3 && key.compare(key.size()-3, 3, "[0]") == 0) {
+                _uniformslots[key.substr(0,key.size()-3)] = ii;
+            }
         }
     }
     
@@ -299,6 +328,79 @@ void Shader::cacheUniforms() {
     }
 }
 
+/**
+ * Returns the table index of the given uniform, checking its type.
+ *
+ * If name is not a valid uniform, or it does not have the given type,
+ * this method returns -1. The type GL_INT also matches booleans and
+ * samplers.
+ *
+ * @param name  The uniform variable name
+ * @param type  The expected uniform type
+ *
+ * @return the table index of the given uniform, checking its type.
+ */
+GLint Shader::getUniformSlot(const std::string& name, GLenum type) const {
+    auto search = _uniformslots.find(name);
+    if (search == _uniformslots.end() || _uniforms[search->second].location < 0) {
+        return -1;
+    }
+    
+    GLenum actual = _uniforms[search->second].type;
+    bool match = actual == type;
+    if (type == GL_INT) {
+        match = match || actual == GL_BOOL || actual == GL_SAMPLER_2D ||
+                actual == GL_SAMPLER_3D || actual == GL_SAMPLER_CUBE ||
+                actual == GL_SAMPLER_2D_ARRAY;
+    }
+    CUAssertLog(match, "Uniform '%s' does not have the requested type", name.c_str());
+    return match ? search->second : -1;
+}
+
+/**
+ * Returns true if the value differs from the shadow value of a uniform.
+ *
+ * If the value differs (or there is no shadow value), it becomes the new
+ * shadow value, and the caller should upload it. This method returns
+ * false if the slot is invalid.
+ *
+ * @param slot      The table index of the uniform
+ * @param program   The program that issued the handle
+ * @param value     The value to upload
+ * @param size      The size of the value in bytes
+ *
+ * @return true if the value differs from the shadow value of a uniform.
+ */
+bool Shader::updateShadow(GLint slot, GLuint program, const void* value, size_t size) {
+    if (slot < 0) {
+        return false;
+    }
+    CUAssertLog(program == _program && slot < (GLint)_uniforms.size(),
+                "Uniform handle belongs to another shader");
+    Uniform& uniform = _uniforms[slot];
+    if (uniform.cached && std::memcmp(uniform.shadow, value, size) == 0) {
+        return false;
+    }
+    std::memcpy(uniform.shadow, value, size);
+    uniform.cached = true;
+    return true;
+}
+
+/**
+ * Discards the shadow value of the uniform at the given location.
+ *
+ * This is called when a uniform is set without a handle, so that the
+ * next handle update is not skipped.
+ *
+ * @param pos   The location of the uniform in the shader
+ */
+void Shader::forgetUniform(GLint pos) {
+    auto search = _uniformlocales.find(pos);
+    if (search != _uniformlocales.end()) {
+        _uniforms[search->second].cached = false;
+    }
+}
+
 
 #pragma mark -
 #pragma mark Binding
@@ -476,6 +578,13 @@ std::vector<std::string> Shader::getUniforms() const {
  * @return the program offset of the given uniform
  */
 GLint Shader::getUniformLocation(const std::string name) const {
+    auto search = _uniformslots.find(name);
+    if (search != _uniformslots.end()) {
+        return _uniforms[search->second].location;
+    } else if (name.find('[') == std::string::npos) {
+        return -1;
+    }
+    // Only the first element of an array is in the table
     return glGetUniformLocation(_program,name.c_str());
 }
 
@@ -514,6 +623,153 @@ GLenum Shader::getUniformType(const std::string name) const {
 }
 
 
+#pragma mark -
+#pragma mark Uniform Handles
+/**
+ * Sets the uniform for the given handle to an int value.
+ *
+ * The value is compared to the last value set by a handle. If it has
+ * not changed, nothing is uploaded to the shader.
+ *
+ * This method will only succeed if the shader is actively bound.
+ *
+ * @param handle    The uniform handle
+ * @param value     The value for the uniform
+ */
+void Shader::setUniform(const UniformHandle<GLint>& handle, GLint value) {
+    CUAssertLog(isBound(), "Shader is not active.");
+    if (updateShadow(handle.slot, handle.program, &value, sizeof(GLint))) {
+        glUniform1i(handle.location, value);
+    }
+}
+
+/**
+ * Sets the uniform for the given handle to an unsigned int value.
+ *
+ * The value is compared to the last value set by a handle. If it has
+ * not changed, nothing is uploaded to the shader.
+ *
+ * This method will only succeed if the shader is actively bound.
+ *
+ * @param handle    The uniform handle
+ * @param value     The value for the uniform
+ */
+void Shader::setUniform(const UniformHandle<GLuint>& handle, GLuint value) {
+    CUAssertLog(isBound(), "Shader is not active.");
+    if (updateShadow(handle.slot, handle.program, &value, sizeof(GLuint))) {
+        glUniform1ui(handle.location, value);
+    }
+}
+
+/**
+ * Sets the uniform for the given handle to a float value.
+ *
+ * The value is compared to the last value set by a handle. If it has
+ * not changed, nothing is uploaded to the shader.
+ *
+ * This method will only succeed if the shader is actively bound.
+ *
+ * @param handle    The uniform handle
+ * @param value     The value for the uniform
+ */
+void Shader::setUniform(const UniformHandle<GLfloat>& handle, GLfloat value) {
+    CUAssertLog(isBound(), "Shader is not active.");
+    if (updateShadow(handle.slot, handle.program, &value, sizeof(GLfloat))) {
+        glUniform1f(handle.location, value);
+    }
+}
+
+/**
+ * Sets the uniform for the given handle to a vector value.
+ *
+ * The value is compared to the last value set by a handle. If it has
+ * not changed, nothing is uploaded to the shader.
+ *
+ * This method will only succeed if the shader is actively bound.
+ *
+ * @param handle    The uniform handle
+ * @param value     The value for the uniform
+ */
+void Shader::setUniform(const UniformHandle<Vec2>& handle, const Vec2& value) {
+    CUAssertLog(isBound(), "Shader is not active.");
+    if (updateShadow(handle.slot, handle.program, &value.x, 2*sizeof(GLfloat))) {
+        glUniform2f(handle.location, value.x, value.y);
+    }
+}
+
+/**
+ * Sets the uniform for the given handle to a vector value.
+ *
+ * The value is compared to the last value set by a handle. If it has
+ * not changed, nothing is uploaded to the shader.
+ *
+ * This method will only succeed if the shader is actively bound.
+ *
+ * @param handle    The uniform handle
+ * @param value     The value for the uniform
+ */
+void Shader::setUniform(const UniformHandle<Vec3>& handle, const Vec3& value) {
+    CUAssertLog(isBound(), "Shader is not active.");
+    if (updateShadow(handle.slot, handle.program, &value.x, 3*sizeof(GLfloat))) {
+        glUniform3f(handle.location, value.x, value.y, value.z);
+    }
+}
+
+/**
+ * Sets the uniform for the given handle to a vector value.
+ *
+ * The value is compared to the last value set by a handle. If it has
+ * not changed, nothing is uploaded to the shader.
+ *
+ * This method will only succeed if the shader is actively bound.
+ *
+ * @param handle    The uniform handle
+ * @param value     The value for the uniform
+ */
+void Shader::setUniform(const UniformHandle<Vec4>& handle, const Vec4& value) {
+    CUAssertLog(isBound(), "Shader is not active.");
+    if (updateShadow(handle.slot, handle.program, &value.x, 4*sizeof(GLfloat))) {
+        glUniform4f(handle.location, value.x, value.y, value.z, value.w);
+    }
+}
+
+/**
+ * Sets the uniform for the given handle to a color value.
+ *
+ * The value is compared to the last value set by a handle. If it has
+ * not changed, nothing is uploaded to the shader.
+ *
+ * This method will only succeed if the shader is actively bound.
+ *
+ * @param handle    The uniform handle
+ * @param value     The value for the uniform
+ */
+void Shader::setUniform(const UniformHandle<Color4f>& handle, const Color4f& value) {
+    CUAssertLog(isBound(), "Shader is not active.");
+    if (updateShadow(handle.slot, handle.program, &value.r, 4*sizeof(GLfloat))) {
+        glUniform4f(handle.location, value.r, value.g, value.b, value.a);
+    }
+}
+
+/**
+ * Sets the uniform for the given handle to a matrix value.
+ *
+ * The value is compared to the last value set by a handle. If it has
+ * not changed, nothing is uploaded to the shader.
+ *
+ * This method will only succeed if the shader is actively bound.
+ *
+ * @param handle    The uniform handle
+ * @param value     The value for the uniform
+ */
+void Shader::setUniform(const UniformHandle<Mat4>& handle, const Mat4& value) {
+    CUAssertLog(isBound(), "Shader is not active.");
+    if (updateShadow(handle.slot, handle.program, value.m, 16*sizeof(GLfloat))) {
+        glUniformMatrix4fv(handle.location, 1, false, value.m);
+    }
+}
+
+
 #pragma mark -
 #pragma mark Sampler Properties
 /**
@@ -549,11 +805,11 @@ std::vector<std::string> Shader::getSamplers() const {
  * @return the program offset of the given sampler variable
  */
 GLint Shader::getSamplerLocation(const std::string name) const {
-    GLint result =  glGetUniformLocation(_program,name.c_str());
-    if (result != -1 && _uniformtypes.at(name) != GL_SAMPLER_2D) {
-        result = -1;
+    auto search = _uniformslots.find(name);
+    if (search == _uniformslots.end() || _uniforms[search->second].type != GL_SAMPLER_2D) {
+        return -1;
     }
-    return result;
+    return _uniforms[search->second].location;
 }
 
 /**
@@ -911,6 +1167,7 @@ GLuint Shader::getUniformBlock(const std::string name) const {
 void Shader::setUniformVec2(GLint pos, const Vec2 vec) {
     CUAssertLog(isBound(), "Shader is not active.");
     glUniform2f(pos,vec.x,vec.y);
+    forgetUniform(pos);
 }
 
 /**
@@ -924,7 +1181,10 @@ void Shader::setUniformVec2(GLint pos, const Vec2 vec) {
 void Shader::setUniformVec2(const std::string name, const Vec2 vec) {
     CUAssertLog(isBound(), "Shader is not active.");
     GLint locale = getUniformLocation(name.c_str());
-    if (locale >= 0) glUniform2f(locale,vec.x,vec.y);
+    if (locale >= 0) {
+        glUniform2f(locale,vec.x,vec.y);
+        forgetUniform(locale);
+    }
 }
 
 /**
@@ -970,6 +1230,7 @@ bool Shader::getUniformVec2(const std::string name, Vec2& vec) const {
 void Shader::setUniformVec3(GLint pos, const Vec3 vec) {
     CUAssertLog(isBound(), "Shader is not active.");
     glUniform3f(pos,vec.x,vec.y,vec.z);
+    forgetUniform(pos);
 }
 
 /**
@@ -983,7 +1244,10 @@ void Shader::setUniformVec3(GLint pos, const Vec3 vec) {
 void Shader::setUniformVec3(const std::string name, const Vec3 vec) {
     CUAssertLog(isBound(), "Shader is not active.");
     GLint locale = getUniformLocation(name.c_str());
-    if (locale >= 0) glUniform3f(locale,vec.x,vec.y,vec.z);
+    if (locale >= 0) {
+        glUniform3f(locale,vec.x,vec.y,vec.z);
+        forgetUniform(locale);
+    }
 }
 
 /**
@@ -1029,6 +1293,7 @@ bool Shader::getUniformVec3(const std::string name, Vec3& vec) const {
 void Shader::setUniformVec4(GLint pos, const Vec4 vec) {
     CUAssertLog(isBound(), "Shader is not active.");
     glUniform4f(pos,vec.x,vec.y,vec.z,vec.w);
+    forgetUniform(pos);
 }
 
 /**
@@ -1042,7 +1307,10 @@ void Shader::setUniformVec4(GLint pos, const Vec4 vec) {
 void Shader::setUniformVec4(const std::string name, const Vec4 vec) {
     CUAssertLog(isBound(), "Shader is not active.");
     GLint locale = getUniformLocation(name.c_str());
-    if (locale >= 0) glUniform4f(locale,vec.x,vec.y,vec.z,vec.w);
+    if (locale >= 0) {
+        glUniform4f(locale,vec.x,vec.y,vec.z,vec.w);
+        forgetUniform(locale);
+    }
 }
 
 /**
@@ -1207,6 +1475,7 @@ bool Shader::getUniformColor4f(const std::string name, Color4f& color) const {
 void Shader::setUniformMat4(GLint pos, const Mat4& mat) {
     CUAssertLog(isBound(), "Shader is not active.");
     glUniformMatrix4fv(pos,1,false,mat.m);
+    forgetUniform(pos);
 }
 
 /**
@@ -1222,7 +1491,10 @@ void Shader::setUniformMat4(GLint pos, const Mat4& mat) {
 void Shader::setUniformMat4(const std::string name, const Mat4& mat) {
     CUAssertLog(isBound(), "Shader is not active.");
     GLint locale = getUniformLocation(name.c_str());
-    if (locale >= 0) glUniformMatrix4fv(locale,1,false,mat.m);
+    if (locale >= 0) {
+        glUniformMatrix4fv(locale,1,false,mat.m);
+        forgetUniform(locale);
+    }
 }
 
 /**
@@ -1271,6 +1543,7 @@ void Shader::setUniformAffine2(GLint pos, const Affine2& mat) {
     float data[9];
     mat.get3x3(data);
     glUniformMatrix3fv(pos,1,false,data);
+    forgetUniform(pos);
 }
 
 /**
@@ -1291,6 +1564,7 @@ void Shader::setUniformAffine2(const std::string name, const Affine2& mat) {
         float data[9];
         mat.get3x3(data);
         glUniformMatrix3fv(locale,1,false,data);
+        forgetUniform(locale);
     }
 }
 
@@ -1406,6 +1680,7 @@ bool Shader::getUniformQuaternion(const std::string name, Quaternion& quat) cons
 void Shader::setUniform1f(GLint pos, GLfloat v0) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniform1f(pos, v0);
+	forgetUniform(pos);
 }
 
 /**
@@ -1421,7 +1696,10 @@ void Shader::setUniform1f(GLint pos, GLfloat v0) {
 void Shader::setUniform1f(const std::string name, GLfloat v0) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform1f(locale, v0);
+	if (locale >= 0) {
+		glUniform1f(locale, v0);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -1436,6 +1714,7 @@ void Shader::setUniform1f(const std::string name, GLfloat v0) {
 void Shader::setUniform2f(GLint pos, GLfloat v0, GLfloat v1) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniform2f(pos, v0, v1);
+	forgetUniform(pos);
 }
 
 /**
@@ -1452,7 +1731,10 @@ void Shader::setUniform2f(GLint pos, GLfloat v0, GLfloat v1) {
 void Shader::setUniform2f(const std::string name, GLfloat v0, GLfloat v1) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform2f(locale, v0, v1);
+	if (locale >= 0) {
+		glUniform2f(locale, v0, v1);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -1468,6 +1750,7 @@ void Shader::setUniform2f(const std::string name, GLfloat v0, GLfloat v1) {
 void Shader::setUniform3f(GLint pos, GLfloat v0, GLfloat v1, GLfloat v2) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniform3f(pos, v0, v1, v2);
+	forgetUniform(pos);
 }
 
 /**
@@ -1485,7 +1768,10 @@ void Shader::setUniform3f(GLint pos, GLfloat v0, GLfloat v1, GLfloat v2) {
 void Shader::setUniform3f(const std::string name, GLfloat v0, GLfloat v1, GLfloat v2) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform3f(locale, v0, v1, v2);
+	if (locale >= 0) {
+		glUniform3f(locale, v0, v1, v2);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -1502,6 +1788,7 @@ void Shader::setUniform3f(const std::string name, GLfloat v0, GLfloat v1, GLfloa
 void Shader::setUniform4f(GLint pos, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniform4f(pos, v0, v1, v2, v3);
+	forgetUniform(pos);
 }
 
 /**
@@ -1520,7 +1807,10 @@ void Shader::setUniform4f(GLint pos, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat
 void Shader::setUniform4f(const std::string name, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform4f(locale, v0, v1, v2, v3);
+	if (locale >= 0) {
+		glUniform4f(locale, v0, v1, v2, v3);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -1534,6 +1824,7 @@ void Shader::setUniform4f(const std::string name, GLfloat v0, GLfloat v1, GLfloa
 void Shader::setUniform1i(GLint pos, GLint v0) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniform1i(pos, v0);
+	forgetUniform(pos);
 }
 
 /**
@@ -1549,7 +1840,10 @@ void Shader::setUniform1i(GLint pos, GLint v0) {
 void Shader::setUniform1i(const std::string name, GLint v0) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform1i(locale, v0);
+	if (locale >= 0) {
+		glUniform1i(locale, v0);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -1564,6 +1858,7 @@ void Shader::setUniform1i(const std::string name, GLint v0) {
 void Shader::setUniform2i(GLint pos, GLint v0, GLint v1) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniform2i(pos, v0, v1);
+	forgetUniform(pos);
 }
 
 /**
@@ -1580,7 +1875,10 @@ void Shader::setUniform2i(GLint pos, GLint v0, GLint v1) {
 void Shader::setUniform2i(const std::string name, GLint v0, GLint v1) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform2i(locale, v0, v1);
+	if (locale >= 0) {
+		glUniform2i(locale, v0, v1);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -1596,6 +1894,7 @@ void Shader::setUniform2i(const std::string name, GLint v0, GLint v1) {
 void Shader::setUniform3i(GLint pos, GLint v0, GLint v1, GLint v2) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniform3i(pos, v0, v1, v2);
+	forgetUniform(pos);
 }
 
 /**
@@ -1613,7 +1912,10 @@ void Shader::setUniform3i(GLint pos, GLint v0, GLint v1, GLint v2) {
 void Shader::setUniform3i(const std::string name, GLint v0, GLint v1, GLint v2) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform3i(locale, v0, v1, v2);
+	if (locale >= 0) {
+		glUniform3i(locale, v0, v1, v2);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -1630,6 +1932,7 @@ void Shader::setUniform3i(const std::string name, GLint v0, GLint v1, GLint v2)
 void Shader::setUniform4i(GLint pos, GLint v0, GLint v1, GLint v2, GLint v3) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniform4i(pos, v0, v1, v2, v3);
+	forgetUniform(pos);
 }
 
 /**
@@ -1648,7 +1951,10 @@ void Shader::setUniform4i(GLint pos, GLint v0, GLint v1, GLint v2, GLint v3) {
 void Shader::setUniform4i(const std::string name, GLint v0, GLint v1, GLint v2, GLint v3) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform4i(locale, v0, v1, v2, v3);
+	if (locale >= 0) {
+		glUniform4i(locale, v0, v1, v2, v3);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -1662,6 +1968,7 @@ void Shader::setUniform4i(const std::string name, GLint v0, GLint v1, GLint v2,
 void Shader::setUniform1ui(GLint pos, GLuint v0) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniform1ui(pos, v0);
+	forgetUniform(pos);
 }
 
 /**
@@ -1677,7 +1984,10 @@ void Shader::setUniform1ui(GLint pos, GLuint v0) {
 void Shader::setUniform1ui(const std::string name, GLuint v0) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform1ui(locale, v0);
+	if (locale >= 0) {
+		glUniform1ui(locale, v0);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -1692,6 +2002,7 @@ void Shader::setUniform1ui(const std::string name, GLuint v0) {
 void Shader::setUniform2ui(GLint pos, GLuint v0, GLuint v1) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniform2ui(pos, v0, v1);
+	forgetUniform(pos);
 }
 
 /**
@@ -1708,7 +2019,10 @@ void Shader::setUniform2ui(GLint pos, GLuint v0, GLuint v1) {
 void Shader::setUniform2ui(const std::string name, GLuint v0, GLuint v1) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform2ui(locale, v0, v1);
+	if (locale >= 0) {
+		glUniform2ui(locale, v0, v1);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -1724,6 +2038,7 @@ void Shader::setUniform2ui(const std::string name, GLuint v0, GLuint v1) {
 void Shader::setUniform3ui(GLint pos, GLuint v0, GLuint v1, GLuint v2) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniform3ui(pos, v0, v1, v2);
+	forgetUniform(pos);
 }
 
 /**
@@ -1741,7 +2056,10 @@ void Shader::setUniform3ui(GLint pos, GLuint v0, GLuint v1, GLuint v2) {
 void Shader::setUniform3ui(const std::string name, GLuint v0, GLuint v1, GLuint v2) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform3ui(locale, v0, v1, v2);
+	if (locale >= 0) {
+		glUniform3ui(locale, v0, v1, v2);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -1758,6 +2076,7 @@ void Shader::setUniform3ui(const std::string name, GLuint v0, GLuint v1, GLuint
 void Shader::setUniform4ui(GLint pos, GLuint v0, GLuint v1, GLuint v2, GLuint v3) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniform4ui(pos, v0, v1, v2, v3);
+	forgetUniform(pos);
 }
 
 /**
@@ -1776,7 +2095,10 @@ void Shader::setUniform4ui(GLint pos, GLuint v0, GLuint v1, GLuint v2, GLuint v3
 void Shader::setUniform4ui(const std::string name, GLuint v0, GLuint v1, GLuint v2, GLuint v3) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform4ui(locale, v0, v1, v2, v3);
+	if (locale >= 0) {
+		glUniform4ui(locale, v0, v1, v2, v3);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -1791,6 +2113,7 @@ void Shader::setUniform4ui(const std::string name, GLuint v0, GLuint v1, GLuint
 void Shader::setUniform1fv(GLint pos, GLsizei count, const GLfloat *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniform1fv(pos, count, value);
+	forgetUniform(pos);
 }
 
 /**
@@ -1807,7 +2130,10 @@ void Shader::setUniform1fv(GLint pos, GLsizei count, const GLfloat *value) {
 void Shader::setUniform1fv(const std::string name, GLsizei count, const GLfloat *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform1fv(locale, count, value);
+	if (locale >= 0) {
+		glUniform1fv(locale, count, value);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -1822,6 +2148,7 @@ void Shader::setUniform1fv(const std::string name, GLsizei count, const GLfloat
 void Shader::setUniform2fv(GLint pos, GLsizei count, const GLfloat *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniform2fv(pos, count, value);
+	forgetUniform(pos);
 }
 
 /**
@@ -1838,7 +2165,10 @@ void Shader::setUniform2fv(GLint pos, GLsizei count, const GLfloat *value) {
 void Shader::setUniform2fv(const std::string name, GLsizei count, const GLfloat *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform2fv(locale, count, value);
+	if (locale >= 0) {
+		glUniform2fv(locale, count, value);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -1853,6 +2183,7 @@ void Shader::setUniform2fv(const std::string name, GLsizei count, const GLfloat
 void Shader::setUniform3fv(GLint pos, GLsizei count, const GLfloat *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniform3fv(pos, count, value);
+	forgetUniform(pos);
 }
 
 /**
@@ -1869,7 +2200,10 @@ void Shader::setUniform3fv(GLint pos, GLsizei count, const GLfloat *value) {
 void Shader::setUniform3fv(const std::string name, GLsizei count, const GLfloat *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform3fv(locale, count, value);
+	if (locale >= 0) {
+		glUniform3fv(locale, count, value);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -1884,6 +2218,7 @@ void Shader::setUniform3fv(const std::string name, GLsizei count, const GLfloat
 void Shader::setUniform4fv(GLint pos, GLsizei count, const GLfloat *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniform4fv(pos, count, value);
+	forgetUniform(pos);
 }
 
 /**
@@ -1900,7 +2235,10 @@ void Shader::setUniform4fv(GLint pos, GLsizei count, const GLfloat *value) {
 void Shader::setUniform4fv(const std::string name, GLsizei count, const GLfloat *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform4fv(locale, count, value);
+	if (locale >= 0) {
+		glUniform4fv(locale, count, value);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -1915,6 +2253,7 @@ void Shader::setUniform4fv(const std::string name, GLsizei count, const GLfloat
 void Shader::setUniform1iv(GLint pos, GLsizei count, const GLint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniform1iv(pos, count, value);
+	forgetUniform(pos);
 }
 
 /**
@@ -1931,7 +2270,10 @@ void Shader::setUniform1iv(GLint pos, GLsizei count, const GLint *value) {
 void Shader::setUniform1iv(const std::string name, GLsizei count, const GLint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform1iv(locale, count, value);
+	if (locale >= 0) {
+		glUniform1iv(locale, count, value);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -1946,6 +2288,7 @@ void Shader::setUniform1iv(const std::string name, GLsizei count, const GLint *v
 void Shader::setUniform2iv(GLint pos, GLsizei count, const GLint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniform2iv(pos, count, value);
+	forgetUniform(pos);
 }
 
 /**
@@ -1962,7 +2305,10 @@ void Shader::setUniform2iv(GLint pos, GLsizei count, const GLint *value) {
 void Shader::setUniform2iv(const std::string name, GLsizei count, const GLint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform2iv(locale, count, value);
+	if (locale >= 0) {
+		glUniform2iv(locale, count, value);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -1977,6 +2323,7 @@ void Shader::setUniform2iv(const std::string name, GLsizei count, const GLint *v
 void Shader::setUniform3iv(GLint pos, GLsizei count, const GLint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniform3iv(pos, count, value);
+	forgetUniform(pos);
 }
 
 /**
@@ -1993,7 +2340,10 @@ void Shader::setUniform3iv(GLint pos, GLsizei count, const GLint *value) {
 void Shader::setUniform3iv(const std::string name, GLsizei count, const GLint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform3iv(locale, count, value);
+	if (locale >= 0) {
+		glUniform3iv(locale, count, value);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -2008,6 +2358,7 @@ void Shader::setUniform3iv(const std::string name, GLsizei count, const GLint *v
 void Shader::setUniform4iv(GLint pos, GLsizei count, const GLint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniform4iv(pos, count, value);
+	forgetUniform(pos);
 }
 
 /**
@@ -2024,7 +2375,10 @@ void Shader::setUniform4iv(GLint pos, GLsizei count, const GLint *value) {
 void Shader::setUniform4iv(const std::string name, GLsizei count, const GLint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform4iv(locale, count, value);
+	if (locale >= 0) {
+		glUniform4iv(locale, count, value);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -2039,6 +2393,7 @@ void Shader::setUniform4iv(const std::string name, GLsizei count, const GLint *v
 void Shader::setUniform1uiv(GLint pos, GLsizei count, const GLuint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniform1uiv(pos, count, value);
+	forgetUniform(pos);
 }
 
 /**
@@ -2055,7 +2410,10 @@ void Shader::setUniform1uiv(GLint pos, GLsizei count, const GLuint *value) {
 void Shader::setUniform1uiv(const std::string name, GLsizei count, const GLuint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform1uiv(locale, count, value);
+	if (locale >= 0) {
+		glUniform1uiv(locale, count, value);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -2070,6 +2428,7 @@ void Shader::setUniform1uiv(const std::string name, GLsizei count, const GLuint
 void Shader::setUniform2uiv(GLint pos, GLsizei count, const GLuint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniform2uiv(pos, count, value);
+	forgetUniform(pos);
 }
 
 /**
@@ -2086,7 +2445,10 @@ void Shader::setUniform2uiv(GLint pos, GLsizei count, const GLuint *value) {
 void Shader::setUniform2uiv(const std::string name, GLsizei count, const GLuint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform2uiv(locale, count, value);
+	if (locale >= 0) {
+		glUniform2uiv(locale, count, value);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -2101,6 +2463,7 @@ void Shader::setUniform2uiv(const std::string name, GLsizei count, const GLuint
 void Shader::setUniform3uiv(GLint pos, GLsizei count, const GLuint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniform3uiv(pos, count, value);
+	forgetUniform(pos);
 }
 
 /**
@@ -2117,7 +2480,10 @@ void Shader::setUniform3uiv(GLint pos, GLsizei count, const GLuint *value) {
 void Shader::setUniform3uiv(const std::string name, GLsizei count, const GLuint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform3uiv(locale, count, value);
+	if (locale >= 0) {
+		glUniform3uiv(locale, count, value);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -2132,6 +2498,7 @@ void Shader::setUniform3uiv(const std::string name, GLsizei count, const GLuint
 void Shader::setUniform4uiv(GLint pos, GLsizei count, const GLuint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniform4uiv(pos, count, value);
+	forgetUniform(pos);
 }
 
 /**
@@ -2148,7 +2515,10 @@ void Shader::setUniform4uiv(GLint pos, GLsizei count, const GLuint *value) {
 void Shader::setUniform4uiv(const std::string name, GLsizei count, const GLuint *value) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniform4uiv(locale, count, value);
+	if (locale >= 0) {
+		glUniform4uiv(locale, count, value);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -2164,6 +2534,7 @@ void Shader::setUniform4uiv(const std::string name, GLsizei count, const GLuint
 void Shader::setUniformMatrix2fv(GLint pos, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniformMatrix2fv(pos, count, tpose, value);
+	forgetUniform(pos);
 }
 
 /**
@@ -2181,7 +2552,10 @@ void Shader::setUniformMatrix2fv(GLint pos, GLsizei count, const GLfloat *value,
 void Shader::setUniformMatrix2fv(const std::string name, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniformMatrix2fv(locale, count, tpose, value);
+	if (locale >= 0) {
+		glUniformMatrix2fv(locale, count, tpose, value);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -2197,6 +2571,7 @@ void Shader::setUniformMatrix2fv(const std::string name, GLsizei count, const GL
 void Shader::setUniformMatrix3fv(GLint pos, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniformMatrix3fv(pos, count, tpose, value);
+	forgetUniform(pos);
 }
 
 /**
@@ -2214,7 +2589,10 @@ void Shader::setUniformMatrix3fv(GLint pos, GLsizei count, const GLfloat *value,
 void Shader::setUniformMatrix3fv(const std::string name, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniformMatrix3fv(locale, count, tpose, value);
+	if (locale >= 0) {
+		glUniformMatrix3fv(locale, count, tpose, value);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -2230,6 +2608,7 @@ void Shader::setUniformMatrix3fv(const std::string name, GLsizei count, const GL
 void Shader::setUniformMatrix4fv(GLint pos, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniformMatrix4fv(pos, count, tpose, value);
+	forgetUniform(pos);
 }
 
 /**
@@ -2247,7 +2626,10 @@ void Shader::setUniformMatrix4fv(GLint pos, GLsizei count, const GLfloat *value,
 void Shader::setUniformMatrix4fv(const std::string name, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniformMatrix4fv(locale, count, tpose, value);
+	if (locale >= 0) {
+		glUniformMatrix4fv(locale, count, tpose, value);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -2263,6 +2645,7 @@ void Shader::setUniformMatrix4fv(const std::string name, GLsizei count, const GL
 void Shader::setUniformMatrix2x3fv(GLint pos, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniformMatrix2x3fv(pos, count, tpose, value);
+	forgetUniform(pos);
 }
 
 /**
@@ -2280,7 +2663,10 @@ void Shader::setUniformMatrix2x3fv(GLint pos, GLsizei count, const GLfloat *valu
 void Shader::setUniformMatrix2x3fv(const std::string name, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniformMatrix2x3fv(locale, count, tpose, value);
+	if (locale >= 0) {
+		glUniformMatrix2x3fv(locale, count, tpose, value);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -2296,6 +2682,7 @@ void Shader::setUniformMatrix2x3fv(const std::string name, GLsizei count, const
 void Shader::setUniformMatrix3x2fv(GLint pos, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniformMatrix3x2fv(pos, count, tpose, value);
+	forgetUniform(pos);
 }
 
 /**
@@ -2313,7 +2700,10 @@ void Shader::setUniformMatrix3x2fv(GLint pos, GLsizei count, const GLfloat *valu
 void Shader::setUniformMatrix3x2fv(const std::string name, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniformMatrix3x2fv(locale, count, tpose, value);
+	if (locale >= 0) {
+		glUniformMatrix3x2fv(locale, count, tpose, value);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -2329,6 +2719,7 @@ void Shader::setUniformMatrix3x2fv(const std::string name, GLsizei count, const
 void Shader::setUniformMatrix2x4fv(GLint pos, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniformMatrix2x4fv(pos, count, tpose, value);
+	forgetUniform(pos);
 }
 
 /**
@@ -2346,7 +2737,10 @@ void Shader::setUniformMatrix2x4fv(GLint pos, GLsizei count, const GLfloat *valu
 void Shader::setUniformMatrix2x4fv(const std::string name, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniformMatrix2x4fv(locale, count, tpose, value);
+	if (locale >= 0) {
+		glUniformMatrix2x4fv(locale, count, tpose, value);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -2362,6 +2756,7 @@ void Shader::setUniformMatrix2x4fv(const std::string name, GLsizei count, const
 void Shader::setUniformMatrix4x2fv(GLint pos, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniformMatrix4x2fv(pos, count, tpose, value);
+	forgetUniform(pos);
 }
 
 /**
@@ -2379,7 +2774,10 @@ void Shader::setUniformMatrix4x2fv(GLint pos, GLsizei count, const GLfloat *valu
 void Shader::setUniformMatrix4x2fv(const std::string name, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniformMatrix4x2fv(locale, count, tpose, value);
+	if (locale >= 0) {
+		glUniformMatrix4x2fv(locale, count, tpose, value);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -2395,6 +2793,7 @@ void Shader::setUniformMatrix4x2fv(const std::string name, GLsizei count, const
 void Shader::setUniformMatrix3x4fv(GLint pos, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniformMatrix3x4fv(pos, count, tpose, value);
+	forgetUniform(pos);
 }
 
 /**
@@ -2412,7 +2811,10 @@ void Shader::setUniformMatrix3x4fv(GLint pos, GLsizei count, const GLfloat *valu
 void Shader::setUniformMatrix3x4fv(const std::string name, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-	if (locale >= 0) glUniformMatrix3x4fv(locale, count, tpose, value);
+	if (locale >= 0) {
+		glUniformMatrix3x4fv(locale, count, tpose, value);
+		forgetUniform(locale);
+	}
 }
 
 /**
@@ -2428,6 +2830,7 @@ void Shader::setUniformMatrix3x4fv(const std::string name, GLsizei count, const
 void Shader::setUniformMatrix4x3fv(GLint pos, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	glUniformMatrix4x3fv(pos, count, tpose, value);
+	forgetUniform(pos);
 }
 
 /**
@@ -2445,7 +2848,10 @@ void Shader::setUniformMatrix4x3fv(GLint pos, GLsizei count, const GLfloat *valu
 void Shader::setUniformMatrix4x3fv(const std::string name, GLsizei count, const GLfloat *value, GLboolean tpose) {
 	CUAssertLog(isBound(), "Shader is not active.");
 	GLint locale = getUniformLocation(name.c_str());
-    if (locale >= 0) glUniformMatrix4x3fv(locale, count, tpose, value);
+    if (locale >= 0) {
+        glUniformMatrix4x3fv(locale, count, tpose, value);
+        forgetUniform(locale);
+    }
 }
 
 /**
@@ -44,12 +44,17 @@
 //  Version: 2/10/20
 #include <cugl/math/cu_math.h>
 #include <cugl/util/CUDebug.h>
+#include <cugl/util/CUProfiler.h>
 #include <cugl/render/CUSpriteBatch.h>
 #include <cugl/render/CUVertexBuffer.h>
 #include <cugl/render/CUTexture.h>
 #include <cugl/render/CUShader.h>
 #include <cugl/render/CUGradient.h>
 #include <cugl/render/CUScissor.h>
+#include <cugl/render/CUSpriteMesh.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
 /**
  * Default fragment shader
@@ -77,6 +82,8 @@ const std::string oglShaderVert =
 
 using namespace cugl;
 
+/** The number of floats between vertex positions in the vertex buffer */
+#define VERTEX_STRIDE (sizeof(SpriteVertex3)/sizeof(float))
 
 #pragma mark Context
 
@@ -88,6 +95,8 @@ using namespace cugl;
 #define TYPE_SCISSOR    4
 /** The drawing type for a (simple) texture blur */
 #define TYPE_GAUSSBLUR  8
+/** The drawing type for a signed distance field texture */
+#define TYPE_DISTANCE   16
 
 /** The drawing command has changed */
 #define DIRTY_COMMAND       1
@@ -107,8 +116,28 @@ using namespace cugl;
 #define DIRTY_UNIBLOCK      128
 /** The blur step has changed */
 #define DIRTY_BLURSTEP      256
+/** The distance field effects have changed */
+#define DIRTY_DISTANCE      512
+/** The glScissor clipping box has changed */
+#define DIRTY_CLIPRECT      1024
 /** All values have changed */
-#define DIRTY_ALL_VALS      511
+#define DIRTY_ALL_VALS      2047
+
+/** The initial capacity of the scissor stack */
+#define SCISSOR_DEPTH       16
+
+/**
+ * Returns true if the two scissor masks are the same
+ *
+ * @param a     The first scissor mask
+ * @param b     The second scissor mask
+ *
+ * @return true if the two scissor masks are the same
+ */
+static bool same_scissor(const Scissor& a, const Scissor& b) {
+    return (a.getBounds() == b.getBounds() && a.getFringe() == b.getFringe() &&
+            a.getTransform() == b.getTransform());
+}
 
 /**
  * Creates a context of the default uniforms.
@@ -120,11 +149,19 @@ SpriteBatch::Context::Context() {
     blendEquation = GL_FUNC_ADD;
     srcFactor = GL_SRC_ALPHA;
     dstFactor = GL_ONE_MINUS_SRC_ALPHA;
+    alphaSeparate = false;
+    srcAlpha  = GL_ONE;
+    dstAlpha  = GL_ONE_MINUS_SRC_ALPHA;
     depthFunc = GL_ALWAYS;
     perspective = std::make_shared<Mat4>();
     perspective->setIdentity();
     texture  = nullptr;
     blurstep = 0;
+    outlineWidth = 0;
+    outlineColor = Color4f::CLEAR;
+    shadowColor  = Color4f::CLEAR;
+    clipped  = false;
+    clipRect = Rect::ZERO;
     blockptr = -1;
     type = 0;
 }
@@ -141,12 +178,21 @@ SpriteBatch::Context::Context(Context* copy) {
     command = copy->command;
     srcFactor = copy->srcFactor;
     dstFactor = copy->dstFactor;
+    alphaSeparate = copy->alphaSeparate;
+    srcAlpha  = copy->srcAlpha;
+    dstAlpha  = copy->dstAlpha;
     depthFunc = copy->depthFunc;
     blendEquation = copy->blendEquation;
     perspective = copy->perspective;
     texture  = copy->texture;
     blockptr = copy->blockptr;
     blurstep = copy->blurstep;
+    outlineWidth = copy->outlineWidth;
+    outlineColor = copy->outlineColor;
+    shadowOffset = copy->shadowOffset;
+    shadowColor  = copy->shadowColor;
+    clipped  = copy->clipped;
+    clipRect = copy->clipRect;
     dirty = 0;
 }
 
@@ -160,6 +206,9 @@ SpriteBatch::Context::~Context() {
     blendEquation = GL_FALSE;
     srcFactor = GL_FALSE;
     dstFactor = GL_FALSE;
+    alphaSeparate = false;
+    srcAlpha  = GL_FALSE;
+    dstAlpha  = GL_FALSE;
     depthFunc = GL_ALWAYS;
     perspective = nullptr;
     texture  = nullptr;
@@ -187,13 +236,20 @@ _vertMax(0),
 _vertSize(0),
 _indxMax(0),
 _indxSize(0),
+_instData(nullptr),
+_instMax(0),
+_instSize(0),
+_scissorTop(0),
 _vertTotal(0),
 _callTotal(0) {
     _shader = nullptr;
     _vertbuff = nullptr;
+    _instbuff = nullptr;
     _unifbuff = nullptr;
     _gradient = nullptr;
-    _scissor  = nullptr;
+    _scissorStack.resize(1);
+    _scissorStack[0].active = false;
+    std::memset(_viewport,0,sizeof(_viewport));
 }
 
 /**
@@ -208,19 +264,27 @@ void SpriteBatch::dispose() {
     if (_indxData) {
         delete[] _indxData; _indxData = nullptr;
     }
+    if (_instData) {
+        delete[] _instData; _instData = nullptr;
+    }
     if (_context != nullptr) {
         delete _context; _context = nullptr;
     }
     _shader = nullptr;
     _vertbuff = nullptr;
+    _instbuff = nullptr;
     _unifbuff = nullptr;
     _gradient = nullptr;
-    _scissor  = nullptr;
+    _scissorStack.resize(1);
+    _scissorStack[0].active = false;
+    _scissorTop = 0;
     
     _vertMax  = 0;
     _vertSize = 0;
     _indxMax  = 0;
     _indxSize = 0;
+    _instMax  = 0;
+    _instSize = 0;
     _depth = 0;
     _color = Color4f::WHITE;
     
@@ -319,6 +383,22 @@ bool SpriteBatch::init(unsigned int capacity, const std::shared_ptr<Shader>& sha
                             offsetof(cugl::SpriteVertex3,color));
     _vertbuff->setupAttribute("aTexCoord", 2, GL_FLOAT, GL_FALSE,
                             offsetof(cugl::SpriteVertex3,texcoord));
+    
+    // Instanced sprites are unit quads with only per-instance attributes
+    GLuint quad[6] = { 0, 1, 2, 2, 3, 0 };
+    _instbuff = VertexBuffer::alloc(sizeof(SpriteInstance));
+    _instbuff->setupAttribute("aTransform0", 3, GL_FLOAT, GL_FALSE,
+                              offsetof(cugl::SpriteInstance,transform0), 1);
+    _instbuff->setupAttribute("aTransform1", 3, GL_FLOAT, GL_FALSE,
+                              offsetof(cugl::SpriteInstance,transform1), 1);
+    _instbuff->setupAttribute("aTexRect",    4, GL_FLOAT, GL_FALSE,
+                              offsetof(cugl::SpriteInstance,texrect), 1);
+    _instbuff->setupAttribute("aColor",      4, GL_FLOAT, GL_TRUE,
+                              offsetof(cugl::SpriteInstance,color), 1);
+    _instbuff->setupAttribute("aFrame",      2, GL_FLOAT, GL_FALSE,
+                              offsetof(cugl::SpriteInstance,frame), 1);
+    _instbuff->attach(_shader);
+    _instbuff->loadIndexData(quad, 6, GL_STATIC_DRAW);
     _vertbuff->attach(_shader);
     
     // Set up data arrays;
@@ -326,6 +406,9 @@ bool SpriteBatch::init(unsigned int capacity, const std::shared_ptr<Shader>& sha
     _vertData = new SpriteVertex3[_vertMax];
     _indxMax = capacity*3;
     _indxData = new GLuint[_indxMax];
+    _instMax = capacity;
+    _instData = new SpriteInstance[_instMax];
+    _scissorStack.resize(SCISSOR_DEPTH);
     
     // Create uniform buffer (this has its own backing array)
     _unifbuff = UniformBuffer::alloc(40*sizeof(float),capacity/16);
@@ -342,6 +425,7 @@ bool SpriteBatch::init(unsigned int capacity, const std::shared_ptr<Shader>& sha
     _unifbuff->setOffset("gdFeathr", 156);
 
     _shader->setUniformBlock("uContext",_unifbuff);
+    lookupUniforms();
     
     _context = new Context();
     _context->dirty = DIRTY_ALL_VALS;
@@ -382,9 +466,12 @@ void SpriteBatch::setShader(const std::shared_ptr<Shader>& shader) {
     CUAssertLog(_active, "Attempt to reassign shader while drawing is active");
     CUAssertLog(shader != nullptr, "Shader cannot be null");
     _vertbuff->detach();
+    _instbuff->detach();
     _shader = shader;
+    _instbuff->attach(_shader);
     _vertbuff->attach(_shader);
     _shader->setUniformBlock("uContext", _unifbuff);
+    lookupUniforms();
 }
 
 
@@ -403,6 +490,10 @@ void SpriteBatch::setPerspective(const Mat4& perspective) {
         auto matrix = std::make_shared<Mat4>(perspective);
         _context->perspective = matrix;
         _context->dirty = _context->dirty | DIRTY_PERSPECTIVE;
+        if (_scissorStack[_scissorTop].active) {
+            // The perspective decides whether glScissor is possible
+            updateScissor();
+        }
     }
 }
 
@@ -535,8 +626,9 @@ void SpriteBatch::setGradient(const std::shared_ptr<Gradient>& gradient) {
  * @return The active scissor mask for this sprite batch
  */
 std::shared_ptr<Scissor> SpriteBatch::getScissor() const {
-    if (_scissor != nullptr) {
-        return Scissor::alloc(_scissor);
+    const ScissorState& top = _scissorStack[_scissorTop];
+    if (top.active) {
+        return std::make_shared<Scissor>(top.mask);
     }
     return nullptr;
 }
@@ -551,26 +643,120 @@ std::shared_ptr<Scissor> SpriteBatch::getScissor() const {
  * If this value is nullptr, then no scissor mask is active. This value
  * is nullptr by default.
  *
+ * This method replaces the top of the scissor stack. It does not
+ * intersect the scissor with the rest of the stack, and it does not
+ * change the stack depth. Setting a scissor equal to the active one
+ * does nothing.
+ *
  * This method acquires a copy of the scissor. Changes to the original
  * scissor mask after calling this method have no effect.
  *
  * @param scissor   The active scissor mask for this sprite batch
  */
 void SpriteBatch::setScissor(const std::shared_ptr<Scissor>& scissor) {
-    if (scissor == _scissor) {
-        return;
-    }
-    
-    if (_inflight) { record(); }
+    ScissorState& top = _scissorStack[_scissorTop];
     if (scissor == nullptr) {
-        // Active gradient is not null
-        _context->dirty = _context->dirty | DIRTY_UNIBLOCK | DIRTY_DRAWTYPE;
-        _context->type = _context->type & ~TYPE_SCISSOR;
-        _scissor = nullptr;
+        if (!top.active) {
+            return;
+        }
+        top.active = false;
     } else {
-        _context->dirty = _context->dirty | DIRTY_UNIBLOCK | DIRTY_DRAWTYPE;
-        _context->type = _context->type | TYPE_SCISSOR;
-        _scissor = Scissor::alloc(scissor);
+        if (top.active && same_scissor(top.mask,*scissor)) {
+            return;
+        }
+        top.mask = *scissor;
+        top.active = true;
+    }
+    updateScissor();
+}
+
+/**
+ * Pushes the given scissor mask onto the scissor stack.
+ *
+ * The new active mask is the intersection of the given mask with the
+ * current active mask (if any). The intersection takes place in the
+ * coordinate system of the current mask, and so it is exact unless
+ * the masks are rotated differently. This is the same as the method
+ * {@link Scissor#intersect} with loose set to false.
+ *
+ * The stack stores its masks by value and reuses its storage, so this
+ * method does not allocate memory (once the stack has reached its
+ * maximum depth). If the new mask is the same as the current one, the
+ * drawing context does not change.
+ *
+ * Every push must be balanced by a call to {@link #popScissor}.
+ *
+ * @param mask  The scissor mask to push
+ */
+void SpriteBatch::pushScissor(const Scissor& mask) {
+    if (_scissorTop+1 == _scissorStack.size()) {
+        _scissorStack.resize(2*_scissorStack.size());
+    }
+    const ScissorState& prev = _scissorStack[_scissorTop];
+    ScissorState& next = _scissorStack[++_scissorTop];
+    if (prev.active) {
+        next.mask = prev.mask;
+        next.mask.intersect(mask,false);
+    } else {
+        next.mask = mask;
+    }
+    next.active = true;
+    if (!prev.active || !same_scissor(prev.mask,next.mask)) {
+        updateScissor();
+    }
+}
+
+/**
+ * Pushes the given scissor mask onto the scissor stack.
+ *
+ * This method is the same as {@link #pushScissor(const Scissor&)},
+ * except that the given transform replaces the transform of the mask.
+ * This is useful for scene graph nodes, which define their masks in
+ * node space.
+ *
+ * Every push must be balanced by a call to {@link #popScissor}.
+ *
+ * @param mask      The scissor mask to push
+ * @param transform The transform of the pushed mask
+ */
+void SpriteBatch::pushScissor(const Scissor& mask, const Mat4& transform) {
+    Scissor local(mask);
+    local.setTransform(transform);
+    pushScissor(local);
+}
+
+/**
+ * Pushes a copy of the active scissor mask onto the scissor stack.
+ *
+ * This does not change the active mask. It saves the mask, so that it
+ * can be modified with {@link #setScissor} and then restored with
+ * {@link #popScissor}.
+ */
+void SpriteBatch::pushScissor() {
+    if (_scissorTop+1 == _scissorStack.size()) {
+        _scissorStack.resize(2*_scissorStack.size());
+    }
+    const ScissorState& prev = _scissorStack[_scissorTop];
+    ScissorState& next = _scissorStack[++_scissorTop];
+    next.active = prev.active;
+    if (prev.active) {
+        next.mask = prev.mask;
+    }
+}
+
+/**
+ * Pops the top of the scissor stack, restoring the previous mask.
+ *
+ * This method does nothing if the stack only has its base entry.
+ */
+void SpriteBatch::popScissor() {
+    if (_scissorTop == 0) {
+        return;
+    }
+    const ScissorState& prev = _scissorStack[_scissorTop--];
+    const ScissorState& next = _scissorStack[_scissorTop];
+    if (prev.active != next.active || (next.active && !same_scissor(prev.mask,next.mask))) {
+        updateScissor();
     }
 }
 
@@ -600,6 +786,47 @@ void SpriteBatch::setBlendFunc(GLenum srcFactor, GLenum dstFactor) {
     }
 }
 
+/**
+ * Sets a separate blending function for the alpha channel
+ *
+ * By default, the alpha channel is blended with the same factors as the
+ * color channels (see {@link #setBlendFunc}). That is correct when drawing
+ * to the screen, but not when drawing to an offscreen texture. The color
+ * channels are multiplied by the source alpha, but so is the alpha itself.
+ * Hence translucent pixels store the square of their alpha.
+ *
+ * Once this method is called, the alpha channel uses these factors no
+ * matter what the color factors are (see glBlendFuncSeparate). The
+ * factors GL_ONE and GL_ONE_MINUS_SRC_ALPHA store the correct coverage,
+ * and so produce a premultiplied texture. Call {@link #clearBlendAlphaFunc}
+ * to blend the alpha channel with the color factors again.
+ *
+ * @param srcFactor Specifies how the source alpha factor is computed
+ * @param dstFactor Specifies how the destination alpha factor is computed.
+ */
+void SpriteBatch::setBlendAlphaFunc(GLenum srcFactor, GLenum dstFactor) {
+    if (!_context->alphaSeparate || _context->srcAlpha != srcFactor || _context->dstAlpha != dstFactor) {
+        if (_inflight) { record(); }
+        _context->alphaSeparate = true;
+        _context->srcAlpha = srcFactor;
+        _context->dstAlpha = dstFactor;
+        _context->dirty = _context->dirty | DIRTY_BLENDFACTOR;
+    }
+}
+
+/**
+ * Blends the alpha channel with the same factors as the color channels
+ *
+ * This method undoes {@link #setBlendAlphaFunc}, and is the default.
+ */
+void SpriteBatch::clearBlendAlphaFunc() {
+    if (_context->alphaSeparate) {
+        if (_inflight) { record(); }
+        _context->alphaSeparate = false;
+        _context->dirty = _context->dirty | DIRTY_BLENDFACTOR;
+    }
+}
+
 /**
  * Sets the blending equation for this sprite batch
  *
@@ -700,6 +927,101 @@ void SpriteBatch::setBlurStep(GLuint step) {
     _context->blurstep = step;
 }
 
+/**
+ * Sets whether the active texture is a signed distance field.
+ *
+ * A distance field texture stores the distance to the nearest edge in
+ * its alpha channel, with the edge at 0.5. This is typically a font
+ * atlas created with {@link Font#setDistanceSpread}. Such a texture
+ * is filled with the current color (or gradient), and antialiased at
+ * the edges. This allows text to be scaled up without blurring. It
+ * also supports outline and shadow effects.
+ *
+ * A distance field replaces any blur effect. This value is false by
+ * default.
+ *
+ * @param field Whether the active texture is a signed distance field
+ */
+void SpriteBatch::setDistanceField(bool field) {
+    if (isDistanceField() == field) {
+        return;
+    }
+    
+    if (_inflight) { record(); }
+    if (field) {
+        _context->type = _context->type | TYPE_DISTANCE;
+    } else {
+        _context->type = _context->type & ~TYPE_DISTANCE;
+    }
+    _context->dirty = _context->dirty | DIRTY_DISTANCE | DIRTY_DRAWTYPE;
+}
+
+/**
+ * Returns true if the active texture is a signed distance field.
+ *
+ * A distance field texture stores the distance to the nearest edge in
+ * its alpha channel, with the edge at 0.5. This is typically a font
+ * atlas created with {@link Font#setDistanceSpread}. Such a texture
+ * is filled with the current color (or gradient), and antialiased at
+ * the edges. This allows text to be scaled up without blurring. It
+ * also supports outline and shadow effects.
+ *
+ * A distance field replaces any blur effect. This value is false by
+ * default.
+ *
+ * @return true if the active texture is a signed distance field.
+ */
+bool SpriteBatch::isDistanceField() const {
+    return (_context->type & TYPE_DISTANCE) != 0;
+}
+
+/**
+ * Sets the outline for distance field textures.
+ *
+ * The width is measured in distance units, where 0.5 is the full spread
+ * of the distance field. Hence the outline can be no wider than the
+ * spread. A width of 0 disables the outline, which is the default.
+ *
+ * This value has no effect unless {@link #isDistanceField} is true.
+ *
+ * @param width The outline width in distance units
+ * @param color The outline color
+ */
+void SpriteBatch::setOutline(float width, const Color4f color) {
+    if (_context->outlineWidth == width && _context->outlineColor == color) {
+        return;
+    }
+    
+    if (_inflight) { record(); }
+    _context->outlineWidth = width;
+    _context->outlineColor = color;
+    _context->dirty = _context->dirty | DIRTY_DISTANCE;
+}
+
+/**
+ * Sets the drop shadow for distance field textures.
+ *
+ * The offset is measured in texels of the active texture, with the
+ * y-axis pointing up. So the shadow scales with the text. The shadow
+ * has the same outline as the text. A clear color disables the shadow,
+ * which is the default.
+ *
+ * This value has no effect unless {@link #isDistanceField} is true.
+ *
+ * @param offset    The shadow offset in texels
+ * @param color     The shadow color
+ */
+void SpriteBatch::setShadow(const Vec2 offset, const Color4f color) {
+    if (_context->shadowOffset == offset && _context->shadowColor == color) {
+        return;
+    }
+    
+    if (_inflight) { record(); }
+    _context->shadowOffset = offset;
+    _context->shadowColor  = color;
+    _context->dirty = _context->dirty | DIRTY_DISTANCE;
+}
+
 
 #pragma mark -
 #pragma mark Rendering
@@ -721,6 +1043,11 @@ void SpriteBatch::begin() {
     _vertbuff->bind();
     _unifbuff->bind(false);
     _unifbuff->deactivate();
+    _shader->setUniform(_uniformModel, Mat4::IDENTITY);
+    _shader->setUniform(_uniformTint, Color4f::WHITE);
+    _shader->setUniform(_uniformInstanced, 0);
+    _context->dirty = _context->dirty | DIRTY_CLIPRECT;
+    glGetIntegerv(GL_VIEWPORT, _viewport);
     _active = true;
     _callTotal = 0;
     _vertTotal = 0;
@@ -748,11 +1075,16 @@ void SpriteBatch::end() {
  * previuosly drawn shapes.
  */
 void SpriteBatch::flush() {
-    if (_indxSize == 0 || _vertSize == 0) {
+    if (_instSize > 0) {
+        flushInstances();
+        return;
+    } else if (_indxSize == 0 || _vertSize == 0) {
         return;
     } else if (_context->first != _indxSize) {
         record();
     }
+    CUProfileZone("flush");
+    CUProfileGPUZone("flush");
     
     // Load all the vertex data at once
     _vertbuff->loadVertexData(_vertData, _vertSize);
@@ -761,50 +1093,20 @@ void SpriteBatch::flush() {
     _unifbuff->flush();
     
     // Chunk the uniforms
-    std::shared_ptr<Texture> previous = _context->texture;
     for(auto it = _history.begin(); it != _history.end(); ++it) {
         Context* next = *it;
-        if (next->dirty & DIRTY_EQUATION) {
-            glBlendEquation(next->blendEquation);
-        }
-        if (next->dirty & DIRTY_BLENDFACTOR) {
-            glBlendFunc(next->srcFactor, next->dstFactor);
-        }
-        if (next->dirty & DIRTY_BLENDFACTOR) {
-            glBlendFunc(next->srcFactor, next->dstFactor);
-        }
-        if (next->dirty & DIRTY_DEPTHTEST) {
-            if (next->depthFunc == GL_ALWAYS) {
-                glDisable(GL_DEPTH_TEST);
-            } else {
-                glEnable(GL_DEPTH_TEST);
-                glDepthFunc(next->depthFunc);
-            }
-        }
-        if (next->dirty & DIRTY_DRAWTYPE) {
-             _shader->setUniform1i("uType", next->type);
-        }
-        if (next->dirty & DIRTY_PERSPECTIVE) {
-            _shader->setUniformMat4("uPerspective",*(next->perspective.get()));
-        }
-        if (next->dirty & DIRTY_TEXTURE) {
-            previous = next->texture;
-            if (previous != nullptr) {
-                previous->bind();
-            }
-        }
-        if (next->dirty & DIRTY_UNIBLOCK) {
-            _unifbuff->setBlock(next->blockptr);
-        }
-        if (next->dirty & DIRTY_BLURSTEP) {
-            blurTexture(next->texture,next->blurstep);
-        }
+        apply(next);
         GLuint amt = next->last-next->first;
         _vertbuff->draw(next->command, amt, next->first);
         _callTotal++;
     }
     
     _unifbuff->deactivate();
+    if (!_history.empty() && _history.back()->clipped) {
+        // Never leave glScissor on between flushes (it affects glClear)
+        glDisable(GL_SCISSOR_TEST);
+        _context->dirty = _context->dirty | DIRTY_CLIPRECT;
+    }
     
     // Increment the counters
     _vertTotal += _indxSize;
@@ -2009,6 +2311,110 @@ void SpriteBatch::draw(const std::shared_ptr<Texture>& texture, const Color4f co
     fill(poly, origin, transform);
 }
 
+#pragma mark -
+#pragma mark Retained Meshes
+/**
+ * Draws the given retained mesh with the given transform.
+ *
+ * Unlike {@link #fill}, the vertices are not transformed on the CPU or
+ * copied into this sprite batch. The mesh is drawn directly from its own
+ * vertex buffer, with the transform passed to the shader as a uniform.
+ * The mesh uses the current texture, gradient, scissor, blend state and
+ * perspective of this sprite batch.
+ *
+ * The mesh vertices use their own color values.  However, if tint is true,
+ * these values will be tinted (i.e. multiplied) by the current active
+ * color. The vertex positions are 2d, so the depth of this sprite batch
+ * is ignored.
+ *
+ * This method must flush any vertices batched so far, and each retained
+ * mesh is a separate draw call. See {@link SpriteMesh} for when this is
+ * faster than batching.
+ *
+ * @param mesh      The retained mesh to draw
+ * @param transform The coordinate transform
+ * @param tint      Whether to tint with the active color
+ */
+void SpriteBatch::draw(const std::shared_ptr<SpriteMesh>& mesh, const Mat4& transform, bool tint) {
+    CUAssertLog(_active, "SpriteBatch is not active");
+    if (mesh == nullptr || mesh->getIndexSize() == 0) {
+        return;
+    }
+    flush();
+    CUProfileZone("mesh");
+    CUProfileGPUZone("mesh");
+
+    // The mesh needs its own uniform block for the scissor and gradient
+    _context->dirty = _context->dirty | DIRTY_UNIBLOCK;
+    setUniformBlock(_context,tint);
+    _unifbuff->activate();
+    _unifbuff->flush();
+    apply(_context);
+
+    // Gradients use the vertex colors as coordinates
+    _shader->setUniform(_uniformModel, transform);
+    _shader->setUniform(_uniformTint, tint && _gradient == nullptr ? _color : Color4f::WHITE);
+    mesh->getVertexBuffer()->attach(_shader);
+    mesh->getVertexBuffer()->draw(mesh->getCommand(), mesh->getIndexSize());
+    _unifbuff->deactivate();
+
+    // Restore the batch (the next vertices need a new block)
+    _vertbuff->bind();
+    _shader->setUniform(_uniformModel, Mat4::IDENTITY);
+    _shader->setUniform(_uniformTint, Color4f::WHITE);
+    _context->dirty = DIRTY_UNIBLOCK;
+    if (_context->clipped) {
+        glDisable(GL_SCISSOR_TEST);
+        _context->dirty = _context->dirty | DIRTY_CLIPRECT;
+    }
+    _callTotal++;
+    _vertTotal += mesh->getIndexSize();
+}
+
+
+#pragma mark -
+#pragma mark Instanced Sprites
+/**
+ * Draws the given sprite instances with the current texture.
+ *
+ * An instance is a unit quad with its own transform, texture region,
+ * animation frame, and color (see {@link SpriteInstance}). Instances
+ * are not expanded into vertices on the CPU. Instead, consecutive
+ * instances are collected and drawn together with a single call to
+ * glDrawElementsInstanced. The run of instances ends when any other
+ * shape is drawn, when the batch is flushed, or when any drawing state
+ * (such as the texture or blend function) changes. Hence sprites that
+ * share a texture should be drawn together.
+ *
+ * Instances use the current texture, scissor, blend state and
+ * perspective of this sprite batch. They do not use the active color
+ * (each instance has its own color), the depth, or the gradient. This
+ * sprite batch should not have a gradient when drawing instances.
+ *
+ * @param instances The sprite instances to draw
+ * @param count     The number of sprite instances
+ */
+void SpriteBatch::drawInstanced(const SpriteInstance* instances, size_t count) {
+    CUAssertLog(_active, "SpriteBatch is not active");
+    CUAssertLog(_gradient == nullptr, "Instanced sprites do not support gradients");
+    size_t pos = 0;
+    while (pos < count) {
+        if (_instSize == 0) {
+            // Start a new run with its own uniform block
+            flush();
+            _context->dirty = _context->dirty | DIRTY_UNIBLOCK;
+            setUniformBlock(_context,true);
+        }
+        size_t amt = std::min(count-pos,(size_t)(_instMax-_instSize));
+        std::memcpy(_instData+_instSize, instances+pos, amt*sizeof(SpriteInstance));
+        _instSize += (unsigned int)amt;
+        _inflight = true;
+        pos += amt;
+        if (_instSize == _instMax) {
+            flushInstances();
+        }
+    }
+}
 
 #pragma mark -
 #pragma mark Internal Helpers
@@ -2020,6 +2426,11 @@ void SpriteBatch::draw(const std::shared_ptr<Texture>& texture, const Color4f co
  * will use the correct set of uniforms.
  */
 void SpriteBatch::record() {
+    if (_instSize > 0) {
+        // Instances cannot change context mid-run
+        flushInstances();
+        return;
+    }
     Context* next = new Context(_context);
     _context->last = _indxSize;
     next->first = _indxSize;
@@ -2043,12 +2454,16 @@ void SpriteBatch::unwind() {
 /**
  * Sets the active uniform block to agree with the gradient and stroke.
  *
- * This method is called upon vertex preparation.
+ * This method is called upon vertex preparation. As vertices cannot be
+ * drawn together with instances, it draws any pending instances first.
  *
  * @param context   The current uniform context
  * @param tint      Whether to tint the gradient
  */
 void SpriteBatch::setUniformBlock(Context* context, bool tint) {
+    if (_instSize > 0) {
+        flushInstances();
+    }
     if (!(_context->dirty & DIRTY_UNIBLOCK)) {
         return;
     }
@@ -2056,8 +2471,9 @@ void SpriteBatch::setUniformBlock(Context* context, bool tint) {
         flush();
     }
     float data[40];
-    if (_scissor != nullptr) {
-        _scissor->getData(data);
+    const ScissorState& top = _scissorStack[_scissorTop];
+    if (top.active && !_context->clipped) {
+        top.mask.getData(data);
     } else {
         std::memset(data,0,16*sizeof(float));
     }
@@ -2071,6 +2487,159 @@ void SpriteBatch::setUniformBlock(Context* context, bool tint) {
     _unifbuff->setUniformfv(_context->blockptr,0,40,data);
 }
 
+/**
+ * Applies the changed values of the given context to OpenGL.
+ *
+ * Only the values marked dirty in the context are applied. This method
+ * assumes that the uniform buffer is active.
+ *
+ * @param context   The uniform context to apply
+ */
+void SpriteBatch::apply(Context* context) {
+    if (context->dirty & DIRTY_EQUATION) {
+        glBlendEquation(context->blendEquation);
+    }
+    if (context->dirty & DIRTY_BLENDFACTOR) {
+        if (context->alphaSeparate) {
+            glBlendFuncSeparate(context->srcFactor, context->dstFactor,
+                                context->srcAlpha,  context->dstAlpha);
+        } else {
+            glBlendFunc(context->srcFactor, context->dstFactor);
+        }
+    }
+    if (context->dirty & DIRTY_DEPTHTEST) {
+        if (context->depthFunc == GL_ALWAYS) {
+            glDisable(GL_DEPTH_TEST);
+        } else {
+            glEnable(GL_DEPTH_TEST);
+            glDepthFunc(context->depthFunc);
+        }
+    }
+    if (context->dirty & DIRTY_DRAWTYPE) {
+        _shader->setUniform(_uniformType, context->type);
+    }
+    if (context->dirty & DIRTY_PERSPECTIVE) {
+        // A new perspective usually means a new render target (and viewport)
+        _shader->setUniform(_uniformPerspective, *(context->perspective.get()));
+        glGetIntegerv(GL_VIEWPORT, _viewport);
+    }
+    if (context->dirty & DIRTY_TEXTURE) {
+        if (context->texture != nullptr) {
+            context->texture->bind();
+        }
+    }
+    if (context->dirty & DIRTY_UNIBLOCK) {
+        _unifbuff->setBlock(context->blockptr);
+    }
+    if (context->dirty & DIRTY_BLURSTEP) {
+        blurTexture(context->texture,context->blurstep);
+    }
+    if ((context->dirty & (DIRTY_DISTANCE | DIRTY_TEXTURE)) && (context->type & TYPE_DISTANCE)) {
+        distanceTexture(context);
+    }
+    if (context->dirty & DIRTY_CLIPRECT || (context->clipped && (context->dirty & DIRTY_PERSPECTIVE))) {
+        if (context->clipped) {
+            // Convert to normalized device coordinates, and then to the viewport
+            Rect box = context->perspective->transform(context->clipRect);
+            GLint x0 = (GLint)std::round(_viewport[0]+(box.getMinX()+1)*_viewport[2]/2);
+            GLint x1 = (GLint)std::round(_viewport[0]+(box.getMaxX()+1)*_viewport[2]/2);
+            GLint y0 = (GLint)std::round(_viewport[1]+(box.getMinY()+1)*_viewport[3]/2);
+            GLint y1 = (GLint)std::round(_viewport[1]+(box.getMaxY()+1)*_viewport[3]/2);
+            glEnable(GL_SCISSOR_TEST);
+            glScissor(x0, y0, std::max(x1-x0,0), std::max(y1-y0,0));
+        } else {
+            glDisable(GL_SCISSOR_TEST);
+        }
+    }
+}
+
+/**
+ * Updates the drawing context to agree with the top of the scissor stack.
+ *
+ * Axis-aligned masks with no fringe (under an axis-aligned perspective)
+ * are clipped with glScissor. All other masks use the scissor shader, as
+ * glScissor cannot feather the edges of a mask.
+ */
+void SpriteBatch::updateScissor() {
+    if (_inflight) { record(); }
+    const ScissorState& top = _scissorStack[_scissorTop];
+    _context->dirty = _context->dirty | DIRTY_UNIBLOCK | DIRTY_DRAWTYPE | DIRTY_CLIPRECT;
+    if (!top.active) {
+        _context->type = _context->type & ~TYPE_SCISSOR;
+        _context->clipped = false;
+        return;
+    }
+    
+    const Affine2 transform = top.mask.getTransform();
+    const float* matrix = _context->perspective->m;
+    bool aligned = (transform.m[1] == 0 && transform.m[2] == 0 && top.mask.getFringe() == 0);
+    aligned = aligned && matrix[1] == 0 && matrix[4] == 0 && matrix[3] == 0 && matrix[7] == 0;
+    if (aligned) {
+        _context->type = _context->type & ~TYPE_SCISSOR;
+        _context->clipped = true;
+        _context->clipRect = transform.transform(top.mask.getBounds());
+    } else {
+        _context->type = _context->type | TYPE_SCISSOR;
+        _context->clipped = false;
+    }
+}
+
+/**
+ * Draws the pending sprite instances.
+ *
+ * This method is called whenever a run of instances ends. It applies
+ * the current context, and so the run cannot span a context change.
+ */
+void SpriteBatch::flushInstances() {
+    if (_instSize == 0) {
+        return;
+    }
+    CUProfileZone("flush");
+    CUProfileGPUZone("flush");
+    
+    _instbuff->bind();
+    _instbuff->loadVertexData(_instData, _instSize);
+    _unifbuff->activate();
+    _unifbuff->flush();
+    apply(_context);
+    
+    _shader->setUniform(_uniformInstanced, 1);
+    _instbuff->drawInstanced(GL_TRIANGLES, 6, _instSize);
+    _shader->setUniform(_uniformInstanced, 0);
+    _unifbuff->deactivate();
+    
+    // Restore the batch (the next vertices need a new block)
+    _vertbuff->bind();
+    _context->dirty = DIRTY_UNIBLOCK;
+    if (_context->clipped) {
+        glDisable(GL_SCISSOR_TEST);
+        _context->dirty = _context->dirty | DIRTY_CLIPRECT;
+    }
+    _callTotal++;
+    _vertTotal += 6*_instSize;
+    _instSize = 0;
+    _inflight = false;
+}
+
+/**
+ * Caches the uniform handles for the active shader.
+ *
+ * This method is called whenever the shader changes. Handles for
+ * uniforms that the shader does not have are invalid, and are ignored
+ * when drawing.
+ */
+void SpriteBatch::lookupUniforms() {
+    _uniformType = _shader->getUniformHandle<GLint>("uType");
+    _uniformPerspective = _shader->getUniformHandle<Mat4>("uPerspective");
+    _uniformBlur = _shader->getUniformHandle<Vec2>("uBlur");
+    _uniformDistance = _shader->getUniformHandle<Vec3>("uDistance");
+    _uniformOutline  = _shader->getUniformHandle<Color4f>("uOutline");
+    _uniformShadow   = _shader->getUniformHandle<Color4f>("uShadow");
+    _uniformModel    = _shader->getUniformHandle<Mat4>("uModel");
+    _uniformTint     = _shader->getUniformHandle<Color4f>("uTint");
+    _uniformInstanced = _shader->getUniformHandle<GLint>("uInstanced");
+}
+
 /**
  * Updates the shader with the current blur offsets
  *
@@ -2085,13 +2654,34 @@ void SpriteBatch::setUniformBlock(Context* context, bool tint) {
  */
 void SpriteBatch::blurTexture(const std::shared_ptr<Texture>& texture, GLuint step) {
     if (texture == nullptr) {
-        _shader->setUniform2f("uBlur", 0, 0);
+        _shader->setUniform(_uniformBlur, Vec2::ZERO);
         return;
     }
     Size size = texture->getSize();
     size.width  = step/size.width;
     size.height = step/size.height;
-    _shader->setUniform2f("uBlur",size.width,size.height);
+    _shader->setUniform(_uniformBlur, Vec2(size.width,size.height));
+}
+
+/**
+ * Updates the shader with the current distance field effects
+ *
+ * The shadow offset depends upon the texture size. This method converts
+ * the offset into texture coordinates, just like {@link #blurTexture}.
+ *
+ * @param context   The current uniform context
+ */
+void SpriteBatch::distanceTexture(Context* context) {
+    Vec2 offset;
+    if (context->texture != nullptr) {
+        // Texture coordinates have the y-axis pointing down
+        Size size = context->texture->getSize();
+        offset.x =  context->shadowOffset.x/size.width;
+        offset.y = -context->shadowOffset.y/size.height;
+    }
+    _shader->setUniform(_uniformDistance, Vec3(context->outlineWidth, offset.x, offset.y));
+    _shader->setUniform(_uniformOutline, context->outlineColor);
+    _shader->setUniform(_uniformShadow, context->shadowColor);
 }
 
 /**
@@ -2200,7 +2790,7 @@ unsigned int SpriteBatch::prepare(const Rect rect, const Mat4& mat) {
     int ii = 0;
     for(auto it = poly.vertices().begin(); it != poly.vertices().end(); ++it) {
         Vec3 point = Vec3((*it),_depth);
-        _vertData[vstart+ii].position = point*mat;
+        _vertData[vstart+ii].position = point;
         
         point.x = (point.x-rect.origin.x)/rect.size.width;
         point.y = 1-(point.y-rect.origin.y)/rect.size.height;
@@ -2211,6 +2801,9 @@ unsigned int SpriteBatch::prepare(const Rect rect, const Mat4& mat) {
         ii++;
     }
     
+    float* positions = &(_vertData[vstart].position.x);
+    Mat4::transform3(mat, positions, VERTEX_STRIDE, positions, VERTEX_STRIDE, ii);
+    
     int jj = 0;
     unsigned int istart = _indxSize;
     for(auto it = poly.indices().begin(); it != poly.indices().end(); ++it) {
@@ -2432,7 +3025,7 @@ unsigned int SpriteBatch::prepare(const Poly2& poly, const Mat4& mat) {
     int ii = 0;
     for(auto it = poly.vertices().begin(); it != poly.vertices().end(); ++it) {
         Vec3 point = Vec3((*it),_depth);
-        _vertData[vstart+ii].position = point*mat;
+        _vertData[vstart+ii].position = point;
         
         point.x /= twidth;
         point.y = 1-point.y/theight;
@@ -2442,6 +3035,9 @@ unsigned int SpriteBatch::prepare(const Poly2& poly, const Mat4& mat) {
         ii++;
     }
     
+    float* positions = &(_vertData[vstart].position.x);
+    Mat4::transform3(mat, positions, VERTEX_STRIDE, positions, VERTEX_STRIDE, ii);
+    
     int jj = 0;
     unsigned int istart = _indxSize;
     for(auto it = poly.indices().begin(); it != poly.indices().end(); ++it) {
@@ -2563,12 +3159,13 @@ unsigned int SpriteBatch::prepare(const Mesh<SpriteVertex2>& mesh, const Mat4& m
         _vertData[_vertSize+ii].position = Vec3(it->position,_depth);
         _vertData[_vertSize+ii].color = it->color;
         _vertData[_vertSize+ii].texcoord = it->texcoord;
-        _vertData[_vertSize+ii].position *= mat;
         if (tint && _gradient == nullptr) {
             _vertData[_vertSize+ii].color *= _color;
         }
         ii++;
     }
+    float* positions = &(_vertData[_vertSize].position.x);
+    Mat4::transform3(mat, positions, VERTEX_STRIDE, positions, VERTEX_STRIDE, ii);
     
     int jj = 0;
     for(auto it = mesh.indices.begin(); it != mesh.indices.end(); ++it) {
@@ -2659,12 +3256,13 @@ unsigned int SpriteBatch::prepare(const Mesh<SpriteVertex3>& mesh, const Mat4& m
     int ii = 0;
     for(auto it = mesh.vertices.begin(); it != mesh.vertices.end(); ++it) {
         _vertData[_vertSize+ii] = *it;
-        _vertData[_vertSize+ii].position *= mat;
         if (tint && _gradient == nullptr) {
             _vertData[_vertSize+ii].color *= _color;
         }
         ii++;
     }
+    float* positions = &(_vertData[_vertSize].position.x);
+    Mat4::transform3(mat, positions, VERTEX_STRIDE, positions, VERTEX_STRIDE, ii);
     
     int jj = 0;
     for(auto it = mesh.indices.begin(); it != mesh.indices.end(); ++it) {
@@ -0,0 +1,136 @@
+//
+//  CUSpriteMesh.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a sprite mesh that is retained on the GPU. Normally
+//  a SpriteBatch transforms the vertices of every mesh on the CPU and copies
+//  them into its own vertex buffer, every frame. A sprite mesh is uploaded
+//  once to its own vertex buffer, and is drawn with a transform uniform
+//  instead. This is much cheaper for large meshes that rarely change shape,
+//  even if they move every frame.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: agent
+//  Version: 10/19/26
+//
+#include <cugl/render/CUSpriteMesh.h>
+#include <cugl/util/CUDebug.h>
+
+using namespace cugl;
+
+#pragma mark Constructors
+/**
+ * Creates an uninitialized sprite mesh.
+ *
+ * You must initialize the mesh to allocate buffer memory.
+ */
+SpriteMesh::SpriteMesh() :
+_vertbuff(nullptr),
+_command(GL_TRIANGLES),
+_vertSize(0),
+_indxSize(0) {
+}
+
+/**
+ * Deletes the sprite mesh, freeing all resources.
+ *
+ * You must reinitialize the sprite mesh to use it.
+ */
+void SpriteMesh::dispose() {
+    _vertbuff = nullptr;
+    _command  = GL_TRIANGLES;
+    _vertSize = 0;
+    _indxSize = 0;
+}
+
+/**
+ * Initializes this sprite mesh with the given vertices.
+ *
+ * The mesh is uploaded to a new vertex buffer immediately. The mesh must
+ * be sliceable, with a drawing command of GL_TRIANGLES or GL_LINES.
+ *
+ * @param mesh  The mesh to upload
+ *
+ * @return true if initialization was successful.
+ */
+bool SpriteMesh::init(const Mesh<SpriteVertex2>& mesh) {
+    if (_vertbuff != nullptr) {
+        CUAssertLog(false, "SpriteMesh is already initialized");
+        return false; // If asserts are turned off.
+    }
+
+    _vertbuff = VertexBuffer::alloc(sizeof(SpriteVertex2));
+    if (_vertbuff == nullptr) {
+        return false;
+    }
+    _vertbuff->setupAttribute("aPosition", 2, GL_FLOAT, GL_FALSE,
+                              offsetof(cugl::SpriteVertex2,position));
+    _vertbuff->setupAttribute("aColor",    4, GL_FLOAT, GL_TRUE,
+                              offsetof(cugl::SpriteVertex2,color));
+    _vertbuff->setupAttribute("aTexCoord", 2, GL_FLOAT, GL_FALSE,
+                              offsetof(cugl::SpriteVertex2,texcoord));
+    setMesh(mesh);
+    return true;
+}
+
+#pragma mark -
+#pragma mark Attributes
+/**
+ * Replaces the vertices of this sprite mesh.
+ *
+ * The new mesh is uploaded to the vertex buffer immediately. The binding
+ * of any other vertex buffer (such as the one of an active sprite batch)
+ * is preserved.
+ *
+ * @param mesh  The mesh to upload
+ */
+void SpriteMesh::setMesh(const Mesh<SpriteVertex2>& mesh) {
+    CUAssertLog(_vertbuff != nullptr, "SpriteMesh has not been initialized");
+    CUAssertLog(mesh.isSliceable(), "Sprite meshes only support sliceable meshes");
+    CUAssertLog(mesh.command == GL_TRIANGLES || mesh.command == GL_LINES,
+                "Sprite meshes only support triangles and lines");
+
+    // The element buffer binding is part of the vertex array
+    GLint array, buffer;
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &array);
+    glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &buffer);
+
+    _command  = mesh.command;
+    _vertSize = (GLsizei)mesh.vertices.size();
+    _indxSize = (GLsizei)mesh.indices.size();
+    _vertbuff->bind();
+    _vertbuff->loadVertexData(mesh.vertices.data(), _vertSize, GL_STATIC_DRAW);
+    _vertbuff->loadIndexData(mesh.indices.data(), _indxSize, GL_STATIC_DRAW);
+
+    glBindVertexArray(array);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+}
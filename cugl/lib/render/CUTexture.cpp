@@ -373,6 +373,97 @@ const Texture& Texture::set(const void *data) {
     return *this;
 }
 
+/**
+ * Replaces the contents of this texture with an image of the given size.
+ *
+ * Unlike {@link #set}, the image may have a different size than the
+ * original. The OpenGL buffer is reused, so every object holding this
+ * texture (including any subtexture) sees the new image. The filter and
+ * wrap settings are kept, and mipmaps are rebuilt if this texture had
+ * them. The buffer must be in the pixel format of this texture.
+ *
+ * This method is used to hot reload textures. It may not be called on a
+ * subtexture. Any texture bound to offset 0 will be unbound.
+ *
+ * @param data      The buffer to read into the texture
+ * @param width     The image width in pixels
+ * @param height    The image height in pixels
+ *
+ * @return true if the texture was successfully replaced
+ */
+bool Texture::reload(const void *data, int width, int height) {
+    CUAssertLog(_parent == nullptr, "Cannot reload a subtexture");
+    CUAssertLog(width > 0 && height > 0, "Texture size %dx%d is not valid",width,height);
+    if (!_buffer) {
+        return false;
+    }
+    
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, _buffer);
+    
+    GLint  internal = internal_format(_pixelFormat);
+    GLenum datatype = format_type(_pixelFormat);
+    glTexImage2D(GL_TEXTURE_2D, 0, internal, width, height, 0, (GLenum)_pixelFormat, datatype, data);
+    
+    GLenum error = glGetError();
+    if (error) {
+        CULogError("Could not reload texture. %s", gl_error_name(error).c_str());
+        glBindTexture(GL_TEXTURE_2D, 0);
+        return false;
+    }
+    
+    _width  = width;
+    _height = height;
+    if (_hasMipmaps) {
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return true;
+}
+
+/**
+ * Replaces a rectangular region of this texture with the given buffer.
+ *
+ * The buffer must have the pixel format of this texture, and be of size
+ * width*height*bytesize. The region is specified in pixels, with the
+ * origin at the first row of the image, and must fit inside the texture.
+ * Unlike {@link #set}, this texture does not need to be active. This
+ * makes it possible to add images to a texture atlas incrementally,
+ * without uploading the entire atlas.
+ *
+ * Mipmaps are not rebuilt by this method. This method may not be called
+ * on a subtexture. Any texture bound to offset 0 will be unbound.
+ *
+ * @param data      The buffer to read into the texture
+ * @param x         The left edge of the region in pixels
+ * @param y         The first row of the region in pixels
+ * @param width     The region width in pixels
+ * @param height    The region height in pixels
+ *
+ * @return true if the region was successfully replaced
+ */
+bool Texture::update(const void *data, int x, int y, int width, int height) {
+    CUAssertLog(_parent == nullptr, "Cannot update a subtexture");
+    CUAssertLog(x >= 0 && y >= 0 && x+width <= (int)_width && y+height <= (int)_height,
+                "Region (%d,%d,%d,%d) is outside of the texture",x,y,width,height);
+    if (!_buffer) {
+        return false;
+    }
+    
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, _buffer);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height,
+                    (GLenum)_pixelFormat, format_type(_pixelFormat), data);
+    
+    GLenum error = glGetError();
+    glBindTexture(GL_TEXTURE_2D, 0);
+    if (error) {
+        CULogError("Could not update texture. %s", gl_error_name(error).c_str());
+        return false;
+    }
+    return true;
+}
+
 
 #pragma mark -
 #pragma mark Attributes
@@ -574,6 +665,32 @@ std::shared_ptr<Texture> Texture::getSubTexture(GLfloat minS, GLfloat maxS,
     return result;
 }
 
+/**
+ * Resets the region of this subtexture within its parent.
+ *
+ * The values must be 0 <= minS <= maxS <= 1 and 0 <= minT <= maxT <= 1.
+ * They have the same meaning as in {@link #getSubTexture}.
+ *
+ * This method is used to update an atlas after the parent texture is
+ * reloaded with a different size. It may only be called on a subtexture.
+ *
+ * @param minS  The new minimum S coordinate
+ * @param maxS  The new maximum S coordinate
+ * @param minT  The new minimum T coordinate
+ * @param maxT  The new maximum T coordinate
+ */
+void Texture::setSubRegion(GLfloat minS, GLfloat maxS, GLfloat minT, GLfloat maxT) {
+    CUAssertLog(_parent != nullptr, "Texture is not a subtexture");
+    CUAssertLog(minS >= 0 && minS <= maxS && maxS <= 1, "S values are out of range");
+    CUAssertLog(minT >= 0 && minT <= maxT && maxT <= 1, "T values are out of range");
+    _width  = (unsigned int)((maxS-minS)*_parent->_width);
+    _height = (unsigned int)((maxT-minT)*_parent->_height);
+    _minS = minS;
+    _maxS = maxS;
+    _minT = minT;
+    _maxT = maxT;
+}
+
 
 #pragma mark -
 #pragma mark Rendering
@@ -193,6 +193,7 @@ void VertexBuffer::attach(const std::shared_ptr<Shader>& shader) {
 				glVertexAttribPointer(pos,it->second.size,it->second.type,
 									  it->second.norm,_stride,
 									  reinterpret_cast<void*>(it->second.offset));
+				glVertexAttribDivisor(pos,it->second.divisor);
 			} else {
 				glDisableVertexAttribArray(pos);
 			}
@@ -374,19 +375,24 @@ void VertexBuffer::drawInstanced(GLenum mode, GLsizei count, GLsizei instance, G
  * attached.  This allows a vertex buffer to swap (compatible) shaders
  * with little additional code.
  *
+ * The divisor is for instanced drawing. An attribute with divisor 0 advances
+ * once per vertex. Otherwise, it advances once per that many instances.
+ *
  *@param name   The name of the attribute
  *@param size   The number of components per vertex
  *@param type   The data type per component
  *@param norm   Whether the data values are normalized (floating point only)
  *@param offset The offset of the first component in the buffer
+ *@param divisor The number of instances per attribute value
  */
 void VertexBuffer::setupAttribute(const std::string name, GLint size, GLenum type,
-                                  GLboolean norm, GLsizei offset) {
+                                  GLboolean norm, GLsizei offset, GLuint divisor) {
     AttribData data;
     data.size = size;
     data.norm = norm;
     data.type = type;
     data.offset = offset;
+    data.divisor = divisor;
     _attributes[name] = data;
     _enabled[name] = true;
     
@@ -399,6 +405,7 @@ void VertexBuffer::setupAttribute(const std::string name, GLint size, GLenum typ
             glEnableVertexAttribArray(pos);
             glVertexAttribPointer(pos,data.size,data.type,data.norm,_stride,
                                   reinterpret_cast<void*>(data.offset));
+            glVertexAttribDivisor(pos,data.divisor);
         }
         
         GLenum error = glGetError();
@@ -6,8 +6,8 @@ R"(////////// SHADER BEGIN /////////
 //  It supports textures which can be tinted per vertex. It also supports gradients
 //  (which can be used simulataneously with textures, but not with colors), as
 //  well as a scissor mask.  Gradients use the color inputs as their texture
-//  coordinates. Finally, there is support for very simple blur effects, which
-//  are used for font labels.
+//  coordinates. Finally, there is support for very simple blur effects, and
+//  for signed distance field textures, which are used for font labels.
 //
 //  CUGL MIT License:
 //      This software is provided 'as-is', without any express or implied
@@ -39,6 +39,12 @@ precision highp float;  // highp required for gradient precision
 uniform int  uType;
 // Blur offset for simple kernel blur
 uniform vec2 uBlur;
+// Distance field outline width (x) and shadow offset (yz)
+uniform vec3 uDistance;
+// Distance field outline color
+uniform vec4 uOutline;
+// Distance field shadow color
+uniform vec4 uShadow;
 
 // The texture for sampling
 uniform sampler2D uTexture;
@@ -144,6 +150,37 @@ vec4 blursample(vec2 coord) {
     return result;
 }
 
+/**
+ * Returns the color of a signed distance field sample
+ *
+ * The texture alpha is the distance to the glyph edge, with the
+ * edge at 0.5. The edge is antialiased over one screen pixel, so
+ * it stays crisp at any scale. The glyph is filled with the given
+ * color and surrounded by the outline (if it has width). It is
+ * drawn over the shadow (if it is visible).
+ *
+ * coord: The texture coordinate to sample
+ * fill:  The fill color for the glyph
+ */
+vec4 distancesample(vec2 coord, vec4 fill) {
+    float dist = texture(uTexture, coord).a;
+    float soft = max(fwidth(dist)*0.5, 0.001);
+    float edge = 0.5-uDistance.x;
+    float inner = smoothstep(0.5-soft, 0.5+soft, dist);
+    float outer = smoothstep(edge-soft, edge+soft, dist);
+    
+    vec4 result = mix(uOutline, fill, inner);
+    result.a *= outer;
+    if (uShadow.a > 0.0) {
+        float shade = texture(uTexture, coord-uDistance.yz).a;
+        shade = smoothstep(edge-soft, edge+soft, shade)*uShadow.a;
+        float alpha = result.a+shade*(1.0-result.a);
+        vec3 color = result.rgb*result.a+uShadow.rgb*shade*(1.0-result.a);
+        result = vec4(color/max(alpha, 0.001), alpha);
+    }
+    return result;
+}
+
 /**
  * Performs the main fragment shading.
  */
@@ -177,7 +214,9 @@ void main(void) {
     
     if (mod(fType, 2.0) == 1.0) {
         // Include texture (tinted by color or gradient)
-        if (uType >= 8) {
+        if (fType >= 16.0) {
+            result = distancesample(outTexCoord, result);
+        } else if (mod(fType, 16.0) >= 8.0) {
             result *= blursample(outTexCoord);
         } else {
             result *= texture(uTexture, outTexCoord);
@@ -9,6 +9,11 @@ R"(////////// SHADER BEGIN /////////
 //  coordinates. Finally, there is support for very simple blur effects, which
 //  are used for font labels.
 //
+//  Retained meshes are stored in local coordinates, and are positioned with
+//  the model matrix and tinted with the tint uniform. Instanced sprites are
+//  unit quads with per-instance attributes (see SpriteInstance). The quad
+//  corner is computed from the vertex index.
+//
 //  CUGL MIT License:
 //      This software is provided 'as-is', without any express or implied
 //      warranty.  In no event will the authors be held liable for any damages
@@ -46,12 +51,40 @@ out vec2 outTexCoord;
 // Matrices
 uniform mat4 uPerspective;
 
+// Retained meshes (identity and white when batching)
+uniform mat4 uModel;
+uniform vec4 uTint;
+
+// Instanced sprites (0 when batching)
+uniform int uInstanced;
+in vec3 aTransform0;
+in vec3 aTransform1;
+in vec4 aTexRect;
+in vec2 aFrame;
+
 // Transform and pass through                                                   
 void main(void) {
-    gl_Position = uPerspective*aPosition;
-    outPosition = aPosition.xy; // Need untransformed for scissor
-    outColor = aColor;
-    outTexCoord = aTexCoord;
+    vec4 position;
+    if (uInstanced != 0) {
+        // Indices 0,1,2,3 are the corners (0,0), (1,0), (1,1), (0,1)
+        vec3 corner = vec3(float(gl_VertexID == 1 || gl_VertexID == 2),
+                           float(gl_VertexID >= 2), 1.0);
+        position = vec4(dot(aTransform0,corner),dot(aTransform1,corner),0.0,1.0);
+        
+        // Texture coordinates have the y-axis pointing down
+        float cols = max(aFrame.y,1.0);
+        vec2 cell  = vec2(mod(aFrame.x,cols),floor(aFrame.x/cols));
+        vec2 local = vec2(corner.x,1.0-corner.y);
+        local = mix(local,1.0-local,lessThan(aTexRect.zw,vec2(0.0)));
+        outTexCoord = aTexRect.xy+(cell+local)*abs(aTexRect.zw);
+        outColor = aColor;
+    } else {
+        position = uModel*aPosition;
+        outTexCoord = aTexCoord;
+        outColor = aColor*uTint;
+    }
+    gl_Position = uPerspective*position;
+    outPosition = position.xy; // Need unprojected for scissor
 }
 
 /////////// SHADER END //////////)"
@@ -46,6 +46,11 @@
 
 using namespace cugl;
 
+/** The maximum number of nodes in a hit testing leaf */
+#define HIT_LEAF_SIZE   4
+/** The maximum depth of the hit testing hierarchy */
+#define HIT_MAX_DEPTH   64
+
 /**
  * Creates a new degenerate Scene on the stack.
  *
@@ -61,7 +66,13 @@ _color(Color4::WHITE),
 _blendEquation(GL_FUNC_ADD),
 _srcFactor(GL_SRC_ALPHA),
 _dstFactor(GL_ONE_MINUS_SRC_ALPHA),
-_active(false)
+_active(false),
+_hitDirty(true),
+_culling(false),
+_cullActive(false),
+_cullTests(0),
+_cullSkips(0),
+_cullNodes(0)
 {}
 
 /**
@@ -76,6 +87,8 @@ void Scene2::dispose() {
     _name = "";
     _color = Color4::WHITE;
     _active = false;
+    _culling = false;
+    setHitDirty();
 }
 
 /**
@@ -395,6 +408,7 @@ void Scene2::sortZOrder() {
         for(auto it = _children.begin(); it != _children.end(); ++it ) {
             (*it)->sortZOrder();
         }
+        setHitDirty();
     }
 }
 
@@ -411,6 +425,9 @@ void Scene2::sortZOrder() {
  * That means that parents are always draw before (and behind children).
  * To override this draw order, scene nodes do support a z-axis offset.
  *
+ * If culling is enabled (see {@link #setCulling}), subtrees outside of
+ * the camera are skipped.
+ *
  * @param batch     The SpriteBatch to draw with.
  */
 void Scene2::render(const std::shared_ptr<SpriteBatch>& batch) {
@@ -418,9 +435,246 @@ void Scene2::render(const std::shared_ptr<SpriteBatch>& batch) {
     batch->setBlendFunc(_srcFactor, _dstFactor);
     batch->setBlendEquation(_blendEquation);
 
+    _cullTests = 0;
+    _cullSkips = 0;
+    _cullNodes = 0;
+    if (_culling) {
+        // The visible region is the clip space square in world coordinates
+        Mat4 inverse = _camera->getCombined().getInverse();
+        _cullRect = inverse.transform(Rect(-1,-1,2,2));
+        _cullActive = true;
+    }
+
     for(auto it = _children.begin(); it != _children.end(); ++it) {
         (*it)->render(batch, Mat4::IDENTITY, _color);
     }
 
+    _cullActive = false;
     batch->end();
 }
+
+#pragma mark -
+#pragma mark Hit Testing
+/**
+ * Returns the topmost node whose bounding box contains the given point.
+ *
+ * The point is in world coordinates. Nodes are tested against the
+ * axis-aligned bounding box of their content in world space, so rotated
+ * nodes may report hits slightly outside of their contents. Invisible
+ * nodes (and their descendants) are ignored, as are nodes with no
+ * content size. Among the nodes that contain the point, this method
+ * returns the one drawn last in the pre-order traversal of {@link render}.
+ *
+ * If filter is provided, only nodes that pass it are considered. This
+ * is useful for picking only interactive nodes (e.g. buttons) and not
+ * the labels drawn on top of them.
+ *
+ * The query uses a bounding volume hierarchy over all visible nodes, so
+ * it is logarithmic in the size of the scene graph. The hierarchy is
+ * rebuilt lazily on the next query whenever a node in this scene is
+ * moved, resized, shown, hidden, added, removed, or reordered.
+ *
+ * @param point     The point in world coordinates
+ * @param filter    An optional predicate restricting the candidates
+ *
+ * @return the topmost node whose bounding box contains the given point.
+ */
+std::shared_ptr<scene2::SceneNode> Scene2::pick(const Vec2 point,
+                                                const std::function<bool(const std::shared_ptr<scene2::SceneNode>&)>& filter) {
+    buildHitTree();
+    if (_hitTree.empty()) {
+        return nullptr;
+    }
+    
+    // Visit the subtrees with later draw orders first, pruning earlier ones
+    Sint64 best = -1;
+    Uint32 stack[HIT_MAX_DEPTH];
+    size_t top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const HitBox& box = _hitTree[stack[--top]];
+        if ((Sint64)box.order <= best || !box.bounds.contains(point)) {
+            continue;
+        }
+        if (box.count > 0) {
+            for(Uint32 ii = box.start; ii < box.start+box.count; ii++) {
+                Uint32 item = _hitItems[ii];
+                if ((Sint64)item > best && _hitBounds[item].contains(point) &&
+                    (!filter || filter(_hitNodes[item]))) {
+                    best = item;
+                }
+            }
+        } else {
+            Uint32 left  = (Uint32)(&box-_hitTree.data())+1;
+            Uint32 right = box.start;
+            if (_hitTree[left].order > _hitTree[right].order) {
+                stack[top++] = right;
+                stack[top++] = left;
+            } else {
+                stack[top++] = left;
+                stack[top++] = right;
+            }
+        }
+    }
+    return best < 0 ? nullptr : _hitNodes[best];
+}
+
+/**
+ * Appends all nodes whose bounding box contains the given point.
+ *
+ * The point is in world coordinates. The nodes are appended to the
+ * given vector in draw order from front to back, so that the topmost
+ * node comes first. See {@link pick} for how the nodes are tested.
+ *
+ * @param point The point in world coordinates
+ * @param nodes The vector to store the results
+ *
+ * @return the number of nodes appended
+ */
+size_t Scene2::pickAll(const Vec2 point, std::vector<std::shared_ptr<scene2::SceneNode>>& nodes) {
+    buildHitTree();
+    if (_hitTree.empty()) {
+        return 0;
+    }
+    
+    std::vector<Uint32> found;
+    Uint32 stack[HIT_MAX_DEPTH];
+    size_t top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        Uint32 index = stack[--top];
+        const HitBox& box = _hitTree[index];
+        if (!box.bounds.contains(point)) {
+            continue;
+        }
+        if (box.count > 0) {
+            for(Uint32 ii = box.start; ii < box.start+box.count; ii++) {
+                if (_hitBounds[_hitItems[ii]].contains(point)) {
+                    found.push_back(_hitItems[ii]);
+                }
+            }
+        } else {
+            stack[top++] = index+1;
+            stack[top++] = box.start;
+        }
+    }
+    
+    std::sort(found.begin(),found.end(),std::greater<Uint32>());
+    for(auto it = found.begin(); it != found.end(); ++it) {
+        nodes.push_back(_hitNodes[*it]);
+    }
+    return found.size();
+}
+
+/**
+ * Marks the hit testing hierarchy as out of date.
+ *
+ * This method is called by {@link scene2::SceneNode} whenever a node in
+ * this scene changes position, size, visibility or order. Any references
+ * retained by the hierarchy are released immediately.
+ */
+void Scene2::setHitDirty() {
+    if (!_hitDirty) {
+        _hitDirty = true;
+        _hitNodes.clear();
+        _hitBounds.clear();
+        _hitItems.clear();
+        _hitTree.clear();
+    }
+}
+
+/**
+ * Rebuilds the hit testing hierarchy if it is out of date.
+ */
+void Scene2::buildHitTree() {
+    if (!_hitDirty) {
+        return;
+    }
+    
+    _hitNodes.clear();
+    _hitBounds.clear();
+    _hitTree.clear();
+    for(auto it = _children.begin(); it != _children.end(); ++it) {
+        collectHitNodes(*it, Mat4::IDENTITY);
+    }
+    
+    Uint32 size = (Uint32)_hitNodes.size();
+    _hitItems.resize(size);
+    for(Uint32 ii = 0; ii < size; ii++) {
+        _hitItems[ii] = ii;
+    }
+    if (size > 0) {
+        _hitTree.reserve(2*(size/HIT_LEAF_SIZE+1));
+        buildHitBox(0,size);
+    }
+    _hitDirty = false;
+}
+
+/**
+ * Recursively collects the visible nodes of a subtree for hit testing.
+ *
+ * @param node      The root of the subtree
+ * @param transform The world transform of the node parent
+ */
+void Scene2::collectHitNodes(const std::shared_ptr<scene2::SceneNode>& node, const Mat4& transform) {
+    if (!node->isVisible()) {
+        return;
+    }
+    
+    Mat4 matrix;
+    Mat4::multiply(node->getNodeToParentTransform(),transform,&matrix);
+    Size size = node->getContentSize();
+    if (size.width > 0 && size.height > 0) {
+        _hitNodes.push_back(node);
+        _hitBounds.push_back(matrix.transform(Rect(Vec2::ZERO,size)));
+    }
+    for(auto it = node->_children.begin(); it != node->_children.end(); ++it) {
+        collectHitNodes(*it, matrix);
+    }
+}
+
+/**
+ * Recursively builds the hierarchy over the given range of _hitItems.
+ *
+ * @param start The first item in the range
+ * @param end   The item after the range
+ */
+void Scene2::buildHitBox(Uint32 start, Uint32 end) {
+    Uint32 index = (Uint32)_hitTree.size();
+    _hitTree.push_back(HitBox());
+    
+    Rect bounds = _hitBounds[_hitItems[start]];
+    Uint32 order = _hitItems[start];
+    Vec2 cmin(bounds.getMidX(),bounds.getMidY());
+    Vec2 cmax = cmin;
+    for(Uint32 ii = start+1; ii < end; ii++) {
+        const Rect& rect = _hitBounds[_hitItems[ii]];
+        bounds.merge(rect);
+        order = std::max(order,_hitItems[ii]);
+        cmin.x = std::min(cmin.x,rect.getMidX());
+        cmin.y = std::min(cmin.y,rect.getMidY());
+        cmax.x = std::max(cmax.x,rect.getMidX());
+        cmax.y = std::max(cmax.y,rect.getMidY());
+    }
+    _hitTree[index].bounds = bounds;
+    _hitTree[index].order  = order;
+    
+    if (end-start <= HIT_LEAF_SIZE) {
+        _hitTree[index].start = start;
+        _hitTree[index].count = end-start;
+        return;
+    }
+    
+    // Median split along the longest axis of the centers
+    bool xaxis = (cmax.x-cmin.x) >= (cmax.y-cmin.y);
+    Uint32 mid = (start+end)/2;
+    std::nth_element(_hitItems.begin()+start, _hitItems.begin()+mid, _hitItems.begin()+end,
+                     [&](Uint32 a, Uint32 b) {
+                         return (xaxis ? _hitBounds[a].getMidX() < _hitBounds[b].getMidX() :
+                                         _hitBounds[a].getMidY() < _hitBounds[b].getMidY());
+                     });
+    buildHitBox(start,mid);
+    _hitTree[index].start = (Uint32)_hitTree.size();
+    _hitTree[index].count = 0;
+    buildHitBox(mid,end);
+}
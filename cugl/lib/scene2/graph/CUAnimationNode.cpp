@@ -46,6 +46,9 @@
 
 using namespace cugl::scene2;
 
+/** The allowed drift (in pixels) between the polygon and the frame after shifting */
+#define BOUNDS_VARIANCE 0.5f
+
 
 #pragma mark -
 #pragma mark Constructors
@@ -168,3 +171,48 @@ void AnimationNode::setFrame(int frame) {
     _bounds.origin.set(x,y);
 }
 
+#pragma mark -
+#pragma mark Rendering
+/**
+ * Draws this Node via the given SpriteBatch.
+ *
+ * If this node is a plain filmstrip frame (the polygon is the frame
+ * rectangle, with no gradient, flip, or retained mesh), it is drawn as
+ * a {@link SpriteInstance}. Consecutive animation nodes that share a
+ * texture are then drawn by the sprite batch with a single instanced
+ * draw call. Otherwise, this node is drawn like any polygon node.
+ *
+ * @param batch     The SpriteBatch to draw with.
+ * @param transform The global transformation matrix.
+ * @param tint      The tint to blend with the Node color.
+ */
+void AnimationNode::draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform, Color4 tint) {
+    if (_gradient != nullptr || _retained || _absolute || _flipHorizontal || _flipVertical ||
+        _cols <= 0 || _polygon.vertices().size() != 4 || !_polygon.getBounds().equals(_bounds,BOUNDS_VARIANCE)) {
+        PolygonNode::draw(batch, transform, tint);
+        return;
+    }
+
+    // Texture coordinates have the y-axis pointing down
+    Size tsize = _texture->getSize();
+    float swidth  = _texture->getMaxS()-_texture->getMinS();
+    float theight = _texture->getMaxT()-_texture->getMinT();
+    Vec4 texrect;
+    texrect.z = swidth*_bounds.size.width/tsize.width;
+    texrect.w = theight*_bounds.size.height/tsize.height;
+    texrect.x = _texture->getMinS()+swidth*_bounds.origin.x/tsize.width;
+    texrect.y = _texture->getMinT()+theight*(tsize.height-_bounds.getMaxY())/tsize.height;
+    texrect.x -= (_frame % _cols)*texrect.z;
+    texrect.y -= (_frame / _cols)*texrect.w;
+
+    SpriteInstance instance;
+    instance.setTransform(transform, Rect(Vec2::ZERO,getContentSize()));
+    instance.texrect = texrect;
+    instance.color = Color4f(tint);
+    instance.frame.set((float)_frame,(float)_cols);
+
+    batch->setTexture(_texture);
+    batch->setBlendEquation(_blendEquation);
+    batch->setBlendFunc(_srcFactor, _dstFactor);
+    batch->drawInstanced(instance);
+}
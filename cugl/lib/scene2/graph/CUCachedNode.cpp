@@ -0,0 +1,382 @@
+//
+//  CUCachedNode.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a scene graph node that caches the rendering of its
+//  children in an offscreen texture. Most of a level (floors, walls, props)
+//  never changes while the level is running. Yet the scene graph normally
+//  transforms and uploads all of it every frame. A cached node draws its
+//  subtree once, and then draws that subtree as a single textured quad until
+//  one of its descendants changes.
+//
+//  This class uses our standard shared-pointer architecture.
+//
+//  1. The constructor does not perform any initialization; it just sets all
+//     attributes to their defaults.
+//
+//  2. All initialization takes place via init methods, which can fail if an
+//     object is initialized more than once.
+//
+//  3. All allocation takes place via static constructors which return a shared
+//     pointer.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: agent
+//  Version: 10/19/26
+//
+#include <cugl/scene2/graph/CUCachedNode.h>
+#include <cugl/scene2/CUScene2.h>
+#include <cugl/render/CUTexture.h>
+#include <cugl/base/CUApplication.h>
+#include <algorithm>
+#include <cmath>
+
+using namespace cugl;
+using namespace cugl::scene2;
+
+/** The bytes per pixel of the cache (RGBA color and packed depth/stencil) */
+#define CACHE_PIXEL_BYTES 8
+/** The largest width or height of the cache (supported by all GPUs) */
+#define CACHE_MAX_SIZE 4096
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates an uninitialized node.
+ *
+ * You must initialize this Node before use.
+ *
+ * NEVER USE A CONSTRUCTOR WITH NEW. If you want to allocate a Node on the
+ * heap, use one of the static constructors instead.
+ */
+CachedNode::CachedNode() : SceneNode(),
+_target(nullptr),
+_cacheScale(1),
+_failWidth(0),
+_failHeight(0),
+_hits(0),
+_misses(0) {
+}
+
+/**
+ * Disposes all of the resources used by this node.
+ *
+ * A disposed Node can be safely reinitialized. Any children owned by this
+ * node will be released.  They will be deleted if no other object owns them.
+ *
+ * It is unsafe to call this on a Node that is still currently inside of
+ * a scene graph.
+ */
+void CachedNode::dispose() {
+    _target = nullptr;
+    _cacheScale = 1;
+    _failWidth  = 0;
+    _failHeight = 0;
+    _hits = 0;
+    _misses = 0;
+    SceneNode::dispose();
+}
+
+#pragma mark -
+#pragma mark Attributes
+/**
+ * Sets the color tinting this node.
+ *
+ * The tint is applied when drawing the cache, and so changing it does
+ * not invalidate the cache.
+ *
+ * @param color the color tinting this node.
+ */
+void CachedNode::setColor(Color4 color) {
+    _tintColor = color;
+    if (_parent != nullptr) {
+        _parent->setRenderDirty();
+    }
+}
+
+/**
+ * Releases the offscreen buffer storing the cache.
+ *
+ * The cache will be reallocated and redrawn the next time this node is
+ * rendered. You should call this method when a cached node is removed
+ * from the scene but not destroyed, to reclaim its GPU memory.
+ */
+void CachedNode::clearCache() {
+    _target = nullptr;
+    setRenderDirty();
+}
+
+/**
+ * Returns the offscreen texture storing the cache.
+ *
+ * This value is nullptr if this node has not been rendered since it was
+ * created (or since the last call to {@link clearCache}).
+ *
+ * @return the offscreen texture storing the cache.
+ */
+std::shared_ptr<Texture> CachedNode::getCacheTexture() const {
+    return _target == nullptr ? nullptr : _target->getTexture();
+}
+
+#pragma mark -
+#pragma mark Statistics
+/**
+ * Returns the fraction of frames drawn from the cache.
+ *
+ * If this node has not been rendered, this method returns 0.
+ *
+ * @return the fraction of frames drawn from the cache.
+ */
+float CachedNode::getHitRate() const {
+    Uint64 total = _hits+_misses;
+    return total == 0 ? 0.0f : (float)((double)_hits/total);
+}
+
+/**
+ * Returns the GPU memory used by the cache in bytes.
+ *
+ * This includes both the color buffer and the depth/stencil buffer of
+ * the offscreen render target. It is 0 if there is no cache.
+ *
+ * @return the GPU memory used by the cache in bytes.
+ */
+size_t CachedNode::getMemoryUsage() const {
+    if (_target == nullptr) {
+        return 0;
+    }
+    return (size_t)_target->getWidth()*_target->getHeight()*CACHE_PIXEL_BYTES;
+}
+
+#pragma mark -
+#pragma mark Rendering
+/**
+ * Draws this Node and all of its children with the given SpriteBatch.
+ *
+ * If the cache is up to date, this method draws it without visiting any
+ * of the children. Otherwise, it redraws the children to the cache first.
+ * This requires flushing the sprite batch, and so it should not happen
+ * often. If there is no cache, it draws the children directly.
+ *
+ * @param batch     The SpriteBatch to draw with.
+ * @param transform The global transformation matrix.
+ * @param tint      The tint to blend with the Node color.
+ */
+void CachedNode::render(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform, Color4 tint) {
+    if (!_isVisible) { return; }
+
+    Mat4 matrix;
+    Mat4::multiply(_combined,transform,&matrix);
+    if (isCulled(matrix)) { return; }
+
+    float scale = computeScale(batch, matrix);
+    if (_renderDirty || _target == nullptr || scale != _cacheScale) {
+        if (!refresh(batch, scale)) {
+            SceneNode::render(batch, transform, tint);
+            return;
+        }
+        _misses++;
+    } else {
+        _hits++;
+    }
+
+    Color4 color = _tintColor;
+    if (_hasParentColor) {
+        color *= tint;
+    }
+
+    if (_scissor) {
+        batch->pushScissor(*_scissor, matrix);
+    }
+
+    draw(batch,matrix,color);
+
+    if (_scissor) {
+        batch->popScissor();
+    }
+}
+
+/**
+ * Draws the cache via the given SpriteBatch.
+ *
+ * This method only draws the cached texture. It does not update the
+ * cache, and it draws nothing if there is no cache.
+ *
+ * @param batch     The SpriteBatch to draw with.
+ * @param transform The global transformation matrix.
+ * @param tint      The tint to blend with the Node color.
+ */
+void CachedNode::draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform, Color4 tint) {
+    if (_target == nullptr) {
+        return;
+    }
+
+    // The cache is premultiplied, so the tint must be as well
+    Color4f color = tint;
+    color.r *= color.a;
+    color.g *= color.a;
+    color.b *= color.a;
+
+    batch->setTexture(_target->getTexture());
+    batch->setBlendEquation(GL_FUNC_ADD);
+    batch->setBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    batch->setColor(color);
+    batch->fill(Rect(Vec2::ZERO,getContentSize()),Vec2::ZERO,transform);
+}
+
+#pragma mark -
+#pragma mark Internal Helpers
+/**
+ * Returns the pixels per unit of content for the cache.
+ *
+ * This is the on-screen scale of this node under the given transform and
+ * the perspective of the sprite batch, so it includes the camera zoom. It
+ * is rounded up to a power of two, so that a smooth zoom does not redraw
+ * the cache every frame. It is also limited so that the cache does not
+ * exceed the maximum texture size.
+ *
+ * @param batch     The SpriteBatch to draw with.
+ * @param transform The global transformation matrix.
+ *
+ * @return the pixels per unit of content for the cache.
+ */
+float CachedNode::computeScale(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform) const {
+    Application* app = Application::get();
+    if (app == nullptr) {
+        return 1;
+    }
+    
+    // Map the node axes to normalized device coordinates, and then to pixels
+    Mat4 screen;
+    Mat4::multiply(transform,batch->getPerspective(),&screen);
+    Size display = app->getDisplaySize();
+    Vec2 xaxis = screen.transformVector(Vec2::UNIT_X);
+    Vec2 yaxis = screen.transformVector(Vec2::UNIT_Y);
+    xaxis.x *= display.width/2;  xaxis.y *= display.height/2;
+    yaxis.x *= display.width/2;  yaxis.y *= display.height/2;
+    
+    float scale = std::max(xaxis.length(),yaxis.length());
+    if (scale <= 0) {
+        return _cacheScale;
+    }
+    scale = std::exp2(std::ceil(std::log2(scale)));
+    
+    Size size = getContentSize();
+    float extent = std::max(size.width,size.height);
+    if (extent*scale > CACHE_MAX_SIZE) {
+        scale = CACHE_MAX_SIZE/extent;
+    }
+    return scale;
+}
+
+/**
+ * Redraws the children of this node to the cache.
+ *
+ * The cache is reallocated if the content size or the scale has changed.
+ * The sprite batch is flushed before and after drawing to the cache, and
+ * all of its state is restored afterwards. Scene culling is suspended
+ * while drawing to the cache, as the cache must hold the entire subtree.
+ *
+ * The children are drawn with a separate alpha blend function (see
+ * {@link SpriteBatch#setBlendAlphaFunc}), so that the cache stores
+ * premultiplied color with the correct alpha.
+ *
+ * This method returns false if the cache could not be allocated.
+ *
+ * @param batch     The SpriteBatch to draw with.
+ * @param scale     The pixels per unit of content for the cache.
+ *
+ * @return true if the cache was redrawn
+ */
+bool CachedNode::refresh(const std::shared_ptr<SpriteBatch>& batch, float scale) {
+    Size size = getContentSize();
+    int width  = (int)std::ceil(size.width*scale);
+    int height = (int)std::ceil(size.height*scale);
+    if (width <= 0 || height <= 0) {
+        _target = nullptr;
+        clearRenderDirty();
+        return true;
+    }
+
+    if (_target == nullptr || _target->getWidth() != width || _target->getHeight() != height) {
+        // Do not retry a failed allocation every frame
+        if (width == _failWidth && height == _failHeight) {
+            _target = nullptr;
+            return false;
+        }
+        _target = RenderTarget::alloc(width,height);
+        if (_target == nullptr) {
+            CUWarn("Could not allocate a %dx%d cache; drawing children directly.",width,height);
+            _failWidth  = width;
+            _failHeight = height;
+            return false;
+        }
+        _target->setClearColor(Color4::CLEAR);
+    }
+    _cacheScale = scale;
+
+    // Save the batch state
+    Mat4 perspective = batch->getPerspective();
+    GLenum srcFactor = batch->getSourceBlendFactor();
+    GLenum dstFactor = batch->getDestinationBlendFactor();
+    GLenum equation  = batch->getBlendEquation();
+    bool separate    = batch->hasBlendAlphaFunc();
+    GLenum srcAlpha  = batch->getSourceAlphaFactor();
+    GLenum dstAlpha  = batch->getDestinationAlphaFactor();
+
+    // Flip the y axis for texture write
+    Mat4 matrix;
+    Mat4::createOrthographicOffCenter(0, size.width, 0, size.height, -1, 1, &matrix);
+    matrix.scale(1, -1, 1);
+
+    bool culling = (_graph != nullptr && _graph->_cullActive);
+    if (culling) {
+        _graph->_cullActive = false;
+    }
+
+    batch->flush();
+    _target->begin();
+    batch->setPerspective(matrix);
+    batch->setBlendAlphaFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    batch->pushScissor();
+    batch->setScissor(nullptr);
+    for(auto it = _children.begin(); it != _children.end(); ++it) {
+        (*it)->render(batch, Mat4::IDENTITY, Color4::WHITE);
+    }
+    batch->flush();
+    _target->end();
+    batch->popScissor();
+
+    if (culling) {
+        _graph->_cullActive = true;
+    }
+
+    // Restore the batch state
+    batch->setPerspective(perspective);
+    batch->setBlendFunc(srcFactor, dstFactor);
+    batch->setBlendEquation(equation);
+    if (separate) {
+        batch->setBlendAlphaFunc(srcAlpha, dstAlpha);
+    } else {
+        batch->clearBlendAlphaFunc();
+    }
+    clearRenderDirty();
+    return true;
+}
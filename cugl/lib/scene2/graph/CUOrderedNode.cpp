@@ -44,11 +44,17 @@
 //  Author: Walker White
 //  Version: 3/7/21
 #include <cugl/scene2/graph/CUOrderedNode.h>
+#include <cugl/scene2/graph/CUTexturedNode.h>
 #include <cugl/render/CUScissor.h>
+#include <algorithm>
+#include <typeinfo>
 
 using namespace cugl;
 using namespace cugl::scene2;
 
+/** The number of queue entries searched when pulling a node forward for batching */
+#define BATCH_LOOKAHEAD 32
+
 #pragma mark Context
 /**
  * Creates a drawing context with the given parent object
@@ -58,7 +64,9 @@ using namespace cugl::scene2;
 OrderedNode::Context::Context(OrderedNode* parent) :
 node(nullptr),
 scissor(nullptr),
-canonical(0) {
+canonical(0),
+textured(nullptr),
+empty(false) {
     this->parent = parent;
     tint = Color4::WHITE;
 }
@@ -70,11 +78,15 @@ canonical(0) {
  * @param copy      The drawing context to copy
  */
 OrderedNode::Context::Context(const Context& copy) {
+    parent = copy.parent;
     node = copy.node;
     scissor = copy.scissor;
     canonical = copy.canonical;
     transform = copy.transform;
     tint = copy.tint;
+    textured = copy.textured;
+    empty = copy.empty;
+    bounds = copy.bounds;
 }
 
 /**
@@ -144,7 +156,9 @@ bool OrderedNode::Context::sortCompare(Context* a, Context* b) {
  */
 OrderedNode::OrderedNode() :
 _viewport(nullptr),
-_order(PRE_ORDER) {
+_order(PRE_ORDER),
+_batching(false),
+_scissorNext(0) {
 }
 
 /**
@@ -162,7 +176,12 @@ void OrderedNode::dispose() {
         *it = nullptr;
     }
     _entries.clear();
+    _pending.clear();
+    _skipped.clear();
+    _scissorPool.clear();
+    _scissorNext = 0;
     _viewport = nullptr;
+    _batching = false;
     SceneNode::dispose();
 }
 
@@ -235,6 +254,7 @@ bool OrderedNode::initWithOrder(Order order, Rect bounds) {
  * the following additional attributes:
  *
  *      "order":    The sort order of this node.
+ *      "batching": Whether to regroup the render queue by drawing state
  *
  * Sort orders are specified as lower case strings representing the names
  * of the enum with dashes in place of underscores (e.g. "pre-order",
@@ -269,18 +289,60 @@ bool OrderedNode::initWithData(const Scene2Loader* loader, const std::shared_ptr
                 _order = Order::POST_DESCEND;
             }
         }
+        _batching = data->getBool("batching",false);
         return true;
     }
     return false;
 }
 
+/**
+ * Returns true if the given node is a render barrier.
+ *
+ * An ordered node does not visit the descendants of a barrier. Instead, it
+ * renders the barrier (and its descendants) as a single unit. Both ordered
+ * nodes and cached nodes are barriers.
+ *
+ * @param node  The node to check
+ *
+ * @return true if the given node is a render barrier.
+ */
+static bool is_barrier(const SceneNode* node) {
+    const std::string name = node->getClassName();
+    return name == "OrderedNode" || name == "CachedNode";
+}
+
+/**
+ * Returns true if the two textured nodes can be drawn in the same batch.
+ *
+ * Two nodes can be drawn together if they have the same texture, blend
+ * state, and scissor. Nodes with gradients are never batched, as the
+ * gradient is a uniform of the sprite batch.
+ *
+ * @param a     The first textured node
+ * @param b     The second textured node
+ * @param ascis The scissor of the first node
+ * @param bscis The scissor of the second node
+ *
+ * @return true if the two textured nodes can be drawn in the same batch.
+ */
+static bool can_batch(const TexturedNode* a, const TexturedNode* b,
+                      const Scissor* ascis, const Scissor* bscis) {
+    if (ascis != bscis || a->getGradient() != nullptr || b->getGradient() != nullptr) {
+        return false;
+    }
+    return (a->getTexture() == b->getTexture() &&
+            a->getSourceBlendFactor() == b->getSourceBlendFactor() &&
+            a->getDestinationBlendFactor() == b->getDestinationBlendFactor() &&
+            a->getBlendEquation() == b->getBlendEquation());
+}
+
 /**
  * Adds the given node ot the render queue.
  *
  * This method replaces {@link #render} to provide a delayed render command
  * (via a queue of {@link Context} objects). This method is recursive.
  * However, it will stop when it encounters any other {@link OrderedNode}
- * objects.
+ * or {@link CachedNode} objects.
  *
  * @param node      The descendant node to render.
  * @param transform The global transformation matrix.
@@ -291,6 +353,11 @@ void OrderedNode::visit(const std::shared_ptr<SceneNode>& node, const Mat4& tran
 
     Mat4 matrix;
     Mat4::multiply(node->getTransform(),transform,&matrix);
+    if (!is_barrier(node.get()) && node->isCulled(matrix)) {
+        // Barriers are tested when they are rendered
+        return;
+    }
+    
     Color4 color = node->getColor();
     if (node->hasRelativeColor()) {
         color *= tint;
@@ -298,19 +365,22 @@ void OrderedNode::visit(const std::shared_ptr<SceneNode>& node, const Mat4& tran
     
     // We need to capture the important sprite batch state
     std::shared_ptr<Scissor> previous = _viewport;
-    std::shared_ptr<Scissor> current = nullptr;
     if (node->getScissor()) {
-        current = Scissor::alloc(node->getScissor());
-        current->setTransform(matrix);
+        Scissor local(*node->getScissor());
+        local.setTransform(matrix);
+        std::shared_ptr<Scissor> current = acquireScissor();
         if (previous) {
-            current = previous->getIntersection(current, false);
+            current->set(*previous);
+            current->intersect(local, false);
+        } else {
+            current->set(local);
         }
         _viewport = current;
     }
     
-    // Identify pre or post. Block at child ordered nodes
+    // Identify pre or post. Block at child ordered and cached nodes
     bool ispost = (_order == POST_ORDER || _order == POST_ASCEND || _order == POST_DESCEND);
-    bool barrier = node->getClassName() == getClassName();
+    bool barrier = is_barrier(node.get());
     if (ispost && !barrier) {
         auto children = node->getChildren();
         for(auto it = children.begin(); it != children.end(); ++it) {
@@ -339,6 +409,91 @@ void OrderedNode::visit(const std::shared_ptr<SceneNode>& node, const Mat4& tran
     _viewport = previous;
 }
 
+/**
+ * Regroups the sorted render queue by drawing state.
+ *
+ * Within a bucket of equal priority, each textured node pulls forward
+ * the nodes after it that have the same texture, blend state and scissor,
+ * as long as they do not overlap (in world space) any node that they
+ * pass over. This only applies to the {@link Order#ASCEND} and
+ * {@link Order#DESCEND} orders.
+ */
+void OrderedNode::batchEntries() {
+    if (_order != ASCEND && _order != DESCEND) {
+        return;
+    }
+
+    // Classify the entries first
+    for(auto it = _entries.begin(); it != _entries.end(); ++it) {
+        Context* context = *it;
+        SceneNode* node = context->node.get();
+        context->empty = typeid(*node) == typeid(SceneNode);
+        context->textured = nullptr;
+        if (!context->empty && !is_barrier(node)) {
+            TexturedNode* textured = dynamic_cast<TexturedNode*>(node);
+            if (textured != nullptr) {
+                context->textured = textured;
+                context->bounds = context->transform.transform(node->getDrawBounds());
+            }
+        }
+    }
+
+    size_t start = 0;
+    while (start < _entries.size()) {
+        float priority = _entries[start]->node->getPriority();
+        size_t end = start+1;
+        while (end < _entries.size() && _entries[end]->node->getPriority() == priority) {
+            end++;
+        }
+        if (end-start <= 2) {
+            start = end;
+            continue;
+        }
+
+        // Greedy pass over the bucket. Placed entries are marked as nullptr.
+        _pending.assign(_entries.begin()+start, _entries.begin()+end);
+        size_t out = start;
+        for(size_t ii = 0; ii < _pending.size(); ii++) {
+            Context* head = _pending[ii];
+            if (head == nullptr) {
+                continue;
+            }
+            _entries[out++] = head;
+            _pending[ii] = nullptr;
+            if (head->textured == nullptr) {
+                continue;
+            }
+
+            _skipped.clear();
+            size_t limit = std::min(ii+1+BATCH_LOOKAHEAD, _pending.size());
+            for(size_t jj = ii+1; jj < limit; jj++) {
+                Context* next = _pending[jj];
+                if (next == nullptr || next->empty) {
+                    continue;
+                } else if (next->textured == nullptr) {
+                    // Unknown bounds, so nothing may pass it
+                    break;
+                }
+
+                bool movable = can_batch(head->textured, next->textured,
+                                         head->scissor.get(), next->scissor.get());
+                for(auto kt = _skipped.begin(); movable && kt != _skipped.end(); ++kt) {
+                    movable = !(*kt)->bounds.doesIntersect(next->bounds);
+                }
+                if (movable) {
+                    _entries[out++] = next;
+                    _pending[jj] = nullptr;
+                } else {
+                    _skipped.push_back(next);
+                }
+            }
+        }
+        start = end;
+    }
+    _pending.clear();
+    _skipped.clear();
+}
+
 /**
  * Draws this node and all of its children with the given SpriteBatch.
  *
@@ -348,6 +503,9 @@ void OrderedNode::visit(const std::shared_ptr<SceneNode>& node, const Mat4& tran
  * will bypass all calls to {@link SceneNode#render} and instead call
  * {@link SceneNode#draw}. This is why it is important for all custom
  * subclasses of SceneNode to override draw instead of render.
+ * 
+ * If batching is enabled, the sorted queue is regrouped by drawing state
+ * (see {@link #setBatching}) before it is drawn.
  *
  * @param batch     The SpriteBatch to draw with.
  * @param transform The global transformation matrix.
@@ -362,21 +520,24 @@ void OrderedNode::render(const std::shared_ptr<SpriteBatch>& batch, const Mat4&
     } else {
         Mat4 matrix;
         Mat4::multiply(_combined,transform,&matrix);
+        if (isCulled(matrix)) { return; }
+        
         Color4 color = _tintColor;
         if (_hasParentColor) {
             color *= tint;
         }
         
         // Capture sprite batch context
-        std::shared_ptr<Scissor> active = batch->getScissor();
-        _viewport = active;
         if (_scissor) {
-            std::shared_ptr<Scissor> local = Scissor::alloc(_scissor);
-            local->setTransform(matrix);
-            if (active) {
-                local = active->getIntersection(local, false);
-            }
-            _viewport = local;
+            batch->pushScissor(*_scissor, matrix);
+        } else {
+            batch->pushScissor();
+        }
+        const Scissor* active = batch->getActiveScissor();
+        _viewport = nullptr;
+        if (active) {
+            _viewport = acquireScissor();
+            _viewport->set(*active);
         }
 
         // Build and sort
@@ -385,12 +546,24 @@ void OrderedNode::render(const std::shared_ptr<SpriteBatch>& batch, const Mat4&
         }
 
         std::sort(_entries.begin(), _entries.end(), Context::sortCompare);
+        if (_batching) {
+            batchEntries();
+        }
+
+        // Setting a scissor breaks the batch, so only do it on a change
+        bool reset = true;
+        Scissor* scissor = nullptr;
         for(auto it = _entries.begin(); it != _entries.end(); ++it) {
             Context* context = *it;
-            batch->setScissor(context->scissor); // This is in render, so must be applied
-            if (context->node->getClassName() == getClassName()) {
-                // Render barrier at an ordered node
+            if (reset || context->scissor.get() != scissor) {
+                batch->setScissor(context->scissor); // This is in render, so must be applied
+                scissor = context->scissor.get();
+                reset = false;
+            }
+            if (is_barrier(context->node.get())) {
+                // Render barrier at an ordered or cached node
                 context->node->render(batch, context->transform, context->tint);
+                reset = true;
             } else {
                 context->node->draw(batch, context->transform, context->tint);
             }
@@ -403,6 +576,22 @@ void OrderedNode::render(const std::shared_ptr<SpriteBatch>& batch, const Mat4&
         }
         _entries.clear();
         _viewport = nullptr;
-        batch->setScissor(active);
+        _scissorNext = 0;
+        batch->popScissor();
+    }
+}
+
+/**
+ * Returns an unused scissor mask from the pool.
+ *
+ * The pool grows as necessary. All masks are returned to the pool at
+ * the end of {@link #render}.
+ *
+ * @return an unused scissor mask from the pool.
+ */
+std::shared_ptr<Scissor> OrderedNode::acquireScissor() {
+    if (_scissorNext == _scissorPool.size()) {
+        _scissorPool.push_back(std::make_shared<Scissor>());
     }
+    return _scissorPool[_scissorNext++];
 }
@@ -46,6 +46,7 @@
 #include <cugl/scene2/graph/CUPathNode.h>
 #include <cugl/util/CUDebug.h>
 #include <cugl/render/CUGradient.h>
+#include <algorithm>
 
 using namespace cugl::scene2;
 
@@ -67,6 +68,7 @@ _closed(true),
 _joint(poly2::Joint::NONE),
 _endcap(poly2::EndCap::NONE) {
     _classname = "PathNode";
+    _extruder.setUniform(true);
 }
 
 /**
@@ -140,6 +142,7 @@ bool PathNode::initWithPoly(const Poly2& poly, float stroke,
  *      "polygon":  An even array of polygon vertices (numbers)
  *      "indices":  An array of unsigned ints defining triangles from the
  *                  the vertices. The array size should be a multiple of 3.
+ *      "retained": Whether to draw the mesh from its own vertex buffer
  *      'stroke':   A number specifying the stroke width.
  *      'joint':    One of 'mitre', 'bevel', or 'round'.
  *      'cap':      One of 'square' or 'round'.
@@ -402,6 +405,56 @@ void PathNode::setPolygon(const Rect rect) {
 }
 
 
+/**
+ * Moves a single vertex of the path to the given position.
+ *
+ * If the path is an implicit one and the move does not change the bounds
+ * of the path, only the segments and joints adjacent to the vertex are
+ * re-extruded and patched into the mesh in place. Otherwise, this method
+ * is equivalent to resetting the polygon.
+ *
+ * @param index     The index of the vertex to move
+ * @param vertex    The new vertex position
+ */
+void PathNode::setVertex(size_t index, const Vec2 vertex) {
+    Rect bounds = _polygon.getBounds();
+    _polygon.setVertex(index, vertex);
+    if (_polygon.getBounds() != bounds || _polygon.getGeometry() != Geometry::IMPLICIT) {
+        setPolygon(_polygon);
+        return;
+    } else if (_stroke <= 0) {
+        if (_rendered) {
+            refreshRenderData(index,index+1);
+        }
+        return;
+    }
+    
+    if (_extruder.update((Uint32)index, vertex)) {
+        _extruder.updatePolygon(&_extrusion);
+    } else {
+        _extrusion.clear();
+        _extruder.getPolygon(&_extrusion);
+    }
+    _extrbounds = _extrusion.getBounds();
+    _extrbounds.origin -= _polygon.getBounds().origin;
+    // The extrusion bounds are part of the culling bounds
+    setRenderDirty();
+    if (!_rendered) {
+        return;
+    } else if (_mesh.vertices.size() != _extrusion.vertices().size() ||
+               _mesh.indices.size() != _extrusion.indices().size()) {
+        clearRenderData();
+        return;
+    }
+    
+    Uint32 vstart, vcount, istart, icount;
+    _extruder.getUpdateRange(&vstart, &vcount, &istart, &icount);
+    refreshRenderData(vstart, vstart+vcount);
+    const std::vector<Uint32>& indices = static_cast<const Poly2&>(_extrusion).indices();
+    std::copy(indices.begin()+istart, indices.begin()+istart+icount,
+              _mesh.indices.begin()+istart);
+}
+
 #pragma mark -
 #pragma mark Rendering
 /**
@@ -442,11 +495,7 @@ void PathNode::draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& trans
     }
     batch->setBlendEquation(_blendEquation);
     batch->setBlendFunc(_srcFactor, _dstFactor);
-    if (_stroke > 0) {
-        batch->fill(_mesh, transform);
-    } else {
-        batch->outline(_mesh, transform);
-    }
+    drawMesh(batch, transform);
     batch->setGradient(nullptr);
 }
 
@@ -459,10 +508,23 @@ void PathNode::generateRenderData() {
         return;
     }
     
-    const Poly2 source = (_stroke > 0 ? _extrusion : _polygon);
+    const Poly2& source = (_stroke > 0 ? _extrusion : _polygon);
     _mesh.set(source);
     _mesh.command = (_stroke > 0 ? GL_TRIANGLES : GL_LINES);
+    refreshRenderData(0,_mesh.vertices.size());
+    _rendered = true;
+}
 
+/**
+ * Recomputes the render data for the given range of vertices.
+ *
+ * @param start The first vertex to recompute
+ * @param end   The vertex after the last one to recompute
+ */
+void PathNode::refreshRenderData(size_t start, size_t end) {
+    setRenderDirty();
+    _retainedDirty = true;
+    const Poly2& source = (_stroke > 0 ? _extrusion : _polygon);
     Size nsize = getContentSize();
     Size bsize = _polygon.getBounds().size;
     Size tsize = _texture->getSize();
@@ -473,8 +535,9 @@ void PathNode::generateRenderData() {
     }
 
     Vec2 offset = _polygon.getBounds().origin;
-    for(auto it = _mesh.vertices.begin(); it != _mesh.vertices.end(); ++it) {
-        it->position *= scale;
+    for(size_t ii = start; ii < end; ii++) {
+        SpriteVertex2* it = &(_mesh.vertices[ii]);
+        it->position = source.vertices()[ii]*scale;
         if (!_absolute) {
             it->position -= offset*scale;
         }
@@ -495,8 +558,6 @@ void PathNode::generateRenderData() {
             it->color = Vec4(s,t,0,0);
         }
     }
-    
-    _rendered = true;
 }
 
 #pragma mark -
@@ -507,16 +568,16 @@ void PathNode::generateRenderData() {
 void PathNode::updateExtrusion() {
     clearRenderData();
     if (_stroke > 0) {
-        SimpleExtruder extruder;
         if (_polygon.getGeometry() == Geometry::IMPLICIT) {
-            extruder.set(_polygon.vertices(),_closed);
+            _extruder.set(_polygon.vertices(),_closed);
         } else {
-            extruder.set(_polygon);
+            _extruder.set(_polygon);
         }
-        extruder.setJoint(_joint);
-        extruder.setEndCap(_endcap);
-        extruder.calculate(_stroke);
-        extruder.getPolygon(&_extrusion);
+        _extruder.setJoint(_joint);
+        _extruder.setEndCap(_endcap);
+        _extruder.calculate(_stroke);
+        _extrusion.clear();
+        _extruder.getPolygon(&_extrusion);
         _extrbounds = _extrusion.getBounds();
         _extrbounds.origin -= _polygon.getBounds().origin;
     } else {
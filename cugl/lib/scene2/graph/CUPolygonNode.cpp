@@ -50,20 +50,15 @@ using namespace cugl::scene2;
  * Sets the texture polgon to the vertices expressed in image space.
  *
  * The polygon will be triangulated using the rules of SimpleTriangulator.
- * All PolygonNode objects share a single triangulator, so this method is
- * not thread safe.
+ * The triangulation is shared through {@link TriangulationCache}, so a
+ * repeated shape is only triangulated once.
  *
  * @param   vertices The vertices to texture
  * @param   offset   The offset in vertices
  * @param   size     The number of elements in vertices
  */
 void PolygonNode::setPolygon(const std::vector<Vec2>& vertices) {
-    _polygon.set(vertices);
-    _polygon.indices().clear();
-    _triangulator.set(vertices);
-    _triangulator.calculate();
-    _triangulator.getTriangulation(_polygon.indices());
-    _polygon.setGeometry(Geometry::SOLID);
+    TriangulationCache::get()->triangulate(vertices, &_polygon);
     TexturedNode::setPolygon(_polygon);
 }
 
@@ -133,10 +128,7 @@ void PolygonNode::draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& tr
     }
     batch->setBlendEquation(_blendEquation);
     batch->setBlendFunc(_srcFactor, _dstFactor);
-    batch->fill(_mesh, transform);
+    drawMesh(batch, transform);
     batch->setGradient(nullptr);
 }
 
-/** A triangulator for those incomplete polygons */
-cugl::SimpleTriangulator PolygonNode::_triangulator;
-
@@ -70,6 +70,10 @@ _parent(nullptr),
 _graph(nullptr),
 _zOrder(0),
 _zDirty(false),
+_renderDirty(true),
+_cullCount(0),
+_cullEmpty(true),
+_cullDirty(true),
 _priority(0),
 _childOffset(-2) {}
 
@@ -274,6 +278,11 @@ void SceneNode::dispose() {
     _hashOfName = 0;
     _zOrder = 0;
     _zDirty = false;
+    _renderDirty = true;
+    _cullBounds = Rect::ZERO;
+    _cullCount = 0;
+    _cullEmpty = true;
+    _cullDirty = true;
     _json = nullptr;
 }
 
@@ -306,6 +315,7 @@ SceneNode* SceneNode::copy(SceneNode* dst) {
     dst->_zOrder = _zOrder;
     dst->_zDirty = _zDirty;
     dst->_json = _json;
+    dst->setRenderDirty();
     return dst;
 }
 
@@ -327,6 +337,12 @@ void SceneNode::setPosition(float x, float y) {
     _combined.m[12] += (x-_position.x);
     _combined.m[13] += (y-_position.y);
     _position.set(x,y);
+    if (_graph != nullptr) {
+        _graph->setHitDirty();
+    }
+    if (_parent != nullptr) {
+        _parent->setRenderDirty();
+    }
 }
 
 /**
@@ -346,11 +362,34 @@ void SceneNode::setContentSize(const Size size) {
     _position += _anchor*(size-_contentSize);
     _contentSize.set(size);
     if (!_useTransform) updateTransform();
+    if (_graph != nullptr) {
+        _graph->setHitDirty();
+    }
+    setRenderDirty();
     if (_layout) {
         doLayout();
     }
 }
 
+/**
+ * Sets whether the node is visible.
+ *
+ * If a node is not visible, then it is not drawn.  This means that its
+ * children are not visible as well, regardless of their visibility settings.
+ * The default value is true, making the node visible.
+ *
+ * @param visible   true if the node is visible.
+ */
+void SceneNode::setVisible(bool visible) {
+    if (_isVisible != visible && _graph != nullptr) {
+        _graph->setHitDirty();
+    }
+    if (_isVisible != visible && _parent != nullptr) {
+        _parent->setRenderDirty();
+    }
+    _isVisible = visible;
+}
+
 /**
  * Sets the anchor point in percentages.
  *
@@ -502,6 +541,12 @@ void SceneNode::updateTransform() {
     }
     _combined.m[12] += _position.x-offset.x;
     _combined.m[13] += _position.y-offset.y;
+    if (_graph != nullptr) {
+        _graph->setHitDirty();
+    }
+    if (_parent != nullptr) {
+        _parent->setRenderDirty();
+    }
 }
 
 
@@ -615,7 +660,7 @@ void SceneNode::addChild(const std::shared_ptr<SceneNode>& child, int zval) {
     _children.push_back(child);
     child->setParent(this);
     child->pushScene(_graph);
-    
+    setRenderDirty();
 }
 
 /**
@@ -651,6 +696,7 @@ void SceneNode::swapChild(const std::shared_ptr<SceneNode>& child1,
         childdirty = child2->isZDirty();
     }
     setZDirty(_zDirty || child1->_zOrder != child2->_zOrder || childdirty);
+    setRenderDirty();
 }
 
 /**
@@ -672,6 +718,7 @@ void SceneNode::removeChild(unsigned int pos) {
         _children[ii]->_childOffset = ii;
     }
     _children.resize(_children.size()-1);
+    setRenderDirty();
 }
 
 /**
@@ -736,6 +783,7 @@ void SceneNode::removeAllChildren() {
     }
     _children.clear();
     _zDirty = false;
+    setRenderDirty();
 }
 
 /**
@@ -747,6 +795,12 @@ void SceneNode::removeAllChildren() {
  * @param parent    A pointer to the scene graph.
  */
 void SceneNode::pushScene(Scene2* scene) {
+    if (_graph != nullptr) {
+        _graph->setHitDirty();
+    }
+    if (scene != nullptr) {
+        scene->setHitDirty();
+    }
     setScene(scene);
     for(auto it = _children.begin(); it != _children.end(); ++it) {
         (*it)->pushScene(scene);
@@ -787,6 +841,9 @@ void SceneNode::doLayout() {
  */
 void SceneNode::setZOrder(int z) {
     _zOrder = z;
+    if (_parent != nullptr) {
+        _parent->setRenderDirty();
+    }
     
     // Notify the parent if we have a problem.
     if (_parent != nullptr && !_parent->_zDirty) {
@@ -847,6 +904,57 @@ bool SceneNode::compareNodeSibs(const std::shared_ptr<SceneNode>& a,
     (a->_zOrder == b->_zOrder && a->_childOffset < b->_childOffset);
 }
 
+/**
+ * Marks this node and all of its descendants as clean.
+ *
+ * This method is called by {@link CachedNode} after it redraws its
+ * subtree. It is the only way to clean a node.
+ */
+void SceneNode::clearRenderDirty() {
+    _renderDirty = false;
+    for(auto it = _children.begin(); it != _children.end(); ++it) {
+        (*it)->clearRenderDirty();
+    }
+}
+
+/**
+ * Recomputes the culling bounds of this subtree.
+ *
+ * This method recomputes the bounds of any dirty children (visible or
+ * not) first, so that the entire subtree is clean afterwards. This is
+ * what allows {@link #setRenderDirty} to stop at the first node whose
+ * culling bounds are already dirty.
+ */
+void SceneNode::updateCullBounds() {
+    Rect bounds = getDrawBounds();
+    bool empty = bounds.size.width <= 0 || bounds.size.height <= 0;
+    Uint32 count = 1;
+    for(auto it = _children.begin(); it != _children.end(); ++it) {
+        SceneNode* child = it->get();
+        if (child->_cullDirty) {
+            child->updateCullBounds();
+        }
+        if (!child->_isVisible) {
+            continue;
+        }
+        
+        count += child->_cullCount;
+        if (!child->_cullEmpty) {
+            Rect local = child->_combined.transform(child->_cullBounds);
+            if (empty) {
+                bounds = local;
+                empty = false;
+            } else {
+                bounds.merge(local);
+            }
+        }
+    }
+    _cullBounds = bounds;
+    _cullCount = count;
+    _cullEmpty = empty;
+    _cullDirty = false;
+}
+
 /**
  * Resorts the children of this node according to z-value.
  *
@@ -877,6 +985,10 @@ void SceneNode::sortZOrder() {
         for(auto it = _children.begin(); it != _children.end(); ++it ) {
             (*it)->sortZOrder();
         }
+        if (_graph != nullptr) {
+            _graph->setHitDirty();
+        }
+        setRenderDirty();
     }
 }
 
@@ -902,19 +1014,15 @@ void SceneNode::render(const std::shared_ptr<SpriteBatch>& batch, const Mat4& tr
     
     Mat4 matrix;
     Mat4::multiply(_combined,transform,&matrix);
+    if (isCulled(matrix)) { return; }
+    
     Color4 color = _tintColor;
     if (_hasParentColor) {
         color *= tint;
     }
     
-    std::shared_ptr<Scissor> active = batch->getScissor();
     if (_scissor) {
-        std::shared_ptr<Scissor> local = Scissor::alloc(_scissor);
-        local->setTransform(matrix);
-        if (active) {
-            local = active->getIntersection(local, false);
-        }
-        batch->setScissor(local);
+        batch->pushScissor(*_scissor, matrix);
     }
 
     draw(batch,matrix,color);
@@ -923,8 +1031,76 @@ void SceneNode::render(const std::shared_ptr<SpriteBatch>& batch, const Mat4& tr
     }
 
     if (_scissor) {
-        batch->setScissor(active);
+        batch->popScissor();
+    }
+}
+
+/**
+ * Marks the appearance of this node as changed.
+ *
+ * This method marks this node and all of its ancestors as dirty, so that
+ * any enclosing {@link CachedNode} will redraw its subtree. The setters
+ * of this class (and its subclasses) call this method automatically. You
+ * only need to call it if you change the appearance of a node in some
+ * other way, such as modifying a texture that it draws.
+ *
+ * Changes to the position, scale, or angle of a node do not change its
+ * own appearance. They mark the parent instead. Therefore moving a
+ * {@link CachedNode} (or any of its ancestors) does not invalidate the
+ * cache.
+ *
+ * This method also invalidates the culling bounds of this node and its
+ * ancestors (see {@link #getSubtreeBounds}).
+ */
+void SceneNode::setRenderDirty() {
+    // Invariant guarantees we can stop at the first dirty node
+    SceneNode* node = this;
+    while (node != nullptr && !node->_renderDirty) {
+        node->_renderDirty = true;
+        node = node->_parent;
     }
+    // The culling bounds have the same invariant, but are cleaned separately
+    node = this;
+    while (node != nullptr && !node->_cullDirty) {
+        node->_cullDirty = true;
+        node = node->_parent;
+    }
+}
+
+#pragma mark -
+#pragma mark Culling
+/**
+ * Returns true if this node and its descendants may be skipped.
+ *
+ * A subtree is culled if culling is active in its {@link Scene2} and the
+ * subtree bounds, in world space, do not overlap the visible region of the
+ * scene camera. Culling is only active while the scene is rendering, and
+ * only if it is enabled with {@link Scene2#setCulling}. A subtree with no
+ * content bounds is never culled.
+ *
+ * This method is called by {@link #render} before drawing this node. Any
+ * subclass that overrides render (or that renders its descendants in some
+ * other way) should call it as well.
+ *
+ * @param transform The global transformation matrix of this node
+ *
+ * @return true if this node and its descendants may be skipped.
+ */
+bool SceneNode::isCulled(const Mat4& transform) {
+    if (_graph == nullptr || !_graph->_cullActive) {
+        return false;
+    }
+    
+    if (_cullDirty) {
+        updateCullBounds();
+    }
+    _graph->_cullTests++;
+    if (_cullEmpty || transform.transform(_cullBounds).doesIntersect(_graph->_cullRect)) {
+        return false;
+    }
+    _graph->_cullSkips++;
+    _graph->_cullNodes += _cullCount;
+    return true;
 }
 
 /**
@@ -63,7 +63,9 @@ _srcFactor(GL_SRC_ALPHA),
 _dstFactor(GL_ONE_MINUS_SRC_ALPHA),
 _flipHorizontal(false),
 _flipVertical(false),
-_absolute(false) {
+_absolute(false),
+_retained(false),
+_retainedDirty(true) {
     _name = "TexturedNode";
 }
 
@@ -86,6 +88,9 @@ void TexturedNode::dispose() {
     _flipVertical = false;
     _polygon.clear();
     _mesh.clear();
+    _retained = false;
+    _retainedMesh = nullptr;
+    _retainedDirty = true;
     SceneNode::dispose();
 }
 
@@ -250,6 +255,7 @@ bool TexturedNode::initWithTexture(const std::shared_ptr<Texture>& texture, cons
  *      "polygon":  An even array of polygon vertices (numbers)
  *      "indices":  An array of unsigned ints defining triangles from the
  *                  the vertices. The array size should be a multiple of 3.
+ *      "retained": Whether to draw the mesh from its own vertex buffer
  *
  * All attributes are optional.  However, it is generally a good idea to
  * specify EITHER the texture or the polygon
@@ -275,6 +281,7 @@ bool TexturedNode::initWithData(const Scene2Loader* loader, const std::shared_pt
     // Set the texture (it might be null)
     const AssetManager* assets = loader->getManager();
     setTexture(assets->get<Texture>(data->getString("texture",UNKNOWN_STR)));
+    _retained = data->getBool("retained",false);
 
     // Get the geometry
     std::vector<Vec2> vertices;
@@ -386,6 +393,8 @@ void TexturedNode::shiftPolygon(float dx, float dy) {
         it->texcoord.x += dx/w;
         it->texcoord.y -= dy/h;
     }
+    _retainedDirty = true;
+    setRenderDirty();
 }
 
 /**
@@ -444,6 +453,63 @@ void TexturedNode::setGradient(const std::shared_ptr<Gradient>& gradient) {
     clearRenderData();
 }
 
+/**
+ * Sets whether to draw this node from a retained GPU mesh.
+ *
+ * Normally the render data of this node is transformed on the CPU and
+ * copied into the sprite batch every frame. A retained node instead
+ * uploads its render data once to its own {@link SpriteMesh}, and draws
+ * it with a transform uniform. Moving the node only changes the matrix.
+ * The mesh is uploaded again only when the render data changes (e.g. a
+ * new polygon, texture, or animation frame).
+ *
+ * Each retained node is a separate draw call. Hence this is only worth
+ * it for nodes with many vertices, such as large level pieces and
+ * paths. Small sprites should still be batched.
+ *
+ * This method must be called on the rendering thread, as disabling a
+ * retained node releases its vertex buffer.
+ *
+ * @param flag  Whether to draw this node from a retained GPU mesh
+ */
+void TexturedNode::setRetained(bool flag) {
+    if (_retained == flag) {
+        return;
+    }
+    _retained = flag;
+    _retainedDirty = true;
+    if (!flag) {
+        _retainedMesh = nullptr;
+    }
+    setRenderDirty();
+}
+
+/**
+ * Returns the bounding box of the content drawn by this node.
+ *
+ * This is the content bounds unless the node uses absolute positioning.
+ * In that case, the polygon keeps its offset from the node origin.
+ *
+ * @return the bounding box of the content drawn by this node.
+ */
+cugl::Rect TexturedNode::getDrawBounds() const {
+    if (!_absolute) {
+        return SceneNode::getDrawBounds();
+    }
+    
+    // Absolute vertices are scaled, but not translated
+    Size nsize = getContentSize();
+    Rect bounds = _polygon.getBounds();
+    Vec2 origin = bounds.origin;
+    if (bounds.size.width > 0) {
+        origin.x *= nsize.width/bounds.size.width;
+    }
+    if (bounds.size.height > 0) {
+        origin.y *= nsize.height/bounds.size.height;
+    }
+    return Rect(origin,nsize);
+}
+
 
 #pragma mark -
 #pragma mark Internal Helpers
@@ -459,6 +525,19 @@ void TexturedNode::generateRenderData() {
     
     _mesh.set(_polygon);
     _mesh.command = _polygon.getGeometry().glCommand();
+    refreshRenderData(0,_mesh.vertices.size());
+    _rendered = true;
+}
+
+/**
+ * Recomputes the render data for the given range of vertices.
+ *
+ * @param start The first vertex to recompute
+ * @param end   The vertex after the last one to recompute
+ */
+void TexturedNode::refreshRenderData(size_t start, size_t end) {
+    _retainedDirty = true;
+    setRenderDirty();
     Size nsize = getContentSize();
     Size bsize = _polygon.getBounds().size;
     Size tsize = _texture->getSize();
@@ -472,9 +551,16 @@ void TexturedNode::generateRenderData() {
         const Vec2 offset = _polygon.getBounds().origin;
         shift.translate(-offset.x,-offset.y,0);
     }
-    _mesh *= shift;
+    for(size_t ii = start; ii < end; ii++) {
+        _mesh.vertices[ii].position = _polygon.vertices()[ii];
+    }
+    if (start < end) {
+        const size_t stride = sizeof(SpriteVertex2)/sizeof(float);
+        float* positions = &(_mesh.vertices[start].position.x);
+        Mat4::transform2(shift, positions, stride, positions, stride, end-start);
+    }
 
-    for(size_t ii = 0; ii < _polygon.vertices().size(); ii++) {
+    for(size_t ii = start; ii < end; ii++) {
         const Vec2 pos = _polygon.vertices()[ii];
         float s = pos.x/tsize.width;
         float t = pos.y/tsize.height;
@@ -494,8 +580,6 @@ void TexturedNode::generateRenderData() {
             _mesh.vertices[ii].color = Vec4(s,t,0,0);
         }
     }
-    
-    _rendered = true;
 }
 
 /**
@@ -504,7 +588,8 @@ void TexturedNode::generateRenderData() {
 void TexturedNode::clearRenderData() {
     _mesh.clear();
     _rendered = false;
-    
+    _retainedDirty = true;
+    setRenderDirty();
 }
 
 /**
@@ -515,6 +600,8 @@ void TexturedNode::clearRenderData() {
  * of the texture.
  */
 void TexturedNode::updateTextureCoords() {
+    setRenderDirty();
+    _retainedDirty = true;
     if (!_rendered) {
         return;
     }
@@ -533,3 +620,34 @@ void TexturedNode::updateTextureCoords() {
     }
 }
 
+
+/**
+ * Draws the render data via the given SpriteBatch.
+ *
+ * The render data is filled if it is triangulated, and outlined
+ * otherwise. If this node is retained, the render data is drawn from the
+ * retained mesh, which is (re)uploaded first if necessary.
+ *
+ * @param batch     The SpriteBatch to draw with.
+ * @param transform The global transformation matrix.
+ */
+void TexturedNode::drawMesh(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform) {
+    if (!_retained) {
+        if (_mesh.command == GL_TRIANGLES) {
+            batch->fill(_mesh, transform);
+        } else {
+            batch->outline(_mesh, transform);
+        }
+        return;
+    } else if (_mesh.vertices.empty()) {
+        return;
+    }
+
+    if (_retainedMesh == nullptr) {
+        _retainedMesh = SpriteMesh::alloc(_mesh);
+    } else if (_retainedDirty) {
+        _retainedMesh->setMesh(_mesh);
+    }
+    _retainedDirty = false;
+    batch->draw(_retainedMesh, transform);
+}
@@ -44,6 +44,7 @@
 #include <cugl/assets/CUScene2Loader.h>
 #include <cugl/assets/CUAssetManager.h>
 #include <cugl/render/CUGradient.h>
+#include <cugl/math/polygon/CUTriangulationCache.h>
 
 using namespace cugl;
 using namespace cugl::scene2;
@@ -112,6 +113,7 @@ bool WireNode::initWithTraversal(const std::vector<Vec2>& vertices, poly2::Trave
  *      "traveral": One of 'open', 'closed', or 'interior'
  *      "indices":  An array of unsigned ints defining triangles from the
  *                  the vertices. The array size should be a multiple of 3.
+ *      "retained": Whether to draw the mesh from its own vertex buffer
  *
  * All attributes are optional.  However, it is generally a good idea to
  * specify EITHER the texture or the polygon.  If you specify the indices,
@@ -263,10 +265,7 @@ void WireNode::setTraversal(poly2::Traversal traversal) {
 void WireNode::setPolygon(const std::vector<Vec2>& vertices) {
     _source.clear();
     if (_traversal == poly2::Traversal::INTERIOR) {
-        SimpleTriangulator triang;
-        triang.set(vertices);
-        triang.calculate();
-        _source = triang.getPolygon();
+        TriangulationCache::get()->triangulate(vertices, &_source);
     } else {
         _source.set(vertices);
     }
@@ -347,6 +346,39 @@ void WireNode::setPolygon(const Rect rect) {
     _mesh.command = _polygon.getGeometry().glCommand();
 }
 
+/**
+ * Moves a single vertex of the source polygon to the given position.
+ *
+ * This method is designed for wireframes that are edited every frame.
+ * If the traversal is open or closed on an implicit source, the vertex
+ * is moved in the existing mesh in place, provided that the move does
+ * not change the bounds of the wireframe. Otherwise, this method
+ * recomputes the traversal. An interior traversal keeps its original
+ * triangulation.
+ *
+ * @param index     The index of the vertex to move
+ * @param vertex    The new vertex position
+ */
+void WireNode::setVertex(size_t index, const Vec2 vertex) {
+    _source.setVertex(index, vertex);
+    bool inplace = _source.getGeometry() == Geometry::IMPLICIT;
+    inplace = inplace && (_traversal == poly2::Traversal::OPEN || _traversal == poly2::Traversal::CLOSED);
+    inplace = inplace && _polygon.vertices().size() == _source.vertices().size();
+    if (!inplace) {
+        Poly2 source(_source);
+        setPolygon(source);
+        return;
+    }
+    
+    Rect bounds = _polygon.getBounds();
+    _polygon.setVertex(index, vertex);
+    if (_polygon.getBounds() != bounds) {
+        setContentSize(_polygon.getBounds().size);
+    } else if (_rendered) {
+        refreshRenderData(index,index+1);
+    }
+}
+
 #pragma mark -
 #pragma mark Rendering
 /**
@@ -387,7 +419,7 @@ void WireNode::draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& trans
     }
     batch->setBlendEquation(_blendEquation);
     batch->setBlendFunc(_srcFactor, _dstFactor);
-    batch->outline(_mesh, transform);
+    drawMesh(batch, transform);
     batch->setGradient(nullptr);
 
 }
@@ -503,6 +503,7 @@ void Button::setColor(Color4 color) {
     _upcolor = color;
     if (!_down || _downnode) {
         _tintColor = color;
+        setRenderDirty();
     }
 }
 
@@ -526,20 +527,13 @@ void Button::setPushable(const Poly2& bounds) {
  * The pushable region is the area of this node that responds to mouse
  * clicks.  By allowing it to be an arbitrary polygon, we are capable of
  * defining buttons with complex shapes. The vertices will be converted
- * into a polygon using {@link SimpleTriangulator}.
+ * into a polygon using {@link SimpleTriangulator}, through the shared
+ * {@link TriangulationCache}.
  *
  * @param vertices  The region responding to mouse clicks.
  */
 void Button::setPushable(const std::vector<Vec2>& vertices) {
-    _bounds.set(vertices);
-    _bounds.indices().clear();
-    
-    SimpleTriangulator triangulator;
-    triangulator.set(vertices);
-    triangulator.calculate();
-    triangulator.getTriangulation(_bounds.indices());
-    
-    _bounds.setGeometry(Geometry::SOLID);
+    TriangulationCache::get()->triangulate(vertices, &_bounds);
 }
 
 #pragma mark -
@@ -574,6 +568,7 @@ void Button::setDown(bool down) {
     } else if (!down) {
         _tintColor = _upcolor;
     }
+    setRenderDirty();
     
     for(auto it = _listeners.begin(); it != _listeners.end(); ++it) {
         it->second(getName(),down);
@@ -59,9 +59,13 @@ using namespace cugl::scene2;
 Label::Label() : SceneNode(),
 _foreground(Color4::BLACK),
 _background(Color4::CLEAR),
+_outlineWidth(0),
+_outlineColor(Color4::CLEAR),
+_shadowColor(Color4::CLEAR),
 _halign(HAlign::LEFT),
 _valign(VAlign::BOTTOM),
 _rendered(false),
+_generation(0),
 _blendEquation(GL_FUNC_ADD),
 _srcFactor(GL_SRC_ALPHA),
 _dstFactor(GL_ONE_MINUS_SRC_ALPHA)
@@ -82,6 +86,10 @@ void Label::dispose() {
     _font = nullptr;
     _foreground = Color4::BLACK;
     _background = Color4::CLEAR;
+    _outlineWidth = 0;
+    _outlineColor = Color4::CLEAR;
+    _shadowOffset = Vec2::ZERO;
+    _shadowColor  = Color4::CLEAR;
     _halign = HAlign::LEFT;
     _valign = VAlign::BOTTOM;
     _padding = Vec2::ZERO;
@@ -157,6 +165,8 @@ bool Label::initWithText(const std::string& text, const std::shared_ptr<Font>& f
  *      "foreground":   A four-element integer array. Values should be 0..255
  *      "background":   A four-element integer array. Values should be 0..255
  *      "padding":      A two-element float array.
+ *      "outline":      A five-element array of the width and color (0..255)
+ *      "shadow":       A six-element array of the offset and color (0..255)
  *      "halign":       One of 'left', 'center', 'right', 'hard left',
  *                      'true center' and 'hard right'.
  *      "valign":       One of 'top', 'middle', 'bottom', 'hard top',
@@ -219,6 +229,27 @@ bool Label::initWithData(const Scene2Loader* loader, const std::shared_ptr<JsonV
 
     if (update) { updateColor(); }
 
+    if (data->has("outline")) {
+        JsonValue* line = data->get("outline").get();
+        CUAssertLog(line->size() == 5, "'outline' must be a 5-element array");
+        _outlineWidth = line->get(0)->asFloat(0.0f);
+        _outlineColor.r = line->get(1)->asInt(0);
+        _outlineColor.g = line->get(2)->asInt(0);
+        _outlineColor.b = line->get(3)->asInt(0);
+        _outlineColor.a = line->get(4)->asInt(0);
+    }
+
+    if (data->has("shadow")) {
+        JsonValue* shade = data->get("shadow").get();
+        CUAssertLog(shade->size() == 6, "'shadow' must be a 6-element array");
+        _shadowOffset.x = shade->get(0)->asFloat(0.0f);
+        _shadowOffset.y = shade->get(1)->asFloat(0.0f);
+        _shadowColor.r = shade->get(2)->asInt(0);
+        _shadowColor.g = shade->get(3)->asInt(0);
+        _shadowColor.b = shade->get(4)->asInt(0);
+        _shadowColor.a = shade->get(5)->asInt(0);
+    }
+
     if (data->has("padding")) {
         JsonValue* pad = data->get("padding").get();
         CUAssertLog(pad->size() == 2, "'padding' must be a 2-element array");
@@ -307,6 +338,9 @@ void Label::setText(const std::string& text, bool resize) {
         setContentSize(_textbounds.size);
     }
     clearRenderData();
+    
+    // Rasterize any new glyphs before the next draw
+    _font->prefetch(_text);
 }
 
 /**
@@ -515,6 +549,10 @@ void Label::setBackground(Color4 color) {
  * @param tint      The tint to blend with the Node color.
  */
 void Label::draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transform, Color4 tint) {
+    // The font may have replaced the glyphs in the mesh
+    if (_rendered && _generation != _font->getGeneration()) {
+        clearRenderData();
+    }
     if (!_rendered) {
         generateRenderData();
     }
@@ -528,7 +566,17 @@ void Label::draw(const std::shared_ptr<SpriteBatch>& batch, const Mat4& transfor
     }
     batch->setTexture(_texture);
     batch->setColor(tint);
-    batch->fill(_mesh, transform);
+    if (_font->hasDistanceField()) {
+        // Distance units put the full spread at 0.5
+        float width = _outlineWidth/(2.0f*_font->getDistanceSpread());
+        batch->setDistanceField(true);
+        batch->setOutline(std::min(width, 0.5f), tint*_outlineColor);
+        batch->setShadow(_shadowOffset, tint*_shadowColor);
+        batch->fill(_mesh, transform);
+        batch->setDistanceField(false);
+    } else {
+        batch->fill(_mesh, transform);
+    }
 }
 
 
@@ -562,6 +610,7 @@ void Label::generateRenderData() {
 
     // Glyphs are defined by _textbounds, regardless of alignment
     _texture = _font->getMesh(_text, _textbounds.origin, _mesh);
+    _generation = _font->getGeneration();
     for(auto it = _mesh.vertices.begin(); it != _mesh.vertices.end(); ++it) {
         it->color = _foreground;
     }
@@ -576,6 +625,7 @@ void Label::clearRenderData() {
     _mesh.clear();
     _mesh.command = GL_TRIANGLES;
     _rendered = false;
+    setRenderDirty();
 }
 
 /**
@@ -585,6 +635,7 @@ void Label::clearRenderData() {
  * colors.
  */
 void Label::updateColor() {
+    setRenderDirty();
     if (!_rendered) {
         return;
     }
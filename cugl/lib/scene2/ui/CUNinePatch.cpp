@@ -361,6 +361,7 @@ void NinePatch::clearRenderData() {
     _mesh.clear();
     _indices.clear();
     _rendered = false;
+    setRenderDirty();
 }
 
 /**
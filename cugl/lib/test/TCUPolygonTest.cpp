@@ -0,0 +1,291 @@
+//
+//  TCUPolygonTest.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module is a unit test suite for the polygon tools (clipping and
+//  triangulation). These tests check the results against known areas, so
+//  they catch tools that produce plausible-looking but incorrect geometry.
+//
+//  These test classes only use asserts and have no graphical side-effects.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: agent
+//  Version: 10/19/26
+
+#include "TCUPolygonTest.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <cugl/util/CUDebug.h>
+#include <cugl/math/CUPoly2.h>
+#include <cugl/math/polygon/CUPolyClipper.h>
+#include <cugl/math/polygon/CUSimpleTriangulator.h>
+
+using namespace cugl;
+
+/** The tolerance for comparing computed areas */
+#define AREA_EPSILON 0.05f
+
+/**
+ * Returns the total area of the triangles in a SOLID polygon
+ *
+ * Triangles are summed by absolute value, so overlapping triangles are
+ * counted twice and inflate the area.
+ *
+ * @param poly  The triangulated polygon
+ *
+ * @return the total area of the triangles in a SOLID polygon
+ */
+static float solid_area(const Poly2& poly) {
+    const std::vector<Vec2>& verts = poly.vertices();
+    const std::vector<Uint32>& indx = poly.indices();
+    float result = 0;
+    for(size_t ii = 0; ii+2 < indx.size(); ii += 3) {
+        Vec2 e1 = verts[indx[ii+1]]-verts[indx[ii]];
+        Vec2 e2 = verts[indx[ii+2]]-verts[indx[ii]];
+        result += fabsf(e1.cross(e2))/2;
+    }
+    return result;
+}
+
+/**
+ * Returns the vertices of the axis-aligned rectangle, counter-clockwise
+ *
+ * @param x     The left edge
+ * @param y     The bottom edge
+ * @param w     The width
+ * @param h     The height
+ *
+ * @return the vertices of the axis-aligned rectangle, counter-clockwise
+ */
+static std::vector<Vec2> rect_path(float x, float y, float w, float h) {
+    std::vector<Vec2> result;
+    result.push_back(Vec2(x,  y));
+    result.push_back(Vec2(x+w,y));
+    result.push_back(Vec2(x+w,y+h));
+    result.push_back(Vec2(x,  y+h));
+    return result;
+}
+
+/**
+ * Returns the signed area of a closed path (positive if counter-clockwise)
+ *
+ * @param path  The vertices of the path
+ *
+ * @return the signed area of a closed path
+ */
+static float path_area(const std::vector<Vec2>& path) {
+    float result = 0;
+    for(size_t ii = 0; ii < path.size(); ii++) {
+        result += path[ii].cross(path[(ii+1) % path.size()]);
+    }
+    return result/2;
+}
+
+/**
+ * Returns a star with the given number of points, counter-clockwise
+ *
+ * Every other vertex is a reflex vertex, so ear clipping and monotone
+ * partitioning both have real work to do.
+ *
+ * @param points    The number of points of the star
+ *
+ * @return a star with the given number of points, counter-clockwise
+ */
+static std::vector<Vec2> star_path(Uint32 points) {
+    std::vector<Vec2> result;
+    for(Uint32 ii = 0; ii < 2*points; ii++) {
+        float angle  = (float)M_PI*ii/points;
+        float radius = (ii % 2) ? 4.0f : 10.0f;
+        result.push_back(Vec2(radius*cosf(angle),radius*sinf(angle)));
+    }
+    return result;
+}
+
+/**
+ * Returns a comb with the given number of teeth, counter-clockwise
+ *
+ * A comb has many local maxima, which forces the monotone partition to
+ * add diagonals.
+ *
+ * @param teeth The number of teeth of the comb
+ *
+ * @return a comb with the given number of teeth, counter-clockwise
+ */
+static std::vector<Vec2> comb_path(Uint32 teeth) {
+    std::vector<Vec2> result;
+    result.push_back(Vec2(0,0));
+    result.push_back(Vec2(2.0f*teeth-1,0));
+    for(Uint32 ii = teeth; ii > 0; ii--) {
+        result.push_back(Vec2(2.0f*ii-1,5));
+        result.push_back(Vec2(2.0f*ii-2,5));
+        if (ii > 1) {
+            result.push_back(Vec2(2.0f*ii-2,1));
+            result.push_back(Vec2(2.0f*ii-3,1));
+        }
+    }
+    return result;
+}
+
+/**
+ * Returns true if the indices are a valid triangulation of the path
+ *
+ * A valid triangulation has n-2 triangles for n vertices (the paths in
+ * this test have no colinear vertices), all indices in range, no
+ * degenerate triangles, a single orientation, and the same area as
+ * the path.
+ *
+ * @param path      The vertices of the path
+ * @param indices   The triangulation indices
+ *
+ * @return true if the indices are a valid triangulation of the path
+ */
+static bool valid_triangulation(const std::vector<Vec2>& path, const std::vector<Uint32>& indices) {
+    if (indices.size() != 3*(path.size()-2)) {
+        return false;
+    }
+    float total = 0;
+    float sign  = 0;
+    for(size_t ii = 0; ii < indices.size(); ii += 3) {
+        if (indices[ii] >= path.size() || indices[ii+1] >= path.size() || indices[ii+2] >= path.size()) {
+            return false;
+        }
+        Vec2 e1 = path[indices[ii+1]]-path[indices[ii]];
+        Vec2 e2 = path[indices[ii+2]]-path[indices[ii]];
+        float area = e1.cross(e2)/2;
+        if (fabsf(area) < CU_MATH_EPSILON || (sign != 0 && area*sign < 0)) {
+            return false;
+        }
+        sign = area;
+        total += fabsf(area);
+    }
+    return fabsf(total-fabsf(path_area(path))) < AREA_EPSILON;
+}
+
+
+#pragma mark -
+#pragma mark SimpleTriangulator
+/**
+ * Unit test for the monotone and ear clipping triangulation of SimpleTriangulator
+ */
+void cugl::testTriangulation() {
+    CULog("Running tests for SimpleTriangulator.\n");
+
+    std::vector<std::vector<Vec2>> paths;
+    paths.push_back(rect_path(0,0,10,10));
+    paths.push_back(star_path(5));
+    paths.push_back(star_path(64));
+    paths.push_back(comb_path(3));
+    paths.push_back(comb_path(50));
+
+    // Clockwise input must triangulate as well
+    paths.push_back(comb_path(8));
+    std::reverse(paths.back().begin(),paths.back().end());
+
+    SimpleTriangulator triangulator;
+    std::vector<Uint32> indices;
+    for(size_t ii = 0; ii < paths.size(); ii++) {
+        triangulator.setEarClipping(false);
+        triangulator.set(paths[ii]);
+        indices.clear();
+        triangulator.calculate();
+        triangulator.getTriangulation(indices);
+        CUAssertLog(valid_triangulation(paths[ii],indices), "Monotone triangulation of path %zu failed", ii);
+
+        triangulator.setEarClipping(true);
+        triangulator.set(paths[ii]);
+        indices.clear();
+        triangulator.calculate();
+        triangulator.getTriangulation(indices);
+        CUAssertLog(valid_triangulation(paths[ii],indices), "Ear clipping triangulation of path %zu failed", ii);
+    }
+
+    CULog("SimpleTriangulator tests complete.\n");
+}
+
+
+#pragma mark -
+#pragma mark PolyClipper
+/**
+ * Unit test for the boolean and offset operations of PolyClipper
+ */
+void cugl::testPolyClipper() {
+    CULog("Running tests for PolyClipper.\n");
+
+#pragma mark Boolean Test
+    PolyClipper clipper;
+    clipper.setSubject(rect_path(0,0,10,10));
+    clipper.setClip(rect_path(5,0,10,10));
+
+    clipper.calculate(poly2::ClipType::UNION);
+    CUAssertLog(fabsf(solid_area(clipper.getPolygon())-150) < AREA_EPSILON, "Method calculate(UNION) failed");
+    CUAssertLog(clipper.getPaths().size() == 1,  "Method calculate(UNION) failed");
+
+    clipper.calculate(poly2::ClipType::INTERSECTION);
+    CUAssertLog(fabsf(solid_area(clipper.getPolygon())-50) < AREA_EPSILON, "Method calculate(INTERSECTION) failed");
+
+    clipper.calculate(poly2::ClipType::DIFFERENCE);
+    CUAssertLog(fabsf(solid_area(clipper.getPolygon())-50) < AREA_EPSILON, "Method calculate(DIFFERENCE) failed");
+
+    clipper.calculate(poly2::ClipType::XOR);
+    CUAssertLog(fabsf(solid_area(clipper.getPolygon())-100) < AREA_EPSILON, "Method calculate(XOR) failed");
+    CUAssertLog(clipper.getPaths().size() == 2,  "Method calculate(XOR) failed");
+
+#pragma mark Offset Test
+    clipper.clear();
+    clipper.setJoint(poly2::Joint::MITRE);
+    clipper.setSubject(rect_path(0,0,10,10));
+    clipper.calculateOffset(-1);
+    CUAssertLog(fabsf(solid_area(clipper.getPolygon())-64) < AREA_EPSILON, "Method calculateOffset() failed");
+    CUAssertLog(clipper.getPaths().size() == 1, "Method calculateOffset() failed");
+
+    clipper.calculateOffset(1);
+    CUAssertLog(fabsf(solid_area(clipper.getPolygon())-144) < AREA_EPSILON, "Method calculateOffset() failed");
+    CUAssertLog(clipper.getPaths().size() == 1, "Method calculateOffset() failed");
+
+    // A SOLID subject is a set of triangles, and must be offset as one shape
+    Poly2 solid(Rect(0,0,10,10));
+    CUAssertLog(solid.getGeometry() == Geometry::SOLID, "Poly2 constructor failed");
+    clipper.setSubject(solid);
+    clipper.calculateOffset(-1);
+    CUAssertLog(fabsf(solid_area(clipper.getPolygon())-64) < AREA_EPSILON, "Method calculateOffset() failed for SOLID");
+    CUAssertLog(clipper.getPaths().size() == 1, "Method calculateOffset() failed for SOLID");
+
+    // Overlapping subjects are merged before the offset
+    clipper.setSubject(rect_path(0,0,10,10));
+    clipper.addSubject(rect_path(5,0,10,10));
+    clipper.calculateOffset(1);
+    CUAssertLog(fabsf(solid_area(clipper.getPolygon())-204) < AREA_EPSILON, "Method calculateOffset() failed for overlap");
+    CUAssertLog(clipper.getPaths().size() == 1, "Method calculateOffset() failed for overlap");
+
+    CULog("PolyClipper tests complete.\n");
+}
+
+
+#pragma mark -
+#pragma mark Master Test
+/**
+ * Master unit test that invokes all others in this module.
+ */
+void cugl::polygonUnitTest() {
+    testTriangulation();
+    testPolyClipper();
+}
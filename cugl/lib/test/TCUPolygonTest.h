@@ -0,0 +1,55 @@
+//
+//  TCUPolygonTest.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module is a unit test suite for the polygon tools (clipping and
+//  triangulation). These tests check the results against known areas, so
+//  they catch tools that produce plausible-looking but incorrect geometry.
+//
+//  These test classes only use asserts and have no graphical side-effects.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: agent
+//  Version: 10/19/26
+
+#ifndef __T_CU_POLYGON_TEST_H__
+#define __T_CU_POLYGON_TEST_H__
+
+namespace cugl {
+
+/**
+ * Unit test for the monotone and ear clipping triangulation of SimpleTriangulator
+ */
+void testTriangulation();
+
+/**
+ * Unit test for the boolean and offset operations of PolyClipper
+ */
+void testPolyClipper();
+
+/**
+ * Master unit test that invokes all others in this module.
+ */
+void polygonUnitTest();
+
+}
+
+#endif /* __T_CU_POLYGON_TEST_H__ */
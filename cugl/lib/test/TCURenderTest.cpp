@@ -0,0 +1,132 @@
+//
+//  TCURenderTest.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module is a unit test suite for the state management of the render
+//  classes, such as the scissor stack of a sprite batch. These tests create
+//  OpenGL objects, and so they must run after the application has started.
+//
+//  These test classes only use asserts and have no graphical side-effects.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: agent
+//  Version: 10/19/26
+
+#include "TCURenderTest.h"
+#include <memory>
+#include <cugl/util/CUDebug.h>
+#include <cugl/math/CURect.h>
+#include <cugl/render/CUScissor.h>
+#include <cugl/render/CUSpriteBatch.h>
+
+using namespace cugl;
+
+/**
+ * Returns the region of a scissor mask in world space
+ *
+ * Scissor masks may store the same region with different bounds and
+ * transforms, so masks must be compared by their region.
+ *
+ * @param mask  The scissor mask
+ *
+ * @return the region of a scissor mask in world space
+ */
+static Rect mask_region(const Scissor& mask) {
+    return mask.getTransform().transform(mask.getBounds());
+}
+
+
+#pragma mark -
+#pragma mark Scissor Stack
+/**
+ * Unit test for the push and pop operations of the SpriteBatch scissor stack
+ */
+void cugl::testScissorStack() {
+    CULog("Running tests for the scissor stack.\n");
+
+    std::shared_ptr<Scissor> outer = Scissor::alloc(Rect(0,0,100,100));
+    std::shared_ptr<Scissor> inner = Scissor::alloc(Rect(50,50,100,100));
+
+#pragma mark Intersection Test
+    Scissor both = outer->getIntersection(*inner,false);
+    CUAssertLog(mask_region(both) == Rect(50,50,50,50),     "Method getIntersection() failed");
+    CUAssertLog(mask_region(*outer) == Rect(0,0,100,100),   "Method getIntersection() modified the mask");
+
+#pragma mark Push Test
+    std::shared_ptr<SpriteBatch> batch = SpriteBatch::alloc();
+    CUAssertLog(batch != nullptr,                   "SpriteBatch allocation failed");
+    CUAssertLog(batch->getScissorDepth() == 0,      "SpriteBatch allocation failed");
+    CUAssertLog(batch->getActiveScissor() == nullptr, "SpriteBatch allocation failed");
+
+    batch->pushScissor(*outer);
+    CUAssertLog(batch->getScissorDepth() == 1,      "Method pushScissor() failed");
+    CUAssertLog(mask_region(*batch->getActiveScissor()) == Rect(0,0,100,100), "Method pushScissor() failed");
+
+    batch->pushScissor(*inner);
+    CUAssertLog(batch->getScissorDepth() == 2,      "Method pushScissor() failed");
+    CUAssertLog(mask_region(*batch->getActiveScissor()) == Rect(50,50,50,50), "Method pushScissor() did not intersect");
+
+    // Saving the mask allows it to be replaced and restored
+    batch->pushScissor();
+    CUAssertLog(batch->getScissorDepth() == 3,      "Method pushScissor() failed");
+    CUAssertLog(mask_region(*batch->getActiveScissor()) == Rect(50,50,50,50), "Method pushScissor() changed the mask");
+    batch->setScissor(nullptr);
+    CUAssertLog(batch->getActiveScissor() == nullptr, "Method setScissor() failed");
+    CUAssertLog(batch->getScissorDepth() == 3,      "Method setScissor() changed the depth");
+
+    // Deep stacks must grow without losing the masks below them
+    for(int ii = 0; ii < 64; ii++) {
+        batch->pushScissor(*outer);
+    }
+    CUAssertLog(batch->getScissorDepth() == 67,     "Method pushScissor() failed to grow");
+    for(int ii = 0; ii < 64; ii++) {
+        batch->popScissor();
+    }
+
+#pragma mark Pop Test
+    batch->popScissor();
+    CUAssertLog(batch->getScissorDepth() == 2,      "Method popScissor() failed");
+    CUAssertLog(mask_region(*batch->getActiveScissor()) == Rect(50,50,50,50), "Method popScissor() failed");
+
+    batch->popScissor();
+    CUAssertLog(mask_region(*batch->getActiveScissor()) == Rect(0,0,100,100), "Method popScissor() failed");
+
+    batch->popScissor();
+    CUAssertLog(batch->getScissorDepth() == 0,      "Method popScissor() failed");
+    CUAssertLog(batch->getActiveScissor() == nullptr, "Method popScissor() failed");
+
+    // An unbalanced pop must leave the stack empty
+    batch->popScissor();
+    CUAssertLog(batch->getScissorDepth() == 0,      "Method popScissor() failed on an empty stack");
+    batch->dispose();
+
+    CULog("Scissor stack tests complete.\n");
+}
+
+
+#pragma mark -
+#pragma mark Master Test
+/**
+ * Master unit test that invokes all others in this module.
+ */
+void cugl::renderUnitTest() {
+    testScissorStack();
+}
@@ -0,0 +1,185 @@
+//
+//  TCUScene2Test.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module is a unit test suite for the bookkeeping of the scene graph,
+//  such as the cached bounds used for culling and the dirty flags used by
+//  cached nodes. These are invisible when they are correct, but cause nodes
+//  to vanish or freeze when they are stale.
+//
+//  These test classes only use asserts and have no graphical side-effects.
+//  The cached node tests create OpenGL objects, and so they must run after
+//  the application has started.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: agent
+//  Version: 10/19/26
+
+#include "TCUScene2Test.h"
+#include <memory>
+#include <vector>
+#include <cugl/util/CUDebug.h>
+#include <cugl/math/CURect.h>
+#include <cugl/render/CUSpriteBatch.h>
+#include <cugl/render/CUTexture.h>
+#include <cugl/scene2/graph/CUSceneNode.h>
+#include <cugl/scene2/graph/CUCachedNode.h>
+#include <cugl/scene2/graph/CUAnimationNode.h>
+#include <cugl/scene2/graph/CUPathNode.h>
+#include <cugl/scene2/graph/CUWireNode.h>
+
+using namespace cugl;
+using namespace cugl::scene2;
+
+/**
+ * Returns a node with the given bounds in its parent space
+ *
+ * The node has the default (bottom left) anchor, so scaling the node keeps
+ * the origin of the bounds fixed.
+ *
+ * @param bounds    The bounds of the node in its parent space
+ *
+ * @return a node with the given bounds in its parent space
+ */
+static std::shared_ptr<SceneNode> make_node(const Rect bounds) {
+    std::shared_ptr<SceneNode> result = SceneNode::alloc();
+    result->setContentSize(bounds.size);
+    result->setPosition(bounds.origin);
+    return result;
+}
+
+#pragma mark -
+#pragma mark Culling
+/**
+ * Unit test for the invalidation of the subtree bounds used in culling
+ */
+void cugl::testCullBounds() {
+    CULog("Running tests for culling bounds.\n");
+
+    std::shared_ptr<SceneNode> root  = make_node(Rect(0,0,10,10));
+    std::shared_ptr<SceneNode> child = make_node(Rect(20,20,5,5));
+    std::shared_ptr<SceneNode> leaf  = make_node(Rect(0,40,1,1));
+    CUAssertLog(root->getSubtreeBounds() == Rect(0,0,10,10), "Method getSubtreeBounds() failed");
+
+#pragma mark Child Test
+    root->addChild(child);
+    CUAssertLog(root->getSubtreeBounds() == Rect(0,0,25,25), "Method addChild() did not update bounds");
+
+    child->setPosition(Vec2(30,0));
+    CUAssertLog(root->getSubtreeBounds() == Rect(0,0,35,10), "Method setPosition() did not update bounds");
+
+    child->setScale(2);
+    CUAssertLog(root->getSubtreeBounds() == Rect(0,0,40,10), "Method setScale() did not update bounds");
+    child->setScale(1);
+
+    child->setContentSize(Size(5,15));
+    CUAssertLog(root->getSubtreeBounds() == Rect(0,0,35,15), "Method setContentSize() did not update bounds");
+    child->setContentSize(Size(5,5));
+
+#pragma mark Descendant Test
+    // Changes to a grandchild must reach the root, even after the root is clean
+    child->addChild(leaf);
+    CUAssertLog(root->getSubtreeBounds() == Rect(0,0,35,41), "Method addChild() did not update ancestor bounds");
+
+    leaf->setPosition(Vec2(0,50));
+    CUAssertLog(root->getSubtreeBounds() == Rect(0,0,35,51), "Method setPosition() did not update ancestor bounds");
+
+    child->setVisible(false);
+    CUAssertLog(root->getSubtreeBounds() == Rect(0,0,10,10), "Method setVisible() did not update bounds");
+
+    child->setVisible(true);
+    CUAssertLog(root->getSubtreeBounds() == Rect(0,0,35,51), "Method setVisible() did not update bounds");
+
+    leaf->setVisible(false);
+    CUAssertLog(root->getSubtreeBounds() == Rect(0,0,35,10), "Method setVisible() did not update ancestor bounds");
+
+    root->removeChild(child);
+    CUAssertLog(root->getSubtreeBounds() == Rect(0,0,10,10), "Method removeChild() did not update bounds");
+
+    CULog("Culling bounds tests complete.\n");
+}
+
+
+#pragma mark -
+#pragma mark Cached Node
+/**
+ * Draws the given node to a fresh sprite batch
+ *
+ * @param batch The sprite batch to draw with
+ * @param node  The node to draw
+ */
+static void draw_node(const std::shared_ptr<SpriteBatch>& batch, const std::shared_ptr<SceneNode>& node) {
+    batch->begin();
+    node->render(batch, Mat4::IDENTITY, Color4::WHITE);
+    batch->end();
+}
+
+/**
+ * Unit test for the invalidation of cached nodes by in-place mesh updates
+ */
+void cugl::testCachedNode() {
+    CULog("Running tests for cached nodes.\n");
+
+    std::shared_ptr<SpriteBatch> batch = SpriteBatch::alloc();
+    CUAssertLog(batch != nullptr, "SpriteBatch allocation failed");
+
+    std::shared_ptr<CachedNode> cache = CachedNode::allocWithBounds(Size(64,64));
+    std::shared_ptr<AnimationNode> sprite = AnimationNode::alloc(Texture::alloc(16,16),2,2);
+
+    // The interior vertex can move without changing the bounds
+    std::vector<Vec2> vertices = { Vec2(0,0), Vec2(8,2), Vec2(16,8), Vec2(32,0) };
+    std::shared_ptr<PathNode> path = PathNode::allocWithVertices(vertices,2);
+    std::shared_ptr<WireNode> wire = WireNode::allocWithTraversal(vertices,poly2::Traversal::OPEN);
+    cache->addChild(sprite);
+    cache->addChild(path);
+    cache->addChild(wire);
+
+    draw_node(batch,cache);
+    CUAssertLog(cache->isCached(), "Method render() did not fill the cache");
+
+#pragma mark Animation Test
+    sprite->setFrame(1);
+    CUAssertLog(!cache->isCached(), "Method setFrame() did not invalidate the cache");
+    draw_node(batch,cache);
+    CUAssertLog(cache->isCached(), "Method render() did not refill the cache");
+
+#pragma mark Path Test
+    path->setVertex(1,Vec2(8,6));
+    CUAssertLog(!cache->isCached(), "Method PathNode::setVertex() did not invalidate the cache");
+    draw_node(batch,cache);
+    CUAssertLog(cache->isCached(), "Method render() did not refill the cache");
+
+    wire->setVertex(1,Vec2(8,6));
+    CUAssertLog(!cache->isCached(), "Method WireNode::setVertex() did not invalidate the cache");
+
+    CULog("Cached node tests complete.\n");
+}
+
+
+#pragma mark -
+#pragma mark Master Test
+/**
+ * Master unit test that invokes all others in this module.
+ */
+void cugl::scene2UnitTest() {
+    testCullBounds();
+    testCachedNode();
+}
@@ -0,0 +1,58 @@
+//
+//  TCUScene2Test.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module is a unit test suite for the bookkeeping of the scene graph,
+//  such as the cached bounds used for culling and the dirty flags used by
+//  cached nodes. These are invisible when they are correct, but cause nodes
+//  to vanish or freeze when they are stale.
+//
+//  These test classes only use asserts and have no graphical side-effects.
+//  The cached node tests create OpenGL objects, and so they must run after
+//  the application has started.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: agent
+//  Version: 10/19/26
+
+#ifndef __T_CU_SCENE2_TEST_H__
+#define __T_CU_SCENE2_TEST_H__
+
+namespace cugl {
+
+/**
+ * Unit test for the invalidation of the subtree bounds used in culling
+ */
+void testCullBounds();
+
+/**
+ * Unit test for the invalidation of cached nodes by in-place mesh updates
+ */
+void testCachedNode();
+
+/**
+ * Master unit test that invokes all others in this module.
+ */
+void scene2UnitTest();
+
+}
+
+#endif /* __T_CU_SCENE2_TEST_H__ */
@@ -0,0 +1,162 @@
+//
+//  TCUUtilTest.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module is a unit test suite for the string and path utilities. The
+//  std::string_view variants of these functions are checked against the
+//  allocating versions, which are the reference implementations.
+//
+//  These test classes only use asserts and have no graphical side-effects.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: agent
+//  Version: 10/19/26
+
+#include "TCUUtilTest.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cugl/util/CUDebug.h>
+#include <cugl/util/CUStrings.h>
+#include <cugl/util/CUFiletools.h>
+
+using namespace cugl;
+
+
+#pragma mark -
+#pragma mark Strings
+/**
+ * Unit test for the string functions in strtool
+ */
+void cugl::testStrings() {
+    CULog("Running tests for strtool.\n");
+
+#pragma mark Number Test
+    std::string_view text = "x=-42;y=255;z=1.5";
+    size_t pos = 0;
+    CUAssertLog(strtool::stos32(text.substr(2),&pos) == -42,    "Method stos32() failed");
+    CUAssertLog(pos == 3,                                       "Method stos32() failed");
+    CUAssertLog(strtool::stou8(text.substr(8,3)) == 255,        "Method stou8() failed");
+    CUAssertLog(strtool::stou16("ff",nullptr,16) == 255,        "Method stou16() failed");
+    CUAssertLog(strtool::stos64(text.substr(2,3)) == -42,       "Method stos64() failed");
+    CUAssertLog(strtool::stou64("18446744073709551615") == 18446744073709551615ULL,
+                "Method stou64() failed");
+    CUAssertLog(strtool::stof(text.substr(14)) == 1.5f,         "Method stof() failed");
+    CUAssertLog(strtool::stod(text.substr(14)) == 1.5,          "Method stod() failed");
+
+    // Out of range numbers are errors, not zeroes
+    pos = 1;
+    CUAssertLog(strtool::stof("1e99",&pos) == 0 && pos == 0,    "Method stof() accepted an out of range value");
+    pos = 1;
+    CUAssertLog(strtool::stod("1e999",&pos) == 0 && pos == 0,   "Method stod() accepted an out of range value");
+    pos = 1;
+    CUAssertLog(strtool::stou64("18446744073709551616",&pos) == 0 && pos == 0,
+                "Method stou64() accepted an out of range value");
+
+#pragma mark Query Test
+    CUAssertLog(strtool::isalpha(std::string_view("abcXYZ")),    "Method isalpha() failed");
+    CUAssertLog(!strtool::isalpha(std::string_view("abc1")),     "Method isalpha() failed");
+    CUAssertLog(strtool::isalphanum(std::string_view("abc1")),   "Method isalphanum() failed");
+    CUAssertLog(strtool::isnumeric(std::string_view("0123")),    "Method isnumeric() failed");
+    CUAssertLog(!strtool::isnumeric(std::string_view("-1")),     "Method isnumeric() failed");
+    CUAssertLog(strtool::isnumber(std::string_view("-1.5")),     "Method isnumber() failed");
+    CUAssertLog(!strtool::isnumber(std::string_view("x1.5")),    "Method isnumber() failed");
+    CUAssertLog(strtool::islower(std::string_view("abc")),       "Method islower() failed");
+    CUAssertLog(strtool::isupper(std::string_view("ABC")),       "Method isupper() failed");
+    CUAssertLog(strtool::count(std::string_view("a,b,,c"),std::string_view(",")) == 3,
+                "Method count() failed");
+    CUAssertLog(strtool::starts_with(text,std::string_view("x=")),  "Method starts_with() failed");
+    CUAssertLog(!strtool::starts_with(text,std::string_view("y=")), "Method starts_with() failed");
+    CUAssertLog(strtool::ends_with(text,std::string_view("1.5")),   "Method ends_with() failed");
+
+#pragma mark Split Test
+    std::vector<std::string_view> views;
+    std::vector<std::string> strings = strtool::split("a,b,,c",",");
+    CUAssertLog(strtool::split("a,b,,c",",",views) == strings.size(), "Method split() failed");
+    for(size_t ii = 0; ii < strings.size(); ii++) {
+        CUAssertLog(views[ii] == strings[ii], "Method split() failed");
+    }
+
+    // Reusing the output vector must not keep old entries
+    strings = strtool::splitlines("one\ntwo\r\nthree");
+    CUAssertLog(strtool::splitlines("one\ntwo\r\nthree",views) == strings.size(),
+                "Method splitlines() failed");
+    CUAssertLog(views.size() == strings.size(), "Method splitlines() failed");
+    for(size_t ii = 0; ii < strings.size(); ii++) {
+        CUAssertLog(views[ii] == strings[ii], "Method splitlines() failed");
+    }
+
+    std::string buffer;
+    strtool::tolower("MiXeD",buffer);
+    CUAssertLog(buffer == strtool::tolower(std::string("MiXeD")), "Method tolower() failed");
+
+    CULog("strtool tests complete.\n");
+}
+
+
+#pragma mark -
+#pragma mark Filetools
+/**
+ * Unit test for the path functions in filetool
+ */
+void cugl::testFiletools() {
+    CULog("Running tests for filetool.\n");
+
+    // Compare against the allocating versions, as separators are platform specific
+    std::string sep(1,filetool::path_sep);
+    std::vector<std::string> paths;
+    paths.push_back("file.txt");
+    paths.push_back("dir"+sep+"file.txt");
+    paths.push_back("dir"+sep+"sub"+sep);
+    paths.push_back("dir"+sep+"."+sep+"sub"+sep+".."+sep+"file.txt");
+    paths.push_back("");
+
+    std::string dir, base;
+    for(auto it = paths.begin(); it != paths.end(); ++it) {
+        filetool::dir_name(*it,dir);
+        CUAssertLog(dir == filetool::dir_name(*it),         "Method dir_name() failed on '%s'", it->c_str());
+        filetool::base_name(*it,base);
+        CUAssertLog(base == filetool::base_name(*it),       "Method base_name() failed on '%s'", it->c_str());
+        std::pair<std::string,std::string> split = filetool::split_path(*it);
+        filetool::split_path(*it,dir,base);
+        CUAssertLog(dir == split.first && base == split.second,
+                    "Method split_path() failed on '%s'", it->c_str());
+        filetool::normalize_path(*it,dir);
+        CUAssertLog(dir == filetool::normalize_path(*it),   "Method normalize_path() failed on '%s'", it->c_str());
+    }
+
+    std::string joined;
+    filetool::join_path({"dir","sub","file.txt"},joined);
+    CUAssertLog(joined == filetool::join_path({"dir","sub","file.txt"}), "Method join_path() failed");
+
+    CULog("filetool tests complete.\n");
+}
+
+
+#pragma mark -
+#pragma mark Master Test
+/**
+ * Master unit test that invokes all others in this module.
+ */
+void cugl::utilUnitTest() {
+    testStrings();
+    testFiletools();
+}
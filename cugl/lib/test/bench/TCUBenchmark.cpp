@@ -0,0 +1,1469 @@
+//
+//  TCUBenchmark.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module is a suite of micro-benchmarks for performance sensitive code
+//  paths. Unlike the unit tests, these functions are not about correctness
+//  (though they assert that the fast and slow paths agree). They log the
+//  running time and the heap growth of each variant, so that regressions are
+//  easy to spot.
+//
+//  The heap is measured with the statistics of the C allocator, and not by
+//  replacing the global operator new, so linking these benchmarks changes
+//  nothing for the code around them. These benchmarks have their own main,
+//  and are not part of the unit tests.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: agent
+//  Version: 10/19/26
+
+#include "TCUBenchmark.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cugl/cugl.h>
+#if defined (__APPLE__)
+    #include <malloc/malloc.h>
+#else
+    #include <malloc.h>
+#endif
+
+using namespace cugl;
+
+/** The number of times to repeat each benchmark */
+#define BENCH_ITERATIONS 100000
+
+/**
+ * Returns the number of bytes currently allocated on the heap
+ *
+ * This only sees the net change of the heap. Memory that a benchmark
+ * allocates and frees again shows up in the time, but not here. A nonzero
+ * value means that a cache or buffer grew during the benchmark.
+ *
+ * @return the number of bytes currently allocated on the heap
+ */
+static Sint64 heapInUse() {
+#if defined (__APPLE__)
+    malloc_statistics_t stats;
+    malloc_zone_statistics(nullptr, &stats);
+    return (Sint64)stats.size_in_use;
+#elif defined (__WINDOWS__)
+    Sint64 total = 0;
+    _HEAPINFO info;
+    info._pentry = nullptr;
+    while (_heapwalk(&info) == _HEAPOK) {
+        if (info._useflag == _USEDENTRY) {
+            total += info._size;
+        }
+    }
+    return total;
+#elif defined (__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    struct mallinfo2 info = mallinfo2();
+    return (Sint64)(info.uordblks + info.hblkhd);
+#else
+    struct mallinfo info = mallinfo();
+    return (Sint64)info.uordblks + (Sint64)info.hblkhd;
+#endif
+}
+
+/**
+ * Logs the time and heap growth of a single benchmark
+ *
+ * @param name      The benchmark name
+ * @param start     The timestamp at the start of the benchmark
+ * @param end       The timestamp at the end of the benchmark
+ * @param heap      The number of bytes the heap grew during the benchmark
+ */
+static void report(const char* name, const Timestamp& start, const Timestamp& end, Sint64 heap) {
+    CULog("%-24s %8llu micros %+10lld heap bytes",name,
+          (unsigned long long)Timestamp::ellapsedMicros(start,end),(long long)heap);
+}
+
+
+#pragma mark -
+#pragma mark Strings
+/**
+ * Benchmark for the string and path functions in strtool and filetool
+ *
+ * This compares the allocating versions of each function against the
+ * std::string_view and output-parameter versions.
+ */
+void cugl::benchStrings() {
+    CULog("Running benchmarks for strtool and filetool.\n");
+    Timestamp start, end;
+    Sint64 heap;
+
+    // Long enough to defeat the small string optimization
+    const std::string line = "sprite-sheet-enemy-0001,  -1024, 0x7fff, 3.14159265, 2.5e-3,level-floor-04";
+    const std::string path = "/home/user/assets/textures/../json/./levels/level-floor-04.json";
+    const char* numbers[] = { "42", "-1024", "65535", "3.14159265", "2.5e-3" };
+    volatile double sink = 0;
+
+#pragma mark Split Benchmark
+    heap = heapInUse();
+    start.mark();
+    for(int ii = 0; ii < BENCH_ITERATIONS; ii++) {
+        std::vector<std::string> parts = strtool::split(line, ",");
+        sink += parts.size();
+    }
+    end.mark();
+    report("split (allocating)",start,end,heapInUse()-heap);
+
+    std::vector<std::string_view> views;
+    heap = heapInUse();
+    start.mark();
+    for(int ii = 0; ii < BENCH_ITERATIONS; ii++) {
+        strtool::split(line, ",", views);
+        sink += views.size();
+    }
+    end.mark();
+    report("split (string_view)",start,end,heapInUse()-heap);
+    CUAssertAlwaysLog(views.size() == strtool::split(line, ",").size(), "Split variants disagree");
+
+#pragma mark Number Benchmark
+    heap = heapInUse();
+    start.mark();
+    for(int ii = 0; ii < BENCH_ITERATIONS; ii++) {
+        sink += strtool::stos32(std::string(numbers[ii % 3]));
+        sink += strtool::stod(std::string(numbers[3+(ii % 2)]));
+    }
+    end.mark();
+    report("stoX (std::string)",start,end,heapInUse()-heap);
+
+    heap = heapInUse();
+    start.mark();
+    for(int ii = 0; ii < BENCH_ITERATIONS; ii++) {
+        sink += strtool::stos32(numbers[ii % 3]);
+        sink += strtool::stod(numbers[3+(ii % 2)]);
+    }
+    end.mark();
+    report("stoX (string_view)",start,end,heapInUse()-heap);
+
+#pragma mark Lowercase Benchmark
+    heap = heapInUse();
+    start.mark();
+    for(int ii = 0; ii < BENCH_ITERATIONS; ii++) {
+        std::string lower = strtool::tolower(line);
+        sink += lower.size();
+    }
+    end.mark();
+    report("tolower (allocating)",start,end,heapInUse()-heap);
+
+    std::string lower;
+    heap = heapInUse();
+    start.mark();
+    for(int ii = 0; ii < BENCH_ITERATIONS; ii++) {
+        strtool::tolower(line, lower);
+        sink += lower.size();
+    }
+    end.mark();
+    report("tolower (buffer)",start,end,heapInUse()-heap);
+    CUAssertAlwaysLog(lower == strtool::tolower(line), "Lowercase variants disagree");
+
+#pragma mark Path Benchmark
+    heap = heapInUse();
+    start.mark();
+    for(int ii = 0; ii < BENCH_ITERATIONS; ii++) {
+        std::string norm = filetool::normalize_path(path);
+        std::string base = filetool::base_name(norm);
+        sink += base.size();
+    }
+    end.mark();
+    report("path (allocating)",start,end,heapInUse()-heap);
+
+    std::string norm, base;
+    heap = heapInUse();
+    start.mark();
+    for(int ii = 0; ii < BENCH_ITERATIONS; ii++) {
+        filetool::normalize_path(path, norm);
+        filetool::base_name(norm, base);
+        sink += base.size();
+    }
+    end.mark();
+    report("path (buffer)",start,end,heapInUse()-heap);
+    CUAssertAlwaysLog(norm == filetool::normalize_path(path), "Normalize variants disagree");
+    CUAssertAlwaysLog(base == filetool::base_name(norm), "Base name variants disagree");
+
+    CULog("String benchmarks complete (checksum %g).\n",(double)sink);
+}
+
+
+#pragma mark -
+#pragma mark Transforms
+/** The number of vertices in each transform benchmark array */
+#define BENCH_VERTICES 4096
+/** The number of times to transform each vertex array */
+#define BENCH_PASSES   250
+
+/**
+ * Logs the throughput of a single vertex transform benchmark
+ *
+ * @param name      The benchmark name
+ * @param start     The timestamp at the start of the benchmark
+ * @param end       The timestamp at the end of the benchmark
+ */
+static void throughput(const char* name, const Timestamp& start, const Timestamp& end) {
+    Uint64 micros = Timestamp::ellapsedMicros(start,end);
+    double rate = (double)BENCH_VERTICES*BENCH_PASSES/(micros > 0 ? micros : 1);
+    CULog("%-24s %8llu micros %10.1f Mverts/sec",name,(unsigned long long)micros,rate);
+}
+
+/**
+ * Benchmark for the batched 2d vertex transforms
+ *
+ * This compares transforming each vertex separately with the strided
+ * batch kernels in {@link Mat4} and {@link Affine2}.
+ */
+void cugl::benchTransforms() {
+    CULog("Running benchmarks for vertex transforms.\n");
+    Timestamp start, end;
+    
+    Mat4 mat;
+    Mat4::createRotationZ(0.75f, &mat);
+    mat.scale(1.5f, 0.5f, 1.0f);
+    mat.translate(100.0f, -25.0f, 0.0f);
+    Affine2 aff;
+    Affine2::createRotation(0.75f, &aff);
+    aff.scale(Vec2(1.5f, 0.5f));
+    aff.translate(100.0f, -25.0f);
+    
+    std::vector<Vec2> points(BENCH_VERTICES);
+    std::vector<SpriteVertex3> verts(BENCH_VERTICES);
+    for(int ii = 0; ii < BENCH_VERTICES; ii++) {
+        points[ii].set((float)(ii % 64), (float)(ii / 64));
+        verts[ii].position.set(points[ii].x, points[ii].y, 0.5f);
+    }
+    std::vector<Vec2> output(BENCH_VERTICES);
+    std::vector<SpriteVertex3> voutput(verts);
+    const size_t stride = sizeof(SpriteVertex3)/sizeof(float);
+    volatile float sink = 0;
+    
+#pragma mark Vec2 Benchmark
+    start.mark();
+    for(int pass = 0; pass < BENCH_PASSES; pass++) {
+        for(int ii = 0; ii < BENCH_VERTICES; ii++) {
+            Mat4::transform(mat, points[ii], &output[ii]);
+        }
+        sink += output[pass].x;
+    }
+    end.mark();
+    throughput("Vec2 * Mat4 (single)",start,end);
+    
+    start.mark();
+    for(int pass = 0; pass < BENCH_PASSES; pass++) {
+        Mat4::transform2(mat, &points[0].x, 2, &output[0].x, 2, BENCH_VERTICES);
+        sink += output[pass].x;
+    }
+    end.mark();
+    throughput("Vec2 * Mat4 (batch)",start,end);
+    CUAssertAlwaysLog(output[BENCH_VERTICES-1].distance(points[BENCH_VERTICES-1]*mat) < 0.001f,
+                      "Mat4 transform variants disagree");
+    
+    start.mark();
+    for(int pass = 0; pass < BENCH_PASSES; pass++) {
+        for(int ii = 0; ii < BENCH_VERTICES; ii++) {
+            Affine2::transform(aff, points[ii], &output[ii]);
+        }
+        sink += output[pass].x;
+    }
+    end.mark();
+    throughput("Vec2 * Affine2 (single)",start,end);
+    
+    start.mark();
+    for(int pass = 0; pass < BENCH_PASSES; pass++) {
+        Affine2::transform(aff, &points[0].x, 2, &output[0].x, 2, BENCH_VERTICES);
+        sink += output[pass].x;
+    }
+    end.mark();
+    throughput("Vec2 * Affine2 (batch)",start,end);
+    CUAssertAlwaysLog(output[BENCH_VERTICES-1].distance(points[BENCH_VERTICES-1]*aff) < 0.001f,
+                      "Affine2 transform variants disagree");
+    
+#pragma mark Vertex Benchmark
+    start.mark();
+    for(int pass = 0; pass < BENCH_PASSES; pass++) {
+        for(int ii = 0; ii < BENCH_VERTICES; ii++) {
+            voutput[ii].position = verts[ii].position*mat;
+        }
+        sink += voutput[pass].position.x;
+    }
+    end.mark();
+    throughput("SpriteVertex3 (single)",start,end);
+    
+    start.mark();
+    for(int pass = 0; pass < BENCH_PASSES; pass++) {
+        Mat4::transform3(mat, &verts[0].position.x, stride, &voutput[0].position.x, stride, BENCH_VERTICES);
+        sink += voutput[pass].position.x;
+    }
+    end.mark();
+    throughput("SpriteVertex3 (batch)",start,end);
+    CUAssertAlwaysLog(voutput[BENCH_VERTICES-1].position.distance(verts[BENCH_VERTICES-1].position*mat) < 0.001f,
+                      "Vertex transform variants disagree");
+    
+    CULog("Transform benchmarks complete (checksum %g).\n",(double)sink);
+}
+
+#pragma mark -
+#pragma mark Triangulation
+/** The largest polygon to triangulate with (quadratic) ear clipping */
+#define BENCH_EARCLIP_LIMIT 20000
+
+/**
+ * Returns a star-shaped polygon with the given number of vertices
+ *
+ * The radius alternates between an inner and (jittered) outer ring, so that
+ * half of the vertices are reflex. This is the worst case for ear clipping.
+ *
+ * @param count The number of vertices
+ *
+ * @return a star-shaped polygon with the given number of vertices
+ */
+static std::vector<Vec2> makeStar(int count) {
+    std::vector<Vec2> result;
+    result.reserve(count);
+    std::srand(count);
+    for(int ii = 0; ii < count; ii++) {
+        float angle  = 2.0f*(float)M_PI*ii/count;
+        float radius = (ii % 2 ? 100.0f : 50.0f)+(std::rand() % 1000)/100.0f;
+        result.push_back(Vec2(radius*cosf(angle),radius*sinf(angle)));
+    }
+    return result;
+}
+
+/**
+ * Returns the total (signed) area of the given triangulation
+ *
+ * @param vertices  The polygon vertices
+ * @param indices   The triangulation indices
+ *
+ * @return the total (signed) area of the given triangulation
+ */
+static float triangulatedArea(const std::vector<Vec2>& vertices, const std::vector<Uint32>& indices) {
+    float area = 0;
+    for(size_t ii = 0; ii+2 < indices.size(); ii += 3) {
+        const Vec2& a = vertices[indices[ii  ]];
+        const Vec2& b = vertices[indices[ii+1]];
+        const Vec2& c = vertices[indices[ii+2]];
+        area += ((b.x-a.x)*(c.y-a.y)-(b.y-a.y)*(c.x-a.x))/2;
+    }
+    return area;
+}
+
+/**
+ * Benchmark for the polygon triangulators
+ *
+ * This compares the O(n log n) monotone partition of {@link SimpleTriangulator}
+ * with the original ear clipping algorithm on polygons of 100 to 100k
+ * vertices. Ear clipping is skipped on polygons above BENCH_EARCLIP_LIMIT.
+ */
+void cugl::benchTriangulation() {
+    CULog("Running benchmarks for triangulation.\n");
+    Timestamp start, end;
+    Sint64 heap;
+    char name[32];
+    
+    SimpleTriangulator triangulator;
+    for(int size = 100; size <= 100000; size *= 10) {
+        std::vector<Vec2> star = makeStar(size);
+        float monotone = 0;
+        
+        triangulator.set(star);
+        triangulator.setEarClipping(false);
+        triangulator.calculate();   // Warm up the scratch buffers
+        heap = heapInUse();
+        start.mark();
+        triangulator.calculate();
+        end.mark();
+        monotone = triangulatedArea(star,triangulator.getTriangulation());
+        std::snprintf(name, sizeof(name), "Monotone (%d)", size);
+        report(name,start,end,heapInUse()-heap);
+        
+        std::snprintf(name, sizeof(name), "Ear clipping (%d)", size);
+        if (size > BENCH_EARCLIP_LIMIT) {
+            CULog("%-24s %8s",name,"skipped");
+            continue;
+        }
+        triangulator.setEarClipping(true);
+        heap = heapInUse();
+        start.mark();
+        triangulator.calculate();
+        end.mark();
+        report(name,start,end,heapInUse()-heap);
+        
+        // The variants may trim different degenerate triangles, but must cover the same area
+        float diff = triangulatedArea(star,triangulator.getTriangulation())-monotone;
+        CUAssertAlwaysLog(fabsf(diff) < 0.01f*monotone, "Triangulation variants disagree");
+    }
+    CULog("Triangulation benchmarks complete.\n");
+}
+
+/** The number of distinct shapes in the triangulation cache benchmark */
+#define BENCH_CACHE_SHAPES  16
+/** The number of shapes built in the triangulation cache benchmark */
+#define BENCH_CACHE_BUILDS  10000
+
+/**
+ * Benchmark for the triangulation cache
+ *
+ * This builds many solid polygons from a small set of widget shapes, as a
+ * scene loader does. It compares a fresh {@link SimpleTriangulator} for
+ * each polygon with a {@link TriangulationCache}.
+ */
+void cugl::benchTriangulationCache() {
+    CULog("Running benchmarks for the triangulation cache.\n");
+    Timestamp start, end;
+    Sint64 heap;
+    
+    std::vector<std::vector<Vec2>> shapes;
+    for(int ii = 0; ii < BENCH_CACHE_SHAPES; ii++) {
+        shapes.push_back(makeStar(64+2*ii));
+    }
+    
+    Poly2 poly;
+    size_t total = 0;
+    heap = heapInUse();
+    start.mark();
+    for(int ii = 0; ii < BENCH_CACHE_BUILDS; ii++) {
+        SimpleTriangulator triangulator;
+        triangulator.set(shapes[ii % BENCH_CACHE_SHAPES]);
+        triangulator.calculate();
+        poly.clear();
+        triangulator.getPolygon(&poly);
+        total += poly.indices().size();
+    }
+    end.mark();
+    report("Triangulate",start,end,heapInUse()-heap);
+    
+    TriangulationCache cache;
+    heap = heapInUse();
+    start.mark();
+    for(int ii = 0; ii < BENCH_CACHE_BUILDS; ii++) {
+        cache.triangulate(shapes[ii % BENCH_CACHE_SHAPES], &poly);
+        total -= poly.indices().size();
+    }
+    end.mark();
+    report("Triangulate cached",start,end,heapInUse()-heap);
+    
+    CUAssertAlwaysLog(total == 0, "Cached triangulations do not match");
+    CULog("Triangulation cache benchmarks complete (%.1f%% hits).\n",100*cache.getHitRate());
+}
+
+/** The smallest mesh (in grid cells per side) in the boundary benchmark */
+#define BENCH_BOUNDARY_MIN  24
+/** The largest mesh (in grid cells per side) in the boundary benchmark */
+#define BENCH_BOUNDARY_MAX  750
+
+/**
+ * Returns the indices of a triangulated grid with a square hole
+ *
+ * The grid has cells*cells squares (each two triangles), minus the middle
+ * ninth. The triangles are counter-clockwise.
+ *
+ * @param cells The number of cells per side
+ *
+ * @return the indices of a triangulated grid with a square hole
+ */
+static std::vector<Uint32> makeGrid(Uint32 cells) {
+    std::vector<Uint32> result;
+    result.reserve(6*cells*cells);
+    for(Uint32 yy = 0; yy < cells; yy++) {
+        for(Uint32 xx = 0; xx < cells; xx++) {
+            if (xx >= cells/3 && xx < 2*cells/3 && yy >= cells/3 && yy < 2*cells/3) {
+                continue;
+            }
+            Uint32 corner = yy*(cells+1)+xx;
+            result.insert(result.end(), { corner, corner+1, corner+cells+2 });
+            result.insert(result.end(), { corner, corner+cells+2, corner+cells+1 });
+        }
+    }
+    return result;
+}
+
+/**
+ * Benchmark for boundary extraction from triangle meshes
+ *
+ * This extracts the exterior and the boundaries of grid meshes (with a
+ * hole) from one thousand to one million triangles, as is done when a
+ * wireframe outlines a solid polygon.
+ */
+void cugl::benchBoundaries() {
+    CULog("Running benchmarks for boundary extraction.\n");
+    Timestamp start, end;
+    Sint64 heap;
+    char name[32];
+    size_t total = 0;
+    
+    Geometry geom(Geometry::SOLID);
+    for(Uint32 cells = BENCH_BOUNDARY_MIN; cells <= BENCH_BOUNDARY_MAX; cells = cells*3162/1000) {
+        std::vector<Uint32> indices = makeGrid(cells);
+        size_t triangles = indices.size()/3;
+        
+        std::snprintf(name, sizeof(name), "Exterior (%zu)", triangles);
+        heap = heapInUse();
+        start.mark();
+        std::vector<Uint32> exterior = geom.exterior(indices);
+        end.mark();
+        report(name,start,end,heapInUse()-heap);
+        
+        std::snprintf(name, sizeof(name), "Boundaries (%zu)", triangles);
+        heap = heapInUse();
+        start.mark();
+        std::vector<std::vector<Uint32>> bounds = geom.boundaries(indices);
+        end.mark();
+        report(name,start,end,heapInUse()-heap);
+        
+        // The outer square and the hole, with every exterior index on one of them
+        CUAssertAlwaysLog(bounds.size() == 2, "Expected 2 boundaries, found %zu", bounds.size());
+        CUAssertAlwaysLog(bounds[0].size()+bounds[1].size() == exterior.size(),
+                          "The boundaries do not match the exterior");
+        total += exterior.size();
+    }
+    CULog("Boundary benchmarks complete (%zu exterior indices).\n",total);
+}
+
+#pragma mark -
+#pragma mark Clipping
+/** The number of subject polygons clipped in each frame */
+#define BENCH_CLIP_SUBJECTS 2000
+/** The number of wall polygons in the clip set */
+#define BENCH_CLIP_WALLS    50
+
+/**
+ * Benchmark for the polygon boolean operations
+ *
+ * This clips a frame's worth of vision cones against a fixed set of walls
+ * with {@link PolyClipper}, both with and without triangulating the result.
+ */
+void cugl::benchClipping() {
+    CULog("Running benchmarks for polygon clipping.\n");
+    Timestamp start, end;
+    Sint64 heap;
+    
+    PolyClipper clipper;
+    for(int ii = 0; ii < BENCH_CLIP_WALLS; ii++) {
+        Rect wall(ii*20.0f, 0.0f, 5.0f, 100.0f);
+        clipper.addClip(Poly2(wall));
+    }
+    std::vector<Vec2> cone(3);
+    Poly2 result;
+    size_t triangles = 0;
+    size_t contours  = 0;
+    
+    heap = heapInUse();
+    start.mark();
+    for(int ii = 0; ii < BENCH_CLIP_SUBJECTS; ii++) {
+        float x = (ii % 100)*10.0f;
+        cone[0].set(x, 50.0f);
+        cone[1].set(x+60.0f, 20.0f);
+        cone[2].set(x+60.0f, 80.0f);
+        clipper.setSubject(cone);
+        clipper.calculate(poly2::ClipType::DIFFERENCE);
+        result.clear();
+        clipper.getPolygon(&result);
+        triangles += result.indices().size()/3;
+    }
+    end.mark();
+    report("Clip (triangulated)",start,end,heapInUse()-heap);
+    
+    std::vector<Poly2> paths;
+    clipper.setTriangulate(false);
+    heap = heapInUse();
+    start.mark();
+    for(int ii = 0; ii < BENCH_CLIP_SUBJECTS; ii++) {
+        float x = (ii % 100)*10.0f;
+        cone[0].set(x, 50.0f);
+        cone[1].set(x+60.0f, 20.0f);
+        cone[2].set(x+60.0f, 80.0f);
+        clipper.setSubject(cone);
+        clipper.calculate(poly2::ClipType::DIFFERENCE);
+        paths.clear();
+        contours += clipper.getPaths(paths);
+    }
+    end.mark();
+    report("Clip (contours)",start,end,heapInUse()-heap);
+    
+    CUAssertAlwaysLog(triangles > 0 && contours > 0, "Clipping produced no output");
+    CULog("Clipping benchmarks complete (%zu triangles, %zu contours).\n",triangles,contours);
+}
+
+#pragma mark -
+#pragma mark Hit Testing
+/** The number of vertices in the containment polygon */
+#define BENCH_HIT_VERTICES  10000
+/** The number of (button) nodes in the hit testing scene */
+#define BENCH_HIT_NODES     500
+/** The number of taps to hit test against the scene */
+#define BENCH_HIT_QUERIES   1000
+
+/**
+ * Returns the topmost node containing the point, walking the entire scene graph
+ *
+ * This is the linear search that {@link Scene2#pick} replaces.
+ *
+ * @param node  The root of the subtree to search
+ * @param point The point in world coordinates
+ * @param best  The topmost node found so far
+ */
+static void walkScene(const std::shared_ptr<scene2::SceneNode>& node, const Vec2 point,
+                      std::shared_ptr<scene2::SceneNode>& best) {
+    if (!node->isVisible()) {
+        return;
+    }
+    Rect bounds = node->getNodeToWorldTransform().transform(Rect(Vec2::ZERO, node->getContentSize()));
+    if (bounds.contains(point)) {
+        best = node;
+    }
+    for(auto it = node->getChildren().begin(); it != node->getChildren().end(); ++it) {
+        walkScene(*it, point, best);
+    }
+}
+
+/**
+ * Benchmark for containment and hit testing
+ *
+ * This measures {@link Poly2#contains} on a large triangulated polygon and
+ * compares {@link Scene2#pick} with a walk of a scene graph with hundreds
+ * of buttons.
+ */
+void cugl::benchHitTesting() {
+    CULog("Running benchmarks for hit testing.\n");
+    Timestamp start, end;
+    Sint64 heap;
+    
+    SimpleTriangulator triangulator;
+    triangulator.set(makeStar(BENCH_HIT_VERTICES));
+    triangulator.calculate();
+    Poly2 poly = triangulator.getPolygon();
+    Rect bounds = poly.getBounds();
+    
+    size_t inside = 0;
+    start.mark();
+    inside += poly.contains(bounds.getMidX(),bounds.getMidY());
+    end.mark();
+    report("Poly2 contains (first query)",start,end,0);
+    
+    heap = heapInUse();
+    start.mark();
+    for(int ii = 0; ii < BENCH_ITERATIONS; ii++) {
+        float x = bounds.origin.x+(ii % 317)*bounds.size.width/317;
+        float y = bounds.origin.y+(ii % 331)*bounds.size.height/331;
+        inside += poly.contains(x,y);
+    }
+    end.mark();
+    report("Poly2 contains (grid)",start,end,heapInUse()-heap);
+    
+    std::shared_ptr<Scene2> scene = Scene2::alloc(1024,576);
+    for(int ii = 0; ii < BENCH_HIT_NODES; ii++) {
+        float x = (ii % 25)*40.0f;
+        float y = (ii / 25)*28.0f;
+        std::shared_ptr<scene2::SceneNode> button = scene2::SceneNode::allocWithBounds(x,y,36,24);
+        button->addChild(scene2::SceneNode::allocWithBounds(4,4,28,16));
+        scene->addChild(button);
+    }
+    
+    size_t hits = 0;
+    heap = heapInUse();
+    start.mark();
+    for(int ii = 0; ii < BENCH_HIT_QUERIES; ii++) {
+        std::shared_ptr<scene2::SceneNode> best = nullptr;
+        Vec2 point((ii % 97)*10.5f,(ii % 89)*6.4f);
+        for(auto it = scene->getChildren().begin(); it != scene->getChildren().end(); ++it) {
+            walkScene(*it, point, best);
+        }
+        hits += (best != nullptr);
+    }
+    end.mark();
+    report("Scene2 hit test (walk)",start,end,heapInUse()-heap);
+    
+    scene->pick(Vec2::ZERO);
+    heap = heapInUse();
+    start.mark();
+    for(int ii = 0; ii < BENCH_HIT_QUERIES; ii++) {
+        Vec2 point((ii % 97)*10.5f,(ii % 89)*6.4f);
+        hits += (scene->pick(point) != nullptr);
+    }
+    end.mark();
+    report("Scene2 hit test (pick)",start,end,heapInUse()-heap);
+    
+    CUAssertAlwaysLog(inside > 0 && hits > 0, "Hit testing found nothing");
+    CULog("Hit testing benchmarks complete (%zu inside, %zu hits).\n",inside,hits);
+}
+
+#pragma mark -
+#pragma mark Path Editing
+/** The number of points in the dragged path */
+#define BENCH_DRAG_POINTS   10000
+/** The number of frames the path is dragged */
+#define BENCH_DRAG_FRAMES   1000
+
+/**
+ * Benchmark for incremental path extrusion
+ *
+ * This drags a single point of a long path every frame, as an editor
+ * does. It compares a full extrusion with {@link SimpleExtruder#update}.
+ */
+void cugl::benchPathDrag() {
+    CULog("Running benchmarks for path dragging.\n");
+    Timestamp start, end;
+    Sint64 heap;
+    
+    std::vector<Vec2> path(BENCH_DRAG_POINTS);
+    for(int ii = 0; ii < BENCH_DRAG_POINTS; ii++) {
+        path[ii].set(ii*2.0f, 50.0f+40.0f*sinf(ii*0.05f));
+    }
+    Uint32 index = BENCH_DRAG_POINTS/2;
+    
+    SimpleExtruder extruder;
+    extruder.setJoint(poly2::Joint::ROUND);
+    extruder.setEndCap(poly2::EndCap::ROUND);
+    extruder.setUniform(true);
+    Poly2 full;
+    extruder.set(path,false);
+    extruder.calculate(4.0f);
+    extruder.getPolygon(&full);
+    
+    heap = heapInUse();
+    start.mark();
+    for(int ii = 0; ii < BENCH_DRAG_FRAMES; ii++) {
+        path[index].y = 50.0f+(ii % 40);
+        extruder.set(path,false);
+        extruder.calculate(4.0f);
+        full.clear();
+        extruder.getPolygon(&full);
+    }
+    end.mark();
+    report("Path drag (full extrusion)",start,end,heapInUse()-heap);
+    
+    Poly2 patched;
+    extruder.getPolygon(&patched);
+    size_t incremental = 0;
+    heap = heapInUse();
+    start.mark();
+    for(int ii = 0; ii < BENCH_DRAG_FRAMES; ii++) {
+        path[index].y = 50.0f+(ii % 40);
+        incremental += extruder.update(index, path[index]);
+        extruder.updatePolygon(&patched);
+    }
+    end.mark();
+    report("Path drag (incremental)",start,end,heapInUse()-heap);
+    
+    CUAssertAlwaysLog(incremental == BENCH_DRAG_FRAMES, "Path drag was not incremental");
+    CUAssertAlwaysLog(patched.vertices() == full.vertices(), "Incremental extrusion does not match");
+    CULog("Path drag benchmarks complete (%zu vertices).\n",patched.vertices().size());
+}
+
+#pragma mark -
+#pragma mark Path Smoothing
+/** The number of points in the small smoothing input */
+#define BENCH_SMOOTH_SMALL  100000
+/** The number of points in the large smoothing input */
+#define BENCH_SMOOTH_LARGE  1000000
+/** The number of worker threads for the parallel benchmarks */
+#define BENCH_SMOOTH_THREADS 4
+
+/**
+ * Benchmark for path smoothing and spline flattening
+ *
+ * This runs {@link PathSmoother} on noisy gesture paths of 1e5 and 1e6
+ * points, with and without a thread pool. It then flattens splines with
+ * the same number of control points, comparing {@link PolySplineFactory}
+ * with {@link Spline2#flatten}.
+ */
+void cugl::benchSmoothing() {
+    CULog("Running benchmarks for path smoothing.\n");
+    Timestamp start, end;
+    std::shared_ptr<ThreadPool> threads = ThreadPool::alloc(BENCH_SMOOTH_THREADS);
+    size_t kept = 0;
+    size_t flat = 0;
+    
+    const size_t sizes[2] = { BENCH_SMOOTH_SMALL, BENCH_SMOOTH_LARGE };
+    for(int jj = 0; jj < 2; jj++) {
+        size_t size = sizes[jj];
+        std::vector<Vec2> path(size);
+        for(size_t ii = 0; ii < size; ii++) {
+            float angle = ii*2*M_PI/size;
+            path[ii].set(1000*cosf(angle)+(rand() % 100)*0.01f, 1000*sinf(2*angle)+(rand() % 100)*0.01f);
+        }
+        
+        std::string suffix = " ("+std::to_string(size)+")";
+        PathSmoother smoother;
+        smoother.set(path);
+        start.mark();
+        smoother.calculate();
+        end.mark();
+        report(("Smooth"+suffix).c_str(),start,end,0);
+        
+        start.mark();
+        smoother.calculate(threads);
+        end.mark();
+        report(("Smooth pooled"+suffix).c_str(),start,end,0);
+        kept += smoother.getPath().size();
+        
+        // Reuse the path as spline control points
+        path.resize(3*((size-1)/3)+1);
+        Spline2 spline(path);
+        PolySplineFactory factory(&spline);
+        start.mark();
+        factory.calculate(PolySplineFactory::Criterion::DISTANCE, 0.25f);
+        end.mark();
+        report(("Spline subdivide"+suffix).c_str(),start,end,0);
+        
+        std::vector<Vec2> buffer;
+        start.mark();
+        flat += spline.flatten(buffer, 0.25f);
+        end.mark();
+        report(("Spline flatten"+suffix).c_str(),start,end,0);
+        
+        buffer.clear();
+        start.mark();
+        flat += spline.flatten(buffer, 0.25f, threads);
+        end.mark();
+        report(("Spline flatten pooled"+suffix).c_str(),start,end,0);
+    }
+    threads = nullptr;
+    
+    CUAssertAlwaysLog(kept > 0 && flat > 0, "Smoothing produced no output");
+    CULog("Smoothing benchmarks complete (%zu kept, %zu flattened).\n",kept,flat);
+}
+
+#pragma mark -
+#pragma mark Spline Projection
+/** The number of segments in the projection spline */
+#define BENCH_SPLINE_SEGMENTS   1000
+
+/**
+ * Benchmark for nearest point queries on a spline
+ *
+ * This projects mouse positions onto a thousand segment spline, as an
+ * editor does when snapping or picking. It times the first query (which
+ * builds the projection cache), the remaining queries, and the first
+ * query after an edit.
+ */
+void cugl::benchSplineNearest() {
+    CULog("Running benchmarks for spline projection.\n");
+    Timestamp start, end;
+    
+    std::vector<Vec2> points(3*BENCH_SPLINE_SEGMENTS+1);
+    for(size_t ii = 0; ii < points.size(); ii++) {
+        float x = ii*2.0f;
+        points[ii].set(x, 200*sinf(x*0.01f)+(rand() % 100)*0.5f);
+    }
+    Spline2 spline(points);
+    
+    Sint64 heap = heapInUse();
+    start.mark();
+    float total = spline.nearestParameter(Vec2(1000,0));
+    end.mark();
+    report("Spline nearest (first)",start,end,heapInUse()-heap);
+    
+    std::vector<Vec2> mouse(BENCH_ITERATIONS);
+    for(size_t ii = 0; ii < mouse.size(); ii++) {
+        mouse[ii].set((rand() % 6000)*1.0f,(rand() % 600)-300.0f);
+    }
+    
+    heap = heapInUse();
+    start.mark();
+    for(size_t ii = 0; ii < mouse.size(); ii++) {
+        total += spline.nearestParameter(mouse[ii]);
+    }
+    end.mark();
+    report("Spline nearest",start,end,heapInUse()-heap);
+    
+    spline.setAnchor(BENCH_SPLINE_SEGMENTS/2, Vec2(3000,500));
+    heap = heapInUse();
+    start.mark();
+    float param = spline.nearestParameter(Vec2(3000,490));
+    end.mark();
+    report("Spline nearest (edited)",start,end,heapInUse()-heap);
+    
+    CUAssertAlwaysLog(spline.nearestPoint(Vec2(3000,490)).distance(Vec2(3000,490)) <= 10,
+                      "Projection does not reflect the edit");
+    CULog("Spline projection benchmarks complete (%g, %g).\n",total,param);
+}
+
+#pragma mark -
+#pragma mark Easing
+/** The number of nodes eased in each frame of the easing benchmark */
+#define BENCH_EASING_NODES  1024
+/** The number of frames in the easing benchmark */
+#define BENCH_EASING_FRAMES 1000
+
+/**
+ * Benchmark for easing function evaluation
+ *
+ * This eases a transition for a thousand nodes over a thousand frames, as
+ * a UI transition does. It compares the type-erased std::function, the
+ * compile-time functor, and batch evaluation for {@link EasingFunction}.
+ * It then compares the evaluator, batch evaluation, and the lookup table
+ * for {@link EasingBezier}.
+ */
+void cugl::benchEasing() {
+    CULog("Running benchmarks for easing functions.\n");
+    Timestamp start, end;
+    double sink = 0;
+    
+    std::vector<float> times(BENCH_EASING_NODES);
+    std::vector<float> values(BENCH_EASING_NODES);
+    for(size_t ii = 0; ii < times.size(); ii++) {
+        times[ii] = (rand() % 1000)/1000.0f;
+    }
+    const float step = 1.0f/BENCH_EASING_FRAMES;
+    
+#pragma mark Function Benchmark
+    std::function<float(float)> erased = EasingFunction::alloc(EasingFunction::Type::CUBIC_IN_OUT);
+    Sint64 heap = heapInUse();
+    start.mark();
+    for(size_t ii = 0; ii < BENCH_EASING_FRAMES; ii++) {
+        for(size_t jj = 0; jj < times.size(); jj++) {
+            values[jj] = erased(std::fmod(times[jj]+ii*step,1.0f));
+        }
+        sink += values[ii % values.size()];
+    }
+    end.mark();
+    report("Easing std::function",start,end,heapInUse()-heap);
+    
+    EasingFunction::Functor<EasingFunction::Type::CUBIC_IN_OUT> functor;
+    heap = heapInUse();
+    start.mark();
+    for(size_t ii = 0; ii < BENCH_EASING_FRAMES; ii++) {
+        for(size_t jj = 0; jj < times.size(); jj++) {
+            values[jj] = functor(std::fmod(times[jj]+ii*step,1.0f));
+        }
+        sink += values[ii % values.size()];
+    }
+    end.mark();
+    report("Easing functor",start,end,heapInUse()-heap);
+    
+    heap = heapInUse();
+    start.mark();
+    for(size_t ii = 0; ii < BENCH_EASING_FRAMES; ii++) {
+        for(size_t jj = 0; jj < times.size(); jj++) {
+            values[jj] = std::fmod(times[jj]+ii*step,1.0f);
+        }
+        EasingFunction::evaluate(EasingFunction::Type::CUBIC_IN_OUT,
+                                 values.data(), values.data(), values.size());
+        sink += values[ii % values.size()];
+    }
+    end.mark();
+    report("Easing batch",start,end,heapInUse()-heap);
+    
+#pragma mark Bezier Benchmark
+    std::shared_ptr<EasingBezier> bezier = EasingBezier::alloc(EasingFunction::Type::CUBIC_IN_OUT);
+    erased = bezier->getEvaluator();
+    heap = heapInUse();
+    start.mark();
+    for(size_t ii = 0; ii < BENCH_EASING_FRAMES; ii++) {
+        for(size_t jj = 0; jj < times.size(); jj++) {
+            values[jj] = erased(std::fmod(times[jj]+ii*step,1.0f));
+        }
+        sink += values[ii % values.size()];
+    }
+    end.mark();
+    report("Bezier evaluator",start,end,heapInUse()-heap);
+    
+    heap = heapInUse();
+    start.mark();
+    for(size_t ii = 0; ii < BENCH_EASING_FRAMES; ii++) {
+        for(size_t jj = 0; jj < times.size(); jj++) {
+            values[jj] = std::fmod(times[jj]+ii*step,1.0f);
+        }
+        bezier->evaluate(values.data(), values.data(), values.size());
+        sink += values[ii % values.size()];
+    }
+    end.mark();
+    report("Bezier batch",start,end,heapInUse()-heap);
+    
+    bezier->setLookupSize(256);
+    heap = heapInUse();
+    start.mark();
+    for(size_t ii = 0; ii < BENCH_EASING_FRAMES; ii++) {
+        for(size_t jj = 0; jj < times.size(); jj++) {
+            values[jj] = std::fmod(times[jj]+ii*step,1.0f);
+        }
+        bezier->evaluate(values.data(), values.data(), values.size());
+        sink += values[ii % values.size()];
+    }
+    end.mark();
+    report("Bezier batch (lookup)",start,end,heapInUse()-heap);
+    
+    CULog("Easing benchmarks complete (checksum %g).\n",sink);
+}
+
+#pragma mark -
+#pragma mark Retained Meshes
+/** The number of nodes in the retained mesh scene */
+#define BENCH_RETAIN_NODES  10000
+/** The number of frames to render each scene */
+#define BENCH_RETAIN_FRAMES 100
+/** The number of vertices in each star of the retained mesh scene */
+#define BENCH_RETAIN_STAR   64
+
+/**
+ * Renders the given scene for several frames, moving every node each frame
+ *
+ * The scene is rendered once before timing starts, so that any retained
+ * meshes are already uploaded. Each frame ends with glFinish, so the time
+ * includes the GPU.
+ *
+ * @param batch The sprite batch to render with
+ * @param root  The root of the scene to render
+ * @param name  The name of the benchmark
+ */
+static void renderScene(const std::shared_ptr<SpriteBatch>& batch,
+                        const std::shared_ptr<scene2::SceneNode>& root, const char* name) {
+    Mat4 perspective;
+    Mat4::createOrthographicOffCenter(0, 1024, 0, 576, -1, 1, &perspective);
+    batch->begin(perspective);
+    root->render(batch, Mat4::IDENTITY, Color4::WHITE);
+    batch->end();
+    glFinish();
+
+    Timestamp start, end;
+    Sint64 heap = heapInUse();
+    start.mark();
+    for(int frame = 0; frame < BENCH_RETAIN_FRAMES; frame++) {
+        Vec2 offset(frame % 2 ? 1.0f : -1.0f, 0.0f);
+        for(auto it = root->getChildren().begin(); it != root->getChildren().end(); ++it) {
+            (*it)->setPosition((*it)->getPosition()+offset);
+        }
+        batch->begin(perspective);
+        root->render(batch, Mat4::IDENTITY, Color4::WHITE);
+        batch->end();
+        glFinish();
+    }
+    end.mark();
+    report(name,start,end,heapInUse()-heap);
+    CULog("%-24s %8u calls %10u vertices",name,batch->getCallsMade(),batch->getVerticesDrawn());
+}
+
+/**
+ * Returns a scene of polygon nodes with the given shape
+ *
+ * @param poly      The shape of each node
+ * @param retained  Whether the nodes use retained meshes
+ *
+ * @return a scene of polygon nodes with the given shape
+ */
+static std::shared_ptr<scene2::SceneNode> makeRetainScene(const Poly2& poly, bool retained) {
+    std::shared_ptr<scene2::SceneNode> root = scene2::SceneNode::alloc();
+    for(int ii = 0; ii < BENCH_RETAIN_NODES; ii++) {
+        std::shared_ptr<scene2::PolygonNode> node = scene2::PolygonNode::allocWithTexture(Texture::getBlank(),poly);
+        node->setPosition((ii % 100)*10.24f,(ii / 100)*5.76f);
+        node->setRetained(retained);
+        root->addChild(node);
+    }
+    return root;
+}
+
+/**
+ * Benchmark for retained GPU meshes
+ *
+ * This renders a scene of ten thousand moving polygon nodes, first with
+ * the nodes batched on the CPU, and then with each node in its own
+ * {@link SpriteMesh}. It does this for both quads and for stars with many
+ * vertices. This benchmark requires an OpenGL context.
+ */
+void cugl::benchRetainedMeshes() {
+    CULog("Running benchmarks for retained meshes.\n");
+    std::shared_ptr<SpriteBatch> batch = SpriteBatch::alloc();
+
+    Poly2 quad(Rect(0,0,8,8));
+    renderScene(batch,makeRetainScene(quad,false),"Quads (batched)");
+    renderScene(batch,makeRetainScene(quad,true),"Quads (retained)");
+
+    SimpleTriangulator triangulator;
+    std::vector<Vec2> star = makeStar(BENCH_RETAIN_STAR);
+    for(auto it = star.begin(); it != star.end(); ++it) {
+        *it *= 0.05f;
+    }
+    triangulator.set(star);
+    triangulator.calculate();
+    Poly2 poly = triangulator.getPolygon();
+    renderScene(batch,makeRetainScene(poly,false),"Stars (batched)");
+    renderScene(batch,makeRetainScene(poly,true),"Stars (retained)");
+
+    CULog("Retained mesh benchmarks complete.\n");
+}
+
+#pragma mark -
+#pragma mark Instanced Sprites
+/** The number of sprites in the instancing benchmark */
+#define BENCH_INSTANCE_SPRITES  100000
+/** The number of frames to render the sprites */
+#define BENCH_INSTANCE_FRAMES   100
+/** The number of rows in the benchmark filmstrip */
+#define BENCH_INSTANCE_ROWS     2
+/** The number of columns in the benchmark filmstrip */
+#define BENCH_INSTANCE_COLS     8
+
+/**
+ * Benchmark for instanced sprites
+ *
+ * This draws a hundred thousand animated sprites that share a filmstrip,
+ * first as textured quads with {@link SpriteBatch#draw}, and then with
+ * {@link SpriteBatch#drawInstanced}. It then renders the same number of
+ * {@link scene2::AnimationNode} objects, which are instanced automatically.
+ * This benchmark requires an OpenGL context.
+ */
+void cugl::benchInstancedSprites() {
+    CULog("Running benchmarks for instanced sprites.\n");
+    Timestamp start, end;
+    Sint64 heap;
+    
+    std::shared_ptr<SpriteBatch> batch = SpriteBatch::alloc();
+    std::shared_ptr<Texture> texture = Texture::alloc(256,64);
+    Mat4 perspective;
+    Mat4::createOrthographicOffCenter(0, 1024, 0, 576, -1, 1, &perspective);
+    
+    const int frames = BENCH_INSTANCE_ROWS*BENCH_INSTANCE_COLS;
+    Rect bounds(0,0,texture->getWidth()/BENCH_INSTANCE_COLS,texture->getHeight()/BENCH_INSTANCE_ROWS);
+    std::vector<Mat4> transforms;
+    transforms.reserve(BENCH_INSTANCE_SPRITES);
+    for(int ii = 0; ii < BENCH_INSTANCE_SPRITES; ii++) {
+        transforms.push_back(Mat4::createTranslation((ii % 400)*2.56f,(ii / 400)*2.304f,0));
+    }
+    
+    heap = heapInUse();
+    start.mark();
+    for(int frame = 0; frame < BENCH_INSTANCE_FRAMES; frame++) {
+        batch->begin(perspective);
+        for(int ii = 0; ii < BENCH_INSTANCE_SPRITES; ii++) {
+            batch->draw(texture, bounds, Vec2::ZERO, transforms[ii]);
+        }
+        batch->end();
+        glFinish();
+    }
+    end.mark();
+    report("Sprites (draw)",start,end,heapInUse()-heap);
+    CULog("%-24s %8u calls %10u vertices","Sprites (draw)",batch->getCallsMade(),batch->getVerticesDrawn());
+    
+    SpriteInstance instance;
+    instance.texrect.set(0,0,1.0f/BENCH_INSTANCE_COLS,1.0f/BENCH_INSTANCE_ROWS);
+    instance.color = Color4f::WHITE;
+    heap = heapInUse();
+    start.mark();
+    for(int frame = 0; frame < BENCH_INSTANCE_FRAMES; frame++) {
+        batch->begin(perspective);
+        batch->setTexture(texture);
+        for(int ii = 0; ii < BENCH_INSTANCE_SPRITES; ii++) {
+            instance.setTransform(transforms[ii], bounds);
+            instance.frame.set((float)((ii+frame) % frames),(float)BENCH_INSTANCE_COLS);
+            batch->drawInstanced(instance);
+        }
+        batch->end();
+        glFinish();
+    }
+    end.mark();
+    report("Sprites (instanced)",start,end,heapInUse()-heap);
+    CULog("%-24s %8u calls %10u vertices","Sprites (instanced)",batch->getCallsMade(),batch->getVerticesDrawn());
+    
+    std::shared_ptr<scene2::SceneNode> root = scene2::SceneNode::alloc();
+    for(int ii = 0; ii < BENCH_INSTANCE_SPRITES; ii++) {
+        auto node = scene2::AnimationNode::alloc(texture,BENCH_INSTANCE_ROWS,BENCH_INSTANCE_COLS);
+        node->setPosition((ii % 400)*2.56f,(ii / 400)*2.304f);
+        root->addChild(node);
+    }
+    
+    heap = heapInUse();
+    start.mark();
+    for(int frame = 0; frame < BENCH_INSTANCE_FRAMES; frame++) {
+        int ii = 0;
+        for(auto it = root->getChildren().begin(); it != root->getChildren().end(); ++it) {
+            auto node = std::dynamic_pointer_cast<scene2::AnimationNode>(*it);
+            node->setFrame((ii+frame) % frames);
+            ii++;
+        }
+        batch->begin(perspective);
+        root->render(batch, Mat4::IDENTITY, Color4::WHITE);
+        batch->end();
+        glFinish();
+    }
+    end.mark();
+    report("Animation nodes",start,end,heapInUse()-heap);
+    CULog("%-24s %8u calls %10u vertices","Animation nodes",batch->getCallsMade(),batch->getVerticesDrawn());
+    
+    CULog("Instanced sprite benchmarks complete.\n");
+}
+
+#pragma mark -
+#pragma mark Ordered Batching
+/** The number of nodes in the ordered batching benchmark */
+#define BENCH_ORDERED_NODES 4000
+
+/**
+ * Returns an ascending ordered scene of interleaved textures
+ *
+ * Every node has the same priority, and the nodes alternate between two
+ * textures. So without batching, every node is its own draw call.
+ *
+ * @param batching  Whether the ordered node regroups by drawing state
+ *
+ * @return an ascending ordered scene of interleaved textures
+ */
+static std::shared_ptr<scene2::SceneNode> makeOrderedScene(bool batching) {
+    std::shared_ptr<Texture> textures[2] = { Texture::alloc(8,8), Texture::alloc(8,8) };
+    std::shared_ptr<scene2::OrderedNode> root = scene2::OrderedNode::allocWithOrder(scene2::OrderedNode::ASCEND);
+    root->setBatching(batching);
+    for(int ii = 0; ii < BENCH_ORDERED_NODES; ii++) {
+        std::shared_ptr<scene2::PolygonNode> node = scene2::PolygonNode::allocWithTexture(textures[ii % 2]);
+        node->setPosition((ii % 100)*10.24f,(ii / 100)*14.4f);
+        root->addChild(node);
+    }
+    return root;
+}
+
+/**
+ * Benchmark for texture-aware batching in ordered nodes
+ *
+ * This renders a scene of moving nodes that alternate between two textures,
+ * all at the same priority, first without and then with batching. The
+ * number of draw calls shows the effect of the regrouping. This benchmark
+ * requires an OpenGL context.
+ */
+void cugl::benchOrderedBatching() {
+    CULog("Running benchmarks for ordered batching.\n");
+    std::shared_ptr<SpriteBatch> batch = SpriteBatch::alloc();
+    renderScene(batch,makeOrderedScene(false),"Ordered (unbatched)");
+    renderScene(batch,makeOrderedScene(true),"Ordered (batched)");
+    CULog("Ordered batching benchmarks complete.\n");
+}
+
+#pragma mark -
+#pragma mark Scene Culling
+/** The number of nodes in the culling benchmark */
+#define BENCH_CULL_NODES    10000
+/** The number of frames to render the culling scene */
+#define BENCH_CULL_FRAMES   100
+/** The zoom factor of the culling scene */
+#define BENCH_CULL_ZOOM     4.0f
+
+/**
+ * Renders the given scene for several frames, panning the root each frame
+ *
+ * @param batch The sprite batch to render with
+ * @param scene The scene to render
+ * @param name  The name of the benchmark
+ */
+static void renderCulling(const std::shared_ptr<SpriteBatch>& batch,
+                          const std::shared_ptr<Scene2>& scene, const char* name) {
+    std::shared_ptr<scene2::SceneNode> root = scene->getChild(0);
+    Timestamp start, end;
+    Sint64 heap = heapInUse();
+    start.mark();
+    for(int frame = 0; frame < BENCH_CULL_FRAMES; frame++) {
+        root->setPositionX(-frame*BENCH_CULL_ZOOM);
+        scene->render(batch);
+        glFinish();
+    }
+    end.mark();
+    report(name,start,end,heapInUse()-heap);
+    CULog("%-24s %8u calls %10u culled nodes",name,batch->getCallsMade(),scene->getCulledNodes());
+}
+
+/**
+ * Benchmark for hierarchical scene culling
+ *
+ * This renders a level several times wider than the screen, zoomed in so
+ * that most of it is off screen, both without and with culling. The level
+ * is organized into columns, so that whole columns may be culled at once.
+ * This benchmark requires an OpenGL context.
+ */
+void cugl::benchSceneCulling() {
+    CULog("Running benchmarks for scene culling.\n");
+    std::shared_ptr<SpriteBatch> batch = SpriteBatch::alloc();
+    std::shared_ptr<Scene2> scene = Scene2::alloc(1024,576);
+    std::shared_ptr<scene2::SceneNode> root = scene2::SceneNode::alloc();
+    root->setScale(BENCH_CULL_ZOOM);
+    scene->addChild(root);
+    
+    const int rows = 50;
+    std::shared_ptr<scene2::SceneNode> column;
+    for(int ii = 0; ii < BENCH_CULL_NODES; ii++) {
+        if (ii % rows == 0) {
+            column = scene2::SceneNode::alloc();
+            column->setPosition((ii/rows)*12.0f-300.0f,0.0f);
+            root->addChild(column);
+        }
+        std::shared_ptr<scene2::PolygonNode> node = scene2::PolygonNode::alloc(Rect(0,0,8,8));
+        node->setPosition(0.0f,(ii % rows)*11.52f);
+        column->addChild(node);
+    }
+    
+    renderCulling(batch,scene,"Scene (no culling)");
+    scene->setCulling(true);
+    renderCulling(batch,scene,"Scene (culling)");
+    CULog("Scene culling benchmarks complete.\n");
+}
+
+#pragma mark -
+#pragma mark Scissor Stack
+/** The number of items in the scrolling list */
+#define BENCH_SCISSOR_ITEMS     1000
+/** The number of frames to scroll the list */
+#define BENCH_SCISSOR_FRAMES    100
+/** The height of each item in the scrolling list */
+#define BENCH_SCISSOR_HEIGHT    24.0f
+
+/**
+ * Renders the given list for several frames, scrolling it each frame
+ *
+ * @param batch The sprite batch to render with
+ * @param root  The root of the scene (the list viewport)
+ * @param name  The name of the benchmark
+ */
+static void renderScrolling(const std::shared_ptr<SpriteBatch>& batch,
+                            const std::shared_ptr<scene2::SceneNode>& root, const char* name) {
+    std::shared_ptr<scene2::SceneNode> list = root->getChild(0);
+    Mat4 perspective;
+    Mat4::createOrthographicOffCenter(0, 1024, 0, 576, -1, 1, &perspective);
+    
+    Timestamp start, end;
+    Sint64 heap = heapInUse();
+    start.mark();
+    for(int frame = 0; frame < BENCH_SCISSOR_FRAMES; frame++) {
+        list->setPositionY(-frame*BENCH_SCISSOR_HEIGHT/4);
+        batch->begin(perspective);
+        root->render(batch, Mat4::IDENTITY, Color4::WHITE);
+        batch->end();
+        glFinish();
+    }
+    end.mark();
+    report(name,start,end,heapInUse()-heap);
+    CULog("%-24s %8u calls %10u vertices",name,batch->getCallsMade(),batch->getVerticesDrawn());
+}
+
+/**
+ * Benchmark for the sprite batch scissor stack
+ *
+ * This renders a scrolling list of clipped items inside of a clipped
+ * viewport, so that every item pushes a nested scissor mask. The list
+ * is rendered upright (which clips with glScissor) and rotated (which
+ * clips in the shader). This benchmark requires an OpenGL context.
+ */
+void cugl::benchScissorStack() {
+    CULog("Running benchmarks for scissor stack.\n");
+    std::shared_ptr<SpriteBatch> batch = SpriteBatch::alloc();
+    std::shared_ptr<scene2::SceneNode> root = scene2::SceneNode::allocWithBounds(Rect(312,48,400,480));
+    root->setScissor();
+    
+    std::shared_ptr<scene2::SceneNode> list = scene2::SceneNode::alloc();
+    list->setAnchor(Vec2::ANCHOR_BOTTOM_LEFT);
+    root->addChild(list);
+    for(int ii = 0; ii < BENCH_SCISSOR_ITEMS; ii++) {
+        std::shared_ptr<scene2::SceneNode> item = scene2::SceneNode::allocWithBounds(Rect(8,ii*BENCH_SCISSOR_HEIGHT,384,BENCH_SCISSOR_HEIGHT-2));
+        item->setScissor();
+        std::shared_ptr<scene2::PolygonNode> label = scene2::PolygonNode::alloc(Rect(0,0,420,BENCH_SCISSOR_HEIGHT));
+        label->setAnchor(Vec2::ANCHOR_BOTTOM_LEFT);
+        label->setPosition(-8.0f,0.0f);
+        item->addChild(label);
+        list->addChild(item);
+    }
+    
+    renderScrolling(batch,root,"Scissor (glScissor)");
+    root->setAngle(0.1f);
+    renderScrolling(batch,root,"Scissor (shader)");
+    CULog("Scissor stack benchmarks complete.\n");
+}
+
+#pragma mark -
+#pragma mark Frame Profiler
+/** The number of zones recorded by the profiler benchmark */
+#define BENCH_PROFILE_ZONES 1000000
+
+/**
+ * Records many nested zones, returning a checksum to defeat optimization
+ *
+ * @param count The number of outer zones to record
+ *
+ * @return a checksum to defeat optimization
+ */
+static Uint64 recordZones(int count) {
+    Uint64 sum = 0;
+    for(int ii = 0; ii < count; ii++) {
+        CUProfileZone("outer");
+        sum += ii;
+        {
+            CUProfileZone("inner");
+            sum ^= (sum << 1);
+        }
+    }
+    return sum;
+}
+
+/**
+ * Benchmark for the frame profiler
+ *
+ * This measures the cost of a CPU zone when the profiler is stopped and
+ * when it is running. A running profiler should never grow the heap.
+ * This benchmark requires an OpenGL context (for the timer queries).
+ */
+void cugl::benchProfiler() {
+    CULog("Running benchmarks for frame profiler.\n");
+    Uint64 sink = 0;
+    Timestamp start, end;
+    Sint64 heap = heapInUse();
+    start.mark();
+    sink += recordZones(BENCH_PROFILE_ZONES/2);
+    end.mark();
+    report("Zones (stopped)",start,end,heapInUse()-heap);
+    
+    Profiler::start();
+    Profiler::get()->beginFrame();
+    heap = heapInUse();
+    start.mark();
+    sink += recordZones(BENCH_PROFILE_ZONES/2);
+    end.mark();
+    report("Zones (running)",start,end,heapInUse()-heap);
+    Profiler::get()->endFrame();
+    
+    CULog("Average inner zone: %.6f ms",Profiler::get()->getAverage("inner"));
+    Profiler::stop();
+    CULog("Frame profiler benchmarks complete (checksum %llu).\n",(unsigned long long)sink);
+}
+
+#pragma mark -
+#pragma mark Benchmark Harness
+
+/**
+ * Master benchmark that invokes all others in this module.
+ */
+void cugl::benchmarkUnitTest() {
+    benchStrings();
+    benchTransforms();
+    benchTriangulation();
+    benchTriangulationCache();
+    benchBoundaries();
+    benchClipping();
+    benchHitTesting();
+    benchPathDrag();
+    benchSmoothing();
+    benchSplineNearest();
+    benchEasing();
+    benchRetainedMeshes();
+    benchInstancedSprites();
+    benchOrderedBatching();
+    benchSceneCulling();
+    benchScissorStack();
+    benchProfiler();
+}
@@ -0,0 +1,203 @@
+//
+//  TCUBenchmark.h
+//  Cornell University Game Library (CUGL)
+//
+//  This module is a suite of micro-benchmarks for performance sensitive code
+//  paths. Unlike the unit tests, these functions are not about correctness
+//  (though they assert that the fast and slow paths agree). They log the
+//  running time and the heap growth of each variant, so that regressions are
+//  easy to spot.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: agent
+//  Version: 10/19/26
+
+#ifndef __T_CU_BENCHMARK_H__
+#define __T_CU_BENCHMARK_H__
+
+namespace cugl {
+
+/**
+ * Benchmark for the string and path functions in strtool and filetool
+ *
+ * This compares the allocating versions of each function against the
+ * std::string_view and output-parameter versions.
+ */
+void benchStrings();
+
+/**
+ * Benchmark for the batched 2d vertex transforms
+ *
+ * This compares transforming each vertex separately with the strided
+ * batch kernels in {@link Mat4} and {@link Affine2}.
+ */
+void benchTransforms();
+
+/**
+ * Benchmark for the polygon triangulators
+ *
+ * This compares the O(n log n) monotone partition of {@link SimpleTriangulator}
+ * with the original ear clipping algorithm on polygons of 100 to 100k vertices.
+ */
+void benchTriangulation();
+
+/**
+ * Benchmark for the triangulation cache
+ *
+ * This builds many solid polygons from a small set of widget shapes, as a
+ * scene loader does. It compares a fresh {@link SimpleTriangulator} for
+ * each polygon with a {@link TriangulationCache}.
+ */
+void benchTriangulationCache();
+
+/**
+ * Benchmark for boundary extraction from triangle meshes
+ *
+ * This extracts the exterior and the boundaries of grid meshes (with a
+ * hole) from one thousand to one million triangles, as is done when a
+ * wireframe outlines a solid polygon.
+ */
+void benchBoundaries();
+
+/**
+ * Benchmark for the polygon boolean operations
+ *
+ * This clips thousands of polygons against a fixed set of walls with
+ * {@link PolyClipper}, as a game might do each frame.
+ */
+void benchClipping();
+
+/**
+ * Benchmark for containment and hit testing
+ *
+ * This measures {@link Poly2#contains} on a large triangulated polygon and
+ * compares {@link Scene2#pick} with a walk of a scene graph with hundreds
+ * of buttons.
+ */
+void benchHitTesting();
+
+/**
+ * Benchmark for incremental path extrusion
+ *
+ * This drags a single point of a long path every frame, as an editor
+ * does. It compares a full extrusion with {@link SimpleExtruder#update}.
+ */
+void benchPathDrag();
+
+/**
+ * Benchmark for path smoothing and spline flattening
+ *
+ * This runs {@link PathSmoother} on noisy gesture paths of 1e5 and 1e6
+ * points, with and without a thread pool. It then flattens splines with
+ * the same number of control points, comparing {@link PolySplineFactory}
+ * with {@link Spline2#flatten}.
+ */
+void benchSmoothing();
+
+/**
+ * Benchmark for nearest point queries on a spline
+ *
+ * This projects mouse positions onto a thousand segment spline, as an
+ * editor does when snapping or picking. It times the first query (which
+ * builds the projection cache), the remaining queries, and the first
+ * query after an edit.
+ */
+void benchSplineNearest();
+
+/**
+ * Benchmark for easing function evaluation
+ *
+ * This eases a transition for a thousand nodes over a thousand frames, as
+ * a UI transition does. It compares the type-erased std::function, the
+ * compile-time functor, and batch evaluation for {@link EasingFunction}.
+ * It then compares the evaluator, batch evaluation, and the lookup table
+ * for {@link EasingBezier}.
+ */
+void benchEasing();
+
+/**
+ * Benchmark for retained GPU meshes
+ *
+ * This renders a scene of ten thousand moving polygon nodes, first with
+ * the nodes batched on the CPU, and then with each node in its own
+ * {@link SpriteMesh}. It does this for both quads and for stars with many
+ * vertices. This benchmark requires an OpenGL context.
+ */
+void benchRetainedMeshes();
+
+/**
+ * Benchmark for instanced sprites
+ *
+ * This draws a hundred thousand animated sprites that share a filmstrip,
+ * first as textured quads with {@link SpriteBatch#draw}, and then with
+ * {@link SpriteBatch#drawInstanced}. It then renders the same number of
+ * {@link scene2::AnimationNode} objects, which are instanced automatically.
+ * This benchmark requires an OpenGL context.
+ */
+void benchInstancedSprites();
+
+/**
+ * Benchmark for texture-aware batching in ordered nodes
+ *
+ * This renders a scene of moving nodes that alternate between two textures,
+ * all at the same priority, first without and then with batching. The
+ * number of draw calls shows the effect of the regrouping. This benchmark
+ * requires an OpenGL context.
+ */
+void benchOrderedBatching();
+
+/**
+ * Benchmark for hierarchical scene culling
+ *
+ * This renders a level several times wider than the screen, zoomed in so
+ * that most of it is off screen, both without and with culling. The level
+ * is organized into columns, so that whole columns may be culled at once.
+ * This benchmark requires an OpenGL context.
+ */
+void benchSceneCulling();
+
+/**
+ * Benchmark for the sprite batch scissor stack
+ *
+ * This renders a scrolling list of clipped items inside of a clipped
+ * viewport, so that every item pushes a nested scissor mask. The list
+ * is rendered upright (which clips with glScissor) and rotated (which
+ * clips in the shader). This benchmark requires an OpenGL context.
+ */
+void benchScissorStack();
+
+/**
+ * Benchmark for the frame profiler
+ *
+ * This measures the cost of a CPU zone when the profiler is stopped and
+ * when it is running. A running profiler should never grow the heap.
+ * This benchmark requires an OpenGL context (for the timer queries).
+ */
+void benchProfiler();
+
+/**
+ * Master benchmark that invokes all others in this module.
+ */
+void benchmarkUnitTest();
+
+}
+
+#endif /* __T_CU_BENCHMARK_H__ */
@@ -0,0 +1,41 @@
+//
+//  main.cpp
+//  CUGL
+//
+//  This is the entry point for the benchmark application. It is a separate
+//  executable from the unit tests, so the benchmarks never slow down or
+//  change the behavior of the tests.
+//
+//  Author: agent
+//  Version: 10/19/26
+//
+
+#include <cugl/cugl.h>
+
+#include "TCUBenchmark.h"
+
+int main(int argc, char * argv[]) {
+    cugl::Application app;
+    app.setName("Benchmark");
+    app.setOrganization("GDIAC");
+    if (!app.init()) {
+        return 1;
+    }
+
+    // The rendering benchmarks need the OpenGL context from the application
+    app.onStartup();
+
+#if defined CU_MATH_VECTOR_NEON64
+    CULog("Neon64 Vectorization Support");
+#elif defined CU_MATH_VECTOR_SSE
+    CULog("SSE Vectorization Support");
+#else
+    CULog("No Vectorization Support");
+#endif
+
+    cugl::benchmarkUnitTest();
+
+    app.quit();
+    app.onShutdown();
+    return 0;
+}
@@ -14,6 +14,10 @@
 
 #include "TCUMathTest.h"
 #include "TCU2DTest.h"
+#include "TCUPolygonTest.h"
+#include "TCURenderTest.h"
+#include "TCUScene2Test.h"
+#include "TCUUtilTest.h"
 
 #include <Accelerate/Accelerate.h>
 
@@ -195,7 +199,11 @@ int main(int argc, char * argv[]) {
     CULog("No Vectorization Support");
 #endif
     
+    cugl::utilUnitTest();
     cugl::mathUnitTest();
+    cugl::polygonUnitTest();
+    cugl::scene2UnitTest();
+    cugl::renderUnitTest();
 
     //cugl::sceneUnitTest();
     //testBinary();
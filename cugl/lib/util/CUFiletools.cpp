@@ -74,6 +74,24 @@ bool is_sep(char c) {
     return c == '/' || c == '\\';
 }
 
+/**
+ * Returns the position just after the last separator in path.
+ *
+ * If there is no separator in path, this function returns 0 and sets found
+ * to false.
+ *
+ * @param path  The file path name
+ * @param found Pointer to store whether a separator was found
+ *
+ * @return the position just after the last separator in path.
+ */
+static size_t leaf_pos(std::string_view path, bool* found) {
+    size_t pos;
+    for(pos = path.size(); pos > 0 && !is_sep(path[pos-1]); pos--) {}
+    *found = pos > 0;
+    return pos;
+}
+
 /**
  * Returns an absolute (and normalized) path equivalent to path.
  *
@@ -163,9 +181,10 @@ bool is_dir(const std::string path) {
  *
  * @return true if the file named by this path name is a hidden file.
  */
-bool is_hidden(const std::string path) {
-    const std::string base = base_name(path);
-    return base.size() > 0 && base[0] == '.';
+bool is_hidden(std::string_view path) {
+    bool found;
+    size_t pos = leaf_pos(path,&found);
+    return pos < path.size() && path[pos] == '.';
 }
 
 /**
@@ -177,7 +196,7 @@ bool is_hidden(const std::string path) {
  *
  * @return true if this path name is absolute.
  */
-bool is_absolute(const std::string path) {
+bool is_absolute(std::string_view path) {
     // Be OS agnostic
     if (path.size() == 0) {
         return false;
@@ -291,14 +310,12 @@ Uint64 file_timestamp(const std::string path) {
     std::wstring wide = converter.from_bytes(fullpath);
     HANDLE handle = FindFirstFile(wide.c_str(), &search_data);
 
+    // This is a search handle, so the times come from the search data
     Uint64 result = 0;
-    FILETIME creationTime;
-    FILETIME lastAccessTime;
-    FILETIME lastWriteTime;
-    bool ok = GetFileTime(handle, &creationTime, &lastAccessTime, &lastWriteTime);
+    bool ok = handle != INVALID_HANDLE_VALUE;
     if (ok) {
         FILETIME localFileTime;
-        FileTimeToLocalFileTime(&lastWriteTime, &localFileTime);
+        FileTimeToLocalFileTime(&search_data.ftLastWriteTime, &localFileTime);
         SYSTEMTIME sysTime;
         FileTimeToSystemTime(&localFileTime, &sysTime);
         struct tm tmtime = { 0 };
@@ -313,9 +330,8 @@ Uint64 file_timestamp(const std::string path) {
         tmtime.tm_isdst = -1;
         time_t ret = mktime(&tmtime);
         result = static_cast<Uint64> (ret);
+        FindClose(handle);
     }
-
-    FindClose(handle);
     return result;
 #else
     struct stat status;
@@ -351,23 +367,27 @@ Uint64 file_timestamp(const std::string path) {
  * @return the suffix for the leaf file of this path.
  */
 const std::string dir_name(const std::string path) {
-    if (path.empty()) {
-        return "";
-    }
-    bool goon = true;
-    size_t pos;
-    for(pos = path.size(); pos > 0 && goon; ) {
-        if (is_sep(path[pos-1])) {
-            goon = false;
-        } else {
-            pos--;
-        }
-    }
-    
-    if (goon) {
-        return "";
+    std::string result;
+    dir_name(path,result);
+    return result;
+}
+
+/**
+ * Stores the path name of the parent directory for this file in result.
+ *
+ * This is the same as {@link dir_name}, except that it reuses the buffer
+ * of result instead of allocating a new string.
+ *
+ * @param path      The file path name
+ * @param result    The string to store the parent directory
+ */
+void dir_name(std::string_view path, std::string& result) {
+    bool found;
+    size_t pos = leaf_pos(path,&found);
+    if (found) {
+        result.assign(path.data(),pos-1);
     } else {
-        return path.substr(0,pos-1);
+        result.clear();
     }
 }
 
@@ -383,24 +403,24 @@ const std::string dir_name(const std::string path) {
  * @return the suffix for the leaf file of this path.
  */
 const std::string base_name(const std::string path) {
-    if (path.empty()) {
-        return "";
-     }
-     bool goon = true;
-     size_t pos;
-     for(pos = path.size(); pos > 0 && goon; ) {
-         if (is_sep(path[pos-1])) {
-             goon = false;
-         } else {
-             pos--;
-         }
-     }
-     
-     if (goon) {
-         return path;
-     } else {
-         return path.substr(pos);
-     }
+    std::string result;
+    base_name(path,result);
+    return result;
+}
+
+/**
+ * Stores the name of the leaf file of this path in result.
+ *
+ * This is the same as {@link base_name}, except that it reuses the buffer
+ * of result instead of allocating a new string.
+ *
+ * @param path      The file path name
+ * @param result    The string to store the leaf file name
+ */
+void base_name(std::string_view path, std::string& result) {
+    bool found;
+    size_t pos = leaf_pos(path,&found);
+    result.assign(path.data()+pos,path.size()-pos);
 }
 
 /**
@@ -416,24 +436,30 @@ const std::string base_name(const std::string path) {
  * @return the pair of a leaf file and its parent directory.
  */
 std::pair<std::string, std::string> split_path(const std::string path) {
-    if (path.empty()) {
-        return std::pair<std::string, std::string>("","");
-    }
-    bool goon = true;
-    size_t pos;
-    for(pos = path.size(); pos > 0 && goon; ) {
-        if (is_sep(path[pos-1])) {
-            goon = false;
-        } else {
-            pos--;
-        }
-    }
-    
-    if (goon) {
-        return std::pair<std::string, std::string>("",path);
+    std::pair<std::string, std::string> result;
+    split_path(path,result.first,result.second);
+    return result;
+}
+
+/**
+ * Stores the leaf file and its parent directory in the given strings.
+ *
+ * This is the same as {@link split_path}, except that it reuses the
+ * buffers of dir and base instead of allocating new strings.
+ *
+ * @param path  The file path name
+ * @param dir   The string to store the parent directory
+ * @param base  The string to store the leaf file name
+ */
+void split_path(std::string_view path, std::string& dir, std::string& base) {
+    bool found;
+    size_t pos = leaf_pos(path,&found);
+    if (found) {
+        dir.assign(path.data(),pos-1);
     } else {
-        return std::pair<std::string, std::string>(path.substr(0,pos-1),path.substr(pos));
+        dir.clear();
     }
+    base.assign(path.data()+pos,path.size()-pos);
 }
 
 /**
@@ -666,53 +692,75 @@ std::pair<std::string, std::string> split_base(const std::string path) {
  * @return the given path, normalized to the current platform
  */
 const std::string normalize_path(const std::string path) {
-    std::vector<std::string> items = fullsplit_path(path);
-    
-    // Handle the redundancies
-    std::vector<std::string> canonical;
-    for(auto it = items.begin(); it != items.end(); ++it) {
-        if (*it == "..") {
-            CUAssertLog(!canonical.empty(),"Error while canonicalizing pathname");
-            canonical.erase(canonical.end()-1);
-        } else if (*it != "." && *it != "") {
-            canonical.push_back(*it);
+    std::string result;
+    normalize_path(path,result);
+    return result;
+}
+
+/**
+ * Stores the given path, normalized to the current platform, in result.
+ *
+ * This is the same as {@link normalize_path}, except that it reuses the
+ * buffer of result.  The path is normalized in a single pass, without
+ * splitting it into a vector of components first.
+ *
+ * @param path      The file path name
+ * @param result    The string to store the normalized path
+ */
+void normalize_path(std::string_view path, std::string& result) {
+    result.clear();
+    result.reserve(path.size());
+
+    // Process the components in place, splitting like fullsplit_path
+    size_t last = 0;
+    size_t pos = path.find(':');
+    pos = pos == std::string_view::npos ? 1 : pos+1;
+    for(; pos <= path.size(); pos++) {
+        if (pos < path.size() && !is_sep(path[pos])) {
+            continue;
+        } else if (pos == path.size() && last >= path.size()) {
+            break;
+        }
+
+        std::string_view item = path.substr(last,pos-last);
+        last = pos+1;
+        if (item == "..") {
+            // Components never contain a separator, so this removes exactly one
+            CUAssertLog(!result.empty(),"Error while canonicalizing pathname");
+            size_t cut = result.rfind(path_sep);
+            result.resize(cut == std::string::npos ? 0 : cut);
+        } else if (item != "." && !item.empty()) {
+            if (!result.empty()) {
+                result.push_back(path_sep);
+            }
+            result.append(item.data(),item.size());
         }
     }
-    
-    if (canonical.empty()) {
-        return std::string();
+
+    if (result.empty()) {
+        return;
     }
-    
+
     // Treat the initial part special
-    std::string prefix = canonical[0];
+    size_t first = result.find(path_sep,1);
+    size_t prefix = first == std::string::npos ? result.size() : first;
 #if defined (__WINDOWS__)
-    if (prefix.size() > 0 && prefix[0] == '/') {
+    if (result[0] == '/') {
         char currDir[255];
         GetCurrentDirectoryA(255, currDir);
-        std::string volume(currDir,3);
-        if (volume[1] == ':') {
-            canonical[0] = volume+prefix.substr(1);
+        if (currDir[1] == ':') {
+            result.replace(0,1,currDir,3);
         }
     }
 #else
-    if (prefix.size() > 1 && prefix[1] == ':') {
-        if (prefix.size() > 2 && (prefix[2] == '/' || prefix[2] == '\\')) {
-            canonical[0] = "/"+prefix.substr(3);
+    if (prefix > 1 && result[1] == ':') {
+        if (prefix > 2 && (result[2] == '/' || result[2] == '\\')) {
+            result.replace(0,3,"/");
         } else {
-            canonical[0] = prefix.substr(2);
+            result.erase(0,2);
         }
     }
 #endif
-    
-    std::stringstream result;
-    for(size_t pos = 0; pos < canonical.size(); pos++) {
-        result << canonical[pos];
-        if (pos < canonical.size()-1) {
-            result << path_sep;
-        }
-    }
-
-    return result.str();
 }
 
 /**
@@ -962,6 +1010,31 @@ const std::string join_path(const std::string* elts, size_t size) {
     return result.str();
 }
 
+/**
+ * Stores a path that is the concatentation of elts in result.
+ *
+ * This is the same as {@link join_path}, except that it reuses the buffer
+ * of result.  The buffer is sized once, so there is at most one allocation
+ * (and none if result is already large enough).
+ *
+ * @param elts      The strings to join
+ * @param result    The string to store the path
+ */
+void join_path(std::initializer_list<std::string_view> elts, std::string& result) {
+    size_t total = elts.size();
+    for(auto it = elts.begin(); it != elts.end(); ++it) {
+        total += it->size();
+    }
+    result.clear();
+    result.reserve(total);
+    for(auto it = elts.begin(); it != elts.end(); ++it) {
+        if (it != elts.begin()) {
+            result.push_back(path_sep);
+        }
+        result.append(it->data(),it->size());
+    }
+}
+
 
 #pragma mark -
 #pragma mark File Manipulation
@@ -0,0 +1,681 @@
+//
+//  CUProfiler.cpp
+//  Cornell University Game Library (CUGL)
+//
+//  This module provides a frame profiler. The application FPS and the sprite
+//  batch statistics can tell us that a frame is slow, but not why. This
+//  profiler records named zones of CPU time (update, render, flush, audio)
+//  and of GPU time (via timer queries) into ring buffers. The results can be
+//  exported as Chrome trace JSON (for chrome://tracing or Perfetto), or drawn
+//  as an overlay in the game itself.
+//
+//  This class is a singleton, like the AudioEngine. You start it with the
+//  static method start(), and access it with get(). Zones are best recorded
+//  with the CUProfileZone and CUProfileGPUZone macros, which do nothing if the
+//  profiler is not running.
+//
+//  CUGL MIT License:
+//      This software is provided 'as-is', without any express or implied
+//      warranty.  In no event will the authors be held liable for any damages
+//      arising from the use of this software.
+//
+//      Permission is granted to anyone to use this software for any purpose,
+//      including commercial applications, and to alter it and redistribute it
+//      freely, subject to the following restrictions:
+//
+//      1. The origin of this software must not be misrepresented; you must not
+//      claim that you wrote the original software. If you use this software
+//      in a product, an acknowledgment in the product documentation would be
+//      appreciated but is not required.
+//
+//      2. Altered source versions must be plainly marked as such, and must not
+//      be misrepresented as being the original software.
+//
+//      3. This notice may not be removed or altered from any source distribution.
+//
+//  Author: agent
+//  Version: 10/19/26
+//
+#include <cugl/util/CUProfiler.h>
+#include <cugl/util/CUDebug.h>
+#include <cugl/assets/CUJsonValue.h>
+#include <cugl/io/CUJsonWriter.h>
+#include <cugl/render/CUSpriteBatch.h>
+#include <cugl/math/CURect.h>
+#include <cugl/math/CUColor4.h>
+#include <cstring>
+
+using namespace cugl;
+
+/** The number of GPU timer queries (the maximum in flight at once) */
+#define QUERY_COUNT     128
+/** The maximum nesting depth of zones on the main track */
+#define ZONE_DEPTH      32
+/** The nanoseconds spanned by the height of the overlay */
+#define OVERLAY_RANGE   50000000.0f
+/** The nanoseconds in a frame at 60 fps */
+#define OVERLAY_60FPS   16666667.0f
+/** The nanoseconds in a frame at 30 fps */
+#define OVERLAY_30FPS   33333333.0f
+
+#if CU_GL_PLATFORM == CU_GL_OPENGLES
+    // These are defined by EXT_disjoint_timer_query
+    #ifndef GL_TIME_ELAPSED_EXT
+        #define GL_TIME_ELAPSED_EXT 0x88BF
+    #endif
+    #ifndef GL_GPU_DISJOINT_EXT
+        #define GL_GPU_DISJOINT_EXT 0x8FBB
+    #endif
+    /** The query target for GPU zones */
+    #define TIMER_TARGET    GL_TIME_ELAPSED_EXT
+    /** The function type of glGetQueryObjectui64vEXT */
+    typedef void (*cu_query_ui64_t)(GLuint id, GLenum pname, GLuint64* params);
+    /** The function glGetQueryObjectui64vEXT (loaded at runtime) */
+    static cu_query_ui64_t glGetQueryObjectui64vEXT_ = nullptr;
+#else
+    /** The query target for GPU zones */
+    #define TIMER_TARGET    GL_TIME_ELAPSED
+#endif
+
+/** Reference to the profiler singleton */
+Profiler* Profiler::_gProfiler = nullptr;
+
+/**
+ * Returns true if this device supports GPU timer queries
+ *
+ * On OpenGLES, this also loads the extension functions.
+ *
+ * @return true if this device supports GPU timer queries
+ */
+static bool has_timer_queries() {
+#if CU_GL_PLATFORM == CU_GL_OPENGLES
+    if (!SDL_GL_ExtensionSupported("GL_EXT_disjoint_timer_query")) {
+        return false;
+    }
+    glGetQueryObjectui64vEXT_ = (cu_query_ui64_t)SDL_GL_GetProcAddress("glGetQueryObjectui64vEXT");
+    return glGetQueryObjectui64vEXT_ != nullptr;
+#else
+    // Core since OpenGL 3.3
+    return true;
+#endif
+}
+
+/**
+ * Returns the result of the given timer query in nanoseconds
+ *
+ * The result must be available, or this function will stall.
+ *
+ * @param query The timer query
+ *
+ * @return the result of the given timer query in nanoseconds
+ */
+static Uint64 get_elapsed(GLuint query) {
+    GLuint64 result = 0;
+#if CU_GL_PLATFORM == CU_GL_OPENGLES
+    glGetQueryObjectui64vEXT_(query, GL_QUERY_RESULT, &result);
+#else
+    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &result);
+#endif
+    return (Uint64)result;
+}
+
+/**
+ * Returns the overlay color for the zone with the given name
+ *
+ * The color is chosen by a hash of the name, so that it is the same in
+ * every frame.
+ *
+ * @param name  The zone name
+ *
+ * @return the overlay color for the zone with the given name
+ */
+static Color4f zone_color(const char* name) {
+    static const Color4f palette[] = {
+        Color4f(0.30f, 0.69f, 0.31f, 0.9f),
+        Color4f(0.13f, 0.59f, 0.95f, 0.9f),
+        Color4f(1.00f, 0.76f, 0.03f, 0.9f),
+        Color4f(0.91f, 0.12f, 0.39f, 0.9f),
+        Color4f(0.61f, 0.15f, 0.69f, 0.9f),
+        Color4f(0.00f, 0.74f, 0.83f, 0.9f)
+    };
+    Uint32 hash = 5381;
+    for(const char* c = name; *c; c++) {
+        hash = hash*33+(Uint8)(*c);
+    }
+    return palette[hash % (sizeof(palette)/sizeof(Color4f))];
+}
+
+/**
+ * Returns the name of the given track for a Chrome trace
+ *
+ * @param track The profiler track
+ *
+ * @return the name of the given track for a Chrome trace
+ */
+static const char* track_name(Profiler::Track track) {
+    switch (track) {
+        case Profiler::Track::MAIN:
+            return "Main";
+        case Profiler::Track::THREAD:
+            return "Threads";
+        case Profiler::Track::GPU:
+            return "GPU";
+    }
+    return "Unknown";
+}
+
+#pragma mark -
+#pragma mark Constructors
+/**
+ * Creates a new profiler with the given capacity.
+ *
+ * This constructor is private. Use {@link #start} instead.
+ *
+ * @param capacity  The number of zones kept on each track
+ */
+Profiler::Profiler(Uint32 capacity) :
+_enabled(true),
+_frame(0),
+_inframe(false),
+_main(capacity),
+_gpu(capacity),
+_thread(capacity),
+_dropped(0),
+_depth(0),
+_gpuTimers(false),
+_queryTail(0),
+_queryCount(0),
+_gpuOpen(false),
+_gpuIgnored(0) {
+    _origin.mark();
+    _stack.resize(ZONE_DEPTH);
+
+    _gpuTimers = has_timer_queries();
+    if (_gpuTimers) {
+        GLuint queries[QUERY_COUNT];
+        glGenQueries(QUERY_COUNT, queries);
+        _queries.resize(QUERY_COUNT);
+        for(int ii = 0; ii < QUERY_COUNT; ii++) {
+            _queries[ii].query = queries[ii];
+            _queries[ii].name  = nullptr;
+            _queries[ii].start = 0;
+            _queries[ii].frame = 0;
+        }
+    }
+}
+
+/**
+ * Deletes this profiler, releasing all resources.
+ *
+ * This destructor is private. Use {@link #stop} instead.
+ */
+Profiler::~Profiler() {
+    for(auto it = _queries.begin(); it != _queries.end(); ++it) {
+        glDeleteQueries(1, &(it->query));
+    }
+    _queries.clear();
+}
+
+/**
+ * Starts the singleton profiler.
+ *
+ * Once this method is called, the method get() will no longer return
+ * nullptr. Calling the method multiple times (without calling stop) will
+ * have no effect. This method must be called after the OpenGL context
+ * is created, as it allocates the GPU timer queries.
+ *
+ * @param capacity  The number of zones kept on each track
+ *
+ * @return true if the profiler was successfully started
+ */
+bool Profiler::start(Uint32 capacity) {
+    if (_gProfiler != nullptr) {
+        return false;
+    }
+    CUAssertLog(capacity > 0, "The profiler capacity must be positive");
+    _gProfiler = new Profiler(capacity);
+    if (!_gProfiler->_gpuTimers) {
+        CULog("GPU timer queries are not supported; GPU zones are disabled");
+    }
+    return true;
+}
+
+/**
+ * Shuts down the singleton profiler, releasing all resources.
+ *
+ * Once this method is called, the method get() will return nullptr.
+ * Calling the method multiple times (without calling start) will have
+ * no effect.
+ */
+void Profiler::stop() {
+    if (_gProfiler == nullptr) {
+        return;
+    }
+    Profiler* profiler = _gProfiler;
+    _gProfiler = nullptr;
+    delete profiler;
+}
+
+#pragma mark -
+#pragma mark Attributes
+/**
+ * Sets whether the profiler is recording zones.
+ *
+ * A profiler that is not enabled ignores all zones. This allows you to
+ * freeze the current contents of the ring buffers for inspection.
+ *
+ * @param value Whether the profiler is recording zones.
+ */
+void Profiler::setEnabled(bool value) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _enabled = value;
+}
+
+/**
+ * Removes all recorded zones.
+ *
+ * Queries that are still waiting on the GPU will be recorded when they
+ * complete.
+ */
+void Profiler::clear() {
+    _main.clear();
+    _gpu.clear();
+    std::lock_guard<std::mutex> lock(_mutex);
+    _thread.clear();
+}
+
+#pragma mark -
+#pragma mark Recording
+/**
+ * Marks the start of a new frame.
+ *
+ * This opens a zone named "frame" at depth 0 on the main track. This
+ * method is called by the {@link Application} and should not be called
+ * directly.
+ */
+void Profiler::beginFrame() {
+    if (_inframe) {
+        endFrame();
+    }
+    _frame++;
+    _inframe = true;
+    beginZone("frame");
+}
+
+/**
+ * Marks the end of the current frame.
+ *
+ * This closes the frame zone and collects the results of any finished
+ * GPU timer queries. This method is called by the {@link Application}
+ * and should not be called directly.
+ */
+void Profiler::endFrame() {
+    if (!_inframe) {
+        return;
+    }
+    // Close any zones left open by mistake
+    while (_depth > 1) {
+        endZone();
+    }
+    endZone();
+    _inframe = false;
+    collectQueries();
+}
+
+/**
+ * Opens a zone on the main track.
+ *
+ * This zone is nested inside of any zone that is currently open. The
+ * name must outlive the profiler, as it is not copied. This method may
+ * only be called on the main thread.
+ *
+ * @param name  The name of the zone
+ */
+void Profiler::beginZone(const char* name) {
+    if (_depth < _stack.size()) {
+        _stack[_depth].name  = name;
+        _stack[_depth].start = now();
+    }
+    _depth++;
+}
+
+/**
+ * Closes the most recent zone on the main track.
+ *
+ * This method may only be called on the main thread.
+ */
+void Profiler::endZone() {
+    CUAssertLog(_depth > 0, "There is no open zone");
+    if (_depth == 0) {
+        return;
+    }
+    _depth--;
+    if (_enabled && _depth < _stack.size()) {
+        Zone zone;
+        zone.name  = _stack[_depth].name;
+        zone.start = _stack[_depth].start;
+        zone.duration = now()-zone.start;
+        zone.frame = _frame.load();
+        zone.depth = (Uint32)_depth;
+        zone.track = Track::MAIN;
+        _main.push(zone);
+    }
+}
+
+/**
+ * Records a completed zone from a thread other than the main thread.
+ *
+ * The times should come from {@link #now}. This method never blocks.
+ * If the main thread is reading the thread track, the zone is dropped.
+ *
+ * @param name  The name of the zone
+ * @param start The start time of the zone in nanoseconds
+ * @param end   The end time of the zone in nanoseconds
+ */
+void Profiler::recordZone(const char* name, Uint64 start, Uint64 end) {
+    std::unique_lock<std::mutex> lock(_mutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        _dropped++;
+        return;
+    } else if (!_enabled) {
+        return;
+    }
+    Zone zone;
+    zone.name  = name;
+    zone.start = start;
+    zone.duration = end > start ? end-start : 0;
+    zone.frame = _frame.load();
+    zone.depth = 0;
+    zone.track = Track::THREAD;
+    _thread.push(zone);
+}
+
+/**
+ * Opens a GPU zone, measuring all commands until {@link #endGPUZone}.
+ *
+ * GPU zones may not nest. If a GPU zone is already open, this method
+ * (and its matching call to endGPUZone) is ignored. It is also ignored
+ * if the device has no timer queries, or if every query is still waiting
+ * on the GPU.
+ *
+ * @param name  The name of the zone
+ */
+void Profiler::beginGPUZone(const char* name) {
+    if (_gpuOpen || !_gpuTimers || !_enabled || _queryCount == _queries.size()) {
+        _gpuIgnored++;
+        return;
+    }
+    Query& query = _queries[(_queryTail+_queryCount) % _queries.size()];
+    query.name  = name;
+    query.start = now();
+    query.frame = _frame.load();
+    glBeginQuery(TIMER_TARGET, query.query);
+    _queryCount++;
+    _gpuOpen = true;
+}
+
+/**
+ * Closes the current GPU zone.
+ *
+ * The result of the zone is collected at the end of a later frame.
+ */
+void Profiler::endGPUZone() {
+    if (_gpuIgnored > 0) {
+        _gpuIgnored--;
+        return;
+    } else if (!_gpuOpen) {
+        return;
+    }
+    glEndQuery(TIMER_TARGET);
+    _gpuOpen = false;
+}
+
+#pragma mark -
+#pragma mark Results
+/**
+ * Returns the zones on the given track, from oldest to newest.
+ *
+ * Zones on the main and thread tracks are ordered by end time. Zones on
+ * the GPU track are ordered by start time.
+ *
+ * @param track The track to query
+ *
+ * @return the zones on the given track, from oldest to newest.
+ */
+std::vector<Profiler::Zone> Profiler::getZones(Track track) const {
+    std::vector<Zone> result;
+    if (track == Track::THREAD) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        result.reserve(_thread.size);
+        for(size_t ii = 0; ii < _thread.size; ii++) {
+            result.push_back(_thread.at(ii));
+        }
+    } else {
+        const Ring& ring = (track == Track::MAIN ? _main : _gpu);
+        result.reserve(ring.size);
+        for(size_t ii = 0; ii < ring.size; ii++) {
+            result.push_back(ring.at(ii));
+        }
+    }
+    return result;
+}
+
+/**
+ * Returns the average duration of the named zone in milliseconds.
+ *
+ * The average is taken over the recorded zones on the given track. It is
+ * 0 if there are no such zones.
+ *
+ * @param name  The name of the zone
+ * @param track The track of the zone
+ *
+ * @return the average duration of the named zone in milliseconds.
+ */
+float Profiler::getAverage(const std::string& name, Track track) const {
+    std::vector<Zone> zones = getZones(track);
+    Uint64 total = 0;
+    Uint32 count = 0;
+    for(auto it = zones.begin(); it != zones.end(); ++it) {
+        if (name == it->name) {
+            total += it->duration;
+            count++;
+        }
+    }
+    return count == 0 ? 0.0f : (float)(total/(count*1000000.0));
+}
+
+/**
+ * Returns the recorded zones as a Chrome trace.
+ *
+ * The trace uses the JSON object format of the Chrome trace event
+ * profiler, and can be opened with chrome://tracing or Perfetto. Each
+ * track is a separate thread of process 0.
+ *
+ * @return the recorded zones as a Chrome trace.
+ */
+std::shared_ptr<JsonValue> Profiler::getChromeTrace() const {
+    std::shared_ptr<JsonValue> events = JsonValue::allocArray();
+    const Track tracks[] = { Track::MAIN, Track::THREAD, Track::GPU };
+    for(Track track : tracks) {
+        std::shared_ptr<JsonValue> meta = JsonValue::allocObject();
+        meta->appendValue("name", "thread_name");
+        meta->appendValue("ph", "M");
+        meta->appendValue("pid", 0L);
+        meta->appendValue("tid", (long)track);
+        std::shared_ptr<JsonValue> args = JsonValue::allocObject();
+        args->appendValue("name", track_name(track));
+        meta->appendChild("args", args);
+        events->appendChild(meta);
+
+        std::vector<Zone> zones = getZones(track);
+        for(auto it = zones.begin(); it != zones.end(); ++it) {
+            std::shared_ptr<JsonValue> event = JsonValue::allocObject();
+            event->appendValue("name", it->name);
+            event->appendValue("cat", track == Track::GPU ? "gpu" : "cpu");
+            event->appendValue("ph", "X");
+            event->appendValue("ts", it->start/1000.0);
+            event->appendValue("dur", it->duration/1000.0);
+            event->appendValue("pid", 0L);
+            event->appendValue("tid", (long)track);
+            args = JsonValue::allocObject();
+            args->appendValue("frame", (long)it->frame);
+            event->appendChild("args", args);
+            events->appendChild(event);
+        }
+    }
+
+    std::shared_ptr<JsonValue> result = JsonValue::allocObject();
+    result->appendChild("traceEvents", events);
+    result->appendValue("displayTimeUnit", "ms");
+    return result;
+}
+
+/**
+ * Writes the recorded zones to the given file as a Chrome trace.
+ *
+ * The file uses the JSON object format of the Chrome trace event
+ * profiler, and can be opened with chrome://tracing or Perfetto.
+ *
+ * @param path  The path of the file to write
+ *
+ * @return true if the file was successfully written
+ */
+bool Profiler::writeChromeTrace(const std::string& path) const {
+    std::shared_ptr<JsonWriter> writer = JsonWriter::alloc(path);
+    if (writer == nullptr) {
+        CULogError("Could not open %s for writing", path.c_str());
+        return false;
+    }
+    writer->writeJson(getChromeTrace(),false);
+    writer->close();
+    return true;
+}
+
+/**
+ * Draws the recent frames as an overlay with the given sprite batch.
+ *
+ * Each frame is drawn as a vertical bar, with the most recent frame on
+ * the right. The bar is the frame time, divided into the zones at depth
+ * 1 (such as update and render). A thinner bar to its right is the GPU
+ * time of the frame. The horizontal lines mark 1/60 and 1/30 seconds.
+ *
+ * The overlay is drawn in the coordinate space of the current sprite
+ * batch perspective. The sprite batch must be active. This method
+ * changes the texture, color, and blend state of the sprite batch.
+ *
+ * @param batch     The sprite batch to draw with
+ * @param bounds    The bounding box of the overlay
+ * @param frames    The number of frames to draw
+ */
+void Profiler::draw(const std::shared_ptr<SpriteBatch>& batch, const Rect& bounds, Uint32 frames) const {
+    if (frames == 0) {
+        return;
+    }
+
+    const float slot  = bounds.size.width/frames;
+    const float scale = bounds.size.height/OVERLAY_RANGE;
+    const float right = bounds.getMaxX();
+    const Uint32 current = _frame.load();
+
+    batch->setTexture(nullptr);
+    batch->setBlendEquation(GL_FUNC_ADD);
+    batch->setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    batch->setColor(Color4f(0.0f, 0.0f, 0.0f, 0.5f));
+    batch->fill(bounds);
+
+    // CPU zones, newest to oldest (each frame precedes its children)
+    Uint32 frameid = 0;
+    Uint64 framestart = 0;
+    for(size_t ii = _main.size; ii > 0; ii--) {
+        const Zone& zone = _main.at(ii-1);
+        Uint32 age = current-zone.frame;
+        if (age >= frames) {
+            break;
+        } else if (zone.depth > 1) {
+            continue;
+        }
+
+        float x = right-(age+1)*slot;
+        if (zone.depth == 0) {
+            frameid = zone.frame;
+            framestart = zone.start;
+            batch->setColor(Color4f(0.6f, 0.6f, 0.6f, 0.8f));
+            batch->fill(Rect(x, bounds.origin.y, slot*0.6f, zone.duration*scale));
+        } else if (zone.frame == frameid && zone.start >= framestart) {
+            float y = bounds.origin.y+(zone.start-framestart)*scale;
+            batch->setColor(zone_color(zone.name));
+            batch->fill(Rect(x, y, slot*0.6f, zone.duration*scale));
+        }
+    }
+
+    // GPU zones, stacked per frame
+    float offset = 0;
+    frameid = 0;
+    batch->setColor(Color4f(1.0f, 0.34f, 0.13f, 0.9f));
+    for(size_t ii = 0; ii < _gpu.size; ii++) {
+        const Zone& zone = _gpu.at(ii);
+        Uint32 age = current-zone.frame;
+        if (age >= frames) {
+            continue;
+        } else if (zone.frame != frameid) {
+            frameid = zone.frame;
+            offset = 0;
+        }
+        float x = right-(age+1)*slot+slot*0.6f;
+        float h = zone.duration*scale;
+        batch->fill(Rect(x, bounds.origin.y+offset, slot*0.3f, h));
+        offset += h;
+    }
+
+    // Frame budget lines
+    batch->setColor(Color4f(1.0f, 1.0f, 1.0f, 0.6f));
+    batch->fill(Rect(bounds.origin.x, bounds.origin.y+OVERLAY_60FPS*scale, bounds.size.width, 1));
+    batch->fill(Rect(bounds.origin.x, bounds.origin.y+OVERLAY_30FPS*scale, bounds.size.width, 1));
+}
+
+#pragma mark -
+#pragma mark Internal Helpers
+/**
+ * Collects the results of any finished GPU timer queries.
+ *
+ * The queries are collected in order, so this stops at the first query
+ * that is not yet available. If the GPU reports a disjoint event, the
+ * collected results are discarded.
+ */
+void Profiler::collectQueries() {
+    size_t ready = _queryCount-(_gpuOpen ? 1 : 0);
+    if (ready == 0) {
+        return;
+    }
+
+    bool disjoint = false;
+#if CU_GL_PLATFORM == CU_GL_OPENGLES
+    GLint value = 0;
+    glGetIntegerv(GL_GPU_DISJOINT_EXT, &value);
+    disjoint = value != 0;
+#endif
+
+    while (ready > 0) {
+        Query& query = _queries[_queryTail];
+        GLuint available = 0;
+        glGetQueryObjectuiv(query.query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            break;
+        }
+
+        Uint64 elapsed = get_elapsed(query.query);
+        if (!disjoint && _enabled) {
+            Zone zone;
+            zone.name  = query.name;
+            zone.start = query.start;
+            zone.duration = elapsed;
+            zone.frame = query.frame;
+            zone.depth = 0;
+            zone.track = Track::GPU;
+            _gpu.push(zone);
+        }
+        _queryTail = (_queryTail+1) % _queries.size();
+        _queryCount--;
+        ready--;
+    }
+}
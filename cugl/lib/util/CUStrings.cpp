@@ -39,11 +39,23 @@
 #include <sstream>
 #include <cugl/util/CUStrings.h>
 #include <cugl/util/CUDebug.h>
-
-#if defined (__ANDROID__)
+#include <charconv>
+#include <cerrno>
+#include <cmath>
 #include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#if !defined (__cpp_lib_to_chars)
+    #include <locale.h>
+    #if defined (__APPLE__)
+        #include <xlocale.h>
+    #endif
 #endif
 
+/** The largest floating point string that strtod fallback will parse */
+#define STRTOOL_NUMBER_BUFFER 64
+
 namespace cugl {
 namespace strtool {
 
@@ -443,6 +455,148 @@ std::string to_string(double* array, size_t length, size_t offset, int precision
 
 #pragma mark -
 #pragma mark STRING TO NUMBER FUNCTIONS
+/**
+ * Returns the position of the first number character in str.
+ *
+ * This skips any leading whitespace and a leading plus sign, neither of which
+ * are accepted by std::from_chars.  If base is 16 or 0, it also skips a hex
+ * prefix. In the case of base 0, it replaces base with the detected base.
+ *
+ * @param  str  the string to parse
+ * @param  base the number base (which may be modified)
+ *
+ * @return the position of the first number character in str.
+ */
+static size_t number_start(std::string_view str, int* base) {
+    size_t pos = 0;
+    while (pos < str.size() && std::isspace((unsigned char)str[pos])) {
+        pos++;
+    }
+    if (pos+1 < str.size() && str[pos] == '+' && str[pos+1] != '-') {
+        pos++;
+    }
+    if (base != nullptr && (*base == 16 || *base == 0)) {
+        if (pos+2 < str.size() && str[pos] == '0' && (str[pos+1] == 'x' || str[pos+1] == 'X')) {
+            pos += 2;
+            *base = 16;
+        } else if (*base == 0) {
+            *base = (pos+1 < str.size() && str[pos] == '0') ? 8 : 10;
+        }
+    }
+    return pos;
+}
+
+/**
+ * Returns the integer equivalent to the given string
+ *
+ * The value is parsed as type T (which should be a 64 bit type) and is then
+ * narrowed by the caller, matching the wrap-around of the strtol family.
+ * Unsigned types accept a leading minus sign, just like strtoul.
+ *
+ * @param  str  the string to convert
+ * @param  pos  address of an integer to store the number of characters processed
+ * @param  base the number base
+ *
+ * @return the integer equivalent to the given string
+ */
+template <typename T>
+static T parse_integer(std::string_view str, std::size_t* pos, int base) {
+    size_t start = number_start(str,&base);
+    const char* first = str.data()+start;
+    const char* last  = str.data()+str.size();
+
+    T result = 0;
+    std::from_chars_result status;
+    if (std::is_unsigned<T>::value && first != last && *first == '-') {
+        Sint64 value = 0;
+        status = std::from_chars(first, last, value, base);
+        result = (T)value;
+    } else {
+        status = std::from_chars(first, last, result, base);
+    }
+    if (status.ec != std::errc()) {
+        result = 0;
+    }
+    if (pos != nullptr) {
+        *pos = status.ec != std::errc() ? 0 : (std::size_t)(status.ptr-str.data());
+    }
+    return result;
+}
+
+#if !defined (__cpp_lib_to_chars)
+/**
+ * Returns the double equivalent to the given C-string in the "C" locale
+ *
+ * This is strtod, except that the decimal point is always a period, no
+ * matter the locale of the user.
+ *
+ * @param  str  the C-string to convert
+ * @param  end  address to store the end of the number
+ *
+ * @return the double equivalent to the given C-string in the "C" locale
+ */
+static double strtod_c(const char* str, char** end) {
+#if defined (__WINDOWS__)
+    static _locale_t locale = _create_locale(LC_NUMERIC, "C");
+    return _strtod_l(str, end, locale);
+#else
+    static locale_t locale = newlocale(LC_NUMERIC_MASK, "C", (locale_t)0);
+    return strtod_l(str, end, locale);
+#endif
+}
+#endif
+
+/**
+ * Returns the floating point equivalent to the given string
+ *
+ * Floating point std::from_chars is not available in every standard library
+ * we support (most notably the NDK libc++).  In that case, we fall back to
+ * strtod_l with the "C" locale on a stack copy of the string.
+ *
+ * If the number is out of range for T, this returns 0 and sets pos to 0.
+ *
+ * @param  str  the string to convert
+ * @param  pos  address of an integer to store the number of characters processed
+ *
+ * @return the floating point equivalent to the given string
+ */
+template <typename T>
+static T parse_float(std::string_view str, std::size_t* pos) {
+    size_t start = number_start(str,nullptr);
+    const char* first = str.data()+start;
+    const char* last  = str.data()+str.size();
+
+    T result = 0;
+    size_t used = 0;
+#if defined (__cpp_lib_to_chars)
+    std::from_chars_result status = std::from_chars(first, last, result);
+    if (status.ec == std::errc()) {
+        used = (size_t)(status.ptr-str.data());
+    } else {
+        result = 0;
+    }
+#else
+    char buffer[STRTOOL_NUMBER_BUFFER];
+    size_t len = std::min((size_t)(last-first),(size_t)STRTOOL_NUMBER_BUFFER-1);
+    std::memcpy(buffer, first, len);
+    buffer[len] = 0;
+    char* end;
+    errno = 0;
+    double value = strtod_c(buffer, &end);
+    bool range = errno != ERANGE;
+    if (range && std::isfinite(value)) {
+        range = std::abs(value) <= (double)std::numeric_limits<T>::max();
+    }
+    if (end != buffer && range) {
+        result = (T)value;
+        used = start+(size_t)(end-buffer);
+    }
+#endif
+    if (pos != nullptr) {
+        *pos = used;
+    }
+    return result;
+}
 
 /**
  * Returns the byte equivalent to the given string
@@ -458,16 +612,8 @@ std::string to_string(double* array, size_t length, size_t offset, int precision
  *
  * @return the byte equivalent to the given string
  */
-Uint8 stou8(const std::string str, std::size_t* pos, int base) {
-#if defined (__ANDROID__)
-    const char* start = str.c_str();
-    char* end;
-    int result = (Uint8)std::strtol(start, &end, base);
-    *pos = (std::size_t)(end-start); // Bad but no alternative on android
-    return result;
-#else
-    return (Uint8)std::stoi(str,pos,base);
-#endif
+Uint8 stou8(std::string_view str, std::size_t* pos, int base) {
+    return (Uint8)parse_integer<Sint64>(str, pos, base);
 }
 
 /**
@@ -484,16 +630,8 @@ Uint8 stou8(const std::string str, std::size_t* pos, int base) {
  *
  * @return the signed 16 bit integer equivalent to the given string
  */
-Sint16 stos16(const std::string str, std::size_t* pos, int base)  {
-#if defined (__ANDROID__)
-    const char* start = str.c_str();
-    char* end;
-    int result = (Sint16)std::strtol(start, &end, base);
-    *pos = (std::size_t)(end-start); // Bad but no alternative on android
-    return result;
-#else
-    return (Sint16)std::stoi(str,pos,base);
-#endif
+Sint16 stos16(std::string_view str, std::size_t* pos, int base) {
+    return (Sint16)parse_integer<Sint64>(str, pos, base);
 }
 
 /**
@@ -510,16 +648,8 @@ Sint16 stos16(const std::string str, std::size_t* pos, int base)  {
  *
  * @return the unsigned 16 bit integer equivalent to the given string
  */
-Uint16 stou16(const std::string str, std::size_t* pos, int base) {
-#if defined (__ANDROID__)
-    const char* start = str.c_str();
-    char* end;
-    int result = (Uint16)std::strtol(start, &end, base);
-    *pos = (std::size_t)(end-start); // Bad but no alternative on android
-    return result;
-#else
-    return (Uint16)std::stol(str,pos,base);
-#endif
+Uint16 stou16(std::string_view str, std::size_t* pos, int base) {
+    return (Uint16)parse_integer<Sint64>(str, pos, base);
 }
 
 /**
@@ -536,16 +666,8 @@ Uint16 stou16(const std::string str, std::size_t* pos, int base) {
  *
  * @return the signed 32 bit integer equivalent to the given string
  */
-Sint32 stos32(const std::string str, std::size_t* pos, int base) {
-#if defined (__ANDROID__)
-    const char* start = str.c_str();
-    char* end;
-    int result = (Sint32)std::strtol(start, &end, base);
-    *pos = (std::size_t)(end-start); // Bad but no alternative on android
-    return result;
-#else
-    return (Sint32)std::stol(str,pos,base);
-#endif
+Sint32 stos32(std::string_view str, std::size_t* pos, int base) {
+    return (Sint32)parse_integer<Sint64>(str, pos, base);
 }
 
 /**
@@ -562,16 +684,8 @@ Sint32 stos32(const std::string str, std::size_t* pos, int base) {
  *
  * @return the unsigned 32 bit integer equivalent to the given string
  */
-Uint32 stou32(const std::string str, std::size_t* pos, int base) {
-#if defined (__ANDROID__)
-    const char* start = str.c_str();
-    char* end;
-    int result = (Uint32)std::strtoul(start, &end, base);
-    *pos = (std::size_t)(end-start); // Bad but no alternative on android
-    return result;
-#else
-    return (Uint32)std::stoul(str,pos,base);
-#endif
+Uint32 stou32(std::string_view str, std::size_t* pos, int base) {
+    return (Uint32)parse_integer<Uint64>(str, pos, base);
 }
 
 /**
@@ -588,16 +702,8 @@ Uint32 stou32(const std::string str, std::size_t* pos, int base) {
  *
  * @return the signed 64 bit integer equivalent to the given string
  */
-Sint64 stos64(const std::string str, std::size_t* pos, int base) {
-#if defined (__ANDROID__)
-    const char* start = str.c_str();
-    char* end;
-    int result = (Sint64)std::strtoll(start, &end, base);
-    *pos = (std::size_t)(end-start); // Bad but no alternative on android
-    return result;
-#else
-    return (Sint64)std::stoll(str,pos,base);
-#endif
+Sint64 stos64(std::string_view str, std::size_t* pos, int base) {
+    return (Sint64)parse_integer<Sint64>(str, pos, base);
 }
 
 
@@ -615,16 +721,8 @@ Sint64 stos64(const std::string str, std::size_t* pos, int base) {
  *
  * @return the unsigned 64 bit integer equivalent to the given string
  */
-Uint64 stou64(const std::string str, std::size_t* pos, int base) {
-#if defined (__ANDROID__)
-    const char* start = str.c_str();
-    char* end;
-    int result = (Uint64)std::strtoull(start, &end, base);
-    *pos = (std::size_t)(end-start); // Bad but no alternative on android
-    return result;
-#else
-    return (Uint64)std::stoull(str,pos,base);
-#endif
+Uint64 stou64(std::string_view str, std::size_t* pos, int base) {
+    return (Uint64)parse_integer<Uint64>(str, pos, base);
 }
 
 /**
@@ -640,16 +738,8 @@ Uint64 stou64(const std::string str, std::size_t* pos, int base) {
  *
  * @return the float equivalent to the given string
  */
-float  stof(const std::string str, std::size_t* pos) {
-#if defined (__ANDROID__)
-    const char* start = str.c_str();
-    char* end;
-    float result = (float)std::strtod(start, &end);
-    *pos = (std::size_t)(end-start); // Bad but no alternative on android
-    return result;
-#else
-    return std::stof(str,pos);
-#endif
+float stof(std::string_view str, std::size_t* pos) {
+    return parse_float<float>(str, pos);
 }
 
 /**
@@ -665,16 +755,8 @@ float  stof(const std::string str, std::size_t* pos) {
  *
  * @return the double equivalent to the given string
  */
-double stod(const std::string str, std::size_t* pos) {
-#if defined (__ANDROID__)
-    const char* start = str.c_str();
-    char* end;
-    double result = std::strtod(start, &end);
-    *pos = (std::size_t)(end-start); // Bad but no alternative on android
-    return result;
-#else
-    return std::stod(str,pos);
-#endif
+double stod(std::string_view str, std::size_t* pos) {
+    return parse_float<double>(str, pos);
 }
 
 #pragma mark -
@@ -688,7 +770,7 @@ double stod(const std::string str, std::size_t* pos) {
  *
  * @return true if the string only contains alphabetic characters.
  */
-bool isalpha(const std::string str) {
+bool isalpha(std::string_view str) {
     std::locale loc;
     bool result = true;
     for(auto it = str.begin(); result && it != str.end(); ++it) {
@@ -706,7 +788,7 @@ bool isalpha(const std::string str) {
  *
  * @return true if the string only contains alphabetic and numeric characters.
  */
-bool isalphanum(const std::string str) {
+bool isalphanum(std::string_view str) {
     std::locale loc;
     bool result = true;
     for(auto it = str.begin(); result && it != str.end(); ++it) {
@@ -724,7 +806,7 @@ bool isalphanum(const std::string str) {
  *
  * @return true if the string only contains numeric characters.
  */
-bool isnumeric(const std::string str) {
+bool isnumeric(std::string_view str) {
     std::locale loc;
     bool result = true;
     for(auto it = str.begin(); result && it != str.end(); ++it) {
@@ -742,7 +824,7 @@ bool isnumeric(const std::string str) {
  *
  * @return true if the string can safely be converted to a number (double)
  */
-bool isnumber(const std::string str) {
+bool isnumber(std::string_view str) {
     size_t p;
     cugl::strtool::stod(str, &p);
     return p != 0;
@@ -758,10 +840,10 @@ bool isnumber(const std::string str) {
  *
  * @return the number of times substring a appears in str.
  */
-int count(const std::string str, const std::string a) {
+int count(std::string_view str, std::string_view a) {
     int result = 0;
     size_t pos = str.find(a);
-    while( pos != std::string::npos) {
+    while( pos != std::string_view::npos) {
         result++;
         pos = str.find(a,pos+1);
     }
@@ -776,9 +858,8 @@ int count(const std::string str, const std::string a) {
  *
  * @return true if str starts with the substring a.
  */
-bool starts_with(const std::string str, const std::string a) {
-    size_t pos = str.find(a);
-    return pos == 0;
+bool starts_with(std::string_view str, std::string_view a) {
+    return str.size() >= a.size() && str.compare(0,a.size(),a) == 0;
 }
 
 /**
@@ -789,14 +870,8 @@ bool starts_with(const std::string str, const std::string a) {
  *
  * @return true if str ends with the substring a.
  */
-bool ends_with(const std::string str, const std::string a) {
-    if (str.size() < a.size()) {
-        return false;
-    }
-
-    size_t offset = str.size()-a.size();
-    size_t pos = str.find(a);
-    return pos == offset;
+bool ends_with(std::string_view str, std::string_view a) {
+    return str.size() >= a.size() && str.compare(str.size()-a.size(),a.size(),a) == 0;
 }
 
 /**
@@ -812,7 +887,7 @@ bool ends_with(const std::string str, const std::string a) {
  *
  * @return true if the string is lower case
  */
-bool islower(const std::string str) {
+bool islower(std::string_view str) {
     bool result = true;
     std::locale loc;
     for(auto it = str.begin(); result && it != str.end(); ++it) {
@@ -836,7 +911,7 @@ bool islower(const std::string str) {
  *
  * @return true if the string is upper case
  */
-bool isupper(const std::string str) {
+bool isupper(std::string_view str) {
     bool result = true;
     std::locale loc;
     for(auto it = str.begin(); result && it != str.end(); ++it) {
@@ -913,6 +988,81 @@ std::vector<std::string> splitlines(const std::string str) {
     return result;
 }
 
+/**
+ * Stores the substrings of str separated by the given separator in result
+ *
+ * This is the allocation-free version of {@link split}.  The contents of
+ * result are replaced (but its capacity is kept), so the same vector can
+ * be reused across calls.  The views refer to the characters of str, so
+ * they are only valid as long as str is.
+ *
+ * The separator is interpretted exactly; no whitespace is removed around
+ * the separator.  If the separator is the empty string, this function
+ * will store the individual characters in str.
+ *
+ * @param str       The string to split
+ * @param sep       The splitting delimeter
+ * @param result    The vector to store the substrings
+ *
+ * @return the number of substrings found
+ */
+size_t split(std::string_view str, std::string_view sep, std::vector<std::string_view>& result) {
+    result.clear();
+    if (sep.empty()) {
+        for(size_t ii = 0; ii < str.size(); ii++) {
+            result.push_back(str.substr(ii,1));
+        }
+        return result.size();
+    }
+    size_t start = 0;
+    size_t end = str.find(sep,start);
+    while (end != std::string_view::npos) {
+        result.push_back(str.substr(start,end-start));
+        start = end+sep.size();
+        end = str.find(sep,start);
+    }
+    result.push_back(str.substr(start));
+    return result.size();
+}
+
+/**
+ * Stores the substrings of str separated by the line separator in result
+ *
+ * This is the allocation-free version of {@link splitlines}.  The contents
+ * of result are replaced (but its capacity is kept), so the same vector can
+ * be reused across calls.  The views refer to the characters of str, so
+ * they are only valid as long as str is.
+ *
+ * @param str       The string to split
+ * @param result    The vector to store the substrings
+ *
+ * @return the number of substrings found
+ */
+size_t splitlines(std::string_view str, std::vector<std::string_view>& result) {
+    result.clear();
+    size_t start = 0;
+    for (size_t end = 1; end < str.size(); end++) {
+        bool push = false;
+        if (str[end] == '\r') {
+            push = true;
+        } else if (str[end] == '\n') {
+            if (!(start == end && start > 0 && str[start-1] == '\r')) {
+                push = true;
+            } else {
+                start++;
+            }
+        }
+        if (push) {
+            result.push_back(str.substr(start,end-start));
+            start = end+1;
+        }
+    }
+    if (start < str.size()) {
+        result.push_back(str.substr(start));
+    }
+    return result.size();
+}
+
 /**
  * Returns a string that is the concatentation of elts.
  *
@@ -1097,6 +1247,23 @@ std::string tolower(const std::string str) {
     return result;
 }
 
+/**
+ * Stores a lower case copy of str in result.
+ *
+ * This version reuses the buffer of result, so it does not allocate once
+ * result is large enough.  This function uses the current C++ locale.
+ *
+ * @param str       The string to convert
+ * @param result    The string to store the lower case copy
+ */
+void tolower(std::string_view str, std::string& result) {
+    std::locale loc;
+    result.resize(str.size());
+    for(size_t ii = 0; ii < str.size(); ii++) {
+        result[ii] = std::tolower(str[ii], loc);
+    }
+}
+
 /**
  * Returns an upper case copy of str.
  *
@@ -33,6 +33,7 @@
 //  Version: 11/29/16
 //
 #include <cugl/util/CUThreadPool.h>
+#include <algorithm>
 
 using namespace cugl;
 
@@ -160,6 +161,49 @@ void ThreadPool::addTask(const std::function<void()> &task){
     _taskCondition.notify_one();
 }
 
+/**
+ * Splits the range [0,size) across the worker threads and waits for it.
+ *
+ * The range is divided into one contiguous chunk per worker, plus one
+ * for the calling thread. The task is called once per chunk with the
+ * start and end (exclusive) of that chunk. This method blocks until all
+ * chunks have been processed. If the pool is stopped, or the range is
+ * too small to split, the task is run entirely on the calling thread.
+ *
+ * This method must never be called from a task in this same pool, as
+ * the workers may all be blocked waiting on each other.
+ *
+ * @param size  The size of the range to split
+ * @param task  The task to perform on each chunk
+ */
+void ThreadPool::parallelFor(size_t size, const std::function<void(size_t, size_t)>& task) {
+    size_t chunks = std::min(size,_workers.size()+1);
+    if (_stop || chunks <= 1) {
+        task(0,size);
+        return;
+    }
+    
+    std::mutex mutex;
+    std::condition_variable done;
+    size_t remaining = chunks-1;
+    size_t step = size/chunks;
+    for(size_t ii = 1; ii < chunks; ii++) {
+        size_t start = ii*step;
+        size_t end = (ii == chunks-1 ? size : start+step);
+        addTask([&,start,end]() {
+            task(start,end);
+            std::unique_lock<std::mutex> lk(mutex);
+            if (--remaining == 0) {
+                done.notify_one();
+            }
+        });
+    }
+    task(0,step);
+    
+    std::unique_lock<std::mutex> lk(mutex);
+    done.wait(lk, [&]() { return remaining == 0; });
+}
+
 /**
  * Stop the thread pool, marking it for shut down.
  *
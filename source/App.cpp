@@ -1,6 +1,9 @@
 #include "App.h"
 using namespace cugl;
 
+/** The file (in the save directory) for the profiler trace */
+#define PROFILE_FILE    "profile.json"
+
 #pragma mark -
 #pragma mark Gameplay Control
 
@@ -40,11 +43,21 @@ void App::onStartup() {
 
     // Queue up the other assets
     _assets->loadDirectory("json/assets.json");
+    if (USE_LEVEL_EDITOR) {
+        // Pick up texture and font edits without restarting (desktop only)
+        _assets->watchDirectory("json/assets.json");
+    }
 
     //Input manager
     _inputManager = std::shared_ptr<InputManager>(new InputManager());
-    _inputManager->init(nullptr, scene2::OrderedNode::allocWithOrder(scene2::OrderedNode::Order::ASCEND), getSafeBounds());
+    std::shared_ptr<scene2::OrderedNode> root = scene2::OrderedNode::allocWithOrder(scene2::OrderedNode::Order::ASCEND);
+    root->setBatching(true);
+    _inputManager->init(nullptr, root, getSafeBounds());
     AudioEngine::start();
+    if (USE_PROFILER) {
+        Profiler::start();
+    }
+    SaveManager::start(Application::getSaveDirectory());
     Application::onStartup(); // YOU MUST END with call to parent
 }
 
@@ -60,7 +73,8 @@ void App::onStartup() {
  * causing the application to be deleted.
  */
 void App::onShutdown() {
-    _gameplay.toSaveJson();
+    _gameplay.save();
+    SaveManager::stop(); // Blocks until every pending save is written
     _loading.dispose();
     _gameplay.dispose();
     _assets = nullptr;
@@ -77,6 +91,11 @@ void App::onShutdown() {
     AudioEngine::get()->pause();
     AudioEngine::get()->getMusicQueue()->clear();
     AudioEngine::stop();
+    if (Profiler::get() != nullptr) {
+        // Stop after the audio engine, as audio records zones
+        Profiler::get()->writeChromeTrace(Application::getSaveDirectory() + PROFILE_FILE);
+        Profiler::stop();
+    }
 
     Application::onShutdown();  // YOU MUST END with call to parent
 }
@@ -93,7 +112,14 @@ void App::onShutdown() {
  * the background.
  */
 void App::onSuspend() {
-    _gameplay.toSaveJson();
+    _gameplay.save();
+    if (SaveManager::get() != nullptr && !SaveManager::get()->flush(SAVE_SUSPEND_DEADLINE)) {
+        CULogError("Save did not finish before suspension");
+    }
+    if (Profiler::get() != nullptr) {
+        // There is no guarantee that we will be resumed
+        Profiler::get()->writeChromeTrace(Application::getSaveDirectory() + PROFILE_FILE);
+    }
     AudioEngine::get()->pause();
 }
 
@@ -123,6 +149,7 @@ void App::onResume() {
  * @param timestep  The amount of time (in seconds) since the last frame
  */
 void App::update(float timestep) {
+    _assets->update();
     if (!_inGameplay) _inputManager->readInput();
     if (!_loaded && counter > 0) {
         _menu.init(_assets);
@@ -189,8 +216,8 @@ void App::update(float timestep) {
             _menu.deactivateButtons();
             _levelSelect.setLevelSelected(false);
             CULog(Application::getSaveDirectory().c_str());
-            shared_ptr<JsonReader> reader = JsonReader::alloc(Application::getSaveDirectory() + "save.json");
-            _gameplay.init(_assets, 1, reader->readJson(), _inputManager,_menu.getMuted());
+            // The save manager returns the latest save, even if it is still being written
+            _gameplay.init(_assets, 1, SaveManager::get()->loadGame(), _inputManager,_menu.getMuted());
             _gameplay.reset();
             _inMenu = false;
             _inGameplay = true;
@@ -201,7 +228,7 @@ void App::update(float timestep) {
         _gameplay.update(timestep);
         if (_gameplay.getBackToMenu()) {
             _levelSelect.updateAudio();
-            _gameplay.toSaveJson();
+            _gameplay.save();
             _gameplay.setBackToMenu(false);
             _levelSelect.activateButtons();
             _levelSelect.setLevelSelected(false);
@@ -258,4 +285,13 @@ void App::draw() {
     else {
         _gameplay.render(_batch);
     }
+
+    if (Profiler::get() != nullptr) {
+        Size size = getDisplaySize();
+        Mat4 perspective;
+        Mat4::createOrthographicOffCenter(0, size.width, 0, size.height, -1, 1, &perspective);
+        _batch->begin(perspective);
+        Profiler::get()->draw(_batch, Rect(8, 8, size.width/3, size.height/4));
+        _batch->end();
+    }
 }
\ No newline at end of file
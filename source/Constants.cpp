@@ -15,5 +15,6 @@ const float GAME_WIDTH = 1024;
 const int MAX_LEVEL_NUM_PER_LOC = 15;
 const int ENEMY_TURNING_FRAMES = 30;
 const bool USE_LEVEL_EDITOR = false;
+const bool USE_PROFILER = false;
 const bool USE_TAP_POSSESS = true;
 const int MAX_LEVEL_PAGE = 2;
\ No newline at end of file
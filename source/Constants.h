@@ -18,6 +18,8 @@ extern const float GAME_WIDTH;
 extern const int MAX_LEVEL_NUM_PER_LOC;
 extern const int ENEMY_TURNING_FRAMES;
 extern const bool USE_LEVEL_EDITOR;
+/** whether to run the frame profiler (overlay and trace in the save directory)*/
+extern const bool USE_PROFILER;
 extern const bool USE_TAP_POSSESS;
 extern const int MAX_LEVEL_PAGE;
 #endif
\ No newline at end of file
@@ -123,6 +123,8 @@ bool GameplayMode::init(const std::shared_ptr<cugl::AssetManager>& assets, int l
     else if (!Scene2::init(size)) {
         return false;
     }
+    // Levels are wider than the screen, so skip what the camera cannot see
+    setCulling(true);
     // Create a scene graph the same size as the window
     //_scene = Scene2::alloc(size.width, size.height);
     _rootScene = scene2::OrderedNode::allocWithOrder(scene2::OrderedNode::Order::ASCEND);
@@ -459,27 +461,10 @@ void GameplayMode::update(float timestep) {
                 _winPanel->getChildButtons()["next"]->getButton()->activate();
                 _winPanel->getChildButtons()["retry"]->getButton()->activate();
                 _winPanel->getChildButtons()["toMenu"]->getButton()->activate();
-                // and save the update to level_completed.json
-                // first get all fields
-                shared_ptr<JsonReader> reader = JsonReader::alloc(Application::get()->getSaveDirectory() + "completed_levels.json");
-                std::shared_ptr<JsonValue> json = reader->readJson();
-                shared_ptr<JsonValue> completed = json->get("completed");
-                shared_ptr<JsonValue> result = JsonValue::allocObject();
-                shared_ptr<JsonValue> r_complete = JsonValue::allocObject();
-                for (int i = 0; i < MAX_LEVEL_PAGE * 10; i++) {
-                    if (_levelIndex == i) {
-                        r_complete->appendValue("level" + to_string(i + 1), true);
-                    }
-                    else {
-                        r_complete->appendValue("level" + to_string(i + 1), completed->getBool("level" + to_string(i + 1)));
-                    }
+                // and save the update to completed_levels.json (in the background)
+                if (SaveManager::get() != nullptr) {
+                    SaveManager::get()->markCompleted(_levelIndex);
                 }
-                reader->close();
-                result->appendChild("completed", r_complete);
-                shared_ptr<JsonWriter> writer = JsonWriter::alloc(Application::get()->getSaveDirectory() + "completed_levels.json");
-
-                writer->writeJson(result);
-                writer->close();
                 _hasControl = false;
                 return false;
             };
@@ -1733,89 +1718,51 @@ void GameplayMode::ChangeDrawOrder() {
     }
 }
 
-void GameplayMode::toSaveJson() {
-    if (_player != nullptr) { //need some other way to make sure game is initialized (scene is built)
-        shared_ptr<JsonValue> playerObject = JsonValue::allocObject();
-        shared_ptr<JsonValue> enemyArray = JsonValue::allocArray();
-        shared_ptr<JsonValue> decorationsArray = JsonValue::allocArray();
-        shared_ptr<JsonValue> staircaseDoorArray = JsonValue::allocArray();
-        shared_ptr<JsonValue> doorArray = JsonValue::allocArray();
-
-        //player
-        playerObject->appendChild("x_pos", JsonValue::alloc(_player->getPos()));
-        playerObject->appendChild("level", JsonValue::alloc((long)_player->getLevel()));
-        playerObject->appendChild("num_possessions", JsonValue::alloc((long)_player->get_nPossess()));
-
-        //enemies
-
-        vector<shared_ptr<Enemy>> enemies = _enemyController->getEnemies();
-        for (auto it = begin(enemies); it != end(enemies); ++it) {
-            shared_ptr<JsonValue> tempObject = JsonValue::allocObject(); //for enemy
-            tempObject->appendChild("x_pos", JsonValue::alloc(it->get()->getPos()));
-            tempObject->appendChild("level", JsonValue::alloc((long)it->get()->getLevel()));
-            tempObject->appendChild("patrol_start", JsonValue::alloc((long)it->get()->getPatrol().x));
-            tempObject->appendChild("patrol_end", JsonValue::alloc((long)it->get()->getPatrol().y));
-            shared_ptr<JsonValue> tempArray = JsonValue::allocArray(); //for keys
-            vector<int> keys = it->get()->getKeys();
-            for (auto it2 = begin(keys); it2 != end(keys); ++it2) {
-                tempArray->appendChild(JsonValue::alloc((long)*it2));
-            }
-            if (it->get()->isPossessed()) {
-                tempObject->appendChild("possessed", JsonValue::alloc(true));
-            }
-            tempObject->appendChild("keyInt", tempArray);
-            enemyArray->appendChild(tempObject);
-        }
-        for (auto it = begin(_catDens); it != end(_catDens); ++it) {
-            shared_ptr<JsonValue> tempObject = JsonValue::allocObject();
-            tempObject->appendChild("x_pos", JsonValue::alloc(it->get()->getPos().x));
-            tempObject->appendChild("level", JsonValue::alloc((long)it->get()->getLevel()));
-            tempObject->appendChild("connection", JsonValue::alloc((long)it->get()->getConnectedDens()));
-            tempObject->appendChild("isDen", JsonValue::alloc(true));
-            staircaseDoorArray->appendChild(tempObject);
-        }
-        for (auto it = begin(_staircaseDoors); it != end(_staircaseDoors); ++it) {
-            shared_ptr<JsonValue> tempObject = JsonValue::allocObject();
-            tempObject->appendChild("x_pos", JsonValue::alloc(it->get()->getPos().x));
-            tempObject->appendChild("level", JsonValue::alloc((long)it->get()->getLevel()));
-            tempObject->appendChild("connection", JsonValue::alloc((long)it->get()->getConnectedDoors()));
-            tempObject->appendChild("isDen", JsonValue::alloc(false));
-            staircaseDoorArray->appendChild(tempObject);
-        }
-        for (auto it = begin(_doors); it != end(_doors); ++it) {
-            shared_ptr<JsonValue> tempObject = JsonValue::allocObject();
-            tempObject->appendChild("x_pos", JsonValue::alloc(it->get()->getPos().x));
-            tempObject->appendChild("level", JsonValue::alloc((long)it->get()->getLevel()));
-            shared_ptr<JsonValue> tempArray = JsonValue::allocArray(); //for keys
-            vector<int> keys = it->get()->getKeys();
-            for (auto it2 = begin(keys); it2 != end(keys); ++it2) {
-                tempArray->appendChild(JsonValue::alloc((long)*it2));
-            }
-            tempObject->appendChild("keyInt", tempArray);
-            tempObject->appendChild("isOpen", JsonValue::alloc(it->get()->getIsOpen()));
-            doorArray->appendChild(tempObject);
-        }
-        //TODO IF WE EVER GET MORE THAN 1 DECORATIONS
-        shared_ptr<JsonValue> tempObject = JsonValue::allocObject();
-        tempObject->appendChild("x_pos", JsonValue::alloc((long)_cagedAnimal->getPos()));
-        tempObject->appendChild("level", JsonValue::alloc((long)_cagedAnimal->getLevel()));
-        tempObject->appendChild("objective", JsonValue::alloc((long)1));
-        tempObject->appendChild("texture", JsonValue::alloc("caged-animal"));
-        decorationsArray->appendChild(tempObject);
-
-        shared_ptr<JsonValue> result = JsonValue::allocObject();
-        result->appendChild("player", playerObject);
-        result->appendChild("enemy", enemyArray);
-        result->appendChild("decorations", decorationsArray);
-        result->appendChild("staircase-door", staircaseDoorArray);
-        result->appendChild("door", doorArray);
-        result->appendChild("floor", JsonValue::alloc((long)_numFloors));
-        result->appendChild("level", JsonValue::alloc((long)_levelIndex));
-        shared_ptr<JsonWriter> writer = JsonWriter::alloc(Application::get()->getSaveDirectory() + "save.json");
-
-        writer->writeJson(result);
-        writer->close();
+SaveSnapshot GameplayMode::snapshot() {
+    SaveSnapshot result;
+    //player
+    result.player = { _player->getPos(), _player->getLevel(), _player->get_nPossess() };
+
+    //enemies
+    vector<shared_ptr<Enemy>> enemies = _enemyController->getEnemies();
+    result.enemies.reserve(enemies.size());
+    for (auto it = begin(enemies); it != end(enemies); ++it) {
+        SaveSnapshot::EnemyState state;
+        state.x = it->get()->getPos();
+        state.level = it->get()->getLevel();
+        state.patrolStart = (int)it->get()->getPatrol().x;
+        state.patrolEnd = (int)it->get()->getPatrol().y;
+        state.keys = it->get()->getKeys();
+        state.possessed = it->get()->isPossessed();
+        result.enemies.push_back(std::move(state));
+    }
+    result.connectors.reserve(_catDens.size() + _staircaseDoors.size());
+    for (auto it = begin(_catDens); it != end(_catDens); ++it) {
+        result.connectors.push_back({ it->get()->getPos().x, it->get()->getLevel(), it->get()->getConnectedDens(), true });
+    }
+    for (auto it = begin(_staircaseDoors); it != end(_staircaseDoors); ++it) {
+        result.connectors.push_back({ it->get()->getPos().x, it->get()->getLevel(), it->get()->getConnectedDoors(), false });
+    }
+    result.doors.reserve(_doors.size());
+    for (auto it = begin(_doors); it != end(_doors); ++it) {
+        SaveSnapshot::DoorState state;
+        state.x = it->get()->getPos().x;
+        state.level = it->get()->getLevel();
+        state.keys = it->get()->getKeys();
+        state.isOpen = it->get()->getIsOpen();
+        result.doors.push_back(std::move(state));
+    }
+    result.objective = { (int)_cagedAnimal->getPos(), _cagedAnimal->getLevel() };
+    result.numFloors = _numFloors;
+    result.levelIndex = _levelIndex;
+    return result;
+}
+
+std::shared_future<bool> GameplayMode::save() {
+    if (_player != nullptr && SaveManager::get() != nullptr) { //need some other way to make sure game is initialized (scene is built)
+        return SaveManager::get()->saveGame(snapshot());
     }
+    return std::shared_future<bool>();
 }
 
 void GameplayMode::centerCamera() {
@@ -42,6 +42,7 @@
 #include "EnemyController.h"
 #include "InputManager.h"
 #include "CollisionManager.h"
+#include "SaveManager.h"
 
 
 class GameplayMode : public cugl::Scene2 {
@@ -313,7 +314,18 @@ public:
 
     void ChangeDrawOrder();
 
-    void toSaveJson();
+    /** Returns a copy of the current level state, suitable for saving on another thread */
+    SaveSnapshot snapshot();
+
+    /**
+     * Saves the current level state to save.json in the background.
+     *
+     * The state is captured immediately, but the file is written by the
+     * SaveManager. The returned future is invalid if there is nothing to save.
+     *
+     * @return a future that is true once the save is safely on disk
+     */
+    std::shared_future<bool> save();
     void setGameStatus(GameStatus status) {
         _gameStatus = status;
     }
@@ -6,6 +6,8 @@ using namespace cugl;
 /** This is the ideal size of the logo */
 #define SCENE_SIZE  1024
 #define ENEMY_SCALE 0.65
+/** How often (in milliseconds) to check the loaded level file for changes */
+#define LEVEL_POLL_INTERVAL 500
 #pragma mark -
 #pragma mark Constructors
 
@@ -301,6 +303,18 @@ shared_ptr<JsonValue> LevelEditor::toJson() {
     return result;
 }
 
+void LevelEditor::loadLevel(const std::string& file) {
+    shared_ptr<JsonReader> reader = JsonReader::allocWithAsset(file);
+    shared_ptr<JsonValue> json = reader == nullptr ? nullptr : reader->readJson();
+    if (json == nullptr) {
+        CULogError("Could not read level %s", file.c_str());
+        return;
+    }
+    _levelFile = Application::get()->getAssetDirectory() + file;
+    _levelStamp = filetool::file_timestamp(_levelFile);
+    fromJson(json);
+}
+
 void LevelEditor::fromJson(shared_ptr<JsonValue> json) {
 
 
@@ -436,6 +450,17 @@ void LevelEditor::update(float timestep) {
     if (_inputManager->didReset()) {
         _rootScene->setScale(Vec2(1, 1));
     }
+
+    // Reload the level if it was edited outside of the editor
+    Uint32 now = SDL_GetTicks();
+    if (!_levelFile.empty() && now - _levelPoll >= LEVEL_POLL_INTERVAL) {
+        _levelPoll = now;
+        Uint64 stamp = filetool::file_timestamp(_levelFile);
+        if (stamp != 0 && stamp != _levelStamp) {
+            CULog("Reloading %s", _levelFile.c_str());
+            loadLevel(_levelFile.substr(Application::get()->getAssetDirectory().size()));
+        }
+    }
 #endif
 }
 
@@ -674,6 +699,10 @@ void LevelEditor::buildScene() {
                 writer->writeJson(toJson());
                 writer->close();
             }
+            // Do not reload our own save
+            if (!_levelFile.empty()) {
+                _levelStamp = filetool::file_timestamp(_levelFile);
+            }
         }
         });
     buttons.push_back(_save);
@@ -698,8 +727,7 @@ void LevelEditor::buildScene() {
                 );
             }
             else if (filetool::file_exists("levels\\"+ _filePathField->getText() +".json")) {
-                shared_ptr<JsonReader> reader = JsonReader::allocWithAsset("levels\\" + _filePathField->getText() + ".json");
-                fromJson(reader->readJson());
+                loadLevel("levels\\" + _filePathField->getText() + ".json");
             }
             else {
                 string messageStr = "File ";
@@ -91,6 +91,13 @@ protected:
     vector <std::shared_ptr<cugl::scene2::PolygonNode>> enemies;
     vector <std::shared_ptr<cugl::scene2::WireNode>> paths;
 
+    /** The absolute path of the loaded level file (empty if none) */
+    std::string _levelFile;
+    /** The timestamp of the loaded level file when last read or written */
+    Uint64 _levelStamp = 0;
+    /** The time (in milliseconds) the level file was last checked for changes */
+    Uint32 _levelPoll = 0;
+
 public:
 
     /**
@@ -134,6 +141,11 @@ public:
     */
     void fromJson(shared_ptr<JsonValue> json);
 
+    /**
+        reads the given level file and watches it, so that outside edits are reloaded
+    */
+    void loadLevel(const std::string& file);
+
     /**
      * Initializes the controller contents, making it ready for loading
      *
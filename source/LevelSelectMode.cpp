@@ -112,24 +112,11 @@ void LevelSelectMode::update(float progress) {
 }
 
 void LevelSelectMode::updateLevelIcon() {
-    std::shared_ptr<JsonReader> reader = JsonReader::alloc(Application::get()->getSaveDirectory() + "completed_levels.json");
-    if (reader == nullptr) {
-        // if file doesn't exist create a new one
-        shared_ptr<JsonValue> result = JsonValue::allocObject();
-        shared_ptr<JsonValue> r_complete = JsonValue::allocObject();
-        for (int i = 0; i < 12; i++) {
-            r_complete->appendValue("level" + to_string(i + 1), false);
-        }
-        result->appendChild("completed", r_complete);
-        shared_ptr<JsonWriter> writer = JsonWriter::alloc(Application::get()->getSaveDirectory() + "completed_levels.json");
-        writer->writeJson(result);
-        writer->close();
-        reader = JsonReader::alloc(Application::get()->getSaveDirectory() + "completed_levels.json");
-    }
-    std::shared_ptr<JsonValue> json = reader->readJson();
-    shared_ptr<JsonValue> completed = json->get("completed");
+    // The completion table is cached by the save manager, so this never touches disk
+    SaveManager* saves = SaveManager::get();
+    CUAssertLog(saves != nullptr, "The save manager has not been started");
     for (int i = 0; i < MAX_LEVEL_PAGE; i++) {
-        if (completed->getBool("level" + to_string(i * 10 + 1))) {
+        if (saves->isCompleted(i * 10)) {
             _levelSelectPanel[i]->createChildButtonTextureWithName(-380 + (i * 115), 60, 20, 20, ui::ButtonState::AVAILABLE, _assets->get<Texture>("level" + to_string(i * 10 + 1) + "Complete"), "level" + to_string(i * 10 + 1));
             _levelSelectPanel[i]->getChildButtons()["level" + to_string(i * 10 + 1)]->getButton()->setScale(1.0f);
             _levelSelectPanel[i]->getChildButtons()["level" + to_string(i * 10 + 1)]->getButton()->addListener([=](const std::string& name, bool down) {
@@ -143,7 +130,7 @@ void LevelSelectMode::updateLevelIcon() {
                 }
                 });
         }
-        if (completed->getBool("level" + to_string(i * 10 + 2))) {
+        if (saves->isCompleted(i * 10 + 1)) {
             _levelSelectPanel[i]->createChildButtonTextureWithName(-220 + (i * 115), 60, 20, 20, ui::ButtonState::AVAILABLE, _assets->get<Texture>("level" + to_string(i * 10 + 2) + "Complete"), "level" + to_string(i * 10 + 2));
             _levelSelectPanel[i]->getChildButtons()["level" + to_string(i * 10 + 2)]->getButton()->setScale(1.0f);
             _levelSelectPanel[i]->getChildButtons()["level" + to_string(i * 10 + 2)]->getButton()->addListener([=](const std::string& name, bool down) {
@@ -157,7 +144,7 @@ void LevelSelectMode::updateLevelIcon() {
                 }
                 });
         }
-        if (completed->getBool("level" + to_string(i * 10 + 3))) {
+        if (saves->isCompleted(i * 10 + 2)) {
             _levelSelectPanel[i]->createChildButtonTextureWithName(-55 + (i * 115), 60, 20, 20, ui::ButtonState::AVAILABLE, _assets->get<Texture>("level" + to_string(i * 10 + 3) + "Complete"), "level" + to_string(i * 10 + 3));
             _levelSelectPanel[i]->getChildButtons()["level" + to_string(i * 10 + 3)]->getButton()->setScale(1.0f);
             _levelSelectPanel[i]->getChildButtons()["level" + to_string(i * 10 + 3)]->getButton()->addListener([=](const std::string& name, bool down) {
@@ -171,7 +158,7 @@ void LevelSelectMode::updateLevelIcon() {
                 }
                 });
         }
-        if (completed->getBool("level" + to_string(i * 10 + 4))) {
+        if (saves->isCompleted(i * 10 + 3)) {
             _levelSelectPanel[i]->createChildButtonTextureWithName(105 + (i * 115), 60, 20, 20, ui::ButtonState::AVAILABLE, _assets->get<Texture>("level" + to_string(i * 10 + 4) + "Complete"), "level" + to_string(i * 10 + 4));
             _levelSelectPanel[i]->getChildButtons()["level" + to_string(i * 10 + 4)]->getButton()->setScale(1.0f);
             _levelSelectPanel[i]->getChildButtons()["level" + to_string(i * 10 + 4)]->getButton()->addListener([=](const std::string& name, bool down) {
@@ -185,7 +172,7 @@ void LevelSelectMode::updateLevelIcon() {
                 }
                 });
         }
-        if (completed->getBool("level" + to_string(i * 10 + 5))) {
+        if (saves->isCompleted(i * 10 + 4)) {
             _levelSelectPanel[i]->createChildButtonTextureWithName(265 + (i * 115), 55, 20, 20, ui::ButtonState::AVAILABLE, _assets->get<Texture>("level" + to_string(i * 10 + 5) + "Complete"), "level" + to_string(i * 10 + 5));
             _levelSelectPanel[i]->getChildButtons()["level" + to_string(i * 10 + 5)]->getButton()->setScale(1.0f);
             _levelSelectPanel[i]->getChildButtons()["level" + to_string(i * 10 + 5)]->getButton()->addListener([=](const std::string& name, bool down) {
@@ -199,7 +186,7 @@ void LevelSelectMode::updateLevelIcon() {
                 }
                 });
         }
-        if (completed->getBool("level" + to_string(i * 10 + 6))) {
+        if (saves->isCompleted(i * 10 + 5)) {
             _levelSelectPanel[i]->createChildButtonTextureWithName(-380 + (i * 115), -110, 20, 20, ui::ButtonState::AVAILABLE, _assets->get<Texture>("level" + to_string(i * 10 + 6) + "Complete"), "level" + to_string(i * 10 + 6));
             _levelSelectPanel[i]->getChildButtons()["level" + to_string(i * 10 + 6)]->getButton()->setScale(1.0f);
             _levelSelectPanel[i]->getChildButtons()["level" + to_string(i * 10 + 6)]->getButton()->addListener([=](const std::string& name, bool down) {
@@ -213,7 +200,7 @@ void LevelSelectMode::updateLevelIcon() {
                 }
                 });
         }
-        if (completed->getBool("level" + to_string(i * 10 + 7))) {
+        if (saves->isCompleted(i * 10 + 6)) {
             _levelSelectPanel[i]->createChildButtonTextureWithName(-220 + (i * 115), -110, 20, 20, ui::ButtonState::AVAILABLE, _assets->get<Texture>("level" + to_string(i * 10 + 7) + "Complete"), "level" + to_string(i * 10 + 7));
             _levelSelectPanel[i]->getChildButtons()["level" + to_string(i * 10 + 7)]->getButton()->setScale(1.0f);
             _levelSelectPanel[i]->getChildButtons()["level" + to_string(i * 10 + 7)]->getButton()->addListener([=](const std::string& name, bool down) {
@@ -227,7 +214,7 @@ void LevelSelectMode::updateLevelIcon() {
                 }
                 });
         }
-        if (completed->getBool("level" + to_string(i * 10 + 8))) {
+        if (saves->isCompleted(i * 10 + 7)) {
             _levelSelectPanel[i]->createChildButtonTextureWithName(-55 + (i * 115), -115, 20, 20, ui::ButtonState::AVAILABLE, _assets->get<Texture>("level" + to_string(i * 10 + 8) + "Complete"), "level" + to_string(i * 10 + 8));
             _levelSelectPanel[i]->getChildButtons()["level" + to_string(i * 10 + 8)]->getButton()->setScale(1.0f);
             _levelSelectPanel[i]->getChildButtons()["level" + to_string(i * 10 + 8)]->getButton()->addListener([=](const std::string& name, bool down) {
@@ -241,7 +228,7 @@ void LevelSelectMode::updateLevelIcon() {
                 }
                 });
         }
-        if (completed->getBool("level" + to_string(i * 10 + 9))) {
+        if (saves->isCompleted(i * 10 + 8)) {
             _levelSelectPanel[i]->createChildButtonTextureWithName(110 + (i * 115), -115, 20, 20, ui::ButtonState::AVAILABLE, _assets->get<Texture>("level"+ to_string(i * 10 + 9) +"Complete"), "level" + to_string(i * 10 + 9));
             _levelSelectPanel[i]->getChildButtons()["level" + to_string(i * 10 + 9)]->getButton()->setScale(1.0f);
             _levelSelectPanel[i]->getChildButtons()["level" + to_string(i * 10 + 9)]->getButton()->addListener([=](const std::string& name, bool down) {
@@ -255,7 +242,7 @@ void LevelSelectMode::updateLevelIcon() {
                 }
                 });
         }
-        if (completed->getBool("level" + to_string(i * 10 + 10))) {
+        if (saves->isCompleted(i * 10 + 9)) {
             _levelSelectPanel[i]->createChildButtonTextureWithName(275 + (i * 115), -120, 20, 20, ui::ButtonState::AVAILABLE, _assets->get<Texture>("level"+ to_string(i * 10 + 10) +"Complete"), "level" + to_string(i * 10 + 10));
             _levelSelectPanel[i]->getChildButtons()["level" + to_string(i * 10 + 10)]->getButton()->setScale(1.0f);
             _levelSelectPanel[i]->getChildButtons()["level" + to_string(i * 10 + 10)]->getButton()->addListener([=](const std::string& name, bool down) {
@@ -272,7 +259,6 @@ void LevelSelectMode::updateLevelIcon() {
     }
     
     activateButtons();
-    reader->close();
 }
 
 void LevelSelectMode::buildScene() {
@@ -0,0 +1,358 @@
+#include "SaveManager.h"
+#include "Constants.h"
+#include <chrono>
+#include <cstdio>
+#if defined (__WINDOWS__)
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+using namespace cugl;
+
+/** The singleton save manager */
+SaveManager* SaveManager::_gManager = nullptr;
+
+#pragma mark -
+#pragma mark Serialization
+
+std::shared_ptr<JsonValue> SaveSnapshot::toJson() const {
+    shared_ptr<JsonValue> playerObject = JsonValue::allocObject();
+    shared_ptr<JsonValue> enemyArray = JsonValue::allocArray();
+    shared_ptr<JsonValue> decorationsArray = JsonValue::allocArray();
+    shared_ptr<JsonValue> staircaseDoorArray = JsonValue::allocArray();
+    shared_ptr<JsonValue> doorArray = JsonValue::allocArray();
+
+    //player
+    playerObject->appendChild("x_pos", JsonValue::alloc(player.x));
+    playerObject->appendChild("level", JsonValue::alloc((long)player.level));
+    playerObject->appendChild("num_possessions", JsonValue::alloc((long)player.possessions));
+
+    //enemies
+    for (auto it = begin(enemies); it != end(enemies); ++it) {
+        shared_ptr<JsonValue> tempObject = JsonValue::allocObject();
+        tempObject->appendChild("x_pos", JsonValue::alloc(it->x));
+        tempObject->appendChild("level", JsonValue::alloc((long)it->level));
+        tempObject->appendChild("patrol_start", JsonValue::alloc((long)it->patrolStart));
+        tempObject->appendChild("patrol_end", JsonValue::alloc((long)it->patrolEnd));
+        shared_ptr<JsonValue> tempArray = JsonValue::allocArray(); //for keys
+        for (auto it2 = begin(it->keys); it2 != end(it->keys); ++it2) {
+            tempArray->appendChild(JsonValue::alloc((long)*it2));
+        }
+        if (it->possessed) {
+            tempObject->appendChild("possessed", JsonValue::alloc(true));
+        }
+        tempObject->appendChild("keyInt", tempArray);
+        enemyArray->appendChild(tempObject);
+    }
+
+    //cat dens and staircase doors
+    for (auto it = begin(connectors); it != end(connectors); ++it) {
+        shared_ptr<JsonValue> tempObject = JsonValue::allocObject();
+        tempObject->appendChild("x_pos", JsonValue::alloc(it->x));
+        tempObject->appendChild("level", JsonValue::alloc((long)it->level));
+        tempObject->appendChild("connection", JsonValue::alloc((long)it->connection));
+        tempObject->appendChild("isDen", JsonValue::alloc(it->isDen));
+        staircaseDoorArray->appendChild(tempObject);
+    }
+
+    //doors
+    for (auto it = begin(doors); it != end(doors); ++it) {
+        shared_ptr<JsonValue> tempObject = JsonValue::allocObject();
+        tempObject->appendChild("x_pos", JsonValue::alloc(it->x));
+        tempObject->appendChild("level", JsonValue::alloc((long)it->level));
+        shared_ptr<JsonValue> tempArray = JsonValue::allocArray(); //for keys
+        for (auto it2 = begin(it->keys); it2 != end(it->keys); ++it2) {
+            tempArray->appendChild(JsonValue::alloc((long)*it2));
+        }
+        tempObject->appendChild("keyInt", tempArray);
+        tempObject->appendChild("isOpen", JsonValue::alloc(it->isOpen));
+        doorArray->appendChild(tempObject);
+    }
+
+    //TODO IF WE EVER GET MORE THAN 1 DECORATIONS
+    shared_ptr<JsonValue> tempObject = JsonValue::allocObject();
+    tempObject->appendChild("x_pos", JsonValue::alloc((long)objective.x));
+    tempObject->appendChild("level", JsonValue::alloc((long)objective.level));
+    tempObject->appendChild("objective", JsonValue::alloc((long)1));
+    tempObject->appendChild("texture", JsonValue::alloc("caged-animal"));
+    decorationsArray->appendChild(tempObject);
+
+    shared_ptr<JsonValue> result = JsonValue::allocObject();
+    result->appendChild("player", playerObject);
+    result->appendChild("enemy", enemyArray);
+    result->appendChild("decorations", decorationsArray);
+    result->appendChild("staircase-door", staircaseDoorArray);
+    result->appendChild("door", doorArray);
+    result->appendChild("floor", JsonValue::alloc((long)numFloors));
+    result->appendChild("level", JsonValue::alloc((long)levelIndex));
+    return result;
+}
+
+/**
+ * Returns the JSON for the given level completion table
+ *
+ * @param table The level completion table (index 0 is level 1)
+ */
+static std::shared_ptr<JsonValue> completedToJson(const std::vector<bool>& table) {
+    shared_ptr<JsonValue> result = JsonValue::allocObject();
+    shared_ptr<JsonValue> r_complete = JsonValue::allocObject();
+    for (size_t i = 0; i < table.size(); i++) {
+        r_complete->appendValue("level" + to_string(i + 1), (bool)table[i]);
+    }
+    result->appendChild("completed", r_complete);
+    return result;
+}
+
+/**
+ * Forces the contents of the given file to disk.
+ *
+ * Without this, the rename in writeAtomic can reach the disk before the
+ * data does, and a power loss leaves an empty file in place of the save.
+ *
+ * @param path  The absolute path of the file to sync
+ *
+ * @return true if the file was successfully synced
+ */
+static bool syncFile(const std::string path) {
+#if defined (__WINDOWS__)
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    bool success = FlushFileBuffers(handle) != 0;
+    CloseHandle(handle);
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    bool success = fsync(fd) == 0;
+    close(fd);
+#endif
+    return success;
+}
+
+/**
+ * Writes the JSON to the given file, replacing it atomically.
+ *
+ * The data is first written to a temporary file next to the target, which is
+ * synced and then renamed over it. If the application dies mid-write, the
+ * old file is left untouched.
+ *
+ * @param path  The absolute path of the file to write
+ * @param json  The JSON to write
+ *
+ * @return true if the file was successfully replaced
+ */
+static bool writeAtomic(const std::string path, const std::shared_ptr<JsonValue>& json) {
+    std::string temp = path + ".tmp";
+    std::shared_ptr<JsonWriter> writer = JsonWriter::alloc(temp);
+    if (writer == nullptr) {
+        CULogError("Could not open %s for writing", temp.c_str());
+        return false;
+    }
+    writer->writeJson(json);
+    writer->close();
+    if (!syncFile(temp)) {
+        CULogError("Could not sync %s", temp.c_str());
+        return false;
+    }
+#if defined (__WINDOWS__)
+    // rename() will not replace an existing file on Windows
+    bool success = MoveFileExA(temp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    bool success = std::rename(temp.c_str(), path.c_str()) == 0;
+#endif
+    if (!success) {
+        CULogError("Could not replace %s", path.c_str());
+    }
+    return success;
+}
+
+#pragma mark -
+#pragma mark Initialization
+
+bool SaveManager::init(const std::string directory) {
+    _directory = directory;
+    _writer = ThreadPool::alloc(1);
+    if (_writer == nullptr) {
+        return false;
+    }
+    loadCompleted();
+    return true;
+}
+
+void SaveManager::loadCompleted() {
+    _completed.assign(MAX_LEVEL_PAGE * 10, false);
+    std::shared_ptr<JsonReader> reader = JsonReader::alloc(_directory + COMPLETED_FILE);
+    if (reader == nullptr) {
+        // Write the default table on first run, so the file always exists
+        std::lock_guard<std::mutex> lock(_mutex);
+        _completedDirty = true;
+        _completedPromise = std::make_shared<std::promise<bool>>();
+        _completedFuture = _completedPromise->get_future().share();
+        schedule();
+        return;
+    }
+    std::shared_ptr<JsonValue> json = reader->readJson();
+    reader->close();
+    std::shared_ptr<JsonValue> completed = json == nullptr ? nullptr : json->get("completed");
+    if (completed == nullptr) {
+        return;
+    }
+    for (size_t i = 0; i < _completed.size(); i++) {
+        _completed[i] = completed->getBool("level" + to_string(i + 1));
+    }
+}
+
+bool SaveManager::start(const std::string directory) {
+    if (_gManager != nullptr) {
+        return false;
+    }
+    _gManager = new SaveManager();
+    if (!_gManager->init(directory)) {
+        delete _gManager;
+        _gManager = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void SaveManager::stop() {
+    if (_gManager == nullptr) {
+        return;
+    }
+    // Stopping the pool discards queued tasks, so drain them first
+    std::shared_future<bool> game;
+    std::shared_future<bool> completed;
+    {
+        std::lock_guard<std::mutex> lock(_gManager->_mutex);
+        game = _gManager->_gameFuture;
+        completed = _gManager->_completedFuture;
+    }
+    if (game.valid()) {
+        game.wait();
+    }
+    if (completed.valid()) {
+        completed.wait();
+    }
+    _gManager->_writer->stop();
+    _gManager->_writer = nullptr;
+    delete _gManager;
+    _gManager = nullptr;
+}
+
+#pragma mark -
+#pragma mark Saving
+
+void SaveManager::schedule() {
+    if (!_scheduled) {
+        _scheduled = true;
+        _writer->addTask([this]() { process(); });
+    }
+}
+
+void SaveManager::process() {
+    while (true) {
+        std::unique_ptr<SaveSnapshot> game;
+        std::shared_ptr<std::promise<bool>> gamePromise;
+        std::vector<bool> table;
+        std::shared_ptr<std::promise<bool>> tablePromise;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_pendingGame == nullptr && !_completedDirty) {
+                _scheduled = false;
+                return;
+            }
+            game = std::move(_pendingGame);
+            gamePromise = std::move(_gamePromise);
+            _gamePromise = nullptr;
+            if (_completedDirty) {
+                table = _completed;
+                tablePromise = std::move(_completedPromise);
+                _completedPromise = nullptr;
+                _completedDirty = false;
+            }
+        }
+
+        // Serialize outside of the lock so new requests never block
+        if (game != nullptr) {
+            gamePromise->set_value(writeAtomic(_directory + SAVE_FILE, game->toJson()));
+        }
+        if (tablePromise != nullptr) {
+            tablePromise->set_value(writeAtomic(_directory + COMPLETED_FILE, completedToJson(table)));
+        }
+    }
+}
+
+std::shared_future<bool> SaveManager::saveGame(SaveSnapshot snapshot) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _lastGame = std::make_shared<SaveSnapshot>(snapshot);
+    _pendingGame.reset(new SaveSnapshot(std::move(snapshot)));
+    if (_gamePromise == nullptr) {
+        _gamePromise = std::make_shared<std::promise<bool>>();
+        _gameFuture = _gamePromise->get_future().share();
+    }
+    schedule();
+    return _gameFuture;
+}
+
+std::shared_ptr<JsonValue> SaveManager::loadGame() {
+    std::shared_ptr<SaveSnapshot> last;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        last = _lastGame;
+    }
+    if (last != nullptr) {
+        return last->toJson();
+    }
+    std::shared_ptr<JsonReader> reader = JsonReader::alloc(_directory + SAVE_FILE);
+    if (reader == nullptr) {
+        return nullptr;
+    }
+    std::shared_ptr<JsonValue> json = reader->readJson();
+    reader->close();
+    return json;
+}
+
+std::shared_future<bool> SaveManager::markCompleted(int index) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (index < 0) {
+        return _completedFuture;
+    } else if ((size_t)index >= _completed.size()) {
+        _completed.resize(index + 1, false);
+    }
+    _completed[index] = true;
+    _completedDirty = true;
+    if (_completedPromise == nullptr) {
+        _completedPromise = std::make_shared<std::promise<bool>>();
+        _completedFuture = _completedPromise->get_future().share();
+    }
+    schedule();
+    return _completedFuture;
+}
+
+bool SaveManager::isCompleted(int index) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return index >= 0 && (size_t)index < _completed.size() && _completed[index];
+}
+
+bool SaveManager::flush(Uint32 millis) {
+    std::shared_future<bool> game;
+    std::shared_future<bool> completed;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        game = _gameFuture;
+        completed = _completedFuture;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(millis);
+    if (game.valid() && game.wait_until(deadline) != std::future_status::ready) {
+        return false;
+    }
+    if (completed.valid() && completed.wait_until(deadline) != std::future_status::ready) {
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,215 @@
+#pragma once
+#ifndef __SAVE_MANAGER_H__
+#define __SAVE_MANAGER_H__
+#include <cugl/cugl.h>
+#include <future>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+
+/** The name of the in-progress save file (relative to the save directory) */
+#define SAVE_FILE           "save.json"
+/** The name of the level completion file (relative to the save directory) */
+#define COMPLETED_FILE      "completed_levels.json"
+/** How long (in milliseconds) onSuspend will wait for a pending save */
+#define SAVE_SUSPEND_DEADLINE 250
+
+/**
+ * A plain-data copy of the state of a running level.
+ *
+ * This is captured on the main thread by GameplayMode and handed to the
+ * SaveManager. It holds no scene graph or asset references, so it is safe to
+ * serialize on another thread while the game keeps running.
+ */
+struct SaveSnapshot {
+    /** The saved state of the player */
+    struct PlayerState {
+        float x;
+        int level;
+        int possessions;
+    };
+    /** The saved state of a single enemy */
+    struct EnemyState {
+        float x;
+        int level;
+        int patrolStart;
+        int patrolEnd;
+        std::vector<int> keys;
+        bool possessed;
+    };
+    /** The saved state of a staircase door or a cat den */
+    struct ConnectorState {
+        float x;
+        int level;
+        int connection;
+        bool isDen;
+    };
+    /** The saved state of a (regular) door */
+    struct DoorState {
+        float x;
+        int level;
+        std::vector<int> keys;
+        bool isOpen;
+    };
+    /** The saved state of the caged animal (the only decoration for now) */
+    struct ObjectiveState {
+        int x;
+        int level;
+    };
+
+    PlayerState player;
+    std::vector<EnemyState> enemies;
+    std::vector<ConnectorState> connectors;
+    std::vector<DoorState> doors;
+    ObjectiveState objective;
+    int numFloors;
+    int levelIndex;
+
+    /** Returns the JSON for this snapshot, in the format read by GameplayMode::init */
+    std::shared_ptr<cugl::JsonValue> toJson() const;
+};
+
+/**
+ * This class writes the save files on a background thread.
+ *
+ * Writing is crash-safe: every file is written to a temporary file first,
+ * synced to disk, and then renamed over the original, so a partial write can
+ * never replace a good save. Requests are coalesced. If several snapshots are submitted while the
+ * writer is busy, only the most recent one is written.
+ *
+ * Like AudioEngine, this class is a singleton that is managed through the
+ * static methods {@link #start()}, {@link #stop()}, and {@link #get()}.
+ */
+class SaveManager {
+private:
+    /** The singleton save manager */
+    static SaveManager* _gManager;
+
+    /** The directory to write the save files to */
+    std::string _directory;
+    /** The single background writer thread */
+    std::shared_ptr<cugl::ThreadPool> _writer;
+
+    /** A mutex guarding all state shared with the writer thread */
+    std::mutex _mutex;
+    /** The most recent unwritten game snapshot (nullptr if none) */
+    std::unique_ptr<SaveSnapshot> _pendingGame;
+    /** The most recent game snapshot submitted this session (nullptr if none) */
+    std::shared_ptr<SaveSnapshot> _lastGame;
+    /** The promise for the pending game snapshot */
+    std::shared_ptr<std::promise<bool>> _gamePromise;
+    /** The future for the pending game snapshot */
+    std::shared_future<bool> _gameFuture;
+    /** Whether the level completion table has changed since the last write */
+    bool _completedDirty;
+    /** The promise for the pending level completion write */
+    std::shared_ptr<std::promise<bool>> _completedPromise;
+    /** The future for the pending level completion write */
+    std::shared_future<bool> _completedFuture;
+    /** Whether a writer task is currently queued or running */
+    bool _scheduled;
+
+    /** The cached level completion table (index 0 is level 1) */
+    std::vector<bool> _completed;
+
+    /** Creates an uninitialized save manager */
+    SaveManager() : _completedDirty(false), _scheduled(false) {}
+
+    /**
+     * Initializes this manager to write to the given directory.
+     *
+     * This reads the level completion table once, so that later queries do
+     * not touch the file system.
+     *
+     * @param directory The save directory (with a trailing separator)
+     *
+     * @return true if initialization was successful
+     */
+    bool init(const std::string directory);
+
+    /** Reads the level completion table from disk, creating it if missing */
+    void loadCompleted();
+
+    /** Queues the writer task if it is not queued already. Requires _mutex. */
+    void schedule();
+
+    /** The body of the writer task. Loops until no work is pending. */
+    void process();
+
+public:
+    /** Returns the singleton save manager (nullptr if not started) */
+    static SaveManager* get() { return _gManager; }
+
+    /**
+     * Starts the singleton save manager.
+     *
+     * @param directory The save directory (with a trailing separator)
+     *
+     * @return true if the manager was successfully started
+     */
+    static bool start(const std::string directory);
+
+    /**
+     * Stops the singleton save manager.
+     *
+     * Any pending writes are completed before this method returns.
+     */
+    static void stop();
+
+    /**
+     * Submits a game snapshot to be written to SAVE_FILE.
+     *
+     * This method returns immediately. If an earlier snapshot is still waiting
+     * to be written, it is replaced by this one, and both callers receive the
+     * same future.
+     *
+     * @param snapshot  The game state to save
+     *
+     * @return a future that is true once the snapshot is safely on disk
+     */
+    std::shared_future<bool> saveGame(SaveSnapshot snapshot);
+
+    /**
+     * Returns the JSON for the most recent saved game.
+     *
+     * If a snapshot was submitted this session, this is the JSON of the
+     * latest one, whether or not it has reached the disk yet. Otherwise it
+     * is read from SAVE_FILE. So the game can be continued right after it is
+     * saved, without waiting for the writer.
+     *
+     * @return the JSON for the most recent saved game (nullptr if none)
+     */
+    std::shared_ptr<cugl::JsonValue> loadGame();
+
+    /**
+     * Marks the given level as complete and schedules COMPLETED_FILE for writing.
+     *
+     * @param index The level index (0 is level 1)
+     *
+     * @return a future that is true once the table is safely on disk
+     */
+    std::shared_future<bool> markCompleted(int index);
+
+    /**
+     * Returns true if the given level has been completed
+     *
+     * This query uses the in-memory table and never touches the file system.
+     *
+     * @param index The level index (0 is level 1)
+     *
+     * @return true if the given level has been completed
+     */
+    bool isCompleted(int index);
+
+    /**
+     * Waits for all pending writes to finish, up to the given deadline.
+     *
+     * @param millis    The maximum time to wait (in milliseconds)
+     *
+     * @return true if all pending writes finished within the deadline
+     */
+    bool flush(Uint32 millis);
+};
+
+#endif /* __SAVE_MANAGER_H__ */